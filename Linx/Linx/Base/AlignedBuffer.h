@@ -6,11 +6,14 @@
 #define _LINXBASE_ALIGNEDBUFFER_H
 
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/MemoryTracker.h"
 #include "Linx/Base/TypeUtils.h"
 
-#include <algorithm> // copy_n
+#include <algorithm> // copy_n, move
 #include <cstdint> // uintptr_t
+#include <cstdlib> // aligned_alloc, free
 #include <sstream>
+#include <sys/mman.h> // madvise
 
 namespace Linx {
 
@@ -79,6 +82,15 @@ struct AlignmentError : Exception {
   }
 };
 
+/**
+ * @relatesalso AlignedBuffer
+ * @brief The size of the huge pages, in bytes.
+ * 
+ * Owning buffers whose alignment requirement is a multiple of this size are backed by transparent huge pages,
+ * if enabled by the system.
+ */
+inline constexpr Index huge_page_size = 2 * 1024 * 1024;
+
 /**
  * @ingroup data_classes
  * @brief Data holder with aligned memory.
@@ -95,9 +107,20 @@ struct AlignmentError : Exception {
  * This larger memory is freed by the destructor,
  * unless the said buffer is `released()`,
  * in which case the user is responsible for freeing it.
+ * 
+ * Owning buffers are not initialized.
+ * If their alignment requirement is a multiple of `huge_page_size`,
+ * then memory is advised to be backed by huge pages (`madvise(MADV_HUGEPAGE)`),
+ * which reduces TLB misses of large rasters accessed non-sequentially, e.g. by warps:
+ * 
+ * \code
+ * AlignedRaster<float> warped(shape, uninitialized, huge_page_size);
+ * \endcode
+ *
+ * @see `MemoryTracker`
  */
 template <typename T>
-struct AlignedBuffer {
+struct AlignedBuffer : private Internal::MemoryTicket {
 public:
 
   /**
@@ -118,7 +141,7 @@ public:
    * \snippet LinxDemoConstructors_test.cpp AlignedRaster shares
    */
   AlignedBuffer(std::size_t size, T* data = nullptr, Index align = 0) :
-      m_container(nullptr), m_begin(data), m_end(data + size), m_as(align_as(data, align))
+      m_container(nullptr), m_begin(data), m_end(data + size), m_capacity(size), m_as(align_as(data, align))
   {
     if (m_begin) {
       AlignmentError::may_throw(m_begin, m_as);
@@ -127,6 +150,13 @@ public:
     }
   }
 
+  /**
+   * @brief Uninitialized owning constructor.
+   * @param size The number of elements
+   * @param align The alignment requirement in bytes, or 0 or -1 for SIMD compatibility
+   */
+  AlignedBuffer(std::size_t size, UninitializedTag, Index align = 0) : AlignedBuffer(size, nullptr, align) {}
+
   /**
    * @brief Copy constructor.
    */
@@ -143,7 +173,8 @@ public:
    * @brief Move constructor.
    */
   AlignedBuffer(AlignedBuffer&& other) :
-      m_container(other.release()), m_begin(other.m_begin), m_end(other.m_end), m_as(other.m_as)
+      Internal::MemoryTicket(LINX_MOVE(other)), m_container(other.release()), m_begin(other.m_begin),
+      m_end(other.m_end), m_capacity(other.m_capacity), m_as(other.m_as)
   {
     other.reset();
   }
@@ -154,6 +185,7 @@ public:
   AlignedBuffer& operator=(const AlignedBuffer& other)
   {
     if (this != &other) {
+      reset();
       m_as = other.m_as; // Must be set before allocate()
       if (other.owns()) {
         allocate(other.m_end - other.m_begin);
@@ -162,6 +194,7 @@ public:
         m_container = other.m_container;
         m_begin = other.m_begin;
         m_end = other.m_end;
+        m_capacity = other.m_capacity;
       }
     }
     return *this;
@@ -173,9 +206,12 @@ public:
   AlignedBuffer& operator=(AlignedBuffer&& other)
   {
     if (this != &other) {
+      reset();
+      Internal::MemoryTicket::operator=(LINX_MOVE(other));
       m_container = other.release();
       m_begin = other.m_begin;
       m_end = other.m_end;
+      m_capacity = other.m_capacity;
       m_as = other.m_as;
       other.reset();
     }
@@ -245,6 +281,7 @@ public:
    */
   void* release()
   {
+    untrack();
     void* out = m_container;
     m_container = nullptr;
     return out;
@@ -261,20 +298,65 @@ public:
     if (m_container) {
       std::free(m_container);
       m_container = nullptr;
+      untrack();
     }
     m_as = 1;
     m_begin = nullptr;
     m_end = nullptr;
+    m_capacity = 0;
+  }
+
+  /**
+   * @brief Get the number of elements which can be held without reallocation.
+   */
+  std::size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Change the number of elements.
+   * 
+   * If the new size fits the capacity, the buffer is only shortened or lengthened, without reallocation.
+   * Otherwise, the buffer must be owning or empty, some aligned memory is allocated with the same alignment requirement,
+   * and the elements are moved to it.
+   * In both cases, the leading elements are preserved, and the new ones are not initialized.
+   */
+  void resize(std::size_t size)
+  {
+    if (size <= m_capacity) {
+      m_end = m_begin + size;
+      return;
+    }
+    if (m_begin && not owns()) {
+      throw Exception("Cannot grow a non-owning buffer beyond its capacity.");
+    }
+    void* previous = m_container;
+    T* begin = m_begin;
+    T* end = m_end;
+    if (not m_begin) {
+      m_as = align_as(nullptr, 0);
+    }
+    allocate(size);
+    std::move(begin, end, m_begin);
+    std::free(previous);
   }
 
 private:
 
   void allocate(std::size_t size)
   {
-    const auto valid_size = ((size + m_as - 1) / m_as) * m_as; // Smallest multiple of m_as >= size
-    m_container = std::aligned_alloc(m_as, sizeof(T) * valid_size);
+    const auto bytes = ((sizeof(T) * size + m_as - 1) / m_as) * m_as; // Smallest multiple of m_as >= byte count
+    m_container = std::aligned_alloc(m_as, bytes);
+    track(bytes);
+#ifdef MADV_HUGEPAGE
+    if (m_container && m_as % huge_page_size == 0) {
+      ::madvise(m_container, bytes, MADV_HUGEPAGE); // Advisory only, e.g. if huge pages are disabled
+    }
+#endif
     m_begin = reinterpret_cast<T*>(m_container);
     m_end = m_begin + size;
+    m_capacity = bytes / sizeof(T);
   }
 
   static std::size_t align_as(const void* data, Index align)
@@ -307,6 +389,11 @@ protected:
    */
   T* m_end;
 
+  /**
+   * @brief The number of elements which fit in the memory.
+   */
+  std::size_t m_capacity;
+
   /**
    * @brief The required alignment.
    */
@@ -0,0 +1,98 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_BOUNDEDQUEUE_H
+#define _LINXBASE_BOUNDEDQUEUE_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // max
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A bounded first-in first-out queue shared by a producer and a consumer thread.
+ *
+ * Pushing blocks while the queue is full, and popping blocks while it is empty and open.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  explicit BoundedQueue(Index capacity) : m_capacity(std::max<Index>(capacity, 1)) {}
+
+  /**
+   * @brief Push an element, waiting for some room if needed.
+   * @return False if the queue was closed, in which case the element is dropped
+   */
+  bool push(T value)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [&]() {
+      return static_cast<Index>(m_values.size()) < m_capacity || m_closed;
+    });
+    if (m_closed) {
+      return false;
+    }
+    m_values.push_back(std::move(value));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Pop an element, waiting for one if needed.
+   * @return An empty optional if the queue is empty and closed
+   */
+  std::optional<T> pop()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [&]() {
+      return not m_values.empty() || m_closed;
+    });
+    if (m_values.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> out(std::move(m_values.front()));
+    m_values.pop_front();
+    m_not_full.notify_one();
+    return out;
+  }
+
+  /**
+   * @brief Close the queue, i.e. wake up waiting threads and stop waiting.
+   */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+private:
+
+  Index m_capacity;
+  std::deque<T> m_values;
+  bool m_closed = false;
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+};
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,113 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_CONVERSION_H
+#define _LINXBASE_CONVERSION_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // max, min
+#include <limits>
+#include <type_traits>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The type in which conversions are computed.
+ *
+ * Conversions between small integers (up to 16 bits) and `float` are computed in `float`,
+ * which is exact for the input values and doubles the vector width; other conversions are computed in `double`.
+ */
+template <typename T, typename U>
+using ConversionScalar = std::conditional_t<
+    (std::is_same_v<T, float> && std::is_integral_v<U> && sizeof(U) <= 2) ||
+        (std::is_same_v<U, float> && std::is_integral_v<T> && sizeof(T) <= 2),
+    float,
+    double>;
+
+/**
+ * @brief Round and saturate a value to an integral type, or cast it to a floating point type.
+ *
+ * Rounding is half away from zero, and values are clamped before the cast, with selections only,
+ * such that the loop is branchless.
+ */
+template <typename T, typename S>
+LINX_KERNEL T saturate_cast(S value)
+{
+  if constexpr (std::is_integral_v<T>) {
+    constexpr auto lo = static_cast<S>(std::numeric_limits<T>::min());
+    constexpr auto hi = static_cast<S>(std::numeric_limits<T>::max()); // Possibly rounded up
+    const auto rounded = value + (value < 0 ? S(-.5) : S(.5));
+    const auto clamped = std::min(std::max(rounded, lo), hi);
+    return clamped < hi ? static_cast<T>(clamped) : std::numeric_limits<T>::max();
+  } else {
+    return static_cast<T>(value);
+  }
+}
+
+/**
+ * @brief Convert values with a linear transform computed in `S`.
+ *
+ * The function is compiled for several instruction sets, see `instruction_set()`.
+ */
+template <typename T, typename U, typename S>
+LINX_KERNEL void convert_values_kernel(const U* in, Index size, T* out, S scale, S offset)
+{
+  for (Index i = 0; i < size; ++i) {
+    out[i] = saturate_cast<T>(static_cast<S>(in[i]) * scale + offset);
+  }
+}
+
+LINX_MULTIVERSION(convert_values)
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Convert values with a linear transform, in one pass: `out[i] = in[i] * scale + offset`.
+ * @param in The input values
+ * @param size The number of values
+ * @param out The output values
+ * @param scale The scaling factor
+ * @param offset The offset, added after scaling
+ *
+ * Widening (e.g. `short` to `float`) and narrowing (e.g. `float` to `short`) are both supported.
+ * When the output type is integral, values are rounded to the nearest integer and saturated,
+ * such that out-of-range values are clamped to the type limits instead of wrapping around.
+ * NaNs are converted to an unspecified value.
+ *
+ * The loop is branchless and can be vectorized.
+ * Conversions between integers of at most 16 bits and `float` are computed in `float`, others in `double`.
+ */
+template <typename T, typename U>
+void convert_n(const U* in, Index size, T* out, double scale = 1, double offset = 0)
+{
+  using S = Internal::ConversionScalar<T, U>;
+  const auto s = static_cast<S>(scale);
+  const auto o = static_cast<S>(offset);
+  Internal::convert_values(in, size, out, s, o);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Quantize values, i.e. invert the linear transform of `convert_n()`: `out[i] = (in[i] - zero) / scale`.
+ * @param scale The quantization step, e.g. FITS' BSCALE
+ * @param zero The value of the quantized zero, e.g. FITS' BZERO
+ *
+ * This is the reverse of `convert_n(in, size, out, scale, zero)`, up to rounding, with saturation.
+ */
+template <typename T, typename U>
+void quantize_n(const U* in, Index size, T* out, double scale = 1, double zero = 0)
+{
+  convert_n(in, size, out, 1. / scale, -zero / scale);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,122 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_COWHOLDER_H
+#define _LINXBASE_COWHOLDER_H
+
+#include "Linx/Base/TypeUtils.h" // UninitializedTag
+
+#include <algorithm> // copy_n
+#include <memory> // shared_ptr
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Reference-counted data holder with copy-on-write semantics.
+ *
+ * Copies of the holder share the same data, such that copying or passing by value costs O(1),
+ * until one of the copies is modified:
+ * the data is then duplicated, and the modified copy gets its own data.
+ * This makes large rasters cheap to store in containers, or to pass through processing pipelines:
+ *
+ * \code
+ * CowRaster<float> image(shape);
+ * std::vector<CowRaster<float>> history {image, image}; // No deep copy
+ * history[1] += 1; // Deep copy of history[1] only
+ * \endcode
+ *
+ * Writable access to the data, e.g. with non-constant `data()`, `operator[]()` or `begin()`,
+ * calls `detach()`, which duplicates the data if it is shared.
+ * Pointers, references and iterators obtained for writing are therefore valid until the container is copied:
+ * modifying values through them after a copy also modifies the copy.
+ * Similarly, the reference counting is thread-safe, but detaching is not:
+ * a shared container should not be accessed for writing by several threads at the same time,
+ * which is not the case of the parallel pixel-wise operations, which get the data before spawning threads.
+ *
+ * In tight loops, constant access should be preferred to avoid checking the reference count at each access,
+ * or `data()` should be called once outside of the loop.
+ */
+template <typename T>
+class CowHolder {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param size The number of elements
+   * @param data The values to be copied, or `nullptr` to value-initialize the elements
+   */
+  explicit CowHolder(std::size_t size = 0, const T* data = nullptr) : m_size(size), m_container(new T[size]())
+  {
+    if (data) {
+      std::copy_n(data, m_size, m_container.get());
+    }
+  }
+
+  /**
+   * @brief Uninitialized constructor.
+   * @param size The number of elements
+   */
+  CowHolder(std::size_t size, UninitializedTag) : m_size(size), m_container(new T[size]) {}
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  inline const T* begin() const
+  {
+    return m_container.get();
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  inline const T* end() const
+  {
+    return m_container.get() + m_size;
+  }
+
+  /**
+   * @brief Get the number of holders which share the data, including this one.
+   */
+  long use_count() const
+  {
+    return m_container.use_count();
+  }
+
+  /**
+   * @brief Check whether the data is shared with other holders.
+   */
+  bool is_shared() const
+  {
+    return m_container.use_count() > 1;
+  }
+
+  /**
+   * @brief Duplicate the data if it is shared, such that it can be modified.
+   */
+  void detach()
+  {
+    if (is_shared()) {
+      std::shared_ptr<T[]> container(new T[m_size]);
+      std::copy_n(m_container.get(), m_size, container.get());
+      m_container = std::move(container);
+    }
+  }
+
+private:
+
+  /**
+   * @brief The number of elements.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The shared data.
+   */
+  std::shared_ptr<T[]> m_container;
+};
+
+} // namespace Linx
+
+#endif
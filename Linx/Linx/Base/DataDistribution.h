@@ -5,6 +5,8 @@
 #ifndef _LINXBASE_DATADISTRIBUTION_H
 #define _LINXBASE_DATADISTRIBUTION_H
 
+#include "Linx/Base/Selection.h"
+#include "Linx/Base/Summary.h"
 #include "Linx/Base/TypeUtils.h"
 
 #include <algorithm>
@@ -28,6 +30,9 @@ namespace Linx {
  * then it might be faster to completely sort the values by calling `sort()` beforehand.
  * 
  * Methods are not `const` because they involve sorting or caching.
+ * 
+ * For large containers, approximate quantiles can be estimated with bounded memory by a `QuantileSketch`.
+ * When a single exact median or MAD is needed, e.g. per tile, `median()` and `mad()` with a scratch buffer are faster.
  */
 template <typename T>
 class DataDistribution {
@@ -156,7 +161,7 @@ public:
     std::transform(m_values.begin(), m_values.end(), absdev.begin(), [=](auto e) {
       return std::abs(e - m);
     });
-    return DataDistribution<T>(std::move(absdev)).median();
+    return Internal::median_inplace(1, absdev.data(), absdev.size());
   }
 
   /**
@@ -175,7 +180,9 @@ public:
       return nth(f);
     }
     const auto d = n - f;
-    return nth(f) * d + nth(f + 1) * (1. - d); // FIXME linear(&nth(f), d);
+    const auto& lower = nth(f);
+    const auto& upper = m_sorted ? m_values[f + 1] : *std::min_element(m_values.begin() + f + 1, m_values.end());
+    return lower * d + upper * (1. - d); // FIXME linear(&nth(f), d);
   }
 
   /**
@@ -187,25 +194,7 @@ public:
   template <typename TRange>
   std::vector<std::size_t> histogram(const TRange& bins)
   { // FIXME bounds options
-    sort();
-    std::vector<std::size_t> out(std::distance(bins.begin(), bins.end()) - 1);
-    auto it = m_values.begin();
-    auto sup_it = bins.begin();
-    auto count_it = out.begin();
-    while (it != m_values.end() && *it < *sup_it) {
-      ++it;
-    }
-    for (++sup_it; sup_it != bins.end() && count_it != out.end(); ++sup_it) {
-      while (it != m_values.end() && *it < *sup_it) {
-        ++(*count_it);
-        ++it;
-      }
-      ++count_it;
-    }
-    if (it != m_values.end() && *it == bins.back()) {
-      ++(*count_it);
-    }
-    return out;
+    return Linx::histogram(m_values, bins);
   }
 
   /**
@@ -0,0 +1,265 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_DEVICE_H
+#define _LINXBASE_DEVICE_H
+
+#include "Linx/Base/Holders.h" // SizeError
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <type_traits> // remove_pointer_t
+#include <utility> // declval
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Get the number of offloading devices, e.g. GPUs.
+ *
+ * Device code is written with OpenMP target directives, such that a single source serves all vendors.
+ * It is offloaded if the program is compiled with an offloading toolchain,
+ * e.g. `-fopenmp -foffload=nvptx-none` with GCC or `-fopenmp --offload-arch=sm_80` with Clang,
+ * and if a device is available at runtime.
+ * Otherwise, the device is the host itself: device functions run on the CPU and transfers are no-ops.
+ */
+inline Index device_count()
+{
+#ifdef _OPENMP
+  return omp_get_num_devices();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Check whether device functions are offloaded to some device other than the host.
+ */
+inline bool device_available()
+{
+  return device_count() > 0;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief A RAII device-resident copy of a contiguous container, e.g. a raster.
+ *
+ * While the mapping lives, device functions (e.g. `device_generate()` or `device_correlation()`)
+ * work on the device copy of the container without any transfer,
+ * such that a chain of device functions only pays for the transfers of its inputs and outputs.
+ * Transfers are explicit:
+ *
+ * \code
+ * DeviceMapping<Raster<float>> d_in(in); // Upload
+ * DeviceMapping<Raster<float>> d_out(out, false); // Allocate only
+ * device_correlation(in, kernel, out);
+ * device_apply(out, [](auto e) { return e * gain; });
+ * d_out.download();
+ * \endcode
+ *
+ * Transfers can also be asynchronous, in which case they must be completed with `wait()`
+ * before the host copy is accessed or the device copy is used.
+ * The host container must neither be reallocated nor destroyed while it is mapped.
+ */
+template <typename TContainer>
+class DeviceMapping {
+public:
+
+  /**
+   * @brief The value type, which is constant for constant containers.
+   */
+  using Value = std::remove_pointer_t<decltype(std::declval<TContainer&>().data())>;
+
+  /**
+   * @brief Constructor, which allocates the device copy.
+   * @param container The host container
+   * @param upload Whether to initialize the device copy with the host values
+   */
+  explicit DeviceMapping(TContainer& container, bool upload = true) :
+      m_data(container.data()), m_size(static_cast<Index>(container.size()))
+  {
+    auto* data = m_data;
+    const auto size = m_size;
+    if (upload) {
+#pragma omp target enter data map(to : data[0 : size])
+    } else {
+#pragma omp target enter data map(alloc : data[0 : size])
+    }
+  }
+
+  /**
+   * @brief Non-copyable.
+   */
+  DeviceMapping(const DeviceMapping&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  DeviceMapping& operator=(const DeviceMapping&) = delete;
+
+  /**
+   * @brief Destructor, which waits for pending transfers and frees the device copy without downloading it.
+   */
+  ~DeviceMapping()
+  {
+    wait();
+    auto* data = m_data;
+    const auto size = m_size;
+#pragma omp target exit data map(release : data[0 : size])
+  }
+
+  /**
+   * @brief Copy the host values to the device.
+   */
+  void upload()
+  {
+    auto* data = m_data;
+    const auto size = m_size;
+#pragma omp target update to(data[0 : size])
+  }
+
+  /**
+   * @brief Copy the device values to the host.
+   */
+  void download()
+  {
+    auto* data = m_data;
+    const auto size = m_size;
+#pragma omp target update from(data[0 : size])
+  }
+
+  /**
+   * @brief Start copying the host values to the device.
+   */
+  void upload_async()
+  {
+    auto* data = m_data;
+    const auto size = m_size;
+#pragma omp target update to(data[0 : size]) nowait depend(inout : data[0])
+  }
+
+  /**
+   * @brief Start copying the device values to the host.
+   */
+  void download_async()
+  {
+    auto* data = m_data;
+    const auto size = m_size;
+#pragma omp target update from(data[0 : size]) nowait depend(inout : data[0])
+  }
+
+  /**
+   * @brief Wait for the asynchronous transfers started by the calling thread.
+   */
+  void wait()
+  {
+#pragma omp taskwait
+  }
+
+  /**
+   * @brief Get the host address of the mapped values.
+   */
+  Value* data() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Get the number of mapped values.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+private:
+
+  /**
+   * @brief The host values.
+   */
+  Value* m_data;
+
+  /**
+   * @brief The number of values.
+   */
+  Index m_size;
+};
+
+/**
+ * @ingroup pixelwise
+ * @brief Apply a function to each element of a contiguous container on the device.
+ * @param out The container, which is updated as `e = func(e)`
+ * @param func The function, which must be callable on the device, e.g. a lambda of arithmetic expressions
+ *
+ * If the container is mapped (see `DeviceMapping`), the device copy is updated and nothing is transferred;
+ * otherwise, values are transferred both ways.
+ */
+template <typename TOut, typename TFunc>
+TOut& device_apply(TOut& out, TFunc&& func)
+{
+  auto* o = out.data();
+  const auto size = static_cast<Index>(out.size());
+#pragma omp target teams distribute parallel for map(tofrom : o[0 : size])
+  for (Index i = 0; i < size; ++i) {
+    o[i] = func(o[i]);
+  }
+  return out;
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Evaluate an element-wise function of a contiguous container on the device.
+ * @param out The output container, which is assigned `func(a)`
+ * @param func The function, which must be callable on the device
+ * @param a The input container, of the same size as `out`
+ *
+ * Mapped containers are not transferred (see `DeviceMapping`), others are transferred as needed.
+ */
+template <typename TOut, typename TFunc, typename TA>
+TOut& device_generate(TOut& out, TFunc&& func, const TA& a)
+{
+  SizeError::may_throw(a.size(), out.size());
+  auto* o = out.data();
+  const auto* x = a.data();
+  const auto size = static_cast<Index>(out.size());
+#pragma omp target teams distribute parallel for map(to : x[0 : size]) map(from : o[0 : size])
+  for (Index i = 0; i < size; ++i) {
+    o[i] = func(x[i]);
+  }
+  return out;
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Evaluate an element-wise function of two contiguous containers on the device.
+ * @param out The output container, which is assigned `func(a, b)`
+ * @param func The function, which must be callable on the device
+ * @param a The first input container, of the same size as `out`
+ * @param b The second input container, of the same size as `out`
+ *
+ * This is typically used for calibration, e.g. `device_generate(out, [](auto e, auto f) { return e * f; }, raw, flat)`.
+ */
+template <typename TOut, typename TFunc, typename TA, typename TB>
+TOut& device_generate(TOut& out, TFunc&& func, const TA& a, const TB& b)
+{
+  SizeError::may_throw(a.size(), out.size());
+  SizeError::may_throw(b.size(), out.size());
+  auto* o = out.data();
+  const auto* x = a.data();
+  const auto* y = b.data();
+  const auto size = static_cast<Index>(out.size());
+#pragma omp target teams distribute parallel for map(to : x[0 : size], y[0 : size]) map(from : o[0 : size])
+  for (Index i = 0; i < size; ++i) {
+    o[i] = func(x[i], y[i]);
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
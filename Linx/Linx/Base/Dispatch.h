@@ -0,0 +1,293 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_DISPATCH_H
+#define _LINXBASE_DISPATCH_H
+
+#include "Linx/Base/Exceptions.h"
+
+#include <atomic>
+#include <cstdlib> // getenv
+#include <string>
+#include <utility> // forward
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h> // getauxval
+#endif
+
+/**
+ * @brief Whether the hot kernels are compiled for several x86-64 instruction sets.
+ *
+ * Multiply-adds are not contracted into FMA instructions, such that all the variants give bitwise identical results.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LINX_DISPATCH_X86
+#define LINX_TARGET_AVX2 __attribute__((target("avx2,fma"), optimize("fp-contract=off")))
+#define LINX_TARGET_AVX512 \
+  __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma"), optimize("fp-contract=off")))
+#endif
+
+/**
+ * @brief Whether the hot kernels are compiled for SVE in addition to the AArch64 baseline, i.e. NEON.
+ */
+#if defined(__aarch64__) && defined(__linux__) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#define LINX_DISPATCH_SVE
+#define LINX_TARGET_SVE __attribute__((target("+sve")))
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief The instruction sets the hot kernels are compiled for.
+ */
+enum class InstructionSet {
+  Baseline, ///< The instruction set the program is compiled for, e.g. SSE2 on x86-64 or NEON on AArch64
+  Avx2, ///< x86-64 AVX2 and FMA
+  Avx512, ///< x86-64 AVX-512 F, BW, DQ and VL
+  Sve ///< AArch64 SVE
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Get the name of an instruction set, as accepted by `select_instruction_set()`.
+ */
+inline std::string instruction_set_name(InstructionSet set)
+{
+  switch (set) {
+    case InstructionSet::Avx2:
+      return "avx2";
+    case InstructionSet::Avx512:
+      return "avx512";
+    case InstructionSet::Sve:
+      return "sve";
+    default:
+      return "baseline";
+  }
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Check whether the processor supports an instruction set, and the kernels were compiled for it.
+ */
+inline bool supports_instruction_set(InstructionSet set)
+{
+  switch (set) {
+    case InstructionSet::Baseline:
+      return true;
+#ifdef LINX_DISPATCH_X86
+    case InstructionSet::Avx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case InstructionSet::Avx512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+          __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+#endif
+#ifdef LINX_DISPATCH_SVE
+    case InstructionSet::Sve:
+      return getauxval(AT_HWCAP) & HWCAP_SVE;
+#endif
+    default:
+      return false;
+  }
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Get the best instruction set supported by the processor.
+ */
+inline InstructionSet detect_instruction_set()
+{
+  for (auto set : {InstructionSet::Avx512, InstructionSet::Avx2, InstructionSet::Sve}) {
+    if (supports_instruction_set(set)) {
+      return set;
+    }
+  }
+  return InstructionSet::Baseline;
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Parse an instruction set name, or `auto` for the detected one.
+ */
+inline InstructionSet parse_instruction_set(const std::string& name)
+{
+  if (name.empty() || name == "auto") {
+    return detect_instruction_set();
+  }
+  for (auto set : {InstructionSet::Baseline, InstructionSet::Avx2, InstructionSet::Avx512, InstructionSet::Sve}) {
+    if (name == instruction_set_name(set)) {
+      return set;
+    }
+  }
+  throw Exception("Unknown instruction set: " + name);
+}
+
+/**
+ * @brief The state of the dispatcher.
+ */
+struct Dispatcher {
+  /**
+   * @brief Initialize the active instruction set from the `LINX_ISA` environment variable, if valid.
+   */
+  Dispatcher() : active(detect_instruction_set()), origin("detected")
+  {
+    const char* env = std::getenv("LINX_ISA");
+    if (not env) {
+      return;
+    }
+    try {
+      const auto set = parse_instruction_set(env);
+      if (supports_instruction_set(set)) {
+        active = set;
+        origin = std::string("LINX_ISA=") + env;
+      } else {
+        origin = std::string("LINX_ISA=") + env + " unsupported, detected";
+      }
+    } catch (const Exception&) {
+      origin = std::string("LINX_ISA=") + env + " unknown, detected";
+    }
+  }
+
+  static Dispatcher& instance()
+  {
+    static Dispatcher out;
+    return out;
+  }
+
+  std::atomic<InstructionSet> active;
+  std::string origin;
+};
+
+/**
+ * @brief Get the active instruction set.
+ */
+inline InstructionSet active_instruction_set()
+{
+  return Dispatcher::instance().active.load(std::memory_order_relaxed);
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Get the instruction set of the hot kernels.
+ *
+ * Vectorized engines (shift-and-accumulate and static correlations, reductions, conversions,
+ * sliding extrema and fast math functions) are compiled for several instruction sets,
+ * and the variant is selected at runtime, such that a single binary runs efficiently on heterogeneous nodes.
+ * By default, the best instruction set supported by the processor is selected.
+ * It can be overridden with the `LINX_ISA` environment variable (`baseline`, `avx2`, `avx512`, `sve` or `auto`),
+ * or with `select_instruction_set()`, e.g. from the `isa` program option of `ExecutionContext`.
+ */
+inline InstructionSet instruction_set()
+{
+  return Internal::active_instruction_set();
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Select the instruction set of the hot kernels.
+ *
+ * Unsupported instruction sets are rejected with an exception.
+ */
+inline void select_instruction_set(InstructionSet set)
+{
+  if (not supports_instruction_set(set)) {
+    throw Exception("Unsupported instruction set: " + instruction_set_name(set));
+  }
+  auto& dispatcher = Internal::Dispatcher::instance();
+  dispatcher.active = set;
+  dispatcher.origin = "selected";
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Select the instruction set of the hot kernels by name, or `auto` for the detected one.
+ */
+inline void select_instruction_set(const std::string& name)
+{
+  select_instruction_set(Internal::parse_instruction_set(name));
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Describe the active instruction set, e.g. "avx2 (selected; detected: avx512)".
+ */
+inline std::string instruction_set_report()
+{
+  const auto& dispatcher = Internal::Dispatcher::instance();
+  return instruction_set_name(dispatcher.active) + " (" + dispatcher.origin +
+      "; detected: " + instruction_set_name(detect_instruction_set()) + ")";
+}
+
+} // namespace Linx
+
+/**
+ * @brief Define a function which dispatches its calls to variants of a kernel compiled for several instruction sets.
+ * @param name The function name, where `name##_kernel` is the kernel function template
+ *
+ * The kernel is marked `LINX_KERNEL` such that it is inlined into each variant and compiled for its instruction set.
+ * Call overhead is a relaxed atomic load and a switch, such that kernels should work on whole rows or blocks.
+ */
+#if defined(LINX_DISPATCH_X86)
+#define LINX_MULTIVERSION(name) \
+  template <typename... TArgs> \
+  LINX_TARGET_AVX512 decltype(auto) name##_avx512(TArgs&&... args) \
+  { \
+    return name##_kernel(std::forward<TArgs>(args)...); \
+  } \
+  template <typename... TArgs> \
+  LINX_TARGET_AVX2 decltype(auto) name##_avx2(TArgs&&... args) \
+  { \
+    return name##_kernel(std::forward<TArgs>(args)...); \
+  } \
+  template <typename... TArgs> \
+  inline decltype(auto) name(TArgs&&... args) \
+  { \
+    switch (Linx::Internal::active_instruction_set()) { \
+      case Linx::InstructionSet::Avx512: \
+        return name##_avx512(std::forward<TArgs>(args)...); \
+      case Linx::InstructionSet::Avx2: \
+        return name##_avx2(std::forward<TArgs>(args)...); \
+      default: \
+        return name##_kernel(std::forward<TArgs>(args)...); \
+    } \
+  }
+#elif defined(LINX_DISPATCH_SVE)
+#define LINX_MULTIVERSION(name) \
+  template <typename... TArgs> \
+  LINX_TARGET_SVE decltype(auto) name##_sve(TArgs&&... args) \
+  { \
+    return name##_kernel(std::forward<TArgs>(args)...); \
+  } \
+  template <typename... TArgs> \
+  inline decltype(auto) name(TArgs&&... args) \
+  { \
+    if (Linx::Internal::active_instruction_set() == Linx::InstructionSet::Sve) { \
+      return name##_sve(std::forward<TArgs>(args)...); \
+    } \
+    return name##_kernel(std::forward<TArgs>(args)...); \
+  }
+#else
+#define LINX_MULTIVERSION(name) \
+  template <typename... TArgs> \
+  inline decltype(auto) name(TArgs&&... args) \
+  { \
+    return name##_kernel(std::forward<TArgs>(args)...); \
+  }
+#endif
+
+/**
+ * @brief The attribute of multiversioned kernels, which forces their inlining into each variant.
+ */
+#if defined(__GNUC__)
+#define LINX_KERNEL __attribute__((always_inline)) inline
+#else
+#define LINX_KERNEL inline
+#endif
+
+#endif
@@ -0,0 +1,372 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_FASTMATH_H
+#define _LINXBASE_FASTMATH_H
+
+#include "Linx/Base/Dispatch.h"
+
+#include <cmath>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <cstring> // memcpy
+#include <limits>
+#include <type_traits>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The bit-level properties of a floating point type.
+ */
+template <typename T>
+struct FloatBits;
+
+template <>
+struct FloatBits<float> {
+  using Bits = std::uint32_t;
+  static constexpr int Mantissa = 23; ///< The number of mantissa bits
+  static constexpr Bits Bias = 127; ///< The exponent bias
+  static constexpr Bits ExponentMask = 0xff; ///< The exponent mask, once shifted
+  static constexpr float Shifter = 12582912.f; ///< 1.5 * 2^23, such that `x + Shifter` rounds `x` to an integer
+};
+
+template <>
+struct FloatBits<double> {
+  using Bits = std::uint64_t;
+  static constexpr int Mantissa = 52;
+  static constexpr Bits Bias = 1023;
+  static constexpr Bits ExponentMask = 0x7ff;
+  static constexpr double Shifter = 6755399441055744.; ///< 1.5 * 2^52
+};
+
+/**
+ * @brief Reinterpret a floating point value as an unsigned integer.
+ */
+template <typename T>
+inline typename FloatBits<T>::Bits to_bits(T x)
+{
+  typename FloatBits<T>::Bits out;
+  std::memcpy(&out, &x, sizeof(T));
+  return out;
+}
+
+/**
+ * @brief Reinterpret an unsigned integer as a floating point value.
+ */
+template <typename T>
+inline T from_bits(typename FloatBits<T>::Bits bits)
+{
+  T out;
+  std::memcpy(&out, &bits, sizeof(T));
+  return out;
+}
+
+/**
+ * @brief Compute 2^n for an integer `n` in the normal exponent range, given as a value shifted by `Shifter`.
+ */
+template <typename T>
+inline T shifted_exp2(typename FloatBits<T>::Bits shifted)
+{
+  using Traits = FloatBits<T>;
+  return from_bits<T>((shifted - to_bits(Traits::Shifter) + Traits::Bias) << Traits::Mantissa);
+}
+
+/**
+ * @brief Select `a` if `condition` is true, or `b` otherwise, without branching.
+ *
+ * The selection is performed on the bits, since the compiler would branch
+ * rather than vectorize the conditional operator applied to computed values.
+ */
+template <typename T>
+inline T select(bool condition, T a, T b)
+{
+  const auto mask = typename FloatBits<T>::Bits(0) - condition;
+  return from_bits<T>((to_bits(a) & mask) | (to_bits(b) & ~mask));
+}
+
+/**
+ * @brief Evaluate a polynomial with Horner's scheme, from the highest degree coefficient.
+ */
+template <typename T>
+inline T horner(T, T c)
+{
+  return c;
+}
+
+template <typename T, typename... Ts>
+inline T horner(T x, T c, Ts... cs)
+{
+  return horner(x, cs...) * x + c;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free exponential.
+ *
+ * The argument is reduced to `r` in `[-ln(2) / 2, ln(2) / 2]` with `x = n ln(2) + r`,
+ * and `exp(r)` is approximated by its Taylor polynomial of degree 13 (7 for `float`).
+ * The maximum error is 1.2 ULP, overflows return infinity, underflows return 0 or subnormal values,
+ * and NaNs are propagated.
+ *
+ * Since there is no branch, loops of `fast_exp()` are vectorized by the compiler.
+ * For other arithmetic types than `float` and `double`, `std::exp()` is called.
+ */
+template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+inline T fast_exp(T x)
+{
+  if constexpr (std::is_same_v<T, double>) {
+    constexpr double log2e = 1.4426950408889634;
+    constexpr double ln2_hi = 6.93147180369123816490e-01;
+    constexpr double ln2_lo = 1.90821492927058770002e-10;
+    const auto xc = Internal::select(x < -745.2, -745.2, Internal::select(x > 709.8, 709.8, x));
+    const auto t = xc * log2e + Internal::FloatBits<double>::Shifter;
+    const auto n = t - Internal::FloatBits<double>::Shifter;
+    const auto r = (xc - n * ln2_hi) - n * ln2_lo;
+    const auto p = Internal::horner(
+        r,
+        1.,
+        1.,
+        1. / 2,
+        1. / 6,
+        1. / 24,
+        1. / 120,
+        1. / 720,
+        1. / 5040,
+        1. / 40320,
+        1. / 362880,
+        1. / 3628800,
+        1. / 39916800,
+        1. / 479001600,
+        1. / 6227020800);
+    // 2^n is split in two factors to cover the whole range without overflowing the exponent
+    const auto bits = Internal::to_bits(t) - Internal::to_bits(Internal::FloatBits<double>::Shifter);
+    const auto half = static_cast<std::uint64_t>(static_cast<std::int64_t>(bits) >> 1);
+    const auto shifter = Internal::to_bits(Internal::FloatBits<double>::Shifter);
+    auto out = p * Internal::shifted_exp2<double>(half + shifter) *
+        Internal::shifted_exp2<double>(bits - half + shifter);
+    out = Internal::select(x > 709.782712893384, std::numeric_limits<double>::infinity(), out);
+    out = Internal::select(x < -745.1332191019412, 0., out);
+    return Internal::select(x != x, x, out);
+  } else if constexpr (std::is_same_v<T, float>) {
+    constexpr float log2e = 1.44269504f;
+    constexpr float ln2_hi = 0.693359375f;
+    constexpr float ln2_lo = -2.12194440e-4f;
+    const auto xc = Internal::select(x < -104.f, -104.f, Internal::select(x > 88.8f, 88.8f, x));
+    const auto t = xc * log2e + Internal::FloatBits<float>::Shifter;
+    const auto n = t - Internal::FloatBits<float>::Shifter;
+    const auto r = (xc - n * ln2_hi) - n * ln2_lo;
+    const auto p = Internal::horner(r, 1.f, 1.f, 1.f / 2, 1.f / 6, 1.f / 24, 1.f / 120, 1.f / 720, 1.f / 5040);
+    const auto bits = Internal::to_bits(t) - Internal::to_bits(Internal::FloatBits<float>::Shifter);
+    const auto half = static_cast<std::uint32_t>(static_cast<std::int32_t>(bits) >> 1);
+    const auto shifter = Internal::to_bits(Internal::FloatBits<float>::Shifter);
+    auto out =
+        p * Internal::shifted_exp2<float>(half + shifter) * Internal::shifted_exp2<float>(bits - half + shifter);
+    out = Internal::select(x > 88.7228394f, std::numeric_limits<float>::infinity(), out);
+    out = Internal::select(x < -103.972084f, 0.f, out);
+    return Internal::select(x != x, x, out);
+  } else {
+    return std::exp(x);
+  }
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free natural logarithm.
+ *
+ * The argument is decomposed as `x = m 2^e` with `m` in `[sqrt(2) / 2, sqrt(2)[`,
+ * and `log(m) = 2 atanh(s)`, with `s = (m - 1) / (m + 1)`, is approximated by its odd Taylor polynomial
+ * of degree 21 (11 for `float`).
+ * The maximum error is 1 ULP, and special values follow `std::log()`.
+ *
+ * For other arithmetic types than `float` and `double`, `std::log()` is called.
+ */
+template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+inline T fast_log(T x)
+{
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    using Traits = Internal::FloatBits<T>;
+    using Bits = typename Traits::Bits;
+    constexpr auto ln2_hi = T(std::is_same_v<T, double> ? 6.93147180369123816490e-01 : 0.693359375);
+    constexpr auto ln2_lo = T(std::is_same_v<T, double> ? 1.90821492927058770002e-10 : -2.12194440e-4);
+    constexpr auto sqrt2 = T(1.41421356237309504880);
+    const bool subnormal = x < std::numeric_limits<T>::min();
+    const auto scale = T(std::is_same_v<T, double> ? 18014398509481984. : 16777216.); // 2^54 or 2^24
+    const auto xs = Internal::select(subnormal, x * scale, x);
+    const auto bits = Internal::to_bits(xs);
+    const Bits one = Internal::to_bits(T(1));
+    auto m = Internal::from_bits<T>((bits & ((Bits(1) << Traits::Mantissa) - 1)) | one);
+    // The integer exponent is converted to floating point through the bits, for vectorization
+    const auto exponent = (bits >> Traits::Mantissa) & Traits::ExponentMask;
+    const auto biased = Internal::from_bits<T>(exponent | Internal::to_bits(Traits::Shifter));
+    const auto subnormal_shift = Internal::select(subnormal, T(std::is_same_v<T, double> ? 54 : 24), T(0));
+    auto e = biased - Traits::Shifter - T(Traits::Bias) - subnormal_shift;
+    const bool big = m > sqrt2;
+    m = Internal::select(big, m * T(0.5), m);
+    e = Internal::select(big, e + 1, e);
+    const auto f = m - 1;
+    const auto s = f / (f + 2);
+    const auto z = s * s;
+    T p;
+    if constexpr (std::is_same_v<T, double>) {
+      p = Internal::horner(
+          z,
+          1. / 3,
+          1. / 5,
+          1. / 7,
+          1. / 9,
+          1. / 11,
+          1. / 13,
+          1. / 15,
+          1. / 17,
+          1. / 19,
+          1. / 21);
+    } else {
+      p = Internal::horner(z, 1.f / 3, 1.f / 5, 1.f / 7, 1.f / 9, 1.f / 11);
+    }
+    const auto hf = f * f * T(0.5); // log(m) = f - hf + s (hf + R), as in fdlibm, for accuracy
+    auto out = e * ln2_hi - ((hf - (s * (hf + 2 * z * p) + e * ln2_lo)) - f);
+    out = Internal::select(x == 0, -std::numeric_limits<T>::infinity(), out);
+    out = Internal::select(x < 0, std::numeric_limits<T>::quiet_NaN(), out);
+    out = Internal::select(x == std::numeric_limits<T>::infinity(), x, out);
+    return Internal::select(x != x, x, out);
+  } else {
+    return std::log(x);
+  }
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the sine or cosine in a branch-free way.
+ * @tparam Cosine Compute the cosine if true, or the sine otherwise
+ */
+template <bool Cosine, typename T>
+inline T fast_sincos(T x)
+{
+  using Traits = FloatBits<T>;
+  using Bits = typename Traits::Bits;
+  constexpr auto two_over_pi = T(0.636619772367581343076);
+  T r;
+  const auto t = x * two_over_pi + Traits::Shifter;
+  const auto q = t - Traits::Shifter;
+  if constexpr (std::is_same_v<T, double>) {
+    // Cody-Waite reduction, exact for |q| < 2^20
+    r = ((x - q * 1.57079632673412561417e+00) - q * 6.07710050630396597660e-11) - q * 2.02226624879595063154e-21;
+  } else {
+    // Two-part reduction in double precision, which is accurate near the zeros
+    const auto xd = static_cast<double>(x);
+    const auto qd = static_cast<double>(q);
+    r = static_cast<float>((xd - qd * 1.57079632673412561417e+00) - qd * 6.07710050650619224932e-11);
+  }
+  const auto z = r * r;
+  T sin_r;
+  T cos_r;
+  if constexpr (std::is_same_v<T, double>) {
+    sin_r = r + r * z *
+                    horner(
+                        z,
+                        -1. / 6,
+                        1. / 120,
+                        -1. / 5040,
+                        1. / 362880,
+                        -1. / 39916800,
+                        1. / 6227020800,
+                        -1. / 1307674368000);
+    cos_r = 1 + z * horner(
+                        z,
+                        -1. / 2,
+                        1. / 24,
+                        -1. / 720,
+                        1. / 40320,
+                        -1. / 3628800,
+                        1. / 479001600,
+                        -1. / 87178291200,
+                        1. / 20922789888000);
+  } else {
+    sin_r = r + r * z * horner(z, -1.f / 6, 1.f / 120, -1.f / 5040, 1.f / 362880);
+    cos_r = 1 + z * horner(z, -1.f / 2, 1.f / 24, -1.f / 720, 1.f / 40320, -1.f / 3628800);
+  }
+  const auto quadrant = to_bits(t) - to_bits(Traits::Shifter) + (Cosine ? 1 : 0);
+  const auto out = select((quadrant & 1) != 0, cos_r, sin_r); // cos(x) = sin(x + pi / 2)
+  const auto sign = ((quadrant >> 1) & 1) << (sizeof(T) * 8 - 1);
+  return from_bits<T>(to_bits(out) ^ static_cast<Bits>(sign));
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free sine.
+ *
+ * The argument is reduced to `[-pi / 4, pi / 4]` with a Cody-Waite reduction,
+ * and the sine or cosine of the reduced argument is approximated by its Taylor polynomial.
+ * The maximum error is 2.5 ULP (1.5 ULP for `float`) for `|x| < 10^6`; accuracy degrades beyond.
+ *
+ * For other arithmetic types than `float` and `double`, `std::sin()` is called.
+ */
+template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+inline T fast_sin(T x)
+{
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    return Internal::fast_sincos<false>(x);
+  } else {
+    return std::sin(x);
+  }
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Branch-free cosine.
+ * @copydetails fast_sin()
+ */
+template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+inline T fast_cos(T x)
+{
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    return Internal::fast_sincos<true>(x);
+  } else {
+    return std::cos(x);
+  }
+}
+
+#define LINX_FAST_MATH_KERNEL(function) \
+  namespace Internal { \
+  template <typename T> \
+  LINX_KERNEL void fast_##function##_n_kernel(T* data, std::size_t size) \
+  { \
+    for (std::size_t i = 0; i < size; ++i) { \
+      data[i] = fast_##function(data[i]); \
+    } \
+  } \
+  LINX_MULTIVERSION(fast_##function##_n) \
+  } \
+  /** @brief Apply `fast_##function##()` in place to contiguous data, with runtime instruction set dispatch. */ \
+  inline void fast_##function(float* data, std::size_t size) \
+  { \
+    Internal::fast_##function##_n(data, size); \
+  } \
+  /** @brief Apply `fast_##function##()` in place to contiguous data, with runtime instruction set dispatch. */ \
+  inline void fast_##function(double* data, std::size_t size) \
+  { \
+    Internal::fast_##function##_n(data, size); \
+  }
+
+LINX_FAST_MATH_KERNEL(exp)
+LINX_FAST_MATH_KERNEL(log)
+LINX_FAST_MATH_KERNEL(sin)
+LINX_FAST_MATH_KERNEL(cos)
+
+#undef LINX_FAST_MATH_KERNEL
+
+} // namespace Linx
+
+#endif
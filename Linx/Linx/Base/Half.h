@@ -0,0 +1,415 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_HALF_H
+#define _LINXBASE_HALF_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <cstdint>
+#include <cstring> // memcpy
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the bits of a float.
+ */
+inline std::uint32_t float_bits(float in)
+{
+  std::uint32_t out;
+  std::memcpy(&out, &in, sizeof(out));
+  return out;
+}
+
+/**
+ * @brief Make a float from its bits.
+ */
+inline float bits_float(std::uint32_t in)
+{
+  float out;
+  std::memcpy(&out, &in, sizeof(out));
+  return out;
+}
+
+/**
+ * @brief IEEE 754 binary16 encoding, with 5 exponent bits and 10 mantissa bits.
+ */
+struct HalfCodec {
+  static constexpr int digits = 11;
+  static constexpr int digits10 = 3;
+  static constexpr int max_digits10 = 5;
+  static constexpr int min_exponent = -13;
+  static constexpr int max_exponent = 16;
+  static constexpr std::uint16_t min = 0x0400; // 2^-14
+  static constexpr std::uint16_t max = 0x7BFF; // 65504
+  static constexpr std::uint16_t lowest = 0xFBFF;
+  static constexpr std::uint16_t epsilon = 0x1400; // 2^-10
+  static constexpr std::uint16_t infinity = 0x7C00;
+  static constexpr std::uint16_t quiet_nan = 0x7E00;
+  static constexpr std::uint16_t denorm_min = 0x0001;
+
+  /**
+   * @brief Encode a float, with round-to-nearest-even.
+   */
+  static inline std::uint16_t encode(float in)
+  {
+#ifdef __F16C__
+    return _cvtss_sh(in, _MM_FROUND_TO_NEAREST_INT);
+#else
+    auto f = float_bits(in);
+    const auto sign = f & 0x80000000;
+    f ^= sign;
+    std::uint32_t out;
+    if (f >= 0x47800000) { // Overflow, infinity or NaN
+      out = f > 0x7F800000 ? 0x7E00 : 0x7C00;
+    } else if (f < 0x38800000) { // Subnormal or zero: let the FPU round
+      out = float_bits(bits_float(f) + 0.5F) - 0x3F000000;
+    } else {
+      const auto odd = (f >> 13) & 1;
+      f += 0xC8000FFF + odd; // Rebias the exponent and round
+      out = f >> 13;
+    }
+    return static_cast<std::uint16_t>(out | (sign >> 16));
+#endif
+  }
+
+  /**
+   * @brief Decode into a float, which is exact.
+   */
+  static inline float decode(std::uint16_t in)
+  {
+#ifdef __F16C__
+    return _cvtsh_ss(in);
+#else
+    constexpr std::uint32_t shifted_exp = 0x7C00 << 13;
+    auto out = std::uint32_t(in & 0x7FFF) << 13;
+    const auto exp = shifted_exp & out;
+    out += (127 - 15) << 23;
+    if (exp == shifted_exp) { // Infinity or NaN
+      out += (128 - 16) << 23;
+    } else if (exp == 0) { // Subnormal or zero: renormalize
+      out += 1 << 23;
+      out = float_bits(bits_float(out) - bits_float(113 << 23));
+    }
+    return bits_float(out | (std::uint32_t(in & 0x8000) << 16));
+#endif
+  }
+};
+
+/**
+ * @brief bfloat16 encoding, i.e. the upper 16 bits of a float, with 8 exponent bits and 7 mantissa bits.
+ */
+struct BFloat16Codec {
+  static constexpr int digits = 8;
+  static constexpr int digits10 = 2;
+  static constexpr int max_digits10 = 4;
+  static constexpr int min_exponent = std::numeric_limits<float>::min_exponent;
+  static constexpr int max_exponent = std::numeric_limits<float>::max_exponent;
+  static constexpr std::uint16_t min = 0x0080;
+  static constexpr std::uint16_t max = 0x7F7F;
+  static constexpr std::uint16_t lowest = 0xFF7F;
+  static constexpr std::uint16_t epsilon = 0x3C00; // 2^-7
+  static constexpr std::uint16_t infinity = 0x7F80;
+  static constexpr std::uint16_t quiet_nan = 0x7FC0;
+  static constexpr std::uint16_t denorm_min = 0x0001;
+
+  /**
+   * @brief Encode a float, with round-to-nearest-even.
+   */
+  static inline std::uint16_t encode(float in)
+  {
+    const auto f = float_bits(in);
+    if ((f & 0x7FFFFFFF) > 0x7F800000) { // NaN: truncate and keep quiet
+      return static_cast<std::uint16_t>((f >> 16) | 0x40);
+    }
+    return static_cast<std::uint16_t>((f + 0x7FFF + ((f >> 16) & 1)) >> 16);
+  }
+
+  /**
+   * @brief Decode into a float, which is exact.
+   */
+  static inline float decode(std::uint16_t in)
+  {
+    return bits_float(std::uint32_t(in) << 16);
+  }
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief A 16-bit floating point storage type.
+ * @tparam TCodec The encoding
+ *
+ * Values are stored on 16 bits, and converted to and from `float` on load and store,
+ * such that all the computations are made in `float`, and only the storage precision is reduced.
+ * This halves the memory footprint and bandwidth of intermediate products which do not need 32-bit precision,
+ * e.g. quotient maps or masks.
+ * `Raster<Half>` and `Raster<BFloat16>` support element-wise arithmetic and mathematical functions,
+ * and are filtered by `float` kernels, with `float` outputs.
+ *
+ * Conversions use the F16C instructions if available, i.e. if compiled with `-mf16c` or `-march` of a recent CPU,
+ * and bulk conversions with `convert_n()` are vectorized.
+ *
+ * @see `Half`
+ * @see `BFloat16`
+ */
+template <typename TCodec>
+class StorageFloat {
+public:
+
+  /**
+   * @brief Default constructor, which sets the value to zero.
+   */
+  constexpr StorageFloat() = default;
+
+  /**
+   * @brief Conversion constructor, with round-to-nearest-even.
+   */
+  StorageFloat(float value) : m_bits(TCodec::encode(value)) {}
+
+  /**
+   * @brief Make a value from its bits.
+   */
+  static constexpr StorageFloat from_bits(std::uint16_t bits)
+  {
+    StorageFloat out;
+    out.m_bits = bits;
+    return out;
+  }
+
+  /**
+   * @brief Get the bits.
+   */
+  std::uint16_t bits() const
+  {
+    return m_bits;
+  }
+
+  /**
+   * @brief Convert to `float`, which is exact.
+   */
+  operator float() const
+  {
+    return TCodec::decode(m_bits);
+  }
+
+  /**
+   * @brief Add some value.
+   */
+  StorageFloat& operator+=(float rhs)
+  {
+    return *this = float(*this) + rhs;
+  }
+
+  /**
+   * @brief Subtract some value.
+   */
+  StorageFloat& operator-=(float rhs)
+  {
+    return *this = float(*this) - rhs;
+  }
+
+  /**
+   * @brief Multiply by some value.
+   */
+  StorageFloat& operator*=(float rhs)
+  {
+    return *this = float(*this) * rhs;
+  }
+
+  /**
+   * @brief Divide by some value.
+   */
+  StorageFloat& operator/=(float rhs)
+  {
+    return *this = float(*this) / rhs;
+  }
+
+private:
+
+  /**
+   * @brief The encoded value.
+   */
+  std::uint16_t m_bits = 0;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief IEEE 754 half-precision storage type.
+ *
+ * The range is about ±65504, and the precision is 11 bits, i.e. a relative error under 5e-4,
+ * which is enough for most intermediate maps, but not for accumulations.
+ */
+using Half = StorageFloat<Internal::HalfCodec>;
+
+/**
+ * @ingroup data_classes
+ * @brief bfloat16 storage type.
+ *
+ * The range is that of `float`, and the precision is 8 bits, i.e. a relative error under 4e-3.
+ */
+using BFloat16 = StorageFloat<Internal::BFloat16Codec>;
+
+/**
+ * @relatesalso StorageFloat
+ * @brief Insert the value into a stream.
+ */
+template <typename TCodec>
+std::ostream& operator<<(std::ostream& os, const StorageFloat<TCodec>& value)
+{
+  return os << float(value);
+}
+
+/// @cond
+template <typename TCodec>
+struct TypeTraits<StorageFloat<TCodec>> {
+  using Floating = float;
+
+  using Scalar = StorageFloat<TCodec>;
+
+  static inline Scalar from_scalar(Scalar in)
+  {
+    return in;
+  }
+
+  template <typename TFunc, typename TArg>
+  static inline Scalar apply_scalar(TFunc&& func, TArg&& arg)
+  {
+    return std::forward<TFunc>(func)(std::forward<TArg>(arg));
+  }
+};
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Decode 16-bit floating point values into `float`s.
+ *
+ * With F16C, half-precision values are decoded by packs of 8.
+ */
+template <typename TCodec>
+void convert_n(const StorageFloat<TCodec>* in, Index size, float* out, double scale = 1, double offset = 0)
+{
+  Index i = 0;
+#ifdef __F16C__
+  if constexpr (std::is_same_v<TCodec, Internal::HalfCodec>) {
+    if (scale == 1 && offset == 0) {
+      for (; i + 8 <= size; i += 8) {
+        const auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+      }
+    }
+  }
+#endif
+  const auto s = static_cast<float>(scale);
+  const auto o = static_cast<float>(offset);
+  for (; i < size; ++i) {
+    out[i] = float(in[i]) * s + o;
+  }
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Encode `float`s into 16-bit floating point values, with round-to-nearest-even.
+ *
+ * With F16C, half-precision values are encoded by packs of 8.
+ */
+template <typename TCodec>
+void convert_n(const float* in, Index size, StorageFloat<TCodec>* out, double scale = 1, double offset = 0)
+{
+  Index i = 0;
+#ifdef __F16C__
+  if constexpr (std::is_same_v<TCodec, Internal::HalfCodec>) {
+    if (scale == 1 && offset == 0) {
+      for (; i + 8 <= size; i += 8) {
+        const auto h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+      }
+    }
+  }
+#endif
+  const auto s = static_cast<float>(scale);
+  const auto o = static_cast<float>(offset);
+  for (; i < size; ++i) {
+    out[i] = in[i] * s + o;
+  }
+}
+
+} // namespace Linx
+
+/// @cond
+namespace std {
+
+template <typename TCodec>
+struct numeric_limits<Linx::StorageFloat<TCodec>> {
+  using T = Linx::StorageFloat<TCodec>;
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr bool is_iec559 = std::is_same_v<TCodec, Linx::Internal::HalfCodec>;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_modulo = false;
+  static constexpr int radix = 2;
+  static constexpr int digits = TCodec::digits;
+  static constexpr int digits10 = TCodec::digits10;
+  static constexpr int max_digits10 = TCodec::max_digits10;
+  static constexpr int min_exponent = TCodec::min_exponent;
+  static constexpr int max_exponent = TCodec::max_exponent;
+  static constexpr std::float_round_style round_style = std::round_to_nearest;
+
+  static constexpr T min()
+  {
+    return T::from_bits(TCodec::min);
+  }
+
+  static constexpr T max()
+  {
+    return T::from_bits(TCodec::max);
+  }
+
+  static constexpr T lowest()
+  {
+    return T::from_bits(TCodec::lowest);
+  }
+
+  static constexpr T epsilon()
+  {
+    return T::from_bits(TCodec::epsilon);
+  }
+
+  static constexpr T infinity()
+  {
+    return T::from_bits(TCodec::infinity);
+  }
+
+  static constexpr T quiet_NaN()
+  {
+    return T::from_bits(TCodec::quiet_nan);
+  }
+
+  static constexpr T denorm_min()
+  {
+    return T::from_bits(TCodec::denorm_min);
+  }
+};
+
+} // namespace std
+/// @endcond
+
+#endif
@@ -6,6 +6,7 @@
 #define _LINXBASE_HOLDER_H
 
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/MemoryTracker.h"
 
 #include <algorithm> // copy_n
 #include <array>
@@ -63,9 +64,10 @@ inline const T* data(const T (&c)[N]) noexcept
  * The class can be specialized for any continuous container,
  * in which case the specialization should satisfy the `ContiguousRange` requirements.
  * @satisfies{ContiguousRange}
+ * @see `MemoryTracker`
  */
 template <typename TContainer>
-class StdHolder {
+class StdHolder : private Internal::MemoryTicket {
 public:
 
   /**
@@ -80,7 +82,8 @@ public:
    * @brief Default or size-based constructor.
    */
   template <typename U = typename TContainer::value_type>
-  explicit StdHolder(std::size_t size, U* data = nullptr) : m_container(size)
+  explicit StdHolder(std::size_t size, U* data = nullptr) :
+      Internal::MemoryTicket(size * sizeof(typename TContainer::value_type)), m_container(size)
   {
     if (data) {
       std::copy_n(data, size, const_cast<typename TContainer::value_type*>(this->begin()));
@@ -90,7 +93,8 @@ public:
   /**
    * @brief Container-move constructor.
    */
-  explicit StdHolder(std::size_t size, Container&& container) : m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Container&& container) :
+      Internal::MemoryTicket(size * sizeof(typename TContainer::value_type)), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
@@ -123,8 +127,28 @@ public:
     return &*m_container.end();
   }
 
+  /**
+   * @brief Get the number of elements which can be held without reallocation.
+   */
+  std::size_t capacity() const
+  {
+    return m_container.capacity();
+  }
+
   /// @group_modifiers
 
+  /**
+   * @brief Change the number of elements.
+   * 
+   * Memory is reallocated only if the new size exceeds the capacity.
+   * The leading elements are preserved, and the new ones are value-initialized.
+   */
+  void resize(std::size_t size)
+  {
+    m_container.resize(size);
+    track(m_container.capacity() * sizeof(typename TContainer::value_type));
+  }
+
   /**
    * @brief Move the container.
    * 
@@ -143,6 +167,7 @@ public:
   Container& move_to(Container& destination)
   {
     destination = std::move(this->m_container);
+    untrack();
     return destination;
   }
 
@@ -214,19 +239,21 @@ private:
  * @brief `std::unique_ptr` specialization.
  */
 template <typename T>
-class StdHolder<std::unique_ptr<T[]>> {
+class StdHolder<std::unique_ptr<T[]>> : private Internal::MemoryTicket {
 public:
 
   using Container = std::unique_ptr<T[]>;
 
-  explicit StdHolder(std::size_t size, const T* data = nullptr) : m_size(size), m_container {new T[m_size]}
+  explicit StdHolder(std::size_t size, const T* data = nullptr) :
+      Internal::MemoryTicket(size * sizeof(T)), m_size(size), m_container {new T[m_size]}
   {
     if (data) {
       std::copy_n(data, m_size, m_container.get());
     }
   }
 
-  explicit StdHolder(std::size_t size, Container&& container) : m_size(size), m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Container&& container) :
+      Internal::MemoryTicket(size * sizeof(T)), m_size(size), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
@@ -241,6 +268,7 @@ public:
 
   friend void swap(StdHolder& lhs, StdHolder& rhs)
   {
+    swap(static_cast<Internal::MemoryTicket&>(lhs), static_cast<Internal::MemoryTicket&>(rhs));
     std::swap(lhs.m_size, rhs.m_size);
     std::swap(lhs.m_container, rhs.m_container);
   }
@@ -263,6 +291,7 @@ public:
   Container& move_to(Container& destination)
   {
     destination = std::move(this->m_container);
+    untrack();
     return destination;
   }
 
@@ -0,0 +1,397 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_MEMORYPOOL_H
+#define _LINXBASE_MEMORYPOOL_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/MemoryTracker.h"
+#include "Linx/Base/TypeUtils.h" // UninitializedTag
+
+#include <algorithm> // copy_n, fill_n
+#include <atomic>
+#include <cstdlib> // aligned_alloc, free
+#include <map>
+#include <new> // bad_alloc
+#include <type_traits>
+#include <utility> // swap
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The free blocks of a thread, by byte size.
+ */
+struct PoolBlocks {
+  /**
+   * @brief Constructor.
+   */
+  PoolBlocks() : blocks(), cached(0) {}
+
+  /**
+   * @brief Destructor, which frees the blocks.
+   */
+  ~PoolBlocks()
+  {
+    clear();
+    destroyed() = true;
+  }
+
+  /**
+   * @brief Free the blocks.
+   */
+  void clear()
+  {
+    for (auto& b : blocks) {
+      for (auto* ptr : b.second) {
+        std::free(ptr);
+      }
+    }
+    blocks.clear();
+    cached = 0;
+  }
+
+  /**
+   * @brief Check whether the blocks of the thread have been destructed, at thread or program exit.
+   *
+   * The flag is trivially destructible, such that it can still be read after the blocks.
+   */
+  static bool& destroyed()
+  {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  /**
+   * @brief The free blocks, by byte size.
+   */
+  std::map<std::size_t, std::vector<void*>> blocks;
+
+  /**
+   * @brief The total size of the free blocks, in bytes.
+   */
+  std::size_t cached;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief A thread-local pool of memory blocks, to recycle the memory of short-lived temporaries.
+ *
+ * Large allocations are generally mapped and unmapped by the system at each allocation,
+ * which means page faults each time the memory is first written.
+ * Instead, blocks which are released to the pool are kept, by byte size,
+ * and given back by the next acquisition of the same size in the same thread.
+ *
+ * Each thread owns the blocks it has released, up to some capacity, beyond which blocks are freed.
+ * Statistics (memory in use and high-water mark) are global to all threads.
+ * The pool is used through `PoolHolder`, e.g. with `PoolRaster`, and is rarely used directly.
+ *
+ * \code
+ * for (const auto& frame : frames) {
+ *   PoolRaster<float> tmp(frame.shape()); // Allocated once only
+ *   ...
+ * }
+ * std::cout << "Peak memory: " << MemoryPool::high_water_mark() << " bytes" << std::endl;
+ * \endcode
+ */
+class MemoryPool {
+private:
+
+  /**
+   * @brief Private constructor.
+   */
+  MemoryPool() {}
+
+  /**
+   * @brief Get the free blocks of the calling thread.
+   */
+  static Internal::PoolBlocks& blocks()
+  {
+    static thread_local Internal::PoolBlocks b;
+    return b;
+  }
+
+  /**
+   * @brief Get the number of bytes in use.
+   */
+  static std::atomic<std::size_t>& used()
+  {
+    static std::atomic<std::size_t> bytes(0);
+    return bytes;
+  }
+
+  /**
+   * @brief Get the maximum number of bytes in use.
+   */
+  static std::atomic<std::size_t>& peak()
+  {
+    static std::atomic<std::size_t> bytes(0);
+    return bytes;
+  }
+
+  /**
+   * @brief Get the maximum number of bytes cached per thread.
+   */
+  static std::atomic<std::size_t>& max_cached()
+  {
+    static std::atomic<std::size_t> bytes(std::size_t(1) << 30);
+    return bytes;
+  }
+
+public:
+
+  /**
+   * @brief The alignment of the blocks, in bytes.
+   */
+  static constexpr std::size_t Alignment = 64;
+
+  /**
+   * @brief Deleted copy constructor.
+   */
+  MemoryPool(const MemoryPool&) = delete;
+
+  /**
+   * @brief Deleted copy assignment operator.
+   */
+  MemoryPool& operator=(const MemoryPool&) = delete;
+
+  /**
+   * @brief Get the block size of some byte count, i.e. the count rounded up to the alignment.
+   */
+  static std::size_t block_size(std::size_t bytes)
+  {
+    return (bytes + Alignment - 1) / Alignment * Alignment;
+  }
+
+  /**
+   * @brief Get a block of at least some byte count, recycled if possible.
+   *
+   * The block is aligned to `Alignment` bytes, and has garbage values.
+   * Zero-byte requests return `nullptr`.
+   */
+  static void* acquire(std::size_t bytes)
+  {
+    if (bytes == 0) {
+      return nullptr;
+    }
+    const auto size = block_size(bytes);
+    void* out = nullptr;
+    auto& b = blocks();
+    const auto it = b.blocks.find(size);
+    if (it != b.blocks.end() && not it->second.empty()) {
+      out = it->second.back();
+      it->second.pop_back();
+      b.cached -= size;
+    } else {
+      out = std::aligned_alloc(Alignment, size);
+      if (not out) {
+        throw std::bad_alloc();
+      }
+    }
+    const auto in_use = used().fetch_add(size) + size;
+    auto max = peak().load();
+    while (in_use > max && not peak().compare_exchange_weak(max, in_use)) {}
+    return out;
+  }
+
+  /**
+   * @brief Give a block back to the pool of the calling thread.
+   * @param ptr The block, as returned by `acquire()`, possibly from another thread
+   * @param bytes The byte count, as given to `acquire()`
+   *
+   * The block is freed if the pool of the calling thread is full.
+   */
+  static void release(void* ptr, std::size_t bytes)
+  {
+    if (not ptr) {
+      return;
+    }
+    const auto size = block_size(bytes);
+    used().fetch_sub(size);
+    if (Internal::PoolBlocks::destroyed()) { // E.g. static holder destructed after the pool
+      std::free(ptr);
+      return;
+    }
+    auto& b = blocks();
+    if (b.cached + size > max_cached()) {
+      std::free(ptr);
+      return;
+    }
+    b.blocks[size].push_back(ptr);
+    b.cached += size;
+  }
+
+  /**
+   * @brief Get the number of bytes in use, i.e. acquired and not released, by all threads.
+   */
+  static std::size_t in_use()
+  {
+    return used();
+  }
+
+  /**
+   * @brief Get the maximum number of bytes which have been in use at the same time, by all threads.
+   */
+  static std::size_t high_water_mark()
+  {
+    return peak();
+  }
+
+  /**
+   * @brief Reset the high-water mark to the number of bytes in use.
+   */
+  static void reset_high_water_mark()
+  {
+    peak() = used().load();
+  }
+
+  /**
+   * @brief Get the number of bytes cached by the calling thread.
+   */
+  static std::size_t cached()
+  {
+    return blocks().cached;
+  }
+
+  /**
+   * @brief Get the maximum number of bytes cached per thread.
+   */
+  static std::size_t capacity()
+  {
+    return max_cached();
+  }
+
+  /**
+   * @brief Set the maximum number of bytes cached per thread.
+   *
+   * Blocks which are already cached are not freed.
+   */
+  static void set_capacity(std::size_t bytes)
+  {
+    max_cached() = bytes;
+  }
+
+  /**
+   * @brief Free the blocks cached by the calling thread.
+   */
+  static void clear()
+  {
+    blocks().clear();
+  }
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Data holder with memory recycled by `MemoryPool`.
+ *
+ * This is a drop-in replacement of the default holder for short-lived temporaries.
+ * Elements are value-initialized, as with the default holder,
+ * but memory is acquired from the pool of the calling thread, and given back to it at destruction,
+ * such that repeated temporaries of the same size are neither allocated nor page-faulted.
+ *
+ * The value type must be trivially copyable.
+ */
+template <typename T>
+class PoolHolder : private Internal::MemoryTicket {
+  static_assert(std::is_trivially_copyable_v<T>, "PoolHolder requires trivially copyable values.");
+
+public:
+
+  /**
+   * @brief Constructor.
+   * @param size The number of elements
+   * @param data The values to be copied, or `nullptr` to value-initialize the elements
+   */
+  explicit PoolHolder(std::size_t size = 0, const T* data = nullptr) :
+      Internal::MemoryTicket(size * sizeof(T)), m_begin(static_cast<T*>(MemoryPool::acquire(size * sizeof(T)))), m_size(size)
+  {
+    if (data) {
+      std::copy_n(data, m_size, m_begin);
+    } else {
+      std::fill_n(m_begin, m_size, T());
+    }
+  }
+
+  /**
+   * @brief Uninitialized constructor.
+   * @param size The number of elements
+   */
+  PoolHolder(std::size_t size, UninitializedTag) :
+      Internal::MemoryTicket(size * sizeof(T)), m_begin(static_cast<T*>(MemoryPool::acquire(size * sizeof(T)))), m_size(size)
+  {}
+
+  /**
+   * @brief Copy constructor.
+   */
+  PoolHolder(const PoolHolder& other) : PoolHolder(other.m_size, other.m_begin) {}
+
+  /**
+   * @brief Move constructor.
+   */
+  PoolHolder(PoolHolder&& other) :
+      Internal::MemoryTicket(LINX_MOVE(other)), m_begin(other.m_begin), m_size(other.m_size)
+  {
+    other.m_begin = nullptr;
+    other.m_size = 0;
+  }
+
+  /**
+   * @brief Copy and move assignment.
+   */
+  PoolHolder& operator=(PoolHolder other)
+  {
+    swap(static_cast<Internal::MemoryTicket&>(*this), static_cast<Internal::MemoryTicket&>(other));
+    std::swap(m_begin, other.m_begin);
+    std::swap(m_size, other.m_size);
+    return *this;
+  }
+
+  /**
+   * @brief Destructor.
+   *
+   * Gives the memory back to the pool.
+   */
+  ~PoolHolder()
+  {
+    MemoryPool::release(m_begin, m_size * sizeof(T));
+  }
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  inline const T* begin() const
+  {
+    return m_begin;
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  inline const T* end() const
+  {
+    return m_begin + m_size;
+  }
+
+private:
+
+  /**
+   * @brief The data.
+   */
+  T* m_begin;
+
+  /**
+   * @brief The number of elements.
+   */
+  std::size_t m_size;
+};
+
+} // namespace Linx
+
+#endif
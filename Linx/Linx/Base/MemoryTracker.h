@@ -0,0 +1,363 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_MEMORYTRACKER_H
+#define _LINXBASE_MEMORYTRACKER_H
+
+#include <algorithm> // max
+#include <atomic>
+#include <cstddef> // size_t
+#include <utility> // swap
+
+namespace Linx {
+
+class MemoryScope;
+
+/**
+ * @brief A process-wide account of the memory allocated by the data holders.
+ *
+ * If the program is compiled with `-DLINX_TRACK_MEMORY`,
+ * the owning holders (`StdHolder`, `AlignedBuffer` and `PoolHolder`) report their allocations and deallocations,
+ * such that the current and peak numbers of bytes held are known at any time, e.g.:
+ *
+ * \code
+ * auto& tracker = MemoryTracker::instance();
+ * tracker.reset_peak();
+ * auto out = filter * extrapolation(in);
+ * std::cout << "Peak memory: " << tracker.peak() - tracker.baseline() << " bytes" << std::endl;
+ * \endcode
+ *
+ * Without `LINX_TRACK_MEMORY`, holders have no overhead and report nothing.
+ * The macro changes the layout of the holders, and must therefore be defined for all translation units.
+ * Memory allocated by other means, e.g. internal `std::vector`s, is not accounted.
+ *
+ * Allocations by the current thread can also be accounted per scope with `MemoryScope`.
+ */
+class MemoryTracker {
+public:
+
+  /**
+   * @brief Get the tracker.
+   */
+  static MemoryTracker& instance()
+  {
+    static MemoryTracker out;
+    return out;
+  }
+
+  /**
+   * @brief Check whether the holders are instrumented, i.e. whether `LINX_TRACK_MEMORY` is defined.
+   */
+  static constexpr bool instrumented()
+  {
+#ifdef LINX_TRACK_MEMORY
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Account for an allocation.
+   */
+  inline void allocate(std::size_t bytes);
+
+  /**
+   * @brief Account for a deallocation.
+   */
+  inline void deallocate(std::size_t bytes);
+
+  /**
+   * @brief Get the number of bytes currently held.
+   */
+  std::size_t current() const
+  {
+    return m_current.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the maximum number of bytes held at the same time since the last reset.
+   */
+  std::size_t peak() const
+  {
+    return m_peak.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of bytes held at the last reset.
+   */
+  std::size_t baseline() const
+  {
+    return m_baseline.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of allocations since the last reset.
+   */
+  std::size_t allocations() const
+  {
+    return m_allocations.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Reset the peak and baseline to the current number of bytes, and the allocation count to 0.
+   */
+  void reset_peak()
+  {
+    const auto c = current();
+    m_baseline = c;
+    m_peak = c;
+    m_allocations = 0;
+  }
+
+private:
+
+  /**
+   * @brief Constructor.
+   */
+  MemoryTracker() : m_current(0), m_peak(0), m_baseline(0), m_allocations(0) {}
+
+  /**
+   * @brief The number of bytes currently held.
+   */
+  std::atomic<std::size_t> m_current;
+
+  /**
+   * @brief The maximum number of bytes held since the last reset.
+   */
+  std::atomic<std::size_t> m_peak;
+
+  /**
+   * @brief The number of bytes held at the last reset.
+   */
+  std::atomic<std::size_t> m_baseline;
+
+  /**
+   * @brief The number of allocations since the last reset.
+   */
+  std::atomic<std::size_t> m_allocations;
+};
+
+/**
+ * @brief A RAII account of the memory allocated by the calling thread during a scope.
+ *
+ * The scope tracks the net number of bytes allocated by the calling thread since its construction,
+ * and the peak of this number.
+ * Scopes can be nested: the peak of an inner scope contributes to that of the outer scope.
+ * Memory allocated by other threads, e.g. by a multithreaded filter, is not accounted,
+ * while memory allocated before the scope and freed inside it makes the net number negative.
+ *
+ * \code
+ * MemoryScope scope;
+ * auto out = filter * extrapolation(in);
+ * std::cout << "Temporaries: " << scope.peak() - scope.current() << " bytes" << std::endl;
+ * \endcode
+ *
+ * @see `MemoryTracker`
+ */
+class MemoryScope {
+public:
+
+  /**
+   * @brief Constructor, which opens the scope.
+   */
+  MemoryScope() : m_current(0), m_peak(0), m_parent(top())
+  {
+    top() = this;
+  }
+
+  /**
+   * @brief Non-copyable.
+   */
+  MemoryScope(const MemoryScope&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  MemoryScope& operator=(const MemoryScope&) = delete;
+
+  /**
+   * @brief Destructor, which closes the scope and propagates the counts to the enclosing scope.
+   */
+  ~MemoryScope()
+  {
+    top() = m_parent;
+    if (m_parent) {
+      m_parent->m_peak = std::max(m_parent->m_peak, m_parent->m_current + m_peak);
+      m_parent->m_current += m_current;
+    }
+  }
+
+  /**
+   * @brief Get the net number of bytes allocated in the scope.
+   */
+  std::ptrdiff_t current() const
+  {
+    return m_current;
+  }
+
+  /**
+   * @brief Get the peak net number of bytes allocated in the scope, which is non-negative.
+   */
+  std::ptrdiff_t peak() const
+  {
+    return m_peak;
+  }
+
+  /**
+   * @brief Account for an allocation (positive) or deallocation (negative) in the innermost scope of the thread.
+   */
+  static void account(std::ptrdiff_t bytes)
+  {
+    if (auto* scope = top()) {
+      scope->m_current += bytes;
+      scope->m_peak = std::max(scope->m_peak, scope->m_current);
+    }
+  }
+
+private:
+
+  /**
+   * @brief Get the innermost scope of the calling thread.
+   */
+  static MemoryScope*& top()
+  {
+    static thread_local MemoryScope* scope = nullptr;
+    return scope;
+  }
+
+  /**
+   * @brief The net number of bytes.
+   */
+  std::ptrdiff_t m_current;
+
+  /**
+   * @brief The peak net number of bytes.
+   */
+  std::ptrdiff_t m_peak;
+
+  /**
+   * @brief The enclosing scope, or `nullptr`.
+   */
+  MemoryScope* m_parent;
+};
+
+void MemoryTracker::allocate(std::size_t bytes)
+{
+  const auto c = m_current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  auto p = m_peak.load(std::memory_order_relaxed);
+  while (c > p && not m_peak.compare_exchange_weak(p, c, std::memory_order_relaxed)) {}
+  m_allocations.fetch_add(1, std::memory_order_relaxed);
+  MemoryScope::account(bytes);
+}
+
+void MemoryTracker::deallocate(std::size_t bytes)
+{
+  m_current.fetch_sub(bytes, std::memory_order_relaxed);
+  MemoryScope::account(-static_cast<std::ptrdiff_t>(bytes));
+}
+
+/// @cond
+namespace Internal {
+
+#ifdef LINX_TRACK_MEMORY
+
+/**
+ * @brief A base class of the holders, which reports the bytes they hold to the `MemoryTracker`.
+ */
+class MemoryTicket {
+public:
+
+  explicit MemoryTicket(std::size_t bytes = 0) : m_bytes(0)
+  {
+    track(bytes);
+  }
+
+  MemoryTicket(const MemoryTicket& other) : MemoryTicket(other.m_bytes) {}
+
+  MemoryTicket(MemoryTicket&& other) : m_bytes(other.m_bytes)
+  {
+    other.m_bytes = 0;
+  }
+
+  MemoryTicket& operator=(const MemoryTicket& other)
+  {
+    if (this != &other) {
+      track(other.m_bytes);
+    }
+    return *this;
+  }
+
+  MemoryTicket& operator=(MemoryTicket&& other)
+  {
+    if (this != &other) {
+      untrack();
+      std::swap(m_bytes, other.m_bytes);
+    }
+    return *this;
+  }
+
+  ~MemoryTicket()
+  {
+    untrack();
+  }
+
+  /**
+   * @brief Replace the tracked bytes.
+   */
+  void track(std::size_t bytes)
+  {
+    untrack();
+    if (bytes) {
+      MemoryTracker::instance().allocate(bytes);
+      m_bytes = bytes;
+    }
+  }
+
+  /**
+   * @brief Stop tracking, e.g. when the memory is freed or moved out.
+   */
+  void untrack()
+  {
+    if (m_bytes) {
+      MemoryTracker::instance().deallocate(m_bytes);
+      m_bytes = 0;
+    }
+  }
+
+  friend void swap(MemoryTicket& lhs, MemoryTicket& rhs)
+  {
+    std::swap(lhs.m_bytes, rhs.m_bytes);
+  }
+
+private:
+
+  std::size_t m_bytes;
+};
+
+#else
+
+/**
+ * @brief An empty ticket, which is optimized away as a base class.
+ */
+class MemoryTicket {
+public:
+
+  explicit MemoryTicket(std::size_t = 0) {}
+
+  void track(std::size_t) {}
+
+  void untrack() {}
+
+  friend void swap(MemoryTicket&, MemoryTicket&) {}
+};
+
+#endif
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
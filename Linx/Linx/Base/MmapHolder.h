@@ -0,0 +1,317 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_MMAPHOLDER_H
+#define _LINXBASE_MMAPHOLDER_H
+
+#include "Linx/Base/Exceptions.h"
+
+#include <algorithm> // min
+#include <cerrno>
+#include <cstring> // strerror
+#include <fcntl.h> // open
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h> // fstat
+#include <type_traits>
+#include <unistd.h> // close, ftruncate, sysconf
+
+namespace Linx {
+
+/**
+ * @ingroup exceptions
+ * @brief Exception thrown when a memory mapping fails.
+ */
+struct MmapError : Exception {
+  /**
+   * @brief Constructor.
+   */
+  MmapError(const std::string& message) : Exception("Memory mapping error", message + ": " + std::strerror(errno)) {}
+};
+
+/**
+ * @brief The access mode of a memory-mapped file.
+ */
+enum class MmapMode {
+  ReadOnly, ///< Read the file, writing is forbidden
+  ReadWrite, ///< Read and write the file, which is created or extended if needed
+  CopyOnWrite ///< Read the file, and write to a private copy, which is not written back
+};
+
+/**
+ * @brief The expected access pattern to memory-mapped data, as advised to the OS.
+ */
+enum class MmapAdvice {
+  Normal = MADV_NORMAL, ///< No specific pattern
+  Sequential = MADV_SEQUENTIAL, ///< Sequential access, such that pages can be read ahead and then freed
+  Random = MADV_RANDOM, ///< Random access, such that pages should not be read ahead
+  WillNeed = MADV_WILLNEED, ///< Access in the near future, such that pages should be read ahead
+  DontNeed = MADV_DONTNEED ///< No access in the near future, such that pages can be freed (and private changes lost)
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Data holder of some memory-mapped file.
+ *
+ * The holder maps the file contents to memory, such that the OS pages data in on demand,
+ * and pages it out when memory is needed.
+ * This allows to process files which are larger than the RAM, e.g. one section at a time:
+ *
+ * \code
+ * MmapRaster<const float, 3> cube({width, height, depth}, "cube.raw", MmapMode::ReadOnly, header_size);
+ * cube.advise(MmapAdvice::Sequential);
+ * for (Index i = 0; i < depth; ++i) {
+ *   process(cube.section(i));
+ * }
+ * \endcode
+ *
+ * Data is neither converted nor byte-swapped, i.e. the file must be in native endianness.
+ * If no file is given, some anonymous memory is mapped, which is lazily allocated.
+ *
+ * Holders are not copyable, but movable.
+ * Mapped memory is unmapped by the destructor, and written back to the file in `MmapMode::ReadWrite`.
+ */
+template <typename T>
+class MmapHolder {
+public:
+
+  /**
+   * @brief Anonymous mapping constructor.
+   * @param size The number of elements
+   */
+  explicit MmapHolder(std::size_t size = 0) : m_mapping(nullptr), m_length(0), m_begin(nullptr), m_end(nullptr)
+  {
+    if (size > 0) {
+      map(-1, size, MAP_PRIVATE | MAP_ANONYMOUS, PROT_READ | PROT_WRITE, 0);
+    }
+  }
+
+  /**
+   * @brief File mapping constructor.
+   * @param size The number of elements
+   * @param filename The file name
+   * @param mode The access mode
+   * @param offset The data offset in the file, in bytes
+   *
+   * The offset must be a multiple of the alignment of `T`.
+   * In `MmapMode::ReadWrite`, the file is created or extended if needed,
+   * otherwise it must contain at least `offset + size * sizeof(T)` bytes.
+   */
+  MmapHolder(
+      std::size_t size,
+      const std::string& filename,
+      MmapMode mode = MmapMode::ReadOnly,
+      std::size_t offset = 0) :
+      MmapHolder()
+  {
+    if (offset % alignof(T) != 0) {
+      throw Exception(
+          "Alignment error",
+          "Data offset " + std::to_string(offset) + " is not a multiple of " + std::to_string(alignof(T)) + ".");
+    }
+    const bool writable = mode == MmapMode::ReadWrite;
+    const int fd = ::open(filename.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0) {
+      throw MmapError("Cannot open file " + filename);
+    }
+    try {
+      const auto required = static_cast<off_t>(offset + size * sizeof(T));
+      struct stat status;
+      if (::fstat(fd, &status) != 0) {
+        throw MmapError("Cannot get size of file " + filename);
+      }
+      if (status.st_size < required) {
+        if (not writable) {
+          errno = EINVAL;
+          throw MmapError("File " + filename + " is too small");
+        }
+        if (::ftruncate(fd, required) != 0) {
+          throw MmapError("Cannot extend file " + filename);
+        }
+      }
+      const int flags = mode == MmapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+      const int protection = mode == MmapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+      if (size > 0) {
+        map(fd, size, flags, protection, offset);
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd); // The mapping remains valid
+  }
+
+  MmapHolder(const MmapHolder&) = delete;
+  MmapHolder& operator=(const MmapHolder&) = delete;
+
+  /**
+   * @brief Move constructor.
+   */
+  MmapHolder(MmapHolder&& other) :
+      m_mapping(other.m_mapping), m_length(other.m_length), m_begin(other.m_begin), m_end(other.m_end)
+  {
+    other.m_mapping = nullptr;
+    other.reset();
+  }
+
+  /**
+   * @brief Move assignment.
+   */
+  MmapHolder& operator=(MmapHolder&& other)
+  {
+    if (this != &other) {
+      reset();
+      m_mapping = other.m_mapping;
+      m_length = other.m_length;
+      m_begin = other.m_begin;
+      m_end = other.m_end;
+      other.m_mapping = nullptr;
+      other.reset();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor.
+   *
+   * Unmaps the memory.
+   */
+  ~MmapHolder()
+  {
+    reset();
+  }
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  inline const T* begin() const
+  {
+    return m_begin;
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  inline const T* end() const
+  {
+    return m_end;
+  }
+
+  /**
+   * @brief Advise the OS about the access pattern to the whole data.
+   */
+  void advise(MmapAdvice advice) const
+  {
+    advise(advice, 0, m_end - m_begin);
+  }
+
+  /**
+   * @brief Advise the OS about the access pattern to a range of elements.
+   * @param advice The access pattern
+   * @param front The index of the first element
+   * @param size The number of elements
+   *
+   * This is typically used to prefetch the next section while processing the current one:
+   *
+   * \code
+   * const auto section_size = shape_size(cube.section(0).shape());
+   * cube.advise(MmapAdvice::WillNeed, (i + 1) * section_size, section_size);
+   * process(cube.section(i));
+   * cube.advise(MmapAdvice::DontNeed, i * section_size, section_size);
+   * \endcode
+   */
+  void advise(MmapAdvice advice, std::size_t front, std::size_t size) const
+  {
+    const auto total = static_cast<std::size_t>(m_end - m_begin);
+    if (front >= total || size == 0) {
+      return;
+    }
+    const auto* mapping = static_cast<const char*>(m_mapping);
+    const auto* first = reinterpret_cast<const char*>(m_begin + front);
+    const auto* last = reinterpret_cast<const char*>(m_begin + std::min(front + size, total));
+    const auto page = page_size();
+    const auto* aligned = mapping + (first - mapping) / page * page; // madvise requires page alignment
+    if (::madvise(const_cast<char*>(aligned), last - aligned, static_cast<int>(advice)) != 0) {
+      throw MmapError("Cannot advise mapping");
+    }
+  }
+
+  /**
+   * @brief Write the modified data back to the file, in `MmapMode::ReadWrite`.
+   */
+  void sync() const
+  {
+    if (m_mapping && ::msync(m_mapping, m_length, MS_SYNC) != 0) {
+      throw MmapError("Cannot synchronize mapping");
+    }
+  }
+
+private:
+
+  /**
+   * @brief Get the page size.
+   */
+  static std::size_t page_size()
+  {
+    static const auto out = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return out;
+  }
+
+  /**
+   * @brief Map some file or anonymous memory.
+   *
+   * The mapping starts at the page boundary which precedes the offset, as required by `mmap()`.
+   */
+  void map(int fd, std::size_t size, int flags, int protection, std::size_t offset)
+  {
+    const auto shift = offset % page_size();
+    m_length = shift + size * sizeof(T);
+    m_mapping = ::mmap(nullptr, m_length, protection, flags, fd, static_cast<off_t>(offset - shift));
+    if (m_mapping == MAP_FAILED) {
+      m_mapping = nullptr;
+      m_length = 0;
+      throw MmapError("Cannot map memory");
+    }
+    m_begin = reinterpret_cast<T*>(static_cast<char*>(m_mapping) + shift);
+    m_end = m_begin + size;
+  }
+
+  /**
+   * @brief Unmap the memory, if any.
+   */
+  void reset()
+  {
+    if (m_mapping) {
+      ::munmap(m_mapping, m_length);
+    }
+    m_mapping = nullptr;
+    m_length = 0;
+    m_begin = nullptr;
+    m_end = nullptr;
+  }
+
+  /**
+   * @brief The mapping address, which is page-aligned.
+   */
+  void* m_mapping;
+
+  /**
+   * @brief The mapping length, in bytes.
+   */
+  std::size_t m_length;
+
+  /**
+   * @brief The data begin.
+   */
+  T* m_begin;
+
+  /**
+   * @brief The data end.
+   */
+  T* m_end;
+};
+
+} // namespace Linx
+
+#endif
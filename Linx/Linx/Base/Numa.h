@@ -0,0 +1,115 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_NUMA_H
+#define _LINXBASE_NUMA_H
+
+#include "Linx/Base/Parallel.h"
+
+#include <cstdint> // uintptr_t
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h> // MPOL_*
+#include <sys/syscall.h> // SYS_mbind, SYS_get_mempolicy
+#include <unistd.h> // syscall, sysconf
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Get the NUMA node which owns the memory page of some address, or -1 if unknown.
+ *
+ * If the page has not been touched yet, it is allocated as if the calling thread had read it.
+ * The node is unknown on systems without NUMA support.
+ *
+ * @see `numa_nodes()`
+ */
+inline Index numa_node(const void* ptr)
+{
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+  int node = -1;
+  if (::syscall(SYS_get_mempolicy, &node, nullptr, 0, const_cast<void*>(ptr), MPOL_F_NODE | MPOL_F_ADDR) == 0) {
+    return node;
+  }
+#endif
+  return -1;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Get the NUMA node of each chunk of a contiguous container, as split by a parallel policy.
+ * @param in The container
+ * @param policy The parallel policy
+ * @return The node of the first element of each chunk, or -1 if unknown
+ *
+ * Chunks are those of the pixel-wise operations with the same policy,
+ * i.e. bands along the last axis for rasters.
+ * This allows to check the placement of a raster, e.g. after a parallel first touch:
+ *
+ * \code
+ * Raster<float, 3, AlignedBuffer<float>> cube(shape, par); // Parallel first touch
+ * const auto nodes = numa_nodes(cube, par); // E.g. {0, 0, ..., 1, 1}
+ * \endcode
+ */
+template <typename TContainer>
+std::vector<Index> numa_nodes(const TContainer& in, const ParallelPolicy& policy = par)
+{
+  const auto* data = in.data();
+  const auto size = static_cast<Index>(in.size());
+  const auto bounds = Internal::chunk_bounds(policy.thread_count(), size, data, sizeof(*data));
+  std::vector<Index> out;
+  out.reserve(bounds.size() - 1);
+  for (std::size_t i = 0; i + 1 < bounds.size(); ++i) {
+    out.push_back(bounds[i] < size ? numa_node(data + bounds[i]) : -1);
+  }
+  return out;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Interleave the pages of some memory over the allowed NUMA nodes.
+ * @param data The address of the first element
+ * @param size The number of elements
+ * @return Whether the policy was applied
+ *
+ * The pages are distributed round-robin over the nodes when they are first touched,
+ * such that the memory must not have been written yet,
+ * e.g. right after some uninitialized construction:
+ *
+ * \code
+ * AlignedRaster<float> raster(shape, uninitialized, huge_page_size);
+ * numa_interleave(raster.data(), raster.size());
+ * \endcode
+ *
+ * Interleaving suits data which is accessed by all threads without a fixed partitioning,
+ * while parallel first touch suits data which is processed band-wise.
+ * This is advisory only: on systems without NUMA support, nothing is done and false is returned.
+ */
+template <typename T>
+bool numa_interleave(const T* data, std::size_t size)
+{
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_get_mempolicy)
+  if (not data || size == 0) {
+    return false;
+  }
+  constexpr std::size_t max_node = 1024;
+  constexpr std::size_t word_size = sizeof(unsigned long) * 8;
+  unsigned long mask[max_node / word_size] = {};
+  if (::syscall(SYS_get_mempolicy, nullptr, mask, max_node, nullptr, MPOL_F_MEMS_ALLOWED) != 0) {
+    return false;
+  }
+  const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  const auto begin = reinterpret_cast<std::uintptr_t>(data) / page * page; // mbind requires page alignment
+  const auto end = reinterpret_cast<std::uintptr_t>(data + size);
+  return ::syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE, mask, max_node, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,186 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_PARALLEL_H
+#define _LINXBASE_PARALLEL_H
+
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // min
+#include <cstdint> // uintptr_t
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Resolve a thread count, where values <= 0 mean as many threads as available.
+ */
+inline Index resolve_thread_count(Index count)
+{
+  if (count > 0) {
+    return count;
+  }
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/**
+ * @brief The cache line size, in bytes.
+ */
+constexpr Index CacheLine = 64;
+
+/**
+ * @brief Split `[0, size[` into one chunk per thread.
+ * @param threads The thread count
+ * @param size The number of elements
+ * @param data The address of the first element, if chunk bounds should be aligned to cache lines
+ * @param element_size The element size, in bytes
+ * @return The chunk bounds, i.e. the index of the first element of each chunk, followed by `size`
+ *
+ * Aligning chunk bounds to cache lines prevents threads from writing to the same cache line (false sharing).
+ */
+inline std::vector<Index> chunk_bounds(Index threads, Index size, const void* data = nullptr, Index element_size = 1)
+{
+  const auto count = std::max<Index>(std::min(threads, size), 1);
+  const auto address = static_cast<Index>(reinterpret_cast<std::uintptr_t>(data));
+  std::vector<Index> out(count + 1);
+  for (Index i = 0; i <= count; ++i) {
+    auto index = i * size / count;
+    if (i > 0 && i < count && data && CacheLine % element_size == 0) {
+      const auto misalignment = (address + index * element_size) % CacheLine;
+      index += ((CacheLine - misalignment) % CacheLine) / element_size;
+    }
+    out[i] = std::min(index, size);
+  }
+  return out;
+}
+
+/**
+ * @brief Split `[0, size[` into one chunk per thread, and call `func(front, back)` on each chunk in parallel.
+ * @param threads The thread count
+ * @param size The number of elements
+ * @param func The chunk function, which takes the index of the first element and the index past the last element
+ * @param data The address of the first element, if chunk bounds should be aligned to cache lines
+ * @param element_size The element size, in bytes
+ *
+ * @see `chunk_bounds()`
+ */
+template <typename TFunc>
+void parallel_chunks(Index threads, Index size, TFunc&& func, const void* data = nullptr, Index element_size = 1)
+{
+  const auto bounds = chunk_bounds(threads, size, data, element_size);
+  const auto count = static_cast<Index>(bounds.size()) - 1;
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+  for (Index i = 0; i < count; ++i) {
+    const auto front = bounds[i];
+    const auto back = bounds[i + 1];
+    if (front < back) {
+      func(front, back);
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief An execution policy to run pixel-wise operations on several threads.
+ *
+ * Pixel-wise operations of containers (e.g. `generate()`, `apply()`, `fill()` or `range()`)
+ * accept a policy as their first parameter:
+ *
+ * \code
+ * raster.apply(par, [](auto e) { return std::sqrt(e); }); // As many threads as available
+ * raster.generate(par(4), [](auto e, auto f) { return e * f; }, a, b); // 4 threads
+ * \endcode
+ *
+ * Contiguous containers are split into one chunk per thread, aligned to cache lines.
+ * Box-based patches are split along their last axis, i.e. by blocks of rows in 2D.
+ * Other containers are processed sequentially.
+ *
+ * Operations are run with OpenMP, and sequentially if OpenMP is disabled.
+ * The function must be safe to call concurrently.
+ */
+class ParallelPolicy {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param thread_count The thread count, or 0 to use as many threads as available
+   */
+  constexpr explicit ParallelPolicy(Index thread_count = 0) : m_thread_count(thread_count) {}
+
+  /**
+   * @brief Get a policy with given thread count.
+   */
+  constexpr ParallelPolicy operator()(Index thread_count) const
+  {
+    return ParallelPolicy(thread_count);
+  }
+
+  /**
+   * @brief Get the number of threads.
+   */
+  Index thread_count() const
+  {
+    return Internal::resolve_thread_count(m_thread_count);
+  }
+
+private:
+
+  /**
+   * @brief The thread count, or 0 to use as many threads as available.
+   */
+  Index m_thread_count;
+};
+
+/**
+ * @ingroup pixelwise
+ * @brief The parallel execution policy with as many threads as available.
+ * @see `ParallelPolicy`
+ */
+inline constexpr ParallelPolicy par {};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Call a function from one thread of a team, such that it can spawn OpenMP tasks.
+ *
+ * If the caller is already in a parallel region, e.g. in a task of an enclosing `parallel_for_each()`,
+ * the function is called directly, and its tasks are executed by the enclosing team:
+ * nested parallelism does not create new threads, and therefore does not oversubscribe the cores.
+ * Otherwise, a team of `policy.thread_count()` threads is created.
+ */
+template <typename TFunc>
+void with_team(const ParallelPolicy& policy, TFunc&& func)
+{
+#ifdef _OPENMP
+  if (omp_in_parallel()) {
+    func();
+    return;
+  }
+#endif
+#pragma omp parallel num_threads(static_cast<int>(policy.thread_count()))
+#pragma omp single
+  func();
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
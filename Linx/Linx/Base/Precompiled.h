@@ -0,0 +1,57 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_PRECOMPILED_H
+#define _LINXBASE_PRECOMPILED_H
+
+#include <cstdint> // int16_t
+
+/**
+ * @brief Apply a macro to each value type which is precompiled, for some dimension.
+ *
+ * The library explicitly instantiates the most common class templates for these value types and dimensions 2 and 3,
+ * e.g. `Raster<float, 2>` in `Data.cpp`, or `Convolution<float, Box<2>>` in `Transforms.cpp`.
+ * Client code which defines `LINX_PRECOMPILED` (e.g. with `-DLINX_PRECOMPILED`) and links against the library
+ * sees them as `extern template`s, such that they are not instantiated again in each translation unit,
+ * which reduces build times and binary sizes.
+ * Inline member functions can still be inlined.
+ *
+ * Without `LINX_PRECOMPILED`, Linx is header-only, as usual.
+ */
+#define LINX_PRECOMPILED_VALUES(MACRO, N) \
+  MACRO(unsigned char, N) \
+  MACRO(std::int16_t, N) \
+  MACRO(int, N) \
+  MACRO(float, N) \
+  MACRO(double, N)
+
+/**
+ * @brief Apply a macro to each floating point value type which is precompiled, for some dimension.
+ */
+#define LINX_PRECOMPILED_FLOATS(MACRO, N) \
+  MACRO(float, N) \
+  MACRO(double, N)
+
+/**
+ * @brief Apply a macro to each dimension which is precompiled.
+ */
+#define LINX_PRECOMPILED_DIMENSIONS(MACRO) \
+  MACRO(2) \
+  MACRO(3)
+
+/**
+ * @brief Apply a macro to each precompiled pair of value type and dimension.
+ */
+#define LINX_PRECOMPILED_RASTERS(MACRO) \
+  LINX_PRECOMPILED_VALUES(MACRO, 2) \
+  LINX_PRECOMPILED_VALUES(MACRO, 3)
+
+/**
+ * @brief Apply a macro to each precompiled pair of floating point value type and dimension.
+ */
+#define LINX_PRECOMPILED_KERNELS(MACRO) \
+  LINX_PRECOMPILED_FLOATS(MACRO, 2) \
+  LINX_PRECOMPILED_FLOATS(MACRO, 3)
+
+#endif
@@ -0,0 +1,368 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_QUANTILESKETCH_H
+#define _LINXBASE_QUANTILESKETCH_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm>
+#include <cmath> // abs, ceil, pow
+#include <utility> // pair
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Streaming estimator of approximate quantiles (KLL sketch).
+ * @tparam T The element type
+ *
+ * Unlike `DataDistribution`, which copies and sorts all the values,
+ * the sketch keeps a bounded number of weighted samples, which is O(k) in practice:
+ * values are inserted into a hierarchy of compactors,
+ * and when a compactor is full, it is sorted and every other value is promoted to the next compactor
+ * with twice the weight.
+ * The rank error is about 1.7 / k, i.e. under 1% of the number of values for the default `k = 200`,
+ * whatever the number of values.
+ *
+ * Sketches can be merged, e.g. to process tiles or chunks independently, possibly in parallel:
+ *
+ * \code
+ * QuantileSketch<float> sketch;
+ * for (const auto& tile : tiles) {
+ *   sketch.merge(QuantileSketch<float>(tile));
+ * }
+ * auto median = sketch.median();
+ * \endcode
+ *
+ * The min and max values are exact.
+ * Compaction is deterministic, such that the results are reproducible.
+ *
+ * @see `sketch()`
+ */
+template <typename T>
+class QuantileSketch {
+public:
+
+  /**
+   * @copybrief TypeTraits::Floating
+   */
+  using Floating = typename TypeTraits<T>::Floating;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param k The accuracy parameter, i.e. the capacity of the largest compactor
+   */
+  explicit QuantileSketch(std::size_t k = 200) :
+      m_k(std::max<std::size_t>(k, 8)), m_levels(1), m_count(0), m_size(0), m_capacity(capacity())
+  {}
+
+  /**
+   * @brief Range constructor.
+   */
+  template <typename TRange>
+  explicit QuantileSketch(const TRange& values, std::size_t k = 200) : QuantileSketch(k)
+  {
+    insert(values.begin(), values.end());
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of inserted values.
+   */
+  std::size_t size() const
+  {
+    return m_count;
+  }
+
+  /**
+   * @brief Get the number of retained samples.
+   */
+  std::size_t sample_count() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the min value.
+   */
+  const T& min() const
+  {
+    return m_min;
+  }
+
+  /**
+   * @brief Get the max value.
+   */
+  const T& max() const
+  {
+    return m_max;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Insert a value.
+   */
+  void insert(const T& value)
+  {
+    if (m_count == 0) {
+      m_min = value;
+      m_max = value;
+    } else {
+      m_min = std::min(m_min, value);
+      m_max = std::max(m_max, value);
+    }
+    ++m_count;
+    m_levels[0].push_back(value);
+    ++m_size;
+    if (m_size >= m_capacity) {
+      compress();
+    }
+  }
+
+  /**
+   * @brief Insert the values of an iterator range.
+   */
+  template <typename TIt>
+  void insert(TIt begin, TIt end)
+  {
+    for (; begin != end; ++begin) {
+      insert(*begin);
+    }
+  }
+
+  /**
+   * @brief Merge another sketch into this one.
+   */
+  void merge(const QuantileSketch& other)
+  {
+    if (other.m_count == 0) {
+      return;
+    }
+    if (m_count == 0) {
+      m_min = other.m_min;
+      m_max = other.m_max;
+    } else {
+      m_min = std::min(m_min, other.m_min);
+      m_max = std::max(m_max, other.m_max);
+    }
+    m_count += other.m_count;
+    if (m_levels.size() < other.m_levels.size()) {
+      m_levels.resize(other.m_levels.size());
+      m_capacity = capacity();
+    }
+    for (std::size_t h = 0; h < other.m_levels.size(); ++h) {
+      m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(), other.m_levels[h].end());
+    }
+    m_size += other.m_size;
+    while (m_size >= m_capacity) {
+      compress();
+    }
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Estimate the rank of a value, i.e. the number of inserted values less than it.
+   */
+  std::size_t rank(const T& value) const
+  {
+    std::size_t out = 0;
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+      for (const auto& e : m_levels[h]) {
+        if (e < value) {
+          out += std::size_t(1) << h;
+        }
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Estimate the q-th quantile.
+   *
+   * The following values of `q` correspond to equivalent functions:
+   * - 0: `min()`;
+   * - 1: `max()`;
+   * - 0.5: `median()`.
+   */
+  Floating quantile(double q) const
+  {
+    if (q <= 0) {
+      return m_min;
+    }
+    if (q >= 1) {
+      return m_max;
+    }
+    return weighted_quantile(samples(), q);
+  }
+
+  /**
+   * @brief Estimate the median.
+   */
+  Floating median() const
+  {
+    return quantile(0.5);
+  }
+
+  /**
+   * @brief Estimate the median absolute deviation.
+   *
+   * The absolute deviations are computed from the retained samples,
+   * such that the error is of the same order as that of the median.
+   */
+  Floating mad() const
+  {
+    const auto m = median();
+    auto deviations = samples();
+    for (auto& s : deviations) {
+      s.first = std::abs(s.first - m);
+    }
+    return weighted_quantile(std::move(deviations), 0.5);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the capacity of a compactor.
+   */
+  std::size_t capacity(std::size_t h) const
+  {
+    const auto depth = m_levels.size() - 1 - h;
+    return std::max<std::size_t>(2, std::ceil(m_k * std::pow(2. / 3., depth)));
+  }
+
+  /**
+   * @brief Compute the total capacity.
+   */
+  std::size_t capacity() const
+  {
+    std::size_t out = 0;
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+      out += capacity(h);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compact the lowest full compactor into the next one.
+   */
+  void compress()
+  {
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+      if (m_levels[h].size() < capacity(h)) {
+        continue;
+      }
+      if (h + 1 == m_levels.size()) {
+        m_levels.emplace_back();
+        m_capacity = capacity();
+      }
+      auto& current = m_levels[h];
+      auto& next = m_levels[h + 1];
+      std::sort(current.begin(), current.end());
+      const std::size_t odd = current.size() % 2; // Keep the smallest value if odd
+      const std::size_t offset = m_coin;
+      m_coin = not m_coin;
+      for (std::size_t i = odd + offset; i < current.size(); i += 2) {
+        next.push_back(current[i]);
+      }
+      m_size -= (current.size() - odd) / 2;
+      current.resize(odd);
+      return;
+    }
+  }
+
+  /**
+   * @brief Get the retained samples and their weights.
+   */
+  std::vector<std::pair<T, std::size_t>> samples() const
+  {
+    std::vector<std::pair<T, std::size_t>> out;
+    out.reserve(m_size);
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+      for (const auto& e : m_levels[h]) {
+        out.emplace_back(e, std::size_t(1) << h);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the q-th quantile of weighted samples.
+   */
+  static Floating weighted_quantile(std::vector<std::pair<T, std::size_t>> samples, double q)
+  {
+    if (samples.empty()) {
+      return Floating();
+    }
+    std::sort(samples.begin(), samples.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    std::size_t total = 0;
+    for (const auto& s : samples) {
+      total += s.second;
+    }
+    const auto target = q * total;
+    std::size_t cumulated = 0;
+    for (const auto& s : samples) {
+      cumulated += s.second;
+      if (cumulated >= target) {
+        return s.first;
+      }
+    }
+    return samples.back().first;
+  }
+
+  /**
+   * @brief The accuracy parameter.
+   */
+  std::size_t m_k;
+
+  /**
+   * @brief The compactors, where values of level h have weight 2^h.
+   */
+  std::vector<std::vector<T>> m_levels;
+
+  /**
+   * @brief The number of inserted values.
+   */
+  std::size_t m_count;
+
+  /**
+   * @brief The number of retained samples.
+   */
+  std::size_t m_size;
+
+  /**
+   * @brief The total capacity of the compactors.
+   */
+  std::size_t m_capacity;
+
+  /**
+   * @brief The min value.
+   */
+  T m_min {};
+
+  /**
+   * @brief The max value.
+   */
+  T m_max {};
+
+  /**
+   * @brief The offset of the next compaction, alternated for an unbiased promotion.
+   */
+  bool m_coin = false;
+};
+
+} // namespace Linx
+
+#endif
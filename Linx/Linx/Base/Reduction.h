@@ -0,0 +1,252 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_REDUCTION_H
+#define _LINXBASE_REDUCTION_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // min
+#include <iterator> // iterator_traits, random_access_iterator_tag
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup pixelwise
+ * @brief The summation algorithms of reductions.
+ *
+ * All the algorithms accumulate into several independent accumulators,
+ * which breaks the serial dependency chain of `std::accumulate()`, such that the loop can be vectorized.
+ */
+enum class Summation {
+  Lanes, ///< Independent accumulators only, fastest
+  Pairwise, ///< Cascaded sums of blocks, with error growing in O(log n) instead of O(n)
+  Kahan ///< Compensated sums, with error independent of n, slowest
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The number of independent accumulators of the reductions.
+ */
+constexpr Index ReductionLanes = 8;
+
+/**
+ * @brief The number of elements of the blocks of the pairwise summation.
+ */
+constexpr Index PairwiseBlock = 256;
+
+/**
+ * @brief Combine the accumulators pairwise.
+ */
+template <typename U>
+U combine_lanes(U* acc)
+{
+  for (Index width = ReductionLanes / 2; width > 0; width /= 2) {
+    for (Index l = 0; l < width; ++l) {
+      acc[l] += acc[l + width];
+    }
+  }
+  return acc[0];
+}
+
+/**
+ * @brief Sum the chunk sums.
+ */
+template <typename U>
+U combine(const std::vector<U>& sums)
+{
+  U out {};
+  for (const auto& s : sums) {
+    out += s;
+  }
+  return out;
+}
+
+/**
+ * @brief Accumulate `func(*its...)` over `size` elements into `init` with independent accumulators,
+ * and advance the iterators.
+ *
+ * The function is compiled for several instruction sets, see `instruction_set()`.
+ */
+template <typename U, typename TFunc, typename... TIts>
+LINX_KERNEL U accumulate_lanes_kernel(U init, Index size, TFunc& func, TIts&... its)
+{
+  U acc[ReductionLanes] {};
+  acc[0] = init;
+  Index i = 0;
+  for (; i + ReductionLanes <= size; i += ReductionLanes) {
+    for (Index l = 0; l < ReductionLanes; ++l) {
+      acc[l] += func(*its...);
+      (++its, ...);
+    }
+  }
+  for (Index l = 0; i < size; ++i, ++l) {
+    acc[l] += func(*its...);
+    (++its, ...);
+  }
+  return combine_lanes(acc);
+}
+
+LINX_MULTIVERSION(accumulate_lanes)
+
+/**
+ * @brief Sum `func(*its...)` over `size` elements with independent accumulators, and advance the iterators.
+ */
+template <typename U, typename TFunc, typename... TIts>
+U lanes_sum(Index size, TFunc& func, TIts&... its)
+{
+  return accumulate_lanes(U {}, size, func, its...);
+}
+
+/**
+ * @brief Sum `func(*its...)` over `size` elements by blocks, and combine the block sums pairwise.
+ *
+ * Block sums are merged as soon as two sums of the same level are available, like in a binary counter,
+ * such that the iterators are traversed once.
+ */
+template <typename U, typename TFunc, typename... TIts>
+U pairwise_sum(Index size, TFunc& func, TIts&... its)
+{
+  std::vector<U> stack; // Sums of 2^k blocks for decreasing k
+  Index count = 0;
+  for (Index i = 0; i < size; i += PairwiseBlock) {
+    stack.push_back(lanes_sum<U>(std::min(PairwiseBlock, size - i), func, its...));
+    ++count;
+    for (auto c = count; c % 2 == 0; c /= 2) {
+      const auto rhs = stack.back();
+      stack.pop_back();
+      stack.back() += rhs;
+    }
+  }
+  U out {};
+  for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+    out += *it;
+  }
+  return out;
+}
+
+/**
+ * @brief Sum `func(*its...)` over `size` elements with compensated independent accumulators.
+ */
+template <typename U, typename TFunc, typename... TIts>
+U kahan_sum(Index size, TFunc& func, TIts&... its)
+{
+  U acc[ReductionLanes] {};
+  U err[ReductionLanes] {};
+  const auto add = [&](Index l) {
+    const U y = U(func(*its...)) - err[l];
+    const U t = acc[l] + y;
+    err[l] = (t - acc[l]) - y;
+    acc[l] = t;
+    (++its, ...);
+  };
+  Index i = 0;
+  for (; i + ReductionLanes <= size; i += ReductionLanes) {
+    for (Index l = 0; l < ReductionLanes; ++l) {
+      add(l);
+    }
+  }
+  for (Index l = 0; i < size; ++i, ++l) {
+    add(l);
+  }
+  for (Index l = 0; l < ReductionLanes; ++l) {
+    acc[l] -= err[l];
+  }
+  return combine_lanes(acc);
+}
+
+/**
+ * @brief Sum `func(*its...)` over `size` elements with a given algorithm.
+ */
+template <typename U, typename TFunc, typename... TIts>
+U sum_n(Summation mode, Index size, TFunc& func, TIts... its)
+{
+  switch (mode) {
+    case Summation::Pairwise:
+      return pairwise_sum<U>(size, func, its...);
+    case Summation::Kahan:
+      return kahan_sum<U>(size, func, its...);
+    default:
+      return lanes_sum<U>(size, func, its...);
+  }
+}
+
+/**
+ * @brief Check whether the iterator of a range is random-access, such that the range can be split.
+ */
+template <typename TRange, typename = void>
+struct IsRandomAccess : std::false_type {};
+
+template <typename TRange>
+struct IsRandomAccess<
+    TRange,
+    std::void_t<typename std::iterator_traits<decltype(std::declval<const TRange&>().begin())>::iterator_category>> :
+    std::is_base_of<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<decltype(std::declval<const TRange&>().begin())>::iterator_category> {};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Sum a function of the elements of one or several ranges of the same size.
+ * @tparam U The accumulator type
+ * @param mode The summation algorithm
+ * @param func The function, which takes one element of each range
+ * @param in The first range
+ * @param args The other ranges
+ *
+ * For example, the inner product of two ranges is computed as:
+ *
+ * \code
+ * auto dot = transform_sum<double>(Summation::Lanes, [](auto e, auto f) { return e * f; }, a, b);
+ * \endcode
+ *
+ * @see `Summation`
+ */
+template <typename U, typename TFunc, typename TRange, typename... TRanges>
+U transform_sum(Summation mode, TFunc&& func, const TRange& in, const TRanges&... args)
+{
+  return Internal::sum_n<U>(mode, static_cast<Index>(in.size()), func, in.begin(), args.begin()...);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Sum a function of the elements of one or several ranges in parallel.
+ *
+ * Ranges with random-access iterators are split into one chunk per thread,
+ * which are summed independently with `mode`, and the chunk sums are then added.
+ * Other ranges are processed sequentially.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename U, typename TFunc, typename TRange, typename... TRanges>
+U transform_sum(const ParallelPolicy& policy, Summation mode, TFunc&& func, const TRange& in, const TRanges&... args)
+{
+  if constexpr (Internal::IsRandomAccess<TRange>::value && (Internal::IsRandomAccess<TRanges>::value && ...)) {
+    const auto size = static_cast<Index>(in.size());
+    const auto bounds = Internal::chunk_bounds(policy.thread_count(), size);
+    const auto count = static_cast<Index>(bounds.size()) - 1;
+    std::vector<U> sums(count);
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      const auto front = bounds[i];
+      sums[i] = Internal::sum_n<U>(mode, bounds[i + 1] - front, func, in.begin() + front, args.begin() + front...);
+    }
+    return Internal::combine(sums);
+  } else {
+    return transform_sum<U>(mode, LINX_FORWARD(func), in, args...);
+  }
+}
+
+} // namespace Linx
+
+#endif
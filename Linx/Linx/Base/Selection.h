@@ -0,0 +1,354 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_SELECTION_H
+#define _LINXBASE_SELECTION_H
+
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // max_element, min_element, nth_element, sort
+#include <cmath> // abs, sqrt
+#include <type_traits>
+#include <utility> // pair
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The minimum number of elements for a selection to be run in parallel.
+ */
+constexpr Index ParallelSelectionMin = 1 << 16;
+
+/**
+ * @brief Select the k-th and (k+1)-th smallest elements in place, with introselect.
+ *
+ * If `k + 1 == size`, the k-th element is returned twice.
+ */
+template <typename T>
+std::pair<T, T> select_pair(T* data, Index size, Index k)
+{
+  std::nth_element(data, data + k, data + size);
+  if (k + 1 >= size) {
+    return {data[k], data[k]};
+  }
+  return {data[k], *std::min_element(data + k + 1, data + size)};
+}
+
+/**
+ * @brief The population of each class of a selection round, and its extrema.
+ */
+template <typename T>
+struct SelectionClasses {
+  Index counts[3] = {0, 0, 0}; ///< The numbers of elements below, inside and above the bracket
+  T mins[3]; ///< The min of each class
+  T maxs[3]; ///< The max of each class
+
+  /**
+   * @brief Add an element to a class.
+   */
+  void add(Index c, const T& e)
+  {
+    if (counts[c] == 0) {
+      mins[c] = e;
+      maxs[c] = e;
+    } else {
+      mins[c] = std::min(mins[c], e);
+      maxs[c] = std::max(maxs[c], e);
+    }
+    ++counts[c];
+  }
+
+  /**
+   * @brief Merge the classes of another chunk.
+   */
+  void merge(const SelectionClasses& other)
+  {
+    for (Index c = 0; c < 3; ++c) {
+      if (other.counts[c] == 0) {
+        continue;
+      }
+      if (counts[c] == 0) {
+        mins[c] = other.mins[c];
+        maxs[c] = other.maxs[c];
+      } else {
+        mins[c] = std::min(mins[c], other.mins[c]);
+        maxs[c] = std::max(maxs[c], other.maxs[c]);
+      }
+      counts[c] += other.counts[c];
+    }
+  }
+};
+
+/**
+ * @brief Select the k-th and (k+1)-th smallest elements in parallel, without modifying the input.
+ *
+ * This is a parallel variant of Floyd-Rivest's algorithm:
+ * at each round, a bracket which likely contains the k-th element is estimated from a sample,
+ * the elements are classified in parallel as below, inside or above the bracket,
+ * and the class which contains the k-th element is compacted into a smaller buffer.
+ * Once small enough, the buffer is processed with `select_pair()`.
+ */
+template <typename T>
+std::pair<T, T> parallel_select_pair(Index threads, const T* data, Index size, Index k)
+{
+  std::vector<T> buffer;
+  while (threads > 1 && size >= ParallelSelectionMin) {
+
+    // Estimate the bracket from a regular sample
+    const Index sample_size = std::min<Index>(size, 4096);
+    std::vector<T> sample(sample_size);
+    for (Index i = 0; i < sample_size; ++i) {
+      sample[i] = data[i * size / sample_size];
+    }
+    std::sort(sample.begin(), sample.end());
+    const auto center = k * sample_size / size;
+    const auto margin = static_cast<Index>(2 * std::sqrt(double(sample_size)));
+    const auto lo = sample[std::max<Index>(center - margin, 0)];
+    const auto hi = sample[std::min<Index>(center + margin, sample_size - 1)];
+    const auto classify = [&](const T& e) -> Index {
+      return e < lo ? 0 : (hi < e ? 2 : 1);
+    };
+
+    // Classify in parallel
+    const auto bounds = chunk_bounds(threads, size);
+    const auto count = static_cast<Index>(bounds.size()) - 1;
+    std::vector<SelectionClasses<T>> chunks(count);
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      for (Index j = bounds[i]; j < bounds[i + 1]; ++j) {
+        chunks[i].add(classify(data[j]), data[j]);
+      }
+    }
+    SelectionClasses<T> classes;
+    for (const auto& c : chunks) {
+      classes.merge(c);
+    }
+
+    // Locate the k-th and (k+1)-th elements
+    Index c = 0;
+    Index offset = 0;
+    while (k >= offset + classes.counts[c]) {
+      offset += classes.counts[c];
+      ++c;
+    }
+    if (k + 1 == offset + classes.counts[c]) { // (k+1)-th element is the min of the next non-empty class
+      Index d = c + 1;
+      while (d < 3 && classes.counts[d] == 0) {
+        ++d;
+      }
+      return {classes.maxs[c], d < 3 ? classes.mins[d] : classes.maxs[c]};
+    }
+    if (classes.mins[c] == classes.maxs[c]) {
+      return {classes.mins[c], classes.mins[c]};
+    }
+    if (classes.counts[c] == size) { // Bad bracket
+      break;
+    }
+
+    // Compact the class in parallel
+    std::vector<Index> offsets(count + 1, 0);
+    for (Index i = 0; i < count; ++i) {
+      offsets[i + 1] = offsets[i] + chunks[i].counts[c];
+    }
+    std::vector<T> compacted(classes.counts[c]);
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      auto* out = compacted.data() + offsets[i];
+      for (Index j = bounds[i]; j < bounds[i + 1]; ++j) {
+        if (classify(data[j]) == c) {
+          *out++ = data[j];
+        }
+      }
+    }
+    buffer = std::move(compacted);
+    data = buffer.data();
+    size = classes.counts[c];
+    k -= offset;
+  }
+  if (data != buffer.data()) {
+    buffer.assign(data, data + size);
+  }
+  return select_pair(buffer.data(), size, k);
+}
+
+/**
+ * @brief Compute the median of a buffer in place, possibly in parallel.
+ */
+template <typename T>
+typename TypeTraits<T>::Floating median_inplace(Index threads, T* data, Index size)
+{
+  using Floating = typename TypeTraits<T>::Floating;
+  const auto k = (size - 1) / 2;
+  const auto pair = threads > 1 && size >= ParallelSelectionMin ? parallel_select_pair<T>(threads, data, size, k) :
+                                                                  select_pair(data, size, k);
+  if (size % 2) {
+    return pair.first;
+  }
+  return (Floating(pair.first) + Floating(pair.second)) / 2;
+}
+
+/**
+ * @brief Compute the median absolute deviation of a buffer in place, possibly in parallel.
+ *
+ * The values are replaced with the absolute deviations.
+ */
+template <typename T>
+T mad_inplace(Index threads, T* data, Index size)
+{
+  const T m = median_inplace(threads, data, size);
+  const auto bounds = chunk_bounds(size >= ParallelSelectionMin ? threads : 1, size);
+  const auto count = static_cast<Index>(bounds.size()) - 1;
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+  for (Index i = 0; i < count; ++i) {
+    for (Index j = bounds[i]; j < bounds[i + 1]; ++j) {
+      data[j] = std::abs(data[j] - m);
+    }
+  }
+  return median_inplace(threads, data, size);
+}
+
+/**
+ * @brief Copy a range into a scratch buffer, possibly in parallel.
+ */
+template <typename TRange, typename T>
+void copy_to_scratch(Index threads, const TRange& in, std::vector<T>& scratch)
+{
+  const auto size = static_cast<Index>(in.size());
+  scratch.resize(size);
+  if constexpr (std::is_pointer_v<decltype(in.begin())>) {
+    const auto* data = in.begin();
+    const auto bounds = chunk_bounds(size >= ParallelSelectionMin ? threads : 1, size);
+    const auto count = static_cast<Index>(bounds.size()) - 1;
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      std::copy(data + bounds[i], data + bounds[i + 1], scratch.data() + bounds[i]);
+    }
+  } else {
+    std::copy(in.begin(), in.end(), scratch.begin());
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median of a range.
+ * @param in The input range
+ * @param scratch A scratch buffer, which is resized if needed and whose capacity can be reused across calls
+ *
+ * The median is computed by selection (introselect) in the scratch buffer, in linear time,
+ * without sorting nor allocating if the scratch buffer is large enough.
+ * This is useful when computing the median of many small ranges, e.g. of tiles for background estimation:
+ *
+ * \code
+ * std::vector<float> scratch;
+ * for (const auto& tile : tiles) {
+ *   background.push_back(median(tile, scratch));
+ * }
+ * \endcode
+ *
+ * If the range is a writable buffer whose values can be reordered, `median_inplace()` saves the copy.
+ *
+ * @see `mad()`
+ * @see `DataDistribution` for non-destructive estimators which share partially sorted values
+ * @see `QuantileSketch` for approximate estimators with bounded memory
+ */
+template <typename TRange, typename T>
+typename TypeTraits<T>::Floating median(const TRange& in, std::vector<T>& scratch)
+{
+  Internal::copy_to_scratch(1, in, scratch);
+  return Internal::median_inplace(1, scratch.data(), static_cast<Index>(scratch.size()));
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median of a range in parallel.
+ *
+ * Selection is performed by parallel partitioning for large ranges,
+ * and the input is read directly, without copying it, if its data is contiguous.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+typename TypeTraits<std::decay_t<typename TRange::value_type>>::Floating
+median(const ParallelPolicy& policy, const TRange& in)
+{
+  using T = std::decay_t<typename TRange::value_type>;
+  const auto threads = policy.thread_count();
+  const auto size = static_cast<Index>(in.size());
+  if constexpr (std::is_pointer_v<decltype(in.begin())>) {
+    if (threads > 1 && size >= Internal::ParallelSelectionMin) {
+      using Floating = typename TypeTraits<T>::Floating;
+      const auto pair = Internal::parallel_select_pair<T>(threads, in.begin(), size, (size - 1) / 2);
+      return size % 2 ? Floating(pair.first) : (Floating(pair.first) + Floating(pair.second)) / 2;
+    }
+  }
+  std::vector<T> scratch;
+  Internal::copy_to_scratch(threads, in, scratch);
+  return Internal::median_inplace(threads, scratch.data(), size);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median of a buffer in place.
+ *
+ * The values are reordered.
+ */
+template <typename T>
+typename TypeTraits<T>::Floating median_inplace(T* data, Index size)
+{
+  return Internal::median_inplace(1, data, size);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median absolute deviation of a range.
+ * @param in The input range
+ * @param scratch A scratch buffer, which is resized if needed and whose capacity can be reused across calls
+ *
+ * Both the median and the median of the absolute deviations are computed by selection in the same scratch buffer.
+ * For the deviations to be exact, the scratch value type should be floating point, e.g. `double` for integer inputs.
+ *
+ * @see `median()`
+ */
+template <typename TRange, typename T>
+T mad(const TRange& in, std::vector<T>& scratch)
+{
+  Internal::copy_to_scratch(1, in, scratch);
+  return Internal::mad_inplace(1, scratch.data(), static_cast<Index>(scratch.size()));
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median absolute deviation of a range in parallel.
+ * @see `ParallelPolicy`
+ */
+template <typename TRange, typename T>
+T mad(const ParallelPolicy& policy, const TRange& in, std::vector<T>& scratch)
+{
+  const auto threads = policy.thread_count();
+  Internal::copy_to_scratch(threads, in, scratch);
+  return Internal::mad_inplace(threads, scratch.data(), static_cast<Index>(scratch.size()));
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the exact median absolute deviation of a buffer in place.
+ *
+ * The values are replaced with the absolute deviations.
+ */
+template <typename T>
+T mad_inplace(T* data, Index size)
+{
+  return Internal::mad_inplace(1, data, size);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,83 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_SPANS_H
+#define _LINXBASE_SPANS_H
+
+#include <algorithm> // transform
+#include <type_traits>
+#include <utility> // declval
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A function object which accepts any span, used to detect `for_each_span()` methods.
+ */
+struct SpanProbe {
+  template <typename TIt>
+  void operator()(TIt, TIt) const
+  {}
+};
+
+/**
+ * @brief Test whether a range provides a `for_each_span()` method.
+ */
+template <typename T, typename = void>
+struct HasSpans : std::false_type {};
+
+template <typename T>
+struct HasSpans<T, std::void_t<decltype(std::declval<T&>().for_each_span(SpanProbe()))>> : std::true_type {};
+
+/**
+ * @brief Call a function on consecutive spans which cover a range, in iteration order.
+ * @param func The function, which takes begin and end iterators
+ *
+ * Ranges which provide a `for_each_span()` method, like box-based patches of rasters,
+ * are split into spans of pointers to contiguous elements, such that loops can be vectorized.
+ * Other ranges are processed as a single span.
+ */
+template <typename TRange, typename TFunc>
+void for_each_span(TRange& in, TFunc&& func)
+{
+  if constexpr (HasSpans<TRange>::value) {
+    in.for_each_span(func);
+  } else {
+    func(in.begin(), in.end());
+  }
+}
+
+/**
+ * @brief Apply a function to each element of a range in place, span by span.
+ */
+template <typename TRange, typename TFunc>
+void transform_spans(TRange& in, TFunc&& func)
+{
+  for_each_span(in, [&](auto begin, auto end) {
+    std::transform(begin, end, begin, func);
+  });
+}
+
+/**
+ * @brief Apply a binary function to each element of a range and of another range in place, span by span.
+ */
+template <typename TRange, typename TOther, typename TFunc>
+void transform_spans(TRange& in, const TOther& other, TFunc&& func)
+{
+  auto it = other.begin();
+  for_each_span(in, [&](auto begin, auto end) {
+    for (auto e = begin; e != end; ++e, ++it) {
+      *e = func(*e, *it);
+    }
+  });
+}
+
+} // namespace Internal
+/// @endcond
+
+} // namespace Linx
+
+#endif
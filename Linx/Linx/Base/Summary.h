@@ -0,0 +1,365 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_SUMMARY_H
+#define _LINXBASE_SUMMARY_H
+
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/Reduction.h" // IsRandomAccess
+#include "Linx/Base/TypeUtils.h"
+
+#include <algorithm> // min, max
+#include <cmath> // sqrt
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief One-pass summary statistics: count, min, max, sum, mean and variance.
+ * @tparam T The element type
+ *
+ * Values are accumulated with Welford's algorithm, which is numerically stable,
+ * and summaries of disjoint sets of values, e.g. computed by different threads or on different tiles,
+ * are merged with Chan's formula.
+ *
+ * @see `summarize()`
+ */
+template <typename T>
+class Summary {
+public:
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Empty summary constructor.
+   */
+  Summary() : m_count(0), m_min(), m_max(), m_mean(0), m_m2(0) {}
+
+  /**
+   * @brief Iterator constructor.
+   */
+  template <typename TIt>
+  Summary(TIt begin, TIt end) : Summary()
+  {
+    for (; begin != end; ++begin) {
+      insert(*begin);
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index count() const
+  {
+    return m_count;
+  }
+
+  /**
+   * @brief Get the min value.
+   */
+  const T& min() const
+  {
+    return m_min;
+  }
+
+  /**
+   * @brief Get the max value.
+   */
+  const T& max() const
+  {
+    return m_max;
+  }
+
+  /**
+   * @brief Get the sum of the values.
+   */
+  double sum() const
+  {
+    return m_mean * m_count;
+  }
+
+  /**
+   * @brief Get the mean.
+   */
+  double mean() const
+  {
+    return m_mean;
+  }
+
+  /**
+   * @brief Get the variance.
+   * @param unbiased Divide by `count() - 1` instead of `count()`
+   */
+  double variance(bool unbiased = true) const
+  {
+    return m_m2 / (m_count - unbiased);
+  }
+
+  /**
+   * @brief Get the standard deviation.
+   */
+  double stdev(bool unbiased = true) const
+  {
+    return std::sqrt(variance(unbiased));
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Insert a value.
+   */
+  void insert(const T& value)
+  {
+    if (m_count == 0) {
+      m_min = value;
+      m_max = value;
+    } else {
+      m_min = std::min(m_min, value);
+      m_max = std::max(m_max, value);
+    }
+    ++m_count;
+    const double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+  }
+
+  /**
+   * @brief Merge the summary of another set of values.
+   */
+  void merge(const Summary& other)
+  {
+    if (other.m_count == 0) {
+      return;
+    }
+    if (m_count == 0) {
+      *this = other;
+      return;
+    }
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    const auto count = m_count + other.m_count;
+    const auto delta = other.m_mean - m_mean;
+    m_mean += delta * other.m_count / count;
+    m_m2 += other.m_m2 + delta * delta * m_count * other.m_count / count;
+    m_count = count;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The number of values.
+   */
+  Index m_count;
+
+  /**
+   * @brief The min value.
+   */
+  T m_min;
+
+  /**
+   * @brief The max value.
+   */
+  T m_max;
+
+  /**
+   * @brief The running mean.
+   */
+  double m_mean;
+
+  /**
+   * @brief The sum of the squared differences to the mean.
+   */
+  double m_m2;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Locate the bin of a value in arbitrary edges, with a branchless binary search.
+ *
+ * The value must be in `[edges[0], edges[size - 1]]`, where the last bin is closed.
+ */
+template <typename U, typename T>
+inline Index locate_bin(const U* edges, Index size, const T& value)
+{
+  const U* base = edges;
+  Index length = size - 1;
+  while (length > 1) {
+    const auto half = length / 2;
+    base = base[half] <= value ? base + half : base;
+    length -= half;
+  }
+  return base - edges;
+}
+
+/**
+ * @brief Call a function on chunks of a range in parallel, and gather one result per chunk.
+ *
+ * Ranges with random-access iterators are split into one chunk per thread, other ranges are processed as one chunk.
+ */
+template <typename TResult, typename TRange, typename TFunc>
+std::vector<TResult> parallel_gather(Index threads, const TRange& in, TFunc&& func)
+{
+  if constexpr (IsRandomAccess<TRange>::value) {
+    const auto bounds = chunk_bounds(threads, static_cast<Index>(in.size()));
+    const auto count = static_cast<Index>(bounds.size()) - 1;
+    std::vector<TResult> out(count);
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      out[i] = func(in.begin() + bounds[i], in.begin() + bounds[i + 1]);
+    }
+    return out;
+  } else {
+    return {func(in.begin(), in.end())};
+  }
+}
+
+/**
+ * @brief Add histograms.
+ */
+inline std::vector<std::size_t> merge_histograms(const std::vector<std::vector<std::size_t>>& histograms)
+{
+  auto out = histograms[0];
+  for (std::size_t i = 1; i < histograms.size(); ++i) {
+    for (std::size_t b = 0; b < out.size(); ++b) {
+      out[b] += histograms[i][b];
+    }
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso Summary
+ * @brief Compute the summary statistics of a range in one pass.
+ */
+template <typename TRange>
+Summary<std::decay_t<typename TRange::value_type>> summarize(const TRange& in)
+{
+  return Summary<std::decay_t<typename TRange::value_type>>(in.begin(), in.end());
+}
+
+/**
+ * @relatesalso Summary
+ * @brief Compute the summary statistics of a range in one parallel pass.
+ *
+ * The summary of each chunk is computed by one thread, and the summaries are then merged.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+Summary<std::decay_t<typename TRange::value_type>> summarize(const ParallelPolicy& policy, const TRange& in)
+{
+  using Result = Summary<std::decay_t<typename TRange::value_type>>;
+  const auto summaries = Internal::parallel_gather<Result>(policy.thread_count(), in, [](auto begin, auto end) {
+    return Result(begin, end);
+  });
+  Result out;
+  for (const auto& s : summaries) {
+    out.merge(s);
+  }
+  return out;
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the histogram of a range with uniform bins in parallel.
+ * @param policy The execution policy
+ * @param in The input range
+ * @param front The lower bound of the first bin
+ * @param back The upper bound of the last bin
+ * @param count The number of bins
+ *
+ * Bins are closed-open intervals, except the last bin, which includes `back`.
+ * Values out of `[front, back]` are ignored.
+ * The bin of each value is computed in constant time.
+ * One histogram is computed per chunk, and the histograms are then added.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+std::vector<std::size_t> histogram(const ParallelPolicy& policy, const TRange& in, double front, double back, Index count)
+{
+  const auto scale = count / (back - front);
+  const auto histograms =
+      Internal::parallel_gather<std::vector<std::size_t>>(policy.thread_count(), in, [&](auto begin, auto end) {
+        std::vector<std::size_t> out(count, 0);
+        for (; begin != end; ++begin) {
+          const auto& e = *begin;
+          if (e >= front && e <= back) {
+            ++out[std::min(static_cast<Index>((e - front) * scale), count - 1)];
+          }
+        }
+        return out;
+      });
+  return Internal::merge_histograms(histograms);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the histogram of a range with uniform bins.
+ */
+template <typename TRange>
+std::vector<std::size_t> histogram(const TRange& in, double front, double back, Index count)
+{
+  return histogram(ParallelPolicy(1), in, front, back, count);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the histogram of a range with arbitrary bins in parallel.
+ * @param policy The execution policy
+ * @param in The input range
+ * @param bins The increasing bin edges
+ *
+ * The output size is the size of `bins` minus one.
+ * Bins are closed-open intervals, except the last bin, which includes `bins.back()`.
+ * Values out of `[bins.front(), bins.back()]` are ignored.
+ * The bin of each value is found with a branchless binary search.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename TRange, typename TBins>
+std::vector<std::size_t> histogram(const ParallelPolicy& policy, const TRange& in, const TBins& bins)
+{
+  using U = std::decay_t<decltype(*bins.begin())>;
+  const std::vector<U> edges(bins.begin(), bins.end());
+  const auto size = static_cast<Index>(edges.size());
+  const auto histograms =
+      Internal::parallel_gather<std::vector<std::size_t>>(policy.thread_count(), in, [&](auto begin, auto end) {
+        std::vector<std::size_t> out(size - 1, 0);
+        for (; begin != end; ++begin) {
+          const auto& e = *begin;
+          if (e >= edges.front() && e <= edges.back()) {
+            ++out[Internal::locate_bin(edges.data(), size, e)];
+          }
+        }
+        return out;
+      });
+  return Internal::merge_histograms(histograms);
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Compute the histogram of a range with arbitrary bins.
+ */
+template <typename TRange, typename TBins>
+std::vector<std::size_t> histogram(const TRange& in, const TBins& bins)
+{
+  return histogram(ParallelPolicy(1), in, bins);
+}
+
+} // namespace Linx
+
+#endif
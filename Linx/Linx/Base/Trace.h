@@ -0,0 +1,409 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_TRACE_H
+#define _LINXBASE_TRACE_H
+
+#include "Linx/Base/MemoryTracker.h"
+#include "Linx/Base/TypeUtils.h" // Index
+
+#include <algorithm> // min, max
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory> // unique_ptr
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+/**
+ * @brief Record the duration of the enclosing scope in the `TraceRecorder`, if compiled with `LINX_TRACE`.
+ * @param name The event name, which must outlive the recorder, e.g. a string literal
+ * @param category The event category, with the same lifetime requirement
+ *
+ * Without `LINX_TRACE`, the macro expands to nothing, such that instrumented code has no overhead at all.
+ */
+#ifdef LINX_TRACE
+#define LINX_TRACE_SCOPE(name, category) \
+  ::Linx::TraceScope LINX_TRACE_CONCAT(linx_trace_scope_, __LINE__)(name, category)
+#define LINX_TRACE_CONCAT(a, b) LINX_TRACE_CONCAT_IMPL(a, b)
+#define LINX_TRACE_CONCAT_IMPL(a, b) a##b
+#else
+#define LINX_TRACE_SCOPE(name, category)
+#endif
+
+namespace Linx {
+
+/**
+ * @brief A complete trace event, i.e. a named time interval.
+ */
+struct TraceEvent {
+  /**
+   * @brief The event name.
+   */
+  const char* name;
+
+  /**
+   * @brief The event category.
+   */
+  const char* category;
+
+  /**
+   * @brief The start time, in nanoseconds since the recorder creation.
+   */
+  std::int64_t begin;
+
+  /**
+   * @brief The end time, in nanoseconds since the recorder creation.
+   */
+  std::int64_t end;
+
+  /**
+   * @brief The peak number of bytes allocated by the thread during the event, or -1 if not tracked.
+   */
+  std::int64_t bytes;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A ring buffer of events which is written by a single thread.
+ *
+ * When full, the oldest events are overwritten.
+ */
+struct TraceBuffer {
+  TraceBuffer(Index tid, Index capacity) : thread(tid), events(std::max<Index>(capacity, 1)), count(0) {}
+
+  /**
+   * @brief Append an event.
+   */
+  void push(const TraceEvent& event)
+  {
+    const auto c = count.load(std::memory_order_relaxed);
+    events[c % events.size()] = event;
+    count.store(c + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Get the number of retained events.
+   */
+  std::size_t size() const
+  {
+    return std::min(count.load(std::memory_order_acquire), events.size());
+  }
+
+  Index thread;
+  std::vector<TraceEvent> events;
+  std::atomic<std::size_t> count;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief A process-wide recorder of trace events, which can be exported to the Chrome trace format.
+ *
+ * Each thread records into its own ring buffer, such that recording involves neither locking nor allocation,
+ * except for the first event of each thread.
+ * Event names and categories are not copied: they must outlive the recorder, e.g. be string literals.
+ *
+ * Recording is disabled by default, and has to be enabled at runtime, e.g. in a benchmark program:
+ *
+ * \code
+ * TraceRecorder::instance().enable();
+ * ...
+ * TraceRecorder::instance().write("trace.json"); // Open with chrome://tracing or ui.perfetto.dev
+ * \endcode
+ *
+ * Library code is instrumented with `LINX_TRACE_SCOPE`,
+ * which records nothing unless the program is compiled with `-DLINX_TRACE`.
+ * User code can use `TraceScope` directly, which only costs an atomic load when recording is disabled.
+ *
+ * Events can be recorded concurrently, but `enable()`, `clear()` and `write()` should not be called while recording.
+ */
+class TraceRecorder {
+public:
+
+  /**
+   * @brief The default number of events per thread.
+   */
+  static constexpr Index default_capacity = 1 << 16;
+
+  /**
+   * @brief Get the recorder.
+   */
+  static TraceRecorder& instance()
+  {
+    static TraceRecorder out;
+    return out;
+  }
+
+  /**
+   * @brief Enable recording.
+   * @param capacity The number of events retained per thread, beyond which oldest events are overwritten
+   *
+   * The capacity applies to the threads which did not record yet.
+   */
+  void enable(Index capacity = default_capacity)
+  {
+    m_capacity = capacity;
+    m_enabled.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Disable recording.
+   */
+  void disable()
+  {
+    m_enabled.store(false, std::memory_order_release);
+  }
+
+  /**
+   * @brief Check whether recording is enabled.
+   */
+  bool enabled() const
+  {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the current time, in nanoseconds since the recorder creation.
+   */
+  std::int64_t now() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+  }
+
+  /**
+   * @brief Record an event in the buffer of the calling thread.
+   */
+  void record(const char* name, const char* category, std::int64_t begin, std::int64_t end, std::int64_t bytes = -1)
+  {
+    buffer().push({name, category, begin, end, bytes});
+  }
+
+  /**
+   * @brief Get the number of retained events.
+   */
+  Index size() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t out = 0;
+    for (const auto& b : m_buffers) {
+      out += b->size();
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the retained events, in recording order for each thread.
+   * @return The pairs of thread index and event
+   */
+  std::vector<std::pair<Index, TraceEvent>> events() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::pair<Index, TraceEvent>> out;
+    for (const auto& b : m_buffers) {
+      const auto count = b->count.load(std::memory_order_acquire);
+      const auto capacity = b->events.size();
+      for (auto i = count > capacity ? count - capacity : 0; i < count; ++i) {
+        out.emplace_back(b->thread, b->events[i % capacity]);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Discard the retained events.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& b : m_buffers) {
+      b->count.store(0, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Write the retained events in the Chrome trace JSON format, which is also read by Perfetto.
+   *
+   * If memory is tracked, the peak number of bytes of each event is written as argument `peak_bytes`.
+   */
+  void write(std::ostream& os) const
+  {
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& e : events()) {
+      os << (first ? "\n" : ",\n") << "{\"name\":\"";
+      write_escaped(os, e.second.name);
+      os << "\",\"cat\":\"";
+      write_escaped(os, e.second.category);
+      os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.first << ",\"ts\":" << e.second.begin / 1000 << '.'
+         << fraction(e.second.begin) << ",\"dur\":" << (e.second.end - e.second.begin) / 1000 << '.'
+         << fraction(e.second.end - e.second.begin);
+      if (e.second.bytes >= 0) {
+        os << ",\"args\":{\"peak_bytes\":" << e.second.bytes << '}';
+      }
+      os << '}';
+      first = false;
+    }
+    os << "\n]}\n";
+  }
+
+  /**
+   * @brief Write the retained events to a Chrome trace JSON file.
+   */
+  void write(const std::filesystem::path& path) const
+  {
+    std::ofstream ofs(path);
+    if (not ofs) {
+      throw std::runtime_error("Cannot open trace file: " + path.string());
+    }
+    write(ofs);
+  }
+
+private:
+
+  /**
+   * @brief Constructor.
+   */
+  TraceRecorder() : m_enabled(false), m_capacity(default_capacity), m_epoch(std::chrono::steady_clock::now()) {}
+
+  /**
+   * @brief Get the buffer of the calling thread, which is created if needed.
+   */
+  Internal::TraceBuffer& buffer()
+  {
+    thread_local Internal::TraceBuffer* out = nullptr;
+    if (not out) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_buffers.push_back(std::make_unique<Internal::TraceBuffer>(m_buffers.size(), m_capacity));
+      out = m_buffers.back().get();
+    }
+    return *out;
+  }
+
+  /**
+   * @brief Get the three decimals of a time in microseconds, given in nanoseconds.
+   */
+  static std::string fraction(std::int64_t ns)
+  {
+    const auto digits = std::to_string(1000 + ns % 1000);
+    return digits.substr(1);
+  }
+
+  /**
+   * @brief Write a JSON-escaped string.
+   */
+  static void write_escaped(std::ostream& os, const char* text)
+  {
+    for (const char* c = text; c && *c; ++c) {
+      if (*c == '"' || *c == '\\') {
+        os << '\\';
+      }
+      os << *c;
+    }
+  }
+
+  /**
+   * @brief The recording status.
+   */
+  std::atomic<bool> m_enabled;
+
+  /**
+   * @brief The capacity of new buffers.
+   */
+  Index m_capacity;
+
+  /**
+   * @brief The time origin.
+   */
+  std::chrono::steady_clock::time_point m_epoch;
+
+  /**
+   * @brief The mutex which guards the list of buffers.
+   */
+  mutable std::mutex m_mutex;
+
+  /**
+   * @brief The per-thread buffers, which outlive their threads.
+   */
+  std::vector<std::unique_ptr<Internal::TraceBuffer>> m_buffers;
+};
+
+/**
+ * @brief A RAII recorder of the duration of a scope.
+ *
+ * If recording is enabled at construction, an event is recorded at destruction.
+ * If the program is compiled with `LINX_TRACK_MEMORY`, the event includes the peak memory allocated in the scope.
+ *
+ * @see `LINX_TRACE_SCOPE`
+ */
+class TraceScope {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param name The event name, which must outlive the recorder
+   * @param category The event category, which must outlive the recorder
+   */
+  explicit TraceScope(const char* name, const char* category = "Linx") :
+      m_name(name), m_category(category),
+      m_begin(TraceRecorder::instance().enabled() ? TraceRecorder::instance().now() : -1), m_memory()
+  {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  TraceScope(const TraceScope&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  /**
+   * @brief Destructor.
+   */
+  ~TraceScope()
+  {
+    if (m_begin >= 0) {
+      auto& recorder = TraceRecorder::instance();
+      const auto bytes = MemoryTracker::instrumented() ? m_memory.peak() : -1;
+      recorder.record(m_name, m_category, m_begin, recorder.now(), bytes);
+    }
+  }
+
+private:
+
+  /**
+   * @brief The event name.
+   */
+  const char* m_name;
+
+  /**
+   * @brief The event category.
+   */
+  const char* m_category;
+
+  /**
+   * @brief The start time, or -1 if recording is disabled.
+   */
+  std::int64_t m_begin;
+
+  /**
+   * @brief The memory account of the scope.
+   */
+  MemoryScope m_memory;
+};
+
+} // namespace Linx
+
+#endif
@@ -327,6 +327,26 @@ constexpr bool is_base_template_of()
   return decltype(Internal::is_base_template_of_impl<TBase>(std::declval<TDerived*>()))::value;
 }
 
+/**
+ * @brief Tag type to construct data holders and containers without initializing their values.
+ * @see `uninitialized`
+ */
+struct UninitializedTag {};
+
+/**
+ * @brief Tag to construct data holders and containers without initializing their values.
+ * 
+ * This saves writing the whole memory when values are overwritten anyway, e.g. by some file read or filtering:
+ * 
+ * \code
+ * AlignedRaster<float> out(in.shape(), uninitialized);
+ * filter.transform(in, out);
+ * \endcode
+ * 
+ * Holders which do not support it, e.g. `std::vector`-based holders, value-initialize their elements nonetheless.
+ */
+inline constexpr UninitializedTag uninitialized {};
+
 } // namespace Linx
 
 #endif
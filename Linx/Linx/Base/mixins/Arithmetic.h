@@ -5,38 +5,70 @@
 #ifndef _LINXBASE_MIXINS_ARITHMETIC_H
 #define _LINXBASE_MIXINS_ARITHMETIC_H
 
+#include "Linx/Base/Spans.h"
 #include "Linx/Base/TypeUtils.h" // LINX_FORWARD
 
 #include <algorithm>
 #include <boost/operators.hpp>
 #include <functional>
 #include <type_traits>
+#include <utility> // move
 
 namespace Linx {
 
 #define LINX_VECTOR_OPERATOR_INPLACE(op) \
   TDerived& operator op##=(const TDerived & rhs) \
   { \
-    std::transform( \
-        LINX_CRTP_DERIVED.begin(), \
-        LINX_CRTP_DERIVED.end(), \
-        rhs.begin(), \
-        LINX_CRTP_DERIVED.begin(), \
-        [](auto e, auto f) { \
-          return e op f; \
-        }); \
+    Internal::transform_spans(LINX_CRTP_DERIVED, rhs, [](auto e, auto f) { \
+      return e op f; \
+    }); \
     return LINX_CRTP_DERIVED; \
   }
 
 #define LINX_SCALAR_OPERATOR_INPLACE(op) \
   TDerived& operator op##=(const T & rhs) \
   { \
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [&](auto e) { \
+    Internal::transform_spans(LINX_CRTP_DERIVED, [&](auto e) { \
       return e op rhs; \
     }); \
     return LINX_CRTP_DERIVED; \
   }
 
+#define LINX_VECTOR_OPERATOR_RVALUE(op) \
+  friend TDerived operator op(TDerived&& lhs, const TDerived& rhs) \
+  { \
+    lhs op##= rhs; \
+    return std::move(lhs); \
+  } \
+  friend TDerived operator op(const TDerived& lhs, TDerived&& rhs) \
+  { \
+    Internal::transform_spans(rhs, lhs, [](auto f, auto e) { \
+      return e op f; \
+    }); \
+    return std::move(rhs); \
+  } \
+  friend TDerived operator op(TDerived&& lhs, TDerived&& rhs) \
+  { \
+    lhs op##= rhs; \
+    return std::move(lhs); \
+  }
+
+#define LINX_SCALAR_OPERATOR_RVALUE(op) \
+  friend TDerived operator op(TDerived&& lhs, const T& rhs) \
+  { \
+    lhs op##= rhs; \
+    return std::move(lhs); \
+  }
+
+#define LINX_SCALAR_OPERATOR_RVALUE_LEFT(op) \
+  friend TDerived operator op(const T& lhs, TDerived&& rhs) \
+  { \
+    Internal::transform_spans(rhs, [&](auto e) { \
+      return lhs op e; \
+    }); \
+    return std::move(rhs); \
+  }
+
 /**
  * @ingroup concepts
  * @requirements{VectorArithmetic}
@@ -47,6 +79,10 @@ namespace Linx {
  * - Vector-additive: V += U, W = V + U, V -= U, W = V - U;
  * - Scalar-additive: V += a, V = U + a, V = a + U, V -= a, V = U + a, V = a - U, V++, ++V, V--, --V;
  * - Scalar-multiplicative: V *= a, V = U * a, V = a * U, V /= a, V = U / a.
+ * 
+ * When an operand of an operator which returns a new instance is a temporary,
+ * its data is reused for the result instead of being copied,
+ * such that chains like `-(a + b) * c` allocate a single buffer.
  */
 class VectorArithmetic;
 
@@ -114,7 +150,7 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
    */
   TDerived& operator++()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [](auto rhs) {
       return ++rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -125,7 +161,7 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
    */
   TDerived& operator--()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [](auto rhs) {
       return --rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -136,23 +172,58 @@ struct ArithmeticMixin<VectorArithmetic, T, TDerived> :
   /**
    * @brief Copy.
    */
-  TDerived operator+() const
+  TDerived operator+() const&
+  {
+    return LINX_CRTP_CONST_DERIVED;
+  }
+
+  /**
+   * @brief Move.
+   */
+  TDerived operator+() &&
   {
-    return *this;
+    return std::move(LINX_CRTP_DERIVED);
   }
 
   /**
    * @brief Compute the opposite.
    */
-  TDerived operator-() const
+  TDerived operator-() const&
   {
     TDerived res = LINX_CRTP_CONST_DERIVED;
-    std::transform(res.begin(), res.end(), res.begin(), [&](auto r) {
+    Internal::transform_spans(res, [&](auto r) {
       return -r;
     });
     return res;
   }
 
+  /**
+   * @brief Compute the opposite in place of a temporary.
+   */
+  TDerived operator-() &&
+  {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [&](auto r) {
+      return -r;
+    });
+    return std::move(LINX_CRTP_DERIVED);
+  }
+
+  LINX_VECTOR_OPERATOR_RVALUE(+) ///< W = V + U
+  LINX_SCALAR_OPERATOR_RVALUE(+) ///< V = U + a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(+) ///< V = a + U
+
+  LINX_VECTOR_OPERATOR_RVALUE(-) ///< W = V - U
+  LINX_SCALAR_OPERATOR_RVALUE(-) ///< V = U - a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(-) ///< V = a - U
+
+  LINX_SCALAR_OPERATOR_RVALUE(*) ///< V = U * a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(*) ///< V = a * U
+
+  LINX_SCALAR_OPERATOR_RVALUE(/) ///< V = U / a
+
+  LINX_VECTOR_OPERATOR_RVALUE(%) ///< W = V % U
+  LINX_SCALAR_OPERATOR_RVALUE(%) ///< V = U % a
+
   /// @}
 };
 
@@ -195,7 +266,7 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
    */
   TDerived& operator++()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [](auto rhs) {
       return ++rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -206,7 +277,7 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
    */
   TDerived& operator--()
   {
-    std::transform(LINX_CRTP_DERIVED.begin(), LINX_CRTP_DERIVED.end(), LINX_CRTP_DERIVED.begin(), [](auto rhs) {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [](auto rhs) {
       return --rhs;
     });
     return LINX_CRTP_DERIVED;
@@ -217,23 +288,60 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
   /**
    * @brief Copy.
    */
-  TDerived operator+() const
+  TDerived operator+() const&
   {
-    return *this;
+    return LINX_CRTP_CONST_DERIVED;
+  }
+
+  /**
+   * @brief Move.
+   */
+  TDerived operator+() &&
+  {
+    return std::move(LINX_CRTP_DERIVED);
   }
 
   /**
    * @brief Compute the opposite.
    */
-  TDerived operator-() const
+  TDerived operator-() const&
   {
-    TDerived res = static_cast<const TDerived&>(*this);
-    std::transform(res.begin(), res.end(), res.begin(), [&](auto r) {
+    TDerived res = LINX_CRTP_CONST_DERIVED;
+    Internal::transform_spans(res, [&](auto r) {
       return -r;
     });
     return res;
   }
 
+  /**
+   * @brief Compute the opposite in place of a temporary.
+   */
+  TDerived operator-() &&
+  {
+    Internal::transform_spans(LINX_CRTP_DERIVED, [&](auto r) {
+      return -r;
+    });
+    return std::move(LINX_CRTP_DERIVED);
+  }
+
+  LINX_VECTOR_OPERATOR_RVALUE(+) ///< W = V + U
+  LINX_SCALAR_OPERATOR_RVALUE(+) ///< V = U + a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(+) ///< V = a + U
+
+  LINX_VECTOR_OPERATOR_RVALUE(-) ///< W = V - U
+  LINX_SCALAR_OPERATOR_RVALUE(-) ///< V = U - a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(-) ///< V = a - U
+
+  LINX_VECTOR_OPERATOR_RVALUE(*) ///< W = V * U
+  LINX_SCALAR_OPERATOR_RVALUE(*) ///< V = U * a
+  LINX_SCALAR_OPERATOR_RVALUE_LEFT(*) ///< V = a * U
+
+  LINX_VECTOR_OPERATOR_RVALUE(/) ///< W = V / U
+  LINX_SCALAR_OPERATOR_RVALUE(/) ///< V = U / a
+
+  LINX_VECTOR_OPERATOR_RVALUE(%) ///< W = V % U
+  LINX_SCALAR_OPERATOR_RVALUE(%) ///< V = U % a
+
   /// @}
 };
 
@@ -241,6 +349,9 @@ struct ArithmeticMixin<EuclidArithmetic, T, TDerived> :
 
 #undef LINX_VECTOR_OPERATOR_INPLACE
 #undef LINX_SCALAR_OPERATOR_INPLACE
+#undef LINX_VECTOR_OPERATOR_RVALUE
+#undef LINX_SCALAR_OPERATOR_RVALUE
+#undef LINX_SCALAR_OPERATOR_RVALUE_LEFT
 
 } // namespace Linx
 
@@ -9,9 +9,25 @@
 
 #include <algorithm> // equal
 #include <ostream>
+#include <type_traits> // void_t
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether a container must be detached before being written, e.g. because of a `CowHolder`.
+ */
+template <typename T, typename = void>
+struct IsDetachable : std::false_type {};
+
+template <typename T>
+struct IsDetachable<T, std::void_t<decltype(std::declval<T&>().detach())>> : std::true_type {};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup concepts
  * @requirements{ContiguousContainer}
@@ -144,6 +160,7 @@ struct ContiguousContainerMixin {
    */
   inline T* data()
   {
+    detach_holder();
     return const_cast<T*>(const_cast<const ContiguousContainerMixin&>(*this).data());
   }
 
@@ -160,6 +177,7 @@ struct ContiguousContainerMixin {
    */
   inline T& operator[](size_type index)
   {
+    detach_holder();
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this)[index]);
   }
 
@@ -176,6 +194,7 @@ struct ContiguousContainerMixin {
    */
   inline T& front()
   {
+    detach_holder();
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this).front());
   }
 
@@ -192,6 +211,7 @@ struct ContiguousContainerMixin {
    */
   inline T& back()
   {
+    detach_holder();
     return const_cast<T&>(const_cast<const ContiguousContainerMixin&>(*this).back());
   }
 
@@ -202,6 +222,7 @@ struct ContiguousContainerMixin {
    */
   iterator begin()
   {
+    detach_holder();
     return const_cast<iterator>(const_cast<const TDerived&>(static_cast<TDerived&>(*this)).begin()); // TODO cleaner?
   }
 
@@ -218,6 +239,7 @@ struct ContiguousContainerMixin {
    */
   iterator end()
   {
+    detach_holder();
     return const_cast<iterator>(const_cast<const TDerived&>(static_cast<TDerived&>(*this)).end()); // TODO cleaner?
   }
 
@@ -249,6 +271,18 @@ struct ContiguousContainerMixin {
   }
 
   /// @}
+
+private:
+
+  /**
+   * @brief Give the holder a chance to prepare for writing, e.g. to duplicate shared data.
+   */
+  inline void detach_holder()
+  {
+    if constexpr (Internal::IsDetachable<TDerived>::value) {
+      static_cast<TDerived&>(*this).detach();
+    }
+  }
 };
 
 /**
@@ -98,7 +98,9 @@ public:
    */
   T& at(Index i)
   {
-    return const_cast<T&>(const_cast<const DataContainer&>(*this).at(i));
+    const auto& self = const_cast<const DataContainer&>(*this);
+    const auto offset = &self.at(i) - self.data();
+    return this->data()[offset];
   }
 
   /// @}
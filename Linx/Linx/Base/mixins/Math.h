@@ -5,14 +5,21 @@
 #ifndef _LINXBASE_MIXINS_MATH_H
 #define _LINXBASE_MIXINS_MATH_H
 
+#include "Linx/Base/FastMath.h"
+#include "Linx/Base/Reduction.h"
 #include "Linx/Base/SeqUtils.h" // IsRange
+#include "Linx/Base/Spans.h"
 
 #include <algorithm>
 #include <cmath>
-#include <numeric> // inner_product
+#include <type_traits>
+#include <utility> // move
 
 namespace Linx {
 
+template <typename T, typename TDerived>
+struct ContiguousContainerMixin;
+
 /**
  * @brief &pi;
  */
@@ -60,7 +67,7 @@ struct MathFunctionsMixin {
   TDerived& function() \
   { \
     auto* derived = static_cast<TDerived*>(this); \
-    std::transform(derived->begin(), derived->end(), derived->begin(), [](auto e) { \
+    Internal::transform_spans(*derived, [](auto e) { \
       return std::function(e); \
     }); \
     return *derived; \
@@ -72,7 +79,7 @@ struct MathFunctionsMixin {
   const std::enable_if_t<IsRange<U>::value, TDerived>& function(const U& other) \
   { \
     auto* derived = static_cast<TDerived*>(this); \
-    std::transform(derived->begin(), derived->end(), other.begin(), derived->begin(), [](auto e, auto f) { \
+    Internal::transform_spans(*derived, other, [](auto e, auto f) { \
       return std::function(e, f); \
     }); \
     return *derived; \
@@ -84,7 +91,7 @@ struct MathFunctionsMixin {
   std::enable_if_t<not IsRange<U>::value, TDerived>& function(U other) \
   { \
     auto* derived = static_cast<TDerived*>(this); \
-    std::transform(derived->begin(), derived->end(), derived->begin(), [=](auto e) { \
+    Internal::transform_spans(*derived, [=](auto e) { \
       return std::function(e, other); \
     }); \
     return *derived; \
@@ -140,8 +147,37 @@ struct MathFunctionsMixin {
   LINX_MATH_UNARY_INPLACE(tgamma)
   LINX_MATH_UNARY_INPLACE(lgamma)
 
+#define LINX_MATH_FAST_INPLACE(function) \
+  /** @brief Apply fast_##function##(), with a vectorized kernel for contiguous `float` and `double` spans. */ \
+  TDerived& fast_##function() \
+  { \
+    auto* derived = static_cast<TDerived*>(this); \
+    if constexpr ( \
+        (std::is_same_v<T, float> || std::is_same_v<T, double>) && \
+        std::is_base_of_v<ContiguousContainerMixin<T, TDerived>, TDerived>) { \
+      Linx::fast_##function(derived->data(), derived->size()); \
+    } else { \
+      Internal::for_each_span(*derived, [](auto begin, auto end) { \
+        if constexpr ((std::is_same_v<T, float> || std::is_same_v<T, double>) && std::is_pointer_v<decltype(begin)>) { \
+          Linx::fast_##function(begin, end - begin); \
+        } else { \
+          std::transform(begin, end, begin, [](auto e) { \
+            return Linx::fast_##function(e); \
+          }); \
+        } \
+      }); \
+    } \
+    return *derived; \
+  }
+
+  LINX_MATH_FAST_INPLACE(cos)
+  LINX_MATH_FAST_INPLACE(sin)
+  LINX_MATH_FAST_INPLACE(exp)
+  LINX_MATH_FAST_INPLACE(log)
+
 #undef LINX_MATH_UNARY_INPLACE
 #undef LINX_MATH_BINARY_INPLACE
+#undef LINX_MATH_FAST_INPLACE
 };
 
 #define LINX_MATH_UNARY_NEWINSTANCE(function) \
@@ -152,6 +188,14 @@ struct MathFunctionsMixin {
     TDerived out(static_cast<const TDerived&>(in)); \
     out.function(); \
     return out; \
+  } \
+  /** @relatesalso MathFunctionsMixin @brief Apply std::##function##() (in place of a temporary). */ \
+  template <typename T, typename TDerived> \
+  TDerived function(MathFunctionsMixin<T, TDerived>&& in) \
+  { \
+    auto& out = static_cast<TDerived&>(in); \
+    out.function(); \
+    return std::move(out); \
   }
 
 #define LINX_MATH_BINARY_NEWINSTANCE(function) \
@@ -162,6 +206,14 @@ struct MathFunctionsMixin {
     TDerived out(static_cast<const TDerived&>(in)); \
     out.function(other); \
     return out; \
+  } \
+  /** @relatesalso MathFunctionsMixin @brief Apply std::##function##() (in place of a temporary). */ \
+  template <typename T, typename TDerived, typename TOther> \
+  TDerived function(MathFunctionsMixin<T, TDerived>&& in, const TOther& other) \
+  { \
+    auto& out = static_cast<TDerived&>(in); \
+    out.function(other); \
+    return std::move(out); \
   }
 
 LINX_MATH_UNARY_NEWINSTANCE(abs)
@@ -207,6 +259,11 @@ LINX_MATH_UNARY_NEWINSTANCE(erfc)
 LINX_MATH_UNARY_NEWINSTANCE(tgamma)
 LINX_MATH_UNARY_NEWINSTANCE(lgamma)
 
+LINX_MATH_UNARY_NEWINSTANCE(fast_cos)
+LINX_MATH_UNARY_NEWINSTANCE(fast_sin)
+LINX_MATH_UNARY_NEWINSTANCE(fast_exp)
+LINX_MATH_UNARY_NEWINSTANCE(fast_log)
+
 #undef LINX_MATH_UNARY_NEWINSTANCE
 #undef LINX_MATH_BINARY_NEWINSTANCE
 
@@ -217,11 +274,12 @@ LINX_MATH_UNARY_NEWINSTANCE(lgamma)
 template <Index P, typename T, typename TDerived>
 T norm(const MathFunctionsMixin<T, TDerived>& in)
 {
-  T out(0);
-  for (const auto& e : static_cast<const TDerived&>(in)) {
-    out += abspow<P>(e);
-  }
-  return out;
+  return transform_sum<T>(
+      Summation::Lanes,
+      [](T e) {
+        return abspow<P>(e);
+      },
+      static_cast<const TDerived&>(in));
 }
 
 /**
@@ -231,15 +289,13 @@ T norm(const MathFunctionsMixin<T, TDerived>& in)
 template <Index P, typename T, typename TDerived, typename U, typename UDerived>
 T distance(const MathFunctionsMixin<T, TDerived>& lhs, const MathFunctionsMixin<U, UDerived>& rhs)
 {
-  return std::inner_product(
-      static_cast<const TDerived&>(lhs).begin(),
-      static_cast<const TDerived&>(lhs).end(),
-      static_cast<const UDerived&>(rhs).begin(),
-      0.,
-      std::plus<T> {},
+  return transform_sum<double>(
+      Summation::Lanes,
       [](T a, T b) {
         return abspow<P>(b - a);
-      });
+      },
+      static_cast<const TDerived&>(lhs),
+      static_cast<const UDerived&>(rhs));
 }
 
 } // namespace Linx
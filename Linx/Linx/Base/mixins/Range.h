@@ -6,12 +6,87 @@
 #define _LINXBASE_MIXINS_RANGE_H
 
 #include "Linx/Base/DataDistribution.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/QuantileSketch.h"
+#include "Linx/Base/Reduction.h"
+#include "Linx/Base/Spans.h"
 
 #include <algorithm>
+#include <cstdint> // uint64_t
+#include <iterator> // next
 #include <numeric> // accumulate
+#include <type_traits>
 
 namespace Linx {
 
+template <typename T, typename TDerived>
+struct ContiguousContainerMixin;
+
+class CounterGenerator;
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a function is a counter-based random noise generator, which takes the element index.
+ */
+template <typename TFunc>
+struct IsCounterNoise : std::is_base_of<CounterGenerator, std::decay_t<TFunc>> {};
+
+/**
+ * @brief Test whether a type is a box-based patch, i.e. whether its domain is its bounding box.
+ */
+template <typename T, typename = void>
+struct IsBoxPatch : std::false_type {};
+
+template <typename T>
+struct IsBoxPatch<T, std::void_t<decltype(std::declval<T&>().box()), decltype(std::declval<T&>().domain())>> :
+    std::is_same<
+        std::decay_t<decltype(std::declval<T&>().box())>,
+        std::decay_t<decltype(std::declval<T&>().domain())>> {};
+
+/**
+ * @brief Split a range into chunks processed in parallel.
+ * @param func The chunk function, which takes the index of the first element, and begin and end iterators
+ *
+ * Contiguous ranges are split into chunks aligned to cache lines,
+ * box-based patches are split along their last axis,
+ * and other ranges are processed as a single chunk.
+ */
+template <typename T, typename TDerived, typename TFunc>
+void parallel_ranges(const ParallelPolicy& policy, TDerived& in, TFunc&& func)
+{
+  if constexpr (std::is_base_of_v<ContiguousContainerMixin<T, TDerived>, TDerived>) {
+    auto* data = in.data();
+    parallel_chunks(
+        policy.thread_count(),
+        in.size(),
+        [&](Index front, Index back) {
+          func(front, data + front, data + back);
+        },
+        data,
+        sizeof(T));
+  } else if constexpr (IsBoxPatch<TDerived>::value) {
+    const auto box = in.box();
+    const auto axis = static_cast<Index>(box.front().size()) - 1;
+    const auto length = box.length(axis);
+    const auto slice_size = length > 0 ? box.size() / length : 0;
+    parallel_chunks(policy.thread_count(), length, [&](Index front, Index back) {
+      auto chunk_front = box.front();
+      auto chunk_back = box.back();
+      chunk_front[axis] += front;
+      chunk_back[axis] = box.front()[axis] + back - 1;
+      auto chunk = in(std::decay_t<decltype(box)>(chunk_front, chunk_back));
+      func(front * slice_size, chunk.begin(), chunk.end());
+    });
+  } else {
+    func(0, in.begin(), in.end());
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup mixins
  * @brief Base class to provide range operations.
@@ -28,7 +103,30 @@ struct RangeMixin { // FIXME merge with DataContainer
    */
   TDerived& fill(const T& value)
   {
-    std::fill(static_cast<TDerived&>(*this).begin(), static_cast<TDerived&>(*this).end(), value);
+    Internal::for_each_span(static_cast<TDerived&>(*this), [&](auto begin, auto end) {
+      std::fill(begin, end, value);
+    });
+    return static_cast<TDerived&>(*this);
+  }
+
+  /**
+   * @brief Copy the values of a container of compatible size.
+   */
+  template <typename TContainer>
+  TDerived& assign(const TContainer& in)
+  {
+    auto it = in.begin();
+    Internal::for_each_span(static_cast<TDerived&>(*this), [&](auto begin, auto end) {
+      if constexpr (std::is_pointer_v<decltype(it)> && std::is_pointer_v<decltype(begin)>) {
+        const auto size = end - begin;
+        std::copy(it, it + size, begin); // memmove
+        it += size;
+      } else {
+        for (auto e = begin; e != end; ++e, ++it) {
+          *e = *it;
+        }
+      }
+    });
     return static_cast<TDerived&>(*this);
   }
 
@@ -45,10 +143,45 @@ struct RangeMixin { // FIXME merge with DataContainer
   {
     auto v = min;
     auto& t = static_cast<TDerived&>(*this);
-    for (auto& e : t) {
-      e = v;
-      v += step;
-    }
+    Internal::for_each_span(t, [&](auto begin, auto end) {
+      for (auto it = begin; it != end; ++it) {
+        *it = v;
+        v += step;
+      }
+    });
+    return t;
+  }
+
+  /**
+   * @brief Fill the container with a single value, in parallel.
+   * @see `ParallelPolicy`
+   */
+  TDerived& fill(const ParallelPolicy& policy, const T& value)
+  {
+    auto& t = static_cast<TDerived&>(*this);
+    Internal::parallel_ranges<T>(policy, t, [&](Index, auto begin, auto end) {
+      std::fill(begin, end, value);
+    });
+    return t;
+  }
+
+  /**
+   * @brief Fill the container with evenly spaced value, in parallel.
+   * 
+   * The first value of each chunk is computed as `min + step * i`,
+   * such that rounding errors may differ from those of the sequential version.
+   * @see `ParallelPolicy`
+   */
+  TDerived& range(const ParallelPolicy& policy, const T& min = Limits<T>::zero(), const T& step = Limits<T>::one())
+  {
+    auto& t = static_cast<TDerived&>(*this);
+    Internal::parallel_ranges<T>(policy, t, [&](Index offset, auto begin, auto end) {
+      T v = min + step * static_cast<T>(offset);
+      for (auto it = begin; it != end; ++it) {
+        *it = v;
+        v += step;
+      }
+    });
     return t;
   }
 
@@ -87,14 +220,32 @@ struct RangeMixin { // FIXME merge with DataContainer
    * res.generate([](auto v) { return std::sqrt(v); }, a); // res = sqrt(a)
    * res.generate([](auto v, auto w) { return v * w; }, a, b); // res = a * b
    * \endcode
+   * 
+   * Counter-based random noise generators are called with the index of each element in addition.
+   * @see `CounterGenerator`
    */
-  template <typename TFunc, typename... TContainers>
+  template <
+      typename TFunc,
+      typename... TContainers,
+      typename std::enable_if_t<not std::is_same_v<std::decay_t<TFunc>, ParallelPolicy>>* = nullptr>
   TDerived& generate(TFunc&& func, const TContainers&... args)
   {
     auto its = std::make_tuple(args.begin()...);
     auto& t = static_cast<TDerived&>(*this);
-    for (auto& v : t) {
-      v = iterator_tuple_apply(its, func);
+    if constexpr (Internal::IsCounterNoise<TFunc>::value) {
+      std::uint64_t index = 0;
+      for (auto& v : t) {
+        v = iterator_tuple_apply(its, [&](const auto&... es) {
+          return func.at(index, es...);
+        });
+        ++index;
+      }
+    } else {
+      Internal::for_each_span(t, [&](auto begin, auto end) {
+        for (auto it = begin; it != end; ++it) {
+          *it = iterator_tuple_apply(its, func);
+        }
+      });
     }
     return t;
   }
@@ -114,12 +265,53 @@ struct RangeMixin { // FIXME merge with DataContainer
    * res.apply([](auto v, auto w) { return v * w; }, a); // res *= a
    * \endcode
    */
-  template <typename TFunc, typename... TContainers>
+  template <
+      typename TFunc,
+      typename... TContainers,
+      typename std::enable_if_t<not std::is_same_v<std::decay_t<TFunc>, ParallelPolicy>>* = nullptr>
   TDerived& apply(TFunc&& func, const TContainers&... args)
   {
     return generate(std::forward<TFunc>(func), static_cast<TDerived&>(*this), args...);
   }
 
+  /**
+   * @brief Generate values from a function with optional input containers, in parallel.
+   * 
+   * Input containers are best contiguous, since their iterators are advanced to the front of each chunk.
+   * @see `ParallelPolicy`
+   */
+  template <typename TFunc, typename... TContainers>
+  TDerived& generate(const ParallelPolicy& policy, TFunc&& func, const TContainers&... args)
+  {
+    auto& t = static_cast<TDerived&>(*this);
+    Internal::parallel_ranges<T>(policy, t, [&](Index offset, auto begin, auto end) {
+      auto its = std::make_tuple(std::next(args.begin(), offset)...);
+      if constexpr (Internal::IsCounterNoise<TFunc>::value) {
+        std::uint64_t index = offset;
+        for (auto it = begin; it != end; ++it, ++index) {
+          *it = iterator_tuple_apply(its, [&](const auto&... es) {
+            return func.at(index, es...);
+          });
+        }
+      } else {
+        for (auto it = begin; it != end; ++it) {
+          *it = iterator_tuple_apply(its, func);
+        }
+      }
+    });
+    return t;
+  }
+
+  /**
+   * @brief Apply a function with optional input containers, in parallel.
+   * @see `ParallelPolicy`
+   */
+  template <typename TFunc, typename... TContainers>
+  TDerived& apply(const ParallelPolicy& policy, TFunc&& func, const TContainers&... args)
+  {
+    return generate(policy, std::forward<TFunc>(func), static_cast<TDerived&>(*this), args...);
+  }
+
   /**
    * @brief Reverse the order of the elements.
    */
@@ -240,11 +432,35 @@ std::pair<const typename TRange::value_type&, const typename TRange::value_type&
  * @relatesalo RangeMixin
  * @brief Compute the sum of a range.
  * @param offset An offset
+ * @param mode The summation algorithm
+ * @see `transform_sum()`
  */
 template <typename TRange>
-double sum(const TRange& in, double offset = 0)
+double sum(const TRange& in, double offset = 0, Summation mode = Summation::Lanes)
 {
-  return std::accumulate(in.begin(), in.end(), offset);
+  return offset + transform_sum<double>(
+                      mode,
+                      [](const auto& e) {
+                        return double(e);
+                      },
+                      in);
+}
+
+/**
+ * @relatesalo RangeMixin
+ * @brief Compute the sum of a range in parallel.
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+double sum(const ParallelPolicy& policy, const TRange& in, double offset = 0, Summation mode = Summation::Lanes)
+{
+  return offset + transform_sum<double>(
+                      policy,
+                      mode,
+                      [](const auto& e) {
+                        return double(e);
+                      },
+                      in);
 }
 
 /**
@@ -269,6 +485,17 @@ double mean(const TRange& in)
   return sum(in) / in.size();
 }
 
+/**
+ * @relatesalo RangeMixin
+ * @brief Compute the mean of a range in parallel.
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+double mean(const ParallelPolicy& policy, const TRange& in)
+{
+  return sum(policy, in) / in.size();
+}
+
 /**
  * @relatesalo RangeMixin
  * @brief Create a `DataDistribution` from the container.
@@ -279,6 +506,50 @@ DataDistribution<typename TRange::value_type> distribution(const TRange& in)
   return DataDistribution<typename TRange::value_type>(in);
 }
 
+/**
+ * @relatesalo RangeMixin
+ * @brief Create a `QuantileSketch` from the container.
+ * @param k The accuracy parameter
+ */
+template <typename TRange>
+QuantileSketch<std::decay_t<typename TRange::value_type>> sketch(const TRange& in, std::size_t k = 200)
+{
+  return QuantileSketch<std::decay_t<typename TRange::value_type>>(in, k);
+}
+
+/**
+ * @relatesalo RangeMixin
+ * @brief Create a `QuantileSketch` from the container in parallel.
+ *
+ * Ranges with random-access iterators are split into one chunk per thread,
+ * whose sketches are merged.
+ * Other ranges are processed sequentially.
+ *
+ * @see `ParallelPolicy`
+ */
+template <typename TRange>
+QuantileSketch<std::decay_t<typename TRange::value_type>>
+sketch(const ParallelPolicy& policy, const TRange& in, std::size_t k = 200)
+{
+  using Sketch = QuantileSketch<std::decay_t<typename TRange::value_type>>;
+  if constexpr (Internal::IsRandomAccess<TRange>::value) {
+    const auto bounds = Internal::chunk_bounds(policy.thread_count(), static_cast<Index>(in.size()));
+    const auto count = static_cast<Index>(bounds.size()) - 1;
+    std::vector<Sketch> sketches(count, Sketch(k));
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+    for (Index i = 0; i < count; ++i) {
+      sketches[i].insert(in.begin() + bounds[i], in.begin() + bounds[i + 1]);
+    }
+    Sketch out(k);
+    for (const auto& s : sketches) {
+      out.merge(s);
+    }
+    return out;
+  } else {
+    return sketch(in, k);
+  }
+}
+
 } // namespace Linx
 
 #endif
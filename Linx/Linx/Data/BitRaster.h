@@ -0,0 +1,345 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BITRASTER_H
+#define _LINXDATA_BITRASTER_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <bitset>
+#include <boost/operators.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief A bit-packed ND Boolean raster.
+ *
+ * Values are stored row by row, with 64 values per word, and each row along axis 0 starts at a new word.
+ * For example, a 2D raster of width 100 holds two words per row, such that the memory footprint is 8 times smaller
+ * than that of a `Raster<bool>` or `Raster<char>`.
+ *
+ * Bitwise operators work on whole words.
+ * The unused bits of the last word of each row are always zero.
+ *
+ * @see `erode()`, `dilate()`, `open()`, `close()` for morphological operations
+ */
+template <Index N = 2>
+class BitRaster : boost::bitwise<BitRaster<N>> {
+public:
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The storage word type.
+   */
+  using Word = std::uint64_t;
+
+  /**
+   * @brief The number of values per word.
+   */
+  static constexpr Index WordBits = 64;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit BitRaster(Position<N> shape = Position<N>::zero(), bool value = false) :
+      m_shape(LINX_MOVE(shape)), m_row_words((m_shape[0] + WordBits - 1) / WordBits), m_rows(1), m_words()
+  {
+    for (Index i = 1; i < N; ++i) {
+      m_rows *= m_shape[i];
+    }
+    m_words.resize(m_row_words * m_rows, value ? ~Word(0) : Word(0));
+    if (value) {
+      clear_tails();
+    }
+  }
+
+  /**
+   * @brief Create a bit raster from a raster, where each value is converted to `bool`.
+   */
+  template <typename T, typename THolder>
+  explicit BitRaster(const Raster<T, N, THolder>& in) : BitRaster(in.shape())
+  {
+    auto it = in.begin();
+    for (Index r = 0; r < m_rows; ++r) {
+      auto* row = this->row(r);
+      for (Index x = 0; x < m_shape[0]; ++x, ++it) {
+        if (*it) {
+          row[x / WordBits] |= Word(1) << (x % WordBits);
+        }
+      }
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(Position<N>::zero(), m_shape);
+  }
+
+  /**
+   * @brief Get the number of values.
+   */
+  Index size() const
+  {
+    return m_shape[0] * m_rows;
+  }
+
+  /**
+   * @brief Get the number of words per row.
+   */
+  Index row_words() const
+  {
+    return m_row_words;
+  }
+
+  /**
+   * @brief Get the number of rows, i.e. the product of the lengths along axes 1 and higher.
+   */
+  Index rows() const
+  {
+    return m_rows;
+  }
+
+  /**
+   * @brief Count the `true` values.
+   */
+  Index count() const
+  {
+    Index out = 0;
+    for (auto w : m_words) {
+      out += std::bitset<WordBits>(w).count();
+    }
+    return out;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the value at some position.
+   */
+  bool operator[](const Position<N>& p) const
+  {
+    return (row(row_index(p))[p[0] / WordBits] >> (p[0] % WordBits)) & 1;
+  }
+
+  /**
+   * @brief Set the value at some position.
+   */
+  void set(const Position<N>& p, bool value = true)
+  {
+    auto& word = row(row_index(p))[p[0] / WordBits];
+    const auto bit = Word(1) << (p[0] % WordBits);
+    word = value ? (word | bit) : (word & ~bit);
+  }
+
+  /**
+   * @brief Get a pointer to the words of some row.
+   */
+  const Word* row(Index r) const
+  {
+    return m_words.data() + r * m_row_words;
+  }
+
+  /**
+   * @copydoc row()
+   */
+  Word* row(Index r)
+  {
+    return m_words.data() + r * m_row_words;
+  }
+
+  /**
+   * @brief Get the index of the row which contains some position.
+   */
+  Index row_index(const Position<N>& p) const
+  {
+    Index out = 0;
+    Index stride = 1;
+    for (Index i = 1; i < N; ++i) {
+      out += p[i] * stride;
+      stride *= m_shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the mask of the used bits of the last word of each row.
+   */
+  Word tail_mask() const
+  {
+    const auto used = m_shape[0] - (m_row_words - 1) * WordBits;
+    return used == WordBits ? ~Word(0) : (Word(1) << used) - 1;
+  }
+
+  /**
+   * @brief Get the words.
+   */
+  const std::vector<Word>& words() const
+  {
+    return m_words;
+  }
+
+  /**
+   * @brief Convert to a raster of some type.
+   */
+  template <typename T = bool>
+  Raster<T, N> raster() const
+  {
+    Raster<T, N> out(m_shape);
+    auto it = out.begin();
+    for (Index r = 0; r < m_rows; ++r) {
+      const auto* row = this->row(r);
+      for (Index x = 0; x < m_shape[0]; ++x, ++it) {
+        *it = (row[x / WordBits] >> (x % WordBits)) & 1;
+      }
+    }
+    return out;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compare two bit rasters.
+   */
+  bool operator==(const BitRaster& other) const
+  {
+    return m_shape == other.m_shape && m_words == other.m_words;
+  }
+
+  /**
+   * @brief Compare two bit rasters.
+   */
+  bool operator!=(const BitRaster& other) const
+  {
+    return not(*this == other);
+  }
+
+  /**
+   * @brief Intersection.
+   */
+  BitRaster& operator&=(const BitRaster& other)
+  {
+    return apply(other, [](Word lhs, Word rhs) {
+      return lhs & rhs;
+    });
+  }
+
+  /**
+   * @brief Union.
+   */
+  BitRaster& operator|=(const BitRaster& other)
+  {
+    return apply(other, [](Word lhs, Word rhs) {
+      return lhs | rhs;
+    });
+  }
+
+  /**
+   * @brief Symmetric difference.
+   */
+  BitRaster& operator^=(const BitRaster& other)
+  {
+    return apply(other, [](Word lhs, Word rhs) {
+      return lhs ^ rhs;
+    });
+  }
+
+  /**
+   * @brief Difference, i.e. intersection with the complement.
+   */
+  BitRaster& andnot(const BitRaster& other)
+  {
+    return apply(other, [](Word lhs, Word rhs) {
+      return lhs & ~rhs;
+    });
+  }
+
+  /**
+   * @brief Complement.
+   */
+  BitRaster operator~() const
+  {
+    BitRaster out(*this);
+    for (auto& w : out.m_words) {
+      w = ~w;
+    }
+    out.clear_tails();
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Apply a word-wise operation.
+   */
+  template <typename TFunc>
+  BitRaster& apply(const BitRaster& other, TFunc&& func)
+  {
+    auto it = other.m_words.begin();
+    for (auto& w : m_words) {
+      w = func(w, *it);
+      ++it;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Set the unused bits to zero.
+   */
+  void clear_tails()
+  {
+    if (m_row_words == 0) {
+      return;
+    }
+    const auto mask = tail_mask();
+    for (Index r = 0; r < m_rows; ++r) {
+      row(r)[m_row_words - 1] &= mask;
+    }
+  }
+
+  Position<N> m_shape; ///< The shape
+  Index m_row_words; ///< The number of words per row
+  Index m_rows; ///< The number of rows
+  std::vector<Word> m_words; ///< The words
+};
+
+/**
+ * @relatesalso BitRaster
+ * @brief Compute the difference of two bit rasters, i.e. `lhs & ~rhs`.
+ */
+template <Index N>
+BitRaster<N> andnot(BitRaster<N> lhs, const BitRaster<N>& rhs)
+{
+  lhs.andnot(rhs);
+  return lhs;
+}
+
+} // namespace Linx
+
+#endif
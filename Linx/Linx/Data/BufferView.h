@@ -0,0 +1,120 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BUFFERVIEW_H
+#define _LINXDATA_BUFFERVIEW_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/StridedRaster.h"
+
+#include <algorithm> // reverse
+#include <cstdint> // uintptr_t
+#include <string>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief View a row-major buffer, e.g. a NumPy array or a Python buffer, as a strided raster, without copy.
+ * @param data The address of the first element
+ * @param shape The buffer shape, slowest axis first
+ * @param byte_strides The buffer strides, in bytes, slowest axis first
+ *
+ * Axes are reversed, such that the fastest axis of the buffer is axis 0 of the raster,
+ * e.g. a NumPy array of shape `(height, width)` is viewed as a raster of shape `{width, height}`.
+ * Therefore, C-contiguous buffers are viewed as contiguous rasters, see `buffer_raster()`.
+ *
+ * The data must be aligned for `T`, and strides must be multiples of `sizeof(T)`.
+ * Moreover, the stride of the fastest axis must be positive, and other strides must not be null.
+ * Otherwise, an exception is thrown, and the buffer should be copied, e.g. with `numpy.ascontiguousarray()`.
+ */
+template <typename T, Index N, typename TShape, typename TStrides>
+StridedRaster<T, N> buffer_view(T* data, const TShape& shape, const TStrides& byte_strides)
+{
+  const auto dimension = static_cast<Index>(shape.size());
+  SizeError::may_throw(dimension, N);
+  SizeError::may_throw(static_cast<Index>(byte_strides.size()), N);
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0) {
+    throw Exception("Misaligned buffer data");
+  }
+  const auto element_size = static_cast<Index>(sizeof(T));
+  Position<N> linx_shape(dimension);
+  Position<N> linx_strides(dimension);
+  for (Index i = 0; i < dimension; ++i) {
+    const auto j = dimension - 1 - i;
+    const auto stride = static_cast<Index>(byte_strides[j]);
+    if (stride % element_size != 0) {
+      throw Exception("Buffer stride along axis " + std::to_string(j) + " is not a multiple of the value size");
+    }
+    linx_shape[i] = shape[j];
+    linx_strides[i] = stride / element_size;
+  }
+  if (linx_strides[0] <= 0) {
+    throw Exception("Stride of the fastest buffer axis is not positive");
+  }
+  for (Index i = 1; i < dimension; ++i) {
+    if (linx_strides[i] == 0) {
+      throw Exception("Buffer stride along axis " + std::to_string(dimension - 1 - i) + " is null");
+    }
+  }
+  return StridedRaster<T, N>(linx_shape, data, linx_strides);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief View a C-contiguous row-major buffer as a raster, without copy.
+ * @see `buffer_view()`
+ *
+ * An exception is thrown if the buffer is not contiguous.
+ */
+template <typename T, Index N, typename TShape, typename TStrides>
+PtrRaster<T, N> buffer_raster(T* data, const TShape& shape, const TStrides& byte_strides)
+{
+  const auto view = buffer_view<T, N>(data, shape, byte_strides);
+  if (not view.is_contiguous()) {
+    throw Exception("Buffer is not C-contiguous");
+  }
+  return PtrRaster<T, N>(view.shape(), data);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Get the row-major buffer shape of a raster, i.e. its reversed shape.
+ * @see `buffer_strides()`
+ */
+template <typename TRaster>
+std::vector<Index> buffer_shape(const TRaster& raster)
+{
+  const auto& shape = raster.shape();
+  std::vector<Index> out(shape.begin(), shape.end());
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Get the row-major buffer strides of a raster, in bytes.
+ *
+ * Together with `buffer_shape()`, this describes the raster as a C-contiguous buffer,
+ * e.g. to expose it as a NumPy array without copy.
+ */
+template <typename TRaster>
+std::vector<Index> buffer_strides(const TRaster& raster)
+{
+  const auto& shape = raster.shape();
+  const auto dimension = static_cast<Index>(shape.size());
+  std::vector<Index> out(dimension);
+  Index stride = sizeof(typename TRaster::Value);
+  for (Index i = 0; i < dimension; ++i) {
+    out[dimension - 1 - i] = stride;
+    stride *= shape[i];
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,462 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_EXPRESSION_H
+#define _LINXDATA_EXPRESSION_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/SeqUtils.h" // IsRange
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Vector.h"
+
+#include <functional> // plus, minus...
+#include <tuple>
+#include <type_traits>
+#include <utility> // index_sequence
+#include <vector>
+
+namespace Linx {
+
+template <typename TFunc, typename... TArgs>
+class Expression;
+
+template <typename TFunc, Index N>
+class VirtualRaster;
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a type is an expression.
+ */
+template <typename T>
+struct IsExpression : std::false_type {};
+
+template <typename TFunc, typename... TArgs>
+struct IsExpression<Expression<TFunc, TArgs...>> : std::true_type {};
+
+/**
+ * @brief Test whether a type is a virtual raster.
+ */
+template <typename T>
+struct IsVirtualRaster : std::false_type {};
+
+/**
+ * @brief Test whether a type is a container operand, i.e. a range which is not an expression.
+ */
+template <typename T>
+constexpr bool is_container_operand()
+{
+  return IsRange<T>::value && not IsExpression<T>::value;
+}
+
+/**
+ * @brief The storage of an operand: containers by reference, expressions, virtual rasters and scalars by value.
+ */
+template <typename T>
+using ExpressionOperand =
+    std::conditional_t<is_container_operand<T>() && not IsVirtualRaster<T>::value, const T&, T>;
+
+/**
+ * @brief An iterator over a scalar, which is repeated.
+ */
+template <typename T>
+struct ScalarIterator {
+  const T& operator*() const
+  {
+    return value;
+  }
+
+  ScalarIterator& operator++()
+  {
+    return *this;
+  }
+
+  T value; ///< The scalar
+};
+
+/**
+ * @brief Get an iterator over an operand.
+ */
+template <typename T>
+auto operand_begin(const T& operand)
+{
+  if constexpr (IsRange<T>::value) {
+    return operand.begin();
+  } else {
+    return ScalarIterator<T> {operand};
+  }
+}
+
+/**
+ * @brief The identity function.
+ */
+struct Identity {
+  template <typename T>
+  const T& operator()(const T& value) const
+  {
+    return value;
+  }
+};
+
+/**
+ * @brief The container type of an evaluated expression, given the first container operand.
+ *
+ * Rasters and patches are evaluated as rasters, vectors as vectors, and other containers as `std::vector`.
+ */
+template <typename TOperand, typename T>
+struct EvaluationType {
+  using Type = std::vector<T>;
+
+  static Type make(const TOperand& operand)
+  {
+    return Type(operand.size());
+  }
+};
+
+template <typename U, Index N, typename THolder, typename T>
+struct EvaluationType<Raster<U, N, THolder>, T> {
+  using Type = Raster<T, N>;
+
+  static Type make(const Raster<U, N, THolder>& operand)
+  {
+    return Type(operand.shape());
+  }
+};
+
+template <typename U, typename TParent, typename TRegion, bool IsContiguous, typename T>
+struct EvaluationType<Patch<U, TParent, TRegion, IsContiguous>, T> {
+  using Type = Raster<T, std::decay_t<TParent>::Dimension>;
+
+  static Type make(const Patch<U, TParent, TRegion, IsContiguous>& operand)
+  {
+    return Type(box(operand.domain()).shape());
+  }
+};
+
+template <typename U, Index N, typename T>
+struct EvaluationType<Vector<U, N>, T> {
+  using Type = Vector<T, N>;
+
+  static Type make(const Vector<U, N>& operand)
+  {
+    return Type(operand.size());
+  }
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief A lazy element-wise expression.
+ * @tparam TFunc The element-wise function
+ * @tparam TArgs The operands, which are containers (e.g. `Raster`, `Patch` or `Vector`), expressions or scalars
+ *
+ * As opposed to the arithmetic operators of containers, which create one temporary container per operation,
+ * the operators of expressions only build an expression tree,
+ * which is evaluated element-wise in a single loop by `eval()` or `eval_to()`,
+ * without intermediate buffers.
+ * Expressions are created with `lazy()`, and then composed with arithmetic operators:
+ *
+ * \code
+ * Raster<float> calibrated(raw.shape());
+ * ((lazy(raw) - bias) / flat * gain).eval_to(calibrated);
+ * const auto scaled = (lazy(a) * 2 + b - c).eval();
+ * \endcode
+ *
+ * Container operands are stored by reference, and must therefore outlive the expression.
+ * Since `auto` would then hold dangling references to temporaries, expressions should be evaluated in the statement
+ * where they are built, unless all of their container operands are named variables.
+ *
+ * Expressions are ranges, such that they can also be iterated, e.g. with `generate()` or `std::copy()`.
+ */
+template <typename TFunc, typename... TArgs>
+class Expression {
+public:
+
+  /**
+   * @brief The element value type.
+   */
+  using Value =
+      std::decay_t<decltype(std::declval<const TFunc&>()(*Internal::operand_begin(std::declval<TArgs>())...))>;
+
+  /**
+   * @brief The element value type.
+   */
+  using value_type = Value;
+
+  /**
+   * @brief An element-wise iterator.
+   */
+  class Iterator {
+    friend class Expression;
+
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const TFunc& func, std::tuple<decltype(Internal::operand_begin(std::declval<TArgs>()))...> its, Index i) :
+        m_func(&func), m_its(LINX_MOVE(its)), m_index(i)
+    {}
+
+    /**
+     * @brief Evaluate the current element.
+     */
+    Value operator*() const
+    {
+      return std::apply(
+          [&](const auto&... its) {
+            return Value((*m_func)(*its...));
+          },
+          m_its);
+    }
+
+    /**
+     * @brief Move to the next element.
+     */
+    Iterator& operator++()
+    {
+      std::apply(
+          [](auto&... its) {
+            (++its, ...);
+          },
+          m_its);
+      ++m_index;
+      return *this;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same element.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_index == rhs.m_index;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different elements.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_index != rhs.m_index;
+    }
+
+  private:
+
+    const TFunc* m_func; ///< The function
+    std::tuple<decltype(Internal::operand_begin(std::declval<TArgs>()))...> m_its; ///< The operand iterators
+    Index m_index; ///< The element index
+  };
+
+  /**
+   * @brief Constructor.
+   *
+   * The sizes of the container operands must match.
+   */
+  explicit Expression(TFunc func, const TArgs&... args) : m_func(LINX_MOVE(func)), m_args(args...), m_size(-1)
+  {
+    std::apply(
+        [&](const auto&... operands) {
+          (check_size(operands), ...);
+        },
+        m_args);
+  }
+
+  /**
+   * @brief Get the number of elements.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get an iterator to the first element.
+   */
+  Iterator begin() const
+  {
+    return Iterator(
+        m_func,
+        std::apply(
+            [](const auto&... operands) {
+              return std::make_tuple(Internal::operand_begin(operands)...);
+            },
+            m_args),
+        0);
+  }
+
+  /**
+   * @brief Get an iterator past the last element.
+   */
+  Iterator end() const
+  {
+    auto it = begin();
+    it.m_index = m_size; // Only the index is compared
+    return it;
+  }
+
+  /**
+   * @brief Evaluate the expression into a new container.
+   *
+   * The container type is that of the first container operand, with the expression value type,
+   * where patches are evaluated as rasters.
+   */
+  auto eval() const
+  {
+    using Evaluation = Internal::EvaluationType<std::decay_t<decltype(first_container())>, Value>;
+    auto out = Evaluation::make(first_container());
+    eval_to(out);
+    return out;
+  }
+
+  /**
+   * @brief Evaluate the expression into an existing container of same size.
+   *
+   * The output can be one of the operands.
+   */
+  template <typename TOut>
+  TOut& eval_to(TOut& out) const
+  {
+    SizeError::may_throw(out.size(), m_size);
+    auto it = begin();
+    for (auto& e : out) {
+      e = *it;
+      ++it;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the first container operand, possibly of a nested expression.
+   */
+  decltype(auto) first_container() const
+  {
+    return first_container_impl<0>();
+  }
+
+private:
+
+  /**
+   * @brief Check the size of a container operand, or of a nested expression.
+   */
+  template <typename T>
+  void check_size(const T& operand)
+  {
+    if constexpr (IsRange<T>::value) {
+      const auto size = static_cast<Index>(operand.size());
+      if (m_size >= 0) {
+        SizeError::may_throw(size, m_size);
+      }
+      m_size = size;
+    }
+  }
+
+  /**
+   * @brief Get the first container operand, from operand `I`.
+   */
+  template <std::size_t I>
+  decltype(auto) first_container_impl() const
+  {
+    using T = std::tuple_element_t<I, std::tuple<TArgs...>>;
+    const auto& operand = std::get<I>(m_args);
+    if constexpr (Internal::is_container_operand<T>()) {
+      return operand;
+    } else if constexpr (Internal::IsExpression<T>::value) {
+      return operand.first_container();
+    } else {
+      return first_container_impl<I + 1>();
+    }
+  }
+
+  TFunc m_func; ///< The element-wise function
+  std::tuple<Internal::ExpressionOperand<TArgs>...> m_args; ///< The operands
+  Index m_size; ///< The number of elements
+};
+
+/**
+ * @relatesalso Expression
+ * @brief Make a lazy expression from a container.
+ */
+template <typename T>
+Expression<Internal::Identity, T> lazy(const T& in)
+{
+  return Expression<Internal::Identity, T>(Internal::Identity(), in);
+}
+
+/**
+ * @relatesalso Expression
+ * @brief Make a lazy expression from an element-wise function and operands.
+ *
+ * \code
+ * const auto amplitude = lazy([](auto re, auto im) { return std::sqrt(re * re + im * im); }, re, im).eval();
+ * \endcode
+ */
+template <typename TFunc, typename T0, typename... Ts>
+Expression<std::decay_t<TFunc>, T0, Ts...> lazy(TFunc&& func, const T0& arg0, const Ts&... args)
+{
+  return Expression<std::decay_t<TFunc>, T0, Ts...>(LINX_FORWARD(func), arg0, args...);
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a type can be combined with a virtual raster in an expression, i.e. is a range or a scalar.
+ *
+ * Other types, e.g. filters, define their own operators with virtual rasters.
+ */
+template <typename T>
+constexpr bool is_virtual_raster_operand()
+{
+  return IsRange<T>::value || std::is_arithmetic_v<T> || is_complex<T>();
+}
+
+/**
+ * @brief Test whether a binary operation is lazy,
+ * i.e. whether one of the operands is an expression, or a virtual raster combined with a range or scalar.
+ */
+template <typename TLhs, typename TRhs>
+constexpr bool is_lazy_operation()
+{
+  return IsExpression<TLhs>::value || IsExpression<TRhs>::value ||
+      (IsVirtualRaster<TLhs>::value && is_virtual_raster_operand<TRhs>()) ||
+      (IsVirtualRaster<TRhs>::value && is_virtual_raster_operand<TLhs>());
+}
+
+} // namespace Internal
+/// @endcond
+
+#define LINX_LAZY_OPERATOR(op, functor) \
+  template < \
+      typename TLhs, \
+      typename TRhs, \
+      typename std::enable_if_t<Internal::is_lazy_operation<TLhs, TRhs>()>* = nullptr> \
+  Expression<functor, TLhs, TRhs> operator op(const TLhs& lhs, const TRhs& rhs) \
+  { \
+    return Expression<functor, TLhs, TRhs>(functor(), lhs, rhs); \
+  }
+
+LINX_LAZY_OPERATOR(+, std::plus<>) ///< Lazy addition
+LINX_LAZY_OPERATOR(-, std::minus<>) ///< Lazy subtraction
+LINX_LAZY_OPERATOR(*, std::multiplies<>) ///< Lazy multiplication
+LINX_LAZY_OPERATOR(/, std::divides<>) ///< Lazy division
+LINX_LAZY_OPERATOR(%, std::modulus<>) ///< Lazy modulo
+
+#undef LINX_LAZY_OPERATOR
+
+/**
+ * @relatesalso Expression
+ * @brief Lazy opposite.
+ */
+template <typename TFunc, typename... TArgs>
+Expression<std::negate<>, Expression<TFunc, TArgs...>> operator-(const Expression<TFunc, TArgs...>& in)
+{
+  return Expression<std::negate<>, Expression<TFunc, TArgs...>>(std::negate<>(), in);
+}
+
+} // namespace Linx
+
+#endif
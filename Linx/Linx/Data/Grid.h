@@ -344,10 +344,17 @@ template <Index N>
 inline Grid<N> operator&(const Grid<N>& region, const Box<N>& bounds)
 {
   auto front = bounds.front();
+  auto back = bounds.back();
   for (Index i = 0; i < region.dimension(); ++i) {
-    front[i] += (region.back()[i] - front[i]) % region.step()[i];
+    const auto step = region.step()[i];
+    front[i] = std::max(front[i], region.front()[i]);
+    front[i] += (step - (front[i] - region.front()[i]) % step) % step; // Next node
+    back[i] = std::min(back[i], region.back()[i]);
+    if (back[i] < front[i]) {
+      back[i] = front[i] - step; // Empty grid
+    }
   }
-  return Grid<N>({front, bounds.back()}, region.step());
+  return Grid<N>({front, back}, region.step());
 }
 
 } // namespace Linx
@@ -8,6 +8,12 @@
 #include "Linx/Data/Box.h"
 #include "Linx/Data/Raster.h"
 
+#include <map>
+#include <memory> // shared_ptr, atomic_load, atomic_store
+#include <mutex>
+#include <utility> // pair
+#include <vector>
+
 namespace Linx {
 
 /**
@@ -31,6 +37,11 @@ public:
    */
   class Iterator;
 
+  /**
+   * @brief The runs of set flags, as the position of their first element relative to the box front and their length.
+   */
+  using Runs = std::vector<std::pair<Position<N>, Index>>;
+
   /// @{
   /// @group_construction
 
@@ -69,20 +80,32 @@ public:
   /**
    * @brief Create a mask from a ball with (pseudo-)norm L0, L1 or L2.
    * @tparam P The norm power
+   * 
+   * Balls are cached per norm and radius, together with their runs (see `runs()`),
+   * such that building the same ball again, e.g. for each frame of a stack, only costs a copy of the flags,
+   * and the runs are shared by all the copies.
    */
   template <Index P>
   static Mask<N> ball(double radius = 1, const Position<N>& center = Position<N>::zero())
   {
-    auto out = Mask<N>::from_center(radius, center, false);
-    const auto radius_pow = std::pow(radius, P);
-    auto it = out.m_flags.begin();
-    for (const auto& p : out.box() - center) {
-      if (norm<P>(p) <= radius_pow) {
-        *it = true;
+    static std::map<double, Mask<N>> cache;
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(radius);
+    if (it == cache.end()) {
+      auto ball = Mask<N>::from_center(radius, Position<N>::zero(), false);
+      const auto radius_pow = std::pow(radius, P);
+      auto flag = ball.m_flags.begin();
+      for (const auto& p : ball.box()) {
+        if (norm<P>(p) <= radius_pow) {
+          *flag = true;
+        }
+        ++flag;
       }
-      ++it;
+      ball.runs(); // Compile once for all copies
+      it = cache.emplace(radius, LINX_MOVE(ball)).first;
     }
-    return out;
+    return it->second + center;
   }
 
   /// @group_properties
@@ -127,6 +150,37 @@ public:
     return m_flags;
   }
 
+  /**
+   * @brief Get the runs of set flags along axis 0, in the order of the mask positions.
+   * 
+   * The runs are compiled on first call and shared by the copies of the mask, until its flags are modified.
+   * They are independent of the mask position, and of the strides of the rasters it is applied to.
+   * This method is thread-safe.
+   */
+  const Runs& runs() const
+  {
+    auto runs = std::atomic_load(&m_runs);
+    if (not runs) {
+      auto compiled = std::make_shared<Runs>();
+      const auto* flags = m_flags.data();
+      for_each_row(m_flags.domain(), [&](const Position<N>& front, Index length) {
+        const auto* end = flags + length;
+        auto it = std::find(flags, end, true);
+        while (it != end) {
+          const auto run_end = std::find(it, end, false);
+          auto p = front;
+          p[0] += it - flags;
+          compiled->emplace_back(LINX_MOVE(p), run_end - it);
+          it = std::find(run_end, end, true);
+        }
+        flags = end;
+      });
+      runs = LINX_MOVE(compiled);
+      std::atomic_store(&m_runs, runs); // Concurrent compilations are identical
+    }
+    return *runs;
+  }
+
   /**
    * @brief Get the bounding box length along given axis.
    */
@@ -151,6 +205,7 @@ public:
   bool& operator[](const Position<N>& position)
   {
     // FIXME check bounds here or do not in const overload
+    std::atomic_store(&m_runs, std::shared_ptr<const Runs>());
     return m_flags[position - m_box.front()];
   }
 
@@ -196,6 +251,7 @@ public:
     m_box &= box;
     const auto patch = m_flags(m_box - front);
     m_flags = patch.copy();
+    m_runs.reset();
     return *this;
     // FIXME test
   }
@@ -268,6 +324,7 @@ public:
     auto out = *this;
     out.m_box = -m_box;
     std::reverse(out.m_flags.begin(), out.m_flags.end());
+    out.m_runs.reset();
     return out; // FIXME optimize
   }
 
@@ -284,6 +341,11 @@ private:
    * @brief The flag map.
    */
   Raster<bool, N> m_flags;
+
+  /**
+   * @brief The compiled runs, or null if not compiled yet.
+   */
+  mutable std::shared_ptr<const Runs> m_runs;
 };
 
 /**
@@ -317,6 +379,32 @@ inline Mask<N> operator&(Mask<N> region, const Box<N>& bounds)
   return region;
 }
 
+/**
+ * @relatesalso Mask
+ * @brief Call a function on each run of a mask, i.e. on each segment of contiguous set positions along axis 0.
+ * @param mask The mask
+ * @param func The function, which takes the position of the first element of the run and the run length
+ * 
+ * Runs are visited in the order of the mask positions.
+ * This is the row-wise counterpart of iterating over the positions of a mask, which tests each flag,
+ * in the same way as `for_each_row()` is for boxes:
+ * 
+ * \code
+ * for_each_run(Mask<2>::ball<2>(radius), [&](const auto& front, Index length) {
+ *   auto* row = &raster[front];
+ *   std::fill_n(row, length, 0);
+ * });
+ * \endcode
+ */
+template <Index N, typename TFunc>
+void for_each_run(const Mask<N>& mask, TFunc&& func)
+{
+  const auto& front = mask.box().front();
+  for (const auto& run : mask.runs()) {
+    func(run.first + front, run.second);
+  }
+}
+
 } // namespace Linx
 
 #include "Linx/Data/impl/MaskIterator.h"
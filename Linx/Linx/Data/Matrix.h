@@ -9,28 +9,28 @@
 #include "Linx/Base/mixins/DataContainer.h"
 #include "Linx/Data/Vector.h"
 
-#include <eigen3/Eigen/Core>
+#include <algorithm> // min, swap_ranges
+#include <cmath> // abs
 
 namespace Linx {
 
 /**
  * @ingroup data_classes
- * @brief Euclidean matrix.
- * 
+ * @brief Fixed-size Euclidean matrix.
+ *
  * @tparam T The value type
  * @tparam N The number of rows
  * @tparam M The number of columns
- * 
- * 
- * TODO
+ *
+ * Values are stored in row-major order in a `std::array`, such that matrices never allocate.
+ * Sizes are compile-time constants, which allows the compiler to unroll products and inversions.
+ *
+ * Arithmetic operators are those of vector spaces (see `VectorArithmetic`),
+ * while the matrix-matrix and matrix-vector products are provided as `operator*()`.
  */
 template <typename T, Index N = 2, Index M = N>
-class Matrix :
-    public DataContainer<
-        T,
-        StdHolder<Coordinates<T, N * M>>,
-        EuclidArithmetic,
-        Matrix<T, N, M>> { // FIXME MatrixArithmetic
+class Matrix : public DataContainer<T, StdHolder<Coordinates<T, N * M>>, VectorArithmetic, Matrix<T, N, M>> {
+  static_assert(N >= 0 && M >= 0, "Matrix dimensions must be fixed");
 
 public:
 
@@ -42,7 +42,7 @@ public:
   /**
    * @brief The container type.
    */
-  using Container = DataContainer<T, StdHolder<Coordinates<T, N * M>>, EuclidArithmetic, Matrix<T, N, M>>;
+  using Container = DataContainer<T, StdHolder<Coordinates<T, N * M>>, VectorArithmetic, Matrix<T, N, M>>;
 
   static constexpr Index Rows = N;
   static constexpr Index Columns = M;
@@ -56,9 +56,14 @@ public:
   LINX_DEFAULT_MOVABLE(Matrix)
 
   /**
-   * @brief Constructor.
+   * @brief Create the zero matrix.
    */
-  explicit Matrix() : Container(N * M), m_eigen(this->data()) {}
+  explicit Matrix() : Container(N * M) {}
+
+  /**
+   * @brief Create a matrix from a brace-enclosed list of values in row-major order.
+   */
+  Matrix(std::initializer_list<T> values) : Container(values.begin(), values.end()) {}
 
   /**
    * @brief Create the identity matrix.
@@ -92,7 +97,7 @@ public:
   /**
    * @brief Get the matrix shape.
    */
-  const Position<2>& shape() const
+  static constexpr Position<2> shape()
   {
     return {N, M};
   }
@@ -104,7 +109,7 @@ public:
    */
   inline const T& operator()(Index row, Index column) const
   {
-    return column + Columns * row;
+    return this->data()[column + Columns * row];
   }
 
   /**
@@ -112,7 +117,7 @@ public:
    */
   inline T& operator()(Index row, Index column)
   {
-    return const_cast<T&>(const_cast<const Matrix&>(*this)->at(row, column));
+    return this->data()[column + Columns * row];
   }
 
   /**
@@ -121,21 +126,77 @@ public:
   template <Index R, Index C>
   const T& at() const
   {
-    return C + Columns * R;
+    static_assert(R >= 0 && R < N && C >= 0 && C < M);
+    return this->data()[C + Columns * R];
   }
 
   /// @group_operations
 
+  /**
+   * @brief Compute the determinant.
+   *
+   * The determinant is computed by Gaussian elimination with partial pivoting.
+   */
   T determinant() const
   {
-    return m_eigen.determinant();
+    static_assert(N == M, "Determinant is only defined for square matrices");
+    auto lu = *this;
+    T out(1);
+    for (Index j = 0; j < N; ++j) {
+      const auto p = lu.pivot(j);
+      if (lu(p, j) == T(0)) {
+        return T(0);
+      }
+      if (p != j) {
+        lu.swap_rows(p, j);
+        out = -out;
+      }
+      out *= lu(j, j);
+      for (Index i = j + 1; i < N; ++i) {
+        const auto f = lu(i, j) / lu(j, j);
+        for (Index k = j; k < N; ++k) {
+          lu(i, k) -= f * lu(j, k);
+        }
+      }
+    }
+    return out;
   }
 
   /// @group_modifiers
 
+  /**
+   * @brief Inverse the matrix in place.
+   *
+   * The inverse is computed by Gauss-Jordan elimination with partial pivoting.
+   * If the matrix is singular, then the result contains non-finite values.
+   */
   Matrix& inverse()
   {
-    m_eigen.inverse();
+    static_assert(N == M, "Inverse is only defined for square matrices");
+    auto in = *this;
+    *this = identity();
+    for (Index j = 0; j < N; ++j) {
+      const auto p = in.pivot(j);
+      if (p != j) {
+        in.swap_rows(p, j);
+        swap_rows(p, j);
+      }
+      const auto d = T(1) / in(j, j);
+      for (Index k = 0; k < N; ++k) {
+        in(j, k) *= d;
+        (*this)(j, k) *= d;
+      }
+      for (Index i = 0; i < N; ++i) {
+        const auto f = in(i, j);
+        if (i == j || f == T(0)) {
+          continue;
+        }
+        for (Index k = 0; k < N; ++k) {
+          in(i, k) -= f * in(j, k);
+          (*this)(i, k) -= f * (*this)(j, k);
+        }
+      }
+    }
     return *this;
   }
 
@@ -143,9 +204,75 @@ public:
 
 private:
 
-  Eigen::Map<Eigen::Matrix<T, N, M, Eigen::RowMajor>> m_eigen;
+  /**
+   * @brief Get the row of the largest absolute value in some column, from the diagonal downward.
+   */
+  Index pivot(Index column) const
+  {
+    Index out = column;
+    for (Index i = column + 1; i < N; ++i) {
+      if (std::abs((*this)(i, column)) > std::abs((*this)(out, column))) {
+        out = i;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Swap two rows.
+   */
+  void swap_rows(Index a, Index b)
+  {
+    auto* d = this->data();
+    std::swap_ranges(d + a * M, d + (a + 1) * M, d + b * M);
+  }
 };
 
+/**
+ * @relatesalso Matrix
+ * @brief Matrix-matrix product.
+ */
+template <typename T, Index N, Index K, Index M>
+Matrix<T, N, M> operator*(const Matrix<T, N, K>& lhs, const Matrix<T, K, M>& rhs)
+{
+  Matrix<T, N, M> out;
+  for (Index i = 0; i < N; ++i) {
+    for (Index k = 0; k < K; ++k) {
+      const auto l = lhs(i, k);
+      for (Index j = 0; j < M; ++j) {
+        out(i, j) += l * rhs(k, j);
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Matrix-vector product.
+ */
+template <typename T, Index N, Index M>
+Vector<T, N> operator*(const Matrix<T, N, M>& lhs, const Vector<T, M>& rhs)
+{
+  auto out = Vector<T, N>::zero();
+  for (Index i = 0; i < N; ++i) {
+    for (Index j = 0; j < M; ++j) {
+      out[i] += lhs(i, j) * rhs[j];
+    }
+  }
+  return out;
+}
+
+/**
+ * @relatesalso Matrix
+ * @brief Get the inverse of a matrix.
+ */
+template <typename T, Index N>
+Matrix<T, N, N> inverse(Matrix<T, N, N> in)
+{
+  return in.inverse();
+}
+
 } // namespace Linx
 
 #endif
@@ -99,7 +99,7 @@ public:
    */
   Box<Patch::Dimension> box() const
   {
-    return box(m_region);
+    return Linx::box(m_region);
   }
 
   /**
@@ -222,6 +222,68 @@ public:
     return &(*begin());
   }
 
+  /**
+   * @brief Call a function on each row of a box-based patch of a raster, as a contiguous span.
+   * @param func The function, which takes a pointer to the first element of the row and the row length
+   * 
+   * This allows writing the innermost loop over contiguous memory, which the compiler can vectorize:
+   * 
+   * \code
+   * patch.for_each_row([](auto* row, Index length) {
+   *   for (Index x = 0; x < length; ++x) {
+   *     row[x] *= 2;
+   *   }
+   * });
+   * \endcode
+   * 
+   * @see `for_each_row(const Box&, TFunc&&)`
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func) const
+  {
+    static_assert(std::is_same_v<Region, Box<Patch::Dimension>>, "for_each_row() requires a box-based patch.");
+    Linx::for_each_row(m_region, [&](const auto& front, Index length) {
+      func(&static_cast<const Parent&>(*m_parent)[front], length);
+    });
+  }
+
+  /**
+   * @copydoc for_each_row()
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func)
+  {
+    static_assert(std::is_same_v<Region, Box<Patch::Dimension>>, "for_each_row() requires a box-based patch.");
+    Linx::for_each_row(m_region, [&](const auto& front, Index length) {
+      func(&(*m_parent)[front], length);
+    });
+  }
+
+  /**
+   * @brief Call a function on consecutive spans which cover the patch, in iteration order.
+   * @param func The function, which takes begin and end iterators
+   *
+   * Box-based patches of rasters are split into rows, and consecutive rows are merged when contiguous in memory,
+   * such that spans are pointers.
+   * Other patches are processed as a single span of patch iterators.
+   * This is how in-place arithmetic, mathematical functions, `fill()`, `generate()`, `apply()` and `assign()`
+   * run over contiguous memory.
+   */
+  template <typename TFunc>
+  void for_each_span(TFunc&& func) const
+  {
+    for_each_span_impl(*this, std::forward<TFunc>(func));
+  }
+
+  /**
+   * @copydoc for_each_span()
+   */
+  template <typename TFunc>
+  void for_each_span(TFunc&& func)
+  {
+    for_each_span_impl(*this, std::forward<TFunc>(func));
+  }
+
   /// @group_modifiers
 
   /**
@@ -340,6 +402,41 @@ public:
 
 private:
 
+  /**
+   * @brief Check whether the patch can be iterated row by row with pointers.
+   */
+  static constexpr bool has_rows()
+  {
+    return std::is_same_v<Region, Box<Patch::Dimension>> &&
+        std::is_same_v<Indexing, StrideBasedIndexing<Parent, Region>>;
+  }
+
+  /**
+   * @brief Implement `for_each_span()` for constant and mutable patches.
+   */
+  template <typename TPatch, typename TFunc>
+  static void for_each_span_impl(TPatch& patch, TFunc&& func)
+  {
+    if constexpr (has_rows()) {
+      decltype(&*patch.begin()) begin = nullptr;
+      decltype(begin) end = nullptr;
+      patch.for_each_row([&](auto* row, Index length) {
+        if (row != end) {
+          if (begin) {
+            func(begin, end);
+          }
+          begin = row;
+        }
+        end = row + length;
+      });
+      if (begin) {
+        func(begin, end);
+      }
+    } else {
+      func(patch.begin(), patch.end());
+    }
+  }
+
   /**
    * @brief The parent raster.
    */
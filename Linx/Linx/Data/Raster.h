@@ -6,7 +6,12 @@
 #define _LINXDATA_RASTER_H
 
 #include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Base/Conversion.h"
+#include "Linx/Base/CowHolder.h"
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/MemoryPool.h"
+#include "Linx/Base/MmapHolder.h"
+#include "Linx/Base/Precompiled.h"
 #include "Linx/Base/Random.h"
 #include "Linx/Base/mixins/DataContainer.h"
 #include "Linx/Data/Box.h"
@@ -14,6 +19,7 @@
 #include "Linx/Data/Patch.h"
 #include "Linx/Data/Sequence.h"
 
+#include <algorithm> // fill, min, move, move_backward
 #include <complex>
 #include <cstdint>
 #include <string>
@@ -97,6 +103,52 @@ using ArrRaster = Raster<T, N, StdHolder<std::array<T, Capacity>>>;
 template <typename T, Index N = 2>
 using AlignedRaster = Raster<T, N, AlignedBuffer<T>>;
 
+/**
+ * @ingroup data_classes
+ * @brief `Raster` which maps a file to memory.
+ * 
+ * Pages of the file are loaded on demand by the OS, such that rasters larger than the RAM can be processed,
+ * e.g. section-wise, and access patterns can be advised with `advise()`.
+ * Read-only files should be mapped as rasters of constant values.
+ * 
+ * \code
+ * MmapRaster<float, 3> cube({width, height, depth}, "cube.raw", MmapMode::ReadWrite, header_size);
+ * \endcode
+ * 
+ * @see `MmapHolder`
+ */
+template <typename T, Index N = 2>
+using MmapRaster = Raster<T, N, MmapHolder<T>>;
+
+/**
+ * @ingroup data_classes
+ * @brief `Raster` which recycles memory, for short-lived temporaries.
+ * 
+ * Memory is acquired from and given back to the thread-local `MemoryPool`,
+ * such that temporaries of the same shape, e.g. in a loop, share the same allocation.
+ * 
+ * @see `PoolHolder`
+ */
+template <typename T, Index N = 2>
+using PoolRaster = Raster<T, N, PoolHolder<T>>;
+
+/**
+ * @ingroup data_classes
+ * @brief `Raster` which shares its data with its copies until it is modified.
+ * 
+ * Copies cost O(1), such that rasters can be passed by value or stored in containers without deep copies:
+ * 
+ * \code
+ * CowRaster<float> raster(shape);
+ * auto copy = raster; // Shared data
+ * copy[0] = 1; // Deep copy
+ * \endcode
+ * 
+ * @see `CowHolder`
+ */
+template <typename T, Index N = 2>
+using CowRaster = Raster<T, N, CowHolder<T>>;
+
 /**
  * @ingroup data_classes
  * @brief Data of a N-dimensional image (2D by default).
@@ -143,6 +195,9 @@ using AlignedRaster = Raster<T, N, AlignedBuffer<T>>;
  * @tspecialization{ValRaster}
  * @tspecialization{ArrRaster}
  * @tspecialization{AlignedRaster}
+ * @tspecialization{MmapRaster}
+ * @tspecialization{PoolRaster}
+ * @tspecialization{CowRaster}
  * 
  * @satisfies{ContiguousContainer}
  * 
@@ -279,6 +334,54 @@ public:
       Container(shape_size(shape), std::forward<TArgs>(args)...), m_shape(std::move(shape))
   {}
 
+  /**
+   * @brief Uninitialized constructor.
+   * @param shape The raster shape
+   * @param args The arguments to be forwarded to the data holder
+   * 
+   * If the holder supports it (e.g. `AlignedBuffer` or `PoolHolder`), the values are not initialized,
+   * which saves writing the whole memory when it is overwritten anyway.
+   * Otherwise, the tag is ignored:
+   * 
+   * \code
+   * Raster<float> raster(shape, uninitialized); // Value-initialized by std::vector
+   * AlignedRaster<float> aligned(shape, uninitialized, huge_page_size); // Uninitialized huge pages
+   * \endcode
+   */
+  template <typename... TArgs>
+  Raster(Position<N> shape, UninitializedTag, TArgs&&... args) :
+      Raster(
+          std::is_constructible<THolder, std::size_t, UninitializedTag, TArgs...>(),
+          std::move(shape),
+          std::forward<TArgs>(args)...)
+  {}
+
+  /**
+   * @brief Parallel first-touch constructor.
+   * @param shape The raster shape
+   * @param policy The parallel policy
+   * @param args The arguments to be forwarded to the data holder
+   * 
+   * The values are allocated uninitialized, and then value-initialized in parallel,
+   * with the same partitioning as the pixel-wise operations (see `ParallelPolicy`).
+   * On NUMA systems, memory pages are placed on the node of the thread which first touches them,
+   * such that each band of the raster is local to the thread which later processes it with the same policy.
+   * 
+   * \code
+   * AlignedRaster<float> raster(shape, par);
+   * raster.apply(par, [](auto e) { return std::sqrt(e); }); // Local memory accesses
+   * \endcode
+   * 
+   * This requires a holder which supports uninitialized construction (see `uninitialized`).
+   * @see `numa_nodes()` to query the placement
+   */
+  template <typename... TArgs>
+  Raster(Position<N> shape, ParallelPolicy policy, TArgs&&... args) :
+      Raster(std::move(shape), uninitialized, std::forward<TArgs>(args)...)
+  {
+    this->fill(policy, T());
+  }
+
   /**
    * @brief List-copy constructor.
    * @param shape The raster shape
@@ -309,8 +412,14 @@ public:
    * Holder holder(shape_size(shape), std::forward<TArgs>(args)...);
    * std::copy(range.begin(), range.end(), holder.data());
    * \endcode
+   * 
+   * Strings are not considered as ranges, but forwarded to the holder, e.g. as file names (see `MmapRaster`).
    */
-  template <typename TRange, typename std::enable_if_t<IsRange<TRange>::value>* = nullptr, typename... TArgs>
+  template <
+      typename TRange,
+      typename std::enable_if_t<IsRange<TRange>::value && not std::is_same_v<std::decay_t<TRange>, std::string>>* =
+          nullptr,
+      typename... TArgs>
   explicit Raster(Position<N> shape, TRange& range, TArgs&&... args) :
       Container(range.begin(), range.end(), std::forward<TArgs>(args)...), m_shape(std::move(shape))
   {
@@ -492,7 +601,7 @@ public:
    */
   ConstRow row(Index i) const
   {
-    return row(Position<1> {i}); // FIXME accept other dimensions
+    return row(row_position(i));
   }
 
   /**
@@ -500,7 +609,7 @@ public:
    */
   Row row(Index i)
   {
-    return row(Position<1> {i}); // FIXME accept other dimensions
+    return row(row_position(i));
   }
 
   /**
@@ -588,10 +697,158 @@ public:
     return Patch<T, Raster, R>(*this, {LINX_MOVE(p0), LINX_FORWARD(ps)...});
   }
 
+  /// @group_modifiers
+
+  /**
+   * @brief Change the shape without changing the size, i.e. reinterpret the values.
+   * 
+   * No value is moved nor copied.
+   */
+  Raster& reshape(Position<N> shape)
+  {
+    SizeError::may_throw(shape_size(shape), this->size());
+    m_shape = std::move(shape);
+    return *this;
+  }
+
+  /**
+   * @brief Change the shape and size, and preserve the values of the overlapping region.
+   * 
+   * The values at the positions which belong to both the old and new domains are kept at their positions,
+   * and the other values are value-initialized.
+   * The holder must provide `resize()`, like `StdHolder<std::vector>` or `AlignedBuffer`,
+   * in which case memory is reallocated only if the new size exceeds the capacity,
+   * such that a single raster can be reused for a sequence of slightly different shapes:
+   * 
+   * \code
+   * AlignedRaster<float> frame;
+   * for (const auto& name : names) {
+   *   frame.resize(shape_of(name), uninitialized);
+   *   read_into(name, frame);
+   *   process(frame);
+   * }
+   * \endcode
+   * 
+   * Values are moved in place, row by row, in two passes,
+   * which first compact the overlapping region, and then spread it.
+   */
+  Raster& resize(Position<N> shape)
+  {
+    SizeError::may_throw(shape.size(), m_shape.size());
+    const auto old_size = static_cast<Index>(this->size());
+    const auto new_size = shape_size(shape);
+    if (new_size > old_size) {
+      THolder::resize(new_size);
+    }
+    relayout(m_shape, shape);
+    if (new_size < old_size) {
+      THolder::resize(new_size);
+    }
+    m_shape = std::move(shape);
+    return *this;
+  }
+
+  /**
+   * @brief Change the shape and size, without preserving the values.
+   * 
+   * Like `resize(Position<N>)`, memory is reallocated only if the new size exceeds the capacity,
+   * but the values are left unspecified, e.g. uninitialized for `AlignedBuffer`.
+   */
+  Raster& resize(Position<N> shape, UninitializedTag)
+  {
+    THolder::resize(shape_size(shape));
+    m_shape = std::move(shape);
+    return *this;
+  }
+
   /// @}
 
 private:
 
+  /**
+   * @brief Uninitialized constructor, if supported by the holder.
+   */
+  template <typename... TArgs>
+  Raster(std::true_type, Position<N> shape, TArgs&&... args) :
+      Container(shape_size(shape), uninitialized, std::forward<TArgs>(args)...), m_shape(std::move(shape))
+  {}
+
+  /**
+   * @brief Uninitialized constructor, if not supported by the holder.
+   */
+  template <typename... TArgs>
+  Raster(std::false_type, Position<N> shape, TArgs&&... args) :
+      Container(shape_size(shape), std::forward<TArgs>(args)...), m_shape(std::move(shape))
+  {}
+
+  /**
+   * @brief Move the values of the overlapping region from one layout to another.
+   * @param from The current shape
+   * @param to The target shape
+   * 
+   * The holder must be large enough for both shapes.
+   * Rows of the overlapping region are first compacted front to back, where their offsets can only decrease,
+   * and then spread back to front, where their offsets can only increase, such that no value is overwritten early.
+   * Values outside the overlapping region are finally value-initialized.
+   */
+  void relayout(const Position<N>& from, const Position<N>& to)
+  {
+    const auto dim = static_cast<Index>(from.size());
+    auto overlap = from;
+    for (Index i = 0; i < dim; ++i) {
+      overlap[i] = std::min(from[i], to[i]);
+    }
+    const auto width = dim > 0 ? overlap[0] : 1;
+    const auto rows = width > 0 ? shape_size(overlap) / width : 0;
+    auto* data = this->data();
+    const auto offset = [&](Index r, const Position<N>& shape) {
+      Index out = 0;
+      Index stride = dim > 0 ? shape[0] : 1;
+      for (Index i = 1; i < dim; ++i) {
+        out += (r % overlap[i]) * stride;
+        r /= overlap[i];
+        stride *= shape[i];
+      }
+      return out;
+    };
+    for (Index r = 0; r < rows; ++r) {
+      const auto src = offset(r, from);
+      if (src != r * width) {
+        std::move(data + src, data + src + width, data + r * width);
+      }
+    }
+    for (Index r = rows - 1; r >= 0; --r) {
+      const auto dst = offset(r, to);
+      if (dst != r * width) {
+        std::move_backward(data + r * width, data + (r + 1) * width, data + dst + width);
+      }
+    }
+    const auto to_width = dim > 0 ? to[0] : 1;
+    const auto to_rows = to_width > 0 ? shape_size(to) / to_width : 0;
+    for (Index r = 0; r < to_rows; ++r) {
+      auto* row = data + r * to_width;
+      bool inside = width > 0;
+      for (Index i = 1, q = r; i < dim && inside; ++i) {
+        inside = q % to[i] < overlap[i];
+        q /= to[i];
+      }
+      std::fill(inside ? row + width : row, row + to_width, T());
+    }
+  }
+
+  /**
+   * @brief Get the position of the row of given index, in memory order.
+   */
+  Position<Raster::OneLessDimension> row_position(Index i) const
+  {
+    auto position = Position<Raster::OneLessDimension>::zero(dimension() - 1);
+    for (Index d = 0; d < dimension() - 1; ++d) {
+      position[d] = i % m_shape[d + 1];
+      i /= m_shape[d + 1];
+    }
+    return position;
+  }
+
   /**
    * @brief Raster shape, i.e. length along each axis.
    */
@@ -735,9 +992,61 @@ Raster<T, N> random(const Position<N>& shape)
   return out;
 }
 
+/**
+ * @relatesalso Raster
+ * @brief Convert a raster to another value type with a linear transform, in one pass.
+ * @param in The input raster
+ * @param scale The scaling factor
+ * @param offset The offset, added after scaling
+ *
+ * This is typically used to read scaled integer data, e.g. FITS images with BSCALE and BZERO:
+ *
+ * \code
+ * auto physical = convert<float>(raw, bscale, bzero);
+ * \endcode
+ *
+ * Integral outputs are rounded and saturated.
+ *
+ * @see `convert_n()`
+ * @see `quantize()`
+ */
+template <typename T, typename U, Index N, typename THolder>
+Raster<T, N> convert(const Raster<U, N, THolder>& in, double scale = 1, double offset = 0)
+{
+  Raster<T, N> out(in.shape());
+  convert_n(in.data(), in.size(), out.data(), scale, offset);
+  return out;
+}
+
+/**
+ * @relatesalso Raster
+ * @brief Quantize a raster, i.e. invert the transform of `convert()`, with rounding and saturation.
+ *
+ * \code
+ * auto raw = quantize<std::int16_t>(physical, bscale, bzero);
+ * \endcode
+ *
+ * @see `quantize_n()`
+ */
+template <typename T, typename U, Index N, typename THolder>
+Raster<T, N> quantize(const Raster<U, N, THolder>& in, double scale = 1, double zero = 0)
+{
+  Raster<T, N> out(in.shape());
+  quantize_n(in.data(), in.size(), out.data(), scale, zero);
+  return out;
+}
+
 } // namespace Linx
 
 #include "Linx/Data/Patch.h"
 #include "Linx/Data/impl/Raster.hpp"
 
+#ifdef LINX_PRECOMPILED
+namespace Linx {
+#define LINX_EXTERN_RASTER(T, N) extern template class Raster<T, N>;
+LINX_PRECOMPILED_RASTERS(LINX_EXTERN_RASTER)
+#undef LINX_EXTERN_RASTER
+} // namespace Linx
+#endif
+
 #endif
@@ -0,0 +1,424 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_RUNLIST_H
+#define _LINXDATA_RUNLIST_H
+
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Sequence.h"
+
+#include <algorithm> // copy_n, max, min, sort, unique
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief A sparse region made of runs of contiguous positions along axis 0.
+ *
+ * This is the compiled form of a list of positions, e.g. of detected sources or bad pixels:
+ * positions are sorted in the order of the raster indices, duplicates are removed,
+ * and consecutive positions along axis 0 are merged into runs.
+ *
+ * As opposed to a `Sequence` of positions, which is visited in the given order, one index computation per position,
+ * patches of a run list are iterated run by run, contiguously, and in increasing memory order.
+ * Moreover, values can be gathered from and scattered to a raster in parallel:
+ *
+ * \code
+ * const RunList<2> bad_pixels(positions);
+ * auto values = gather(par, raster, bad_pixels);
+ * values *= gain;
+ * scatter(par, values, bad_pixels, raster);
+ * raster(bad_pixels).fill(0);
+ * \endcode
+ */
+template <Index N = 2>
+class RunList : boost::additive<RunList<N>, Position<N>> {
+public:
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief A position iterator.
+   * @see `Box::Iterator`
+   */
+  class Iterator;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Empty run list constructor.
+   */
+  RunList() : m_fronts(), m_offsets(1, 0), m_box() {}
+
+  /**
+   * @brief Compile a range of positions.
+   */
+  template <typename TRange, typename std::enable_if_t<IsRange<TRange>::value>* = nullptr>
+  explicit RunList(const TRange& positions) : RunList()
+  {
+    std::vector<Position<N>> sorted(positions.begin(), positions.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+      for (auto i = lhs.size(); i-- > 0;) { // Last axis first, as for raster indices
+        if (lhs[i] != rhs[i]) {
+          return lhs[i] < rhs[i];
+        }
+      }
+      return false;
+    });
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    for (const auto& p : sorted) {
+      if (not m_fronts.empty() && extends(p)) {
+        ++m_offsets.back();
+      } else {
+        m_fronts.push_back(p);
+        m_offsets.push_back(m_offsets.back() + 1);
+      }
+    }
+    update_box();
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of positions.
+   */
+  Index size() const
+  {
+    return m_offsets.back();
+  }
+
+  /**
+   * @brief Get the number of runs.
+   */
+  Index run_count() const
+  {
+    return static_cast<Index>(m_fronts.size());
+  }
+
+  /**
+   * @brief Get the bounding box.
+   */
+  const Box<N>& box() const
+  {
+    return m_box;
+  }
+
+  /**
+   * @brief Get the first position of each run.
+   */
+  const std::vector<Position<N>>& fronts() const
+  {
+    return m_fronts;
+  }
+
+  /**
+   * @brief Get the index of the first position of each run in the list, followed by the size.
+   *
+   * The length of run `i` is `offsets()[i + 1] - offsets()[i]`.
+   */
+  const std::vector<Index>& offsets() const
+  {
+    return m_offsets;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  Iterator begin() const
+  {
+    return Iterator(*this, 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  Iterator end() const
+  {
+    return Iterator(*this, run_count());
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Check whether two run lists are equal.
+   */
+  bool operator==(const RunList<N>& other) const
+  {
+    return m_fronts == other.m_fronts && m_offsets == other.m_offsets;
+  }
+
+  /**
+   * @brief Check whether two run lists are different.
+   */
+  bool operator!=(const RunList<N>& other) const
+  {
+    return not(*this == other);
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Append a run.
+   * @param front The position of the first element of the run
+   * @param length The run length, strictly positive
+   *
+   * The run must follow the last run in memory order, without overlap, such that no sorting is needed.
+   * It is merged with the last run if they are contiguous.
+   */
+  void append(const Position<N>& front, Index length)
+  {
+    auto back = front;
+    back[0] += length - 1;
+    if (m_fronts.empty()) {
+      m_box = Box<N>(front, back);
+    } else {
+      m_box |= Box<N>(front, back);
+    }
+    if (not m_fronts.empty() && extends(front)) {
+      m_offsets.back() += length;
+      return;
+    }
+    m_fronts.push_back(front);
+    m_offsets.push_back(m_offsets.back() + length);
+  }
+
+  /**
+   * @brief Translate the run list by a given vector.
+   */
+  RunList<N>& operator+=(const Position<N>& vector)
+  {
+    for (auto& f : m_fronts) {
+      f += vector;
+    }
+    m_box += vector;
+    return *this;
+  }
+
+  /**
+   * @brief Translate the run list by the opposite of a given vector.
+   */
+  RunList<N>& operator-=(const Position<N>& vector)
+  {
+    for (auto& f : m_fronts) {
+      f -= vector;
+    }
+    m_box -= vector;
+    return *this;
+  }
+
+  /**
+   * @brief Clamp the run list inside a box.
+   */
+  RunList<N>& operator&=(const Box<N>& box)
+  {
+    std::vector<Position<N>> fronts;
+    std::vector<Index> offsets(1, 0);
+    for (std::size_t i = 0; i < m_fronts.size(); ++i) {
+      auto f = m_fronts[i];
+      const auto x_front = std::max(f[0], box.front()[0]);
+      const auto x_back = std::min(f[0] + m_offsets[i + 1] - m_offsets[i] - 1, box.back()[0]);
+      f[0] = box.front()[0];
+      if (x_front > x_back || not box.contains(f)) {
+        continue;
+      }
+      f[0] = x_front;
+      fronts.push_back(f);
+      offsets.push_back(offsets.back() + x_back - x_front + 1);
+    }
+    m_fronts = LINX_MOVE(fronts);
+    m_offsets = LINX_MOVE(offsets);
+    update_box();
+    return *this;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Check whether a position extends the last run.
+   */
+  bool extends(const Position<N>& position) const
+  {
+    const auto& front = m_fronts.back();
+    if (position[0] != front[0] + m_offsets.back() - m_offsets[m_offsets.size() - 2]) {
+      return false;
+    }
+    for (std::size_t i = 1; i < position.size(); ++i) {
+      if (position[i] != front[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Compute the bounding box.
+   */
+  void update_box()
+  {
+    if (m_fronts.empty()) {
+      m_box = Box<N>();
+      return;
+    }
+    auto front = m_fronts[0];
+    auto back = m_fronts[0];
+    for (std::size_t r = 0; r < m_fronts.size(); ++r) {
+      const auto& f = m_fronts[r];
+      for (std::size_t i = 0; i < f.size(); ++i) {
+        front[i] = std::min(front[i], f[i]);
+        back[i] = std::max(back[i], f[i]);
+      }
+      back[0] = std::max(back[0], f[0] + m_offsets[r + 1] - m_offsets[r] - 1);
+    }
+    m_box = Box<N>(LINX_MOVE(front), LINX_MOVE(back));
+  }
+
+  /**
+   * @brief The first position of each run.
+   */
+  std::vector<Position<N>> m_fronts;
+
+  /**
+   * @brief The index of the first position of each run, followed by the size.
+   */
+  std::vector<Index> m_offsets;
+
+  /**
+   * @brief The bounding box.
+   */
+  Box<N> m_box;
+};
+
+/**
+ * @relatesalso RunList
+ * @brief Get the bounding box of a run list.
+ */
+template <Index N>
+inline const Box<N>& box(const RunList<N>& region)
+{
+  return region.box();
+}
+
+/**
+ * @relatesalso RunList
+ * @brief Clamp a run list inside a box.
+ */
+template <Index N>
+inline RunList<N> operator&(RunList<N> region, const Box<N>& bounds)
+{
+  region &= bounds;
+  return region;
+}
+
+/**
+ * @relatesalso RunList
+ * @brief Call a function on each run of a run list.
+ * @param region The run list
+ * @param func The function, which takes the position of the first element of the run and the run length
+ *
+ * @see `for_each_run(const Mask&, TFunc&&)`
+ */
+template <Index N, typename TFunc>
+void for_each_run(const RunList<N>& region, TFunc&& func)
+{
+  const auto& fronts = region.fronts();
+  const auto& offsets = region.offsets();
+  for (std::size_t i = 0; i < fronts.size(); ++i) {
+    func(fronts[i], offsets[i + 1] - offsets[i]);
+  }
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Call `func(front, length, offset)` on each run of a run list, with runs split into chunks per thread.
+ */
+template <Index N, typename TFunc>
+void parallel_runs(const ParallelPolicy& policy, const RunList<N>& region, TFunc&& func)
+{
+  const auto& fronts = region.fronts();
+  const auto& offsets = region.offsets();
+  parallel_chunks(policy.thread_count(), region.run_count(), [&](Index front, Index back) {
+    for (Index i = front; i < back; ++i) {
+      func(fronts[i], offsets[i + 1] - offsets[i], offsets[i]);
+    }
+  });
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso RunList
+ * @brief Copy the values of a raster at the positions of a run list into a sequence.
+ * @param policy The parallel policy
+ * @param in The raster
+ * @param region The run list
+ *
+ * Values are ordered as the positions of the run list.
+ */
+template <typename TRaster, Index N>
+Sequence<std::decay_t<typename TRaster::Value>>
+gather(const ParallelPolicy& policy, const TRaster& in, const RunList<N>& region)
+{
+  Sequence<std::decay_t<typename TRaster::Value>> out(region.size());
+  auto* data = out.data();
+  Internal::parallel_runs(policy, region, [&](const auto& front, Index length, Index offset) {
+    std::copy_n(&in[front], length, data + offset);
+  });
+  return out;
+}
+
+/**
+ * @relatesalso RunList
+ * @brief Copy the values of a raster at the positions of a run list into a sequence, sequentially.
+ */
+template <typename TRaster, Index N>
+Sequence<std::decay_t<typename TRaster::Value>> gather(const TRaster& in, const RunList<N>& region)
+{
+  return gather(par(1), in, region);
+}
+
+/**
+ * @relatesalso RunList
+ * @brief Copy values into a raster at the positions of a run list.
+ * @param policy The parallel policy
+ * @param values The values, ordered as the positions of the run list, e.g. as returned by `gather()`
+ * @param region The run list
+ * @param out The raster
+ */
+template <typename TValues, Index N, typename TRaster>
+void scatter(const ParallelPolicy& policy, const TValues& values, const RunList<N>& region, TRaster& out)
+{
+  const auto begin = values.begin();
+  Internal::parallel_runs(policy, region, [&](const auto& front, Index length, Index offset) {
+    std::copy_n(begin + offset, length, &out[front]);
+  });
+}
+
+/**
+ * @relatesalso RunList
+ * @brief Copy values into a raster at the positions of a run list, sequentially.
+ */
+template <typename TValues, Index N, typename TRaster>
+void scatter(const TValues& values, const RunList<N>& region, TRaster& out)
+{
+  scatter(par(1), values, region, out);
+}
+
+} // namespace Linx
+
+#include "Linx/Data/impl/RunListIterator.h"
+
+#endif
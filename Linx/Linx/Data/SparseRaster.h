@@ -0,0 +1,478 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_SPARSERASTER_H
+#define _LINXDATA_SPARSERASTER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/RunList.h"
+#include "Linx/Data/Sequence.h"
+
+#include <algorithm> // stable_sort, upper_bound
+#include <iterator> // distance
+#include <numeric> // iota
+#include <type_traits>
+#include <utility> // move
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief An ND raster which stores its non-zero values only.
+ *
+ * Non-zero values are stored in memory order, run by run, where runs are sequences of contiguous non-zero values
+ * along axis 0, like in compressed sparse row formats.
+ * The positions of the non-zero values are a `RunList`, given by `region()`, and the values are a `Sequence`,
+ * given by `values()`, in the same order.
+ * For maps with a low density, like detection masks or bad pixel maps,
+ * both the memory footprint and the cost of the loops are proportional to the number of non-zero values.
+ *
+ * The region can be used to index dense rasters, e.g. for masking, and dense rasters can be updated with
+ * the non-zero values only:
+ *
+ * \code
+ * const SparseRaster<float> rays(image.shape(), positions, amplitudes);
+ * image -= rays; // Non-zero values only
+ * image(rays.region()).fill(0); // Masking
+ * const auto weighted = rays * weights; // Sparse, weights are read at the non-zero positions only
+ * rays.for_each([&](const auto& p, auto v) { ... }); // Non-zero values only
+ * \endcode
+ *
+ * The set of non-zero positions is fixed at construction, and values which are later set to zero are kept.
+ */
+template <typename T, Index N = 2>
+class SparseRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor of a zero raster.
+   */
+  explicit SparseRaster(Position<N> shape = Position<N>::zero()) : m_shape(LINX_MOVE(shape)), m_region(), m_values()
+  {}
+
+  /**
+   * @brief Create a sparse raster from the non-zero values of a dense raster.
+   *
+   * Rows are scanned contiguously, without any index computation, and runs are built on the fly.
+   */
+  template <typename U, typename UHolder>
+  explicit SparseRaster(const Raster<U, N, UHolder>& in) : SparseRaster(in.shape())
+  {
+    const auto width = m_shape[0];
+    const auto rows = width > 0 ? static_cast<Index>(in.size()) / width : 0;
+    std::vector<T> values;
+    const auto* data = in.data();
+    for (Index r = 0; r < rows; ++r) {
+      const auto* row = data + r * width;
+      Index x = 0;
+      while (x < width) {
+        while (x < width && row[x] == U()) {
+          ++x;
+        }
+        const auto front = x;
+        while (x < width && row[x] != U()) {
+          values.push_back(static_cast<T>(row[x]));
+          ++x;
+        }
+        if (x > front) {
+          auto p = row_position(r);
+          p[0] = front;
+          m_region.append(p, x - front);
+        }
+      }
+    }
+    m_values = Sequence<T>(values);
+  }
+
+  /**
+   * @brief Create a sparse raster with a given value at some positions.
+   * @param shape The raster shape
+   * @param positions The range of positions, e.g. a `Sequence<Position<N>>`, in any order, possibly with duplicates
+   * @param value The value at the positions
+   */
+  template <typename TRange, typename std::enable_if_t<IsRange<TRange>::value>* = nullptr>
+  SparseRaster(Position<N> shape, const TRange& positions, T value = T(1)) : SparseRaster(LINX_MOVE(shape))
+  {
+    m_region = RunList<N>(positions);
+    check_bounds();
+    m_values = Sequence<T>(m_region.size());
+    m_values.fill(value);
+  }
+
+  /**
+   * @brief Create a sparse raster with given values at some positions.
+   * @param shape The raster shape
+   * @param positions The range of positions, in any order
+   * @param values The range of values, in the same order as the positions
+   *
+   * In case of duplicate positions, the last value is kept.
+   */
+  template <
+      typename TRange,
+      typename TValues,
+      typename std::enable_if_t<IsRange<TRange>::value && IsRange<TValues>::value>* = nullptr>
+  SparseRaster(Position<N> shape, const TRange& positions, const TValues& values) : SparseRaster(LINX_MOVE(shape))
+  {
+    std::vector<Position<N>> ps(positions.begin(), positions.end());
+    std::vector<T> vs(values.begin(), values.end());
+    SizeError::may_throw(vs.size(), ps.size());
+    std::vector<Index> indices(ps.size());
+    for (std::size_t i = 0; i < ps.size(); ++i) {
+      indices[i] = index(ps[i]);
+    }
+    std::vector<std::size_t> order(ps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+      return indices[lhs] < indices[rhs];
+    });
+    std::vector<T> sorted;
+    sorted.reserve(order.size());
+    for (std::size_t k = 0; k < order.size(); ++k) {
+      const auto i = order[k];
+      if (k + 1 < order.size() && indices[order[k + 1]] == indices[i]) {
+        continue; // Overwritten
+      }
+      m_region.append(ps[i], 1);
+      sorted.push_back(vs[i]);
+    }
+    check_bounds();
+    m_values = Sequence<T>(sorted);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(Position<N>::zero(), m_shape);
+  }
+
+  /**
+   * @brief Get the number of values, including the zeros.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the number of stored values.
+   */
+  Index count() const
+  {
+    return m_region.size();
+  }
+
+  /**
+   * @brief Get the positions of the stored values.
+   */
+  const RunList<N>& region() const
+  {
+    return m_region;
+  }
+
+  /**
+   * @brief Get the stored values, in the order of `region()`.
+   */
+  const Sequence<T>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @copydoc values()
+   */
+  Sequence<T>& values()
+  {
+    return m_values;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the value at some position.
+   *
+   * The run which contains the position is found by binary search.
+   */
+  T operator[](const Position<N>& p) const
+  {
+    const auto& fronts = m_region.fronts();
+    const auto& offsets = m_region.offsets();
+    const auto i = index(p);
+    const auto it = std::upper_bound(fronts.begin(), fronts.end(), i, [&](Index lhs, const Position<N>& rhs) {
+      return lhs < index(rhs);
+    });
+    if (it == fronts.begin()) {
+      return T();
+    }
+    const auto r = std::distance(fronts.begin(), it) - 1;
+    const auto x = i - index(fronts[r]);
+    return x < offsets[r + 1] - offsets[r] ? m_values[offsets[r] + x] : T();
+  }
+
+  /**
+   * @brief Call a function on each stored value.
+   * @param func The function, which takes the position and the value
+   */
+  template <typename TFunc>
+  void for_each(TFunc&& func) const
+  {
+    auto it = m_values.begin();
+    for (const auto& p : m_region) {
+      func(p, *it);
+      ++it;
+    }
+  }
+
+  /**
+   * @copydoc for_each()
+   */
+  template <typename TFunc>
+  void for_each(TFunc&& func)
+  {
+    auto it = m_values.begin();
+    for (const auto& p : m_region) {
+      func(p, *it);
+      ++it;
+    }
+  }
+
+  /**
+   * @brief Convert to a dense raster.
+   */
+  template <typename U = T>
+  Raster<U, N> raster() const
+  {
+    Raster<U, N> out(m_shape);
+    scatter(m_values, m_region, out);
+    return out;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Check whether two sparse rasters have the same shape, positions and values.
+   */
+  bool operator==(const SparseRaster& other) const
+  {
+    return m_shape == other.m_shape && m_region == other.m_region && m_values == other.m_values;
+  }
+
+  /**
+   * @brief Check whether two sparse rasters differ.
+   */
+  bool operator!=(const SparseRaster& other) const
+  {
+    return not(*this == other);
+  }
+
+  /**
+   * @brief Multiply the stored values by the values of a dense raster at the same positions.
+   */
+  template <typename U, typename UHolder>
+  SparseRaster& operator*=(const Raster<U, N, UHolder>& rhs)
+  {
+    check_shape(rhs.shape());
+    auto* data = m_values.data();
+    for_each_run(m_region, [&](const auto& front, Index length) {
+      const auto* r = &rhs[front];
+      for (Index x = 0; x < length; ++x, ++data) {
+        *data *= r[x];
+      }
+    });
+    return *this;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the index of some position in memory order.
+   */
+  Index index(const Position<N>& p) const
+  {
+    Index out = 0;
+    Index stride = 1;
+    for (Index i = 0; i < N; ++i) {
+      out += p[i] * stride;
+      stride *= m_shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the position of the first element of some row.
+   */
+  Position<N> row_position(Index r) const
+  {
+    Position<N> out;
+    out[0] = 0;
+    for (Index i = 1; i < N; ++i) {
+      out[i] = r % m_shape[i];
+      r /= m_shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Throw if the region is not included in the domain.
+   */
+  void check_bounds() const
+  {
+    if (m_region.size() == 0) {
+      return;
+    }
+    const auto& box = m_region.box();
+    for (Index i = 0; i < N; ++i) {
+      OutOfBoundsError::may_throw("Sparse raster position", box.front()[i], {0, m_shape[i] - 1});
+      OutOfBoundsError::may_throw("Sparse raster position", box.back()[i], {0, m_shape[i] - 1});
+    }
+  }
+
+  /**
+   * @brief Throw if a dense raster shape differs.
+   */
+  void check_shape(const Position<N>& shape) const
+  {
+    for (Index i = 0; i < N; ++i) {
+      SizeError::may_throw(shape[i], m_shape[i]);
+    }
+  }
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The positions of the stored values.
+   */
+  RunList<N> m_region;
+
+  /**
+   * @brief The stored values.
+   */
+  Sequence<T> m_values;
+};
+
+/**
+ * @relatesalso SparseRaster
+ * @brief Add the stored values of a sparse raster to a dense raster.
+ *
+ * Only the stored values are visited.
+ */
+template <typename T, Index N, typename THolder, typename U>
+Raster<T, N, THolder>& operator+=(Raster<T, N, THolder>& lhs, const SparseRaster<U, N>& rhs)
+{
+  for (Index i = 0; i < N; ++i) {
+    SizeError::may_throw(rhs.shape()[i], lhs.shape()[i]);
+  }
+  Internal::parallel_runs(par(1), rhs.region(), [&](const auto& front, Index length, Index offset) {
+    auto* l = &lhs[front];
+    const auto* r = rhs.values().data() + offset;
+    for (Index x = 0; x < length; ++x) {
+      l[x] += r[x];
+    }
+  });
+  return lhs;
+}
+
+/**
+ * @relatesalso SparseRaster
+ * @brief Subtract the stored values of a sparse raster from a dense raster.
+ *
+ * Only the stored values are visited.
+ */
+template <typename T, Index N, typename THolder, typename U>
+Raster<T, N, THolder>& operator-=(Raster<T, N, THolder>& lhs, const SparseRaster<U, N>& rhs)
+{
+  for (Index i = 0; i < N; ++i) {
+    SizeError::may_throw(rhs.shape()[i], lhs.shape()[i]);
+  }
+  Internal::parallel_runs(par(1), rhs.region(), [&](const auto& front, Index length, Index offset) {
+    auto* l = &lhs[front];
+    const auto* r = rhs.values().data() + offset;
+    for (Index x = 0; x < length; ++x) {
+      l[x] -= r[x];
+    }
+  });
+  return lhs;
+}
+
+/**
+ * @relatesalso SparseRaster
+ * @brief Add a sparse raster to a dense raster.
+ */
+template <typename T, Index N, typename THolder, typename U>
+Raster<T, N, THolder> operator+(Raster<T, N, THolder> lhs, const SparseRaster<U, N>& rhs)
+{
+  lhs += rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso SparseRaster
+ * @brief Subtract a sparse raster from a dense raster.
+ */
+template <typename T, Index N, typename THolder, typename U>
+Raster<T, N, THolder> operator-(Raster<T, N, THolder> lhs, const SparseRaster<U, N>& rhs)
+{
+  lhs -= rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso SparseRaster
+ * @brief Multiply a sparse raster by a dense raster, which yields a sparse raster.
+ *
+ * The dense raster is only read at the stored positions, such that this is also a masking operation.
+ */
+template <typename T, Index N, typename U, typename UHolder>
+SparseRaster<T, N> operator*(SparseRaster<T, N> lhs, const Raster<U, N, UHolder>& rhs)
+{
+  lhs *= rhs;
+  return lhs;
+}
+
+/**
+ * @relatesalso SparseRaster
+ * @copydoc operator*(SparseRaster<T, N>, const Raster<U, N, UHolder>&)
+ */
+template <typename T, Index N, typename U, typename UHolder>
+SparseRaster<T, N> operator*(const Raster<U, N, UHolder>& lhs, SparseRaster<T, N> rhs)
+{
+  rhs *= lhs;
+  return rhs;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,342 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_SPLITRASTER_H
+#define _LINXDATA_SPLITRASTER_H
+
+#include "Linx/Data/Raster.h"
+
+#include <cmath> // atan2, sqrt
+#include <complex>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Split interleaved complex values into real and imaginary planes.
+ */
+template <typename T>
+void deinterleave(const std::complex<T>* in, Index size, T* re, T* im)
+{
+  const auto* values = reinterpret_cast<const T*>(in);
+  for (Index i = 0; i < size; ++i) {
+    re[i] = values[2 * i];
+    im[i] = values[2 * i + 1];
+  }
+}
+
+/**
+ * @brief Interleave real and imaginary planes into complex values.
+ */
+template <typename T>
+void interleave(const T* re, const T* im, Index size, std::complex<T>* out)
+{
+  auto* values = reinterpret_cast<T*>(out);
+  for (Index i = 0; i < size; ++i) {
+    values[2 * i] = re[i];
+    values[2 * i + 1] = im[i];
+  }
+}
+
+/**
+ * @brief Multiply interleaved complex values in place, e.g. spectra.
+ *
+ * As opposed to `std::complex::operator*=()`, infinite and NaN values are not handled specifically,
+ * which makes the loop branchless and vectorizable.
+ */
+template <typename T>
+void complex_multiply(std::complex<T>* lhs, const std::complex<T>* rhs, Index size)
+{
+  auto* l = reinterpret_cast<T*>(lhs);
+  const auto* r = reinterpret_cast<const T*>(rhs);
+  for (Index i = 0; i < 2 * size; i += 2) {
+    const auto re = l[i] * r[i] - l[i + 1] * r[i + 1];
+    const auto im = l[i] * r[i + 1] + l[i + 1] * r[i];
+    l[i] = re;
+    l[i + 1] = im;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief A complex raster stored as two real planes, i.e. in structure-of-arrays layout.
+ * @tparam T The real value type
+ * @tparam N The dimension
+ *
+ * As opposed to `Raster<std::complex<T>, N>`, where real and imaginary parts are interleaved,
+ * the real parts and imaginary parts are stored in two separate rasters, which are accessed with `real()` and `imag()`.
+ * This way, element-wise operations, like complex multiplications or moduli, operate on contiguous real values,
+ * and are easily vectorized.
+ *
+ * Conversions to and from interleaved buffers, like FFTW's, are provided by `deinterleave()` and `interleave()`:
+ * \code
+ * SplitRaster<double, 2> acc(dft.out_shape());
+ * for (const auto& image : images) {
+ *   // ...
+ *   dft.transform();
+ *   spectrum.deinterleave(dft.out());
+ *   acc.multiply_add(spectrum, kernel); // acc += spectrum * kernel
+ * }
+ * acc.interleave(idft.in());
+ * \endcode
+ */
+template <typename T, Index N = 2>
+class SplitRaster {
+public:
+
+  /**
+   * @brief The real value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit SplitRaster(const Position<N>& shape = Position<N>::zero()) : m_real(shape), m_imag(shape) {}
+
+  /**
+   * @brief Split an interleaved complex raster.
+   */
+  template <typename THolder>
+  explicit SplitRaster(const Raster<std::complex<T>, N, THolder>& in) : SplitRaster(in.shape())
+  {
+    deinterleave(in);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_real.shape();
+  }
+
+  /**
+   * @brief Get the number of complex values.
+   */
+  Index size() const
+  {
+    return m_real.size();
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the plane of the real parts.
+   */
+  const Raster<T, N>& real() const
+  {
+    return m_real;
+  }
+
+  /**
+   * @copydoc real()
+   */
+  Raster<T, N>& real()
+  {
+    return m_real;
+  }
+
+  /**
+   * @brief Get the plane of the imaginary parts.
+   */
+  const Raster<T, N>& imag() const
+  {
+    return m_imag;
+  }
+
+  /**
+   * @copydoc imag()
+   */
+  Raster<T, N>& imag()
+  {
+    return m_imag;
+  }
+
+  /**
+   * @brief Get the complex value at some position.
+   */
+  std::complex<T> operator[](const Position<N>& p) const
+  {
+    return {m_real[p], m_imag[p]};
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Copy values from an interleaved complex raster of the same shape.
+   */
+  template <typename THolder>
+  SplitRaster& deinterleave(const Raster<std::complex<T>, N, THolder>& in)
+  {
+    SizeError::may_throw(in.size(), size());
+    Internal::deinterleave(in.data(), size(), m_real.data(), m_imag.data());
+    return *this;
+  }
+
+  /**
+   * @brief Copy values to an interleaved complex raster of the same shape.
+   */
+  template <typename THolder>
+  const SplitRaster& interleave(Raster<std::complex<T>, N, THolder>& out) const
+  {
+    SizeError::may_throw(out.size(), size());
+    Internal::interleave(m_real.data(), m_imag.data(), size(), out.data());
+    return *this;
+  }
+
+  /**
+   * @brief Multiply values element-wise by those of another split raster.
+   */
+  SplitRaster& operator*=(const SplitRaster& rhs)
+  {
+    SizeError::may_throw(rhs.size(), size());
+    auto* re = m_real.data();
+    auto* im = m_imag.data();
+    const auto* rhs_re = rhs.m_real.data();
+    const auto* rhs_im = rhs.m_imag.data();
+    const auto s = size();
+    for (Index i = 0; i < s; ++i) {
+      const auto r = re[i] * rhs_re[i] - im[i] * rhs_im[i];
+      im[i] = re[i] * rhs_im[i] + im[i] * rhs_re[i];
+      re[i] = r;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Add the element-wise product of two split rasters, i.e. `this += lhs * rhs`.
+   * @param lhs The left-hand side operand
+   * @param rhs The right-hand side operand
+   * @param conjugate If true, add `lhs * conj(rhs)` instead, e.g. for cross-correlations
+   *
+   * This is the typical accumulation of spectrum products, e.g. when summing filtered images in Fourier domain.
+   */
+  SplitRaster& multiply_add(const SplitRaster& lhs, const SplitRaster& rhs, bool conjugate = false)
+  {
+    SizeError::may_throw(lhs.size(), size());
+    SizeError::may_throw(rhs.size(), size());
+    auto* re = m_real.data();
+    auto* im = m_imag.data();
+    const auto* a = lhs.m_real.data();
+    const auto* b = lhs.m_imag.data();
+    const auto* c = rhs.m_real.data();
+    const auto* d = rhs.m_imag.data();
+    const T sign = conjugate ? -1 : 1;
+    const auto s = size();
+    for (Index i = 0; i < s; ++i) {
+      re[i] += a[i] * c[i] - sign * b[i] * d[i];
+      im[i] += sign * a[i] * d[i] + b[i] * c[i];
+    }
+    return *this;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The real parts.
+   */
+  Raster<T, N> m_real;
+
+  /**
+   * @brief The imaginary parts.
+   */
+  Raster<T, N> m_imag;
+};
+
+/**
+ * @relatesalso SplitRaster
+ * @brief Get the real parts.
+ */
+template <typename T, Index N>
+Raster<T, N> real(const SplitRaster<T, N>& in)
+{
+  return in.real();
+}
+
+/**
+ * @relatesalso SplitRaster
+ * @brief Get the imaginary parts.
+ */
+template <typename T, Index N>
+Raster<T, N> imag(const SplitRaster<T, N>& in)
+{
+  return in.imag();
+}
+
+/**
+ * @relatesalso SplitRaster
+ * @brief Compute the squared moduli, like `std::norm()`.
+ */
+template <typename T, Index N>
+Raster<T, N> norm(const SplitRaster<T, N>& in)
+{
+  Raster<T, N> out(in.shape());
+  const auto* re = in.real().data();
+  const auto* im = in.imag().data();
+  auto* o = out.data();
+  const auto size = static_cast<Index>(out.size());
+  for (Index i = 0; i < size; ++i) {
+    o[i] = re[i] * re[i] + im[i] * im[i];
+  }
+  return out;
+}
+
+/**
+ * @relatesalso SplitRaster
+ * @brief Compute the moduli, like `std::abs()`.
+ *
+ * As opposed to `std::abs()`, intermediate overflows are not prevented,
+ * which makes the loop vectorizable.
+ */
+template <typename T, Index N>
+Raster<T, N> abs(const SplitRaster<T, N>& in)
+{
+  auto out = norm(in);
+  auto* o = out.data();
+  const auto size = static_cast<Index>(out.size());
+  for (Index i = 0; i < size; ++i) {
+    o[i] = std::sqrt(o[i]);
+  }
+  return out;
+}
+
+/**
+ * @relatesalso SplitRaster
+ * @brief Compute the arguments, like `std::arg()`.
+ */
+template <typename T, Index N>
+Raster<T, N> arg(const SplitRaster<T, N>& in)
+{
+  Raster<T, N> out(in.shape());
+  const auto* re = in.real().data();
+  const auto* im = in.imag().data();
+  auto* o = out.data();
+  const auto size = static_cast<Index>(out.size());
+  for (Index i = 0; i < size; ++i) {
+    o[i] = std::atan2(im[i], re[i]);
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,427 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_STRIDEDRASTER_H
+#define _LINXDATA_STRIDEDRASTER_H
+
+#include "Linx/Base/Dimension.h"
+#include "Linx/Base/mixins/Arithmetic.h"
+#include "Linx/Base/mixins/Math.h"
+#include "Linx/Base/mixins/Range.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Grid.h"
+#include "Linx/Data/Raster.h"
+
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief A view of non-contiguous raster data, with arbitrary strides along each axis.
+ * @tparam T The value type, which is const for read-only views
+ * @tparam N The dimension
+ *
+ * As opposed to `PtrRaster`, the elements need not be contiguous:
+ * the element at position `p` is at index `sum(p[i] * strides()[i])` of the data.
+ * This allows viewing sub-boxes, decimated grids and axis permutations of a raster as rasters, without copy:
+ *
+ * \code
+ * Raster<float, 3> cube({width, height, depth});
+ * auto view = strided(cube);
+ * auto inner = view(Box<3>({1, 1, 1}, {width - 2, height - 2, depth - 2})); // Sub-box
+ * auto even = view(Grid<3>(cube.domain(), {2, 2, 2})); // Every other pixel
+ * auto transposed = view.permute({2, 1, 0}); // Axis permutation
+ * transposed += 1; // Modifies cube
+ * \endcode
+ *
+ * Like other views, strided rasters are cheap to copy, and copies share the same data.
+ * The element-wise operations of rasters are available,
+ * and iteration is written row by row, with a constant step along axis 0.
+ * Therefore, the stride along axis 0 must be positive;
+ * other strides can be of any sign (e.g. to flip an axis) but not null.
+ *
+ * Strided rasters are domain-based: their domain always starts at the origin,
+ * as opposed to the region of a patch.
+ * Filters are applied through a contiguous copy, see `FilterMixin::operator*()`.
+ */
+template <typename T, Index N = 2>
+class StridedRaster :
+    public Dimensional<N>,
+    public ArithmeticMixin<EuclidArithmetic, T, StridedRaster<T, N>>,
+    public MathFunctionsMixin<T, StridedRaster<T, N>>,
+    public RangeMixin<T, StridedRaster<T, N>> {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The iterator type.
+   * @tparam U The value type, can be `T` or `const T`
+   */
+  template <typename U>
+  using Iterator = StridedIterator<U, N>;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The shape
+   * @param data The address of the element at the origin
+   * @param strides The distance between two consecutive elements along each axis, in number of elements
+   */
+  StridedRaster(Position<N> shape, T* data, Position<N> strides) :
+      m_shape(LINX_MOVE(shape)), m_data(data), m_strides(LINX_MOVE(strides))
+  {}
+
+  /**
+   * @brief Contiguous raster constructor.
+   */
+  template <typename U, typename UHolder>
+  explicit StridedRaster(Raster<U, N, UHolder>& raster) :
+      StridedRaster(raster.shape(), raster.data(), contiguous_strides(raster.shape()))
+  {}
+
+  /**
+   * @copydoc StridedRaster(Raster<U, N, UHolder>&)
+   */
+  template <typename U, typename UHolder>
+  explicit StridedRaster(const Raster<U, N, UHolder>& raster) :
+      StridedRaster(raster.shape(), raster.data(), contiguous_strides(raster.shape()))
+  {}
+
+  /**
+   * @brief Read-only view constructor.
+   */
+  template <typename U, typename std::enable_if_t<std::is_same_v<const U, T>>* = nullptr>
+  StridedRaster(const StridedRaster<U, N>& other) : StridedRaster(other.shape(), other.data(), other.strides())
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(Position<N>::zero(m_shape.size()), m_shape);
+  }
+
+  /**
+   * @brief Get the bounding box, i.e. the domain.
+   */
+  Box<N> box() const
+  {
+    return domain();
+  }
+
+  /**
+   * @brief Get the number of elements.
+   */
+  std::size_t size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the length along a given axis.
+   */
+  Index length(Index i) const
+  {
+    return m_shape[i];
+  }
+
+  /**
+   * @brief Get the strides, in number of elements.
+   */
+  const Position<N>& strides() const
+  {
+    return m_strides;
+  }
+
+  /**
+   * @brief Check whether the elements are contiguous and ordered as in a raster of the same shape.
+   */
+  bool is_contiguous() const
+  {
+    return m_strides == contiguous_strides(m_shape);
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the address of the element at the origin.
+   */
+  T* data() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Compute the index of a given position.
+   */
+  Index index(const Position<N>& position) const
+  {
+    Index out = 0;
+    for (std::size_t i = 0; i < m_strides.size(); ++i) {
+      out += position[i] * m_strides[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Access the element at given position.
+   */
+  const T& operator[](const Position<N>& position) const
+  {
+    return m_data[index(position)];
+  }
+
+  /**
+   * @copybrief operator[]()const
+   */
+  T& operator[](const Position<N>& position)
+  {
+    return m_data[index(position)];
+  }
+
+  /**
+   * @brief Constant iterator to the first element.
+   */
+  Iterator<const T> begin() const
+  {
+    return Iterator<const T>(m_data, step(), width(), 0, m_shape, m_strides);
+  }
+
+  /**
+   * @brief Iterator to the first element.
+   */
+  Iterator<T> begin()
+  {
+    return Iterator<T>(m_data, step(), width(), 0, m_shape, m_strides);
+  }
+
+  /**
+   * @brief Constant end iterator.
+   */
+  Iterator<const T> end() const
+  {
+    return Iterator<const T>(m_data, step(), width(), row_count(), m_shape, m_strides);
+  }
+
+  /**
+   * @brief End iterator.
+   */
+  Iterator<T> end()
+  {
+    return Iterator<T>(m_data, step(), width(), row_count(), m_shape, m_strides);
+  }
+
+  /**
+   * @brief Call a function on each row.
+   * @param func The function, which takes a pointer to the first element of the row, the row length and the step
+   *
+   * The elements of a row are `row[0]`, `row[step]`... `row[(length - 1) * step]`,
+   * such that the innermost loop can be specialized for `step == 1`:
+   *
+   * \code
+   * view.for_each_row([](auto* row, Index length, Index step) {
+   *   for (Index i = 0; i < length * step; i += step) {
+   *     row[i] *= 2;
+   *   }
+   * });
+   * \endcode
+   */
+  template <typename TFunc>
+  void for_each_row(TFunc&& func) const
+  {
+    const auto stride = step();
+    Linx::for_each_row(domain(), [&](const auto& front, Index length) {
+      func(m_data + index(front), length, stride);
+    });
+  }
+
+  /// @group_views
+
+  /**
+   * @brief Get a view of a sub-box.
+   */
+  StridedRaster<const T, N> operator()(const Box<N>& box) const
+  {
+    return {box.shape(), m_data + index(box.front()), m_strides};
+  }
+
+  /**
+   * @copybrief operator()(const Box<N>&)const
+   */
+  StridedRaster operator()(const Box<N>& box)
+  {
+    return {box.shape(), m_data + index(box.front()), m_strides};
+  }
+
+  /**
+   * @brief Get a view of the nodes of a grid.
+   */
+  StridedRaster<const T, N> operator()(const Grid<N>& grid) const
+  {
+    return {grid.shape(), m_data + index(grid.front()), grid_strides(grid)};
+  }
+
+  /**
+   * @copybrief operator()(const Grid<N>&)const
+   */
+  StridedRaster operator()(const Grid<N>& grid)
+  {
+    return {grid.shape(), m_data + index(grid.front()), grid_strides(grid)};
+  }
+
+  /**
+   * @brief Get a patch of any other region.
+   */
+  template <
+      typename TRegion,
+      typename std::enable_if_t<
+          not std::is_same_v<std::decay_t<TRegion>, Box<N>> &&
+          not std::is_same_v<std::decay_t<TRegion>, Grid<N>>>* = nullptr>
+  Patch<const T, const StridedRaster, std::decay_t<TRegion>> operator()(TRegion&& region) const
+  {
+    return Patch<const T, const StridedRaster, std::decay_t<TRegion>>(*this, LINX_FORWARD(region));
+  }
+
+  /**
+   * @copybrief operator()(TRegion&&)const
+   */
+  template <
+      typename TRegion,
+      typename std::enable_if_t<
+          not std::is_same_v<std::decay_t<TRegion>, Box<N>> &&
+          not std::is_same_v<std::decay_t<TRegion>, Grid<N>>>* = nullptr>
+  Patch<T, StridedRaster, std::decay_t<TRegion>> operator()(TRegion&& region)
+  {
+    return Patch<T, StridedRaster, std::decay_t<TRegion>>(*this, LINX_FORWARD(region));
+  }
+
+  /**
+   * @brief Get a view with permuted axes.
+   * @param axes The axes of the view, such that axis `i` of the view is axis `axes[i]` of this raster
+   *
+   * For example, in 2D, `permute({1, 0})` is the transposed view.
+   */
+  StridedRaster permute(const Position<N>& axes) const
+  {
+    auto shape = m_shape;
+    auto strides = m_strides;
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+      shape[i] = m_shape[axes[i]];
+      strides[i] = m_strides[axes[i]];
+    }
+    return {LINX_MOVE(shape), m_data, LINX_MOVE(strides)};
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Compute the strides of a contiguous raster.
+   */
+  static Position<N> contiguous_strides(const Position<N>& shape)
+  {
+    auto out = shape;
+    Index stride = 1;
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+      out[i] = stride;
+      stride *= shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the strides of the nodes of a grid.
+   */
+  Position<N> grid_strides(const Grid<N>& grid) const
+  {
+    auto out = m_strides;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      out[i] *= grid.step()[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the step along axis 0.
+   */
+  Index step() const
+  {
+    return m_strides.size() > 0 ? m_strides[0] : 1;
+  }
+
+  /**
+   * @brief Get the distance between the first and past-the-last elements of a row.
+   */
+  Index width() const
+  {
+    return m_shape.size() > 0 ? step() * (m_shape[0] - 1) + 1 : 1;
+  }
+
+  /**
+   * @brief Get the number of rows.
+   */
+  Index row_count() const
+  {
+    const auto s = static_cast<Index>(size());
+    return s > 0 ? s / (m_shape.size() > 0 ? m_shape[0] : 1) : 0;
+  }
+
+  /**
+   * @brief The shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The address of the element at the origin.
+   */
+  T* m_data;
+
+  /**
+   * @brief The strides.
+   */
+  Position<N> m_strides;
+};
+
+/**
+ * @relatesalso StridedRaster
+ * @brief Get a strided view of a raster.
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<T, N> strided(Raster<T, N, THolder>& in)
+{
+  return StridedRaster<T, N>(in);
+}
+
+/**
+ * @relatesalso StridedRaster
+ * @brief Get a read-only strided view of a raster.
+ */
+template <typename T, Index N, typename THolder>
+StridedRaster<const T, N> strided(const Raster<T, N, THolder>& in)
+{
+  return StridedRaster<const T, N>(in);
+}
+
+} // namespace Linx
+
+#endif
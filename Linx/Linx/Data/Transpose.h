@@ -0,0 +1,317 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_TRANSPOSE_H
+#define _LINXDATA_TRANSPOSE_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Holders.h" // SizeError
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/StridedRaster.h"
+
+#include <algorithm> // copy_n, min, swap
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The tile length of blocked transpositions.
+ *
+ * Two tiles of 4-byte values (4 kB each) fit in the L1 cache.
+ */
+constexpr Index TransposeTile = 32;
+
+/**
+ * @brief Compute the position of a given index in a shape, with axes ordered from the fastest to the slowest.
+ */
+template <Index N>
+Position<N> shape_position(const Position<N>& shape, const Position<N>& order, Index index)
+{
+  auto out = shape;
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const auto a = order[i];
+    out[a] = index % shape[a];
+    index /= shape[a];
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup data_classes
+ * @brief Copy a raster with permuted axes.
+ * @param policy The parallel policy
+ * @param in The input raster
+ * @param axes The axes of the output, such that axis `i` of the output is axis `axes[i]` of the input
+ * @param out The output raster, of shape `strided(in).permute(axes).shape()`
+ *
+ * This is the contiguous counterpart of `StridedRaster::permute()`, e.g. to run along-axis filters along a slow axis:
+ *
+ * \code
+ * auto zyx = transpose(par, cube, {2, 1, 0});
+ * zyx = convolution_along<float, 0>(kernel) * extrapolation(zyx);
+ * cube = transpose(par, zyx, {2, 1, 0});
+ * \endcode
+ *
+ * When axis 0 is kept, rows are copied as is.
+ * Otherwise, the output is written by square tiles of the planes spanned by output axis 0
+ * and the output axis which is input axis 0, such that both reads and writes stay in cache.
+ * Consecutive tiles are taken along the other axes, and distributed over the threads.
+ */
+template <typename T, Index N, typename THolder, typename U, typename UHolder>
+Raster<U, N, UHolder>& transpose(
+    const ParallelPolicy& policy,
+    const Raster<T, N, THolder>& in,
+    const Position<N>& axes,
+    Raster<U, N, UHolder>& out)
+{
+  const auto view = strided(in).permute(axes);
+  const auto& shape = view.shape();
+  const auto& strides = view.strides();
+  for (std::size_t i = 0; i < shape.size(); ++i) {
+    SizeError::may_throw(out.length(i), shape[i]);
+  }
+  if (out.size() == 0) {
+    return out;
+  }
+
+  const auto dimension = static_cast<Index>(shape.size());
+  Index b = 0; // Output axis which is input axis 0
+  while (b < dimension && axes[b] != 0) {
+    ++b;
+  }
+  auto outer = shape; // Shape of the tile grid, tiles spanning along axes 0 and b
+  const auto width = shape[0];
+  const auto height = b > 0 ? shape[b] : 1;
+  outer[0] = b > 0 ? (width + Internal::TransposeTile - 1) / Internal::TransposeTile : 1;
+  if (b > 0) {
+    outer[b] = (height + Internal::TransposeTile - 1) / Internal::TransposeTile;
+  }
+  auto order = axes; // Tiles of the same planes are consecutive, such that they share memory pages
+  Index k = 0;
+  for (Index i = 1; i < dimension; ++i) {
+    if (i != b) {
+      order[k++] = i;
+    }
+  }
+  order[k++] = 0;
+  if (b > 0) {
+    order[k] = b;
+  }
+  const auto out_stride = b > 0 ? shape_stride(shape, b) : 0;
+  const auto in_stride = strides[0];
+  const auto* in_data = view.data();
+  auto* out_data = out.data();
+
+  Internal::parallel_chunks(policy.thread_count(), shape_size(outer), [&](Index front, Index back) {
+    for (Index t = front; t < back; ++t) {
+      auto p = Internal::shape_position(outer, order, t);
+      if (b == 0) {
+        std::copy_n(in_data + view.index(p), width, out_data + out.index(p));
+        continue;
+      }
+      const auto x0 = p[0] * Internal::TransposeTile;
+      const auto y0 = p[b] * Internal::TransposeTile;
+      const auto x1 = std::min(x0 + Internal::TransposeTile, width);
+      const auto y1 = std::min(y0 + Internal::TransposeTile, height);
+      p[0] = x0;
+      p[b] = y0;
+      const auto* i = in_data + view.index(p);
+      auto* o = out_data + out.index(p);
+      for (Index y = 0; y < y1 - y0; ++y) {
+        for (Index x = 0; x < x1 - x0; ++x) {
+          o[y * out_stride + x] = i[x * in_stride + y];
+        }
+      }
+    }
+  });
+  return out;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Copy a raster with permuted axes, sequentially.
+ */
+template <typename T, Index N, typename THolder, typename U, typename UHolder>
+Raster<U, N, UHolder>& transpose(const Raster<T, N, THolder>& in, const Position<N>& axes, Raster<U, N, UHolder>& out)
+{
+  return transpose(par(1), in, axes, out);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Copy a raster with permuted axes into a new raster.
+ */
+template <typename T, Index N, typename THolder>
+Raster<std::remove_const_t<T>, N>
+transpose(const ParallelPolicy& policy, const Raster<T, N, THolder>& in, const Position<N>& axes)
+{
+  Raster<std::remove_const_t<T>, N> out(strided(in).permute(axes).shape(), uninitialized);
+  transpose(policy, in, axes, out);
+  return out;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Copy a raster with permuted axes into a new raster, sequentially.
+ */
+template <typename T, Index N, typename THolder>
+Raster<std::remove_const_t<T>, N> transpose(const Raster<T, N, THolder>& in, const Position<N>& axes)
+{
+  return transpose(par(1), in, axes);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Swap two axes of same length of a raster, in place.
+ * @param policy The parallel policy
+ * @param raster The raster
+ * @param i The first axis
+ * @param j The second axis
+ *
+ * Each square section spanned by the axes is transposed by pairs of tiles which are swapped,
+ * and tiles are distributed over the threads.
+ * The shape is unchanged, by definition.
+ */
+template <typename T, Index N, typename THolder>
+Raster<T, N, THolder>&
+transpose_inplace(const ParallelPolicy& policy, Raster<T, N, THolder>& raster, Index i = 0, Index j = 1)
+{
+  const auto& shape = raster.shape();
+  SizeError::may_throw(shape[j], shape[i]);
+  if (i == j || raster.size() == 0) {
+    return raster;
+  }
+  const auto length = shape[i];
+  const auto tiles = (length + Internal::TransposeTile - 1) / Internal::TransposeTile;
+  const auto si = shape_stride(shape, i);
+  const auto sj = shape_stride(shape, j);
+  auto order = shape; // Natural order of the axes
+  for (std::size_t a = 0; a < order.size(); ++a) {
+    order[a] = a;
+  }
+  auto outer = shape; // Shape of the pairs of tiles (upper triangle), times the other axes
+  outer[i] = tiles * (tiles + 1) / 2;
+  outer[j] = 1;
+  auto* data = raster.data();
+
+  Internal::parallel_chunks(policy.thread_count(), shape_size(outer), [&](Index front, Index back) {
+    for (Index t = front; t < back; ++t) {
+      auto p = Internal::shape_position(outer, order, t);
+      Index ti = 0; // Decode the pair (ti, tj) with ti <= tj from its index in the upper triangle
+      Index pair = p[i];
+      while (pair >= tiles - ti) {
+        pair -= tiles - ti;
+        ++ti;
+      }
+      const auto tj = ti + pair;
+      p[i] = 0;
+      auto* section = data + raster.index(p);
+      const auto x0 = ti * Internal::TransposeTile;
+      const auto y0 = tj * Internal::TransposeTile;
+      const auto x1 = std::min(x0 + Internal::TransposeTile, length);
+      const auto y1 = std::min(y0 + Internal::TransposeTile, length);
+      for (Index y = y0; y < y1; ++y) {
+        for (Index x = x0; x < (ti == tj ? y : x1); ++x) { // Upper triangle only for diagonal tiles
+          std::swap(section[x * si + y * sj], section[y * si + x * sj]);
+        }
+      }
+    }
+  });
+  return raster;
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Swap two axes of same length of a raster, in place and sequentially.
+ */
+template <typename T, Index N, typename THolder>
+Raster<T, N, THolder>& transpose_inplace(Raster<T, N, THolder>& raster, Index i = 0, Index j = 1)
+{
+  return transpose_inplace(par(1), raster, i, j);
+}
+
+/**
+ * @ingroup data_classes
+ * @brief Transform the profiles of a raster along some axis in place, by blocks gathered in contiguous memory.
+ * @param policy The parallel policy
+ * @param raster The raster
+ * @param axis The axis of the profiles
+ * @param margin The number of scratch values before and after each profile, e.g. for boundary conditions
+ * @param func The function, called as `func(block, width)`
+ *
+ * Profiles along a slow axis are not read one by one with the stride of the axis,
+ * which would thrash the cache and the TLB,
+ * but by blocks of `width` neighbor profiles, i.e. of consecutive indices along the faster axes,
+ * which are gathered row by row into a thread-local block, transformed, and scattered back.
+ * In the block, value `k` of profile `j` is `block[k * width + j]`,
+ * such that loops over `j` are contiguous and vectorized across the profiles,
+ * while the recursion along the axis, if any, runs over `k`.
+ * Indices `k` in `[-margin, 0)` and `[length, length + margin)` are scratch space.
+ * Along axis 0, blocks are made of a single profile, which is contiguous anyway.
+ *
+ * Blocks are distributed over the threads, such that axis-2 transforms of a cube run at nearly axis-0 speed.
+ *
+ * \code
+ * // Cumulative sum along axis 2
+ * const auto length = cube.length(2);
+ * transform_profiles(par, cube, 2, 0, [&](float* block, Index width) {
+ *   for (Index k = 1; k < length; ++k) {
+ *     for (Index j = 0; j < width; ++j) {
+ *       block[k * width + j] += block[(k - 1) * width + j];
+ *     }
+ *   }
+ * });
+ * \endcode
+ */
+template <typename T, Index N, typename THolder, typename TFunc>
+Raster<T, N, THolder>&
+transform_profiles(const ParallelPolicy& policy, Raster<T, N, THolder>& raster, Index axis, Index margin, TFunc&& func)
+{
+  if (raster.size() == 0) {
+    return raster;
+  }
+  const auto& shape = raster.shape();
+  const auto inner = shape_stride(shape, axis); // Contiguous number of profiles
+  const auto length = shape[axis];
+  const auto outer = raster.size() / (inner * length);
+  const auto width = std::min(inner, Internal::TransposeTile);
+  const auto blocks = (inner + width - 1) / width; // Per section of `inner * length` values
+  auto* data = raster.data();
+
+  Internal::parallel_chunks(policy.thread_count(), outer * blocks, [&](Index front, Index back) {
+    std::vector<T> scratch((length + 2 * margin) * width);
+    for (Index t = front; t < back; ++t) {
+      const auto x0 = (t % blocks) * width;
+      const auto w = std::min(width, inner - x0);
+      auto* base = data + (t / blocks) * inner * length + x0;
+      auto* block = scratch.data() + margin * w;
+      if (w == inner) { // Contiguous section
+        std::copy_n(base, length * w, block);
+        func(block, w);
+        std::copy_n(block, length * w, base);
+        continue;
+      }
+      for (Index k = 0; k < length; ++k) {
+        std::copy_n(base + k * inner, w, block + k * w);
+      }
+      func(block, w);
+      for (Index k = 0; k < length; ++k) {
+        std::copy_n(block + k * w, w, base + k * inner);
+      }
+    }
+  });
+  return raster;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,323 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_VIRTUALRASTER_H
+#define _LINXDATA_VIRTUALRASTER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Expression.h"
+#include "Linx/Data/Raster.h"
+
+#include <cstdint> // uint64_t
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief A raster whose values are computed on the fly from their positions, without any storage.
+ * @tparam TFunc The generator, which maps a `Position<N>` to a value
+ * @tparam N The dimension
+ *
+ * Virtual rasters are ranges of positions mapped by a function, e.g. coordinate ramps, counter-based noise or constants,
+ * such that values which are used once, typically as a term of an expression or as a coordinate in a warp,
+ * are never stored.
+ * They take part in expressions (see `Expression`), where they are stored by value, like scalars,
+ * and can be filtered (see `FilterMixin`).
+ *
+ * \code
+ * const auto noise = virtual_noise(image.shape(), CounterGaussianNoise<float>(0, sigma, seed));
+ * const auto noisy = (image + noise).eval(); // Single loop, no noise buffer
+ * \endcode
+ *
+ * The generator is defined everywhere, including outside the domain,
+ * such that a virtual raster is its own extrapolation, and a sub-raster is a shifted virtual raster.
+ * It must be a pure function of the position: it can be called several times per pixel, in any order,
+ * and from several threads.
+ *
+ * @see `virtual_raster()`, `virtual_constant()`, `virtual_coordinate()`, `virtual_index()`, `virtual_noise()`
+ */
+template <typename TFunc, Index N = 2>
+class VirtualRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = std::decay_t<decltype(std::declval<const TFunc&>()(std::declval<const Position<N>&>()))>;
+
+  /**
+   * @brief The value type.
+   */
+  using value_type = Value;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief An element iterator, in memory order.
+   */
+  class Iterator {
+  public:
+
+    /**
+     * @brief Constructor.
+     */
+    Iterator(const VirtualRaster& raster, typename Box<N>::Iterator it) : m_raster(&raster), m_it(LINX_MOVE(it)) {}
+
+    /**
+     * @brief Generate the current element.
+     */
+    Value operator*() const
+    {
+      return (*m_raster)[*m_it];
+    }
+
+    /**
+     * @brief Move to the next element.
+     */
+    Iterator& operator++()
+    {
+      ++m_it;
+      return *this;
+    }
+
+    /**
+     * @brief Check whether two iterators point to the same element.
+     */
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_it == rhs.m_it;
+    }
+
+    /**
+     * @brief Check whether two iterators point to different elements.
+     */
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_it != rhs.m_it;
+    }
+
+  private:
+
+    const VirtualRaster* m_raster; ///< The raster
+    typename Box<N>::Iterator m_it; ///< The position iterator
+  };
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param func The generator
+   * @param front The position which is passed to the generator for the first pixel
+   */
+  VirtualRaster(Position<N> shape, TFunc func, Position<N> front = Position<N>::zero()) :
+      m_domain(Box<N>::from_shape(Position<N>::zero(), LINX_MOVE(shape))), m_func(LINX_MOVE(func)),
+      m_front(LINX_MOVE(front))
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster dimension.
+   */
+  Index dimension() const
+  {
+    return m_domain.dimension();
+  }
+
+  /**
+   * @brief Get the raster shape.
+   */
+  Position<N> shape() const
+  {
+    return m_domain.shape();
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index size() const
+  {
+    return m_domain.size();
+  }
+
+  /**
+   * @brief Get the generator.
+   */
+  const TFunc& generator() const
+  {
+    return m_func;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Generate the value at given position, which can be outside the domain.
+   */
+  inline Value operator[](const Position<N>& position) const
+  {
+    return m_func(position + m_front);
+  }
+
+  /**
+   * @brief Get a virtual sub-raster, whose first pixel is at the front of a given box.
+   *
+   * The box can extend outside the domain.
+   */
+  VirtualRaster operator()(const Box<N>& region) const
+  {
+    return VirtualRaster(region.shape(), m_func, region.front() + m_front);
+  }
+
+  /**
+   * @brief Iterator to the first element.
+   */
+  Iterator begin() const
+  {
+    return Iterator(*this, m_domain.begin());
+  }
+
+  /**
+   * @brief Iterator past the last element.
+   */
+  Iterator end() const
+  {
+    return Iterator(*this, m_domain.end());
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Generate the values into a new raster.
+   */
+  Raster<Value, N> eval() const
+  {
+    Raster<Value, N> out(shape());
+    eval_to(out);
+    return out;
+  }
+
+  /**
+   * @brief Generate the values into an existing container of same size.
+   */
+  template <typename TOut>
+  TOut& eval_to(TOut& out) const
+  {
+    SizeError::may_throw(out.size(), size());
+    auto it = out.begin();
+    for (const auto& p : m_domain) {
+      *it = (*this)[p];
+      ++it;
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  Box<N> m_domain; ///< The domain
+  TFunc m_func; ///< The generator
+  Position<N> m_front; ///< The generator position of the first pixel
+};
+
+/// @cond
+namespace Internal {
+
+template <typename TFunc, Index N>
+struct IsVirtualRaster<VirtualRaster<TFunc, N>> : std::true_type {};
+
+template <typename TFunc, Index N, typename T>
+struct EvaluationType<VirtualRaster<TFunc, N>, T> {
+  using Type = Raster<T, N>;
+
+  static Type make(const VirtualRaster<TFunc, N>& operand)
+  {
+    return Type(operand.shape());
+  }
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso VirtualRaster
+ * @brief Make a virtual raster from a generator.
+ */
+template <Index N, typename TFunc>
+VirtualRaster<std::decay_t<TFunc>, N> virtual_raster(Position<N> shape, TFunc&& func)
+{
+  return VirtualRaster<std::decay_t<TFunc>, N>(LINX_MOVE(shape), LINX_FORWARD(func));
+}
+
+/**
+ * @relatesalso VirtualRaster
+ * @brief Make a constant virtual raster.
+ */
+template <typename T, Index N>
+auto virtual_constant(Position<N> shape, T value)
+{
+  return virtual_raster(LINX_MOVE(shape), [=](const Position<N>&) {
+    return value;
+  });
+}
+
+/**
+ * @relatesalso VirtualRaster
+ * @brief Make a virtual raster of the coordinates along some axis, i.e. a coordinate ramp.
+ */
+template <typename T = Index, Index N>
+auto virtual_coordinate(Position<N> shape, Index axis)
+{
+  return virtual_raster(LINX_MOVE(shape), [=](const Position<N>& p) {
+    return static_cast<T>(p[axis]);
+  });
+}
+
+/**
+ * @relatesalso VirtualRaster
+ * @brief Make a virtual raster of the pixel indices, like `Raster::range()` without storage.
+ *
+ * Indices are those of the positions in the whole raster, including in sub-rasters.
+ */
+template <typename T = Index, Index N>
+auto virtual_index(Position<N> shape)
+{
+  return virtual_raster(shape, [=](const Position<N>& p) {
+    return static_cast<T>(Internal::IndexRecursionImpl<N>::index(shape, p));
+  });
+}
+
+/**
+ * @relatesalso VirtualRaster
+ * @brief Make a virtual raster of counter-based noise, e.g. `CounterGaussianNoise`.
+ *
+ * The value of a pixel is the value of its index in the whole raster,
+ * such that it does not depend on the evaluation order or thread count, and is the same in sub-rasters.
+ */
+template <Index N, typename TGenerator>
+auto virtual_noise(Position<N> shape, TGenerator generator)
+{
+  return virtual_raster(shape, [=](const Position<N>& p) {
+    return generator.at(static_cast<std::uint64_t>(Internal::IndexRecursionImpl<N>::index(shape, p)));
+  });
+}
+
+} // namespace Linx
+
+#endif
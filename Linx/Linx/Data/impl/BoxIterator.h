@@ -76,17 +76,20 @@ public:
    */
   Iterator& operator++()
   {
-    if (m_current == m_region.back()) { // TODO simpler?
-      m_current = end_position(m_region);
+    const auto& front = m_region.front();
+    const auto& back = m_region.back();
+    if (++m_current[0] <= back[0]) { // Most frequent case, without carry
       return *this;
     }
-    ++m_current[0];
-    for (std::size_t i = 0; i < m_current.size() - 1; ++i) {
-      if (m_current[i] > m_region.back()[i]) {
-        m_current[i] = m_region.front()[i];
-        ++m_current[i + 1];
+    m_current[0] = front[0];
+    const auto dimension = static_cast<Index>(m_current.size());
+    for (Index i = 1; i < dimension; ++i) {
+      if (++m_current[i] <= back[i]) {
+        return *this;
       }
+      m_current[i] = front[i];
     }
+    m_current = end_position(m_region);
     return *this;
   }
 
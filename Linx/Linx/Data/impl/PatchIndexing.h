@@ -21,10 +21,16 @@ class Line;
 template <Index N>
 class Mask;
 
+template <Index N>
+class RunList;
+
 // Forward declaration for specializations
 template <typename T, Index N, typename THolder>
 class Raster;
 
+template <typename T, Index N>
+class StridedIterator;
+
 /// @endcond
 
 /**
@@ -98,62 +104,58 @@ public:
 
 /**
  * @brief Indexing of regular grids, based on strides.
+ * 
+ * Row offsets are not tabulated but computed incrementally from the strides,
+ * such that constructing and translating a patch does not allocate.
  */
 template <typename TParent, typename TRegion>
 class StrideBasedIndexing {
 public:
 
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = TParent::Dimension;
+
   /**
    * @brief The patch iterator.
    */
   template <typename T>
-  class Iterator;
+  using Iterator = StridedIterator<T, Dimension>;
 
   /**
    * @brief Default constructor.
    */
-  StrideBasedIndexing() : m_step(1), m_width(0), m_offsets(1) {}
+  StrideBasedIndexing() : m_step(1), m_width(0), m_rows(0), m_lengths(), m_strides() {}
 
   /**
    * @brief Constructor for boxes.
    */
-  StrideBasedIndexing(const TParent& parent, const Box<TParent::Dimension>& region) :
-      m_step(1), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1)
-  // max to prevent division by 0, +1 in order to dereference m_offsets.end() in iterator
+  StrideBasedIndexing(const TParent& parent, const Box<Dimension>& region) :
+      m_step(1), m_width(region.length(0)), m_rows(0), m_lengths(region.shape()), m_strides(m_lengths.size())
   {
-    if (region.size() <= 0) { // FIXME needed?
-      return;
-    }
-    auto plane = (region - region.front()).project();
-    std::transform(plane.begin(), plane.end(), m_offsets.begin(), [&](const auto& p) {
-      return parent.index(p);
-    });
+    init(parent, region, Position<Dimension>::one(m_lengths.size()));
   }
 
   /**
    * @brief Constructor for grids.
    */
-  StrideBasedIndexing(const TParent& parent, const Grid<TParent::Dimension>& region) :
-      m_step(region.step()[0]), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1)
-  // for max and +1 see above
+  StrideBasedIndexing(const TParent& parent, const Grid<Dimension>& region) :
+      m_step(region.step()[0]), m_width(m_step * (region.length(0) - 1) + 1), m_rows(0),
+      m_lengths(region.step().size()), m_strides(m_lengths.size())
   {
-    if (region.size() <= 0) { // FIXME needed?
-      return;
-    }
-    const auto plane = (region - region.front()).project();
-    std::transform(plane.begin(), plane.end(), m_offsets.begin(), [&](const auto& p) {
-      return parent.index(p);
-    });
+    init(parent, region, region.step());
   }
 
   /**
    * @brief Constructor for lines.
    */
   template <Index I>
-  StrideBasedIndexing(const TParent& parent, const Line<I, TParent::Dimension>& region) :
+  StrideBasedIndexing(const TParent& parent, const Line<I, Dimension>& region) :
       m_step(shape_stride<I>(parent.shape()) * region.step()), m_width(m_step * (region.size() - 1) + 1),
-      m_offsets(2, 0)
-  {} // 1+1 see above
+      m_rows(region.size() > 0), m_lengths(Position<Dimension>::one(parent.shape().size())),
+      m_strides(m_lengths.size())
+  {}
 
   /**
    * @brief Get an iterator to the beginning.
@@ -161,7 +163,7 @@ public:
   template <typename T>
   Iterator<T> begin(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data());
+    return Iterator<T>(&raster[region.front()], m_step, m_width, 0, m_lengths, m_strides);
   }
 
   /**
@@ -170,25 +172,51 @@ public:
   template <typename T>
   Iterator<T> end(TParent& raster, const TRegion& region) const
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data() + m_offsets.size() - 1);
+    return Iterator<T>(&raster[region.front()], m_step, m_width, m_rows, m_lengths, m_strides);
   }
 
 private:
 
+  /**
+   * @brief Compute the row count, lengths and strides along axes 1 and more.
+   */
+  template <typename TGrid>
+  void init(const TParent& parent, const TGrid& region, const Position<Dimension>& step)
+  {
+    const auto size = region.size();
+    m_rows = size > 0 ? size / std::max(region.length(0), Index(1)) : 0;
+    for (std::size_t i = 0; i < m_lengths.size(); ++i) {
+      auto unit = Position<Dimension>::zero(m_lengths.size());
+      unit[i] = step[i];
+      m_lengths[i] = region.length(i);
+      m_strides[i] = parent.index(unit);
+    }
+  }
+
   /**
    * @brief The stride along axis 0.
    */
   Index m_step;
 
   /**
-   * @brief The length along axis 0.
+   * @brief The distance between the row beginning and end.
    */
   Index m_width;
 
   /**
-   * @brief The offsets relative to the region front.
+   * @brief The number of rows.
    */
-  std::vector<Index> m_offsets;
+  Index m_rows;
+
+  /**
+   * @brief The number of rows along each axis.
+   */
+  Position<Dimension> m_lengths;
+
+  /**
+   * @brief The stride between rows along each axis.
+   */
+  Position<Dimension> m_strides;
 };
 
 /**
@@ -247,6 +275,110 @@ private:
   std::vector<Index> m_offsets;
 };
 
+/**
+ * @brief Indexing of masks, based on runs of contiguous elements.
+ * 
+ * Each row of the mask is compiled into the runs of set flags, stored as an offset and a length,
+ * such that iteration is contiguous inside each run, and unset flags are never visited.
+ */
+template <typename TParent, typename TRegion>
+class RunBasedIndexing {
+public:
+
+  /**
+   * @brief The patch iterator.
+   */
+  template <typename T>
+  class Iterator;
+
+  /**
+   * @brief Default constructor.
+   */
+  RunBasedIndexing() : m_runs(1, {0, 0}) {}
+
+  /**
+   * @brief Constructor.
+   */
+  RunBasedIndexing(const TParent& parent, const TRegion& region) : m_runs()
+  {
+    const auto front = box(region).front();
+    for_each_run(region, [&](const auto& p, Index length) {
+      m_runs.emplace_back(parent.index(p - front), length);
+    });
+    m_runs.emplace_back(0, 0); // Sentinel in order to dereference m_runs.end() in iterator
+  }
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  template <typename T>
+  Iterator<T> begin(TParent& raster, const TRegion& region) const
+  {
+    return Iterator<T>(&raster[box(region).front()], m_runs.data());
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  template <typename T>
+  Iterator<T> end(TParent& raster, const TRegion& region) const
+  {
+    return Iterator<T>(&raster[box(region).front()], m_runs.data() + m_runs.size() - 1);
+  }
+
+private:
+
+  /**
+   * @brief The offsets relative to the front index and lengths of the runs.
+   */
+  std::vector<std::pair<Index, Index>> m_runs;
+};
+
+/**
+ * @brief Indexing of run lists, based on the runs of the region itself.
+ * 
+ * The region is already compiled, such that the index of each run is computed on the fly during iteration,
+ * and nothing is allocated at construction.
+ */
+template <typename TParent, typename TRegion>
+class RunListIndexing {
+public:
+
+  /**
+   * @brief The patch iterator.
+   */
+  template <typename T>
+  class Iterator;
+
+  /**
+   * @brief Default constructor.
+   */
+  RunListIndexing() {}
+
+  /**
+   * @brief Constructor.
+   */
+  RunListIndexing(const TParent&, const TRegion&) {}
+
+  /**
+   * @brief Get an iterator to the beginning.
+   */
+  template <typename T>
+  Iterator<T> begin(TParent& raster, const TRegion& region) const
+  {
+    return Iterator<T>(raster, region, 0);
+  }
+
+  /**
+   * @brief Get an iterator to the end.
+   */
+  template <typename T>
+  Iterator<T> end(TParent& raster, const TRegion& region) const
+  {
+    return Iterator<T>(raster, region, region.run_count());
+  }
+};
+
 template <typename TParent, typename TRegion, bool IsContiguous = false>
 struct PatchTraits {
   /**
@@ -257,7 +389,7 @@ struct PatchTraits {
    * - `Box`,
    * - `Grid`,
    * - `Line`,
-   * - `Mask`.
+   * - `Mask` and `RunList`, as runs of contiguous elements.
    * 
    * For extrapolators, no optimization is performed.
    */
@@ -309,7 +441,16 @@ struct PatchTraits<Raster<T, N, THolder>, Line<I, N>> {
 template <typename T, Index N, typename THolder>
 struct PatchTraits<Raster<T, N, THolder>, Mask<N>> {
   template <typename UParent, typename URegion>
-  using Indexing = OffsetBasedIndexing<UParent, URegion>;
+  using Indexing = RunBasedIndexing<UParent, URegion>;
+};
+
+/**
+ * @brief `RunList` specialization.
+ */
+template <typename T, Index N, typename THolder>
+struct PatchTraits<Raster<T, N, THolder>, RunList<N>> {
+  template <typename UParent, typename URegion>
+  using Indexing = RunListIndexing<UParent, URegion>;
 };
 
 /// @endcond
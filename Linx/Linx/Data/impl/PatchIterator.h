@@ -60,23 +60,40 @@ private:
   PositionIterator m_current;
 };
 
-template <typename TParent, typename TRegion>
-template <typename T>
-class StrideBasedIndexing<TParent, TRegion>::Iterator : public std::iterator<std::forward_iterator_tag, T> {
+/**
+ * @brief An iterator over strided data, row by row.
+ * 
+ * Rows are visited with a constant step, and the row offset is carried over the other axes at each end of row.
+ * The step must be positive, while the strides along the other axes can be of any sign.
+ */
+template <typename T, Index N>
+class StridedIterator : public std::iterator<std::forward_iterator_tag, T> {
 public:
 
   using Value = T;
-  static constexpr Index Dimension = TParent::Dimension;
+  static constexpr Index Dimension = N;
 
   /**
    * @brief Constructor.
+   * @param front The front pointer
    * @param step The stride along axis 0
-   * @param width The length along axis 0
-   * @param offset An iterator to the beginning of line offsets
+   * @param width The distance between the row beginning and end
+   * @param row The row index
+   * @param lengths The number of rows along each axis
+   * @param strides The stride between rows along each axis
+   * 
+   * For the end iterator, the row index is the number of rows, and other values are ignored.
    */
-  Iterator(Value* front, Index step, Index width, const Index* offset) :
-      m_step(step), m_width(width), m_front(front), m_eol(m_front + m_width), m_offset_it(offset),
-      m_current(m_front + *m_offset_it)
+  StridedIterator(
+      Value* front,
+      Index step,
+      Index width,
+      Index row,
+      const Position<Dimension>& lengths,
+      const Position<Dimension>& strides) :
+      m_step(step), m_width(width), m_front(front), m_row(row), m_offset(0), m_eol(m_front + m_width),
+      m_current(m_front), m_counts(Position<Dimension>::zero(lengths.size())), m_lengths(lengths),
+      m_strides(strides)
   {}
 
   /**
@@ -98,14 +115,23 @@ public:
   /**
    * @brief Increment operator.
    */
-  Iterator& operator++()
+  StridedIterator& operator++()
   {
     m_current += m_step;
     if (m_current < m_eol) {
       return *this;
     }
-    m_current = m_front + *(++m_offset_it);
-    // Cannot dereference if m_offset_it == m_offset_end => size + 1 to avoid branching
+    ++m_row;
+    const auto dimension = static_cast<Index>(m_lengths.size());
+    for (Index i = 1; i < dimension; ++i) {
+      if (++m_counts[i] < m_lengths[i]) {
+        m_offset += m_strides[i];
+        break;
+      }
+      m_offset -= m_strides[i] * (m_lengths[i] - 1);
+      m_counts[i] = 0;
+    }
+    m_current = m_front + m_offset;
     m_eol = m_current + m_width;
     return *this;
   }
@@ -113,7 +139,7 @@ public:
   /**
    * @brief Increment operator.
    */
-  Iterator operator++(int)
+  StridedIterator operator++(int)
   {
     auto out = *this;
     ++(*this);
@@ -123,17 +149,17 @@ public:
   /**
    * @brief Equality operator.
    */
-  bool operator==(const Iterator& rhs) const
+  bool operator==(const StridedIterator& rhs) const
   {
-    return m_offset_it == rhs.m_offset_it;
+    return m_row == rhs.m_row;
   }
 
   /**
    * @brief Non equality operator.
    */
-  bool operator!=(const Iterator& rhs) const
+  bool operator!=(const StridedIterator& rhs) const
   {
-    return m_offset_it != rhs.m_offset_it;
+    return m_row != rhs.m_row;
   }
 
 private:
@@ -154,19 +180,39 @@ private:
   Value* m_front;
 
   /**
-   * @brief The current end of line pointer.
+   * @brief The current row index.
    */
-  Value* m_eol;
+  Index m_row;
 
   /**
-   * @brief A beginning of line offset iterator.
+   * @brief The offset of the current row relative to the front.
    */
-  const Index* m_offset_it;
+  Index m_offset;
+
+  /**
+   * @brief The current end of line pointer.
+   */
+  Value* m_eol;
 
   /**
    * @brief The current pointer.
    */
   Value* m_current;
+
+  /**
+   * @brief The current row along each axis.
+   */
+  Position<Dimension> m_counts;
+
+  /**
+   * @brief The number of rows along each axis.
+   */
+  Position<Dimension> m_lengths;
+
+  /**
+   * @brief The stride between rows along each axis.
+   */
+  Position<Dimension> m_strides;
 };
 
 template <typename TParent, typename TRegion>
@@ -217,6 +263,224 @@ private:
   const Index* m_current;
 };
 
+template <typename TParent, typename TRegion>
+template <typename T>
+class RunBasedIndexing<TParent, TRegion>::Iterator : public std::iterator<std::forward_iterator_tag, T> {
+public:
+
+  using Value = T;
+
+  /**
+   * @brief Constructor.
+   * @param front The front pointer
+   * @param run An iterator to the current run
+   */
+  Iterator(Value* front, const std::pair<Index, Index>* run) :
+      m_front(front), m_run(run), m_current(m_front + m_run->first), m_eor(m_current + m_run->second)
+  {}
+
+  /**
+   * @brief Dereference operator.
+   */
+  Value& operator*() const
+  {
+    return *m_current;
+  }
+
+  /**
+   * @brief Arrow operator.
+   */
+  Value* operator->() const
+  {
+    return m_current;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator& operator++()
+  {
+    if (++m_current < m_eor) {
+      return *this;
+    }
+    ++m_run; // Cannot dereference if m_run == end => sentinel
+    m_current = m_front + m_run->first;
+    m_eor = m_current + m_run->second;
+    return *this;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator operator++(int)
+  {
+    auto out = *this;
+    ++(*this);
+    return out;
+  }
+
+  /**
+   * @brief Equality operator.
+   */
+  bool operator==(const Iterator& rhs) const
+  {
+    return m_current == rhs.m_current && m_run == rhs.m_run;
+  }
+
+  /**
+   * @brief Non equality operator.
+   */
+  bool operator!=(const Iterator& rhs) const
+  {
+    return not(*this == rhs);
+  }
+
+private:
+
+  /**
+   * @brief The front pointer.
+   */
+  Value* m_front;
+
+  /**
+   * @brief The current run.
+   */
+  const std::pair<Index, Index>* m_run;
+
+  /**
+   * @brief The current pointer.
+   */
+  Value* m_current;
+
+  /**
+   * @brief The current end of run pointer.
+   */
+  Value* m_eor;
+};
+
+template <typename TParent, typename TRegion>
+template <typename T>
+class RunListIndexing<TParent, TRegion>::Iterator : public std::iterator<std::forward_iterator_tag, T> {
+public:
+
+  using Value = T;
+
+  /**
+   * @brief Constructor.
+   * @param parent The parent
+   * @param region The run list
+   * @param run The index of the current run
+   */
+  Iterator(TParent& parent, const TRegion& region, Index run) :
+      m_parent(&parent), m_front(region.fronts().data() + run), m_end(region.fronts().data() + region.run_count()),
+      m_offset(region.offsets().data() + run), m_current(nullptr), m_eor(nullptr)
+  {
+    start();
+  }
+
+  /**
+   * @brief Dereference operator.
+   */
+  Value& operator*() const
+  {
+    return *m_current;
+  }
+
+  /**
+   * @brief Arrow operator.
+   */
+  Value* operator->() const
+  {
+    return m_current;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator& operator++()
+  {
+    if (++m_current < m_eor) {
+      return *this;
+    }
+    ++m_front;
+    ++m_offset;
+    start();
+    return *this;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator operator++(int)
+  {
+    auto out = *this;
+    ++(*this);
+    return out;
+  }
+
+  /**
+   * @brief Equality operator.
+   */
+  bool operator==(const Iterator& rhs) const
+  {
+    return m_current == rhs.m_current && m_offset == rhs.m_offset;
+  }
+
+  /**
+   * @brief Non equality operator.
+   */
+  bool operator!=(const Iterator& rhs) const
+  {
+    return not(*this == rhs);
+  }
+
+private:
+
+  /**
+   * @brief Move to the beginning of the current run, or to `nullptr` past the last run.
+   */
+  void start()
+  {
+    if (m_front == m_end) {
+      m_current = nullptr;
+      m_eor = nullptr;
+      return;
+    }
+    m_current = &(*m_parent)[*m_front];
+    m_eor = m_current + (m_offset[1] - m_offset[0]);
+  }
+
+  /**
+   * @brief The parent.
+   */
+  TParent* m_parent;
+
+  /**
+   * @brief The front position of the current run.
+   */
+  const Position<TParent::Dimension>* m_front;
+
+  /**
+   * @brief The end of the run fronts.
+   */
+  const Position<TParent::Dimension>* m_end;
+
+  /**
+   * @brief The offset of the current run in the region.
+   */
+  const Index* m_offset;
+
+  /**
+   * @brief The current pointer.
+   */
+  Value* m_current;
+
+  /**
+   * @brief The current end of run pointer.
+   */
+  Value* m_eor;
+};
+
 } // namespace Linx
 
 #endif
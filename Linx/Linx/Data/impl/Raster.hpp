@@ -113,7 +113,7 @@ inline const T& Raster<T, N, THolder>::operator[](const Position<N>& pos) const
 template <typename T, Index N, typename THolder>
 inline T& Raster<T, N, THolder>::operator[](const Position<N>& pos)
 {
-  return const_cast<T&>(const_cast<const Raster&>(*this)[pos]);
+  return (*this)[index(pos)];
 }
 
 template <typename T, Index N, typename THolder>
@@ -134,7 +134,9 @@ inline const T& Raster<T, N, THolder>::at(const Position<N>& pos) const
 template <typename T, Index N, typename THolder>
 inline T& Raster<T, N, THolder>::at(const Position<N>& pos)
 {
-  return const_cast<T&>(const_cast<const Raster&>(*this).at(pos));
+  const auto& self = const_cast<const Raster&>(*this);
+  const auto offset = &self.at(pos) - self.data();
+  return this->data()[offset];
 }
 
 template <typename T, Index N, typename THolder>
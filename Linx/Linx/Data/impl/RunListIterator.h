@@ -0,0 +1,118 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_IMPL_RUNLISTITERATOR_H
+#define _LINXDATA_IMPL_RUNLISTITERATOR_H
+
+#include "Linx/Data/RunList.h"
+
+namespace Linx {
+
+template <Index N>
+class RunList<N>::Iterator : public std::iterator<std::forward_iterator_tag, Position<N>> {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param region The run list
+   * @param run The index of the current run
+   */
+  explicit Iterator(const RunList<N>& region, Index run) :
+      m_region(&region), m_run(run), m_eor(0), m_current()
+  {
+    start();
+  }
+
+  /**
+   * @brief Dereference operator.
+   */
+  const Position<N>& operator*() const
+  {
+    return m_current;
+  }
+
+  /**
+   * @brief Arrow operator.
+   */
+  const Position<N>* operator->() const
+  {
+    return &m_current;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator& operator++()
+  {
+    if (++m_current[0] < m_eor) {
+      return *this;
+    }
+    ++m_run;
+    start();
+    return *this;
+  }
+
+  /**
+   * @brief Increment operator.
+   */
+  Iterator operator++(int)
+  {
+    auto out = *this;
+    ++(*this);
+    return out;
+  }
+
+  /**
+   * @brief Equality operator.
+   */
+  bool operator==(const Iterator& rhs) const
+  {
+    return m_run == rhs.m_run && (m_run == m_region->run_count() || m_current[0] == rhs.m_current[0]);
+  }
+
+  /**
+   * @brief Non-equality operator.
+   */
+  bool operator!=(const Iterator& rhs) const
+  {
+    return not(*this == rhs);
+  }
+
+private:
+
+  /**
+   * @brief Move to the beginning of the current run, if any.
+   */
+  void start()
+  {
+    if (m_run < m_region->run_count()) {
+      m_current = m_region->m_fronts[m_run];
+      m_eor = m_current[0] + m_region->m_offsets[m_run + 1] - m_region->m_offsets[m_run];
+    }
+  }
+
+  /**
+   * @brief The run list.
+   */
+  const RunList<N>* m_region;
+
+  /**
+   * @brief The index of the current run.
+   */
+  Index m_run;
+
+  /**
+   * @brief The coordinate past the current run end along axis 0.
+   */
+  Index m_eor;
+
+  /**
+   * @brief The current position.
+   */
+  Position<N> m_current;
+};
+
+} // namespace Linx
+
+#endif
@@ -5,7 +5,11 @@
 #ifndef _LINX_IO_H
 #define _LINX_IO_H
 
+#include "Linx/Io/AsyncFits.h"
 #include "Linx/Io/Fits.h"
+#include "Linx/Io/FitsMapping.h"
+#include "Linx/Io/FitsStream.h"
+#include "Linx/Io/Npy.h"
 #include "Linx/Io/Temporary.h"
 
 #include <filesystem>
@@ -26,6 +30,19 @@ Raster<T, N> read(const std::filesystem::path& path, Index index = 0)
   }
 }
 
+/**
+ * @brief Read a region of a raster from a file.
+ */
+template <typename T, Index N = 2>
+Raster<T, N> read(const std::filesystem::path& path, const Box<N>& region, Index index = 0)
+{
+  try {
+    return Fits(path).read<Raster<T, N>>(region, index);
+  } catch (FileFormatError&) {
+    throw FileFormatError("No suitable reader", path);
+  }
+}
+
 /**
  * @brief Write a raster to a file.
  */
@@ -0,0 +1,281 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_ASYNCFITS_H
+#define _LINXIO_ASYNCFITS_H
+
+#include "Linx/Base/BoundedQueue.h"
+#include "Linx/Io/Fits.h"
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief An image HDU of a FITS file.
+ */
+struct FitsHdu {
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path path;
+
+  /**
+   * @brief The (0-based) HDU index.
+   */
+  Index index = 0;
+};
+
+/**
+ * @brief Asynchronous reader which prefetches a sequence of HDUs on a background thread.
+ * @tparam TRaster The raster type
+ *
+ * HDUs are read in order by a background I/O thread, up to a given number of HDUs in advance,
+ * such that reading the next HDU overlaps with processing the current one:
+ *
+ * \code
+ * AsyncFitsReader<Raster<float>> reader({{"a.fits", 1}, {"b.fits", 1}, {"c.fits", 1}});
+ * AsyncFitsWriter writer;
+ * while (auto raster = reader.next()) {
+ *   process(*raster);
+ *   writer.write("out.fits", std::move(*raster), 'a');
+ * }
+ * writer.wait();
+ * \endcode
+ *
+ * Memory is bounded by `depth + 1` rasters: the current one and the prefetched ones.
+ * Reading errors are rethrown by `next()` in the calling thread.
+ */
+template <typename TRaster>
+class AsyncFitsReader {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param hdus The HDUs to be read, in order
+   * @param depth The maximum number of HDUs read in advance
+   */
+  explicit AsyncFitsReader(std::vector<FitsHdu> hdus, Index depth = 1) :
+      m_queue(depth), m_thread([this, hdus = std::move(hdus)]() {
+        for (const auto& hdu : hdus) {
+          try {
+            if (not m_queue.push(Item(Fits(hdu.path).read<TRaster>(hdu.index)))) {
+              break; // Stopped by the destructor
+            }
+          } catch (...) {
+            m_queue.push(Item(std::current_exception()));
+            break;
+          }
+        }
+        m_queue.close();
+      })
+  {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  AsyncFitsReader(const AsyncFitsReader&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  AsyncFitsReader& operator=(const AsyncFitsReader&) = delete;
+
+  /**
+   * @brief Destructor, which stops prefetching.
+   */
+  ~AsyncFitsReader()
+  {
+    m_queue.close();
+    m_thread.join();
+  }
+
+  /**
+   * @brief Get the next raster, waiting for it to be read if needed.
+   * @return An empty optional once all HDUs have been read
+   */
+  std::optional<TRaster> next()
+  {
+    auto item = m_queue.pop();
+    if (not item) {
+      return std::nullopt;
+    }
+    if (item->error) {
+      std::rethrow_exception(item->error);
+    }
+    return std::move(item->raster);
+  }
+
+private:
+
+  /**
+   * @brief A raster or reading error.
+   */
+  struct Item {
+    explicit Item(TRaster&& r) : raster(std::move(r)), error() {}
+    explicit Item(std::exception_ptr e) : raster(), error(e) {}
+    std::optional<TRaster> raster;
+    std::exception_ptr error;
+  };
+
+  /**
+   * @brief The prefetched rasters.
+   */
+  Internal::BoundedQueue<Item> m_queue;
+
+  /**
+   * @brief The I/O thread.
+   */
+  std::thread m_thread;
+};
+
+/**
+ * @brief Asynchronous writer which writes rasters on a background thread.
+ *
+ * Rasters are moved to a bounded queue and written in order by a background I/O thread,
+ * such that writing overlaps with computation.
+ * When the queue is full, `write()` waits for some room, which bounds memory usage.
+ *
+ * Writing errors are rethrown by `wait()`, or by the next call to `write()`.
+ *
+ * @see `AsyncFitsReader`
+ */
+class AsyncFitsWriter {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param depth The maximum number of rasters waiting to be written
+   */
+  explicit AsyncFitsWriter(Index depth = 1) : m_queue(depth), m_error(), m_mutex(), m_thread([this]() {
+    while (auto task = m_queue.pop()) {
+      try {
+        (*task)();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (not m_error) {
+          m_error = std::current_exception();
+        }
+      }
+    }
+  })
+  {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  AsyncFitsWriter(const AsyncFitsWriter&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  AsyncFitsWriter& operator=(const AsyncFitsWriter&) = delete;
+
+  /**
+   * @brief Destructor, which waits for the pending rasters to be written.
+   *
+   * Errors are not reported, call `wait()` explicitly to check them.
+   */
+  ~AsyncFitsWriter()
+  {
+    m_queue.close();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  /**
+   * @brief Enqueue a raster to be written as a new HDU.
+   * @param path The file path
+   * @param raster The raster, which is moved to the queue
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   */
+  template <typename TRaster>
+  void write(std::filesystem::path path, TRaster raster, char mode = 'x')
+  {
+    may_throw();
+    const auto pushed = m_queue.push([path = std::move(path), raster = std::move(raster), mode]() {
+      Fits(path).write(raster, mode);
+    });
+    if (not pushed) {
+      throw Exception("Cannot enqueue raster: writer was waited for");
+    }
+  }
+
+  /**
+   * @brief Enqueue a raster to be appended to a session.
+   * @param session The session, which must not be used by the calling thread until `wait()` returns
+   * @param raster The raster, which is moved to the queue
+   *
+   * This avoids reopening the file for each raster.
+   */
+  template <typename TRaster>
+  void append(FitsSession& session, TRaster raster)
+  {
+    may_throw();
+    const auto pushed = m_queue.push([&session, raster = std::move(raster)]() {
+      session.append(raster);
+    });
+    if (not pushed) {
+      throw Exception("Cannot enqueue raster: writer was waited for");
+    }
+  }
+
+  /**
+   * @brief Wait for all the enqueued rasters to be written.
+   *
+   * Rasters cannot be enqueued after this call: `write()` and `append()` throw an `Exception`.
+   */
+  void wait()
+  {
+    m_queue.close();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+    may_throw();
+  }
+
+private:
+
+  /**
+   * @brief Rethrow the error of the I/O thread, if any.
+   */
+  void may_throw()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_error) {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+  }
+
+  /**
+   * @brief The pending writes.
+   */
+  Internal::BoundedQueue<std::function<void()>> m_queue;
+
+  /**
+   * @brief The first writing error.
+   */
+  std::exception_ptr m_error;
+
+  /**
+   * @brief The error mutex.
+   */
+  std::mutex m_mutex;
+
+  /**
+   * @brief The I/O thread.
+   */
+  std::thread m_thread;
+};
+
+} // namespace Linx
+
+#endif
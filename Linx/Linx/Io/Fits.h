@@ -5,6 +5,9 @@
 #ifndef _LINXIO_FITS_H
 #define _LINXIO_FITS_H
 
+#include "Linx/Base/Conversion.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/Trace.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Io/Exceptions.h"
 
@@ -12,9 +15,64 @@
 #include <fitsio.h>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether a container exposes contiguous data.
+ */
+template <typename T, typename = void>
+struct HasData : std::false_type {};
+
+template <typename T>
+struct HasData<T, std::void_t<decltype(std::declval<const T&>().data())>> : std::true_type {};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief Tile compression parameters of a FITS image HDU.
+ *
+ * The image is split into tiles which are compressed independently, and can therefore be decompressed in parallel.
+ * Floating point values are quantized before compression unless the quantization level is 0,
+ * in which case the compression is lossless (and useful with GZIP only).
+ *
+ * @see `Fits::write(const TRaster&, const FitsCompression&, char)`
+ */
+struct FitsCompression {
+  /**
+   * @brief The compression algorithms.
+   */
+  enum class Algorithm {
+    Rice, ///< Rice, best for integers and quantized floats
+    Gzip, ///< GZIP
+    ShuffledGzip, ///< GZIP after byte shuffling, which is generally better for floats
+    Hcompress, ///< H-compress, for 2D images only
+    Plio ///< IRAF's PLIO, for positive integer masks only
+  };
+
+  /**
+   * @brief The compression algorithm.
+   */
+  Algorithm algorithm = Algorithm::Rice;
+
+  /**
+   * @brief The tile shape, or empty to compress rows independently.
+   */
+  std::vector<long> tile = {};
+
+  /**
+   * @brief The quantization level of floating point values, or 0 for lossless compression.
+   *
+   * Positive values are fractions of the noise standard deviation, negative values are absolute steps.
+   */
+  float quantization = 4;
+};
+
 /**
  * @brief FITS file reader/writer.
  * 
@@ -65,26 +123,70 @@ public:
     return m_path;
   }
 
+  /**
+   * @brief Get the number of HDUs.
+   */
+  Index hdu_count() const;
+
+  /**
+   * @brief Get the shape of an image at given (0-based) HDU index, without reading the data.
+   */
+  template <Index N = 2>
+  Position<N> shape(Index hdu = 0) const;
+
+  /**
+   * @brief Get the BITPIX of an image at given (0-based) HDU index, without reading the data.
+   *
+   * This is the BITPIX keyword value, i.e. the type of the stored values,
+   * which differs from that of the physical values e.g. for unsigned integers or quantized images.
+   */
+  int bitpix(Index hdu = 0) const;
+
+  /**
+   * @brief Read an image at given (0-based) HDU index into an existing raster.
+   * @param out The output raster, e.g. an `AlignedRaster` or `PtrRaster`, of same shape as the image
+   * @param hdu The HDU index
+   *
+   * As opposed to `read()`, no raster is allocated, such that the same buffer can be reused for many images.
+   * A `SizeError` is thrown if the shapes differ.
+   */
+  template <typename TRaster>
+  void read_to(TRaster& out, Index hdu = 0) const;
+
   /**
    * @brief Read an image at given (0-based) HDU index.
    */
   template <typename TRaster>
   TRaster read(Index hdu = 0)
   {
-    FileNotFoundError::may_throw(m_path);
+    LINX_TRACE_SCOPE("Fits::read", "Io");
     int status = 0;
-    fitsfile* fptr;
-    int naxis = 0;
-    fits_open_file(&fptr, m_path.c_str(), READONLY, &status);
+    fitsfile* fptr = open_hdu(hdu, READONLY);
+    auto out = read_image<TRaster>(fptr, status);
+    fits_close_file(fptr, &status);
     if (status != 0) {
-      throw FileFormatError("Cannot read file", m_path);
+      throw Error("Cannot read file", m_path, status);
     }
-    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
-    fits_get_img_dim(fptr, &naxis, &status);
-    Position<TRaster::Dimension> shape(naxis);
-    fits_get_img_size(fptr, naxis, shape.data(), &status);
-    TRaster out(shape);
-    fits_read_img(fptr, typecode<typename TRaster::Value>(), 1, out.size(), nullptr, out.data(), nullptr, &status);
+    fptr = nullptr;
+    return out;
+  }
+
+  /**
+   * @brief Read a region of an image at given (0-based) HDU index.
+   * @param region The region to be read, in 0-based image coordinates
+   * @param hdu The HDU index
+   *
+   * Only the requested region is read from the file, such that images larger than the memory can be processed,
+   * e.g. tile by tile.
+   * The dimension of the region is that of the image.
+   */
+  template <typename TRaster>
+  TRaster read(const Box<TRaster::Dimension>& region, Index hdu = 0)
+  {
+    LINX_TRACE_SCOPE("Fits::read", "Io");
+    int status = 0;
+    fitsfile* fptr = open_hdu(hdu, READONLY);
+    auto out = read_subset<TRaster>(fptr, region, status);
     fits_close_file(fptr, &status);
     if (status != 0) {
       throw Error("Cannot read file", m_path, status);
@@ -93,13 +195,363 @@ public:
     return out;
   }
 
+  /**
+   * @brief Read an image at given (0-based) HDU index with several threads.
+   * @param policy The parallel execution policy
+   * @param hdu The HDU index
+   *
+   * The image is split along its last axis into one band per thread, aligned to the compression tiles if any,
+   * and each thread reads its band through its own file handle.
+   * For tile-compressed images, this decompresses the tiles in parallel.
+   *
+   * Concurrent file handles require a thread-safe CFITSIO, i.e. built with `--enable-reentrant`.
+   * Otherwise, as reported by `fits_is_reentrant()`, the image is read sequentially with `read(Index)`.
+   */
+  template <typename TRaster>
+  TRaster read(const ParallelPolicy& policy, Index hdu = 0)
+  {
+    if (not fits_is_reentrant()) {
+      return read<TRaster>(hdu);
+    }
+    LINX_TRACE_SCOPE("Fits::read", "Io");
+    int status = 0;
+    fitsfile* fptr = open_hdu(hdu, READONLY);
+    const auto shape = read_shape<TRaster::Dimension>(fptr, status);
+    const auto naxis = static_cast<Index>(shape.size());
+    long band = 1; // Number of sections per tile
+    if (naxis > 0 && fits_is_compressed_image(fptr, &status)) {
+      const auto key = "ZTILE" + std::to_string(naxis);
+      int ignored = 0;
+      fits_read_key(fptr, TLONG, key.c_str(), &band, nullptr, &ignored);
+    }
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    TRaster out(shape);
+    if (out.size() == 0) {
+      return out;
+    }
+    const auto length = shape[naxis - 1];
+    const auto section_size = out.size() / length;
+    const auto band_count = (length + band - 1) / band;
+    std::vector<int> statuses(band_count, 0);
+    Internal::parallel_chunks(policy.thread_count(), band_count, [&](Index front, Index back) {
+      LINX_TRACE_SCOPE("Fits::read_band", "Io");
+      auto& s = statuses[front];
+      fitsfile* f;
+      fits_open_file(&f, m_path.c_str(), READONLY, &s);
+      fits_movabs_hdu(f, hdu + 1, nullptr, &s);
+      const auto first = front * band * section_size;
+      const auto size = std::min(back * band, length) * section_size - first;
+      fits_read_img(f, typecode<typename TRaster::Value>(), first + 1, size, nullptr, out.data() + first, nullptr, &s);
+      fits_close_file(f, &s);
+    });
+    for (auto s : statuses) {
+      if (s != 0) {
+        throw Error("Cannot read file", m_path, s);
+      }
+    }
+    return out;
+  }
+
   /**
    * @brief Write an image as a new FITS file.
+   * @param raster The raster or box patch to be written
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * Rasters are written directly from their data, and box patches of rasters row by row, without copy.
+   * Patches of extrapolators are streamed through a buffer of the size of a row.
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, char mode = 'x')
+  {
+    LINX_TRACE_SCOPE("Fits::write", "Io");
+    int status = 0;
+    fitsfile* fptr = open_to_write(mode);
+    write_image(fptr, raster, status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    fptr = nullptr;
+  }
+
+  /**
+   * @brief Write a tile-compressed image as a new FITS file.
+   * @param raster The raster or box patch to be written
+   * @param compression The compression parameters
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * @see `read(const ParallelPolicy&, Index)` to decompress tiles in parallel
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, const FitsCompression& compression, char mode = 'x')
+  {
+    LINX_TRACE_SCOPE("Fits::write", "Io");
+    int status = 0;
+    fitsfile* fptr = open_to_write(mode);
+    fits_set_compression_type(fptr, compression_type(compression.algorithm), &status);
+    if (not compression.tile.empty()) {
+      auto tile = compression.tile;
+      fits_set_tile_dim(fptr, tile.size(), tile.data(), &status);
+    }
+    fits_set_quantize_level(fptr, compression.quantization, &status);
+    write_image(fptr, raster, status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    fptr = nullptr;
+  }
+
+  /**
+   * @brief Write a raster into a region of an existing image at given (0-based) HDU index.
    * @param raster The raster to be written
+   * @param region The region to be written, of same shape as the raster, in 0-based image coordinates
+   * @param hdu The HDU index
+   *
+   * Only the requested region is written to the file, such that an image can be written tile by tile,
+   * e.g. after having been created with `create()`.
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, const Box<TRaster::Dimension>& region, Index hdu = 0)
+  {
+    LINX_TRACE_SCOPE("Fits::write", "Io");
+    SizeError::may_throw(raster.size(), region.size());
+    int status = 0;
+    fitsfile* fptr = open_hdu(hdu, READWRITE);
+    write_subset(fptr, raster, region, status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    fptr = nullptr;
+  }
+
+  /**
+   * @brief Create an image of given shape without writing its values.
+   * @param shape The image shape
    * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * The values can then be written region by region with `write(raster, region, hdu)`.
+   */
+  template <typename T, Index N>
+  void create(Position<N> shape, char mode = 'x')
+  {
+    int status = 0;
+    fitsfile* fptr = open_to_write(mode);
+    fits_create_img(fptr, image_typecode<T>(), shape.size(), shape.data(), &status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    fptr = nullptr;
+  }
+
+  /**
+   * @brief Write a quantized image as a new FITS file.
+   * @tparam T The integral type of the stored values, e.g. `std::int16_t`
+   * @param raster The raster of physical values to be written
+   * @param bscale The quantization step
+   * @param bzero The physical value of the stored zero
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * The values are quantized in one pass with `quantize_n()`, i.e. rounded and saturated,
+   * and the BSCALE and BZERO keywords are written, such that reading as floating point values
+   * yields the physical values, up to the quantization step.
+   * Quantization is done by Linx instead of CFITSIO, which is faster.
+   */
+  template <typename T, typename TRaster>
+  void write_quantized(const TRaster& raster, double bscale, double bzero = 0, char mode = 'x')
+  {
+    LINX_TRACE_SCOPE("Fits::write", "Io");
+    std::vector<T> quantized(raster.size());
+    quantize_n(raster.data(), raster.size(), quantized.data(), bscale, bzero);
+    int status = 0;
+    fitsfile* fptr = open_to_write(mode);
+    auto shape = raster.shape();
+    fits_create_img(fptr, image_typecode<T>(), raster.dimension(), shape.data(), &status);
+    fits_write_key(fptr, TDOUBLE, "BSCALE", &bscale, nullptr, &status);
+    fits_write_key(fptr, TDOUBLE, "BZERO", &bzero, nullptr, &status);
+    fits_set_bscale(fptr, 1, 0, &status); // Write stored values as is
+    if (raster.size() > 0) {
+      fits_write_img(fptr, typecode<T>(), 1, raster.size(), quantized.data(), &status);
+    }
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    fptr = nullptr;
+  }
+
+  /**
+   * @brief Get the BITPIX of a given type.
+   */
+  template <typename T>
+  static constexpr int bitpix()
+  {
+    if constexpr (std::is_integral_v<T>) {
+      return 8 * static_cast<int>(sizeof(T));
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+      return -8 * static_cast<int>(sizeof(T));
+    }
+    return 0;
+  }
+
+private:
+
+  friend class FitsSession;
+
+  /**
+   * @brief Read the image of the current HDU.
+   */
+  template <typename TRaster>
+  static TRaster read_image(fitsfile* fptr, int& status)
+  {
+    TRaster out(read_shape<TRaster::Dimension>(fptr, status));
+    read_values(fptr, out, status);
+    return out;
+  }
+
+  /**
+   * @brief Read the image shape of the current HDU.
+   */
+  template <Index N>
+  static Position<N> read_shape(fitsfile* fptr, int& status)
+  {
+    int naxis = 0;
+    fits_get_img_dim(fptr, &naxis, &status);
+    Position<N> shape(naxis);
+    fits_get_img_size(fptr, naxis, shape.data(), &status);
+    return shape;
+  }
+
+  /**
+   * @brief Read the values of the image of the current HDU into a raster of the same size.
+   */
+  template <typename TRaster>
+  static void read_values(fitsfile* fptr, TRaster& out, int& status)
+  {
+    if (out.size() > 0) {
+      fits_read_img(fptr, typecode<typename TRaster::Value>(), 1, out.size(), nullptr, out.data(), nullptr, &status);
+    }
+  }
+
+  /**
+   * @brief Read a region of the image of the current HDU.
    */
   template <typename TRaster>
-  void write(TRaster raster, char mode = 'x')
+  static TRaster read_subset(fitsfile* fptr, const Box<TRaster::Dimension>& region, int& status)
+  {
+    auto fpixel = region.front() + 1;
+    auto lpixel = region.back() + 1;
+    auto inc = Position<TRaster::Dimension>::one(fpixel.size());
+    TRaster out(region.shape());
+    if (out.size() > 0) {
+      fits_read_subset(
+          fptr,
+          typecode<typename TRaster::Value>(),
+          fpixel.data(),
+          lpixel.data(),
+          inc.data(),
+          nullptr,
+          out.data(),
+          nullptr,
+          &status);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Create an image HDU and write a raster or box patch.
+   */
+  template <typename TRaster>
+  static void write_image(fitsfile* fptr, const TRaster& raster, int& status)
+  {
+    using Value = std::decay_t<typename TRaster::Value>;
+    auto shape = shape_of(raster);
+    const auto size = shape_size(shape);
+    fits_create_img(fptr, image_typecode<Value>(), shape.size(), shape.data(), &status);
+    if constexpr (not Internal::IsBoxPatch<const TRaster>::value) {
+      if (size > 0) {
+        auto* data = const_cast<Value*>(raster.data()); // Not modified by CFITSIO
+        fits_write_img(fptr, typecode<Value>(), 1, size, data, &status);
+      }
+    } else if constexpr (Internal::HasData<typename TRaster::Parent>::value) {
+      Index first = 1;
+      raster.for_each_row([&](const auto* row, Index length) {
+        fits_write_img(fptr, typecode<Value>(), first, length, const_cast<Value*>(row), &status);
+        first += length;
+      });
+    } else {
+      const Index width = size > 0 ? shape[0] : 0;
+      std::vector<Value> row(width);
+      auto it = raster.begin();
+      for (Index first = 1; first <= size && status == 0; first += width) {
+        for (auto& e : row) {
+          e = *it;
+          ++it;
+        }
+        fits_write_img(fptr, typecode<Value>(), first, width, row.data(), &status);
+      }
+    }
+  }
+
+  /**
+   * @brief Write a raster into a region of the image of the current HDU.
+   */
+  template <typename TRaster>
+  static void write_subset(fitsfile* fptr, const TRaster& raster, const Box<TRaster::Dimension>& region, int& status)
+  {
+    auto fpixel = region.front() + 1;
+    auto lpixel = region.back() + 1;
+    if (raster.size() > 0) {
+      auto* data = const_cast<std::decay_t<typename TRaster::Value>*>(raster.data()); // Not modified by CFITSIO
+      fits_write_subset(fptr, typecode<typename TRaster::Value>(), fpixel.data(), lpixel.data(), data, &status);
+    }
+  }
+
+  /**
+   * @brief Get the shape of a raster or box patch.
+   */
+  template <typename TRaster>
+  static auto shape_of(const TRaster& raster)
+  {
+    if constexpr (Internal::IsBoxPatch<const TRaster>::value) {
+      return raster.box().shape();
+    } else {
+      return raster.shape();
+    }
+  }
+
+  /**
+   * @brief Open the file and move to some (0-based) HDU.
+   * @param iomode `READONLY` or `READWRITE`
+   */
+  fitsfile* open_hdu(Index hdu, int iomode)
+  {
+    FileNotFoundError::may_throw(m_path);
+    int status = 0;
+    fitsfile* fptr;
+    fits_open_file(&fptr, m_path.c_str(), iomode, &status);
+    if (status != 0) {
+      throw FileFormatError("Cannot read file", m_path);
+    }
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    if (status != 0) {
+      int ignored = 0;
+      fits_close_file(fptr, &ignored);
+      throw Error("Cannot move to HDU " + std::to_string(hdu), m_path, status);
+    }
+    return fptr;
+  }
+
+  /**
+   * @brief Open the file for writing according to some mode.
+   */
+  fitsfile* open_to_write(char mode)
   {
     int status = 0;
     fitsfile* fptr;
@@ -123,36 +575,29 @@ public:
     if (status != 0) {
       throw FileFormatError("Cannot write file", m_path);
     }
-    auto shape = raster.shape();
-    fits_create_img(fptr, image_typecode<typename TRaster::Value>(), raster.dimension(), shape.data(), &status);
-    if (raster.size() > 0) {
-      std::vector<std::decay_t<typename TRaster::Value>> nonconst(raster.begin(), raster.end());
-      fits_write_img(fptr, typecode<typename TRaster::Value>(), 1, raster.size(), nonconst.data(), &status);
-    }
-    fits_close_file(fptr, &status);
-    if (status != 0) {
-      throw Error("Cannot write file", m_path, status);
-    }
-    fptr = nullptr;
+    return fptr;
   }
 
   /**
-   * @brief Get the BITPIX of a given type.
+   * @brief Get CFITSIO's compression type.
    */
-  template <typename T>
-  static constexpr int bitpix()
+  static int compression_type(FitsCompression::Algorithm algorithm)
   {
-    if constexpr (std::is_integral_v<T>) {
-      return 8 * static_cast<int>(sizeof(T));
-    }
-    if constexpr (std::is_floating_point_v<T>) {
-      return -8 * static_cast<int>(sizeof(T));
+    switch (algorithm) {
+      case FitsCompression::Algorithm::Rice:
+        return RICE_1;
+      case FitsCompression::Algorithm::Gzip:
+        return GZIP_1;
+      case FitsCompression::Algorithm::ShuffledGzip:
+        return GZIP_2;
+      case FitsCompression::Algorithm::Hcompress:
+        return HCOMPRESS_1;
+      case FitsCompression::Algorithm::Plio:
+        return PLIO_1;
     }
     return 0;
   }
 
-private:
-
   /**
    * @brief Get CFITSIO's typecode.
    */
@@ -226,6 +671,348 @@ private:
   std::filesystem::path m_path;
 };
 
+/**
+ * @brief FITS file handler which keeps the file open across calls.
+ *
+ * As opposed to `Fits`, which opens and closes the file at each call,
+ * a session opens the file at construction and closes it at destruction.
+ * This saves CFITSIO from reopening the file and rescanning its headers
+ * when several HDUs are read or written in sequence:
+ *
+ * \code
+ * FitsSession session("out.fits", 'w');
+ * session.append(data);
+ * for (...) {
+ *   // ...
+ *   session.append(mask);
+ * }
+ * \endcode
+ *
+ * The current HDU is cached, such that consecutive accesses to the same HDU do not move in the file.
+ * CFITSIO's I/O buffers are also kept across calls; their number and size are set at CFITSIO's build time.
+ */
+class FitsSession {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param path The file path
+   * @param mode `r` to read an existing file, `a` to read and write an existing file,
+   * `x` to create a new file, `w` to create or overwrite
+   */
+  explicit FitsSession(const std::filesystem::path& path, char mode = 'r') :
+      m_fits(path), m_fptr(nullptr), m_hdu(0)
+  {
+    switch (mode) {
+      case 'r':
+        m_fptr = m_fits.open_hdu(0, READONLY);
+        break;
+      case 'a':
+        m_fptr = m_fits.open_hdu(0, READWRITE);
+        break;
+      default:
+        m_fptr = m_fits.open_to_write(mode);
+        m_hdu = -1;
+    }
+  }
+
+  /**
+   * @brief Non-copyable.
+   */
+  FitsSession(const FitsSession&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  FitsSession& operator=(const FitsSession&) = delete;
+
+  /**
+   * @brief Destructor, which closes the file.
+   *
+   * Errors are not reported, call `close()` explicitly to check them.
+   */
+  ~FitsSession()
+  {
+    if (m_fptr) {
+      int status = 0;
+      fits_close_file(m_fptr, &status);
+    }
+  }
+
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_fits.path();
+  }
+
+  /**
+   * @brief Get the number of HDUs.
+   */
+  Index hdu_count() const
+  {
+    int status = 0;
+    int count = 0;
+    fits_get_num_hdus(m_fptr, &count, &status);
+    may_throw("Cannot count HDUs", status);
+    return count;
+  }
+
+  /**
+   * @brief Read an image at given (0-based) HDU index.
+   */
+  template <typename TRaster>
+  TRaster read(Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    auto out = Fits::read_image<TRaster>(m_fptr, status);
+    may_throw("Cannot read file", status);
+    return out;
+  }
+
+  /**
+   * @brief Read a region of an image at given (0-based) HDU index.
+   */
+  template <typename TRaster>
+  TRaster read(const Box<TRaster::Dimension>& region, Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    auto out = Fits::read_subset<TRaster>(m_fptr, region, status);
+    may_throw("Cannot read file", status);
+    return out;
+  }
+
+  /**
+   * @brief Append an image HDU.
+   * @param raster The raster or box patch to be written
+   * @return The index of the new HDU
+   */
+  template <typename TRaster>
+  Index append(const TRaster& raster)
+  {
+    int status = 0;
+    Fits::write_image(m_fptr, raster, status);
+    int hdu = 0;
+    fits_get_hdu_num(m_fptr, &hdu);
+    m_hdu = hdu - 1;
+    may_throw("Cannot write file", status);
+    return m_hdu;
+  }
+
+  /**
+   * @brief Write a raster into a region of an existing image at given (0-based) HDU index.
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, const Box<TRaster::Dimension>& region, Index hdu = 0)
+  {
+    SizeError::may_throw(raster.size(), region.size());
+    move_to(hdu);
+    int status = 0;
+    Fits::write_subset(m_fptr, raster, region, status);
+    may_throw("Cannot write file", status);
+  }
+
+  /**
+   * @brief Get the shape of an image at given (0-based) HDU index.
+   */
+  template <Index N = 2>
+  Position<N> shape(Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    auto out = Fits::read_shape<N>(m_fptr, status);
+    may_throw("Cannot read file", status);
+    return out;
+  }
+
+  /**
+   * @brief Get the BITPIX of an image at given (0-based) HDU index.
+   */
+  int bitpix(Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    int out = 0;
+    fits_get_img_type(m_fptr, &out, &status);
+    may_throw("Cannot read file", status);
+    return out;
+  }
+
+  /**
+   * @brief Get the offset of the data unit of an image at given (0-based) HDU index, in bytes.
+   *
+   * The image must be uncompressed and unscaled, i.e. values are stored raw, in big endian, from this offset.
+   */
+  Index data_offset(Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    int compressed = fits_is_compressed_image(m_fptr, &status);
+    int type = 0;
+    int equivalent_type = 0;
+    fits_get_img_type(m_fptr, &type, &status);
+    fits_get_img_equivtype(m_fptr, &equivalent_type, &status);
+    LONGLONG header = 0;
+    LONGLONG data = 0;
+    LONGLONG end = 0;
+    fits_get_hduaddrll(m_fptr, &header, &data, &end, &status);
+    may_throw("Cannot read file", status);
+    if (compressed || type != equivalent_type) {
+      throw FileFormatError("Image HDU " + std::to_string(hdu) + " is compressed or scaled", path());
+    }
+    return data;
+  }
+
+  /**
+   * @brief Read an image at given (0-based) HDU index into an existing raster of same shape.
+   */
+  template <typename TRaster>
+  void read_to(TRaster& out, Index hdu = 0)
+  {
+    const auto shape = this->shape<TRaster::Dimension>(hdu);
+    SizeError::may_throw(out.shape().size(), shape.size());
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+      SizeError::may_throw(out.shape()[i], shape[i]);
+    }
+    int status = 0;
+    Fits::read_values(m_fptr, out, status);
+    may_throw("Cannot read file", status);
+  }
+
+  /**
+   * @brief Read consecutive values of an image at given (0-based) HDU index.
+   * @param data The output buffer
+   * @param first The (0-based) index of the first value in the image
+   * @param size The number of values
+   * @param hdu The HDU index
+   */
+  template <typename T>
+  void read_n(T* data, Index first, Index size, Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    if (size > 0) {
+      fits_read_img(m_fptr, Fits::typecode<T>(), first + 1, size, nullptr, data, nullptr, &status);
+    }
+    may_throw("Cannot read file", status);
+  }
+
+  /**
+   * @brief Append an image HDU without writing its values.
+   * @return The index of the new HDU
+   */
+  template <typename T, Index N>
+  Index create(Position<N> shape)
+  {
+    int status = 0;
+    fits_create_img(m_fptr, Fits::image_typecode<T>(), shape.size(), shape.data(), &status);
+    int hdu = 0;
+    fits_get_hdu_num(m_fptr, &hdu);
+    m_hdu = hdu - 1;
+    may_throw("Cannot write file", status);
+    return m_hdu;
+  }
+
+  /**
+   * @brief Write consecutive values of an image at given (0-based) HDU index.
+   * @param data The input values
+   * @param first The (0-based) index of the first value in the image
+   * @param size The number of values
+   * @param hdu The HDU index
+   */
+  template <typename T>
+  void write_n(const T* data, Index first, Index size, Index hdu = 0)
+  {
+    move_to(hdu);
+    int status = 0;
+    if (size > 0) {
+      auto* values = const_cast<T*>(data); // Not modified by CFITSIO
+      fits_write_img(m_fptr, Fits::typecode<T>(), first + 1, size, values, &status);
+    }
+    may_throw("Cannot write file", status);
+  }
+
+  /**
+   * @brief Close the file.
+   */
+  void close()
+  {
+    if (not m_fptr) {
+      return;
+    }
+    int status = 0;
+    fits_close_file(m_fptr, &status);
+    m_fptr = nullptr;
+    may_throw("Cannot close file", status);
+  }
+
+private:
+
+  /**
+   * @brief Move to some (0-based) HDU unless it is the current one.
+   */
+  void move_to(Index hdu)
+  {
+    if (hdu == m_hdu) {
+      return;
+    }
+    int status = 0;
+    fits_movabs_hdu(m_fptr, hdu + 1, nullptr, &status);
+    may_throw("Cannot move to HDU " + std::to_string(hdu), status);
+    m_hdu = hdu;
+  }
+
+  /**
+   * @brief Throw a `Fits::Error` if the status is not null.
+   */
+  void may_throw(const std::string& context, int status) const
+  {
+    if (status != 0) {
+      throw Fits::Error(context, path(), status);
+    }
+  }
+
+  /**
+   * @brief The file handler, for path and opening.
+   */
+  Fits m_fits;
+
+  /**
+   * @brief The CFITSIO file pointer.
+   */
+  fitsfile* m_fptr;
+
+  /**
+   * @brief The current HDU index, or -1 if none.
+   */
+  Index m_hdu;
+};
+
+inline Index Fits::hdu_count() const
+{
+  return FitsSession(m_path).hdu_count();
+}
+
+template <Index N>
+Position<N> Fits::shape(Index hdu) const
+{
+  return FitsSession(m_path).shape<N>(hdu);
+}
+
+inline int Fits::bitpix(Index hdu) const
+{
+  return FitsSession(m_path).bitpix(hdu);
+}
+
+template <typename TRaster>
+void Fits::read_to(TRaster& out, Index hdu) const
+{
+  FitsSession(m_path).read_to(out, hdu);
+}
+
 } // namespace Linx
 
 #endif
@@ -0,0 +1,206 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_FITSMAPPING_H
+#define _LINXIO_FITSMAPPING_H
+
+#include "Linx/Base/MmapHolder.h"
+#include "Linx/Io/Fits.h"
+
+#include <cstdint>
+#include <cstring> // memcpy
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether the host is little endian, i.e. whether FITS values must be byte-swapped.
+ */
+constexpr bool is_little_endian()
+{
+  return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+}
+
+/**
+ * @brief Reverse the byte order of consecutive values in place.
+ */
+template <typename T>
+void byteswap_n(T* data, Index size)
+{
+  if constexpr (sizeof(T) == 2) {
+    using U = std::uint16_t;
+    for (Index i = 0; i < size; ++i) {
+      U u;
+      std::memcpy(&u, data + i, sizeof(U));
+      u = __builtin_bswap16(u);
+      std::memcpy(data + i, &u, sizeof(U));
+    }
+  } else if constexpr (sizeof(T) == 4) {
+    using U = std::uint32_t;
+    for (Index i = 0; i < size; ++i) {
+      U u;
+      std::memcpy(&u, data + i, sizeof(U));
+      u = __builtin_bswap32(u);
+      std::memcpy(data + i, &u, sizeof(U));
+    }
+  } else if constexpr (sizeof(T) == 8) {
+    using U = std::uint64_t;
+    for (Index i = 0; i < size; ++i) {
+      U u;
+      std::memcpy(&u, data + i, sizeof(U));
+      u = __builtin_bswap64(u);
+      std::memcpy(data + i, &u, sizeof(U));
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief Memory-mapped view of an uncompressed FITS image HDU.
+ * @tparam T The value type, which must match the BITPIX of the image
+ * @tparam N The image dimension
+ *
+ * The data unit of the HDU is mapped to memory in `MmapMode::CopyOnWrite`, such that pages are loaded on demand
+ * and the file is never modified.
+ * FITS values are big endian: on little-endian hosts, they are byte-swapped lazily and in place, section by section
+ * (i.e. along the last axis), when first accessed.
+ * Therefore, reading a small region of a huge image involves neither a full read nor a copy by CFITSIO:
+ *
+ * \code
+ * FitsMapping<float, 3> cube("cube.fits");
+ * auto roi = cube(Box<3>({100, 200, 50}, {131, 231, 51})); // Only sections 50 and 51 are swapped
+ * process(roi);
+ * \endcode
+ *
+ * Only images which are stored raw can be mapped, i.e. neither tile-compressed nor scaled with BSCALE or BZERO
+ * (which includes unsigned integers of 16 bits or more).
+ * Lazy swapping mutates the mapping, such that accesses should not be concurrent,
+ * unless `raster()` is called first to swap all the values.
+ *
+ * @see `MmapRaster`
+ */
+template <typename T, Index N = 2>
+class FitsMapping {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param path The file path
+   * @param hdu The (0-based) HDU index
+   */
+  explicit FitsMapping(const std::filesystem::path& path, Index hdu = 0) : m_raster(), m_swapped()
+  {
+    FitsSession session(path);
+    const auto bitpix = session.bitpix(hdu);
+    if (bitpix != Fits::bitpix<T>()) {
+      throw FileFormatError("Cannot map BITPIX " + std::to_string(bitpix) + " values", path);
+    }
+    const auto shape = session.template shape<N>(hdu);
+    const auto offset = session.data_offset(hdu);
+    session.close();
+    m_raster = MmapRaster<T, N>(shape, path.string(), MmapMode::CopyOnWrite, offset);
+    m_swapped.assign(shape.size() > 0 ? shape[shape.size() - 1] : 0, not Internal::is_little_endian());
+  }
+
+  /**
+   * @brief Get the image shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_raster.shape();
+  }
+
+  /**
+   * @brief Get the value at given position.
+   */
+  const T& operator[](const Position<N>& position)
+  {
+    swap(position[position.size() - 1]);
+    return m_raster[position];
+  }
+
+  /**
+   * @brief Get the section at given index.
+   */
+  auto section(Index index)
+  {
+    swap(index);
+    return m_raster.section(index);
+  }
+
+  /**
+   * @brief Get a patch of the image over some region.
+   */
+  auto operator()(const Box<N>& region)
+  {
+    const auto last = region.size() - 1;
+    swap(region.front()[last], region.back()[last]);
+    return m_raster(region);
+  }
+
+  /**
+   * @brief Get the whole image, after swapping all the values.
+   */
+  MmapRaster<T, N>& raster()
+  {
+    if (not m_swapped.empty()) {
+      swap(0, m_swapped.size() - 1);
+    }
+    return m_raster;
+  }
+
+  /**
+   * @brief Advise the OS about the access pattern to some sections.
+   */
+  void advise(MmapAdvice advice, Index front, Index back) const
+  {
+    const auto section_size = shape_size(shape()) / std::max<Index>(m_swapped.size(), 1);
+    m_raster.advise(advice, front * section_size, (back - front + 1) * section_size);
+  }
+
+private:
+
+  /**
+   * @brief Swap the values of a section if not done yet.
+   */
+  void swap(Index index)
+  {
+    swap(index, index);
+  }
+
+  /**
+   * @brief Swap the values of a range of sections if not done yet.
+   */
+  void swap(Index front, Index back)
+  {
+    OutOfBoundsError::may_throw("Section index: ", front, {0, static_cast<Index>(m_swapped.size()) - 1});
+    OutOfBoundsError::may_throw("Section index: ", back, {front, static_cast<Index>(m_swapped.size()) - 1});
+    const auto section_size = shape_size(shape()) / static_cast<Index>(m_swapped.size());
+    for (auto i = front; i <= back; ++i) {
+      if (not m_swapped[i]) {
+        Internal::byteswap_n(m_raster.data() + i * section_size, section_size);
+        m_swapped[i] = true;
+      }
+    }
+  }
+
+  /**
+   * @brief The mapped raster.
+   */
+  MmapRaster<T, N> m_raster;
+
+  /**
+   * @brief The byte-swapping status of each section.
+   */
+  std::vector<bool> m_swapped;
+};
+
+} // namespace Linx
+
+#endif
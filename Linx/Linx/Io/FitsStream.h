@@ -0,0 +1,308 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_FITSSTREAM_H
+#define _LINXIO_FITSSTREAM_H
+
+#include "Linx/Io/Fits.h"
+
+#include <algorithm> // min
+#include <utility> // swap
+
+namespace Linx {
+
+/**
+ * @brief Streaming reader of an image HDU, chunk by chunk.
+ * @tparam T The value type
+ * @tparam N The image dimension
+ *
+ * The image is sliced along its last axis into chunks of given thickness, like with `chunks()`,
+ * except for the last chunk which may be thinner.
+ * Chunks are read one at a time into a reusable raster, such that memory is bounded by the size of a chunk.
+ * For example, a thickness of 1 streams the sections of a cube, or the rows of an image:
+ *
+ * \code
+ * FitsChunkReader<float, 3> reader("cube.fits");
+ * while (reader.next()) {
+ *   process(reader.chunk()); // Plane at position reader.domain().front()
+ * }
+ * \endcode
+ *
+ * @see `FitsChunkWriter`
+ */
+template <typename T, Index N = 2>
+class FitsChunkReader {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param path The file path
+   * @param thickness The number of sections per chunk
+   * @param hdu The (0-based) HDU index
+   */
+  explicit FitsChunkReader(const std::filesystem::path& path, Index thickness = 1, Index hdu = 0) :
+      m_session(path), m_hdu(hdu), m_shape(m_session.template shape<N>(hdu)), m_thickness(thickness), m_next(0),
+      m_domain(), m_chunk()
+  {
+    OutOfBoundsError::may_throw("Chunk thickness: ", m_thickness, {1, std::numeric_limits<Index>::max()});
+  }
+
+  /**
+   * @brief Get the image shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the nominal chunk thickness.
+   */
+  Index thickness() const
+  {
+    return m_thickness;
+  }
+
+  /**
+   * @brief Read the next chunk.
+   * @return False if all chunks have already been read
+   */
+  bool next()
+  {
+    const auto last = m_shape.size() - 1;
+    const auto begin = m_next;
+    if (begin >= m_shape[last]) {
+      return false;
+    }
+    auto chunk_shape = m_shape;
+    chunk_shape[last] = std::min(m_thickness, m_shape[last] - begin);
+    if (chunk_shape != m_chunk.shape()) {
+      m_chunk = Raster<T, N>(chunk_shape); // Only for the first and last chunks
+    }
+    auto front = Position<N>::zero(m_shape.size());
+    front[last] = begin;
+    m_domain = Box<N>::from_shape(front, chunk_shape);
+    const auto section_size = shape_size(m_shape) / m_shape[last];
+    m_session.read_n(m_chunk.data(), begin * section_size, m_chunk.size(), m_hdu);
+    m_next += chunk_shape[last];
+    return true;
+  }
+
+  /**
+   * @brief Get the domain of the current chunk in the image.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /**
+   * @brief Get the current chunk.
+   */
+  const Raster<T, N>& chunk() const
+  {
+    return m_chunk;
+  }
+
+  /**
+   * @copydoc chunk()
+   */
+  Raster<T, N>& chunk()
+  {
+    return m_chunk;
+  }
+
+private:
+
+  /**
+   * @brief The file session.
+   */
+  FitsSession m_session;
+
+  /**
+   * @brief The HDU index.
+   */
+  Index m_hdu;
+
+  /**
+   * @brief The image shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The nominal chunk thickness.
+   */
+  Index m_thickness;
+
+  /**
+   * @brief The index of the next section to be read.
+   */
+  Index m_next;
+
+  /**
+   * @brief The domain of the current chunk.
+   */
+  Box<N> m_domain;
+
+  /**
+   * @brief The chunk buffer.
+   */
+  Raster<T, N> m_chunk;
+};
+
+/**
+ * @brief Streaming writer of an image HDU, chunk by chunk.
+ * @tparam T The value type
+ * @tparam N The image dimension
+ *
+ * The image HDU is created in advance with its final shape, and values are then appended incrementally,
+ * e.g. one section or one band of rows at a time.
+ * Chunks are contiguous rasters whose shape equals that of the image except along the last axis:
+ *
+ * \code
+ * FitsChunkReader<float, 3> reader("in.fits", 4);
+ * FitsChunkWriter<float, 3> writer("out.fits", reader.shape());
+ * while (reader.next()) {
+ *   writer.write(filter * extrapolation(reader.chunk()));
+ * }
+ * \endcode
+ *
+ * @see `FitsChunkReader`
+ */
+template <typename T, Index N = 2>
+class FitsChunkWriter {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param path The file path
+   * @param shape The image shape
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   */
+  FitsChunkWriter(const std::filesystem::path& path, Position<N> shape, char mode = 'x') :
+      m_session(path, mode), m_hdu(m_session.template create<T>(shape)), m_shape(LINX_MOVE(shape)), m_next(0)
+  {}
+
+  /**
+   * @brief Get the image shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the number of values written so far.
+   */
+  Index written() const
+  {
+    return m_next;
+  }
+
+  /**
+   * @brief Check whether the whole image has been written.
+   */
+  bool done() const
+  {
+    return m_next == shape_size(m_shape);
+  }
+
+  /**
+   * @brief Append a chunk.
+   * @param chunk A raster or box patch of a raster, e.g. from `chunks()`,
+   * of shape equal to that of the image except along the last axis
+   *
+   * Patches are written row by row, without copy.
+   */
+  template <typename TRaster>
+  void write(const TRaster& chunk)
+  {
+    constexpr bool is_patch = Internal::IsBoxPatch<const TRaster>::value;
+    Position<N> chunk_shape;
+    if constexpr (is_patch) {
+      chunk_shape = chunk.box().shape();
+    } else {
+      chunk_shape = chunk.shape();
+    }
+    const auto last = static_cast<Index>(m_shape.size()) - 1;
+    for (Index i = 0; i < last; ++i) {
+      SizeError::may_throw(chunk_shape[i], m_shape[i]);
+    }
+    const auto size = shape_size(chunk_shape);
+    OutOfBoundsError::may_throw("Chunk end: ", m_next + size, {0, shape_size(m_shape)});
+    if constexpr (is_patch) {
+      auto first = m_next;
+      chunk.for_each_row([&](const auto* row, Index length) {
+        m_session.write_n(row, first, length, m_hdu);
+        first += length;
+      });
+    } else {
+      m_session.write_n(chunk.data(), m_next, size, m_hdu);
+    }
+    m_next += size;
+  }
+
+  /**
+   * @brief Close the file.
+   */
+  void close()
+  {
+    m_session.close();
+  }
+
+private:
+
+  /**
+   * @brief The file session.
+   */
+  FitsSession m_session;
+
+  /**
+   * @brief The HDU index.
+   */
+  Index m_hdu;
+
+  /**
+   * @brief The image shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The index of the next value to be written.
+   */
+  Index m_next;
+};
+
+/**
+ * @brief Make a `SectionStream` source which reads the chunks of a FITS image.
+ * @param reader The reader, whose thickness must be that of the stream
+ *
+ * Chunk buffers are swapped with that of the reader, such that values are not copied.
+ */
+template <typename T, Index N>
+auto chunk_source(FitsChunkReader<T, N>& reader)
+{
+  return [&](const Box<N>&, Raster<T, N>& chunk) {
+    if (not reader.next()) {
+      throw Exception("Cannot read chunk: end of image reached");
+    }
+    SizeError::may_throw(reader.chunk().size(), chunk.size());
+    std::swap(reader.chunk(), chunk);
+  };
+}
+
+/**
+ * @brief Make a `SectionStream` sink which writes the chunks of a FITS image.
+ */
+template <typename T, Index N>
+auto chunk_sink(FitsChunkWriter<T, N>& writer)
+{
+  return [&](const Box<N>&, const auto& chunk) {
+    writer.write(chunk);
+  };
+}
+
+} // namespace Linx
+
+#endif
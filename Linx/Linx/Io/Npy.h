@@ -0,0 +1,355 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXIO_NPY_H
+#define _LINXIO_NPY_H
+
+#include "Linx/Base/MmapHolder.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <algorithm> // copy
+#include <complex>
+#include <cstdint>
+#include <cstdlib> // aligned_alloc, free
+#include <cstring> // memcpy
+#include <fcntl.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief Minimal NumPy `.npy` reader/writer, for fast spilling and reloading of intermediate rasters.
+ *
+ * Values are stored raw, in native endianness, after a header of one page, such that the data is page-aligned.
+ * Rasters are stored in Fortran order, i.e. the `.npy` shape is that of the raster,
+ * and the file can be loaded as is with `numpy.load()`, or memory-mapped with `numpy.load(mmap_mode='r')`.
+ *
+ * Compared to `Fits`, there is neither byte swapping nor header parsing beyond the type and shape.
+ * Writing is done with a single system call from `Raster::data()`, optionally bypassing the page cache,
+ * and reading can be done through a memory mapping:
+ *
+ * \code
+ * Npy("/tmp/step1.npy").write(raster, 'w', Npy::Access::Direct);
+ * ...
+ * auto mapped = Npy("/tmp/step1.npy").map<float, 2>(); // Loaded on demand
+ * \endcode
+ */
+class Npy {
+public:
+
+  /**
+   * @brief The access mode of the data.
+   */
+  enum class Access {
+    Buffered, ///< Through the page cache
+    Direct ///< Bypassing the page cache with `O_DIRECT` where possible, i.e. for aligned data
+  };
+
+  /**
+   * @brief The header size, in bytes, which is a multiple of the page size of common systems.
+   */
+  static constexpr Index header_size = 4096;
+
+  /**
+   * @brief Constructor.
+   */
+  Npy(const std::filesystem::path& path) : m_path(path) {}
+
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Get the `.npy` type descriptor of a value type, e.g. `<f4` for `float` on little-endian hosts.
+   */
+  template <typename T>
+  static std::string dtype()
+  {
+    using V = std::remove_cv_t<T>;
+    const char endianness = sizeof(V) == 1 ? '|' : (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? '<' : '>');
+    char kind = 0;
+    if constexpr (std::is_same_v<V, bool>) {
+      kind = 'b';
+    } else if constexpr (std::is_floating_point_v<V>) {
+      kind = 'f';
+    } else if constexpr (std::is_integral_v<V>) {
+      kind = std::is_signed_v<V> ? 'i' : 'u';
+    } else if constexpr (std::is_same_v<V, std::complex<float>> || std::is_same_v<V, std::complex<double>>) {
+      kind = 'c';
+    } else {
+      static_assert(sizeof(V) == 0, "Unsupported .npy value type.");
+    }
+    return std::string {endianness, kind} + std::to_string(sizeof(V));
+  }
+
+  /**
+   * @brief Read the type descriptor.
+   */
+  std::string dtype() const
+  {
+    return read_header().dtype;
+  }
+
+  /**
+   * @brief Read the shape.
+   */
+  template <Index N = 2>
+  Position<N> shape() const
+  {
+    const auto header = read_header();
+    auto out = make_shape<N>(header);
+    return out;
+  }
+
+  /**
+   * @brief Read a raster.
+   *
+   * The values are read with a single system call into the raster data.
+   */
+  template <typename TRaster>
+  TRaster read() const
+  {
+    using T = typename TRaster::Value;
+    const auto header = read_header();
+    check_dtype<T>(header);
+    auto shape = make_shape<TRaster::Dimension>(header);
+    TRaster out(shape);
+    File file(m_path, O_RDONLY);
+    read_all(file.fd, reinterpret_cast<char*>(out.data()), out.size() * sizeof(T), header_size);
+    return out;
+  }
+
+  /**
+   * @brief Map a raster to memory.
+   * @param mode The mapping mode, e.g. `MmapMode::ReadWrite` to modify the file in place
+   */
+  template <typename T, Index N = 2>
+  MmapRaster<T, N> map(MmapMode mode = MmapMode::ReadOnly) const
+  {
+    const auto header = read_header();
+    check_dtype<T>(header);
+    auto shape = make_shape<N>(header);
+    return MmapRaster<T, N>(shape, m_path.string(), mode, header_size);
+  }
+
+  /**
+   * @brief Write a raster.
+   * @param raster The raster
+   * @param mode `x` to create a new file, `w` to create or overwrite
+   * @param access The access mode
+   *
+   * In `Access::Direct`, the page-aligned part of the data is written without copy, bypassing the page cache,
+   * and the remaining bytes, if any, are written through the cache.
+   * If the data is not aligned or the file system does not support `O_DIRECT`, writing falls back to buffered access.
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, char mode = 'x', Access access = Access::Buffered) const
+  {
+    using T = std::remove_cv_t<typename TRaster::Value>;
+    if (mode == 'x') {
+      PathExistsError::may_throw(m_path);
+    }
+    auto buffer = std::unique_ptr<char, void (*)(void*)>(
+        static_cast<char*>(std::aligned_alloc(header_size, header_size)),
+        &std::free); // Aligned for O_DIRECT
+    const auto header = make_header(dtype<T>(), raster.shape());
+    std::memcpy(buffer.get(), header.data(), header.size());
+
+    const auto* data = reinterpret_cast<const char*>(raster.data());
+    const auto size = static_cast<Index>(raster.size() * sizeof(T));
+    const bool aligned = reinterpret_cast<std::uintptr_t>(data) % header_size == 0;
+    const auto direct_size = aligned ? size / header_size * header_size : 0;
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+    if (access == Access::Direct && direct_size > 0) {
+      const int fd = ::open(m_path.c_str(), flags | O_DIRECT, 0644);
+      if (fd >= 0) {
+        File file(fd);
+        write_all(file.fd, buffer.get(), header_size, 0);
+        write_all(file.fd, data, direct_size, header_size);
+        ::fcntl(file.fd, F_SETFL, ::fcntl(file.fd, F_GETFL) & ~O_DIRECT); // For the unaligned tail
+        write_all(file.fd, data + direct_size, size - direct_size, header_size + direct_size);
+        file.close(m_path);
+        return;
+      }
+    }
+#endif
+    File file(m_path, flags);
+    write_all(file.fd, buffer.get(), header_size, 0);
+    write_all(file.fd, data, size, header_size);
+    file.close(m_path);
+  }
+
+private:
+
+  /**
+   * @brief The parsed header.
+   */
+  struct Header {
+    std::string dtype;
+    std::vector<Index> shape;
+  };
+
+  /**
+   * @brief A POSIX file descriptor, which is closed by the destructor.
+   */
+  struct File {
+    explicit File(int descriptor) : fd(descriptor) {}
+    File(const std::filesystem::path& path, int flags) : fd(::open(path.c_str(), flags, 0644))
+    {
+      if (fd < 0) {
+        throw FileFormatError("Cannot open file", path);
+      }
+    }
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+    ~File()
+    {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+    void close(const std::filesystem::path& path)
+    {
+      const int status = ::close(fd);
+      fd = -1;
+      if (status != 0) {
+        throw FileFormatError("Cannot close file", path);
+      }
+    }
+    int fd;
+  };
+
+  /**
+   * @brief Make the padded header.
+   */
+  template <typename TShape>
+  static std::string make_header(const std::string& dtype, const TShape& shape)
+  {
+    std::string dict = "{'descr': '" + dtype + "', 'fortran_order': True, 'shape': (";
+    for (auto l : shape) {
+      dict += std::to_string(l) + ", ";
+    }
+    dict += "), }";
+    const auto prefix = std::string("\x93NUMPY\x01\x00", 8);
+    const auto length = header_size - static_cast<Index>(prefix.size()) - 2;
+    dict.resize(length - 1, ' ');
+    dict += '\n';
+    const char length_bytes[] = {static_cast<char>(length & 0xFF), static_cast<char>(length >> 8)};
+    return prefix + std::string(length_bytes, 2) + dict;
+  }
+
+  /**
+   * @brief Read and parse the header.
+   */
+  Header read_header() const
+  {
+    FileNotFoundError::may_throw(m_path);
+    std::string buffer(header_size, '\0');
+    File file(m_path, O_RDONLY);
+    const auto count = ::pread(file.fd, buffer.data(), header_size, 0);
+    if (count < 10 || buffer.compare(0, 6, "\x93NUMPY") != 0) {
+      throw FileFormatError("Not a .npy file", m_path);
+    }
+    const auto length = static_cast<unsigned char>(buffer[8]) | static_cast<unsigned char>(buffer[9]) << 8;
+    if (buffer[6] != 1 || length + 10 != header_size) {
+      throw FileFormatError("Unsupported .npy header; only Linx-written files can be read", m_path);
+    }
+    const auto dict = buffer.substr(10, length);
+    const auto value = [&](const std::string& key) {
+      const auto pos = dict.find("'" + key + "': ");
+      if (pos == std::string::npos) {
+        throw FileFormatError("Missing .npy key: " + key, m_path);
+      }
+      return pos + key.size() + 4;
+    };
+    Header out;
+    const auto descr = value("descr") + 1;
+    out.dtype = dict.substr(descr, dict.find('\'', descr) - descr);
+    if (dict.compare(value("fortran_order"), 4, "True") != 0) {
+      throw FileFormatError("Unsupported .npy C order", m_path);
+    }
+    const auto* it = dict.c_str() + value("shape") + 1;
+    char* end = nullptr;
+    for (auto l = std::strtol(it, &end, 10); end != it; l = std::strtol(it, &end, 10)) {
+      out.shape.push_back(l);
+      it = end + 1; // Skip comma
+    }
+    return out;
+  }
+
+  /**
+   * @brief Convert the shape of a header to a position.
+   */
+  template <Index N>
+  static Position<N> make_shape(const Header& header)
+  {
+    Position<N> out(N == -1 ? static_cast<Index>(header.shape.size()) : N);
+    SizeError::may_throw(header.shape.size(), out.size());
+    std::copy(header.shape.begin(), header.shape.end(), out.begin());
+    return out;
+  }
+
+  /**
+   * @brief Check that the type descriptor matches some value type.
+   */
+  template <typename T>
+  void check_dtype(const Header& header) const
+  {
+    if (header.dtype != dtype<T>()) {
+      throw FileFormatError("Cannot read " + header.dtype + " values as " + dtype<T>(), m_path);
+    }
+  }
+
+  /**
+   * @brief Read some bytes at given offset, looping over partial reads.
+   */
+  void read_all(int fd, char* data, Index size, Index offset) const
+  {
+    while (size > 0) {
+      const auto count = ::pread(fd, data, size, offset);
+      if (count <= 0) {
+        throw FileFormatError("Cannot read file", m_path);
+      }
+      data += count;
+      size -= count;
+      offset += count;
+    }
+  }
+
+  /**
+   * @brief Write some bytes at given offset, looping over partial writes.
+   */
+  void write_all(int fd, const char* data, Index size, Index offset) const
+  {
+    while (size > 0) {
+      const auto count = ::pwrite(fd, data, size, offset);
+      if (count <= 0) {
+        throw FileFormatError("Cannot write file", m_path);
+      }
+      data += count;
+      size -= count;
+      offset += count;
+    }
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
+};
+
+} // namespace Linx
+
+#endif
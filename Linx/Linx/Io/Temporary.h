@@ -5,11 +5,108 @@
 #ifndef _LINXIO_TEMPORARY_H
 #define _LINXIO_TEMPORARY_H
 
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <atomic>
+#include <fcntl.h>
 #include <filesystem>
 #include <string>
+#include <sys/mman.h> // memfd_create
+#include <system_error>
+#include <unistd.h>
+#include <vector>
 
 namespace Linx {
 
+/**
+ * @brief Scratch storage locations.
+ */
+enum class ScratchLocation {
+  Memory, ///< Anonymous RAM-backed file created with `memfd_create()`, for buffers only
+  Shm, ///< RAM-backed file system `/dev/shm`
+  Temporary ///< Directory given by `std::filesystem::temp_directory_path()`, which may be on disk or network
+};
+
+/**
+ * @brief Placement policy of scratch files.
+ *
+ * Locations are tried in order, and the first one which is supported, has enough available space,
+ * and fits in the budget in the case of RAM-backed locations, is selected.
+ *
+ * \code
+ * ScratchPolicy policy {{ScratchLocation::Memory, ScratchLocation::Shm, ScratchLocation::Temporary}, 1L << 30};
+ * TemporaryBuffer buffer("tile", size, policy); // In RAM while less than 1 GB is used by buffers
+ * \endcode
+ */
+struct ScratchPolicy {
+  /**
+   * @brief The locations, in fallback order.
+   */
+  std::vector<ScratchLocation> order = {ScratchLocation::Temporary};
+
+  /**
+   * @brief The maximum number of bytes used by the buffers of the process in RAM-backed locations, or -1 for no limit.
+   */
+  Index budget = -1;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The number of bytes used by the buffers of the process in RAM-backed locations.
+ */
+inline std::atomic<Index>& scratch_usage()
+{
+  static std::atomic<Index> out(0);
+  return out;
+}
+
+/**
+ * @brief Get the directory of a location, or an empty path if the location is not a directory or does not exist.
+ */
+inline std::filesystem::path scratch_directory(ScratchLocation location)
+{
+  std::error_code ec;
+  switch (location) {
+    case ScratchLocation::Shm:
+      return std::filesystem::is_directory("/dev/shm", ec) ? "/dev/shm" : "";
+    case ScratchLocation::Temporary:
+      return std::filesystem::temp_directory_path();
+    default:
+      return "";
+  }
+}
+
+/**
+ * @brief Check whether a directory has some available space.
+ */
+inline bool has_space(const std::filesystem::path& directory, Index size)
+{
+  std::error_code ec;
+  const auto info = std::filesystem::space(directory, ec);
+  return not ec && static_cast<Index>(info.available) >= size;
+}
+
+/**
+ * @brief Try to reserve some bytes of the RAM budget.
+ */
+inline bool reserve_scratch(Index size, Index budget)
+{
+  auto& usage = scratch_usage();
+  auto current = usage.load();
+  do {
+    if (budget >= 0 && current + size > budget) {
+      return false;
+    }
+  } while (not usage.compare_exchange_weak(current, current + size));
+  return true;
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @brief A path which is removed at destruction.
  */
@@ -18,14 +115,35 @@ public:
 
   /**
    * @brief Constructor.
-   * 
+   *
    * The path is in a suitable temporary directory.
    */
   explicit TemporaryPath(std::string name) : m_path(std::filesystem::temp_directory_path() / name) {}
 
+  /**
+   * @brief Constructor with placement policy.
+   * @param name The file name
+   * @param policy The placement policy
+   * @param size The expected file size, in bytes
+   *
+   * The path is in the first directory of the policy which has at least `size` bytes available.
+   * `ScratchLocation::Memory` is skipped since it has no path, and the budget is not checked since the file may grow.
+   */
+  TemporaryPath(std::string name, const ScratchPolicy& policy, Index size = 0) : m_path()
+  {
+    for (auto location : policy.order) {
+      const auto directory = Internal::scratch_directory(location);
+      if (not directory.empty() && Internal::has_space(directory, size)) {
+        m_path = directory / name;
+        return;
+      }
+    }
+    throw Exception("No scratch location available for " + name);
+  }
+
   /**
    * @brief Destructor.
-   * 
+   *
    * Removes the path.
    */
   virtual ~TemporaryPath()
@@ -51,6 +169,168 @@ private:
   std::filesystem::path m_path;
 };
 
+/**
+ * @brief A scratch file of fixed size, which is removed at destruction.
+ *
+ * The file is created in the first location of the policy which is supported and has enough room,
+ * such that scratch I/O of out-of-core processing can be kept in RAM and off the network.
+ * Whatever the location, the file can be accessed through its descriptor or its path,
+ * e.g. to be memory-mapped as a raster:
+ *
+ * \code
+ * TemporaryBuffer buffer("cube", shape_size(shape) * sizeof(float), {{ScratchLocation::Memory}});
+ * MmapRaster<float, 3> cube(shape, buffer.path().string(), MmapMode::ReadWrite);
+ * \endcode
+ */
+class TemporaryBuffer {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param name The file name, which is also used for debugging anonymous files
+   * @param size The file size, in bytes
+   * @param policy The placement policy
+   */
+  TemporaryBuffer(const std::string& name, Index size, const ScratchPolicy& policy = {}) :
+      m_fd(-1), m_path(), m_size(size), m_location(ScratchLocation::Temporary), m_reserved(0)
+  {
+    for (auto location : policy.order) {
+      const bool in_ram = location != ScratchLocation::Temporary;
+      if (in_ram && not Internal::reserve_scratch(size, policy.budget)) {
+        continue;
+      }
+      if (create(name, location)) {
+        m_location = location;
+        m_reserved = in_ram ? size : 0;
+        return;
+      }
+      if (in_ram) {
+        Internal::scratch_usage() -= size;
+      }
+    }
+    throw Exception("No scratch location available for " + name);
+  }
+
+  /**
+   * @brief Non-copyable.
+   */
+  TemporaryBuffer(const TemporaryBuffer&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  TemporaryBuffer& operator=(const TemporaryBuffer&) = delete;
+
+  /**
+   * @brief Destructor.
+   *
+   * Closes and removes the file, and releases the budget.
+   */
+  ~TemporaryBuffer()
+  {
+    ::close(m_fd);
+    if (m_location != ScratchLocation::Memory) {
+      std::error_code ec;
+      std::filesystem::remove(m_path, ec);
+    }
+    Internal::scratch_usage() -= m_reserved;
+  }
+
+  /**
+   * @brief Get the file descriptor.
+   */
+  int fd() const
+  {
+    return m_fd;
+  }
+
+  /**
+   * @brief Get the file path.
+   *
+   * For anonymous files, this is a path of the form `/proc/self/fd/<fd>`, which is valid in the current process only.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Get the file size, in bytes.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the selected location.
+   */
+  ScratchLocation location() const
+  {
+    return m_location;
+  }
+
+private:
+
+  /**
+   * @brief Try to create the file of given size in some location.
+   */
+  bool create(const std::string& name, ScratchLocation location)
+  {
+    if (location == ScratchLocation::Memory) {
+#ifdef MFD_CLOEXEC
+      m_fd = ::memfd_create(name.c_str(), MFD_CLOEXEC);
+      m_path = "/proc/self/fd/" + std::to_string(m_fd);
+#endif
+    } else {
+      const auto directory = Internal::scratch_directory(location);
+      if (directory.empty() || not Internal::has_space(directory, m_size)) {
+        return false;
+      }
+      m_path = directory / name;
+      m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    }
+    if (m_fd < 0) {
+      return false;
+    }
+    if (::ftruncate(m_fd, m_size) != 0) {
+      ::close(m_fd);
+      m_fd = -1;
+      if (location != ScratchLocation::Memory) {
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+      }
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief The file descriptor.
+   */
+  int m_fd;
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
+
+  /**
+   * @brief The file size.
+   */
+  Index m_size;
+
+  /**
+   * @brief The selected location.
+   */
+  ScratchLocation m_location;
+
+  /**
+   * @brief The number of bytes reserved in the RAM budget.
+   */
+  Index m_reserved;
+};
+
 } // namespace Linx
 
 #endif
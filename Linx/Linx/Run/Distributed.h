@@ -0,0 +1,462 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_DISTRIBUTED_H
+#define _LINXRUN_DISTRIBUTED_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm> // copy_n
+#include <string>
+
+#ifdef LINX_MPI
+#include <mpi.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @brief Get the block of a domain owned by some rank.
+ * @param domain The whole domain
+ * @param count The number of ranks
+ * @param rank The rank
+ *
+ * The domain is split into slabs along its last axis, e.g. into bands of rows in 2D,
+ * as evenly as possible, in rank order.
+ * Slabs are contiguous in memory, such that halos are exchanged as single blocks.
+ */
+template <Index N>
+Box<N> block_partition(const Box<N>& domain, Index count, Index rank)
+{
+  const auto axis = domain.dimension() - 1;
+  const auto length = domain.length(axis);
+  auto front = domain.front();
+  auto back = domain.back();
+  front[axis] += rank * length / count;
+  back[axis] = domain.front()[axis] + (rank + 1) * length / count - 1;
+  return {front, back};
+}
+
+/**
+ * @brief The communicator of a single process, i.e. without distribution.
+ *
+ * A communicator provides:
+ * - `Index rank() const` and `Index size() const`;
+ * - `void exchange(const T* send, Index send_count, Index dest, T* recv, Index recv_count, Index source)`,
+ *   templated on `T`, which sends to `dest` and receives from `source` simultaneously,
+ *   where a rank of -1 means no transfer;
+ * - `void barrier()`.
+ *
+ * @see `MpiCommunicator`
+ */
+class SerialCommunicator {
+public:
+
+  /**
+   * @brief Get the rank of the calling process.
+   */
+  Index rank() const
+  {
+    return 0;
+  }
+
+  /**
+   * @brief Get the number of processes.
+   */
+  Index size() const
+  {
+    return 1;
+  }
+
+  /**
+   * @brief Copy values to self, if both ranks are 0.
+   */
+  template <typename T>
+  void exchange(const T* send, Index send_count, Index dest, T* recv, Index recv_count, Index source)
+  {
+    if (dest == 0 && source == 0) {
+      SizeError::may_throw(recv_count, send_count);
+      std::copy_n(send, send_count, recv);
+    }
+  }
+
+  /**
+   * @brief Do nothing.
+   */
+  void barrier() {}
+};
+
+#ifdef LINX_MPI
+
+/**
+ * @brief A communicator backed by MPI.
+ *
+ * This communicator is only available if `LINX_MPI` is defined, and the program is built and linked with MPI.
+ * MPI must be initialized by the program, e.g. with `MPI_Init()`, and finalized after the communicator is destroyed.
+ */
+class MpiCommunicator {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  explicit MpiCommunicator(MPI_Comm comm = MPI_COMM_WORLD) : m_comm(comm), m_rank(0), m_size(1)
+  {
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(m_comm, &rank);
+    MPI_Comm_size(m_comm, &size);
+    m_rank = rank;
+    m_size = size;
+  }
+
+  /**
+   * @brief Get the rank of the calling process.
+   */
+  Index rank() const
+  {
+    return m_rank;
+  }
+
+  /**
+   * @brief Get the number of processes.
+   */
+  Index size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Send to `dest` and receive from `source`, or -1 for no transfer.
+   */
+  template <typename T>
+  void exchange(const T* send, Index send_count, Index dest, T* recv, Index recv_count, Index source)
+  {
+    MPI_Sendrecv(
+        send,
+        static_cast<int>(send_count * sizeof(T)),
+        MPI_BYTE,
+        dest < 0 ? MPI_PROC_NULL : static_cast<int>(dest),
+        0,
+        recv,
+        static_cast<int>(recv_count * sizeof(T)),
+        MPI_BYTE,
+        source < 0 ? MPI_PROC_NULL : static_cast<int>(source),
+        0,
+        m_comm,
+        MPI_STATUS_IGNORE);
+  }
+
+  /**
+   * @brief Wait for all processes.
+   */
+  void barrier()
+  {
+    MPI_Barrier(m_comm);
+  }
+
+private:
+
+  MPI_Comm m_comm;
+  Index m_rank;
+  Index m_size;
+};
+
+#endif
+
+/**
+ * @brief A raster distributed over the ranks of a communicator, with halos.
+ * @tparam T The value type
+ * @tparam N The dimension
+ * @tparam TComm The communicator type, e.g. `SerialCommunicator` or `MpiCommunicator`
+ *
+ * Each rank owns a block of the domain, as given by `block_partition()`,
+ * and stores it in a local raster together with a halo, i.e. the neighboring values owned by other ranks.
+ * The halo is sized from a margin, e.g. a filter window, and clipped to the domain.
+ * Halos are refreshed with `exchange()`, after which filters can be applied to each block independently:
+ *
+ * \code
+ * MpiCommunicator comm;
+ * const auto filter = convolution(kernel);
+ * DistributedRaster<float, 2, MpiCommunicator> image(domain, box(filter.window()), comm);
+ * image.read(fits); // Each rank reads its block and halo only
+ * auto filtered = image.filter(filter); // Exchanges halos, filters blocks, and exchanges output halos
+ * auto result = filtered.gather(); // Whole raster on rank 0
+ * \endcode
+ *
+ * At the domain borders, the local raster is extrapolated, such that results match
+ * those of `filter * extrapolation<TMethod>(whole)`, for methods which do not wrap around, i.e. all but `Periodic`.
+ * Pixel-wise operations do not need any communication, and can be applied to `local()` directly,
+ * which keeps the halo consistent.
+ */
+template <typename T, Index N = 2, typename TComm = SerialCommunicator>
+class DistributedRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param domain The whole domain
+   * @param margin The halo margin, e.g. a filter window, whose front is negative or null
+   * @param comm The communicator
+   */
+  DistributedRaster(const Box<N>& domain, const Box<N>& margin, TComm comm = TComm()) :
+      m_domain(domain), m_margin(margin), m_comm(LINX_MOVE(comm)),
+      m_owned(block_partition(domain, m_comm.size(), m_comm.rank())), m_halo((m_owned + margin) & domain),
+      m_local(m_halo.shape())
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the whole domain.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /**
+   * @brief Get the halo margin.
+   */
+  const Box<N>& margin() const
+  {
+    return m_margin;
+  }
+
+  /**
+   * @brief Get the block owned by the calling rank, in domain coordinates.
+   */
+  const Box<N>& owned() const
+  {
+    return m_owned;
+  }
+
+  /**
+   * @brief Get the block and its halo, in domain coordinates.
+   */
+  const Box<N>& halo() const
+  {
+    return m_halo;
+  }
+
+  /**
+   * @brief Get the communicator.
+   */
+  TComm& communicator()
+  {
+    return m_comm;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the local raster, i.e. the block and its halo, whose origin is `halo().front()`.
+   */
+  const Raster<T, N>& local() const
+  {
+    return m_local;
+  }
+
+  /**
+   * @copydoc local()
+   */
+  Raster<T, N>& local()
+  {
+    return m_local;
+  }
+
+  /**
+   * @brief Get the owned block of the local raster as a patch.
+   */
+  decltype(auto) owned_patch()
+  {
+    return m_local(m_owned - m_halo.front());
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Read the block and its halo from a file.
+   * @param file The file, e.g. `Fits`, which provides region reads as `file.read<Raster<T, N>>(box, hdu)`
+   * @param hdu The HDU index
+   *
+   * As halos are read, no exchange is needed.
+   */
+  template <typename TFile>
+  void read(TFile& file, Index hdu = 0)
+  {
+    m_local = file.template read<Raster<T, N>>(m_halo, hdu);
+  }
+
+  /**
+   * @brief Write the owned blocks into an existing file, one rank after the other.
+   * @param file The file, e.g. `Fits`, which provides region writes as `file.write(raster, box, hdu)`
+   * @param hdu The HDU index
+   *
+   * The image must have been created beforehand with the domain shape, e.g. by rank 0 followed by a barrier.
+   */
+  template <typename TFile>
+  void write(TFile& file, Index hdu = 0)
+  {
+    const auto block = owned_raster();
+    for (Index r = 0; r < m_comm.size(); ++r) {
+      if (r == m_comm.rank()) {
+        file.write(block, m_owned, hdu);
+      }
+      m_comm.barrier();
+    }
+  }
+
+  /**
+   * @brief Fill the halo with the values owned by the other ranks.
+   *
+   * This is a collective operation: all ranks must call it.
+   * Each rank sends the part of its block which lies in the halo of each other rank,
+   * in a shifted pattern which cannot deadlock.
+   */
+  void exchange()
+  {
+    const auto rank = m_comm.rank();
+    const auto size = m_comm.size();
+    for (Index shift = 1; shift < size; ++shift) {
+      const auto dest = (rank + shift) % size;
+      const auto source = (rank - shift + size) % size;
+      const auto send_box = m_owned & halo_of(dest);
+      const auto recv_box = m_halo & owned_of(source);
+      const auto send_count = slab_size(send_box);
+      const auto recv_count = slab_size(recv_box);
+      m_comm.exchange(
+          send_count ? &m_local[send_box.front() - m_halo.front()] : m_local.data(),
+          send_count,
+          send_count ? dest : -1,
+          recv_count ? &m_local[recv_box.front() - m_halo.front()] : m_local.data(),
+          recv_count,
+          recv_count ? source : -1);
+    }
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Filter the distributed raster.
+   * @tparam TMethod The extrapolation method at the domain borders
+   * @param filter The filter, whose window must be included in the margin along the last axis
+   * @param args The extrapolation method arguments, e.g. a constant value
+   * @return The filtered raster, with the same partition and margin, and whose halo is exchanged
+   *
+   * This is a collective operation: all ranks must call it.
+   */
+  template <typename TMethod = Nearest, typename TFilter, typename... TArgs>
+  DistributedRaster<typename TFilter::Value, N, TComm> filter(const TFilter& filter, TArgs&&... args)
+  {
+    const auto window = extend<N>(box(filter.window()));
+    const auto axis = N - 1;
+    const auto bounds = std::make_pair(m_margin.front()[axis], m_margin.back()[axis]);
+    OutOfBoundsError::may_throw("Window front along last axis: ", window.front()[axis], bounds);
+    OutOfBoundsError::may_throw("Window back along last axis: ", window.back()[axis], bounds);
+
+    exchange();
+    DistributedRaster<typename TFilter::Value, N, TComm> out(m_domain, m_margin, m_comm);
+    const auto extrapolated = extrapolation<TMethod>(m_local, LINX_FORWARD(args)...);
+    const auto block = filter * extrapolated(m_owned - m_halo.front());
+    std::copy(block.begin(), block.end(), &out.m_local[m_owned.front() - m_halo.front()]);
+    out.exchange();
+    return out;
+  }
+
+  /**
+   * @brief Copy the owned block.
+   */
+  Raster<T, N> owned_raster() const
+  {
+    const auto offset = m_owned.front() - m_halo.front();
+    Raster<T, N> out(m_owned.shape());
+    std::copy_n(&m_local[offset], out.size(), out.data());
+    return out;
+  }
+
+  /**
+   * @brief Gather the whole raster on some rank.
+   * @param root The rank which receives the raster
+   * @return The whole raster on `root`, an empty raster on the other ranks
+   *
+   * This is a collective operation: all ranks must call it.
+   */
+  Raster<T, N> gather(Index root = 0)
+  {
+    const auto rank = m_comm.rank();
+    const auto block = owned_raster();
+    if (rank != root) {
+      m_comm.exchange(block.data(), block.size(), root, static_cast<T*>(nullptr), Index(0), Index(-1));
+      return Raster<T, N>();
+    }
+    Raster<T, N> out(m_domain.shape());
+    for (Index r = 0; r < m_comm.size(); ++r) {
+      const auto b = owned_of(r);
+      auto* dst = &out[b.front() - m_domain.front()];
+      if (r == rank) {
+        std::copy_n(block.data(), block.size(), dst);
+      } else {
+        m_comm.exchange(static_cast<const T*>(nullptr), Index(0), Index(-1), dst, b.size(), r);
+      }
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  template <typename U, Index M, typename UComm>
+  friend class DistributedRaster;
+
+  /**
+   * @brief Get the block owned by some rank.
+   */
+  Box<N> owned_of(Index rank) const
+  {
+    return block_partition(m_domain, m_comm.size(), rank);
+  }
+
+  /**
+   * @brief Get the block and halo of some rank.
+   */
+  Box<N> halo_of(Index rank) const
+  {
+    return (owned_of(rank) + m_margin) & m_domain;
+  }
+
+  /**
+   * @brief Get the number of elements of a slab, or 0 if empty.
+   */
+  static Index slab_size(const Box<N>& slab)
+  {
+    return slab.length(N - 1) > 0 ? slab.size() : 0;
+  }
+
+  Box<N> m_domain;
+  Box<N> m_margin;
+  TComm m_comm;
+  Box<N> m_owned;
+  Box<N> m_halo;
+  Raster<T, N> m_local;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,393 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_EXECUTION_H
+#define _LINXRUN_EXECUTION_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <exception>
+#include <iterator> // begin, end
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h> // sched_getaffinity, sched_setaffinity
+#endif
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The first error thrown by concurrent tasks.
+ */
+struct TaskErrors {
+  /**
+   * @brief Run a function and keep its error, if any and if first.
+   */
+  template <typename TFunc>
+  void run(TFunc&& func)
+  {
+    try {
+      func();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (not error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  /**
+   * @brief Rethrow the error, if any.
+   */
+  void may_throw() const
+  {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  std::mutex mutex;
+  std::exception_ptr error;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @brief The process-wide configuration of the parallel engines.
+ *
+ * All parallel features of Linx (pixel-wise operations with `par`, filters, pipelines, `parallel_for()`...)
+ * are scheduled by the OpenMP runtime, such that they share a single pool of threads.
+ * The context configures this pool once for all:
+ * - the default thread count, i.e. that of `par` and of policies or `parallelize()` calls with a null thread count;
+ * - whether parallel regions can be nested, which is disabled by default,
+ *   such that inner regions run sequentially, while `parallel_for()`, `parallel_for_each()` and `run_tasks()`
+ *   spawn tasks in the enclosing team in any case;
+ * - whether the threads are pinned to the allowed cores, one core per thread, round-robin;
+ * - the instruction set of the hot kernels, see `instruction_set()`.
+ *
+ * Programs can expose the configuration through the options `threads`, `nested`, `pin` and `isa`:
+ *
+ * \code
+ * ProgramOptions options;
+ * ExecutionContext::declare(options);
+ * options.parse(argc, argv);
+ * ExecutionContext::configure(options);
+ * \endcode
+ *
+ * Without OpenMP, everything runs sequentially and the configuration is ignored.
+ * Pinning is only supported on Linux; the standard `OMP_PROC_BIND` and `OMP_PLACES` variables can be used instead.
+ */
+class ExecutionContext {
+public:
+
+  /**
+   * @brief Configure the engines.
+   * @param thread_count The default thread count, or 0 to use as many threads as cores
+   * @param nested Whether to allow nested parallel regions
+   * @param pinned Whether to pin each thread to a core
+   */
+  static void configure(Index thread_count, bool nested = false, bool pinned = false)
+  {
+    const auto cores = allowed_cores();
+    if (thread_count <= 0) {
+      thread_count = cores.empty() ? Internal::resolve_thread_count(0) : static_cast<Index>(cores.size());
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(static_cast<int>(thread_count));
+    omp_set_max_active_levels(nested ? 8 : 1);
+#endif
+    state().thread_count = thread_count;
+    state().nested = nested;
+    state().pinned = pinned && not cores.empty();
+    if (state().pinned) {
+      pin(cores);
+    }
+  }
+
+  /**
+   * @brief Declare the options `threads`, `nested`, `pin` and `isa`.
+   */
+  static void declare(ProgramOptions& options)
+  {
+    options.named("threads", "The number of threads of the parallel engines, or 0 to use all cores", 0L);
+    options.flag("nested", "Allow nested parallel regions");
+    options.flag("pin", "Pin each thread to a core");
+    options.named("isa", "The instruction set of the kernels: auto, baseline, avx2, avx512 or sve", std::string("auto"));
+  }
+
+  /**
+   * @brief Configure the engines from program options, which were declared with `declare()`.
+   *
+   * Option `isa` set to `auto` does not override the `LINX_ISA` environment variable.
+   */
+  static void configure(const ProgramOptions& options)
+  {
+    configure(options.as<Index>("threads"), options.has("nested"), options.has("pin"));
+    const auto isa = options.as<std::string>("isa");
+    if (isa != "auto" || std::getenv("LINX_ISA") == nullptr) {
+      select_instruction_set(isa);
+    }
+  }
+
+  /**
+   * @brief Get the default thread count.
+   */
+  static Index thread_count()
+  {
+    return Internal::resolve_thread_count(0);
+  }
+
+  /**
+   * @brief Check whether nested parallel regions are allowed.
+   */
+  static bool nested()
+  {
+    return state().nested;
+  }
+
+  /**
+   * @brief Check whether threads were pinned.
+   */
+  static bool pinned()
+  {
+    return state().pinned;
+  }
+
+  /**
+   * @brief Get the cores the process is allowed to run on, or an empty list if unknown.
+   */
+  static std::vector<Index> allowed_cores()
+  {
+    std::vector<Index> out;
+#if defined(__linux__) && defined(CPU_ISSET)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (Index i = 0; i < CPU_SETSIZE; ++i) {
+        if (CPU_ISSET(i, &set)) {
+          out.push_back(i);
+        }
+      }
+    }
+#endif
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief The configuration.
+   */
+  struct State {
+    Index thread_count = 0;
+    bool nested = false;
+    bool pinned = false;
+  };
+
+  /**
+   * @brief Get the configuration.
+   */
+  static State& state()
+  {
+    static State out;
+    return out;
+  }
+
+  /**
+   * @brief Pin the threads of the default team, which the OpenMP runtime reuses for subsequent regions.
+   */
+  static void pin(const std::vector<Index>& cores)
+  {
+#if defined(__linux__) && defined(CPU_SET)
+#pragma omp parallel
+    {
+      Index rank = 0;
+#ifdef _OPENMP
+      rank = omp_get_thread_num();
+#endif
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cores[rank % cores.size()], &set);
+      sched_setaffinity(0, sizeof(set), &set);
+    }
+#else
+    (void)cores;
+#endif
+  }
+};
+
+/**
+ * @brief Call a function on each element of a range concurrently, with dynamic load balancing.
+ * @param policy The parallel policy
+ * @param range The range, e.g. `tiles(raster, shape)` or `sections(raster)`
+ * @param func The function, called as `func(element)`
+ *
+ * Each element is an OpenMP task: idle threads pick the next pending element,
+ * such that unbalanced workloads, e.g. tiles with varying costs, are evenly spread.
+ * When called from a parallel region, e.g. from another `parallel_for_each()`, the tasks join the enclosing team
+ * instead of creating new threads.
+ * The first error thrown by `func` is rethrown in the calling thread once all tasks are completed.
+ *
+ * \code
+ * parallel_for_each(par, tiles(raster, Position<2> {64, 64}), [](auto& tile) {
+ *   tile.apply([](auto e) { return std::sqrt(e); });
+ * });
+ * \endcode
+ */
+template <typename TRange, typename TFunc>
+void parallel_for_each(const ParallelPolicy& policy, TRange&& range, TFunc&& func)
+{
+  using std::begin;
+  using std::end;
+  using Element = std::decay_t<decltype(*begin(range))>;
+  std::vector<Element> elements;
+  for (auto it = begin(range); it != end(range); ++it) {
+    elements.push_back(*it);
+  }
+  const auto count = elements.size();
+  Internal::TaskErrors errors;
+  Internal::with_team(policy, [&]() {
+    for (std::size_t i = 0; i < count; ++i) {
+#pragma omp task shared(errors, func, elements)
+      errors.run([&]() {
+        func(elements[i]);
+      });
+    }
+#pragma omp taskwait
+  });
+  errors.may_throw();
+}
+
+/**
+ * @brief Call a function on each position of a box concurrently.
+ * @param policy The parallel policy
+ * @param box The box
+ * @param func The function, called as `func(position)`
+ *
+ * The box is split along its last axis, e.g. into rows in 2D,
+ * and each slice is an OpenMP task, as in `parallel_for_each()`.
+ * Positions of a slice are visited in order.
+ */
+template <Index N, typename TFunc>
+void parallel_for(const ParallelPolicy& policy, const Box<N>& box, TFunc&& func)
+{
+  const auto axis = box.dimension() - 1;
+  std::vector<Box<N>> slices;
+  for (auto i = box.front()[axis]; i <= box.back()[axis]; ++i) {
+    auto front = box.front();
+    auto back = box.back();
+    front[axis] = i;
+    back[axis] = i;
+    slices.emplace_back(front, back);
+  }
+  parallel_for_each(policy, slices, [&](const auto& slice) {
+    for (const auto& p : slice) {
+      func(p);
+    }
+  });
+}
+
+/**
+ * @brief Reduce the elements of a range concurrently, with per-block accumulators.
+ * @param policy The parallel policy
+ * @param range The range, e.g. `tiles(raster, shape)` or `sections(raster)`
+ * @param identity The initial value of each accumulator, e.g. 0 for a sum or an empty histogram
+ * @param func The accumulation function, called as `func(accumulator, element)`
+ * @param combine The combination function, called as `combine(accumulator, other)`
+ * @return The combination of the accumulators
+ *
+ * The elements are split into consecutive blocks, a few per thread for load balancing,
+ * and each block is accumulated into its own copy of `identity` by an OpenMP task, as in `parallel_for_each()`.
+ * Accumulators are not shared, such that `func` needs no synchronization,
+ * e.g. to fill a histogram or append to a list of sources.
+ * They are finally combined in the calling thread, in block order:
+ * the result is reproducible for a given thread count,
+ * and it does not depend on the thread count at all if `combine` is associative,
+ * e.g. lists are concatenated in the order of the range.
+ *
+ * \code
+ * using Histogram = std::vector<Index>;
+ * const auto histogram = parallel_reduce(
+ *     par,
+ *     tiles(image, Position<2> {64, 64}),
+ *     Histogram(256),
+ *     [](Histogram& h, const auto& tile) {
+ *       for (auto e : tile) {
+ *         ++h[e];
+ *       }
+ *     },
+ *     [](Histogram& h, const Histogram& other) {
+ *       for (std::size_t i = 0; i < h.size(); ++i) {
+ *         h[i] += other[i];
+ *       }
+ *     });
+ * \endcode
+ */
+template <typename TRange, typename T, typename TFunc, typename TCombine>
+T parallel_reduce(const ParallelPolicy& policy, TRange&& range, const T& identity, TFunc&& func, TCombine&& combine)
+{
+  using std::begin;
+  using std::end;
+  using Element = std::decay_t<decltype(*begin(range))>;
+  std::vector<Element> elements;
+  for (auto it = begin(range); it != end(range); ++it) {
+    elements.push_back(*it);
+  }
+  const auto bounds = Internal::chunk_bounds(4 * policy.thread_count(), static_cast<Index>(elements.size()));
+  const auto block_count = static_cast<Index>(bounds.size()) - 1;
+  std::vector<T> accumulators(block_count, identity);
+  Internal::TaskErrors errors;
+  Internal::with_team(policy, [&]() {
+    for (Index b = 0; b < block_count; ++b) {
+#pragma omp task shared(errors, func, elements, accumulators, bounds)
+      errors.run([&]() {
+        for (auto i = bounds[b]; i < bounds[b + 1]; ++i) {
+          func(accumulators[b], elements[i]);
+        }
+      });
+    }
+#pragma omp taskwait
+  });
+  errors.may_throw();
+  for (Index b = 1; b < block_count; ++b) {
+    combine(accumulators[0], accumulators[b]);
+  }
+  return accumulators[0];
+}
+
+/**
+ * @brief Run functions concurrently as a group of tasks, and wait for them.
+ *
+ * The functions are OpenMP tasks of the enclosing team if any, or of a new team otherwise,
+ * as in `parallel_for_each()`.
+ * This is also how `StepperPipeline::get()` evaluates independent steps.
+ * The first error thrown is rethrown in the calling thread once all tasks are completed.
+ */
+template <typename... TFuncs>
+void run_tasks(const ParallelPolicy& policy, TFuncs&&... funcs)
+{
+  Internal::TaskErrors errors;
+  Internal::with_team(policy, [&]() {
+    const auto spawn = [&](auto& func) {
+#pragma omp task shared(errors, func)
+      errors.run(func);
+    };
+    using mock_unpack = int[];
+    (void)mock_unpack {0, (spawn(funcs), 0)...};
+#pragma omp taskwait
+  });
+  errors.may_throw();
+}
+
+} // namespace Linx
+
+#endif
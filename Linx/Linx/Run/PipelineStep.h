@@ -21,6 +21,22 @@ namespace Linx {
  * struct Step1b : PipelineStep<int(Step0)> {};
  * struct Step2 : PipelineStep<bool(Step1a, Step1b)>{};
  * \endcode
+ *
+ * By default, the value of a step may be released once all its dependants have been evaluated
+ * (see `StepperPipeline`).
+ * To keep it, the step should be marked as retained:
+ * \code
+ * struct Step0 : PipelineStep<char()> {
+ *   static constexpr bool Retained = true;
+ * };
+ * \endcode
+ *
+ * Similarly, the value of a step can be persisted across runs by marking it as cached:
+ * \code
+ * struct Step1a : PipelineStep<float(Step0)> {
+ *   static constexpr bool Cached = true;
+ * };
+ * \endcode
  */
 template <typename T, typename... TSteps>
 struct PipelineStep;
@@ -33,6 +49,8 @@ struct PipelineStep<T()> {
   using Value = T;
   using Prerequisite = void;
   static constexpr std::size_t Cardinality = 0;
+  static constexpr bool Retained = false;
+  static constexpr bool Cached = false;
 };
 
 /**
@@ -43,6 +61,8 @@ struct PipelineStep<T(TStep)> {
   using Value = T;
   using Prerequisite = TStep;
   static constexpr std::size_t Cardinality = 1;
+  static constexpr bool Retained = false;
+  static constexpr bool Cached = false;
 };
 
 /**
@@ -53,6 +73,8 @@ struct PipelineStep<T(TSteps...)> {
   using Value = T;
   using Prerequisite = std::tuple<TSteps...>;
   static constexpr std::size_t Cardinality = sizeof...(TSteps);
+  static constexpr bool Retained = false;
+  static constexpr bool Cached = false;
 };
 
 } // namespace Linx
@@ -0,0 +1,280 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_SECTIONSTREAM_H
+#define _LINXRUN_SECTIONSTREAM_H
+
+#include "Linx/Base/BoundedQueue.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, min
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility> // move
+
+namespace Linx {
+
+/**
+ * @brief Make a section source which copies chunks from a raster, e.g. in memory or memory-mapped.
+ * @see `SectionStream`
+ */
+template <typename TRaster>
+auto raster_source(const TRaster& in)
+{
+  return [&](const auto& domain, auto& chunk) {
+    const auto last = domain.dimension() - 1;
+    const auto offset = domain.front()[last] * (static_cast<Index>(in.size()) / in.shape()[last]);
+    std::copy_n(in.data() + offset, chunk.size(), chunk.data());
+  };
+}
+
+/**
+ * @brief Make a section sink which copies chunks to a raster, e.g. in memory or memory-mapped.
+ * @see `SectionStream`
+ */
+template <typename TRaster>
+auto raster_sink(TRaster& out)
+{
+  return [&](const auto& domain, const auto& chunk) {
+    const auto last = domain.dimension() - 1;
+    const auto offset = domain.front()[last] * (static_cast<Index>(out.size()) / out.shape()[last]);
+    std::copy_n(chunk.data(), chunk.size(), out.data() + offset);
+  };
+}
+
+/**
+ * @brief Pipelined processing of a raster section by section.
+ * @tparam TIn The input value type
+ * @tparam TOut The output value type
+ * @tparam N The dimension
+ *
+ * The raster is sliced along its last axis into chunks of given thickness, like with `sections()`,
+ * except for the last chunk which may be thinner.
+ * Each chunk goes through three stages, which run concurrently:
+ * - loading, by a source on a background thread;
+ * - computing, in the calling thread, which may itself spawn parallel regions;
+ * - storing, by a sink on another background thread.
+ *
+ * Therefore, while chunk `k` is computed, chunk `k + 1` is loaded and chunk `k - 1` is stored,
+ * and the throughput approaches that of the slowest stage instead of the sum of the stages.
+ * Chunk buffers are recycled, and there are at most `depth + 1` input and `depth + 1` output buffers,
+ * such that memory is bounded whatever the raster size.
+ * The default depth of 1 is double buffering.
+ *
+ * Stages are callables:
+ * - the source is `void(const Box<N>& domain, Raster<TIn, N>& chunk)`, which fills the chunk;
+ * - the compute function is `void(const Raster<TIn, N>& in, Raster<TOut, N>& out)`;
+ * - the sink is `void(const Box<N>& domain, const Raster<TOut, N>& chunk)`.
+ *
+ * Sources and sinks can be memory or memory-mapped rasters with `raster_source()` and `raster_sink()`,
+ * FITS files with `chunk_source()` and `chunk_sink()`, or user callbacks.
+ * Chunks are passed in order, which is required by streaming sources and sinks.
+ *
+ * \code
+ * SectionStream<float> stream(cube.shape());
+ * const auto compute = [&](const auto& in, auto& out) {
+ *   const auto plane = filter * extrapolation(in.section(0));
+ *   std::copy(plane.begin(), plane.end(), out.begin());
+ * };
+ * stream.run(raster_source(cube), compute, raster_sink(filtered));
+ * \endcode
+ *
+ * The first error of any stage stops all the stages, and is rethrown by `run()` in the calling thread.
+ */
+template <typename TIn, typename TOut = TIn, Index N = 3>
+class SectionStream {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param thickness The number of sections per chunk
+   * @param depth The number of chunks which can be loaded in advance or stored late
+   */
+  explicit SectionStream(Position<N> shape, Index thickness = 1, Index depth = 1) :
+      m_shape(LINX_MOVE(shape)), m_thickness(thickness), m_depth(depth)
+  {
+    OutOfBoundsError::may_throw("Chunk thickness: ", m_thickness, {1, std::numeric_limits<Index>::max()});
+    OutOfBoundsError::may_throw("Stream depth: ", m_depth, {1, std::numeric_limits<Index>::max()});
+  }
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the nominal chunk thickness.
+   */
+  Index thickness() const
+  {
+    return m_thickness;
+  }
+
+  /**
+   * @brief Get the number of chunks.
+   */
+  Index size() const
+  {
+    const auto length = m_shape[m_shape.size() - 1];
+    return (length + m_thickness - 1) / m_thickness;
+  }
+
+  /**
+   * @brief Get the domain of some chunk.
+   */
+  Box<N> domain(Index k) const
+  {
+    const auto last = m_shape.size() - 1;
+    auto front = Position<N>::zero();
+    auto back = m_shape - 1;
+    front[last] = k * m_thickness;
+    back[last] = std::min(front[last] + m_thickness, m_shape[last]) - 1;
+    return {front, back};
+  }
+
+  /**
+   * @brief Load, compute and store all the chunks.
+   */
+  template <typename TSource, typename TCompute, typename TSink>
+  void run(TSource&& source, TCompute&& compute, TSink&& sink) const
+  {
+    const auto count = size();
+    Internal::BoundedQueue<Chunk<TIn>> free_in(m_depth + 1);
+    Internal::BoundedQueue<Chunk<TIn>> loaded(m_depth);
+    Internal::BoundedQueue<Chunk<TOut>> free_out(m_depth + 1);
+    Internal::BoundedQueue<Chunk<TOut>> computed(m_depth);
+    const auto first = domain(0);
+    for (Index i = 0; i <= m_depth; ++i) {
+      free_in.push(Chunk<TIn> {first, Raster<TIn, N>(first.shape())});
+      free_out.push(Chunk<TOut> {first, Raster<TOut, N>(first.shape())});
+    }
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex mutex;
+    const auto fail = [&]() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (not error) {
+          error = std::current_exception();
+        }
+      }
+      failed = true;
+      free_in.close();
+      loaded.close();
+      free_out.close();
+      computed.close();
+    };
+
+    std::thread loader([&]() {
+      try {
+        for (Index k = 0; k < count && not failed; ++k) {
+          auto chunk = free_in.pop();
+          if (not chunk) {
+            break;
+          }
+          reset(*chunk, domain(k));
+          source(chunk->domain, chunk->raster);
+          if (not loaded.push(std::move(*chunk))) {
+            break;
+          }
+        }
+        loaded.close();
+      } catch (...) {
+        fail();
+      }
+    });
+
+    std::thread storer([&]() {
+      try {
+        while (auto chunk = computed.pop()) {
+          if (failed) {
+            break;
+          }
+          sink(chunk->domain, chunk->raster);
+          free_out.push(std::move(*chunk));
+        }
+      } catch (...) {
+        fail();
+      }
+    });
+
+    try {
+      while (auto in = loaded.pop()) {
+        if (failed) {
+          break;
+        }
+        auto out = free_out.pop();
+        if (not out) {
+          break;
+        }
+        reset(*out, in->domain);
+        compute(std::as_const(in->raster), out->raster);
+        free_in.push(std::move(*in));
+        if (not computed.push(std::move(*out))) {
+          break;
+        }
+      }
+      computed.close();
+    } catch (...) {
+      fail();
+    }
+
+    loader.join();
+    storer.join();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+private:
+
+  /**
+   * @brief A chunk buffer and its domain.
+   */
+  template <typename T>
+  struct Chunk {
+    Box<N> domain;
+    Raster<T, N> raster;
+  };
+
+  /**
+   * @brief Assign a domain to a chunk, and reallocate its buffer if the shape changed.
+   */
+  template <typename T>
+  static void reset(Chunk<T>& chunk, const Box<N>& domain)
+  {
+    chunk.domain = domain;
+    if (chunk.raster.shape() != domain.shape()) {
+      chunk.raster = Raster<T, N>(domain.shape()); // Only for the first and last chunks
+    }
+  }
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The chunk thickness.
+   */
+  Index m_thickness;
+
+  /**
+   * @brief The stream depth.
+   */
+  Index m_depth;
+};
+
+} // namespace Linx
+
+#endif
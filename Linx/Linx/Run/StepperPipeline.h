@@ -5,16 +5,252 @@
 #ifndef _LINXRUN_STEPPERPIPELINE_H
 #define _LINXRUN_STEPPERPIPELINE_H
 
+#include "Linx/Base/MemoryTracker.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/Trace.h"
 #include "PipelineStep.h"
 
+#include <algorithm> // max
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <filesystem>
+#include <functional> // hash
 #include <map>
-#include <numeric> // accumulate
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <typeindex>
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The evaluation records of the steps of a pipeline.
+ *
+ * Records are stored in an insert-only linked list, such that they can be looked up without locking,
+ * while new records are pushed to the front with a compare-and-swap.
+ * Each record holds the elapsed time of its step, or -1 if not evaluated,
+ * the peak number of bytes allocated by its evaluation,
+ * whether the value of the step was released, whether it was loaded from the cache,
+ * and a mutex which serializes the evaluations and releases of the step.
+ */
+class StepRegistry {
+public:
+
+  /**
+   * @brief An evaluation record.
+   */
+  struct Record {
+    explicit Record(std::type_index k, double ms = -1) :
+        key(k), milliseconds(ms), bytes(-1), released(false), cached(false), mutex(), next(nullptr)
+    {}
+    std::type_index key;
+    std::atomic<double> milliseconds;
+    std::atomic<std::ptrdiff_t> bytes;
+    std::atomic<bool> released;
+    std::atomic<bool> cached;
+    std::mutex mutex;
+    Record* next;
+  };
+
+  /**
+   * @brief Constructor.
+   */
+  StepRegistry() : m_head(nullptr) {}
+
+  /**
+   * @brief Copy constructor, which copies the times only.
+   */
+  StepRegistry(const StepRegistry& other) : m_head(nullptr)
+  {
+    copy(other);
+  }
+
+  /**
+   * @brief Copy assignment, which copies the times only.
+   */
+  StepRegistry& operator=(const StepRegistry& other)
+  {
+    if (this != &other) {
+      clear();
+      copy(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor.
+   */
+  ~StepRegistry()
+  {
+    clear();
+  }
+
+  /**
+   * @brief Find the record of a step without locking.
+   * @return A pointer to the record, or `nullptr` if none
+   */
+  const Record* find(std::type_index key) const
+  {
+    for (auto* r = m_head.load(std::memory_order_acquire); r; r = r->next) {
+      if (r->key == key) {
+        return r;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Get the record of a step, which is created if needed.
+   */
+  Record& at(std::type_index key)
+  {
+    if (auto* r = find(key)) {
+      return const_cast<Record&>(*r);
+    }
+    auto* record = new Record(key);
+    auto* head = m_head.load(std::memory_order_acquire);
+    do {
+      for (auto* r = head; r; r = r->next) {
+        if (r->key == key) { // Inserted concurrently
+          delete record;
+          return *r;
+        }
+      }
+      record->next = head;
+    } while (not m_head.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_acquire));
+    return *record;
+  }
+
+  /**
+   * @brief Apply a function to each record.
+   */
+  template <typename TFunc>
+  void for_each(TFunc&& func) const
+  {
+    for (auto* r = m_head.load(std::memory_order_acquire); r; r = r->next) {
+      func(*r);
+    }
+  }
+
+  /**
+   * @brief Mark all the steps as not evaluated.
+   */
+  void reset()
+  {
+    for (auto* r = m_head.load(std::memory_order_acquire); r; r = r->next) {
+      r->milliseconds.store(-1, std::memory_order_release);
+      r->bytes.store(-1, std::memory_order_release);
+      r->released.store(false, std::memory_order_release);
+      r->cached.store(false, std::memory_order_release);
+    }
+  }
+
+private:
+
+  /**
+   * @brief Copy the records of another registry.
+   */
+  void copy(const StepRegistry& other)
+  {
+    other.for_each([&](const Record& r) {
+      auto& record = at(r.key);
+      record.milliseconds.store(r.milliseconds.load());
+      record.bytes.store(r.bytes.load());
+      record.released.store(r.released.load());
+      record.cached.store(r.cached.load());
+    });
+  }
+
+  /**
+   * @brief Delete the records.
+   */
+  void clear()
+  {
+    auto* r = m_head.exchange(nullptr);
+    while (r) {
+      auto* next = r->next;
+      delete r;
+      r = next;
+    }
+  }
+
+  /**
+   * @brief The most recently inserted record.
+   */
+  std::atomic<Record*> m_head;
+};
+
+/**
+ * @brief A tag which holds a step type.
+ */
+template <typename S>
+struct StepTag {
+  using Step = S;
+};
+
+/**
+ * @brief The pending consumers of the steps involved in a call to `StepperPipeline::get()`.
+ */
+class ReleasePlan {
+public:
+
+  /**
+   * @brief Register a consumer of a step.
+   */
+  void add(std::type_index key)
+  {
+    ++m_consumers[key];
+  }
+
+  /**
+   * @brief Mark a step as visited.
+   * @return True if the step was not visited yet
+   */
+  bool visit(std::type_index key)
+  {
+    return m_visited.insert(key).second;
+  }
+
+  /**
+   * @brief Unregister a consumer of a step.
+   * @return True if the step has no more pending consumers
+   *
+   * This is the only method which is called concurrently.
+   */
+  bool consume(std::type_index key)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return --m_consumers[key] == 0;
+  }
+
+private:
+
+  /**
+   * @brief The mutex which guards the consumer counts.
+   */
+  std::mutex m_mutex;
+
+  /**
+   * @brief The numbers of pending consumers.
+   */
+  std::map<std::type_index, Index> m_consumers;
+
+  /**
+   * @brief The visited steps.
+   */
+  std::set<std::type_index> m_visited;
+};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @brief A pipeline or directed acyclic graph (DAG) which can be run step-by-step using lazy evaluation.
  * 
@@ -37,6 +273,43 @@ namespace Linx {
  * - `Value` is the return value type of `get<S>()`;
  * - `Prerequisite` is (are) the step(s) which must be run prior to `S`, or `void` if there is no prerequisite;
  *   Multiple prerequisites are describled with tuples.
+ *
+ * With a parallel policy, `get<S>(par)` evaluates the prerequisites of multi-input steps as concurrent OpenMP tasks,
+ * such that independent branches of the DAG run concurrently, while each step is still evaluated only once.
+ * In this case, the `evaluate_impl()` specializations of independent steps must be safe to call concurrently.
+ * The elapsed time of the longest chain of steps is given by `critical_milliseconds()`.
+ *
+ * Pipelines can be shared by threads: concurrent calls to `get<S>()` wait for a single evaluation of `S`,
+ * and the evaluation status and times are read without locking.
+ * `reset()` must not be called concurrently with evaluations.
+ *
+ * To bound the memory footprint, child classes may additionally provide `void release_impl<S>()`,
+ * which frees or recycles the value of `S`.
+ * In this case, `get<S>()` counts the consumers of each step which has to be evaluated,
+ * and releases the value of a prerequisite as soon as its last consumer has been evaluated,
+ * unless the prerequisite is marked as retained (see `PipelineStep`).
+ * The value of the requested step is never released.
+ * A generic no-op `release_impl()` can be specialized for the steps to be released only.
+ * Released steps are no more `evaluated()`, and are evaluated again if requested later.
+ * Releasing is not synchronized with `get_impl()`: when a pipeline is shared by threads,
+ * the steps which are requested concurrently should be retained.
+ *
+ * Values can also be persisted across runs, e.g. when tuning downstream parameters.
+ * Once a cache directory is set with `cache_directory()`, the steps marked as cached (see `PipelineStep`)
+ * are loaded from the directory if possible instead of being evaluated, and are saved otherwise.
+ * For each cached step `S`, child classes must then provide:
+ * - `void save_impl<S>(const std::filesystem::path&)`, which writes the computed value of `S`,
+ *   typically with `Npy::write()`;
+ * - `void load_impl<S>(const std::filesystem::path&)`, which reads it back, e.g. with `Npy::read()` or `Npy::map()`.
+ *
+ * Files are named after a digest of the step and its inputs.
+ * Parameters and inputs which are not steps are accounted for by `std::size_t hash_impl<S>()`, if provided.
+ * The digest of a step combines its type, its hash and the digests of its prerequisites,
+ * such that changing a parameter invalidates the cache of all the downstream steps.
+ * A generic `hash_impl()` which returns 0 can be specialized for the parametrized steps only.
+ * Cache hits are reported by `cached()`, and count as evaluations whose time is that of loading.
+ *
+ * If compiled with `LINX_TRACK_MEMORY`, the peak memory allocated by each step is given by `peak_bytes()`.
  */
 template <typename TDerived>
 class StepperPipeline {
@@ -48,21 +321,62 @@ public:
   template <typename S>
   typename S::Value get()
   {
-    if constexpr (S::Cardinality == 1) {
-      get<typename S::Prerequisite>();
-    } else if constexpr (S::Cardinality > 1) {
-      get_multiple<typename S::Prerequisite>(std::make_index_sequence<S::Cardinality> {});
+    Internal::ReleasePlan plan;
+    plan_consumers<S>(plan);
+    evaluate_all<S>(plan);
+    return Accessor<S>::get(derived());
+  }
+
+  /**
+   * @brief Evaluation of step `S`, with independent prerequisites evaluated concurrently.
+   *
+   * Errors thrown by concurrent evaluations are rethrown in the calling thread.
+   * When called from a parallel region, e.g. from `parallel_for_each()`,
+   * the steps are tasks of the enclosing team instead of a new one.
+   */
+  template <typename S>
+  typename S::Value get(const ParallelPolicy& policy)
+  {
+    TaskError error;
+    Internal::ReleasePlan plan;
+    plan_consumers<S>(plan);
+    Internal::with_team(policy, [&]() {
+      evaluate_tasks<S>(error, plan);
+    });
+    if (error.error) {
+      std::rethrow_exception(error.error);
     }
-    return evaluate_get<S>();
+    return Accessor<S>::get(derived());
   }
 
   /**
-   * @brief Check whether some step `S` has already been evaluated.
+   * @brief Check whether some step `S` has already been evaluated and not released since.
    */
   template <typename S>
   bool evaluated() const
   {
-    return m_milliseconds.find(key<S>()) != m_milliseconds.end();
+    const auto* record = m_registry.find(key<S>());
+    return record && is_available(*record);
+  }
+
+  /**
+   * @brief Check whether the value of some step `S` has been released since its last evaluation.
+   */
+  template <typename S>
+  bool released() const
+  {
+    const auto* record = m_registry.find(key<S>());
+    return record && record->released.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Check whether the value of some step `S` was loaded from the cache at its last evaluation.
+   */
+  template <typename S>
+  bool cached() const
+  {
+    const auto* record = m_registry.find(key<S>());
+    return record && record->cached.load(std::memory_order_acquire);
   }
 
   /**
@@ -72,11 +386,22 @@ public:
   template <typename S>
   double milliseconds() const
   {
-    const auto it = m_milliseconds.find(key<S>());
-    if (it != m_milliseconds.end()) {
-      return it->second;
-    }
-    return -1;
+    const auto* record = m_registry.find(key<S>());
+    return record ? record->milliseconds.load(std::memory_order_acquire) : -1;
+  }
+
+  /**
+   * @brief Get the peak number of bytes allocated by the last evaluation of step `S`.
+   * @return The number of bytes if the step was evaluated, or -1 otherwise.
+   *
+   * The bytes are those of the holders allocated by the evaluating thread, including temporaries,
+   * if the program is compiled with `LINX_TRACK_MEMORY` (see `MemoryTracker`), or 0 otherwise.
+   */
+  template <typename S>
+  std::ptrdiff_t peak_bytes() const
+  {
+    const auto* record = m_registry.find(key<S>());
+    return record ? record->bytes.load(std::memory_order_acquire) : -1;
   }
 
   /**
@@ -84,9 +409,84 @@ public:
    */
   double milliseconds() const
   {
-    return std::accumulate(m_milliseconds.begin(), m_milliseconds.end(), 0., [](const auto sum, const auto& e) {
-      return sum + e.second;
+    double out = 0;
+    m_registry.for_each([&](const auto& r) {
+      out += std::max(r.milliseconds.load(std::memory_order_acquire), 0.);
     });
+    return out;
+  }
+
+  /**
+   * @brief Get the elapsed time of the critical path to step `S`.
+   * @return The sum of the times of the longest chain of steps which ends with `S`,
+   * or -1 if `S` was not evaluated.
+   *
+   * This is the wall time of `get<S>()` with enough threads, ignoring scheduling overheads.
+   */
+  template <typename S>
+  double critical_milliseconds() const
+  {
+    const auto out = milliseconds<S>();
+    if (out < 0) {
+      return out;
+    }
+    if constexpr (S::Cardinality == 1) {
+      return out + std::max(critical_milliseconds<typename S::Prerequisite>(), 0.);
+    } else if constexpr (S::Cardinality > 1) {
+      return out + max_critical_milliseconds<typename S::Prerequisite>(std::make_index_sequence<S::Cardinality> {});
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the cache directory, or an empty path if caching is disabled.
+   */
+  const std::filesystem::path& cache_directory() const
+  {
+    return m_cache_directory;
+  }
+
+  /**
+   * @brief Set the cache directory, which is created if needed, or disable caching with an empty path.
+   *
+   * This must not be called concurrently with evaluations.
+   */
+  void cache_directory(const std::filesystem::path& directory)
+  {
+    if (not directory.empty()) {
+      std::filesystem::create_directories(directory);
+    }
+    m_cache_directory = directory;
+  }
+
+  /**
+   * @brief Get the digest of step `S`, which identifies its value in the cache.
+   */
+  template <typename S>
+  std::size_t digest()
+  {
+    std::size_t out = std::hash<std::string>()(typeid(S).name());
+    const auto combine = [&](std::size_t value) {
+      out ^= value + 0x9e3779b9 + (out << 6) + (out >> 2);
+    };
+    if constexpr (Accessor<S>::hashable()) {
+      combine(Accessor<S>::hash(derived()));
+    }
+    for_each_prerequisite<S>([&](auto tag) {
+      combine(digest<typename decltype(tag)::Step>());
+    });
+    return out;
+  }
+
+  /**
+   * @brief Get the path of the cached value of step `S`.
+   */
+  template <typename S>
+  std::filesystem::path cache_path()
+  {
+    std::ostringstream os;
+    os << std::hex << digest<S>() << ".npy";
+    return m_cache_directory / os.str();
   }
 
 protected:
@@ -96,20 +496,170 @@ protected:
    */
   void reset()
   {
-    m_milliseconds.clear();
+    m_registry.reset();
   }
 
 private:
 
   /**
-   * @brief Call `get()` on each element of a tuple.
+   * @brief Call a function on a `StepTag` of each prerequisite of step `S`.
+   */
+  template <typename S, typename TFunc>
+  static void for_each_prerequisite(TFunc&& func)
+  {
+    if constexpr (S::Cardinality == 1) {
+      func(Internal::StepTag<typename S::Prerequisite> {});
+    } else if constexpr (S::Cardinality > 1) {
+      for_each_element<typename S::Prerequisite>(func, std::make_index_sequence<S::Cardinality> {});
+    }
+  }
+
+  /**
+   * @brief Call a function on a `StepTag` of each element of a tuple.
+   */
+  template <typename STuple, typename TFunc, std::size_t... Is>
+  static void for_each_element(TFunc& func, std::index_sequence<Is...>)
+  {
+    using mock_unpack = int[];
+    (void)mock_unpack {0, (func(Internal::StepTag<std::tuple_element_t<Is, STuple>> {}), void(), 0)...};
+  }
+
+  /**
+   * @brief Count the consumers of the steps which have to be evaluated for step `S`.
+   */
+  template <typename S>
+  void plan_consumers(Internal::ReleasePlan& plan)
+  {
+    if (evaluated<S>() || loadable<S>() || not plan.visit(key<S>())) {
+      return;
+    }
+    for_each_prerequisite<S>([&](auto tag) {
+      using P = typename decltype(tag)::Step;
+      plan.add(key<P>());
+      plan_consumers<P>(plan);
+    });
+  }
+
+  /**
+   * @brief Evaluate step `S` and its prerequisites sequentially.
+   */
+  template <typename S>
+  void evaluate_all(Internal::ReleasePlan& plan)
+  {
+    if (evaluated<S>()) {
+      return;
+    }
+    if (not loadable<S>()) {
+      for_each_prerequisite<S>([&](auto tag) {
+        evaluate_all<typename decltype(tag)::Step>(plan);
+      });
+    }
+    if (evaluate_once<S>()) {
+      consume<S>(plan);
+    }
+  }
+
+  /**
+   * @brief Unregister step `S` as a consumer of its prerequisites, and release those which are not needed anymore.
+   */
+  template <typename S>
+  void consume(Internal::ReleasePlan& plan)
+  {
+    for_each_prerequisite<S>([&](auto tag) {
+      using P = typename decltype(tag)::Step;
+      if (plan.consume(key<P>())) {
+        release<P>();
+      }
+    });
+  }
+
+  /**
+   * @brief Release the value of step `S` if it is not retained and the child class supports it.
+   */
+  template <typename S>
+  void release()
+  {
+    if constexpr (not S::Retained && Accessor<S>::releasable()) {
+      auto& record = m_registry.at(key<S>());
+      std::lock_guard<std::mutex> lock(record.mutex);
+      Accessor<S>::release(derived());
+      record.released.store(true, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief The first error of concurrent evaluations.
+   */
+  struct TaskError {
+    std::mutex mutex;
+    std::exception_ptr error;
+  };
+
+  /**
+   * @brief Evaluate step `S` and its prerequisites as OpenMP tasks.
+   *
+   * Must be called from inside a parallel region.
+   * The first error is stored.
+   */
+  template <typename S>
+  void evaluate_tasks(TaskError& error, Internal::ReleasePlan& plan)
+  {
+    if (evaluated<S>()) {
+      return;
+    }
+    if (loadable<S>()) {
+      // Prerequisites not needed
+    } else if constexpr (S::Cardinality == 1) {
+      evaluate_tasks<typename S::Prerequisite>(error, plan);
+    } else if constexpr (S::Cardinality > 1) {
+      spawn_tasks<typename S::Prerequisite>(error, plan, std::make_index_sequence<S::Cardinality> {});
+    }
+    {
+      std::lock_guard<std::mutex> lock(error.mutex);
+      if (error.error) {
+        return; // Some prerequisite failed
+      }
+    }
+    try {
+      if (evaluate_once<S>()) {
+        consume<S>(plan);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error.mutex);
+      if (not error.error) {
+        error.error = std::current_exception();
+      }
+    }
+  }
+
+  /**
+   * @brief Evaluate each element of a tuple as an OpenMP task and wait for them.
    */
   template <typename STuple, std::size_t... Is>
-  void get_multiple(std::index_sequence<Is...>)
+  void spawn_tasks(TaskError& error, Internal::ReleasePlan& plan, std::index_sequence<Is...>)
   {
     using mock_unpack = int[];
-    (void)mock_unpack {0, (get<std::tuple_element_t<Is, STuple>>(), void(), 0)...};
-    // TODO could be done in threads!
+    (void)mock_unpack {0, (spawn_task<std::tuple_element_t<Is, STuple>>(error, plan), 0)...};
+#pragma omp taskwait
+  }
+
+  /**
+   * @brief Evaluate step `S` as an OpenMP task.
+   */
+  template <typename S>
+  void spawn_task(TaskError& error, Internal::ReleasePlan& plan)
+  {
+#pragma omp task shared(error, plan)
+    evaluate_tasks<S>(error, plan);
+  }
+
+  /**
+   * @brief Get the maximum critical path time of the elements of a tuple.
+   */
+  template <typename STuple, std::size_t... Is>
+  double max_critical_milliseconds(std::index_sequence<Is...>) const
+  {
+    return std::max({0., critical_milliseconds<std::tuple_element_t<Is, STuple>>()...});
   }
 
   /**
@@ -134,21 +684,161 @@ private:
       auto f = &Accessor::template get_impl<S>;
       return (algo.*f)();
     }
+
+    /**
+     * @brief Call `algo.release_impl<S>()`.
+     */
+    static void release(TDerived& algo)
+    {
+      auto f = &Accessor::template release_impl<S>;
+      (algo.*f)();
+    }
+
+    /**
+     * @brief Call `algo.hash_impl<S>()`.
+     */
+    static std::size_t hash(TDerived& algo)
+    {
+      auto f = &Accessor::template hash_impl<S>;
+      return (algo.*f)();
+    }
+
+    /**
+     * @brief Call `algo.save_impl<S>()`.
+     */
+    static void save(TDerived& algo, const std::filesystem::path& path)
+    {
+      auto f = &Accessor::template save_impl<S>;
+      (algo.*f)(path);
+    }
+
+    /**
+     * @brief Call `algo.load_impl<S>()`.
+     */
+    static void load(TDerived& algo, const std::filesystem::path& path)
+    {
+      auto f = &Accessor::template load_impl<S>;
+      (algo.*f)(path);
+    }
+
+    /**
+     * @brief Check whether `TDerived` provides `hash_impl()`.
+     */
+    static constexpr bool hashable()
+    {
+      return Hashable<Accessor>::value;
+    }
+
+    /**
+     * @brief Check whether `TDerived` provides `release_impl()`.
+     */
+    static constexpr bool releasable()
+    {
+      return Releasable<Accessor>::value;
+    }
+
+    /**
+     * @brief Detect `T::release_impl<S>()`.
+     */
+    template <typename T, typename = void>
+    struct Releasable : std::false_type {};
+
+    /**
+     * @brief Detect `T::release_impl<S>()`.
+     */
+    template <typename T>
+    struct Releasable<T, std::void_t<decltype(&T::template release_impl<S>)>> : std::true_type {};
+
+    /**
+     * @brief Detect `T::hash_impl<S>()`.
+     */
+    template <typename T, typename = void>
+    struct Hashable : std::false_type {};
+
+    /**
+     * @brief Detect `T::hash_impl<S>()`.
+     */
+    template <typename T>
+    struct Hashable<T, std::void_t<decltype(&T::template hash_impl<S>)>> : std::true_type {};
   };
 
   /**
-   * @brief Run step `S` if not done and return its output.
+   * @brief Run step `S` if not done or released, or load it from the cache.
+   * @return True if the step was evaluated or loaded by this call
+   *
+   * Concurrent calls for the same step wait for a single evaluation.
    */
   template <typename S>
-  typename S::Value evaluate_get()
+  bool evaluate_once()
   {
-    if (not evaluated<S>()) { // FIXME not thread-safe
-      const auto start = std::chrono::high_resolution_clock::now();
-      Accessor<S>::evaluate(derived());
-      const auto stop = std::chrono::high_resolution_clock::now();
-      m_milliseconds[key<S>()] = std::chrono::duration<double, std::milli>(stop - start).count();
+    auto& record = m_registry.at(key<S>());
+    if (is_available(record)) {
+      return false;
     }
-    return Accessor<S>::get(derived());
+    std::lock_guard<std::mutex> lock(record.mutex);
+    if (is_available(record)) {
+      return false; // Evaluated by another thread in the meantime
+    }
+    MemoryScope scope;
+    const auto start = std::chrono::high_resolution_clock::now();
+    const bool hit = evaluate_or_load<S>();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    record.bytes.store(scope.peak(), std::memory_order_release);
+    record.cached.store(hit, std::memory_order_release);
+    record.released.store(false, std::memory_order_release);
+    record.milliseconds.store(std::max(ms, 0.), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Check whether step `S` can be loaded from the cache, in which case its prerequisites are not needed.
+   */
+  template <typename S>
+  bool loadable()
+  {
+    if constexpr (S::Cached) {
+      return not m_cache_directory.empty() && std::filesystem::is_regular_file(cache_path<S>());
+    }
+    return false;
+  }
+
+  /**
+   * @brief Evaluate step `S`, or load it from the cache if enabled for `S`.
+   * @return True in case of cache hit
+   *
+   * Values are saved to a temporary file which is then renamed, such that incomplete files are never loaded.
+   */
+  template <typename S>
+  bool evaluate_or_load()
+  {
+    LINX_TRACE_SCOPE(typeid(S).name(), "StepperPipeline");
+    if constexpr (S::Cached) {
+      if (not m_cache_directory.empty()) {
+        const auto path = cache_path<S>();
+        if (std::filesystem::is_regular_file(path)) {
+          Accessor<S>::load(derived(), path);
+          return true;
+        }
+        Accessor<S>::evaluate(derived());
+        auto part = path;
+        part += ".part";
+        Accessor<S>::save(derived(), part);
+        std::filesystem::rename(part, path);
+        return false;
+      }
+    }
+    Accessor<S>::evaluate(derived());
+    return false;
+  }
+
+  /**
+   * @brief Check whether the value of a record is available, i.e. evaluated and not released.
+   */
+  static bool is_available(const Internal::StepRegistry::Record& record)
+  {
+    return record.milliseconds.load(std::memory_order_acquire) >= 0 &&
+        not record.released.load(std::memory_order_acquire);
   }
 
   /**
@@ -171,9 +861,14 @@ private:
   }
 
   /**
-   * @brief The set of performed steps and durations.
+   * @brief The evaluation records of the steps.
+   */
+  Internal::StepRegistry m_registry;
+
+  /**
+   * @brief The cache directory, or an empty path if caching is disabled.
    */
-  std::map<std::type_index, double> m_milliseconds;
+  std::filesystem::path m_cache_directory;
 };
 
 } // namespace Linx
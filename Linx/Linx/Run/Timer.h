@@ -8,8 +8,14 @@
 #include "Linx/Base/DataDistribution.h"
 
 #include <algorithm> // min_element, max_element
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <thread>
 #include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
 
 namespace Linx {
 
@@ -214,6 +220,340 @@ private:
   TUnit m_elapsed;
 };
 
+/**
+ * @brief A low-overhead clock based on the CPU time-stamp counter.
+ *
+ * Ticks are read with `rdtsc` on x86 and `cntvct_el0` on AArch64,
+ * which costs a few nanoseconds, against some tens for `std::chrono::steady_clock`.
+ * Other architectures fall back to `std::chrono::steady_clock`.
+ *
+ * The tick frequency is calibrated against `std::chrono::steady_clock` at first use, during about 10 ms,
+ * or read from `cntfrq_el0` on AArch64.
+ * The counter is assumed to be invariant, i.e. of constant frequency and synchronized between cores,
+ * which is the case of modern CPUs.
+ */
+class TickClock {
+public:
+
+  /**
+   * @brief Get the current tick count.
+   */
+  static std::uint64_t now()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t out;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(out));
+    return out;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /**
+   * @brief Get the tick frequency, in Hz.
+   */
+  static double frequency()
+  {
+    static const double out = calibrate();
+    return out;
+  }
+
+  /**
+   * @brief Convert a tick count to some duration unit.
+   */
+  template <typename TUnit = std::chrono::nanoseconds>
+  static double to(std::uint64_t ticks)
+  {
+    return static_cast<double>(ticks) / frequency() * TUnit::period::den / TUnit::period::num;
+  }
+
+private:
+
+  /**
+   * @brief Measure the tick frequency.
+   */
+  static double calibrate()
+  {
+#if defined(__aarch64__)
+    std::uint64_t out;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(out));
+    return static_cast<double>(out);
+#elif defined(__x86_64__) || defined(__i386__)
+    const auto start = std::chrono::steady_clock::now();
+    const auto tic = now();
+    auto stop = start;
+    while (stop - start < std::chrono::milliseconds(10)) {
+      stop = std::chrono::steady_clock::now();
+    }
+    const auto toc = now();
+    return (toc - tic) / std::chrono::duration<double>(stop - start).count();
+#else
+    return 1e9;
+#endif
+  }
+};
+
+/**
+ * @brief A store of tick durations, which can be fed concurrently, e.g. by `ScopedTimer`s.
+ *
+ * Each thread accumulates into its own slot, which is allocated at its first sample,
+ * such that samples are pushed without locking nor allocation.
+ * Each slot retains up to `capacity()` samples, beyond which samples are only accounted in `count()` and `total()`.
+ * Slots are merged on demand, e.g. by `distribution()`, which must not be called concurrently with pushes.
+ *
+ * \code
+ * TickSamples samples;
+ * #pragma omp parallel for
+ * for (Index i = 0; i < tile_count; ++i) {
+ *   ScopedTimer timer(samples);
+ *   process(tiles[i]);
+ * }
+ * const auto us = samples.distribution<std::chrono::microseconds>();
+ * std::cout << us.mean() << " +/- " << us.stdev() << " us" << std::endl;
+ * \endcode
+ */
+class TickSamples {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param capacity The maximum number of samples retained per thread
+   */
+  explicit TickSamples(Index capacity = 1 << 16) : m_id(next_id()), m_capacity(capacity), m_head(nullptr) {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  TickSamples(const TickSamples&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  TickSamples& operator=(const TickSamples&) = delete;
+
+  /**
+   * @brief Destructor.
+   */
+  ~TickSamples()
+  {
+    auto* s = m_head.load();
+    while (s) {
+      auto* next = s->next;
+      delete s;
+      s = next;
+    }
+  }
+
+  /**
+   * @brief Get the maximum number of samples retained per thread.
+   */
+  Index capacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Push a sample from the calling thread.
+   */
+  void push(std::uint64_t ticks)
+  {
+    auto& s = slot();
+    if (s.count < m_capacity) {
+      s.samples[s.count] = ticks;
+    }
+    ++s.count;
+    s.total += ticks;
+  }
+
+  /**
+   * @brief Get the number of pushed samples, including those which were not retained.
+   */
+  Index count() const
+  {
+    Index out = 0;
+    for_each([&](const Slot& s) {
+      out += s.count;
+    });
+    return out;
+  }
+
+  /**
+   * @brief Get the sum of the pushed samples, including those which were not retained.
+   */
+  template <typename TUnit = std::chrono::nanoseconds>
+  double total() const
+  {
+    std::uint64_t out = 0;
+    for_each([&](const Slot& s) {
+      out += s.total;
+    });
+    return TickClock::to<TUnit>(out);
+  }
+
+  /**
+   * @brief Merge the retained samples of all threads.
+   */
+  template <typename TUnit = std::chrono::nanoseconds>
+  std::vector<double> merge() const
+  {
+    std::vector<double> out;
+    for_each([&](const Slot& s) {
+      const auto size = std::min(s.count, m_capacity);
+      for (Index i = 0; i < size; ++i) {
+        out.push_back(TickClock::to<TUnit>(s.samples[i]));
+      }
+    });
+    return out;
+  }
+
+  /**
+   * @brief Get the distribution of the retained samples of all threads.
+   */
+  template <typename TUnit = std::chrono::nanoseconds>
+  DataDistribution<double> distribution() const
+  {
+    return DataDistribution<double>(merge<TUnit>());
+  }
+
+  /**
+   * @brief Discard the samples, keeping the slots allocated.
+   */
+  void clear()
+  {
+    for (auto* s = m_head.load(std::memory_order_acquire); s; s = s->next) {
+      s->count = 0;
+      s->total = 0;
+    }
+  }
+
+private:
+
+  /**
+   * @brief The samples of a thread.
+   */
+  struct Slot {
+    Slot(std::thread::id t, Index capacity) : thread(t), samples(capacity), count(0), total(0), next(nullptr) {}
+    std::thread::id thread;
+    std::vector<std::uint64_t> samples;
+    Index count;
+    std::uint64_t total;
+    Slot* next;
+  };
+
+  /**
+   * @brief Get a unique identifier, such that thread-local caches are not fooled by address reuse.
+   */
+  static std::uint64_t next_id()
+  {
+    static std::atomic<std::uint64_t> id(0);
+    return ++id;
+  }
+
+  /**
+   * @brief Get the slot of the calling thread, which is created if needed.
+   */
+  Slot& slot()
+  {
+    thread_local std::uint64_t cached_id = 0;
+    thread_local Slot* cached_slot = nullptr;
+    if (cached_id == m_id) {
+      return *cached_slot;
+    }
+    const auto thread = std::this_thread::get_id();
+    auto* head = m_head.load(std::memory_order_acquire);
+    Slot* out = nullptr;
+    for (auto* s = head; s; s = s->next) {
+      if (s->thread == thread) {
+        out = s;
+        break;
+      }
+    }
+    if (not out) {
+      out = new Slot(thread, m_capacity); // Only this thread inserts its slot
+      do {
+        out->next = head;
+      } while (not m_head.compare_exchange_weak(head, out, std::memory_order_release, std::memory_order_acquire));
+    }
+    cached_id = m_id;
+    cached_slot = out;
+    return *out;
+  }
+
+  /**
+   * @brief Apply a function to each slot.
+   */
+  template <typename TFunc>
+  void for_each(TFunc&& func) const
+  {
+    for (auto* s = m_head.load(std::memory_order_acquire); s; s = s->next) {
+      func(*s);
+    }
+  }
+
+  /**
+   * @brief The unique identifier.
+   */
+  std::uint64_t m_id;
+
+  /**
+   * @brief The maximum number of samples retained per thread.
+   */
+  Index m_capacity;
+
+  /**
+   * @brief The most recently allocated slot.
+   */
+  std::atomic<Slot*> m_head;
+};
+
+/**
+ * @brief A RAII timer which pushes the duration of its scope to some `TickSamples`.
+ *
+ * Measuring a scope costs two reads of the `TickClock` and a store to a thread-local slot,
+ * such that inner loops, e.g. tiles of a filter, can be instrumented.
+ */
+class ScopedTimer {
+public:
+
+  /**
+   * @brief Constructor, which starts the timer.
+   */
+  explicit ScopedTimer(TickSamples& samples) : m_samples(samples), m_tic(TickClock::now()) {}
+
+  /**
+   * @brief Non-copyable.
+   */
+  ScopedTimer(const ScopedTimer&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  /**
+   * @brief Destructor, which stops the timer and pushes the elapsed ticks.
+   */
+  ~ScopedTimer()
+  {
+    m_samples.push(TickClock::now() - m_tic);
+  }
+
+private:
+
+  /**
+   * @brief The sample store.
+   */
+  TickSamples& m_samples;
+
+  /**
+   * @brief The start tick count.
+   */
+  std::uint64_t m_tic;
+};
+
 } // namespace Linx
 
 #endif
@@ -5,17 +5,39 @@
 #ifndef _LINXTRANSFORMS_AFFINITY_H
 #define _LINXTRANSFORMS_AFFINITY_H
 
+#include "Linx/Base/Precompiled.h"
+#include "Linx/Base/Trace.h"
+#include "Linx/Data/Matrix.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Data/Vector.h"
+#include "Linx/Transforms/Extrapolation.h"
 #include "Linx/Transforms/Interpolation.h"
+#include "Linx/Transforms/SimpleFilter.h" // resolve_thread_count, split_bands, output_patch
+#include "Linx/Transforms/impl/PlaneWarping.h"
 
-#include <eigen3/Eigen/Core>
-#include <eigen3/Eigen/LU> // inverse
+#include <algorithm> // clamp
+#include <array>
+#include <cmath> // ceil, floor
+#include <utility> // pair
+#include <vector>
 
 namespace Linx {
 
 /// @cond
 
+namespace Internal {
+
+/**
+ * @brief Test whether an input of `Affinity::transform()` is an `Interpolation`, which may have an interior.
+ */
+template <typename TIn>
+struct IsInterpolation : std::false_type {};
+
+template <typename TParent, typename TMethod>
+struct IsInterpolation<Interpolation<TParent, TMethod>> : std::true_type {};
+
+} // namespace Internal
+
 // Forward declare for inverse
 template <Index N = 2>
 class Affinity;
@@ -33,7 +55,7 @@ Affinity<N> inverse(const Affinity<N>& in);
 template <typename TIn>
 Vector<double, TIn::Dimension> center(const TIn& in)
 {
-  const auto& domain = box(in.domain());
+  const auto domain = box(in.domain()); // Copy, since domain() may return a temporary
   Vector<double, TIn::Dimension> out(domain.front() + domain.back());
   out /= 2;
   return out;
@@ -100,25 +122,27 @@ Vector<double, TIn::Dimension> center(const TIn& in)
  * out = upsample<Cubic>(in, 3);
  * \endcode
  * 
- * \note
- * This class depends on Eigen.
+ * Warping can be parallelized over bands of rows with `parallelize()`,
+ * in which case each thread works with its own copy of the interpolator,
+ * and the output is identical to the sequential output:
+ * 
+ * \code
+ * auto out = Affinity<2>::rotation_deg(30, 0, 1, center(in)).parallelize(8).warp<Cubic>(in);
+ * \endcode
+ * 
+ * The linear map is a fixed-size `Matrix`, such that composition, inversion and application never allocate.
+ * The dimension must therefore be fixed at compile time (`N &ge; 0`).
  */
 template <Index N>
 class Affinity {
-private:
-
-  using EigenMatrix = Eigen::Matrix<double, N, N, Eigen::RowMajor>;
-  using EigenVector = Eigen::Matrix<double, N, 1>;
-  using EigenDiagonal = Eigen::DiagonalMatrix<double, N>;
-
 public:
 
   /**
    * @brief Create an affinity around given center.
    */
   explicit Affinity(const Vector<double, N>& center = Vector<double, N>::zero()) :
-      m_map(EigenMatrix::Identity(center.size(), center.size())), m_translation(EigenVector::Zero(center.size())),
-      m_center(to_eigen_vector(center))
+      m_map(Matrix<double, N>::identity()), m_translation(Vector<double, N>::zero()), m_center(center),
+      m_thread_count(1)
   {}
 
   /**
@@ -188,7 +212,7 @@ public:
   Affinity& operator+=(const Vector<double, N>& vector)
   {
     if (not vector.is_zero()) {
-      m_translation += to_eigen_vector(vector);
+      m_translation += vector;
     }
     return *this;
   }
@@ -208,7 +232,7 @@ public:
   Affinity& operator-=(const Vector<double, N>& vector)
   {
     if (not vector.is_zero()) {
-      m_translation -= to_eigen_vector(vector);
+      m_translation -= vector;
     }
     return *this;
   }
@@ -218,7 +242,7 @@ public:
    */
   Affinity& operator*=(double value)
   {
-    m_map *= EigenVector::Constant(m_translation.size(), value).asDiagonal();
+    m_map *= value;
     return *this;
   }
 
@@ -228,7 +252,9 @@ public:
   Affinity& operator*=(const Vector<double, N>& vector)
   {
     if (not vector.is_one()) {
-      m_map *= to_eigen_vector(vector).asDiagonal();
+      scale_columns(vector, [](auto& m, auto v) {
+        m *= v;
+      });
     }
     return *this;
   }
@@ -247,7 +273,9 @@ public:
   Affinity& operator/=(const Vector<double, N>& vector)
   {
     if (not vector.is_one()) {
-      m_map *= to_eigen_vector(vector).cwiseInverse().asDiagonal();
+      scale_columns(vector, [](auto& m, auto v) {
+        m /= v;
+      });
     }
     return *this;
   }
@@ -258,14 +286,14 @@ public:
   Affinity& rotate_rad(double angle, Index from = 0, Index to = 1)
   {
     if (angle != 0) {
-      EigenMatrix rotation = EigenMatrix::Identity();
+      auto rotation = Matrix<double, N>::identity();
       const auto sin = std::sin(angle);
       const auto cos = std::cos(angle);
       rotation(from, from) = cos;
       rotation(from, to) = -sin;
       rotation(to, from) = sin;
       rotation(to, to) = cos;
-      m_map *= rotation;
+      m_map = m_map * rotation;
     }
     return *this;
   }
@@ -283,47 +311,195 @@ public:
    */
   Affinity& inverse()
   {
-    m_map = m_map.inverse().eval();
-    m_translation = -m_map * m_translation;
+    m_map.inverse();
+    m_translation = -(m_map * m_translation);
     return *this;
   }
 
+  /**
+   * @brief Set the number of threads used by `transform()` and `warp()`.
+   * @param count The number of threads, or a value <= 0 to use as many threads as available
+   */
+  Affinity& parallelize(Index count = -1)
+  {
+    m_thread_count = count;
+    return *this;
+  }
+
+  /**
+   * @brief Get the number of threads used by `transform()` and `warp()`.
+   * @see `parallelize()`
+   */
+  Index thread_count() const
+  {
+    return Internal::resolve_thread_count(m_thread_count);
+  }
+
   /**
    * @brief Apply the transform to an input vector.
    */
   template <typename T>
   Vector<double, N> operator()(const Vector<T, N>& in) const
   {
-    return Vector<double, N>(m_translation + m_center + m_map * (to_eigen_vector(in) - m_center));
-    // TODO faster without cast, i.e. without Eigen?
+    auto out = offset();
+    const auto size = static_cast<Index>(out.size());
+    for (Index i = 0; i < size; ++i) {
+      auto& o = out[i];
+      for (Index j = 1; j < size; ++j) {
+        o += m_map(i, j) * in[j];
+      }
+      o += m_map(i, 0) * in[0]; // Last, like in transform()
+    }
+    return out;
   }
 
   /**
    * @brief Apply the transform with a given interpolation method.
    */
   template <typename TInterpolation, typename TIn, typename... TArgs>
-  Raster<typename TIn::Value, TIn::Dimension> warp(const TIn& in, TArgs&&... args) const
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> warp(const TIn& in, TArgs&&... args) const
   {
-    Raster<typename TIn::Value, TIn::Dimension> out(in.shape());
+    Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(in.shape());
     transform(interpolation<TInterpolation>(in, LINX_FORWARD(args)...), out);
     return out;
   }
 
+  /**
+   * @brief Apply the transform to several planes of the same shape, with shared mapping and weights.
+   * @tparam TInterpolation The separable interpolation method, e.g. `Linear` or `Cubic`
+   * @param in The input planes, e.g. the bands of a multi-band image
+   * @param out The output planes, of the shape of the input planes, which are overwritten
+   * @param extrapolation The extrapolation method, e.g. `Nearest` or `Constant<float>(0)`
+   *
+   * The inverse mapping, the decomposition of the input position and the interpolation weights
+   * are computed once per output pixel, and applied to every plane,
+   * instead of once per plane with as many calls to `warp()`.
+   * Planes are contiguous rasters, e.g. `Raster`s or `PtrRaster`s.
+   *
+   * @see `warp_channels()` for planes stored along the last axis of a single raster
+   */
+  template <typename TInterpolation, typename TIn, typename TOut, typename TExtrapolation = Nearest>
+  void warp_planes(const std::vector<TIn>& in, std::vector<TOut>& out, TExtrapolation extrapolation = TExtrapolation())
+      const
+  {
+    warp_groups(Internal::PlaneGroup<TInterpolation, TExtrapolation, TIn, TOut>(in, out, LINX_MOVE(extrapolation)));
+  }
+
+  /**
+   * @brief Apply the transform to several data planes and mask planes with different interpolation methods.
+   * @tparam TInterpolation The interpolation method of the data planes, e.g. `Cubic`
+   * @tparam TMaskInterpolation The interpolation method of the mask planes, e.g. `Nearest`
+   *
+   * This is typically used to register (data, variance, mask) triplets:
+   * the inverse mapping is computed once per output pixel for all the planes,
+   * and the weights once per method.
+   *
+   * \code
+   * std::vector<PtrRaster<const float>> data {image, variance};
+   * std::vector<PtrRaster<float>> warped {warped_image, warped_variance};
+   * std::vector<PtrRaster<const char>> masks {mask};
+   * std::vector<PtrRaster<char>> warped_masks {warped_mask};
+   * affinity.warp_planes<Cubic, Nearest>(data, warped, masks, warped_masks);
+   * \endcode
+   */
+  template <
+      typename TInterpolation,
+      typename TMaskInterpolation,
+      typename TIn,
+      typename TOut,
+      typename TMask,
+      typename TMaskOut,
+      typename TExtrapolation = Nearest>
+  void warp_planes(
+      const std::vector<TIn>& in,
+      std::vector<TOut>& out,
+      const std::vector<TMask>& masks,
+      std::vector<TMaskOut>& mask_out,
+      TExtrapolation extrapolation = TExtrapolation()) const
+  {
+    const Internal::PlaneGroup<TInterpolation, TExtrapolation, TIn, TOut> data(in, out, extrapolation);
+    const Internal::PlaneGroup<TMaskInterpolation, TExtrapolation, TMask, TMaskOut> mask(
+        masks,
+        mask_out,
+        LINX_MOVE(extrapolation));
+    if (not in.empty() && not masks.empty() && data.shape() != mask.shape()) {
+      throw Exception("Shapes of the warped planes differ");
+    }
+    if (in.empty()) {
+      warp_groups(mask);
+    } else {
+      warp_groups(data, mask);
+    }
+  }
+
+  /**
+   * @brief Apply the transform to each plane of a raster, whose last axis is a channel axis.
+   * @tparam TInterpolation The separable interpolation method
+   * @param in The input raster, of dimension `N + 1`
+   * @param extrapolation The extrapolation method
+   *
+   * The planes are the contiguous slices along the last axis, which are warped with shared weights,
+   * see `warp_planes()`.
+   */
+  template <typename TInterpolation, typename T, Index M, typename THolder, typename TExtrapolation = Nearest>
+  Raster<std::remove_cv_t<T>, M>
+  warp_channels(const Raster<T, M, THolder>& in, TExtrapolation extrapolation = TExtrapolation()) const
+  {
+    static_assert(M == N + 1, "The input must have one more axis than the affinity.");
+    Raster<std::remove_cv_t<T>, M> out(in.shape());
+    Position<N> shape;
+    for (Index i = 0; i < N; ++i) {
+      shape[i] = in.shape()[i];
+    }
+    const auto size = shape_size(shape);
+    std::vector<PtrRaster<const T, N>> in_planes;
+    std::vector<PtrRaster<std::remove_cv_t<T>, N>> out_planes;
+    for (Index c = 0; c < in.shape()[N]; ++c) {
+      in_planes.emplace_back(shape, in.data() + c * size);
+      out_planes.emplace_back(shape, out.data() + c * size);
+    }
+    warp_planes<TInterpolation>(in_planes, out_planes, LINX_MOVE(extrapolation));
+    return out;
+  }
+
   /**
    * @brief Apply the transform to an input interpolator.
    * 
    * The domain of the output parameter (which can be a raster or a patch)
    * is used to decide which positions to take into account.
    * If positions outside the input domain are required, then `in` must be an extrapolator, too.
+   * 
+   * If the output domain is a box, it is processed by bands of rows, in parallel according to `parallelize()`.
    */
   template <typename TIn, typename TOut>
   TOut& transform(const TIn& in, TOut& out) const
   {
+    LINX_TRACE_SCOPE("Affinity::transform", "Transforms");
     const Affinity inv = Linx::inverse(*this);
-    auto it = out.begin();
-    for (const auto& p : out.domain()) {
-      *it = in(inv(p));
-      ++it;
+    if constexpr (std::is_same_v<std::decay_t<decltype(out.domain())>, Box<N>>) {
+      const auto domain = out.domain();
+      const auto threads = thread_count();
+      if (threads == 1) {
+        auto it = out.begin();
+        inv.transform_rows(in, domain, it);
+        return out;
+      }
+      const auto bands = Internal::split_bands(domain, bands_per_thread * threads);
+      const auto size = static_cast<Index>(bands.size());
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(std::min(threads, size)))
+      for (Index b = 0; b < size; ++b) {
+        LINX_TRACE_SCOPE("Affinity::band", "Transforms");
+        const auto local = in; // Per-thread interpolator
+        auto outsub = Internal::output_patch(out, bands[b] - domain.front());
+        auto it = outsub.begin();
+        inv.transform_rows(local, bands[b], it);
+      }
+    } else {
+      auto it = out.begin();
+      for (const auto& p : out.domain()) {
+        *it = in(inv(p));
+        ++it;
+      }
     }
     return out;
   }
@@ -331,30 +507,225 @@ public:
 private:
 
   /**
-   * @brief Copy a vector into an `EigenVector`.
+   * @brief Get the image of the origin, i.e. `b + c - a * c`.
    */
-  template <typename T>
-  static EigenVector to_eigen_vector(const Vector<T, N>& in)
+  Vector<double, N> offset() const
   {
-    EigenVector out(in.size());
-    std::copy(in.begin(), in.end(), out.begin());
+    const auto size = static_cast<Index>(m_center.size());
+    Vector<double, N> out(size);
+    for (Index i = 0; i < size; ++i) {
+      auto& o = out[i];
+      o = m_translation[i] + m_center[i];
+      for (Index j = 0; j < size; ++j) {
+        o -= m_map(i, j) * m_center[j];
+      }
+    }
     return out;
   }
 
+  /**
+   * @brief Apply the transform to the positions of a box, row by row, and assign the interpolated values.
+   * 
+   * The contribution of the axes other than 0 is computed once per row,
+   * such that each position only costs one multiply-add per axis, without rounding drift.
+   * The result is bitwise identical to `operator()`.
+   * 
+   * If the interpolator has an interior (see `Interpolation::interior()`),
+   * then each row is split into an interior segment, which is interpolated without extrapolation,
+   * and border segments, which are interpolated with extrapolation.
+   */
+  template <typename TIn, typename TIt>
+  void transform_rows(const TIn& in, const Box<N>& domain, TIt& it) const
+  {
+    if constexpr (Internal::IsInterpolation<TIn>::value) {
+      if constexpr (TIn::HasInterior) {
+        transform_rows(in, in.unchecked(), in.interior(), domain, it);
+        return;
+      }
+    }
+    transform_rows(in, in, {}, domain, it);
+  }
+
+  /**
+   * @brief Apply the transform to the positions of a box, row by row,
+   * with a specific interpolator in some interior.
+   * 
+   * Rows are split into at most three segments, such that the interior is read with `inner`
+   * and the rest is read with `in`.
+   * The interior is shrunk by half a pixel, which is much larger than rounding errors.
+   * If `inner` and `in` are of the same type, then `in` is used everywhere.
+   */
+  template <typename TIn, typename TInner, typename TIt>
+  void transform_rows(
+      const TIn& in,
+      const TInner& inner,
+      const std::pair<Vector<double, N>, Vector<double, N>>& interior,
+      const Box<N>& domain,
+      TIt& it) const
+  {
+    const auto size = static_cast<Index>(m_center.size());
+    const auto front = domain.front()[0];
+    const auto width = domain.length(0);
+    if (width <= 0) {
+      return;
+    }
+    const auto origin = offset();
+    Vector<double, N> step(size);
+    for (Index i = 0; i < size; ++i) {
+      step[i] = m_map(i, 0);
+    }
+    Vector<double, N> row(size);
+    Vector<double, N> q(size);
+    for_each_row(domain, [&](const auto& r, Index) {
+      for (Index i = 0; i < size; ++i) {
+        auto& o = row[i];
+        o = origin[i];
+        for (Index j = 1; j < size; ++j) {
+          o += m_map(i, j) * r[j];
+        }
+      }
+      const auto end = front + width;
+      auto begin_inner = end;
+      auto end_inner = end;
+      if constexpr (not std::is_same_v<TIn, TInner>) {
+        double lo = front;
+        double hi = end;
+        for (Index i = 0; i < size; ++i) {
+          const auto a = interior.first[i] + .5 - row[i];
+          const auto b = interior.second[i] - .5 - row[i];
+          if (step[i] > 0) {
+            lo = std::max(lo, a / step[i]);
+            hi = std::min(hi, b / step[i]);
+          } else if (step[i] < 0) {
+            lo = std::max(lo, b / step[i]);
+            hi = std::min(hi, a / step[i]);
+          } else if (a > 0 || b < 0) {
+            hi = lo;
+          }
+        }
+        if (lo < hi) {
+          begin_inner = static_cast<Index>(std::ceil(lo));
+          end_inner = std::max(begin_inner, static_cast<Index>(std::floor(hi)) + 1);
+          end_inner = std::min(end_inner, end);
+        }
+      }
+      const auto fill = [&](const auto& interpolator, Index from, Index to) {
+        for (Index x = from; x < to; ++x, ++it) {
+          for (Index i = 0; i < size; ++i) {
+            q[i] = row[i] + step[i] * x;
+          }
+          *it = interpolator(q);
+        }
+      };
+      fill(in, front, begin_inner);
+      fill(inner, begin_inner, end_inner);
+      fill(in, end_inner, end);
+    });
+  }
+
+  /**
+   * @brief Apply the transform to groups of planes of the same shape.
+   */
+  template <typename TGroup, typename... TGroups>
+  void warp_groups(const TGroup& group, const TGroups&... groups) const
+  {
+    LINX_TRACE_SCOPE("Affinity::warp_planes", "Transforms");
+    const Affinity inv = Linx::inverse(*this);
+    const auto& shape = group.shape();
+    const auto domain = Box<N>::from_shape(Position<N>::zero(), shape);
+    const auto threads = thread_count();
+    const auto bands = Internal::split_bands(domain, bands_per_thread * threads);
+    const auto size = static_cast<Index>(bands.size());
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(std::max<Index>(1, std::min(threads, size))))
+    for (Index b = 0; b < size; ++b) {
+      inv.map_rows(bands[b], shape, [&](const auto& q, Index index) {
+        group(q, index);
+        (groups(q, index), ...);
+      });
+    }
+  }
+
+  /**
+   * @brief Apply the transform to the positions of a box, row by row, and call a function on the result.
+   * @param domain The box
+   * @param shape The shape of the raster, which is used to compute the indices of the positions
+   * @param func The function, called as `func(image, index)`
+   *
+   * The images are computed like in `transform_rows()`.
+   */
+  template <typename TFunc>
+  void map_rows(const Box<N>& domain, const Position<N>& shape, TFunc&& func) const
+  {
+    const auto front = domain.front()[0];
+    const auto width = domain.length(0);
+    if (width <= 0) {
+      return;
+    }
+    const auto origin = offset();
+    Vector<double, N> step;
+    for (Index i = 0; i < N; ++i) {
+      step[i] = m_map(i, 0);
+    }
+    Vector<double, N> row;
+    Vector<double, N> q;
+    for_each_row(domain, [&](const auto& r, Index) {
+      Index index = 0;
+      Index stride = 1;
+      for (Index i = 0; i < N; ++i) {
+        auto& o = row[i];
+        o = origin[i];
+        for (Index j = 1; j < N; ++j) {
+          o += m_map(i, j) * r[j];
+        }
+        index += r[i] * stride;
+        stride *= shape[i];
+      }
+      for (Index x = front; x < front + width; ++x, ++index) {
+        for (Index i = 0; i < N; ++i) {
+          q[i] = row[i] + step[i] * x;
+        }
+        func(q, index);
+      }
+    });
+  }
+
+  /**
+   * @brief Scale each column of the map by the matching value of a vector, i.e. right-multiply by a diagonal.
+   */
+  template <typename TFunc>
+  void scale_columns(const Vector<double, N>& vector, TFunc&& func)
+  {
+    for (Index i = 0; i < N; ++i) {
+      for (Index j = 0; j < N; ++j) {
+        func(m_map(i, j), vector[j]);
+      }
+    }
+  }
+
   /**
    * @brief The linear map.
    */
-  EigenMatrix m_map;
+  Matrix<double, N> m_map;
 
   /**
    * @brief The translation vector.
    */
-  EigenVector m_translation;
+  Vector<double, N> m_translation;
 
   /**
    * @brief The linear map center.
    */
-  EigenVector m_center;
+  Vector<double, N> m_center;
+
+  /**
+   * @brief The number of bands per thread, for load balancing.
+   */
+  static constexpr Index bands_per_thread = 4;
+
+  /**
+   * @brief The number of threads.
+   */
+  Index m_thread_count;
 };
 
 /**
@@ -369,24 +740,496 @@ Affinity<N> inverse(const Affinity<N>& in)
   return out;
 }
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The raster and extrapolation method of an input which can be resampled axis by axis.
+ * 
+ * Rasters are read as if extrapolated with `Nearest`, although no value outside their domain should be required.
+ * Extrapolators are supported if their method remaps indices axis by axis.
+ */
+template <typename TIn>
+struct SeparableSource : std::false_type {};
+
+template <typename T, Index N, typename THolder>
+struct SeparableSource<Raster<T, N, THolder>> : std::true_type {
+  static const Raster<T, N, THolder>& raster(const Raster<T, N, THolder>& in)
+  {
+    return in;
+  }
+
+  static Nearest method(const Raster<T, N, THolder>&)
+  {
+    return {};
+  }
+};
+
+template <typename T, Index N, typename THolder, typename TMethod>
+struct SeparableSource<Extrapolation<Raster<T, N, THolder>, TMethod>> : RemapsIndex<TMethod> {
+  static const Raster<T, N, THolder>& raster(const Extrapolation<Raster<T, N, THolder>, TMethod>& in)
+  {
+    return in.raster();
+  }
+
+  static const TMethod& method(const Extrapolation<Raster<T, N, THolder>, TMethod>& in)
+  {
+    return in.method();
+  }
+};
+
+/**
+ * @brief Copy a shifted box of some input, i.e. `out[p] = in[p - shift]`, by blocks of rows.
+ */
+template <typename TIn, typename TOut>
+void shift_copy(const TIn& in, const Position<TIn::Dimension>& shift, TOut& out)
+{
+  const auto region = Box<TIn::Dimension>::from_shape(-shift, out.shape());
+  if constexpr (is_extrapolator<TIn>()) {
+    in.copy_to(region, out);
+  } else {
+    extrapolation<Nearest>(in).copy_to(region, out);
+  }
+}
+
+/**
+ * @brief The precomputed samples of a 1D resampling.
+ * 
+ * For each output index `x`, the value is `biases[x] + sum_k weights[x * support + k] * in[indices[x * support + k]]`,
+ * where the bias is the contribution of the constant extrapolation value, if any.
+ */
+template <typename T>
+struct ResamplingAxis {
+  Index support; ///< The number of samples per output index
+  std::vector<Index> indices; ///< The input indices of the samples
+  std::vector<double> weights; ///< The weights of the samples
+  std::vector<T> biases; ///< The contributions of the extrapolation value
+};
+
+/**
+ * @brief Precompute the samples of a 1D resampling, given the input coordinate of each output index.
+ */
+template <typename T, typename TInterpolation, typename TExtrapolation, typename TCoordinate>
+ResamplingAxis<T> resampling_axis(
+    const TInterpolation& interpolation,
+    const TExtrapolation& extrapolation,
+    Index in_length,
+    Index out_length,
+    TCoordinate&& coordinate)
+{
+  constexpr Index support = TInterpolation::Support;
+  T constant {};
+  if constexpr (std::is_convertible_v<const TExtrapolation&, T>) {
+    constant = T(extrapolation);
+  }
+  ResamplingAxis<T> out {
+      support,
+      std::vector<Index>(out_length * support, 0),
+      std::vector<double>(out_length * support, 0),
+      std::vector<T>(out_length, T {})};
+  std::array<double, support> weights;
+  for (Index x = 0; x < out_length; ++x) {
+    const auto first = interpolation.weights(coordinate(x), weights);
+    for (Index k = 0; k < support; ++k) {
+      const auto j = extrapolation.index(first + k, in_length);
+      if (j >= 0) {
+        out.indices[x * support + k] = j;
+        out.weights[x * support + k] = weights[k];
+      } else {
+        out.biases[x] += weights[k] * constant; // Out of bounds for constant extrapolation only
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Resample contiguous data along some axis.
+ * 
+ * The data is seen as a 3D array of shape `(inner, length, outer)`, where `length` is the length along the axis,
+ * such that the inner loop is contiguous whatever the axis.
+ */
+template <typename T, typename U, typename V, typename TShape>
+void resample_axis(
+    const U* in,
+    const TShape& shape,
+    Index axis,
+    const ResamplingAxis<T>& samples,
+    V* out,
+    Index threads)
+{
+  Index inner = 1;
+  for (Index i = 0; i < axis; ++i) {
+    inner *= shape[i];
+  }
+  Index outer = 1;
+  for (Index i = axis + 1; i < static_cast<Index>(shape.size()); ++i) {
+    outer *= shape[i];
+  }
+  const auto in_length = shape[axis];
+  const auto out_length = static_cast<Index>(samples.biases.size());
+  const auto support = samples.support;
+  const auto count = outer * out_length;
+#pragma omp parallel for num_threads(static_cast<int>(threads))
+  for (Index l = 0; l < count; ++l) {
+    const auto x = l % out_length;
+    const auto* src = in + (l / out_length) * inner * in_length;
+    auto* dst = out + l * inner;
+    const auto* indices = samples.indices.data() + x * support;
+    const auto* weights = samples.weights.data() + x * support;
+    for (Index c = 0; c < inner; ++c) {
+      T value = samples.biases[x];
+      for (Index k = 0; k < support; ++k) {
+        value += weights[k] * T(src[indices[k] * inner + c]);
+      }
+      dst[c] = value;
+    }
+  }
+}
+
+/**
+ * @brief Apply an axis-aligned scaling to a raster by successive 1D resamplings along each axis.
+ * 
+ * If `skip_identity` is true, then the axes which are not resampled are skipped.
+ */
+template <typename TInterpolation, typename T, typename TRaster, typename TMethod, Index N, typename TOut>
+void separable_passes(
+    const TRaster& raster,
+    const TMethod& method,
+    const Affinity<N>& affinity,
+    TOut& out,
+    Index threads,
+    bool skip_identity)
+{
+  const TInterpolation interpolation {};
+  const auto inv = inverse(affinity);
+  const auto dimension = raster.dimension();
+  const auto count = resolve_thread_count(threads);
+  const auto origin = Vector<double, N>::zero(dimension);
+  std::vector<Index> axes;
+  for (Index i = 0; i < dimension; ++i) {
+    auto unit = origin;
+    unit[i] = 1;
+    if (not skip_identity || inv(origin)[i] != 0 || inv(unit)[i] != 1 || raster.shape()[i] != out.shape()[i]) {
+      axes.push_back(i);
+    }
+  }
+  if (axes.empty()) {
+    std::copy(raster.begin(), raster.end(), out.begin());
+    return;
+  }
+  PoolRaster<T, N> current; // Pooled, such that repeated warps do not allocate
+  for (std::size_t k = 0; k < axes.size(); ++k) {
+    const auto axis = axes[k];
+    const auto shape = k == 0 ? raster.shape() : current.shape();
+    auto next_shape = shape;
+    next_shape[axis] = out.shape()[axis];
+    const auto samples = resampling_axis<T>(interpolation, method, shape[axis], next_shape[axis], [&](Index x) {
+      auto p = origin;
+      p[axis] = x;
+      return inv(p)[axis];
+    });
+    const bool last = k + 1 == axes.size();
+    PoolRaster<T, N> next(last ? Position<N>::zero(dimension) : next_shape, uninitialized);
+    if (k == 0) {
+      last ? resample_axis(raster.data(), shape, axis, samples, out.data(), count) :
+             resample_axis(raster.data(), shape, axis, samples, next.data(), count);
+    } else {
+      last ? resample_axis(current.data(), shape, axis, samples, out.data(), count) :
+             resample_axis(current.data(), shape, axis, samples, next.data(), count);
+    }
+    current = LINX_MOVE(next);
+  }
+}
+
+/**
+ * @brief Apply an axis-aligned scaling by successive 1D resamplings along each axis.
+ * 
+ * If the interpolation method requires a prefilter, then the coefficients are computed first.
+ * Otherwise, the axes which are not resampled are skipped.
+ */
+template <typename TInterpolation, typename TIn, Index N, typename TOut>
+void separable_warp(const TIn& in, const Affinity<N>& affinity, TOut& out, Index threads)
+{
+  using T = typename TypeTraits<std::decay_t<typename TIn::Value>>::Floating;
+  if constexpr (Prefilters<TInterpolation>::value) {
+    using Source = PrefilterSource<TIn, T>;
+    const auto coefficients = TInterpolation().template prefilter<T>(Source::raster(in));
+    separable_passes<TInterpolation, T>(coefficients, Source::method(in), affinity, out, threads, false);
+  } else {
+    using Source = SeparableSource<TIn>;
+    separable_passes<TInterpolation, T>(Source::raster(in), Source::method(in), affinity, out, threads, true);
+  }
+}
+
+/**
+ * @brief Compute the weights of some position, and get the index of the first sample.
+ * 
+ * The weights only depend on the fractional part of the position,
+ * such that they are valid for all the positions shifted by an integer.
+ */
+template <typename TInterpolation>
+Index shift_weights(
+    const TInterpolation& interpolation,
+    double position,
+    std::array<double, TInterpolation::Support>& weights)
+{
+  const auto floor = std::floor(position);
+  return interpolation.weights(position - floor, weights) + static_cast<Index>(floor);
+}
+
+/**
+ * @brief Resample a contiguous line with a constant shift, i.e. `out[x] = in(x + shift)`.
+ * @param in The input line, whose first element is at coordinate `in_front`
+ * @param out The output line, whose first element is at coordinate `out_front`
+ * 
+ * Since the shift is constant, the weights are computed once for the whole line.
+ * The input line must contain all the samples.
+ */
+template <typename TInterpolation, typename T, typename U, typename V>
+void shift_line(
+    const TInterpolation& interpolation,
+    double shift,
+    const U* in,
+    Index in_front,
+    V* out,
+    Index out_front,
+    Index out_length,
+    Index out_stride)
+{
+  constexpr Index support = TInterpolation::Support;
+  std::array<double, support> weights;
+  const auto* src = in + shift_weights(interpolation, out_front + shift, weights) - in_front;
+  for (Index x = 0; x < out_length; ++x, ++src) {
+    T value {};
+    for (Index k = 0; k < support; ++k) {
+      value += weights[k] * T(src[k]);
+    }
+    out[x * out_stride] = value;
+  }
+}
+
+/**
+ * @brief Rotate a raster by three 1D shears, along `from`, `to` and `from` again.
+ * 
+ * Intermediate images are extended such that they contain all the values required by the next pass.
+ */
+template <typename TInterpolation, typename TIn, typename TOut>
+void shear_rotate(const TIn& in, double angle, Index from, Index to, TOut& out, Index threads)
+{
+  using T = typename TypeTraits<std::decay_t<typename TIn::Value>>::Floating;
+  using Source = SeparableSource<TIn>;
+  const auto& raster = Source::raster(in);
+  const auto& method = Source::method(in);
+  T constant {};
+  if constexpr (std::is_convertible_v<decltype(method), T>) {
+    constant = T(method);
+  }
+  const TInterpolation interpolation {};
+  constexpr Index support = TInterpolation::Support;
+  const auto count = resolve_thread_count(threads);
+
+  // Reduce the angle to [-pi/2, pi/2], the rest being an exact half-turn
+  const auto pi = Linx::pi<double>();
+  angle = std::remainder(angle, 2 * pi);
+  const bool flip = std::abs(angle) > pi / 2;
+  if (flip) {
+    angle -= std::copysign(pi, angle);
+  }
+  const auto a = -std::tan(angle / 2); // Shears along `from`
+  const auto b = std::sin(angle); // Shear along `to`
+
+  // Geometry of the intermediate images
+  const auto& shape = raster.shape();
+  const auto width = shape[from];
+  const auto height = shape[to];
+  const auto cu = (width - 1) / 2.;
+  const auto cv = (height - 1) / 2.;
+  const auto mu = static_cast<Index>(std::ceil(std::abs(a) * cv)) + support + 1;
+  const auto mv = static_cast<Index>(std::ceil(std::abs(b) * (cu + mu))) + support + 1;
+  const auto w = width + 2 * mu; // Along `from` for both intermediate images, which start at `-mu`
+  const auto h = height + 2 * mv; // Along `to` for the first intermediate image, which starts at `-mv`
+  PoolRaster<T, 1> first({w * h}, uninitialized); // Pooled, such that repeated rotations do not allocate
+  PoolRaster<T, 1> second({w * height}, uninitialized);
+
+  const auto dimension = raster.dimension();
+  const auto origin = Position<TIn::Dimension>::zero(dimension);
+  auto unit = origin;
+  unit[from] = 1;
+  const auto su = raster.index(unit) - raster.index(origin);
+  unit[from] = 0;
+  unit[to] = 1;
+  const auto sv = raster.index(unit) - raster.index(origin);
+  auto planes = shape;
+  planes[from] = 1;
+  planes[to] = 1;
+  const auto* data = raster.data();
+  auto* dst = out.data();
+
+  // The weights of the columns, which are shifted along `to`
+  std::vector<Index> firsts(w);
+  std::vector<std::array<double, support>> weights(w);
+  for (Index i = 0; i < w; ++i) {
+    firsts[i] = shift_weights(interpolation, -b * (i - mu - cu), weights[i]) + mv;
+  }
+
+  for (const auto& p : Box<TIn::Dimension>::from_shape(origin, planes)) {
+    const auto offset = raster.index(p);
+
+    // Rows of the first image, from the extrapolated input
+#pragma omp parallel for num_threads(static_cast<int>(count))
+    for (Index j = 0; j < h; ++j) {
+      const auto v = j - mv;
+      const auto shift = -a * (v - cv);
+      const auto margin = static_cast<Index>(std::ceil(std::abs(shift))) + support + 1;
+      PoolRaster<T, 1> line({w + 2 * margin}, uninitialized);
+      const auto iv = method.index(flip ? height - 1 - v : v, height);
+      const auto* src = data + offset + iv * sv;
+      for (Index k = 0; k < static_cast<Index>(line.size()); ++k) {
+        const auto u = k - mu - margin;
+        const auto iu = u >= 0 && u < width ? u : method.index(u, width); // Remapping commutes with flipping
+        line[k] = iu >= 0 && iv >= 0 ? T(src[(flip ? width - 1 - iu : iu) * su]) : constant;
+      }
+      shift_line<TInterpolation, T>(interpolation, shift, line.data(), -mu - margin, first.data() + j * w, -mu, w, 1);
+    }
+
+    // Columns of the second image, by rows for contiguity
+#pragma omp parallel for num_threads(static_cast<int>(count))
+    for (Index j = 0; j < height; ++j) {
+      auto* row = second.data() + j * w;
+      for (Index i = 0; i < w; ++i) {
+        const auto* src = first.data() + (j + firsts[i]) * w + i;
+        T value {};
+        for (Index k = 0; k < support; ++k) {
+          value += weights[i][k] * src[k * w];
+        }
+        row[i] = value;
+      }
+    }
+
+    // Rows of the output
+#pragma omp parallel for num_threads(static_cast<int>(count))
+    for (Index j = 0; j < height; ++j) {
+      const auto shift = -a * (j - cv);
+      auto* row = dst + offset + j * sv;
+      shift_line<TInterpolation, T>(interpolation, shift, second.data() + j * w, -mu, row, 0, width, su);
+    }
+  }
+}
+
+/**
+ * @brief Check that the output of a warp has the shape of its input.
+ */
+template <typename TIn, typename TOut>
+void check_warp_shape(const TIn& in, const TOut& out)
+{
+  if (out.shape() != in.shape()) {
+    throw Exception("Output shape of the warp differs from the input shape");
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso Affinity
+ * @brief Translate some input data into a given output using a given interpolation method.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `translate()`
+ * 
+ * The output is overwritten, such that it can be reused from one call to the next.
+ * Intermediate rasters of the separable path are pooled (see `MemoryPool`),
+ * such that repeated calls with the same shapes do not allocate.
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>& translate_to(
+    const TIn& in,
+    const Vector<double, TIn::Dimension>& vector,
+    Raster<T, TIn::Dimension, THolder>& out,
+    Index threads = 1)
+{
+  Internal::check_warp_shape(in, out);
+  if constexpr (Internal::SeparableSource<TIn>::value) {
+    if (std::all_of(vector.begin(), vector.end(), [](auto e) {
+          return e == std::floor(e);
+        })) {
+      Position<TIn::Dimension> shift(vector.size());
+      std::copy(vector.begin(), vector.end(), shift.begin());
+      Internal::shift_copy(in, shift, out);
+      return out;
+    }
+  }
+  auto affinity = Affinity<TIn::Dimension>::translation(vector);
+  if constexpr (Internal::IsSeparable<TInterpolation>::value && Internal::SeparableSource<TIn>::value) {
+    Internal::separable_warp<TInterpolation>(in, affinity, out, threads);
+  } else {
+    affinity.parallelize(threads).transform(interpolation<TInterpolation>(in), out);
+  }
+  return out;
+}
+
 /**
  * @relatesalso Affinity
  * @brief Translate some input data using a given interpolation method.
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `translate_to()`
+ * 
+ * If `in` is a raster or an extrapolator whose method remaps indices (e.g. `Constant`, `Nearest` or `Periodic`),
+ * then two fast paths are available:
+ * - If the vector is integral, then no interpolation is performed:
+ *   the in-bounds part of each row is copied in block, and the rest is extrapolated;
+ *   the interpolation method is assumed to return the input values at integral positions.
+ * - Otherwise, if the interpolation method is separable, then the input is resampled axis by axis,
+ *   with the same weights for all the output positions, like in `scale()`.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> translate(const TIn& in, const Vector<double, TIn::Dimension>& vector)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension>
+translate(const TIn& in, const Vector<double, TIn::Dimension>& vector, Index threads = 1)
 {
-  return Affinity<TIn::Dimension>::translate(vector).template warp<TInterpolation>(in); // FIXME optimize
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(in.shape());
+  translate_to<TInterpolation>(in, vector, out, threads);
+  return out;
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Scale some input data from its center into a given output using a given interpolation method.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `scale()`, `translate_to()`
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>&
+scale_to(const TIn& in, double factor, Raster<T, TIn::Dimension, THolder>& out, Index threads = 1)
+{
+  Internal::check_warp_shape(in, out);
+  auto affinity = Affinity<TIn::Dimension>::scaling(factor, center(in));
+  if constexpr (Internal::IsSeparable<TInterpolation>::value && Internal::SeparableSource<TIn>::value) {
+    Internal::separable_warp<TInterpolation>(in, affinity, out, threads);
+  } else {
+    affinity.parallelize(threads).transform(interpolation<TInterpolation>(in), out);
+  }
+  return out;
 }
 
 /**
  * @relatesalso Affinity
  * @brief Scale some input data from its center using a given interpolation method.
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `scale_to()`
+ * 
+ * If the interpolation method is separable (e.g. `Nearest`, `Linear` or `Cubic`)
+ * and `in` is a raster or an extrapolator whose method remaps indices,
+ * then the input is resampled axis by axis, with weights and indices precomputed once per output index.
+ * The output equals that of `Affinity::warp()` up to rounding errors.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> scale(const TIn& in, double factor, Index threads = 1)
 {
-  return Affinity<TIn::Dimension>::scaling(factor, center(in)).template warp<TInterpolation>(in); // FIXME optimize
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(in.shape());
+  scale_to<TInterpolation>(in, factor, out, threads);
+  return out;
 }
 
 /**
@@ -394,9 +1237,12 @@ Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
  * @brief Upsample some input data using a given interpolation method.
  * @tparam TInterpolation The interpolation method
  * @tparam M The number of sampling dimensions
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * 
+ * Like `scale()`, the input is resampled axis by axis when possible.
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> upsample(const TIn& in, double factor, Index threads = 1)
 {
   Vector<double, TIn::Dimension> factors(in.dimension());
   auto shape = in.shape();
@@ -407,9 +1253,13 @@ Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double facto
   for (Index i = M; i < in.dimension(); ++i) {
     factors[i] = 1;
   }
-  Raster<typename TIn::Value, TIn::Dimension> out(std::move(shape));
-  const auto scaling = Affinity<TIn::Dimension>::scaling(std::move(factors));
-  scaling.transform(interpolation<TInterpolation>(in), out);
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(std::move(shape));
+  auto scaling = Affinity<TIn::Dimension>::scaling(std::move(factors));
+  if constexpr (Internal::IsSeparable<TInterpolation>::value && Internal::SeparableSource<TIn>::value) {
+    Internal::separable_warp<TInterpolation>(in, scaling, out, threads);
+  } else {
+    scaling.parallelize(threads).transform(interpolation<TInterpolation>(in), out);
+  }
   return out;
 }
 
@@ -418,33 +1268,173 @@ Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double facto
  * @brief Downsample some input data using a given interpolation method.
  * @tparam TInterpolation The interpolation method
  * @tparam M The number of sampling dimensions
+ * @param threads The number of threads, see `Affinity::parallelize()`
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> downsample(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> downsample(const TIn& in, double factor, Index threads = 1)
+{
+  return upsample<TInterpolation, M>(in, 1. / factor, threads);
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center into a given output using a given interpolation method.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `rotate_rad()`, `translate_to()`
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>& rotate_rad_to(
+    const TIn& in,
+    double angle,
+    Raster<T, TIn::Dimension, THolder>& out,
+    Index from = 0,
+    Index to = 1,
+    Index threads = 1)
+{
+  Internal::check_warp_shape(in, out);
+  auto affinity = Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in));
+  return affinity.parallelize(threads).transform(interpolation<TInterpolation>(in), out);
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center into a given output using a given interpolation method.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `rotate_deg()`, `translate_to()`
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>& rotate_deg_to(
+    const TIn& in,
+    double angle,
+    Raster<T, TIn::Dimension, THolder>& out,
+    Index from = 0,
+    Index to = 1,
+    Index threads = 1)
 {
-  return upsample<TInterpolation, M>(in, 1. / factor);
+  return rotate_rad_to<TInterpolation>(in, Linx::pi<double>() / 180. * angle, out, from, to, threads);
 }
 
 /**
  * @relatesalso Affinity
  * @brief Rotate some input data around its center using a given interpolation method.
+ * @param threads The number of threads, see `Affinity::parallelize()`
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension>
+rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1, Index threads = 1)
 {
-  return Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in)).template warp<TInterpolation>(in);
+  auto affinity = Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in));
+  return affinity.parallelize(threads).template warp<TInterpolation>(in);
 }
 
 /**
  * @relatesalso Affinity
  * @brief Rotate some input data around its center using a given interpolation method.
+ * @param threads The number of threads, see `Affinity::parallelize()`
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension>
+rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1, Index threads = 1)
 {
-  return Affinity<TIn::Dimension>::rotation_deg(angle, from, to, center(in)).template warp<TInterpolation>(in);
+  auto affinity = Affinity<TIn::Dimension>::rotation_deg(angle, from, to, center(in));
+  return affinity.parallelize(threads).template warp<TInterpolation>(in);
 }
 
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive shears into a given output.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `shear_rotate_rad()`, `translate_to()`
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>& shear_rotate_rad_to(
+    const TIn& in,
+    double angle,
+    Raster<T, TIn::Dimension, THolder>& out,
+    Index from = 0,
+    Index to = 1,
+    Index threads = 1)
+{
+  if constexpr (
+      Internal::IsSeparable<TInterpolation>::value && not Internal::Prefilters<TInterpolation>::value &&
+      Internal::SeparableSource<TIn>::value) {
+    Internal::check_warp_shape(in, out);
+    Internal::shear_rotate<TInterpolation>(in, angle, from, to, out, threads);
+    return out;
+  } else {
+    return rotate_rad_to<TInterpolation>(in, angle, out, from, to, threads);
+  }
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive shears into a given output.
+ * @param out The output raster, of the shape of the input
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `shear_rotate_rad_to()`
+ */
+template <typename TInterpolation, typename TIn, typename T, typename THolder>
+Raster<T, TIn::Dimension, THolder>& shear_rotate_deg_to(
+    const TIn& in,
+    double angle,
+    Raster<T, TIn::Dimension, THolder>& out,
+    Index from = 0,
+    Index to = 1,
+    Index threads = 1)
+{
+  return shear_rotate_rad_to<TInterpolation>(in, Linx::pi<double>() / 180. * angle, out, from, to, threads);
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive shears (Paeth's decomposition).
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `shear_rotate_rad_to()`
+ * 
+ * The rotation is decomposed as a shear along `from`, a shear along `to` and a shear along `from` again,
+ * each of which is a 1D resampling of the lines with a constant shift per line.
+ * Weights are therefore computed once per line, and lines are processed in parallel.
+ * Angles larger than a right angle in absolute value are handled with an exact half-turn.
+ * 
+ * This is much faster than `rotate_rad()` for large supports (e.g. `Cubic` or `Lanczos`),
+ * at the cost of slightly different results, since successive 1D interpolations smooth more than one 2D interpolation.
+ * The output equals that of `rotate_rad()` for constant and linear data, up to border effects.
+ * 
+ * The fast path requires a separable interpolation method without prefilter,
+ * and `in` to be a raster or an extrapolator whose method remaps indices (e.g. `Constant`, `Nearest` or `Periodic`);
+ * otherwise, the function falls back to `rotate_rad()`.
+ */
+template <typename TInterpolation, typename TIn>
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension>
+shear_rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1, Index threads = 1)
+{
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(in.shape());
+  shear_rotate_rad_to<TInterpolation>(in, angle, out, from, to, threads);
+  return out;
+}
+
+/**
+ * @relatesalso Affinity
+ * @brief Rotate some input data around its center by three successive shears (Paeth's decomposition).
+ * @param threads The number of threads, see `Affinity::parallelize()`
+ * @see `shear_rotate_rad()`
+ */
+template <typename TInterpolation, typename TIn>
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension>
+shear_rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1, Index threads = 1)
+{
+  return shear_rotate_rad<TInterpolation>(in, Linx::pi<double>() / 180. * angle, from, to, threads);
+}
+
+#ifdef LINX_PRECOMPILED
+#define LINX_EXTERN_AFFINITY(N) extern template class Affinity<N>;
+LINX_PRECOMPILED_DIMENSIONS(LINX_EXTERN_AFFINITY)
+#undef LINX_EXTERN_AFFINITY
+#endif
+
 } // namespace Linx
 
 #endif
@@ -0,0 +1,323 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BACKGROUND_H
+#define _LINXTRANSFORMS_BACKGROUND_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Tiling.h"
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/Interpolation.h"
+
+#include <algorithm> // lower_bound, max, min, sort, upper_bound
+#include <cmath> // abs, isnan, sqrt
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief The per-tile statistic of a `BackgroundEstimator`.
+ */
+enum class BackgroundStatistic {
+  Median, ///< The median of the clipped values
+  Mode ///< The mode estimator `2.5 median - 1.5 mean`, or the median if the distribution is too skewed
+};
+
+/**
+ * @ingroup filtering
+ * @brief Tile-based background estimator.
+ * @tparam T The background value type
+ * @tparam N The dimension
+ *
+ * The image is split into tiles with `tiles()`, and a robust statistic of the values of each tile is computed,
+ * after iterative sigma clipping around the median.
+ * The resulting coarse mesh, with one value per tile, is median-filtered to remove the residual outliers,
+ * e.g. tiles dominated by a bright object,
+ * and upsampled to the image resolution with some interpolation method, like `Cubic` or `BSpline`,
+ * where each mesh value is located at the center of its tile.
+ *
+ * Tiles are processed concurrently, each thread sorting the values of its tiles in its own scratch buffer.
+ * NaNs are ignored, and tiles without any valid value are given the median of the other tiles.
+ * For memory-constrained runs, `mesh()` returns the mesh only,
+ * which can later be evaluated at any position, or upsampled with `upsample()`.
+ *
+ * \code
+ * BackgroundEstimator<float> estimator({64, 64});
+ * const auto background = estimator(par, image);
+ * image -= background;
+ * \endcode
+ */
+template <typename T = float, Index N = 2>
+class BackgroundEstimator {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param tile_shape The tile shape
+   * @param statistic The per-tile statistic
+   * @param threshold The sigma-clipping threshold, in number of standard deviations
+   * @param iterations The maximum number of sigma-clipping iterations
+   * @param radius The radius of the median filter of the mesh, or 0 to skip filtering
+   */
+  explicit BackgroundEstimator(
+      Position<N> tile_shape,
+      BackgroundStatistic statistic = BackgroundStatistic::Mode,
+      double threshold = 3,
+      Index iterations = 5,
+      Index radius = 1) :
+      m_tile_shape(std::move(tile_shape)),
+      m_statistic(statistic), m_threshold(threshold), m_iterations(iterations), m_radius(radius)
+  {
+    for (const auto& e : m_tile_shape) {
+      OutOfBoundsError::may_throw("Tile length", e, {1, std::numeric_limits<Index>::max()});
+    }
+    OutOfBoundsError::may_throw("Sigma-clipping iteration count", iterations, {0, std::numeric_limits<Index>::max()});
+    OutOfBoundsError::may_throw("Mesh filter radius", radius, {0, std::numeric_limits<Index>::max()});
+  }
+
+  /**
+   * @brief Get the tile shape.
+   */
+  const Position<N>& tile_shape() const
+  {
+    return m_tile_shape;
+  }
+
+  /**
+   * @brief Get the mesh shape for some image shape.
+   *
+   * Along each axis, the last tile may be smaller than the others.
+   */
+  Position<N> mesh_shape(const Position<N>& shape) const
+  {
+    auto out = shape;
+    for (Index i = 0; i < N; ++i) {
+      out[i] = (shape[i] + m_tile_shape[i] - 1) / m_tile_shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Estimate the filtered background mesh of an image.
+   * @param policy The parallel execution policy
+   * @param in The input image
+   */
+  template <typename TRaster>
+  Raster<T, N> mesh(const ParallelPolicy& policy, const TRaster& in) const
+  {
+    Raster<T, N> out(mesh_shape(in.shape()));
+    std::vector<Box<N>> boxes;
+    for (const auto& tile : tiles(in, m_tile_shape)) {
+      boxes.push_back(tile.domain());
+    }
+    const auto size = static_cast<Index>(boxes.size());
+    if (size == 0) {
+      return out;
+    }
+
+    // Per-tile statistics
+#pragma omp parallel num_threads(static_cast<int>(std::min(policy.thread_count(), size)))
+    {
+      std::vector<double> values;
+      values.reserve(shape_size(m_tile_shape));
+#pragma omp for schedule(dynamic)
+      for (Index t = 0; t < size; ++t) {
+        const auto& box = boxes[t];
+        values.clear();
+        for (const auto& e : in(box)) {
+          if (not std::isnan(static_cast<double>(e))) {
+            values.push_back(static_cast<double>(e));
+          }
+        }
+        auto q = box.front();
+        for (Index i = 0; i < N; ++i) {
+          q[i] /= m_tile_shape[i];
+        }
+        out[q] = static_cast<T>(statistic(values));
+      }
+    }
+
+    // Empty tiles
+    std::vector<double> valid;
+    for (const auto& e : out) {
+      if (not std::isnan(static_cast<double>(e))) {
+        valid.push_back(e);
+      }
+    }
+    if (valid.size() < out.size()) {
+      const auto fill = static_cast<T>(valid.empty() ? 0. : clipped_median(valid));
+      for (auto& e : out) {
+        if (std::isnan(static_cast<double>(e))) {
+          e = fill;
+        }
+      }
+    }
+
+    // Outlier tiles
+    if (m_radius == 0) {
+      return out;
+    }
+    return median_filter<T>(Box<N>::from_center(m_radius)) * extrapolation<Nearest>(out);
+  }
+
+  /**
+   * @brief Estimate the filtered background mesh of an image, sequentially.
+   */
+  template <typename TRaster>
+  Raster<T, N> mesh(const TRaster& in) const
+  {
+    return mesh(ParallelPolicy(1), in);
+  }
+
+  /**
+   * @brief Upsample a mesh to the full resolution.
+   * @tparam TInterpolation The interpolation method
+   * @param mesh The mesh, as output by `mesh()`
+   * @param shape The image shape
+   * @param threads The number of threads
+   *
+   * Mesh value `mesh[q]` is located at the center of the `q`-th full tile, i.e. at `(q + 1/2) * tile_shape - 1/2`,
+   * and the mesh is extrapolated with the nearest value beyond the outer tile centers.
+   */
+  template <typename TInterpolation = Cubic, typename TMesh>
+  Raster<T, N> upsample(const TMesh& mesh, const Position<N>& shape, Index threads = 1) const
+  {
+    if (mesh.shape() != mesh_shape(shape)) {
+      throw Exception("Mesh and image shapes do not match");
+    }
+    Vector<double, N> factors;
+    Vector<double, N> offset;
+    for (Index i = 0; i < N; ++i) {
+      factors[i] = m_tile_shape[i];
+      offset[i] = .5 * (m_tile_shape[i] - 1);
+    }
+    auto affinity = Affinity<N>::scaling(factors);
+    affinity += offset;
+    Raster<T, N> out(shape);
+    const auto extrapolated = extrapolation<Nearest>(mesh);
+    using Source = std::decay_t<decltype(extrapolated)>;
+    if constexpr (Internal::IsSeparable<TInterpolation>::value && Internal::SeparableSource<Source>::value) {
+      Internal::separable_warp<TInterpolation>(extrapolated, affinity, out, threads);
+    } else {
+      affinity.parallelize(threads).transform(interpolation<TInterpolation>(extrapolated), out);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Estimate the full-resolution background of an image.
+   * @tparam TInterpolation The interpolation method
+   * @param policy The parallel execution policy
+   * @param in The input image
+   */
+  template <typename TInterpolation = Cubic, typename TRaster>
+  Raster<T, N> operator()(const ParallelPolicy& policy, const TRaster& in) const
+  {
+    return upsample<TInterpolation>(mesh(policy, in), in.shape(), policy.thread_count());
+  }
+
+  /**
+   * @brief Estimate the full-resolution background of an image, sequentially.
+   */
+  template <typename TInterpolation = Cubic, typename TRaster>
+  Raster<T, N> operator()(const TRaster& in) const
+  {
+    return operator()<TInterpolation>(ParallelPolicy(1), in);
+  }
+
+private:
+
+  /**
+   * @brief Sort and sigma-clip some values in place.
+   * @param values The values
+   * @param mean The mean of the kept values
+   * @param sigma The standard deviation of the kept values
+   * @param begin The beginning of the range of kept values
+   * @param end The end of the range of kept values
+   *
+   * On sorted values, the kept values are a contiguous range, which is shrunk by binary search,
+   * like in `SigmaClippedMeanCombiner`.
+   */
+  void clip(std::vector<double>& values, double& mean, double& sigma, const double*& begin, const double*& end) const
+  {
+    std::sort(values.begin(), values.end());
+    begin = values.data();
+    end = begin + values.size();
+    for (Index i = 0; i <= m_iterations; ++i) {
+      const auto count = end - begin;
+      double sum = 0;
+      double sum2 = 0;
+      for (auto it = begin; it != end; ++it) {
+        sum += *it;
+        sum2 += *it * *it;
+      }
+      mean = sum / count;
+      sigma = std::sqrt(std::max(0., sum2 / count - mean * mean));
+      if (i == m_iterations || count < 3) {
+        break;
+      }
+      const auto median = (begin[(count - 1) / 2] + begin[count / 2]) / 2;
+      const auto lo = std::lower_bound(begin, end, median - m_threshold * sigma);
+      const auto hi = std::upper_bound(lo, end, median + m_threshold * sigma);
+      if ((lo == begin && hi == end) || lo == hi) {
+        break;
+      }
+      begin = lo;
+      end = hi;
+    }
+  }
+
+  /**
+   * @brief Compute the sigma-clipped median of some values, which are reordered.
+   */
+  double clipped_median(std::vector<double>& values) const
+  {
+    double mean;
+    double sigma;
+    const double* begin;
+    const double* end;
+    clip(values, mean, sigma, begin, end);
+    const auto count = end - begin;
+    return (begin[(count - 1) / 2] + begin[count / 2]) / 2;
+  }
+
+  /**
+   * @brief Compute the statistic of some values, which are reordered, or NaN if there are no values.
+   */
+  double statistic(std::vector<double>& values) const
+  {
+    if (values.empty()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    double mean;
+    double sigma;
+    const double* begin;
+    const double* end;
+    clip(values, mean, sigma, begin, end);
+    const auto count = end - begin;
+    const auto median = (begin[(count - 1) / 2] + begin[count / 2]) / 2;
+    if (m_statistic == BackgroundStatistic::Median || std::abs(mean - median) > .3 * sigma) {
+      return median;
+    }
+    return 2.5 * median - 1.5 * mean;
+  }
+
+  Position<N> m_tile_shape; ///< The tile shape
+  BackgroundStatistic m_statistic; ///< The per-tile statistic
+  double m_threshold; ///< The sigma-clipping threshold
+  Index m_iterations; ///< The maximum number of sigma-clipping iterations
+  Index m_radius; ///< The radius of the mesh filter
+};
+
+} // namespace Linx
+
+#endif
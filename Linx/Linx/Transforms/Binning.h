@@ -0,0 +1,195 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BINNING_H
+#define _LINXTRANSFORMS_BINNING_H
+
+#include "Linx/Base/Conversion.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // fill, min
+#include <cstdint> // int64_t
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief The reduction of the blocks of `bin()`.
+ */
+enum class Binning {
+  Sum, ///< Sum of the block values
+  Mean ///< Mean of the block values, i.e. sum divided by the number of values inside the input domain
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The accumulation type of binning.
+ *
+ * Integers are accumulated as signed 64-bit integers, and floating point values in their own type,
+ * such that the accumulation loops are vectorized.
+ */
+template <typename T>
+using BinningValue = std::conditional_t<std::is_integral_v<T>, std::int64_t, T>;
+
+/**
+ * @brief Accumulate an input row into an output row of binned sums.
+ * @param in The input row
+ * @param length The input row length
+ * @param factor The binning factor along the row
+ * @param acc The output row, of length `ceil(length / factor)`
+ *
+ * Full blocks are summed with a loop per block element, whose iterations are independent,
+ * and the remainder block, if any, is summed separately.
+ */
+template <typename U, typename S>
+void bin_row(const U* in, Index length, Index factor, S* acc)
+{
+  const auto full = length / factor;
+  if (factor == 1) {
+    for (Index j = 0; j < full; ++j) {
+      acc[j] += in[j];
+    }
+  } else if (factor == 2) { // Most frequent case, with pairwise adds
+    for (Index j = 0; j < full; ++j) {
+      acc[j] += static_cast<S>(in[2 * j]) + static_cast<S>(in[2 * j + 1]);
+    }
+  } else {
+    for (Index k = 0; k < factor; ++k) {
+      const auto* it = in + k;
+      for (Index j = 0; j < full; ++j) {
+        acc[j] += it[j * factor];
+      }
+    }
+  }
+  for (Index i = full * factor; i < length; ++i) {
+    acc[full] += in[i];
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Bin a raster by integer factors, i.e. sum or average its values over non-overlapping blocks.
+ * @tparam T The output value type
+ * @param policy The parallel execution policy
+ * @param in The input raster
+ * @param factors The block shape
+ * @param mode The block reduction
+ * @return The binned raster, of shape `ceil(in.shape() / factors)`
+ *
+ * Trailing blocks which are truncated by the input domain are reduced over their values inside the domain.
+ * For example, binning a 5-pixel row by 2 yields `{in[0] + in[1], in[2] + in[3], in[4]}` with `Binning::Sum`,
+ * and the last value is `in[4]` as well with `Binning::Mean`.
+ *
+ * Each input row is read once, and accumulated into a row buffer, which is then written to the output.
+ * Integers are accumulated exactly as 64-bit integers, and the output values are rounded and saturated.
+ * Output rows are split into chunks which are processed concurrently.
+ *
+ * This is much faster than decimating a `mean_filter()` with a `Grid`, or than `downsample()`,
+ * which both go through generic patch or interpolation machinery.
+ *
+ * \code
+ * const auto binned = bin<float>(par, image, Position<2> {2, 2}, Binning::Mean);
+ * \endcode
+ */
+template <typename T, typename U, Index N, typename UHolder>
+Raster<T, N>
+bin(const ParallelPolicy& policy, const Raster<U, N, UHolder>& in, const Position<N>& factors, Binning mode = Binning::Mean)
+{
+  using S = Internal::BinningValue<std::conditional_t<std::is_integral_v<T>, std::decay_t<U>, T>>;
+  const auto& in_shape = in.shape();
+  auto shape = in_shape;
+  for (Index i = 0; i < N; ++i) {
+    const auto name = "Binning factor along axis " + std::to_string(i) + ": ";
+    OutOfBoundsError::may_throw(name, factors[i], {1, std::numeric_limits<Index>::max()});
+    shape[i] = (in_shape[i] + factors[i] - 1) / factors[i];
+  }
+  Raster<T, N> out(shape);
+  const auto width = shape[0];
+  const auto length = in_shape[0];
+  const auto rows = width > 0 ? out.size() / width : 0;
+
+  // Position of the first input row of a block of output rows
+  const auto row_position = [&](Index row) {
+    auto q = Position<N>::zero();
+    for (Index i = 1; i < N; ++i) {
+      q[i] = row % shape[i];
+      row /= shape[i];
+    }
+    return q;
+  };
+
+  Internal::parallel_chunks(policy.thread_count(), rows, [&](Index front, Index back) {
+    std::vector<S> acc(width);
+    for (Index row = front; row < back; ++row) {
+      std::fill(acc.begin(), acc.end(), S(0));
+      const auto q = row_position(row);
+
+      // Iterate over the input rows of the block
+      auto block_front = Position<N>::zero();
+      auto block_back = Position<N>::zero();
+      Index count = 1;
+      for (Index i = 1; i < N; ++i) {
+        block_front[i] = q[i] * factors[i];
+        block_back[i] = std::min(block_front[i] + factors[i], in_shape[i]) - 1;
+        count *= block_back[i] - block_front[i] + 1;
+      }
+      for (const auto& p : Box<N>(block_front, block_back)) {
+        Internal::bin_row(&in[p], length, factors[0], acc.data());
+      }
+
+      auto* dst = &out[q];
+      if (mode == Binning::Sum) {
+        for (Index j = 0; j < width; ++j) {
+          dst[j] = Internal::saturate_cast<T>(acc[j]);
+        }
+      } else {
+        using F = typename TypeTraits<S>::Floating;
+        const auto full = length / factors[0];
+        const auto norm = F(1) / (count * factors[0]);
+        for (Index j = 0; j < full; ++j) {
+          dst[j] = Internal::saturate_cast<T>(static_cast<F>(acc[j]) * norm);
+        }
+        for (Index j = full; j < width; ++j) { // Truncated block
+          dst[j] = Internal::saturate_cast<T>(static_cast<F>(acc[j]) / (count * (length - full * factors[0])));
+        }
+      }
+    }
+  });
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Bin a raster by a given factor along each axis.
+ */
+template <typename T, typename U, Index N, typename UHolder>
+Raster<T, N> bin(const ParallelPolicy& policy, const Raster<U, N, UHolder>& in, Index factor, Binning mode = Binning::Mean)
+{
+  return bin<T>(policy, in, Position<N>::one() * factor, mode);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Bin a raster by a given factor along each axis, sequentially.
+ */
+template <typename T, typename U, Index N, typename UHolder>
+Raster<T, N> bin(const Raster<U, N, UHolder>& in, Index factor, Binning mode = Binning::Mean)
+{
+  return bin<T>(ParallelPolicy(1), in, Position<N>::one() * factor, mode);
+}
+
+} // namespace Linx
+
+#endif
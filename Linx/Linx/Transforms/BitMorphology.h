@@ -0,0 +1,211 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BITMORPHOLOGY_H
+#define _LINXTRANSFORMS_BITMORPHOLOGY_H
+
+#include "Linx/Data/BitRaster.h"
+#include "Linx/Data/Box.h"
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Word-wise intersection, for erosion.
+ */
+struct BitAnd {
+  static constexpr std::uint64_t identity = ~std::uint64_t(0);
+  std::uint64_t operator()(std::uint64_t lhs, std::uint64_t rhs) const
+  {
+    return lhs & rhs;
+  }
+};
+
+/**
+ * @brief Word-wise union, for dilation.
+ */
+struct BitOr {
+  static constexpr std::uint64_t identity = 0;
+  std::uint64_t operator()(std::uint64_t lhs, std::uint64_t rhs) const
+  {
+    return lhs | rhs;
+  }
+};
+
+/**
+ * @brief Get the 64 values of a row which start at some index, which may be out of bounds.
+ * @param row The row words
+ * @param words The number of words of the row
+ * @param tail The mask of the used bits of the last word
+ * @param start The index of the first value
+ * @param fill The word of out-of-bounds values
+ */
+inline std::uint64_t
+bits_at(const std::uint64_t* row, Index words, std::uint64_t tail, Index start, std::uint64_t fill)
+{
+  const auto word = [&](Index w) {
+    if (w < 0 || w >= words) {
+      return fill;
+    }
+    if (w == words - 1) {
+      return (row[w] & tail) | (fill & ~tail);
+    }
+    return row[w];
+  };
+  const Index w = start >= 0 ? start / 64 : -((-start + 63) / 64);
+  const Index s = start - w * 64;
+  const auto lo = word(w);
+  if (s == 0) {
+    return lo;
+  }
+  return (lo >> s) | (word(w + 1) << (64 - s));
+}
+
+/**
+ * @brief Combine the values of a bit raster over a window along axis 0.
+ */
+template <Index N, typename TOp>
+BitRaster<N> combine_along_0(const BitRaster<N>& in, Index front, Index back, TOp&& op, std::uint64_t fill)
+{
+  BitRaster<N> out(in.shape());
+  const auto words = in.row_words();
+  const auto tail = in.tail_mask();
+  for (Index r = 0; r < in.rows(); ++r) {
+    const auto* src = in.row(r);
+    auto* dst = out.row(r);
+    for (Index w = 0; w < words; ++w) {
+      auto acc = std::decay_t<TOp>::identity;
+      for (Index k = front; k <= back; ++k) {
+        acc = op(acc, bits_at(src, words, tail, w * 64 + k, fill));
+      }
+      dst[w] = w == words - 1 ? acc & tail : acc;
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Combine the rows of a bit raster over a window along some axis greater than 0.
+ */
+template <Index N, typename TOp>
+BitRaster<N>
+combine_along(const BitRaster<N>& in, Index axis, Index front, Index back, TOp&& op, std::uint64_t fill)
+{
+  BitRaster<N> out(in.shape());
+  const auto& shape = in.shape();
+  const auto words = in.row_words();
+  const auto tail = in.tail_mask();
+  Index stride = 1;
+  for (Index i = 1; i < axis; ++i) {
+    stride *= shape[i];
+  }
+  for (Index r = 0; r < in.rows(); ++r) {
+    const auto c = (r / stride) % shape[axis];
+    auto* dst = out.row(r);
+    std::fill_n(dst, words, std::decay_t<TOp>::identity);
+    for (Index k = front; k <= back; ++k) {
+      if (c + k < 0 || c + k >= shape[axis]) {
+        for (Index w = 0; w < words; ++w) {
+          dst[w] = op(dst[w], fill);
+        }
+      } else {
+        const auto* src = in.row(r + k * stride);
+        for (Index w = 0; w < words; ++w) {
+          dst[w] = op(dst[w], src[w]);
+        }
+      }
+    }
+    if (words > 0) {
+      dst[words - 1] &= tail;
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Combine the values of a bit raster over a box window, axis by axis.
+ */
+template <Index N, typename TOp>
+BitRaster<N> combine(const BitRaster<N>& in, const Box<N>& window, TOp&& op, bool outside)
+{
+  const std::uint64_t fill = outside ? ~std::uint64_t(0) : 0;
+  auto out = in;
+  if (window.front()[0] != 0 || window.back()[0] != 0) {
+    out = combine_along_0(out, window.front()[0], window.back()[0], op, fill);
+  }
+  for (Index i = 1; i < N; ++i) {
+    if (window.front()[i] != 0 || window.back()[i] != 0) {
+      out = combine_along(out, i, window.front()[i], window.back()[i], op, fill);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Get the point reflection of a box.
+ */
+template <Index N>
+Box<N> reflect(const Box<N>& window)
+{
+  return {-window.back(), -window.front()};
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Erode a bit raster with a box structuring element.
+ * @param in The input bit raster
+ * @param window The structuring element
+ * @param outside The value of out-of-bounds pixels
+ *
+ * As for `erosion()`, the output is `true` at position `p` if all the input values are `true` in `window + p`.
+ * Values are processed by words of 64, with shifts along axis 0, and whole rows along the other axes.
+ */
+template <Index N>
+BitRaster<N> erode(const BitRaster<N>& in, const Box<N>& window, bool outside = false)
+{
+  return Internal::combine(in, window, Internal::BitAnd(), outside);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Dilate a bit raster with a box structuring element.
+ *
+ * As for `dilation()`, the output is `true` at position `p` if any input value is `true` in `window + p`.
+ *
+ * @copydetails erode()
+ */
+template <Index N>
+BitRaster<N> dilate(const BitRaster<N>& in, const Box<N>& window, bool outside = false)
+{
+  return Internal::combine(in, window, Internal::BitOr(), outside);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Open a bit raster with a box structuring element, i.e. erode and then dilate with the reflected window.
+ */
+template <Index N>
+BitRaster<N> open(const BitRaster<N>& in, const Box<N>& window, bool outside = false)
+{
+  return dilate(erode(in, window, outside), Internal::reflect(window), outside);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Close a bit raster with a box structuring element, i.e. dilate and then erode with the reflected window.
+ */
+template <Index N>
+BitRaster<N> close(const BitRaster<N>& in, const Box<N>& window, bool outside = false)
+{
+  return erode(dilate(in, window, outside), Internal::reflect(window), outside);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,189 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_DEVICEFILTERS_H
+#define _LINXTRANSFORMS_DEVICEFILTERS_H
+
+#include "Linx/Base/Device.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // min, max, reverse_copy
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Correlate a 2D buffer with a kernel on the device, with nearest-neighbor extrapolation.
+ * @param in The input values
+ * @param width The input and output width
+ * @param height The input and output height
+ * @param kernel The kernel values
+ * @param kernel_width The kernel width
+ * @param kernel_height The kernel height
+ * @param out The output values
+ *
+ * The kernel origin is its center, rounded down.
+ */
+template <typename T, typename U>
+void device_correlate(
+    const T* in,
+    Index width,
+    Index height,
+    const U* kernel,
+    Index kernel_width,
+    Index kernel_height,
+    T* out)
+{
+  const auto size = width * height;
+  const auto kernel_size = kernel_width * kernel_height;
+  const auto x0 = (kernel_width - 1) / 2;
+  const auto y0 = (kernel_height - 1) / 2;
+#pragma omp target teams distribute parallel for collapse(2) map(to : in[0 : size], kernel[0 : kernel_size]) \
+    map(from : out[0 : size])
+  for (Index y = 0; y < height; ++y) {
+    for (Index x = 0; x < width; ++x) {
+      U sum = 0;
+      for (Index j = 0; j < kernel_height; ++j) {
+        const auto v = std::min(std::max(y + j - y0, Index(0)), height - 1);
+        for (Index i = 0; i < kernel_width; ++i) {
+          const auto u = std::min(std::max(x + i - x0, Index(0)), width - 1);
+          sum += kernel[j * kernel_width + i] * in[v * width + u];
+        }
+      }
+      out[y * width + x] = sum;
+    }
+  }
+}
+
+/**
+ * @brief Compute the minimum or maximum of a 2D buffer over a box on the device, with nearest-neighbor extrapolation.
+ */
+template <bool IsMax, typename T>
+void device_rank(const T* in, Index width, Index height, Index radius_x, Index radius_y, T* out)
+{
+  const auto size = width * height;
+#pragma omp target teams distribute parallel for collapse(2) map(to : in[0 : size]) map(from : out[0 : size])
+  for (Index y = 0; y < height; ++y) {
+    for (Index x = 0; x < width; ++x) {
+      T value = IsMax ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+      for (Index v = std::max(y - radius_y, Index(0)); v <= std::min(y + radius_y, height - 1); ++v) {
+        for (Index u = std::max(x - radius_x, Index(0)); u <= std::min(x + radius_x, width - 1); ++u) {
+          const auto e = in[v * width + u];
+          value = IsMax ? std::max(value, e) : std::min(value, e);
+        }
+      }
+      out[y * width + x] = value;
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Correlate a 2D raster with a kernel on the device.
+ * @param in The input raster
+ * @param kernel The kernel, whose origin is the center, rounded down
+ * @param out The output raster, of the same shape as the input
+ *
+ * This is the device counterpart of `correlation(kernel) * extrapolation<Nearest>(in)`.
+ * Rasters which are mapped to the device (see `DeviceMapping`) are not transferred,
+ * such that device filters and pixel-wise operations can be chained without round trips.
+ */
+template <typename T, typename THolder, typename U, typename UHolder, typename TOut>
+TOut& device_correlation(const Raster<T, 2, THolder>& in, const Raster<U, 2, UHolder>& kernel, TOut& out)
+{
+  SizeError::may_throw(out.size(), in.size());
+  Internal::device_correlate(
+      in.data(),
+      in.shape()[0],
+      in.shape()[1],
+      kernel.data(),
+      kernel.shape()[0],
+      kernel.shape()[1],
+      out.data());
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Convolve a 2D raster with a kernel on the device.
+ * @see `device_correlation()`
+ */
+template <typename T, typename THolder, typename U, typename UHolder, typename TOut>
+TOut& device_convolution(const Raster<T, 2, THolder>& in, const Raster<U, 2, UHolder>& kernel, TOut& out)
+{
+  Raster<U, 2> reversed(kernel.shape());
+  std::reverse_copy(kernel.begin(), kernel.end(), reversed.begin());
+  return device_correlation(in, reversed, out);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Correlate a 2D raster with a separable kernel on the device.
+ * @param in The input raster
+ * @param horizontal The kernel along the first axis
+ * @param vertical The kernel along the second axis
+ * @param out The output raster, of the same shape as the input
+ *
+ * The intermediate raster lives on the device only.
+ */
+template <typename T, typename THolder, typename U, typename TOut>
+TOut& device_separable_correlation(
+    const Raster<T, 2, THolder>& in,
+    const std::vector<U>& horizontal,
+    const std::vector<U>& vertical,
+    TOut& out)
+{
+  SizeError::may_throw(out.size(), in.size());
+  const auto width = in.shape()[0];
+  const auto height = in.shape()[1];
+  Raster<T, 2> tmp(in.shape());
+  DeviceMapping<Raster<T, 2>> d_tmp(tmp, false);
+  const auto h = static_cast<Index>(horizontal.size());
+  const auto v = static_cast<Index>(vertical.size());
+  Internal::device_correlate(in.data(), width, height, horizontal.data(), h, Index(1), tmp.data());
+  Internal::device_correlate(tmp.data(), width, height, vertical.data(), Index(1), v, out.data());
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the minimum filter of a 2D raster with a box window on the device.
+ * @param in The input raster
+ * @param radius The half-lengths of the box along each axis
+ * @param out The output raster, of the same shape as the input
+ *
+ * This is the device counterpart of `minimum_filter<T>(Box<2>(-radius, radius)) * extrapolation<Nearest>(in)`,
+ * i.e. the grey-level erosion.
+ */
+template <typename T, typename THolder, typename TOut>
+TOut& device_minimum_filter(const Raster<T, 2, THolder>& in, Position<2> radius, TOut& out)
+{
+  SizeError::may_throw(out.size(), in.size());
+  Internal::device_rank<false>(in.data(), in.shape()[0], in.shape()[1], radius[0], radius[1], out.data());
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the maximum filter, i.e. the grey-level dilation, of a 2D raster with a box window on the device.
+ * @see `device_minimum_filter()`
+ */
+template <typename T, typename THolder, typename TOut>
+TOut& device_maximum_filter(const Raster<T, 2, THolder>& in, Position<2> radius, TOut& out)
+{
+  SizeError::may_throw(out.size(), in.size());
+  Internal::device_rank<true>(in.data(), in.shape()[0], in.shape()[1], radius[0], radius[1], out.data());
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,218 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_DISTANCETRANSFORM_H
+#define _LINXTRANSFORMS_DISTANCETRANSFORM_H
+
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, transform
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the 1D squared distance transform of a sampled function in place, as a lower envelope of parabolas.
+ * @param f The function values, where infinity denotes the absence of feature, replaced with the transform
+ * @param size The number of values
+ * @param v The buffer of the parabola vertices, of `size` elements
+ * @param z The buffer of the parabola boundaries, of `size + 1` elements
+ * @param d The buffer of the output values, of `size` elements
+ *
+ * This is the algorithm of Felzenszwalb and Huttenlocher, in O(size).
+ * Infinite values are skipped, such that they do not pollute the intersections of the parabolas.
+ */
+inline void squared_distance_1d(double* f, Index size, Index* v, double* z, double* d)
+{
+  constexpr auto inf = std::numeric_limits<double>::infinity();
+  Index k = -1;
+  for (Index q = 0; q < size; ++q) {
+    if (f[q] == inf) {
+      continue;
+    }
+    if (k < 0) {
+      k = 0;
+      v[0] = q;
+      z[0] = -inf;
+      z[1] = inf;
+      continue;
+    }
+    double s;
+    while (true) { // Terminates as z[0] is -inf
+      const auto p = v[k];
+      s = ((f[q] + double(q) * q) - (f[p] + double(p) * p)) / (2. * (q - p));
+      if (s > z[k]) {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = inf;
+  }
+  if (k < 0) {
+    return;
+  }
+  k = 0;
+  for (Index q = 0; q < size; ++q) {
+    while (z[k + 1] < q) {
+      ++k;
+    }
+    const auto dq = double(q - v[k]);
+    d[q] = dq * dq + f[v[k]];
+  }
+  std::copy_n(d, size, f);
+}
+
+/**
+ * @brief Apply the 1D squared distance transform to all the lines of a raster along some axis, in parallel.
+ */
+template <Index N, typename THolder>
+void squared_distance_along(const ParallelPolicy& policy, Raster<double, N, THolder>& raster, Index axis)
+{
+  const auto& shape = raster.shape();
+  const auto length = shape[axis];
+  if (length <= 1) {
+    return;
+  }
+  Index stride = 1;
+  for (Index i = 0; i < axis; ++i) {
+    stride *= shape[i];
+  }
+  const auto lines = static_cast<Index>(raster.size()) / length;
+  auto* data = raster.data();
+#pragma omp parallel num_threads(static_cast<int>(std::min(policy.thread_count(), lines)))
+  {
+    std::vector<double> f(length);
+    std::vector<Index> v(length);
+    std::vector<double> z(length + 1);
+    std::vector<double> d(length);
+#pragma omp for schedule(static)
+    for (Index l = 0; l < lines; ++l) {
+      auto* front = data + (l / stride) * stride * length + l % stride;
+      for (Index i = 0; i < length; ++i) {
+        f[i] = front[i * stride];
+      }
+      squared_distance_1d(f.data(), length, v.data(), z.data(), d.data());
+      for (Index i = 0; i < length; ++i) {
+        front[i * stride] = f[i];
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the exact squared Euclidean distance of each pixel to the nearest non-null pixel of a mask.
+ * @param policy The parallel execution policy
+ * @param mask The mask
+ *
+ * The transform is separable: it is computed axis by axis,
+ * with the linear-time algorithm of Felzenszwalb and Huttenlocher, and lines are processed in parallel.
+ * The overall complexity is O(n) whatever the distances.
+ *
+ * Null pixels of a mask without non-null pixels are infinitely far.
+ * Squared distances are integers, which are represented exactly.
+ */
+template <typename TMask>
+Raster<double, TMask::Dimension> squared_distance_transform(const ParallelPolicy& policy, const TMask& mask)
+{
+  static constexpr Index N = TMask::Dimension;
+  Raster<double, N> out(mask.shape());
+  std::transform(mask.begin(), mask.end(), out.begin(), [](const auto& e) {
+    return e ? 0. : std::numeric_limits<double>::infinity();
+  });
+  for (Index i = 0; i < out.dimension(); ++i) {
+    Internal::squared_distance_along(policy, out, i);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the squared Euclidean distance transform sequentially.
+ */
+template <typename TMask>
+Raster<double, TMask::Dimension> squared_distance_transform(const TMask& mask)
+{
+  return squared_distance_transform(ParallelPolicy(1), mask);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the exact Euclidean distance of each pixel to the nearest non-null pixel of a mask.
+ * @see `squared_distance_transform()`
+ */
+template <typename TMask>
+Raster<float, TMask::Dimension> distance_transform(const ParallelPolicy& policy, const TMask& mask)
+{
+  const auto squared = squared_distance_transform(policy, mask);
+  Raster<float, TMask::Dimension> out(squared.shape());
+  out.generate(
+      policy,
+      [](auto e) {
+        return std::sqrt(e);
+      },
+      squared);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the Euclidean distance transform sequentially.
+ */
+template <typename TMask>
+Raster<float, TMask::Dimension> distance_transform(const TMask& mask)
+{
+  return distance_transform(ParallelPolicy(1), mask);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Dilate a mask with an L2-ball.
+ * @param policy The parallel execution policy
+ * @param mask The mask
+ * @param radius The ball radius
+ *
+ * Pixels are flagged if their Euclidean distance to the nearest non-null pixel is at most `radius`.
+ * As opposed to `BitMorphology` or filters, the cost is independent of the radius.
+ */
+template <typename TMask>
+Raster<char, TMask::Dimension> ball_dilation(const ParallelPolicy& policy, const TMask& mask, double radius)
+{
+  const auto squared = squared_distance_transform(policy, mask);
+  const auto threshold = radius * radius;
+  Raster<char, TMask::Dimension> out(squared.shape());
+  out.generate(
+      policy,
+      [=](auto e) {
+        return char(e <= threshold);
+      },
+      squared);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Dilate a mask with an L2-ball sequentially.
+ */
+template <typename TMask>
+Raster<char, TMask::Dimension> ball_dilation(const TMask& mask, double radius)
+{
+  return ball_dilation(ParallelPolicy(1), mask, radius);
+}
+
+} // namespace Linx
+
+#endif
@@ -8,8 +8,81 @@
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/impl/ResamplingMethods.h"
 
+#include <algorithm> // clamp, copy, copy_n, fill_n, min
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether an extrapolation method remaps indices axis by axis, with `index(i, length)`.
+ */
+template <typename TMethod, typename = void>
+struct RemapsIndex : std::false_type {};
+
+template <typename TMethod>
+struct RemapsIndex<TMethod, std::void_t<decltype(std::declval<const TMethod&>().index(Index(), Index()))>> :
+    std::true_type {};
+
+/**
+ * @brief Write a band of out-of-bounds values of an extrapolated row, element by element.
+ * @param method The extrapolation method
+ * @param row The in-bounds row
+ * @param length The row length
+ * @param front The index of the first value of the band
+ * @param count The number of values of the band
+ * @param out The output iterator
+ * @param outside The function which computes a value whose index is not remapped, called as `outside(i)`
+ * @return The output iterator past the band
+ */
+template <typename TMethod, typename T, typename TOut, typename TFunc>
+TOut extrapolate_band(const TMethod& method, const T* row, Index length, Index front, Index count, TOut out, TFunc&& outside)
+{
+  for (Index i = front; i < front + count; ++i) {
+    const auto j = method.index(i, length);
+    *out++ = j >= 0 ? row[j] : outside(i);
+  }
+  return out;
+}
+
+/**
+ * @brief Write a band of constant values.
+ */
+template <typename U, typename T, typename TOut, typename TFunc>
+TOut extrapolate_band(const Constant<U>& method, const T*, Index, Index, Index count, TOut out, TFunc&&)
+{
+  return std::fill_n(out, count, static_cast<U>(method));
+}
+
+/**
+ * @brief Write a band of replicated edge values.
+ */
+template <typename T, typename TOut, typename TFunc>
+TOut extrapolate_band(const Nearest&, const T* row, Index length, Index front, Index count, TOut out, TFunc&&)
+{
+  return std::fill_n(out, count, row[front < 0 ? 0 : length - 1]);
+}
+
+/**
+ * @brief Write a band of wrapped values, by block copies.
+ */
+template <typename T, typename TOut, typename TFunc>
+TOut extrapolate_band(const Periodic& method, const T* row, Index length, Index front, Index count, TOut out, TFunc&&)
+{
+  auto j = method.index(front, length);
+  while (count > 0) {
+    const auto n = std::min(count, length - j);
+    out = std::copy_n(row + j, n, out);
+    count -= n;
+    j = 0;
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup resampling
  * @brief Extrapolation decorator.
@@ -117,8 +190,75 @@ public:
   template <typename TRegion>
   Raster<std::decay_t<Value>, Dimension> copy(TRegion&& region) const
   {
-    // FIXME optimize
-    return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    if constexpr (std::is_same_v<std::decay_t<TRegion>, Box<Dimension>>) {
+      Raster<std::decay_t<Value>, Dimension> out(region.shape());
+      copy_to(region, out);
+      return out;
+    } else {
+      return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    }
+  }
+
+  /**
+   * @brief Copy the data in a given box into a raster of the same shape.
+   * 
+   * If the method remaps indices axis by axis (e.g. `Constant`, `Nearest` or `Periodic`),
+   * then the out-of-bounds indices are remapped once per row along axes 1 and higher,
+   * and the in-bounds part of each row is copied in block.
+   * The out-of-bounds bands of the row are filled in bulk according to the method,
+   * i.e. with `std::fill_n()` for `Constant` and `Nearest`, and block copies for `Periodic`,
+   * or element by element otherwise.
+   * Rows which are remapped to the same input row as the previous one, e.g. outside the domain with `Nearest`,
+   * are copies of the previous output row.
+   * Otherwise, the values are extrapolated one by one.
+   * No allocation is made in any case.
+   */
+  template <typename U, typename UHolder>
+  void copy_to(const Box<Dimension>& region, Raster<U, Dimension, UHolder>& out) const
+  {
+    if constexpr (Internal::RemapsIndex<TMethod>::value) {
+      const auto& shape = m_raster.shape();
+      const auto width = region.length(0);
+      const auto f0 = region.front()[0];
+      const auto begin = std::clamp(-f0, Index(0), width);
+      const auto end = std::clamp(shape[0] - f0, begin, width);
+      auto lines_shape = region.shape();
+      lines_shape[0] = 1;
+      auto* dst = out.data();
+      const U* previous = nullptr;
+      auto previous_q = region.front();
+      for (const auto& l : Box<Dimension>::from_shape(region.front(), lines_shape)) {
+        auto q = l;
+        q[0] = 0;
+        bool inside = true;
+        for (Index i = 1; i < Dimension; ++i) {
+          q[i] = m_method.index(l[i], shape[i]);
+          inside &= (q[i] >= 0);
+        }
+        if (not inside) {
+          dst = std::fill_n(dst, width, m_method.at(m_raster, l));
+          continue;
+        }
+        if (previous && q == previous_q) {
+          dst = std::copy_n(previous, width, dst);
+          continue;
+        }
+        previous = dst;
+        previous_q = q;
+        const auto* row = &m_raster[q];
+        auto p = l;
+        const auto outside = [&](Index i) {
+          p[0] = i;
+          return m_method.at(m_raster, p);
+        };
+        dst = Internal::extrapolate_band(m_method, row, shape[0], f0, begin, dst, outside);
+        dst = std::copy(row + f0 + begin, row + f0 + end, dst);
+        dst = Internal::extrapolate_band(m_method, row, shape[0], f0 + end, width - end, dst, outside);
+      }
+    } else {
+      const auto patch = (*this)(region);
+      std::copy(patch.begin(), patch.end(), out.begin());
+    }
   }
 
 private:
@@ -185,6 +325,27 @@ auto extrapolation(const Raster<T, N, THolder>& raster, T constant) -> decltype(
   return Extrapolation<Raster<T, N, THolder>, Constant<T>>(raster, Constant<T>(constant));
 }
 
+/**
+ * @relatesalso Extrapolation
+ * @brief Make an extrapolator with precomputed index maps.
+ * @param margin The margin on both sides of each axis, beyond which accesses are not tabulated
+ * @param args The arguments of the tabulated method
+ * 
+ * \code
+ * const auto nearest = tabulated_extrapolation(raster, 2);
+ * const auto constant = tabulated_extrapolation<Constant<float>>(raster, 2, 0.F);
+ * \endcode
+ * 
+ * @see `Tabulated`
+ */
+template <typename TMethod = Nearest, typename TRaster, typename... TArgs>
+auto tabulated_extrapolation(const TRaster& raster, Index margin, TArgs&&... args) -> decltype(auto)
+{
+  return Extrapolation<TRaster, Tabulated<TMethod>>(
+      raster,
+      Tabulated<TMethod>(TMethod(std::forward<TArgs>(args)...), raster.shape(), margin));
+}
+
 /**
  * @relatesalso Extrapolation
  * @brief Do not extrapolate if `in` is an extrapolator or patch of an extrapolator.
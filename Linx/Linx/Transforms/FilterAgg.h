@@ -6,17 +6,43 @@
 #define _LINXTRANSFORMS_FILTERAGG_H
 
 #include "Linx/Base/SeqUtils.h"
+#include "Linx/Data/BorderedBox.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/FilterSeq.h"
+#include "Linx/Transforms/impl/SparseCorrelation.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
 #include <type_traits> // decay
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a filter is linear and shift-invariant,
+ * i.e. a box-based correlation or convolution, or a sequence thereof.
+ */
+template <typename TFilter, typename = void>
+struct IsLinearFilter : IsLinearBoxFilter<TFilter> {};
+
+template <typename... TFilters>
+struct IsLinearFilter<FilterSeq<TFilters...>, void> : std::conjunction<IsLinearFilter<std::decay_t<TFilters>>...> {};
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief An aggregate of filters.
+ * 
+ * By default, each filter is applied to the whole input, and the results are combined pixel-wise.
+ * If all of the filters are linear, e.g. correlations, convolutions or sequences thereof,
+ * then the aggregate is evaluated in a single pass instead:
+ * each filter is reduced to a set of taps over the common window,
+ * and the combined value is computed row by row as soon as the neighborhood is read, without intermediate rasters.
+ * This is typically the case of gradient magnitudes, like `norm(sobel_gradient<T, 0, 1>(), sobel_gradient<T, 1, 0>())`.
  */
 template <typename TFunc, typename... TFilters>
 class FilterAgg :
@@ -70,21 +96,183 @@ protected:
     return {front, back};
   }
 
+  /**
+   * @brief Apply the filters to an input raster, with cropping.
+   */
+  template <typename T, Index N, typename THolder, typename TOut>
+  void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
+  {
+    if constexpr (N == Dimension && single_pass) {
+      const auto shape = in.shape() - (window_impl().shape() - 1);
+      transform_single_pass(in, Position<N>::zero(), shape, taps(), out.begin());
+    } else {
+      transform_impl(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    }
+  }
+
   /**
    * @brief Apply the filters to an input extrapolator.
+   * 
+   * In single-pass mode, the inner region is read in place, and only the borders are extrapolated.
    */
-  template <typename TIn, typename TOut>
-  void transform_impl(const TIn& in, TOut& out) const
+  template <typename TRaster, typename TMethod, typename TOut>
+  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
+  {
+    if constexpr (TRaster::Dimension == Dimension && single_pass) {
+      const auto& raw = dont_extrapolate(in);
+      const auto window = window_impl();
+      const auto taps = this->taps();
+      using Tile = Internal::TemporaryRaster<std::decay_t<typename TRaster::Value>, Dimension>;
+      const auto bbox = Internal::BorderedBox<Dimension>(raw.domain(), window);
+      bbox.apply_inner_border(
+          [&](const auto& ib) {
+            auto outsub = out(ib);
+            transform_single_pass(raw, ib.front() + window.front(), ib.shape(), taps, outsub.begin());
+          },
+          [&](const auto& ib) {
+            const auto region = ib + window;
+            Tile tile(region.shape(), uninitialized);
+            in.copy_to(region, tile);
+            auto outsub = out(ib);
+            transform_single_pass(tile, Position<Dimension>::zero(), ib.shape(), taps, outsub.begin());
+          });
+    } else {
+      transform_impl(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    }
+  }
+
+  /**
+   * @brief Apply the filters to an input padded raster.
+   */
+  template <typename T, Index N, typename TOut>
+  void transform_impl(const PaddedRaster<T, N>& in, TOut& out) const
+  {
+    if constexpr (N == Dimension && single_pass) {
+      transform_single_pass(in.padded(), in.halo() + window_impl().front(), in.shape(), taps(), out.begin());
+    } else {
+      transform_impl(in.padded()(Box<N>::from_shape(in.halo(), in.shape())), out);
+    }
+  }
+
+  /**
+   * @brief Apply the filters to an input patch.
+   */
+  template <typename T, typename TParent, typename TRegion, typename TOut>
+  void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out) const
   {
     transform_impl(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
   }
 
 private:
 
+  /**
+   * @brief Whether all the filters are linear, such that the aggregate can be evaluated in a single pass.
+   */
+  static constexpr bool single_pass = (Internal::IsLinearFilter<std::decay_t<TFilters>>::value && ...);
+
+  /**
+   * @brief Apply each filter into a pooled temporary raster, and aggregate the results into the output.
+   */
   template <typename TIn, typename TOut, std::size_t... Is>
   void transform_impl(const TIn& in, TOut& out, std::index_sequence<Is...>) const
   {
-    out.generate(m_op, std::get<Is>(m_filters) * in...);
+    out.generate(m_op, Internal::temporary_filter(std::get<Is>(m_filters), in)...);
+  }
+
+  /**
+   * @brief Get the non-zero correlation coefficients of each filter over the common window.
+   * 
+   * The coefficients are read from the impulse response of each filter, which is the reflected correlation kernel.
+   */
+  auto taps() const
+  {
+    return taps(std::make_index_sequence<sizeof...(TFilters)> {});
+  }
+
+  template <std::size_t... Is>
+  auto taps(std::index_sequence<Is...>) const
+  {
+    const auto window = window_impl();
+    const auto taps_of = [&](const auto& filter) {
+      using V = typename std::decay_t<decltype(filter)>::Value;
+      Raster<V, Dimension> impulse(window.shape());
+      impulse[window.back()] = V(1);
+      const auto response = filter * extrapolation(impulse, V());
+      std::vector<V> coefficients;
+      coefficients.reserve(window.size());
+      for (const auto& q : window) {
+        coefficients.push_back(response[window.back() - q]);
+      }
+      return Internal::SparseTaps<V, Dimension>::from_window(window, coefficients.begin());
+    };
+    return std::make_tuple(taps_of(std::get<Is>(m_filters))...);
+  }
+
+  /**
+   * @brief Evaluate the aggregate over a region of a contiguous raster in a single pass.
+   * @param in The input raster
+   * @param front The input position of the window front for the first output element
+   * @param shape The output shape
+   * @param taps The taps of each filter
+   * @param out_it The output iterator, incremented in the order of the output region
+   */
+  template <typename TIn, typename TTaps, typename TIt>
+  void transform_single_pass(
+      const TIn& in,
+      const Position<Dimension>& front,
+      const Position<Dimension>& shape,
+      const TTaps& taps,
+      TIt out_it) const
+  {
+    const auto origin = in.index(Position<Dimension>::zero());
+    const auto offsets_of = [&](const auto& t) {
+      std::vector<Index> offsets;
+      offsets.reserve(t.positions.size());
+      for (const auto& p : t.positions) {
+        offsets.push_back(in.index(p) - origin);
+      }
+      return offsets;
+    };
+    const auto offsets = std::apply(
+        [&](const auto&... ts) {
+          return std::make_tuple(offsets_of(ts)...);
+        },
+        taps);
+    transform_single_pass(in, front, shape, taps, offsets, out_it, std::make_index_sequence<sizeof...(TFilters)> {});
+  }
+
+  template <typename TIn, typename TTaps, typename TOffsets, typename TIt, std::size_t... Is>
+  void transform_single_pass(
+      const TIn& in,
+      const Position<Dimension>& front,
+      const Position<Dimension>& shape,
+      const TTaps& taps,
+      const TOffsets& offsets,
+      TIt out_it,
+      std::index_sequence<Is...>) const
+  {
+    const auto width = shape[0];
+    auto rows = std::make_tuple(Internal::TemporaryRaster<typename std::decay_t<TFilters>::Value, 1>({width})...);
+    const auto accumulate = [&](const auto& t, const std::vector<Index>& o, auto& row, const auto* base) {
+      std::fill(row.begin(), row.end(), 0);
+      for (std::size_t k = 0; k < o.size(); ++k) {
+        const auto w = t.weights[k];
+        const auto* src = base + o[k];
+#pragma omp simd
+        for (Index x = 0; x < width; ++x) {
+          row[x] += w * src[x];
+        }
+      }
+    };
+    auto lines_shape = shape;
+    lines_shape[0] = 1;
+    for (const auto& l : Box<Dimension>::from_shape(Position<Dimension>::zero(), lines_shape)) {
+      const auto* base = in.data() + in.index(front + l);
+      (accumulate(std::get<Is>(taps), std::get<Is>(offsets), std::get<Is>(rows), base), ...);
+      for (Index x = 0; x < width; ++x, ++out_it) {
+        *out_it = m_op(std::get<Is>(rows)[x]...);
+      }
+    }
   }
 
 private:
@@ -104,7 +292,10 @@ template <
     typename std::enable_if_t<is_filter<TFilter>() && is_filter<UFilter>()>* = nullptr>
 auto operator+(const TFilter& lhs, const UFilter& rhs)
 {
-  return FilterAgg<TFilter, UFilter>(std::plus<typename TFilter::Value>(), lhs, rhs);
+  return FilterAgg<std::plus<typename TFilter::Value>, TFilter, UFilter>(
+      std::plus<typename TFilter::Value>(),
+      TFilter(lhs),
+      UFilter(rhs));
 }
 
 /**
@@ -119,10 +310,10 @@ template <
     typename... TFilters>
 auto norm(const TFilter0& filter0, const TFilters&... filters)
 {
-  auto agg = [&](const typename TFilter0::Value& e0, const typename TFilters::Value&... es) {
+  auto agg = [](const typename TFilter0::Value& e0, const typename TFilters::Value&... es) {
     return abspow<P>(e0) + (abspow<P>(es) + ...);
   };
-  return FilterAgg<decltype(agg), TFilter0, TFilters...>(agg, filter0, filters...);
+  return FilterAgg<decltype(agg), TFilter0, TFilters...>(LINX_MOVE(agg), TFilter0(filter0), TFilters(filters)...);
 }
 
 } // namespace Linx
@@ -0,0 +1,284 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_FILTERPLANNER_H
+#define _LINXTRANSFORMS_FILTERPLANNER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Transforms/mixins/Kernel.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional> // hash
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the name of a kernel strategy, as used in tuning files.
+ */
+inline const char* strategy_name(KernelStrategy strategy)
+{
+  switch (strategy) {
+    case KernelStrategy::Direct:
+      return "Direct";
+    case KernelStrategy::Separable:
+      return "Separable";
+    case KernelStrategy::ShiftAccumulate:
+      return "ShiftAccumulate";
+    case KernelStrategy::Sparse:
+      return "Sparse";
+    case KernelStrategy::Measure:
+      return "Measure";
+    default:
+      return "Automatic";
+  }
+}
+
+/**
+ * @brief Parse the name of a kernel strategy.
+ */
+inline KernelStrategy parse_strategy(const std::string& name)
+{
+  for (auto s :
+       {KernelStrategy::Direct,
+        KernelStrategy::Separable,
+        KernelStrategy::ShiftAccumulate,
+        KernelStrategy::Sparse,
+        KernelStrategy::Measure}) {
+    if (name == strategy_name(s)) {
+      return s;
+    }
+  }
+  return KernelStrategy::Automatic;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief A planner which selects the fastest strategy of kernel-based filters by timing them.
+ *
+ * Like FFTW's `FFTW_MEASURE` flag, the applicable strategies are timed on the first input of each configuration,
+ * and the fastest one is remembered for subsequent calls.
+ * A configuration is identified by the kernel type and values, the input type and shape, and the thread count.
+ *
+ * The planner is used by `SimpleFilter` when the kernel strategy is `KernelStrategy::Measure`:
+ *
+ * \code
+ * auto filter = convolution(kernel);
+ * filter.kernel().strategy(KernelStrategy::Measure);
+ * filter_planner().load("tuning.txt");
+ * for (const auto& frame : frames) {
+ *   process(filter * extrapolation(frame)); // Only the first call is timed
+ * }
+ * filter_planner().save("tuning.txt");
+ * \endcode
+ *
+ * Since keys are built from type names, tuning files are only portable across builds with the same compiler.
+ * The planner is thread-safe, but concurrent calls with a new configuration may time it concurrently.
+ *
+ * @see `filter_planner()`
+ */
+class FilterPlanner {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param repeat The number of runs of each strategy, the fastest of which is retained
+   */
+  explicit FilterPlanner(Index repeat = 3) : m_repeat(repeat), m_plans(), m_mutex() {}
+
+  /**
+   * @brief Get the number of runs of each strategy.
+   */
+  Index repeat() const
+  {
+    return m_repeat;
+  }
+
+  /**
+   * @brief Get the number of planned configurations.
+   */
+  std::size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_plans.size();
+  }
+
+  /**
+   * @brief Forget all plans.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_plans.clear();
+  }
+
+  /**
+   * @brief Get the fastest strategy of a filter for some input, measuring it if not already planned.
+   * @param filter The filter, which must provide `kernel()` with `strategy()` setter and getter
+   * @param in The input, which will be filtered several times if the configuration was not planned yet
+   */
+  template <typename TFilter, typename TIn>
+  KernelStrategy plan(const TFilter& filter, const TIn& in)
+  {
+    const auto k = key(filter, in);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const auto it = m_plans.find(k);
+      if (it != m_plans.end()) {
+        return it->second;
+      }
+    }
+    const auto strategy = measure(filter, in);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_plans.emplace(k, strategy);
+    return strategy;
+  }
+
+  /**
+   * @brief Time the applicable strategies of a filter for some input, and get the fastest one.
+   *
+   * Nothing is remembered.
+   */
+  template <typename TFilter, typename TIn>
+  KernelStrategy measure(const TFilter& filter, const TIn& in) const
+  {
+    using Clock = std::chrono::steady_clock;
+    auto best = KernelStrategy::Automatic;
+    auto best_duration = Clock::duration::max();
+    for (auto s :
+         {KernelStrategy::Direct,
+          KernelStrategy::Separable,
+          KernelStrategy::ShiftAccumulate,
+          KernelStrategy::Sparse}) {
+      auto candidate = filter;
+      candidate.kernel().strategy(s);
+      if (candidate.kernel().strategy() != s) {
+        continue; // Not applicable
+      }
+      for (Index i = 0; i < m_repeat; ++i) {
+        const auto start = Clock::now();
+        const auto out = candidate * in;
+        const auto duration = Clock::now() - start;
+        if (duration < best_duration) {
+          best_duration = duration;
+          best = s;
+        }
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Read plans from a tuning file, if it exists.
+   *
+   * Plans of the file override the plans of the same configurations.
+   */
+  void load(const std::string& filename)
+  {
+    std::ifstream file(filename);
+    if (not file) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string line;
+    while (std::getline(file, line)) {
+      const auto tab = line.rfind('\t');
+      if (tab == std::string::npos) {
+        continue;
+      }
+      const auto strategy = Internal::parse_strategy(line.substr(tab + 1));
+      if (strategy != KernelStrategy::Automatic) {
+        m_plans[line.substr(0, tab)] = strategy;
+      }
+    }
+  }
+
+  /**
+   * @brief Write the plans to a tuning file.
+   *
+   * Each line contains a configuration key and the name of the strategy, separated by a tabulation.
+   */
+  void save(const std::string& filename) const
+  {
+    std::ofstream file(filename);
+    if (not file) {
+      throw Exception("Cannot write tuning file: " + filename);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& p : m_plans) {
+      file << p.first << '\t' << Internal::strategy_name(p.second) << '\n';
+    }
+  }
+
+  /**
+   * @brief Get the key of a configuration.
+   */
+  template <typename TFilter, typename TIn>
+  static std::string key(const TFilter& filter, const TIn& in)
+  {
+    using T = std::decay_t<decltype(*filter.kernel().values().begin())>;
+    std::size_t hash = 0;
+    for (const auto& v : filter.kernel().values()) {
+      hash ^= std::hash<T>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    std::ostringstream os;
+    os << typeid(filter.kernel()).name() << ' ' << typeid(TIn).name() << ' ' << std::hex << hash << std::dec;
+    const auto window = box(filter.window()); // Copy, since window() may return a temporary
+    for (auto i : window.front()) {
+      os << ' ' << i;
+    }
+    for (auto i : window.back()) {
+      os << ' ' << i;
+    }
+    os << ' ';
+    const auto& shape = in.shape();
+    for (auto l : shape) {
+      os << 'x' << l;
+    }
+    os << ' ' << filter.thread_count();
+    return os.str();
+  }
+
+private:
+
+  /**
+   * @brief The number of runs of each strategy.
+   */
+  Index m_repeat;
+
+  /**
+   * @brief The fastest strategy of each configuration.
+   */
+  std::map<std::string, KernelStrategy> m_plans;
+
+  /**
+   * @brief The mutex of the plans.
+   */
+  mutable std::mutex m_mutex;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Get the global filter planner, which is used by `SimpleFilter` when the strategy is `KernelStrategy::Measure`.
+ */
+inline FilterPlanner& filter_planner()
+{
+  static FilterPlanner planner;
+  return planner;
+}
+
+} // namespace Linx
+
+#endif
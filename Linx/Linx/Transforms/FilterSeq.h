@@ -8,12 +8,87 @@
 #include "Linx/Base/SeqUtils.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/SimpleFilter.h" // resolve_thread_count, split_bands, output_patch
+#include "Linx/Transforms/impl/SeparableCorrelation.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
+#include <algorithm> // copy
 #include <type_traits> // decay
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a filter is a box-based correlation or convolution with real coefficients.
+ */
+template <typename TFilter, typename = void>
+struct IsLinearBoxFilter : std::false_type {};
+
+template <typename TFilter>
+struct IsLinearBoxFilter<TFilter, std::void_t<decltype(std::declval<const TFilter&>().kernel().correlation_coefficients())>> :
+    std::is_same<std::decay_t<decltype(std::declval<const TFilter&>().window())>, Box<TFilter::Dimension>> {};
+
+/**
+ * @brief Compute the full 1D convolution of two vectors.
+ */
+inline std::vector<double> convolve(const std::vector<double>& lhs, const std::vector<double>& rhs)
+{
+  std::vector<double> out(lhs.size() + rhs.size() - 1, 0.);
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    for (std::size_t j = 0; j < rhs.size(); ++j) {
+      out[i + j] += lhs[i] * rhs[j];
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief The raster type of the intermediate results, which are pooled if possible.
+ */
+template <typename T, Index N>
+using TemporaryRaster = std::conditional_t<std::is_trivially_copyable_v<T>, PoolRaster<T, N>, Raster<T, N>>;
+
+/**
+ * @brief Apply a filter with cropping into a temporary raster.
+ */
+template <typename TFilter, typename U, Index N, typename UHolder>
+TemporaryRaster<typename TFilter::Value, N> temporary_filter(const TFilter& filter, const Raster<U, N, UHolder>& in)
+{
+  const auto w = box(filter.window());
+  TemporaryRaster<typename TFilter::Value, N> out(in.shape() - extend<N>(w.shape() - 1), uninitialized);
+  filter.transform(in, out);
+  return out;
+}
+
+/**
+ * @brief Apply a filter to a box-based patch into a temporary raster.
+ */
+template <typename TFilter, typename U, typename UParent, typename URegion>
+TemporaryRaster<typename TFilter::Value, URegion::Dimension>
+temporary_filter(const TFilter& filter, const Patch<U, UParent, URegion>& in)
+{
+  TemporaryRaster<typename TFilter::Value, URegion::Dimension> out(in.domain().shape(), uninitialized);
+  filter.transform(in, out);
+  return out;
+}
+
+/**
+ * @brief Apply a filter to an extrapolated raster into a temporary raster.
+ */
+template <typename TFilter, typename TRaster, typename TMethod>
+TemporaryRaster<typename TFilter::Value, TRaster::Dimension>
+temporary_filter(const TFilter& filter, const Extrapolation<TRaster, TMethod>& in)
+{
+  TemporaryRaster<typename TFilter::Value, TRaster::Dimension> out(in.shape(), uninitialized);
+  filter.transform(in, out);
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief A sequence of filters.
@@ -85,6 +160,34 @@ public:
     return FilterSeq<UFilter, TFilters...>(std::tuple_cat(std::make_tuple(lhs), rhs.m_filters));
   }
 
+  /// @group_modifiers
+
+  /**
+   * @brief Evaluate the sequence band by band instead of filter by filter.
+   * @param band_length The band length along the last axis, or -1 for an automatic value
+   * @param thread_count The number of threads, or -1 for the maximum available
+   * 
+   * By default, each filter is applied to the whole image in turn, with full-size intermediate rasters.
+   * In streaming mode, the output is split into bands along the last axis,
+   * each of which is read with a margin sized from the combined window,
+   * and pushed through the whole sequence while it is still in cache.
+   * Intermediate rasters are thus limited to the size of a band, at the cost of recomputing the margins.
+   * Bands are processed in parallel, each thread with its own intermediate rasters.
+   * 
+   * The automatic band length is such that bands contain about `band_size` input pixels.
+   */
+  FilterSeq& stream(Index band_length = -1, Index thread_count = 1)
+  {
+    m_band_length = band_length > 0 ? band_length : -1;
+    m_thread_count = thread_count;
+    return *this;
+  }
+
+  /**
+   * @brief The target number of input pixels per band in streaming mode.
+   */
+  static constexpr Index band_size = 1 << 16;
+
   /// @group_properties
 
   /**
@@ -120,6 +223,16 @@ protected:
   template <typename T, Index N, typename THolder, typename TOut>
   void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
   {
+    if constexpr (N == Dimension && (Internal::IsLinearBoxFilter<TFilters>::value && ...)) {
+      if (const auto separable = fuse()) {
+        separable.correlate(in, Position<N>::zero(), in.shape() - (window_impl().shape() - 1), out);
+        return;
+      }
+    }
+    if (m_band_length != 0) {
+      transform_bands(in, Position<N>::zero(), in.shape() - (extend<N>(window_impl()).shape() - 1), out);
+      return;
+    }
     const auto outK = upto_kth<sizeof...(TFilters) - 2>(in);
     filter<sizeof...(TFilters) - 1>().transform(outK, out);
   }
@@ -128,48 +241,185 @@ protected:
    * @brief Filter an input extrapolated raster.
    * 
    * The input and output must have the same size, although not necessarily the same domain.
+   * The input is extrapolated once, over the domain extended by the combined window,
+   * and then the filters are applied with cropping.
    */
   template <typename TRaster, typename TMethod, typename TOut>
   void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
   {
+    if constexpr (TRaster::Dimension == Dimension && (Internal::IsLinearBoxFilter<TFilters>::value && ...)) {
+      if (const auto separable = fuse()) {
+        separable.correlate(in, window_impl().front(), in.shape(), out);
+        return;
+      }
+    }
+    if (m_band_length != 0) {
+      transform_bands(in, extend<TRaster::Dimension>(window_impl()).front(), in.shape(), out);
+      return;
+    }
     const auto domain0 = in.domain() + extend<TRaster::Dimension>(window_impl());
-    const auto outK = upto_kth<sizeof...(TFilters) - 2>(in(domain0));
+    using Temporary = Internal::TemporaryRaster<std::decay_t<typename TRaster::Value>, TRaster::Dimension>;
+    Temporary in0(domain0.shape(), uninitialized);
+    in.copy_to(domain0, in0);
+    const auto outK = crop_upto_kth<sizeof...(TFilters) - 2>(in0);
     filter<sizeof...(TFilters) - 1>().transform(outK, out);
   }
 
+  /**
+   * @brief Filter an input padded raster.
+   * 
+   * The halo is read instead of extrapolating the input.
+   */
+  template <typename T, Index N, typename TOut>
+  void transform_impl(const PaddedRaster<T, N>& in, TOut& out) const
+  {
+    transform_impl(in.padded()(Box<N>::from_shape(in.halo(), in.shape())), out);
+  }
+
   /**
    * @brief Filter an input patch.
+   * 
+   * The patch region must be a box, and its parent is read around it.
    */
   template <typename T, typename TParent, typename TRegion, typename TOut>
   void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out) const
   {
-    const auto& raw = raster(in);
-    const auto& domain = in.domain();
-    const auto& extrapolate = in.method();
     static constexpr Index N = sizeof...(TFilters);
-    const auto domain0 = box(domain) + extend<TParent::Dimension>(window_impl());
-    auto outK = upto_kth<N - 2>(extrapolate(raw(domain0)));
-    const auto domainK = in.domain() + filter<N - 1>().origin();
-    filter<N - 1>().transform(outK(domainK), out);
+    const auto domain0 = box(in.domain()) + extend<TParent::Dimension>(window_impl());
+    const Internal::TemporaryRaster<std::decay_t<T>, TParent::Dimension> in0(in.parent()(domain0));
+    const auto outK = crop_upto_kth<N - 2>(in0);
+    filter<N - 1>().transform(outK, out);
+  }
+
+  /**
+   * @brief Filter and decimate an input grid-based patch.
+   * 
+   * The sequence is applied to the bounding box of the grid, which is then decimated into the output.
+   */
+  template <typename T, typename TParent, typename TOut>
+  void transform_impl(const Patch<T, TParent, Grid<TParent::Dimension>>& in, TOut& out) const
+  {
+    const auto& grid = in.domain();
+    Internal::TemporaryRaster<Value, TParent::Dimension> full(grid.box().shape(), uninitialized);
+    transform_impl(in.parent()(grid.box()), full);
+    const auto samples = full(Grid<TParent::Dimension>(full.domain(), grid.step()));
+    std::copy(samples.begin(), samples.end(), out.begin());
   }
 
 private:
 
+  /**
+   * @brief Fuse the filters into a single separable kernel.
+   * 
+   * This is possible if each filter is a correlation or convolution along a single axis.
+   * In this case, the filters are applied in a single pass with line buffers instead of intermediate rasters.
+   * Otherwise, the output is empty.
+   */
+  Internal::SeparableCorrelation<Dimension> fuse() const
+  {
+    std::vector<std::vector<double>> factors(Dimension, std::vector<double> {1.});
+    bool fusable = true;
+    seq_foreach(m_filters, [&](const auto& f) {
+      const auto w = extend<Dimension>(box(f.window()));
+      Index axis = 0;
+      Index count = 0;
+      for (Index i = 0; i < Dimension; ++i) {
+        if (w.length(i) > 1) {
+          axis = i;
+          ++count;
+        }
+      }
+      fusable &= (count <= 1);
+      if (fusable) {
+        factors[axis] = Internal::convolve(factors[axis], f.kernel().correlation_coefficients());
+      }
+    });
+    if (not fusable) {
+      return {};
+    }
+    return Internal::SeparableCorrelation<Dimension>::from_factors(LINX_MOVE(factors));
+  }
+
+  /**
+   * @brief Filter an input raster or extrapolator band by band.
+   * @param in The input raster or extrapolator
+   * @param front The input position of the combined window front for the first output element
+   * @param shape The output shape
+   * @param out The output
+   */
+  template <typename TIn, typename TOut>
+  void transform_bands(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    static constexpr Index K = sizeof...(TFilters);
+    const auto margin = extend<N>(window_impl()).shape() - 1;
+    Index length = m_band_length;
+    if (length <= 0) {
+      Index slab = 1;
+      for (Index i = 0; i < N - 1; ++i) {
+        slab *= shape[i] + margin[i];
+      }
+      length = std::max(band_size / std::max(slab, Index(1)) - margin[N - 1], margin[N - 1] + 1);
+    }
+    const auto domain = Box<N>::from_shape(Position<N>::zero(), shape);
+    const auto bands = Internal::split_bands(domain, (shape[N - 1] + length - 1) / length);
+    const auto size = static_cast<Index>(bands.size());
+    const auto threads = static_cast<int>(std::min(Internal::resolve_thread_count(m_thread_count), size));
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (Index i = 0; i < size; ++i) {
+      const auto& band = bands[i];
+      const auto region = Box<N>::from_shape(front + band.front(), band.shape() + margin);
+      const Internal::TemporaryRaster<std::decay_t<typename TIn::Value>, N> tile(in(region));
+      const auto outK = crop_upto_kth<K - 2>(tile);
+      auto out_band = Internal::output_patch(out, band);
+      filter<K - 1>().transform(outK, out_band);
+    }
+  }
+
+  /**
+   * @brief Apply the filters up to the k-th one to a raster, with cropping at each step.
+   * 
+   * Intermediate results are pooled, such that repeated calls (e.g. per band) do not allocate.
+   */
+  template <std::size_t K, typename TRaster>
+  auto crop_upto_kth(const TRaster& in) const
+  {
+    if constexpr (K == 0) {
+      return Internal::temporary_filter(filter<0>(), in);
+    } else {
+      return Internal::temporary_filter(filter<K>(), crop_upto_kth<K - 1>(in));
+    }
+  }
+
   template <std::size_t K, typename TIn>
   auto upto_kth(const TIn& in) const
   {
     const auto& domain = in.domain() - extend<TIn::Dimension>(Linx::box(filter<K>().window()));
     const auto patch = in(domain);
     if constexpr (K == 0) {
-      return filter<0>() * patch;
+      return Internal::temporary_filter(filter<0>(), patch);
     } else {
-      return filter<K>() * upto_kth<K - 1>(patch);
+      return Internal::temporary_filter(filter<K>(), upto_kth<K - 1>(patch));
     }
   }
 
 private:
 
   std::tuple<TFilters...> m_filters;
+
+  /**
+   * @brief The band length in streaming mode, -1 for automatic, or 0 if disabled.
+   */
+  Index m_band_length = 0;
+
+  /**
+   * @brief The number of threads in streaming mode.
+   */
+  Index m_thread_count = 1;
 };
 
 /**
@@ -5,11 +5,19 @@
 #ifndef _LINXTRANSFORMS_FILTERS_H
 #define _LINXTRANSFORMS_FILTERS_H
 
+#include "Linx/Base/Precompiled.h"
+#include "Linx/Base/Reduction.h"
 #include "Linx/Base/TypeUtils.h"
 #include "Linx/Data/Mask.h" // for sparse_*
 #include "Linx/Transforms/FilterAgg.h"
 #include "Linx/Transforms/FilterSeq.h"
+#include "Linx/Transforms/RecursiveGaussian.h"
 #include "Linx/Transforms/SimpleFilter.h"
+#include "Linx/Transforms/impl/FixedPointCorrelation.h"
+#include "Linx/Transforms/impl/SlidingExtremum.h"
+#include "Linx/Transforms/impl/SlidingRank.h"
+#include "Linx/Transforms/impl/StaticCorrelation.h"
+#include "Linx/Transforms/impl/SummedAreaTable.h"
 #include "Linx/Transforms/mixins/Kernel.h"
 
 namespace Linx {
@@ -27,7 +35,22 @@ public:
   template <typename TIn>
   inline T operator()(const TIn& neighbors) const
   {
-    return std::inner_product(this->m_values.begin(), this->m_values.end(), neighbors.begin(), T {});
+    return transform_sum<T>(
+        Summation::Lanes,
+        [](T e, T f) {
+          return e * f;
+        },
+        this->m_values,
+        neighbors);
+  }
+
+  /**
+   * @brief Get the correlation coefficients, ordered like the window positions.
+   */
+  template <typename U = T, std::enable_if_t<std::is_arithmetic_v<U>>* = nullptr>
+  std::vector<double> correlation_coefficients() const
+  {
+    return {this->m_values.begin(), this->m_values.end()};
   }
 
   void init_impl() // FIXME private
@@ -37,6 +60,7 @@ public:
         e = std::conj(e);
       }
     }
+    this->decompose(this->m_values.begin());
   }
 };
 
@@ -53,10 +77,267 @@ public:
   template <typename TIn>
   inline T operator()(const TIn& neighbors) const
   {
-    return std::inner_product(this->m_values.rbegin(), this->m_values.rend(), neighbors.begin(), T {});
+    auto product = [](T e, T f) {
+      return e * f;
+    };
+    return Internal::sum_n<T>(
+        Summation::Lanes,
+        static_cast<Index>(this->m_values.size()),
+        product,
+        this->m_values.rbegin(),
+        neighbors.begin());
+  }
+
+  /**
+   * @brief Get the correlation coefficients, ordered like the window positions.
+   */
+  template <typename U = T, std::enable_if_t<std::is_arithmetic_v<U>>* = nullptr>
+  std::vector<double> correlation_coefficients() const
+  {
+    return {this->m_values.rbegin(), this->m_values.rend()};
+  }
+
+  void init_impl() // FIXME private
+  {
+    this->decompose(this->m_values.rbegin());
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief Correlation kernel of compile-time shape.
+ * @tparam T The value type
+ * @tparam Lengths The window lengths along each axis
+ *
+ * As opposed to `Correlation`, the coefficients are stored in an `std::array`,
+ * and the window is a centered box whose shape is known at compile time, with origin rounded down.
+ * The region-wise engine computes each output row at once with fully unrolled inner products,
+ * vectorized across output pixels, which is the fastest strategy for small windows, e.g. 3x3 or 5x5.
+ *
+ * @see `correlation()`
+ */
+template <typename T, Index... Lengths>
+class StaticCorrelation :
+    public StructuringElementMixin<T, Box<sizeof...(Lengths)>, StaticCorrelation<T, Lengths...>> {
+public:
+
+  /**
+   * @brief The number of coefficients.
+   */
+  static constexpr Index Size = (Index(1) * ... * Lengths);
+
+  /**
+   * @brief Constructor.
+   * @param values The correlation coefficients, ordered like the window positions
+   */
+  explicit StaticCorrelation(const std::array<T, Size>& values) :
+      StructuringElementMixin<T, Box<sizeof...(Lengths)>, StaticCorrelation>(static_window()), m_values(values)
+  {}
+
+  /**
+   * @brief Get the window, which is centered with origin rounded down.
+   */
+  static Box<sizeof...(Lengths)> static_window()
+  {
+    const Position<sizeof...(Lengths)> shape {Lengths...};
+    return Box<sizeof...(Lengths)>::from_shape(-(shape - 1) / 2, shape);
+  }
+
+  /**
+   * @brief Get the kernel values, ordered like the window positions.
+   */
+  const std::array<T, Size>& values() const
+  {
+    return m_values;
+  }
+
+  template <typename TIn>
+  inline T operator()(const TIn& neighbors) const
+  {
+    T sum = 0;
+    auto c = m_values.begin();
+    for (const auto& e : neighbors) {
+      sum += *c * e;
+      ++c;
+    }
+    return sum;
   }
 
-  void init_impl() {} // FIXME private
+  /**
+   * @brief Get the correlation coefficients, ordered like the window positions.
+   */
+  template <typename U = T, std::enable_if_t<std::is_arithmetic_v<U>>* = nullptr>
+  std::vector<double> correlation_coefficients() const
+  {
+    return {m_values.begin(), m_values.end()};
+  }
+
+  /**
+   * @brief Check whether `transform_region()` is applicable, i.e. whether the values are real.
+   */
+  bool transforms_region() const
+  {
+    return std::is_arithmetic_v<T>;
+  }
+
+  /**
+   * @brief Filter a whole region with unrolled inner products.
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<TIn::Dimension == sizeof...(Lengths) && std::is_arithmetic_v<T>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    Internal::static_correlate(std::integer_sequence<Index, Lengths...>(), in, front, m_values, shape, out);
+  }
+
+private:
+
+  /**
+   * @brief The kernel values.
+   */
+  std::array<T, Size> m_values;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Fixed-point correlation kernel for integer rasters.
+ * @tparam T The integral input and output value type, of at most 32 bits
+ *
+ * Coefficients are quantized as 16-bit integers `q = round(c * 2^shift)`,
+ * such that products are accumulated exactly in 32-bit integers for inputs up to 16 bits
+ * (64-bit integers otherwise), and sums are rounded, shifted back and saturated to `T`.
+ * No floating point copy of the input is made.
+ *
+ * The number of fractional bits, `shift()`, is the largest one up to the requested number of bits
+ * such that neither the coefficients nor the accumulators overflow.
+ * The direct and region-wise paths perform the same integer operations, and therefore yield identical results.
+ */
+template <typename T, typename TWindow>
+class FixedPointCorrelation : public StructuringElementMixin<T, TWindow, FixedPointCorrelation<T, TWindow>> {
+public:
+
+  /**
+   * @brief The accumulator type.
+   */
+  using Accumulator = typename Internal::FixedPointTypes<T>::Accumulator;
+
+  /**
+   * @brief Constructor.
+   * @param window The window
+   * @param values The correlation coefficients, ordered like the window positions
+   * @param bits The maximum number of fractional bits, in [0, 15]
+   */
+  FixedPointCorrelation(TWindow window, const std::vector<double>& values, Index bits = 15) :
+      StructuringElementMixin<T, TWindow, FixedPointCorrelation>(LINX_MOVE(window)), m_coefficients(values.size()),
+      m_shift(bits)
+  {
+    OutOfBoundsError::may_throw("Fractional bits: ", bits, {0, 15});
+    const double range = std::max(-double(std::numeric_limits<T>::min()), double(std::numeric_limits<T>::max()));
+    const double acc_max = double(std::numeric_limits<Accumulator>::max());
+    for (; m_shift >= 0; --m_shift) {
+      double norm = 0;
+      bool fits = true;
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        const auto q = std::round(std::ldexp(values[i], m_shift));
+        fits &= std::abs(q) <= 32767;
+        norm += std::abs(q);
+        m_coefficients[i] = static_cast<std::int16_t>(q);
+      }
+      if ((fits && norm * range <= acc_max) || m_shift == 0) {
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Get the number of fractional bits of the quantized coefficients.
+   */
+  Index shift() const
+  {
+    return m_shift;
+  }
+
+  /**
+   * @brief Get the quantized coefficients, ordered like the window positions.
+   */
+  const std::vector<std::int16_t>& coefficients() const
+  {
+    return m_coefficients;
+  }
+
+  /**
+   * @brief Get the correlation coefficients, i.e. the dequantized coefficients.
+   */
+  std::vector<double> correlation_coefficients() const
+  {
+    std::vector<double> out(m_coefficients.size());
+    std::transform(m_coefficients.begin(), m_coefficients.end(), out.begin(), [&](auto q) {
+      return std::ldexp(q, -m_shift);
+    });
+    return out;
+  }
+
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    Accumulator acc = 0;
+    auto q = m_coefficients.begin();
+    for (const auto& e : neighbors) {
+      acc += Accumulator(*q) * static_cast<Accumulator>(e);
+      ++q;
+    }
+    return Internal::fixed_point_round<T>(acc, m_shift);
+  }
+
+  /**
+   * @brief Check whether the row-wise engine is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, FixedPointCorrelation::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with integer shift-and-accumulate.
+   *
+   * Input rows are fetched as 16-bit integers (for inputs up to 16 bits)
+   * and accumulated two taps at a time with widening 16-bit multiplications.
+   *
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == FixedPointCorrelation::Dimension &&
+          std::is_same_v<std::decay_t<typename TIn::Value>, T>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    Internal::fixed_point_correlate<T>(in, front, box(this->window()).shape(), m_coefficients, m_shift, shape, out);
+  }
+
+private:
+
+  /**
+   * @brief The quantized coefficients.
+   */
+  std::vector<std::int16_t> m_coefficients;
+
+  /**
+   * @brief The number of fractional bits.
+   */
+  Index m_shift;
 };
 
 /**
@@ -69,10 +350,153 @@ struct MeanFilter : public StructuringElementMixin<T, TWindow, MeanFilter<T, TWi
   template <typename TIn>
   T operator()(const TIn& neighbors) const
   {
-    return std::accumulate(neighbors.begin(), neighbors.end(), T()) / neighbors.size();
+    return transform_sum<T>(
+               Summation::Lanes,
+               [](T e) {
+                 return e;
+               },
+               neighbors) /
+        neighbors.size();
+  }
+
+  /**
+   * @brief Check whether the summed-area table is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, MeanFilter::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with a summed-area table.
+   * 
+   * The cost per pixel is `2^N` additions whatever the window size.
+   * Sums are accumulated exactly for integers, as `double`s for `float`s, and as `long double`s otherwise.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == MeanFilter::Dimension && std::is_arithmetic_v<T> && not std::is_same_v<T, bool> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    Internal::summed_area_mean<T>(in, front, box(this->window()).shape(), shape, out);
   }
 };
 
+/**
+ * @ingroup filtering
+ * @brief Local mean, variance and standard deviation with a box window.
+ *
+ * The three maps are computed together from summed-area tables of the values and of their squares,
+ * in a single pass over the input, whatever the window size.
+ * This is cheaper than two mean filters and a square, which each allocate a full raster.
+ *
+ * \code
+ * const auto moments = local_moments<float>(Box<2>::from_center(3));
+ * const auto [mean, variance, stdev] = moments * extrapolation<Nearest>(image);
+ * \endcode
+ *
+ * @see `local_moments()`
+ */
+template <typename T, Index N>
+class LocalMoments {
+  static_assert(std::is_floating_point_v<T>, "Local moments must be floating point values.");
+
+public:
+
+  /**
+   * @brief The output value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The output maps.
+   */
+  struct Maps {
+    Raster<T, N> mean; ///< The local mean
+    Raster<T, N> variance; ///< The local variance
+    Raster<T, N> stdev; ///< The local standard deviation
+  };
+
+  /**
+   * @brief Constructor.
+   */
+  explicit LocalMoments(Box<N> window) : m_window(LINX_MOVE(window)) {}
+
+  /**
+   * @brief Get the window.
+   */
+  const Box<N>& window() const
+  {
+    return m_window;
+  }
+
+  /**
+   * @brief Compute the moments into given outputs.
+   * @param in The input raster, or extrapolated raster
+   * @param mean The local mean output
+   * @param variance The local variance output
+   * @param stdev The local standard deviation output
+   *
+   * The outputs are rasters or patches of the shape of `operator*()`'s outputs, which are overwritten.
+   */
+  template <typename TIn, typename TMean, typename TVariance, typename TStdev>
+  void transform(const TIn& in, TMean& mean, TVariance& variance, TStdev& stdev) const
+  {
+    const auto shape = output_shape(in);
+    SizeError::may_throw(mean.size(), shape_size(shape));
+    SizeError::may_throw(variance.size(), shape_size(shape));
+    SizeError::may_throw(stdev.size(), shape_size(shape));
+    const auto front = is_extrapolator<TIn>() ? m_window.front() : Position<N>::zero();
+    Internal::summed_area_moments<T>(in, front, m_window.shape(), shape, mean, variance, stdev);
+  }
+
+  /**
+   * @brief Compute the moments with cropping, or with extrapolation if `in` is an extrapolator.
+   */
+  template <typename TIn>
+  Maps operator*(const TIn& in) const
+  {
+    const auto shape = output_shape(in);
+    Maps out {Raster<T, N>(shape), Raster<T, N>(shape), Raster<T, N>(shape)};
+    transform(in, out.mean, out.variance, out.stdev);
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Get the output shape: that of the input if extrapolated, or that of the inner region otherwise.
+   */
+  template <typename TIn>
+  Position<N> output_shape(const TIn& in) const
+  {
+    if constexpr (is_extrapolator<TIn>()) {
+      return in.shape();
+    } else {
+      return in.shape() - m_window.shape() + 1;
+    }
+  }
+
+  /**
+   * @brief The window.
+   */
+  Box<N> m_window;
+};
+
 /**
  * @ingroup filtering
  * @brief Median filtering kernel.
@@ -96,6 +520,47 @@ struct MedianFilter :
     std::nth_element(b, n + 1, e);
     return (*n + *(n + 1)) * .5;
   }
+
+  /**
+   * @brief Check whether the sliding median is applicable, i.e. whether the window is a box of odd size.
+   */
+  bool transforms_region() const
+  {
+    if constexpr (std::is_same_v<std::decay_t<TWindow>, Box<MedianFilter::Dimension>>) {
+      return this->window().size() % 2 == 1;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Filter a whole region with a sliding median.
+   * 
+   * The window is slid along axis 0 with incremental updates instead of being sorted at each pixel,
+   * using a histogram for 8- and 16-bit integers, and a sorted window otherwise.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == MedianFilter::Dimension && std::is_arithmetic_v<T> &&
+          std::is_same_v<std::decay_t<typename TIn::Value>, T>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    if constexpr (is_extrapolator<TIn>()) {
+      const auto raster = in.copy(Box<TIn::Dimension>::from_shape(front, shape + window - 1));
+      Internal::sliding_median(raster, Position<TIn::Dimension>::zero(), window, shape, out);
+    } else {
+      Internal::sliding_median(in, front, window, shape, out);
+    }
+  }
 };
 
 /**
@@ -108,7 +573,50 @@ struct MinimumFilter : public StructuringElementMixin<T, TWindow, MinimumFilter<
   template <typename TIn>
   inline T operator()(const TIn& neighbors) const
   {
-    return *std::min_element(neighbors.begin(), neighbors.end());
+    // Iterators of extrapolated patches are not assignable, which prevents from using std::min_element()
+    return std::accumulate(std::next(neighbors.begin()), neighbors.end(), T(*neighbors.begin()), [](T lhs, T rhs) {
+      return std::min(lhs, rhs);
+    });
+  }
+
+  /**
+   * @brief Check whether the van Herk/Gil-Werman algorithm is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, MinimumFilter::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with the van Herk/Gil-Werman algorithm.
+   * 
+   * The minimum is computed axis by axis, with about three comparisons per pixel and axis whatever the window size.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == MinimumFilter::Dimension && std::is_arithmetic_v<T> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    Internal::sliding_extremum<T>(
+        in,
+        front,
+        window,
+        shape,
+        Internal::SlidingMin(),
+        [](const auto& e) {
+          return static_cast<T>(e);
+        },
+        out);
   }
 };
 
@@ -122,8 +630,231 @@ struct MaximumFilter : public StructuringElementMixin<T, TWindow, MaximumFilter<
   template <typename TIn>
   inline T operator()(const TIn& neighbors) const
   {
-    return *std::max_element(neighbors.begin(), neighbors.end());
+    // Iterators of extrapolated patches are not assignable, which prevents from using std::max_element()
+    return std::accumulate(std::next(neighbors.begin()), neighbors.end(), T(*neighbors.begin()), [](T lhs, T rhs) {
+      return std::max(lhs, rhs);
+    });
+  }
+
+  /**
+   * @brief Check whether the van Herk/Gil-Werman algorithm is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, MaximumFilter::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with the van Herk/Gil-Werman algorithm.
+   * 
+   * The maximum is computed axis by axis, with about three comparisons per pixel and axis whatever the window size.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == MaximumFilter::Dimension && std::is_arithmetic_v<T> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    Internal::sliding_extremum<T>(
+        in,
+        front,
+        window,
+        shape,
+        Internal::SlidingMax(),
+        [](const auto& e) {
+          return static_cast<T>(e);
+        },
+        out);
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief Rank filtering kernel, which selects the value of given quantile in each neighborhood.
+ * 
+ * The output is the value of rank `round(quantile * (size - 1))` in the sorted neighborhood,
+ * such that quantiles 0, 0.5 and 1 respectively yield the minimum, median (for odd sizes) and maximum filters.
+ */
+template <typename T, typename TWindow>
+struct RankFilter : public StructuringElementMixin<T, TWindow, RankFilter<T, TWindow>> {
+  /**
+   * @brief Constructor.
+   * @param window The structuring element
+   * @param quantile The quantile, in [0, 1]
+   */
+  RankFilter(TWindow window, double quantile) :
+      StructuringElementMixin<T, TWindow, RankFilter>(LINX_MOVE(window)), m_quantile(quantile)
+  {
+    OutOfBoundsError::may_throw("Quantile: ", m_quantile, {0., 1.});
+  }
+
+  /**
+   * @brief Get the quantile.
+   */
+  double quantile() const
+  {
+    return m_quantile;
+  }
+
+  /**
+   * @brief Get the rank of the output value in a neighborhood of given size.
+   */
+  Index rank(Index size) const
+  {
+    return std::lround(m_quantile * (size - 1));
   }
+
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    std::vector<T> v(neighbors.begin(), neighbors.end());
+    const auto n = v.begin() + rank(v.size());
+    std::nth_element(v.begin(), n, v.end());
+    return *n;
+  }
+
+  /**
+   * @brief Check whether a sliding engine is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, RankFilter::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region by sliding the window.
+   * 
+   * The extreme ranks are computed with the van Herk/Gil-Werman algorithm, like `MinimumFilter` and `MaximumFilter`,
+   * and the other ones with the sliding order statistics of `MedianFilter`.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == RankFilter::Dimension && std::is_arithmetic_v<T> &&
+          std::is_same_v<std::decay_t<typename TIn::Value>, T>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    const auto r = rank(shape_size(window));
+    const auto convert = [](const auto& e) {
+      return static_cast<T>(e);
+    };
+    if (r == 0) {
+      Internal::sliding_extremum<T>(in, front, window, shape, Internal::SlidingMin(), convert, out);
+    } else if (r == shape_size(window) - 1) {
+      Internal::sliding_extremum<T>(in, front, window, shape, Internal::SlidingMax(), convert, out);
+    } else if constexpr (is_extrapolator<TIn>()) {
+      const auto raster = in.copy(Box<TIn::Dimension>::from_shape(front, shape + window - 1));
+      Internal::sliding_rank(raster, Position<TIn::Dimension>::zero(), window, shape, r, out);
+    } else {
+      Internal::sliding_rank(in, front, window, shape, r, out);
+    }
+  }
+
+private:
+
+  /**
+   * @brief The quantile.
+   */
+  double m_quantile;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Trimmed mean filtering kernel, which averages the central values of each sorted neighborhood.
+ * 
+ * The `floor(trim * size)` lowest and highest values are discarded before averaging.
+ */
+template <typename T, typename TWindow>
+struct TrimmedMeanFilter : public StructuringElementMixin<T, TWindow, TrimmedMeanFilter<T, TWindow>> {
+  /**
+   * @brief Constructor.
+   * @param window The structuring element
+   * @param trim The fraction of values which are discarded on each side, in [0, 0.5)
+   */
+  TrimmedMeanFilter(TWindow window, double trim) :
+      StructuringElementMixin<T, TWindow, TrimmedMeanFilter>(LINX_MOVE(window)), m_trim(trim)
+  {
+    OutOfBoundsError::may_throw("Trim: ", m_trim, {0., std::nextafter(.5, 0.)});
+  }
+
+  /**
+   * @brief Get the trimmed fraction on each side.
+   */
+  double trim() const
+  {
+    return m_trim;
+  }
+
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    std::vector<T> v(neighbors.begin(), neighbors.end());
+    std::sort(v.begin(), v.end());
+    const auto first = static_cast<Index>(m_trim * v.size());
+    const auto last = static_cast<Index>(v.size()) - 1 - first;
+    return static_cast<T>(std::accumulate(v.begin() + first, v.begin() + last + 1, 0.) / (last - first + 1));
+  }
+
+  /**
+   * @brief Check whether the sliding engine is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, TrimmedMeanFilter::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region by sliding a sorted window.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == TrimmedMeanFilter::Dimension && std::is_arithmetic_v<T> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    const auto size = shape_size(window);
+    const auto first = static_cast<Index>(m_trim * size);
+    const auto last = size - 1 - first;
+    if constexpr (is_extrapolator<TIn>()) {
+      const auto raster = in.copy(Box<TIn::Dimension>::from_shape(front, shape + window - 1));
+      Internal::sliding_trimmed_mean<T>(raster, Position<TIn::Dimension>::zero(), window, shape, first, last, out);
+    } else {
+      Internal::sliding_trimmed_mean<T>(in, front, window, shape, first, last, out);
+    }
+  }
+
+private:
+
+  /**
+   * @brief The trimmed fraction on each side.
+   */
+  double m_trim;
 };
 
 /**
@@ -160,6 +891,46 @@ struct BinaryErosion : public StructuringElementMixin<T, TWindow, BinaryErosion<
     patch <<= pos;
     return out;
   }
+
+  /**
+   * @brief Check whether the van Herk/Gil-Werman algorithm is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, BinaryErosion::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with the van Herk/Gil-Werman algorithm.
+   * 
+   * The erosion is computed axis by axis, with about three comparisons per pixel and axis whatever the window size.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == BinaryErosion::Dimension && std::is_arithmetic_v<T> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    Internal::sliding_extremum<T>(
+        in,
+        front,
+        window,
+        shape,
+        Internal::SlidingMin(),
+        [](const auto& e) {
+          return static_cast<T>(bool(e));
+        },
+        out);
+  }
 };
 
 /**
@@ -196,6 +967,150 @@ struct BinaryDilation : public StructuringElementMixin<T, TWindow, BinaryDilatio
     patch <<= pos;
     return out;
   }
+
+  /**
+   * @brief Check whether the van Herk/Gil-Werman algorithm is applicable, i.e. whether the window is a box.
+   */
+  bool transforms_region() const
+  {
+    return Internal::is_box_window<TWindow, BinaryDilation::Dimension>();
+  }
+
+  /**
+   * @brief Filter a whole region with the van Herk/Gil-Werman algorithm.
+   * 
+   * The dilation is computed axis by axis, with about three comparisons per pixel and axis whatever the window size.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <
+      typename TIn,
+      typename TOut,
+      std::enable_if_t<
+          TIn::Dimension == BinaryDilation::Dimension && std::is_arithmetic_v<T> &&
+          std::is_arithmetic_v<std::decay_t<typename TIn::Value>>>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    const auto window = box(this->window()).shape();
+    Internal::sliding_extremum<T>(
+        in,
+        front,
+        window,
+        shape,
+        Internal::SlidingMax(),
+        [](const auto& e) {
+          return static_cast<T>(bool(e));
+        },
+        out);
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief Fused morphological opening or closing kernel, optionally followed by a top-hat.
+ * @tparam TFirst The extremum operator of the first pass, i.e. `Internal::SlidingMin` for the opening
+ * @tparam TSecond The extremum operator of the second pass, i.e. `Internal::SlidingMax` for the opening
+ * @tparam TResidual The combination of the input and filtered values, e.g. `Internal::WhiteResidual` for the top-hat
+ * 
+ * The kernel window is the footprint of the composite operation, i.e. the structuring element dilated by itself.
+ * Box structuring elements are processed region-wise with the van Herk/Gil-Werman algorithm,
+ * both passes sharing the same buffers, and the residual being fused with the output assignment.
+ */
+template <typename T, Index N, typename TFirst, typename TSecond, typename TResidual>
+class OpeningClosing {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The window type.
+   */
+  using Window = Box<N>;
+
+  /**
+   * @brief Constructor.
+   */
+  explicit OpeningClosing(Box<N> element) :
+      m_element(LINX_MOVE(element)), m_window(m_element.front() - m_element.back(), m_element.back() - m_element.front())
+  {}
+
+  /**
+   * @brief Get the structuring element.
+   */
+  const Box<N>& element() const
+  {
+    return m_element;
+  }
+
+  /**
+   * @brief Get the footprint.
+   */
+  const Box<N>& window() const
+  {
+    return m_window;
+  }
+
+  /**
+   * @brief Compute the output at the center of a footprint.
+   */
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    Raster<T, N> footprint(m_window.shape());
+    std::copy(neighbors.begin(), neighbors.end(), footprint.begin());
+    std::array<T, 1> out;
+    transform_region(footprint, Position<N>::zero(), Position<N>::one(), out);
+    return out[0];
+  }
+
+  /**
+   * @brief Check whether the region-wise engine is applicable, which is always the case.
+   */
+  bool transforms_region() const
+  {
+    return true;
+  }
+
+  /**
+   * @brief Filter a whole region with the van Herk/Gil-Werman algorithm.
+   * 
+   * Each pass costs about three comparisons per pixel and axis whatever the window size.
+   * 
+   * @see `SimpleFilter`
+   */
+  template <typename TIn, typename TOut, std::enable_if_t<TIn::Dimension == N>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    Internal::sliding_opening<T>(in, front, m_element.shape(), shape, TFirst(), TSecond(), TResidual(), out);
+  }
+
+private:
+
+  /**
+   * @brief The structuring element.
+   */
+  Box<N> m_element;
+
+  /**
+   * @brief The footprint.
+   */
+  Box<N> m_window;
 };
 
 /**
@@ -277,6 +1192,75 @@ auto correlation(const Raster<T, N, THolder>& values)
   return correlation(values.data(), values.domain() - (values.shape() - 1) / 2);
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a correlation kernel of compile-time shape, with centered origin.
+ * @tparam T The value type
+ * @tparam Lengths The window lengths along each axis
+ * @param values The correlation coefficients, ordered like the window positions
+ *
+ * \code
+ * const auto kernel = correlation<float, 3, 3>({0, 1, 0, 1, -4, 1, 0, 1, 0});
+ * \endcode
+ *
+ * @see `StaticCorrelation`
+ */
+template <typename T, Index L0, Index... Ls>
+auto correlation(const std::array<T, (L0 * ... * Ls)>& values)
+{
+  return SimpleFilter<StaticCorrelation<T, L0, Ls...>>(values);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a convolution kernel of compile-time shape, with centered origin.
+ *
+ * The kernel is stored as the equivalent correlation kernel, i.e. with reversed values.
+ *
+ * @see `StaticCorrelation`
+ */
+template <typename T, Index L0, Index... Ls>
+auto convolution(std::array<T, (L0 * ... * Ls)> values)
+{
+  std::reverse(values.begin(), values.end());
+  return SimpleFilter<StaticCorrelation<T, L0, Ls...>>(values);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a fixed-point correlation kernel for integer rasters from a raster of coefficients, with centered origin.
+ * @tparam T The integral input and output value type
+ * @param values The correlation coefficients
+ * @param bits The maximum number of fractional bits of the quantized coefficients
+ *
+ * This is a faster alternative to `correlation()` for 8- and 16-bit images,
+ * at the cost of quantizing the coefficients and rounding the output.
+ *
+ * @see `FixedPointCorrelation`
+ */
+template <typename T, typename U, Index N, typename THolder>
+auto fixed_point_correlation(const Raster<U, N, THolder>& values, Index bits = 15)
+{
+  return SimpleFilter<FixedPointCorrelation<T, Box<N>>>(
+      values.domain() - (values.shape() - 1) / 2,
+      std::vector<double>(values.begin(), values.end()),
+      bits);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a fixed-point convolution kernel for integer rasters from a raster of coefficients, with centered origin.
+ *
+ * @see `fixed_point_correlation()`
+ */
+template <typename T, typename U, Index N, typename THolder>
+auto fixed_point_convolution(const Raster<U, N, THolder>& values, Index bits = 15)
+{
+  std::vector<double> reversed(values.begin(), values.end());
+  std::reverse(reversed.begin(), reversed.end());
+  return SimpleFilter<FixedPointCorrelation<T, Box<N>>>(values.domain() - (values.shape() - 1) / 2, reversed, bits);
+}
+
 /**
  * @ingroup filtering
  * @brief Create a filter made of identical 1D correlation kernels along given axes.
@@ -319,6 +1303,54 @@ auto convolution_along(const std::vector<T>& values)
   }
 }
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Check whether an axis belongs to a list.
+ */
+template <Index... Is>
+constexpr bool contains_axis(Index axis)
+{
+  return ((axis == Is) || ...);
+}
+
+/**
+ * @brief Make a correlation kernel of compile-time shape, whose window is 3-pixel long along some axes.
+ * @param coefficient The function which computes the coefficient at each window position
+ *
+ * The window length is 1 along the other axes.
+ */
+template <typename T, Index... Is, std::size_t... As, typename TFunc>
+auto static_correlation_along(std::integer_sequence<Index, Is...>, std::index_sequence<As...>, TFunc&& coefficient)
+{
+  using TKernel = StaticCorrelation<T, (contains_axis<Is...>(As) ? 3 : 1)...>;
+  std::array<T, TKernel::Size> values;
+  auto it = values.begin();
+  for (const auto& p : TKernel::static_window()) {
+    *it = coefficient(p);
+    ++it;
+  }
+  return SimpleFilter<TKernel>(values);
+}
+
+/**
+ * @brief Make a 3x3 gradient filter from the averaging kernel.
+ */
+template <typename T, Index IDerivation, Index... IAveraging>
+auto static_gradient(T sign, std::array<T, 3> averaging)
+{
+  return static_correlation_along<T>(
+      std::integer_sequence<Index, IDerivation, IAveraging...>(),
+      std::make_index_sequence<std::max({IDerivation, IAveraging...}) + 1>(),
+      [&](const auto& p) {
+        return T(sign * p[IDerivation] * (T(1) * ... * averaging[p[IAveraging] + 1]));
+      });
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief Make a Prewitt gradient filter along given axes.
@@ -330,6 +1362,7 @@ auto convolution_along(const std::vector<T>& values)
  * The convolution kernel along the `IAveraging` axes is `{1, 1, 1}` and that along `IDerivation` is `{sign, 0, -sign}`.
  * For differenciation in the increasing-index direction, keep `sign = 1`;
  * for the opposite direction, set `sign = -1`.
+ * The filter is a `StaticCorrelation`, i.e. the outer product of the 1D kernels with a compile-time window.
  * 
  * For example, to compute the derivative along axis 1 backward, while averaging along axes 0 and 2, do:
  * \code
@@ -343,9 +1376,7 @@ auto convolution_along(const std::vector<T>& values)
 template <typename T, Index IDerivation, Index... IAveraging>
 auto prewitt_gradient(T sign = 1)
 {
-  const auto derivation = convolution_along<T, IDerivation>({sign, 0, -sign});
-  const auto averaging = convolution_along<T, IAveraging...>({1, 1, 1});
-  return derivation * averaging;
+  return Internal::static_gradient<T, IDerivation, IAveraging...>(sign, {1, 1, 1});
 }
 
 /**
@@ -360,9 +1391,7 @@ auto prewitt_gradient(T sign = 1)
 template <typename T, Index IDerivation, Index... IAveraging>
 auto sobel_gradient(T sign = 1)
 {
-  const auto derivation = convolution_along<T, IDerivation>({sign, 0, -sign});
-  const auto averaging = convolution_along<T, IAveraging...>({1, 2, 1});
-  return derivation * averaging;
+  return Internal::static_gradient<T, IDerivation, IAveraging...>(sign, {1, 2, 1});
 }
 
 /**
@@ -377,31 +1406,60 @@ auto sobel_gradient(T sign = 1)
 template <typename T, Index IDerivation, Index... IAveraging>
 auto scharr_gradient(T sign = 1)
 {
-  const auto derivation = convolution_along<T, IDerivation>({sign, 0, -sign});
-  const auto averaging = convolution_along<T, IAveraging...>({3, 10, 3});
-  return derivation * averaging;
+  return Internal::static_gradient<T, IDerivation, IAveraging...>(sign, {3, 10, 3});
 }
 
 /**
  * @ingroup filtering
  * @brief Make a Laplace operator along given axes.
  * 
- * The convolution kernel is built as a sum of 1D kernels `{sign, -2 * sign, sign}`.
+ * The convolution kernel is built as a sum of 1D kernels `{sign, -2 * sign, sign}`,
+ * and stored as a `StaticCorrelation`.
  */
 template <typename T, Index... Is>
 auto laplace_operator(T sign = 1)
 {
-  return FilterAgg(std::plus<T>(), convolution_along<T, Is>({sign, sign * -2, sign})...);
+  const std::array<T, 3> line {sign, sign * -2, sign};
+  return Internal::static_correlation_along<T>(
+      std::integer_sequence<Index, Is...>(),
+      std::make_index_sequence<std::max({Is...}) + 1>(),
+      [&](const auto& p) {
+        T out = 0;
+        for (auto a : {Is...}) {
+          bool on_axis = true;
+          for (auto b : {Is...}) {
+            on_axis &= (b == a || p[b] == 0);
+          }
+          if (on_axis) {
+            out += line[p[a] + 1];
+          }
+        }
+        return out;
+      });
 }
 
 /**
  * @ingroup filtering
  * @brief Make a mean filter with a given structuring element.
+ * 
+ * If the structuring element is a box, a summed-area table is used, whose cost is independent of the window size.
  */
 template <typename T, typename TWindow>
 auto mean_filter(TWindow&& window)
 {
-  return SimpleFilter<MeanFilter<T, TWindow>>(MeanFilter<T, TWindow>(LINX_FORWARD(window))); // FIXME separable
+  return SimpleFilter<MeanFilter<T, TWindow>>(MeanFilter<T, TWindow>(LINX_FORWARD(window)));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a local moments transform with a given box window.
+ *
+ * @see `LocalMoments`
+ */
+template <typename T, Index N>
+LocalMoments<T, N> local_moments(Box<N> window)
+{
+  return LocalMoments<T, N>(LINX_MOVE(window));
 }
 
 /**
@@ -434,6 +1492,28 @@ auto maximum_filter(TWindow&& window)
   return SimpleFilter<MaximumFilter<T, TWindow>>(MaximumFilter<T, TWindow>(LINX_FORWARD(window)));
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a rank filter with a given structuring element and quantile.
+ * 
+ * For example, `rank_filter<float>(Box<2>::from_center(7), .05)` computes the 5th percentile of each neighborhood.
+ */
+template <typename T, typename TWindow>
+auto rank_filter(TWindow&& window, double quantile)
+{
+  return SimpleFilter<RankFilter<T, TWindow>>(RankFilter<T, TWindow>(LINX_FORWARD(window), quantile));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a trimmed mean filter with a given structuring element and trimmed fraction on each side.
+ */
+template <typename T, typename TWindow>
+auto trimmed_mean_filter(TWindow&& window, double trim)
+{
+  return SimpleFilter<TrimmedMeanFilter<T, TWindow>>(TrimmedMeanFilter<T, TWindow>(LINX_FORWARD(window), trim));
+}
+
 /**
  * @ingroup filtering
  * @brief Make a erosion filter with a given structuring element.
@@ -454,6 +1534,63 @@ auto dilation(TWindow&& window)
   return SimpleFilter<BinaryDilation<T, TWindow>>(BinaryDilation<T, TWindow>(LINX_FORWARD(window)));
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a morphological opening filter, i.e. an erosion followed by a dilation, with a box structuring element.
+ * 
+ * This is equivalent to `maximum_filter<T>(element) * minimum_filter<T>(element)` (up to the window orientation),
+ * without intermediate raster.
+ */
+template <typename T, Index N>
+auto opening(Box<N> element)
+{
+  using Kernel = OpeningClosing<T, N, Internal::SlidingMin, Internal::SlidingMax, Internal::NoResidual>;
+  return SimpleFilter<Kernel>(LINX_MOVE(element));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a morphological closing filter, i.e. a dilation followed by an erosion, with a box structuring element.
+ */
+template <typename T, Index N>
+auto closing(Box<N> element)
+{
+  using Kernel = OpeningClosing<T, N, Internal::SlidingMax, Internal::SlidingMin, Internal::NoResidual>;
+  return SimpleFilter<Kernel>(LINX_MOVE(element));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a white top-hat filter, i.e. the input minus its opening, with a box structuring element.
+ * 
+ * The subtraction is fused with the opening, e.g. for background removal in a single pass over the output.
+ */
+template <typename T, Index N>
+auto white_tophat(Box<N> element)
+{
+  using Kernel = OpeningClosing<T, N, Internal::SlidingMin, Internal::SlidingMax, Internal::WhiteResidual>;
+  return SimpleFilter<Kernel>(LINX_MOVE(element));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a black top-hat filter, i.e. the closing of the input minus the input, with a box structuring element.
+ */
+template <typename T, Index N>
+auto black_tophat(Box<N> element)
+{
+  using Kernel = OpeningClosing<T, N, Internal::SlidingMax, Internal::SlidingMin, Internal::BlackResidual>;
+  return SimpleFilter<Kernel>(LINX_MOVE(element));
+}
+
+#ifdef LINX_PRECOMPILED
+#define LINX_EXTERN_KERNELS(T, N) \
+  extern template class Correlation<T, Box<N>>; \
+  extern template class Convolution<T, Box<N>>;
+LINX_PRECOMPILED_KERNELS(LINX_EXTERN_KERNELS)
+#undef LINX_EXTERN_KERNELS
+#endif
+
 } // namespace Linx
 
 #endif
@@ -6,10 +6,115 @@
 #define _LINXTRANSFORMS_INTERPOLATION_H
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/SimpleFilter.h" // resolve_thread_count
 #include "Linx/Transforms/impl/ResamplingMethods.h"
 
+#include <algorithm> // clamp
+#include <memory> // shared_ptr
+#include <utility> // pair
+#include <vector>
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The raster of a prefiltered interpolation, and the extrapolation method of its coefficients.
+ */
+template <typename TParent, typename T>
+struct PrefilterSource;
+
+template <typename U, Index N, typename THolder, typename T>
+struct PrefilterSource<Raster<U, N, THolder>, T> {
+  using Method = Mirror;
+
+  static const Raster<U, N, THolder>& raster(const Raster<U, N, THolder>& in)
+  {
+    return in;
+  }
+
+  static Method method(const Raster<U, N, THolder>&)
+  {
+    return {};
+  }
+};
+
+template <typename U, Index N, typename THolder, typename TMethod, typename T>
+struct PrefilterSource<Extrapolation<Raster<U, N, THolder>, TMethod>, T> {
+  using Method = TMethod;
+
+  static const Raster<U, N, THolder>& raster(const Extrapolation<Raster<U, N, THolder>, TMethod>& in)
+  {
+    return in.raster();
+  }
+
+  static Method method(const Extrapolation<Raster<U, N, THolder>, TMethod>& in)
+  {
+    return in.method();
+  }
+};
+
+template <typename U, Index N, typename THolder, typename V, typename T>
+struct PrefilterSource<Extrapolation<Raster<U, N, THolder>, Constant<V>>, T> {
+  using Method = Constant<T>; // Same type as the coefficients
+
+  static const Raster<U, N, THolder>& raster(const Extrapolation<Raster<U, N, THolder>, Constant<V>>& in)
+  {
+    return in.raster();
+  }
+
+  static Method method(const Extrapolation<Raster<U, N, THolder>, Constant<V>>& in)
+  {
+    return Method(T(V(in.method())));
+  }
+};
+
+/**
+ * @brief Get an order of some positions such that the positions of a same tile are consecutive.
+ * @param side The tile length along each axis
+ * 
+ * Tiles are ordered like the pixels of a raster, and out-of-domain positions are assigned to the nearest tiles.
+ * The order is computed by counting sort, in linear time.
+ */
+template <typename TPositions, Index N>
+std::vector<Index> tile_order(const TPositions& positions, const Position<N>& shape, Index side)
+{
+  const auto dimension = static_cast<Index>(shape.size());
+  Position<N> tiles(dimension);
+  Index count = 1;
+  for (Index i = 0; i < dimension; ++i) {
+    tiles[i] = std::max((shape[i] + side - 1) / side, Index(1));
+    count *= tiles[i];
+  }
+  const auto size = static_cast<Index>(positions.size());
+  std::vector<Index> keys(size);
+  std::vector<Index> offsets(count + 1, 0);
+  for (Index j = 0; j < size; ++j) {
+    const auto& p = positions[j];
+    Index key = 0;
+    for (Index i = dimension - 1; i >= 0; --i) {
+      const auto x = std::clamp(static_cast<Index>(std::floor(p[i])), Index(0), shape[i] - 1);
+      key = key * tiles[i] + x / side;
+    }
+    keys[j] = key;
+    ++offsets[key + 1];
+  }
+  for (Index k = 0; k < count; ++k) {
+    offsets[k + 1] += offsets[k];
+  }
+  std::vector<Index> out(size);
+  for (Index j = 0; j < size; ++j) {
+    out[offsets[keys[j]]++] = j;
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup resampling
  * @brief Interpolation decorator with optional extrapolator.
@@ -24,6 +129,24 @@ namespace Linx {
  * 
  * If `TParent` is a raster, then no bound checking is performed.
  * This is the fastest option when no value outside the raster domain has to be evaluated.
+ * 
+ * If `TParent` is an extrapolator and the method is separable (e.g. `Linear` or `Cubic`),
+ * then most queries of a warp fall in the interior, where no extrapolation is needed.
+ * Callers which visit many positions, like `Affinity::transform()`, can then
+ * classify them with `interior()`, and query the interior ones through `unchecked()`,
+ * in the spirit of the inner and border regions of filters.
+ * 
+ * If the method requires a prefilter (e.g. `BSpline`), then the coefficients are computed at construction,
+ * and shared by the copies of the interpolator, such that many warps can be performed for a single prefilter.
+ * In this case, `TParent` must be a raster or an extrapolator of a raster.
+ * 
+ * Values at many scattered positions are best computed in batch with `gather()`,
+ * which can visit the positions tile by tile for cache locality, and spread them over threads:
+ * 
+ * \code
+ * Sequence<Vector<double, 2>> positions = ... ; // Millions of sub-pixel positions
+ * const auto values = interpolation<Cubic>(extrapolation(raster, 0.F)).gather(positions, -1, 64);
+ * \endcode
  */
 template <typename TParent, typename TMethod>
 class Interpolation {
@@ -44,12 +167,31 @@ public:
    */
   static constexpr Index Dimension = TParent::Dimension;
 
+  /**
+   * @brief Whether `interior()` and `unchecked()` are available.
+   */
+  static constexpr bool HasInterior =
+      is_extrapolator<TParent>() && Internal::IsSeparable<TMethod>::value && not Internal::Prefilters<TMethod>::value;
+
+  /**
+   * @brief The prefiltered coefficients type.
+   */
+  using Coefficients = Raster<std::remove_cv_t<Floating>, Dimension>;
+
   /**
    * @brief Constructor.
+   * 
+   * If the method requires a prefilter, then the coefficients are computed.
    */
   explicit Interpolation(const TParent& parent, TMethod&& method = TMethod()) :
-      m_parent(parent), m_method(std::move(method))
-  {}
+      m_parent(parent), m_method(std::move(method)), m_coefficients()
+  {
+    if constexpr (Internal::Prefilters<TMethod>::value) {
+      using Source = Internal::PrefilterSource<TParent, std::remove_cv_t<Floating>>;
+      m_coefficients = std::make_shared<const Coefficients>(
+          m_method.template prefilter<std::remove_cv_t<Floating>>(Source::raster(m_parent)));
+    }
+  }
 
   /**
    * @brief Get the decorated parent.
@@ -104,11 +246,130 @@ public:
    */
   inline Floating operator()(const Vector<double, Dimension>& position) const
   {
-    return m_method.template at<Floating>(m_parent, position);
+    if constexpr (Internal::Prefilters<TMethod>::value) {
+      using Source = Internal::PrefilterSource<TParent, std::remove_cv_t<Floating>>;
+      const Extrapolation<Coefficients, typename Source::Method> coefficients(
+          *m_coefficients,
+          Source::method(m_parent));
+      return m_method.template at<Floating>(coefficients, position);
+    } else {
+      return m_method.template at<Floating>(m_parent, position);
+    }
+  }
+
+  /**
+   * @brief Compute the values at a sequence of positions.
+   * @param positions The integral or non-integral positions, e.g. a `Sequence<Vector<double, N>>`
+   * @param threads The number of threads, or -1 to use as many threads as available
+   * @param tile The tile length for locality ordering, or 0 to visit the positions in the input order
+   * 
+   * Integral positions (`Position<N>`) are read with `operator[]()`, and other positions with `operator()()`.
+   * If the interpolator has an interior (see `interior()`), then the interior positions are read unchecked.
+   * The values are identical to those of the element-wise calls.
+   */
+  template <typename TPositions>
+  Sequence<std::remove_cv_t<Floating>> gather(const TPositions& positions, Index threads = 1, Index tile = 0) const
+  {
+    Sequence<std::remove_cv_t<Floating>> out(positions.size());
+    gather_to(positions, out, threads, tile);
+    return out;
+  }
+
+  /**
+   * @brief Compute the values at a sequence of positions into a pre-existing sequence of the same size.
+   * @copydetails gather()
+   */
+  template <typename TPositions, typename TOut>
+  TOut& gather_to(const TPositions& positions, TOut& out, Index threads = 1, Index tile = 0) const
+  {
+    SizeError::may_throw(out.size(), positions.size());
+    const auto size = static_cast<Index>(positions.size());
+    const auto order = tile > 0 ? Internal::tile_order(positions, shape(), tile) : std::vector<Index>();
+    const auto count = Internal::resolve_thread_count(threads);
+    if constexpr (HasInterior) {
+      const auto inner = unchecked();
+      const auto bounds = interior();
+      const auto evaluate = [&](const auto& p) {
+        for (Index i = 0; i < static_cast<Index>(p.size()); ++i) {
+          if (p[i] < bounds.first[i] || p[i] >= bounds.second[i]) {
+            return value(p);
+          }
+        }
+        return inner.value(p);
+      };
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+      for (Index j = 0; j < size; ++j) {
+        const auto i = order.empty() ? j : order[j];
+        out[i] = evaluate(positions[i]);
+      }
+    } else {
+#pragma omp parallel for schedule(static) num_threads(static_cast<int>(count))
+      for (Index j = 0; j < size; ++j) {
+        const auto i = order.empty() ? j : order[j];
+        out[i] = value(positions[i]);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Get the prefiltered coefficients, or `nullptr` if the method requires no prefilter.
+   */
+  const Coefficients* coefficients() const
+  {
+    return m_coefficients.get();
+  }
+
+  /**
+   * @brief Get the bounds of the interior, i.e. of the positions whose stencil lies inside the raster domain.
+   * 
+   * Along each axis `i`, the positions `x` such that `front[i] <= x[i] < back[i]` are interior.
+   * The bounds are conservative by one pixel on the back side, which makes them robust to quantization.
+   */
+  std::pair<Vector<double, Dimension>, Vector<double, Dimension>> interior() const
+  {
+    static_assert(Internal::IsSeparable<TMethod>::value, "Interpolation method must be separable");
+    std::array<double, TMethod::Support> weights;
+    const auto offset = m_method.weights(0., weights);
+    const auto& s = shape();
+    Vector<double, Dimension> front(s.size());
+    Vector<double, Dimension> back(s.size());
+    for (Index i = 0; i < static_cast<Index>(s.size()); ++i) {
+      front[i] = -offset;
+      back[i] = s[i] - TMethod::Support - offset;
+    }
+    return {LINX_MOVE(front), LINX_MOVE(back)};
+  }
+
+  /**
+   * @brief Get an interpolator of the decorated raster, without extrapolation nor bound checking.
+   * 
+   * For positions of the interior, the values are the same as those of this interpolator.
+   */
+  auto unchecked() const
+  {
+    using TRaster = std::decay_t<decltype(raster())>;
+    return Interpolation<TRaster, TMethod>(raster(), TMethod(m_method));
   }
 
 private:
 
+  template <typename UParent, typename UMethod>
+  friend class Interpolation;
+
+  /**
+   * @brief Get the value at an integral or non-integral position.
+   */
+  template <typename TPosition>
+  inline std::remove_cv_t<Floating> value(const TPosition& position) const
+  {
+    if constexpr (std::is_same_v<TPosition, Position<Dimension>>) {
+      return (*this)[position];
+    } else {
+      return (*this)(position);
+    }
+  }
+
   /**
    * @brief The raster or extrapolator.
    */
@@ -118,6 +379,11 @@ private:
    * @brief The interpolation method.
    */
   TMethod m_method;
+
+  /**
+   * @brief The prefiltered coefficients, if any, shared by the copies.
+   */
+  std::shared_ptr<const Coefficients> m_coefficients;
 };
 
 /**
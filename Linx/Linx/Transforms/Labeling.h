@@ -0,0 +1,359 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_LABELING_H
+#define _LINXTRANSFORMS_LABELING_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief The connectivity of the labeling.
+ */
+enum class Connectivity {
+  Faces, ///< Neighbors share a face, e.g. 4-connectivity in 2D and 6-connectivity in 3D
+  Full ///< Neighbors share at least a corner, e.g. 8-connectivity in 2D and 26-connectivity in 3D
+};
+
+/**
+ * @ingroup filtering
+ * @brief The statistics of a connected region.
+ */
+template <Index N = 2>
+struct Region {
+  /**
+   * @brief The label, strictly positive.
+   */
+  Index label = 0;
+
+  /**
+   * @brief The number of pixels.
+   */
+  Index area = 0;
+
+  /**
+   * @brief The bounding box.
+   */
+  Box<N> box;
+
+  /**
+   * @brief The sum of the values.
+   */
+  double flux = 0;
+
+  /**
+   * @brief Add a pixel to the region.
+   */
+  void add(const Position<N>& position, double value)
+  {
+    if (area == 0) {
+      box = Box<N>(position, position);
+    } else {
+      box |= Box<N>(position, position);
+    }
+    ++area;
+    flux += value;
+  }
+
+  /**
+   * @brief Merge another part of the region.
+   */
+  Region& operator+=(const Region& rhs)
+  {
+    if (rhs.area == 0) {
+      return *this;
+    }
+    if (area == 0) {
+      box = rhs.box;
+    } else {
+      box |= rhs.box;
+    }
+    area += rhs.area;
+    flux += rhs.flux;
+    return *this;
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief The result of `label_regions()`.
+ */
+template <Index N = 2>
+struct Labeling {
+  /**
+   * @brief The label map, where background pixels are 0 and region pixels are labeled from 1.
+   */
+  Raster<Index, N> labels;
+
+  /**
+   * @brief The region statistics, such that `regions[i].label == i + 1`.
+   */
+  std::vector<Region<N>> regions;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Find the root of an element without modifying the forest.
+ */
+inline Index find_root(const std::vector<Index>& parents, Index i)
+{
+  while (parents[i] != i) {
+    i = parents[i];
+  }
+  return i;
+}
+
+/**
+ * @brief Find the root of an element and compress the path.
+ */
+inline Index find_compress(std::vector<Index>& parents, Index i)
+{
+  const auto root = find_root(parents, i);
+  while (parents[i] != root) {
+    const auto next = parents[i];
+    parents[i] = root;
+    i = next;
+  }
+  return root;
+}
+
+/**
+ * @brief Merge the trees of two elements, such that the root is the smallest index.
+ */
+inline void unite(std::vector<Index>& parents, Index a, Index b)
+{
+  a = find_compress(parents, a);
+  b = find_compress(parents, b);
+  if (a < b) {
+    parents[b] = a;
+  } else if (b < a) {
+    parents[a] = b;
+  }
+}
+
+/**
+ * @brief The neighbor offsets which precede the center in memory order.
+ */
+template <Index N>
+std::vector<Position<N>> preceding_neighbors(Connectivity connectivity)
+{
+  std::vector<Position<N>> out;
+  for (const auto& d : Box<N>::from_center(1)) {
+    Index last = -1; // Last non-null axis
+    Index norm = 0;
+    for (Index i = 0; i < N; ++i) {
+      if (d[i] != 0) {
+        last = i;
+        ++norm;
+      }
+    }
+    if (last >= 0 && d[last] < 0 && (connectivity == Connectivity::Full || norm == 1)) {
+      out.push_back(d);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Get the offset of some displacement in memory order.
+ */
+template <Index N>
+Index linear_offset(const Position<N>& shape, const Position<N>& displacement)
+{
+  Index out = 0;
+  Index stride = 1;
+  for (Index i = 0; i < N; ++i) {
+    out += displacement[i] * stride;
+    stride *= shape[i];
+  }
+  return out;
+}
+
+/**
+ * @brief Label a block of a mask with union-find, ignoring the pixels outside the block.
+ * @param mask The mask
+ * @param block The block
+ * @param neighbors The neighbor displacements
+ * @param offsets The neighbor offsets in memory order
+ * @param parents The parent of each pixel, or -1 for background pixels
+ */
+template <Index N, typename TMask>
+void label_block(
+    const TMask& mask,
+    const Box<N>& block,
+    const std::vector<Position<N>>& neighbors,
+    const std::vector<Index>& offsets,
+    std::vector<Index>& parents)
+{
+  const auto count = static_cast<Index>(neighbors.size());
+  Index i = linear_offset(mask.shape(), block.front());
+  for (const auto& p : block) {
+    if (not mask[i]) {
+      parents[i] = -1;
+      ++i;
+      continue;
+    }
+    parents[i] = i;
+    for (Index k = 0; k < count; ++k) {
+      if (block.contains(p + neighbors[k]) && parents[i + offsets[k]] >= 0) {
+        unite(parents, i, i + offsets[k]);
+      }
+    }
+    ++i;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Label the connected regions of a mask, and compute their statistics.
+ * @param policy The parallel execution policy
+ * @param mask The mask, whose non-null pixels belong to regions
+ * @param in The values whose sums over each region are computed, of the same shape as the mask
+ * @param connectivity The connectivity
+ *
+ * The mask is split into blocks along the last axis, which are labeled concurrently with union-find.
+ * Trees are then merged across the block borders, and the final labels and statistics are computed in a single pass,
+ * again block-wise.
+ *
+ * Labels are numbered in memory order of the first pixel of each region,
+ * such that the result does not depend on the number of threads.
+ */
+template <typename TMask, typename TIn>
+Labeling<TMask::Dimension>
+label_regions(const ParallelPolicy& policy, const TMask& mask, const TIn& in, Connectivity connectivity)
+{
+  static constexpr Index N = TMask::Dimension;
+  SizeError::may_throw(in.size(), mask.size());
+  const auto& shape = mask.shape();
+  const auto size = static_cast<Index>(mask.size());
+  const auto neighbors = Internal::preceding_neighbors<N>(connectivity);
+  Raster<Index, N> labels(shape);
+  std::vector<Index> offsets;
+  for (const auto& d : neighbors) {
+    offsets.push_back(Internal::linear_offset(shape, d));
+  }
+
+  const auto domain = mask.domain();
+  const auto length = shape[N - 1];
+  const auto bounds = Internal::chunk_bounds(policy.thread_count(), length);
+  const auto block_count = static_cast<Index>(bounds.size()) - 1;
+  const auto block = [&](Index b) {
+    auto front = domain.front();
+    auto back = domain.back();
+    front[N - 1] = bounds[b];
+    back[N - 1] = bounds[b + 1] - 1;
+    return Box<N>(front, back);
+  };
+  const auto block_front = [&](Index b) {
+    return size / std::max<Index>(length, 1) * bounds[b];
+  };
+
+  // Local labeling
+  std::vector<Index> parents(size);
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(block_count))
+  for (Index b = 0; b < block_count; ++b) {
+    Internal::label_block(mask, block(b), neighbors, offsets, parents);
+  }
+
+  // Merging across block borders
+  for (Index b = 1; b < block_count; ++b) {
+    auto back = domain.back();
+    back[N - 1] = bounds[b];
+    const Box<N> border(block(b).front(), back);
+    Index i = block_front(b);
+    for (const auto& p : border) {
+      if (parents[i] >= 0) {
+        for (std::size_t k = 0; k < neighbors.size(); ++k) {
+          if (neighbors[k][N - 1] < 0 && domain.contains(p + neighbors[k]) && parents[i + offsets[k]] >= 0) {
+            Internal::unite(parents, i, i + offsets[k]);
+          }
+        }
+      }
+      ++i;
+    }
+  }
+
+  // Root numbering
+  std::vector<Index> firsts(block_count + 1, 1);
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(block_count))
+  for (Index b = 0; b < block_count; ++b) {
+    Index count = 0;
+    for (Index i = block_front(b); i < block_front(b + 1); ++i) {
+      count += parents[i] == i;
+    }
+    firsts[b + 1] = count;
+  }
+  for (Index b = 0; b < block_count; ++b) {
+    firsts[b + 1] += firsts[b];
+  }
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(block_count))
+  for (Index b = 0; b < block_count; ++b) {
+    auto next = firsts[b];
+    for (Index i = block_front(b); i < block_front(b + 1); ++i) {
+      labels[i] = parents[i] == i ? next++ : 0;
+    }
+  }
+
+  // Final labels and statistics
+  Labeling<N> out {LINX_MOVE(labels), std::vector<Region<N>>(firsts.back() - 1)};
+  std::vector<std::unordered_map<Index, Region<N>>> foreign(block_count); // Regions rooted in previous blocks
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(block_count))
+  for (Index b = 0; b < block_count; ++b) {
+    Index i = block_front(b);
+    Index previous = 0;
+    Region<N>* region = nullptr;
+    for (const auto& p : block(b)) {
+      const auto parent = parents[i];
+      if (parent >= 0) {
+        auto& label = out.labels[i];
+        if (parent != i) {
+          label = out.labels[Internal::find_root(parents, parent)];
+        }
+        if (label != previous) {
+          region = label >= firsts[b] ? &out.regions[label - 1] : &foreign[b][label];
+          previous = label;
+        }
+        region->add(p, in[i]);
+      }
+      ++i;
+    }
+  }
+  for (Index i = 0; i < static_cast<Index>(out.regions.size()); ++i) {
+    out.regions[i].label = i + 1;
+  }
+  for (const auto& f : foreign) {
+    for (const auto& r : f) {
+      out.regions[r.first - 1] += r.second;
+    }
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Label the connected regions of a mask sequentially, and compute their statistics.
+ */
+template <typename TMask, typename TIn>
+Labeling<TMask::Dimension>
+label_regions(const TMask& mask, const TIn& in, Connectivity connectivity = Connectivity::Full)
+{
+  return label_regions(ParallelPolicy(1), mask, in, connectivity);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,266 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_PADDEDRASTER_H
+#define _LINXTRANSFORMS_PADDEDRASTER_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm> // copy
+
+namespace Linx {
+
+/**
+ * @ingroup resampling
+ * @brief A raster surrounded by a halo of extrapolated values.
+ * @tparam T The value type
+ * @tparam N The dimension
+ *
+ * The values are stored in a single raster, which spans the domain extended by the halo,
+ * such that out-of-domain neighbors are read with plain pointer arithmetic, without bound checks.
+ * The halo is filled in place with `extrapolate()`, e.g. once per frame when the same filter is applied to a series:
+ *
+ * \code
+ * PaddedRaster<float> padded({2048, 2048}, Position<2>::one() * 2);
+ * const auto filter = mean_filter<float>(Box<2>::from_center(2));
+ * for (const auto& frame : frames) {
+ *   padded.assign(frame).extrapolate<Nearest>();
+ *   process(filter * padded);
+ * }
+ * \endcode
+ *
+ * Positions are given in the coordinates of the logical domain, and can lie in the halo.
+ * Filters accept padded rasters as long as the halo is larger than the filter window,
+ * and return outputs with the logical shape.
+ *
+ * The extrapolation method must provide `index(i, length)`, like `Constant`, `Nearest` and `Periodic`.
+ */
+template <typename T, Index N = 2>
+class PaddedRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The logical shape
+   * @param halo The halo thickness along each axis, on both sides
+   */
+  explicit PaddedRaster(Position<N> shape, Position<N> halo) :
+      m_shape(LINX_MOVE(shape)), m_halo(LINX_MOVE(halo)), m_padded(m_shape + m_halo * 2)
+  {}
+
+  /**
+   * @brief Copy a raster into a padded raster.
+   *
+   * The halo is not filled.
+   */
+  template <typename THolder>
+  explicit PaddedRaster(const Raster<T, N, THolder>& raster, Position<N> halo) :
+      PaddedRaster(raster.shape(), LINX_MOVE(halo))
+  {
+    assign(raster);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the logical shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the logical domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(Position<N>::zero(), m_shape);
+  }
+
+  /**
+   * @brief Get the halo thickness.
+   */
+  const Position<N>& halo() const
+  {
+    return m_halo;
+  }
+
+  /**
+   * @brief Get the domain extended by the halo, in logical coordinates.
+   */
+  Box<N> padded_domain() const
+  {
+    return Box<N>::from_shape(-m_halo, m_padded.shape());
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the underlying raster, including the halo, whose domain starts at the front of the halo.
+   */
+  const Raster<T, N>& padded() const
+  {
+    return m_padded;
+  }
+
+  /**
+   * @copydoc padded()
+   */
+  Raster<T, N>& padded()
+  {
+    return m_padded;
+  }
+
+  /**
+   * @brief Access the element at given position, which can lie in the halo.
+   */
+  const T& operator[](const Position<N>& position) const
+  {
+    return m_padded[position + m_halo];
+  }
+
+  /**
+   * @copydoc operator[]()
+   */
+  T& operator[](const Position<N>& position)
+  {
+    return m_padded[position + m_halo];
+  }
+
+  /**
+   * @brief Get the patch of the padded raster over the logical domain.
+   */
+  auto raster() const
+  {
+    return m_padded(Box<N>::from_shape(m_halo, m_shape));
+  }
+
+  /**
+   * @copydoc raster()
+   */
+  auto raster()
+  {
+    return m_padded(Box<N>::from_shape(m_halo, m_shape));
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Copy a raster into the logical domain.
+   *
+   * The halo is left untouched.
+   */
+  template <typename U, typename UHolder>
+  PaddedRaster& assign(const Raster<U, N, UHolder>& raster)
+  {
+    SizeError::may_throw(raster.size(), shape_size(m_shape));
+    const auto width = m_shape[0];
+    auto lines_shape = m_shape;
+    lines_shape[0] = 1;
+    for (const auto& l : Box<N>::from_shape(Position<N>::zero(), lines_shape)) {
+      const auto* src = &raster[l];
+      std::copy(src, src + width, &(*this)[l]);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Fill the halo in place with some extrapolation method.
+   *
+   * The halo is filled axis by axis, each extrapolated value being copied from the remapped index.
+   */
+  template <typename TMethod = Nearest, typename... TArgs>
+  PaddedRaster& extrapolate(TArgs&&... args)
+  {
+    return extrapolate_with(TMethod(std::forward<TArgs>(args)...));
+  }
+
+  /**
+   * @brief Fill the halo in place with a constant value.
+   */
+  PaddedRaster& extrapolate(T constant)
+  {
+    return extrapolate_with(Constant<T>(constant));
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Fill the halo in place with some extrapolation method instance.
+   */
+  template <typename TMethod>
+  PaddedRaster& extrapolate_with(const TMethod& method)
+  {
+    auto* data = m_padded.data();
+    const auto& shape = m_padded.shape();
+    for (Index i = 0; i < N; ++i) {
+      // Lines along axis i, over the extended domain along previous axes, and the logical domain along next ones
+      auto front = m_halo;
+      auto lines_shape = m_shape;
+      for (Index j = 0; j < i; ++j) {
+        front[j] = 0;
+        lines_shape[j] = shape[j];
+      }
+      front[i] = 0;
+      lines_shape[i] = 1;
+      auto unit = Position<N>::zero();
+      unit[i] = 1;
+      const auto stride = m_padded.index(unit) - m_padded.index(Position<N>::zero());
+      const auto length = m_shape[i];
+      const auto halo = m_halo[i];
+      for (const auto& l : Box<N>::from_shape(front, lines_shape)) {
+        auto* line = data + m_padded.index(l);
+        auto* inner = line + halo * stride;
+        for (Index k = -halo; k < 0; ++k) {
+          fill(method, inner, length, k, stride);
+        }
+        for (Index k = length; k < length + halo; ++k) {
+          fill(method, inner, length, k, stride);
+        }
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Fill one extrapolated value of a line.
+   */
+  template <typename TMethod>
+  static void fill(const TMethod& method, T* inner, Index length, Index k, Index stride)
+  {
+    const auto j = method.index(k, length);
+    if (j >= 0) {
+      inner[k * stride] = inner[j * stride];
+    } else if constexpr (std::is_convertible_v<const TMethod&, T>) {
+      inner[k * stride] = T(method); // Constant
+    }
+  }
+
+  Position<N> m_shape; ///< The logical shape
+  Position<N> m_halo; ///< The halo thickness
+  Raster<T, N> m_padded; ///< The values, including the halo
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,198 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_PEAKS_H
+#define _LINXTRANSFORMS_PEAKS_H
+
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+#include "Linx/Data/Vector.h"
+
+#include <algorithm> // sort
+#include <cmath> // abs
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the non-null displacements of a window, nearest first, and whether they precede the origin.
+ */
+template <Index N, typename TWindow>
+std::vector<std::pair<Position<N>, bool>> peak_neighbors(const TWindow& window)
+{
+  std::vector<std::pair<Position<N>, bool>> out;
+  for (const auto& d : window) {
+    if (d.is_zero()) {
+      continue;
+    }
+    bool precedes = false;
+    for (Index i = N - 1; i >= 0; --i) { // Memory order
+      if (d[i] != 0) {
+        precedes = d[i] < 0;
+        break;
+      }
+    }
+    out.emplace_back(d, precedes);
+  }
+  std::stable_sort(out.begin(), out.end(), [](const auto& lhs, const auto& rhs) {
+    return norm<1>(lhs.first) < norm<1>(rhs.first);
+  });
+  return out;
+}
+
+/**
+ * @brief Check whether a value is a peak with respect to a neighbor value.
+ *
+ * Ties are broken by memory order, such that a plateau yields a single peak.
+ */
+template <typename T>
+inline bool dominates(const T& value, const T& neighbor, bool precedes)
+{
+  return precedes ? value > neighbor : value >= neighbor;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Find the local maxima of a raster above some threshold.
+ * @param policy The parallel execution policy
+ * @param in The input raster
+ * @param window The neighborhood, e.g. `Box<N>::from_center(1)` or `Mask<N>::ball<2>(radius)`
+ * @param threshold The threshold, which peaks must exceed
+ * @return The peak positions, in memory order
+ *
+ * A pixel is a peak if it is strictly greater than the threshold,
+ * and greater than or equal to each of its neighbors inside the raster domain.
+ * Neighbors which precede the pixel in memory order must even be strictly lower,
+ * such that a plateau yields a single peak.
+ *
+ * Neighbors are compared nearest first, and the comparisons stop at the first greater neighbor,
+ * such that most pixels are rejected after a few reads.
+ * No intermediate raster is created, unlike when comparing the input with `maximum_filter(window) * in`.
+ *
+ * The raster is split into blocks along the last axis, which are scanned concurrently.
+ * The output does not depend on the number of threads.
+ */
+template <typename T, Index N, typename THolder, typename TWindow>
+Sequence<Position<N>>
+find_peaks(const ParallelPolicy& policy, const Raster<T, N, THolder>& in, const TWindow& window, T threshold)
+{
+  const auto neighbors = Internal::peak_neighbors<N>(window);
+  const auto count = static_cast<Index>(neighbors.size());
+  std::vector<Index> offsets(count);
+  for (Index k = 0; k < count; ++k) {
+    offsets[k] = in.index(neighbors[k].first);
+  }
+  const auto domain = in.domain();
+  const auto inner = domain - box(window);
+  const auto* data = in.data();
+
+  const auto is_peak = [&](const Position<N>& p, Index i) {
+    const auto& v = data[i];
+    if (not(v > threshold)) {
+      return false;
+    }
+    const auto inside = inner.contains(p);
+    for (Index k = 0; k < count; ++k) {
+      const auto& n = neighbors[k];
+      if (not inside && not domain.contains(p + n.first)) {
+        continue;
+      }
+      if (not Internal::dominates(v, data[i + offsets[k]], n.second)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const auto length = in.shape()[N - 1];
+  const auto bounds = Internal::chunk_bounds(policy.thread_count(), length);
+  const auto block_count = static_cast<Index>(bounds.size()) - 1;
+  std::vector<std::vector<Position<N>>> found(block_count);
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(block_count))
+  for (Index b = 0; b < block_count; ++b) {
+    auto front = domain.front();
+    auto back = domain.back();
+    front[N - 1] = bounds[b];
+    back[N - 1] = bounds[b + 1] - 1;
+    const Box<N> block(front, back);
+    Index i = in.index(front);
+    for (const auto& p : block) {
+      if (is_peak(p, i)) {
+        found[b].push_back(p);
+      }
+      ++i;
+    }
+  }
+
+  Index size = 0;
+  for (const auto& f : found) {
+    size += f.size();
+  }
+  Sequence<Position<N>> out(size);
+  auto it = out.begin();
+  for (const auto& f : found) {
+    it = std::copy(f.begin(), f.end(), it);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Find the local maxima of a raster above some threshold, sequentially.
+ */
+template <typename T, Index N, typename THolder, typename TWindow>
+Sequence<Position<N>> find_peaks(const Raster<T, N, THolder>& in, const TWindow& window, T threshold)
+{
+  return find_peaks(ParallelPolicy(1), in, window, threshold);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Refine peak positions to sub-pixel accuracy.
+ * @param in The input raster
+ * @param peaks The peak positions, e.g. output by `find_peaks()`
+ * @return The refined positions, in the same order
+ *
+ * A parabola is fitted along each axis through the peak and its two neighbors,
+ * and the coordinate is shifted to the vertex of the parabola, within half a pixel.
+ * Coordinates are left unchanged on the raster border and where the fit is degenerate.
+ */
+template <typename T, Index N, typename THolder, typename TRange>
+std::vector<Vector<double, N>> refine_peaks(const Raster<T, N, THolder>& in, const TRange& peaks)
+{
+  std::vector<Vector<double, N>> out;
+  const auto& shape = in.shape();
+  for (const auto& p : peaks) {
+    Vector<double, N> centroid(p);
+    const auto center = static_cast<double>(in[p]);
+    for (Index i = 0; i < N; ++i) {
+      if (p[i] <= 0 || p[i] >= shape[i] - 1) {
+        continue;
+      }
+      auto q = p;
+      --q[i];
+      const auto before = static_cast<double>(in[q]);
+      q[i] += 2;
+      const auto after = static_cast<double>(in[q]);
+      const auto curvature = before - 2 * center + after;
+      if (curvature < 0) {
+        centroid[i] += std::clamp(.5 * (before - after) / curvature, -.5, .5);
+      }
+    }
+    out.push_back(LINX_MOVE(centroid));
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
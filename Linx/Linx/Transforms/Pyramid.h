@@ -0,0 +1,254 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_PYRAMID_H
+#define _LINXTRANSFORMS_PYRAMID_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Grid.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <algorithm> // copy
+#include <limits>
+#include <utility> // index_sequence
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Create the anti-aliasing filter of the pyramids, i.e. the binomial kernel `[1 4 6 4 1] / 16` along each axis.
+ */
+template <typename T, std::size_t... Is>
+auto pyramid_filter(std::index_sequence<Is...>)
+{
+  const std::vector<T> binomial {T(1) / 16, T(4) / 16, T(6) / 16, T(4) / 16, T(1) / 16};
+  return correlation_along<T, static_cast<Index>(Is)...>(binomial);
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief A multi-resolution pyramid, where each level is the previous one smoothed and decimated by 2 along each axis.
+ * @tparam T The value type, which should be floating point
+ * @tparam N The dimension
+ *
+ * Level 0 is a copy of the input, and level `l + 1` has shape `(shape(l) + 1) / 2`.
+ * Each level is computed from the previous one with the separable binomial kernel `[1 4 6 4 1] / 16`,
+ * i.e. a `FilterSeq` of 1D correlations, with nearest-neighbor extrapolation,
+ * followed by the decimation with a `Grid` of step 2.
+ *
+ * All the levels are stored in a single contiguous allocation, and are exposed as `PtrRaster`s.
+ * Levels are built lazily, when first accessed, or all at once with `build()`.
+ * When a region of level 0 is modified, `update()` rebuilds only the affected regions of the built levels.
+ *
+ * \code
+ * Pyramid<float> pyramid(image, 4);
+ * const auto& coarse = pyramid.level(3); // Builds levels 1 to 3, each from the previous one
+ * pyramid.base()[{10, 20}] = 0;
+ * pyramid.update(Box<2>({10, 20}, {10, 20})); // Recomputes a few pixels per level
+ * \endcode
+ */
+template <typename T, Index N = 2>
+class Pyramid {
+public:
+
+  /**
+   * @brief The level type.
+   */
+  using Level = PtrRaster<T, N>;
+
+  /**
+   * @brief Constructor.
+   * @param in The full-resolution raster
+   * @param count The number of levels, including the full-resolution level
+   */
+  template <typename TIn>
+  Pyramid(const TIn& in, Index count) :
+      m_data(), m_levels(), m_built(1), m_filter(Internal::pyramid_filter<T>(std::make_index_sequence<N>()))
+  {
+    OutOfBoundsError::may_throw("Level count: ", count, {1, std::numeric_limits<Index>::max()});
+    std::vector<Position<N>> shapes {in.shape()};
+    std::vector<Index> offsets {0};
+    Index size = shape_size(in.shape());
+    for (Index l = 1; l < count; ++l) {
+      shapes.push_back((shapes.back() + 1) / 2);
+      offsets.push_back(size);
+      size += shape_size(shapes.back());
+    }
+    m_data.resize(size);
+    for (Index l = 0; l < count; ++l) {
+      m_levels.emplace_back(shapes[l], m_data.data() + offsets[l]);
+    }
+    std::copy(in.begin(), in.end(), m_levels[0].begin());
+  }
+
+  /**
+   * @brief Non-copyable, as levels point to the storage.
+   */
+  Pyramid(const Pyramid&) = delete;
+
+  /**
+   * @brief Movable.
+   */
+  Pyramid(Pyramid&&) = default;
+
+  /**
+   * @brief Get the number of levels.
+   */
+  Index size() const
+  {
+    return m_levels.size();
+  }
+
+  /**
+   * @brief Get the number of levels which are built, including level 0.
+   */
+  Index built() const
+  {
+    return m_built;
+  }
+
+  /**
+   * @brief Get the total number of values of all the levels.
+   */
+  Index storage_size() const
+  {
+    return m_data.size();
+  }
+
+  /**
+   * @brief Get a level, and build it and the previous levels if needed.
+   */
+  const Level& level(Index l)
+  {
+    OutOfBoundsError::may_throw("Level: ", l, {0, size() - 1});
+    for (; m_built <= l; ++m_built) {
+      rebuild(m_built, m_levels[m_built].domain());
+    }
+    return m_levels[l];
+  }
+
+  /**
+   * @brief Get the full-resolution level, for modification.
+   * @see `update()`
+   */
+  Level& base()
+  {
+    return m_levels[0];
+  }
+
+  /**
+   * @brief Build all the levels.
+   */
+  Pyramid& build()
+  {
+    level(size() - 1);
+    return *this;
+  }
+
+  /**
+   * @brief Rebuild the built levels after some region of level 0 was modified.
+   * @param region The modified region, in level 0 coordinates
+   */
+  Pyramid& update(const Box<N>& region)
+  {
+    const auto radius = (m_kernel_length - 1) / 2;
+    auto changed = region & m_levels[0].domain();
+    if (is_empty(changed)) {
+      return *this;
+    }
+    for (Index l = 1; l < m_built; ++l) {
+      auto front = changed.front();
+      auto back = changed.back();
+      for (Index i = 0; i < N; ++i) {
+        front[i] = std::max<Index>((front[i] - radius + 1) / 2, 0); // Ceil for positive values
+        back[i] = (back[i] + radius) / 2;
+      }
+      changed = Box<N>(front, back) & m_levels[l].domain();
+      if (is_empty(changed)) {
+        break;
+      }
+      rebuild(l, changed);
+    }
+    return *this;
+  }
+
+private:
+
+  /**
+   * @brief The length of the 1D binomial kernel.
+   */
+  static constexpr Index m_kernel_length = 5;
+
+  /**
+   * @brief Compute the number of elements of a shape.
+   */
+  static Index shape_size(const Position<N>& shape)
+  {
+    Index out = 1;
+    for (auto l : shape) {
+      out *= l;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Check whether a box is empty.
+   */
+  static bool is_empty(const Box<N>& region)
+  {
+    for (Index i = 0; i < N; ++i) {
+      if (region.length(i) <= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Recompute some region of a level from the previous level.
+   */
+  void rebuild(Index l, const Box<N>& region)
+  {
+    const Box<N> sources(region.front() * 2, region.back() * 2);
+    const auto margin = extend<N>(box(m_filter.window()));
+    Raster<T, N> in(sources.shape() + margin.shape() - 1);
+    extrapolation<Nearest>(m_levels[l - 1]).copy_to(sources + margin, in);
+    auto filtered = m_filter * in;
+    const auto decimated = filtered(Grid<N>(filtered.domain(), 2));
+    auto patch = m_levels[l](region);
+    std::copy(decimated.begin(), decimated.end(), patch.begin());
+  }
+
+  /**
+   * @brief The contiguous storage.
+   */
+  std::vector<T> m_data;
+
+  /**
+   * @brief The levels, which point to the storage.
+   */
+  std::vector<Level> m_levels;
+
+  /**
+   * @brief The number of built levels.
+   */
+  Index m_built;
+
+  /**
+   * @brief The anti-aliasing filter.
+   */
+  decltype(Internal::pyramid_filter<T>(std::make_index_sequence<N>())) m_filter;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,486 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_RECONSTRUCTION_H
+#define _LINXTRANSFORMS_RECONSTRUCTION_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/BitRaster.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Labeling.h"
+
+#include <cstdint> // uint64_t
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the position of some index in memory order.
+ */
+template <Index N>
+Position<N> linear_position(const Position<N>& shape, Index index)
+{
+  Position<N> out;
+  for (Index i = 0; i < N; ++i) {
+    out[i] = index % shape[i];
+    index /= shape[i];
+  }
+  return out;
+}
+
+/**
+ * @brief Check whether a position lies on the border of some shape.
+ *
+ * Neighbors of inner positions are known to be in bounds, such that their bound checks are skipped.
+ */
+template <Index N>
+bool on_border(const Position<N>& shape, const Position<N>& p)
+{
+  for (Index i = 0; i < N; ++i) {
+    if (p[i] == 0 || p[i] == shape[i] - 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Reconstruct a raster by dilation or erosion, with Vincent's hybrid algorithm.
+ * @tparam Dilation The reconstruction mode: by dilation if `true`, by erosion otherwise
+ * @param marker The marker
+ * @param mask The mask
+ * @param connectivity The connectivity
+ *
+ * A forward raster scan propagates the marker from the preceding neighbors,
+ * and a backward raster scan from the following neighbors.
+ * The pixels which can still propagate after the two scans are queued,
+ * and the FIFO is processed until stability, such that each pixel is visited a few times only.
+ */
+template <bool Dilation, typename T, Index N, typename THolder, typename UHolder>
+Raster<std::decay_t<T>, N> reconstruct(
+    const Raster<T, N, THolder>& marker,
+    const Raster<T, N, UHolder>& mask,
+    Connectivity connectivity)
+{
+  using V = std::decay_t<T>;
+  const auto& shape = mask.shape();
+  for (Index i = 0; i < N; ++i) {
+    SizeError::may_throw(marker.shape()[i], shape[i]);
+  }
+  const auto beyond = [](V lhs, V rhs) { // Whether lhs is more propagated than rhs
+    if constexpr (Dilation) {
+      return lhs > rhs;
+    } else {
+      return lhs < rhs;
+    }
+  };
+
+  Raster<V, N> out(shape);
+  const auto size = static_cast<Index>(out.size());
+  const auto* m = mask.data();
+  auto* o = out.data();
+  auto it = marker.begin();
+  for (Index i = 0; i < size; ++i, ++it) {
+    o[i] = beyond(*it, m[i]) ? m[i] : *it;
+  }
+  if (size == 0) {
+    return out;
+  }
+
+  const auto backward = preceding_neighbors<N>(connectivity);
+  std::vector<Position<N>> forward;
+  std::vector<Index> backward_offsets;
+  std::vector<Index> forward_offsets;
+  for (const auto& d : backward) {
+    forward.push_back(-d);
+    backward_offsets.push_back(linear_offset(shape, d));
+    forward_offsets.push_back(-backward_offsets.back());
+  }
+  const auto count = static_cast<Index>(backward.size());
+  const auto domain = out.domain();
+
+  // Propagate the neighbor values to pixel i, clipped by the mask
+  const auto pull =
+      [&](Index i, const Position<N>& p, const std::vector<Position<N>>& neighbors, const std::vector<Index>& offsets) {
+        const auto border = on_border(shape, p);
+        auto v = o[i];
+        for (Index k = 0; k < count; ++k) {
+          if (border && not domain.contains(p + neighbors[k])) {
+            continue;
+          }
+          const auto n = o[i + offsets[k]];
+          if (beyond(n, v)) {
+            v = n;
+          }
+        }
+        o[i] = beyond(v, m[i]) ? m[i] : v;
+      };
+
+  // Forward scan
+  Index i = 0;
+  for (const auto& p : domain) {
+    pull(i, p, backward, backward_offsets);
+    ++i;
+  }
+
+  // Backward scan, which queues the pixels which could still propagate forward
+  std::queue<Index> fifo;
+  for (i = size - 1; i >= 0; --i) {
+    const auto p = linear_position(shape, i);
+    pull(i, p, forward, forward_offsets);
+    const auto border = on_border(shape, p);
+    for (Index k = 0; k < count; ++k) {
+      if (border && not domain.contains(p + forward[k])) {
+        continue;
+      }
+      const auto j = i + forward_offsets[k];
+      if (beyond(o[i], o[j]) && beyond(m[j], o[j])) {
+        fifo.push(i);
+        break;
+      }
+    }
+  }
+
+  // Propagation
+  while (not fifo.empty()) {
+    i = fifo.front();
+    fifo.pop();
+    const auto p = linear_position(shape, i);
+    const auto border = on_border(shape, p);
+    for (Index k = 0; k < 2 * count; ++k) {
+      const auto& d = k < count ? backward[k] : forward[k - count];
+      if (border && not domain.contains(p + d)) {
+        continue;
+      }
+      const auto j = i + (k < count ? backward_offsets[k] : forward_offsets[k - count]);
+      if (beyond(o[i], o[j]) && o[j] != m[j]) {
+        o[j] = beyond(o[i], m[j]) ? m[j] : o[i];
+        fifo.push(j);
+      }
+    }
+  }
+
+  return out;
+}
+
+/**
+ * @brief Reverse the bits of a word.
+ */
+inline std::uint64_t reverse_bits(std::uint64_t x)
+{
+  x = ((x >> 1) & 0x5555555555555555) | ((x & 0x5555555555555555) << 1);
+  x = ((x >> 2) & 0x3333333333333333) | ((x & 0x3333333333333333) << 2);
+  x = ((x >> 4) & 0x0F0F0F0F0F0F0F0F) | ((x & 0x0F0F0F0F0F0F0F0F) << 4);
+  x = ((x >> 8) & 0x00FF00FF00FF00FF) | ((x & 0x00FF00FF00FF00FF) << 8);
+  x = ((x >> 16) & 0x0000FFFF0000FFFF) | ((x & 0x0000FFFF0000FFFF) << 16);
+  return (x >> 32) | (x << 32);
+}
+
+/**
+ * @brief Extend some seeds towards the most significant bits, within the runs of a mask.
+ * @param mask The mask
+ * @param seeds The seeds, which must be set in the mask
+ *
+ * Adding a seed to its run of ones carries up to the end of the run, and the flipped bits are the filled ones.
+ */
+inline std::uint64_t fill_up(std::uint64_t mask, std::uint64_t seeds)
+{
+  return (((mask + seeds) ^ mask) & mask) | seeds;
+}
+
+/**
+ * @brief Fill the runs of a mask row which contain some set bit, in place.
+ * @param row The row words, which must be included in the mask
+ * @param mask The mask row words
+ * @param words The number of words
+ *
+ * The upward pass fills each run from its lowest set bit to its end,
+ * and the downward pass, on reversed words, from its end to its beginning.
+ * Runs which cross words are followed with a carry bit.
+ */
+inline void fill_runs(std::uint64_t* row, const std::uint64_t* mask, Index words)
+{
+  std::uint64_t carry = 0;
+  for (Index w = 0; w < words; ++w) {
+    row[w] = fill_up(mask[w], (row[w] | carry) & mask[w]);
+    carry = row[w] >> 63;
+  }
+  carry = 0;
+  for (Index w = words - 1; w >= 0; --w) {
+    const auto m = reverse_bits(mask[w]);
+    row[w] = reverse_bits(fill_up(m, (reverse_bits(row[w]) | carry) & m));
+    carry = row[w] & 1;
+  }
+}
+
+/**
+ * @brief Dilate a row by one bit on each side.
+ */
+inline void spread_bits(const std::uint64_t* in, std::uint64_t* out, Index words)
+{
+  for (Index w = 0; w < words; ++w) {
+    auto word = in[w] | (in[w] << 1) | (in[w] >> 1);
+    if (w > 0) {
+      word |= in[w - 1] >> 63;
+    }
+    if (w < words - 1) {
+      word |= in[w + 1] << 63;
+    }
+    out[w] = word;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a marker by dilation under a mask.
+ * @param marker The marker, which is clipped by the mask
+ * @param mask The mask
+ * @param connectivity The connectivity
+ *
+ * The output is the limit of the iterated elementary dilations of the marker, clipped by the mask, i.e.
+ * the mask is flattened from above down to the marker, except where the marker reaches it.
+ * With binary rasters, the output is made of the connected components of the mask which intersect the marker.
+ *
+ * Vincent's hybrid algorithm is used:
+ * a forward and a backward raster scan perform most of the propagation,
+ * and the remaining propagation is driven by a FIFO queue of the pixels which can still change their neighbors.
+ * The cost is nearly linear in the number of pixels, whatever the size and shape of the structures,
+ * instead of one full pass per iteration of dilation.
+ */
+template <typename T, Index N, typename THolder, typename UHolder>
+Raster<std::decay_t<T>, N> reconstruct_by_dilation(
+    const Raster<T, N, THolder>& marker,
+    const Raster<T, N, UHolder>& mask,
+    Connectivity connectivity = Connectivity::Full)
+{
+  return Internal::reconstruct<true>(marker, mask, connectivity);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a marker by erosion over a mask.
+ *
+ * This is the dual of `reconstruct_by_dilation()`:
+ * the marker is clipped from below by the mask, and basins of the mask are filled up to the marker.
+ */
+template <typename T, Index N, typename THolder, typename UHolder>
+Raster<std::decay_t<T>, N> reconstruct_by_erosion(
+    const Raster<T, N, THolder>& marker,
+    const Raster<T, N, UHolder>& mask,
+    Connectivity connectivity = Connectivity::Full)
+{
+  return Internal::reconstruct<false>(marker, mask, connectivity);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a bit-packed marker by dilation under a bit-packed mask.
+ *
+ * This is the bit-packed counterpart of `reconstruct_by_dilation()` for `Raster`s.
+ * The algorithm is the same, with rows instead of pixels:
+ * the propagation along axis 0 fills whole runs of the mask at once with word-wise carry arithmetic,
+ * and the FIFO queue contains the rows which can still change their neighbor rows.
+ */
+template <Index N>
+BitRaster<N> reconstruct_by_dilation(
+    const BitRaster<N>& marker,
+    const BitRaster<N>& mask,
+    Connectivity connectivity = Connectivity::Full)
+{
+  using Word = typename BitRaster<N>::Word;
+  const auto& shape = mask.shape();
+  for (Index i = 0; i < N; ++i) {
+    SizeError::may_throw(marker.shape()[i], shape[i]);
+  }
+  BitRaster<N> out = marker;
+  out &= mask;
+  const auto words = out.row_words();
+  const auto rows = out.rows();
+  if (words == 0 || rows == 0) {
+    return out;
+  }
+
+  // Neighbor rows, i.e. neighbors along the axes other than 0
+  auto row_shape = shape;
+  row_shape[0] = 1;
+  std::vector<Position<N>> backward;
+  std::vector<Position<N>> forward;
+  for (const auto& d : Internal::preceding_neighbors<N>(connectivity)) {
+    if (d[0] == 0) {
+      backward.push_back(d);
+      forward.push_back(-d);
+    }
+  }
+  const auto count = static_cast<Index>(backward.size());
+  std::vector<Index> offsets(count);
+  for (Index k = 0; k < count; ++k) {
+    offsets[k] = Internal::linear_offset(row_shape, forward[k]);
+  }
+  const Box<N> domain(Position<N>::zero(), row_shape - 1);
+
+  // With full connectivity, the rows propagate diagonally, too
+  std::vector<Word> spread(words);
+  const auto propagated = [&](Index r) -> const Word* {
+    if (connectivity == Connectivity::Faces) {
+      return out.row(r);
+    }
+    Internal::spread_bits(out.row(r), spread.data(), words);
+    return spread.data();
+  };
+
+  // Add some propagated bits to row r, and fill the touched runs
+  const auto absorb = [&](Index r, const Word* bits) {
+    auto* o = out.row(r);
+    const auto* m = mask.row(r);
+    bool changed = false;
+    for (Index w = 0; w < words; ++w) {
+      const auto added = bits[w] & m[w] & ~o[w];
+      if (added) {
+        o[w] |= added;
+        changed = true;
+      }
+    }
+    if (changed) {
+      Internal::fill_runs(o, m, words);
+    }
+    return changed;
+  };
+
+  // Forward scan
+  for (Index r = 0; r < rows; ++r) {
+    Internal::fill_runs(out.row(r), mask.row(r), words);
+    const auto p = Internal::linear_position(row_shape, r);
+    for (Index k = 0; k < count; ++k) {
+      if (domain.contains(p + backward[k])) {
+        absorb(r, propagated(r - offsets[k]));
+      }
+    }
+  }
+
+  // Backward scan, which queues the rows which could still propagate forward
+  std::queue<Index> fifo;
+  for (Index r = rows - 1; r >= 0; --r) {
+    const auto p = Internal::linear_position(row_shape, r);
+    for (Index k = 0; k < count; ++k) {
+      if (domain.contains(p + forward[k])) {
+        absorb(r, propagated(r + offsets[k]));
+      }
+    }
+    const auto* bits = propagated(r);
+    for (Index k = 0; k < count; ++k) {
+      if (not domain.contains(p + forward[k])) {
+        continue;
+      }
+      const auto* o = out.row(r + offsets[k]);
+      const auto* m = mask.row(r + offsets[k]);
+      bool pending = false;
+      for (Index w = 0; w < words && not pending; ++w) {
+        pending = bits[w] & m[w] & ~o[w];
+      }
+      if (pending) {
+        fifo.push(r);
+        break;
+      }
+    }
+  }
+
+  // Propagation
+  while (not fifo.empty()) {
+    const auto r = fifo.front();
+    fifo.pop();
+    const auto p = Internal::linear_position(row_shape, r);
+    const auto* bits = propagated(r);
+    for (Index k = 0; k < 2 * count; ++k) {
+      const auto& d = k < count ? backward[k] : forward[k - count];
+      const auto q = k < count ? r - offsets[k] : r + offsets[k - count];
+      if (domain.contains(p + d) && absorb(q, bits)) {
+        fifo.push(q);
+      }
+    }
+  }
+
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Fill the holes of a raster.
+ * @param in The input raster
+ * @param connectivity The connectivity of the holes
+ *
+ * Holes are the regional minima which are not connected to the border,
+ * and they are filled up to their lowest surrounding level.
+ * With binary rasters, they are the background components which do not touch the border.
+ * This is the reconstruction by erosion of the input from a marker which equals the input on the border,
+ * and the maximum value elsewhere.
+ */
+template <typename T, Index N, typename THolder>
+Raster<std::decay_t<T>, N> fill_holes(const Raster<T, N, THolder>& in, Connectivity connectivity = Connectivity::Full)
+{
+  using V = std::decay_t<T>;
+  Raster<V, N> marker(in.shape());
+  const auto& shape = in.shape();
+  V top = std::numeric_limits<V>::lowest();
+  for (const auto& e : in) {
+    if (e > top) {
+      top = e;
+    }
+  }
+  auto it = in.begin();
+  for (const auto& p : marker.domain()) {
+    marker[p] = Internal::on_border(shape, p) ? *it : top;
+    ++it;
+  }
+  return reconstruct_by_erosion(marker, in, connectivity);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Fill the holes of a bit-packed mask.
+ *
+ * The background which is connected to the border is reconstructed by dilation from the border,
+ * and the output is its complement.
+ * The connectivity is that of the background.
+ */
+template <Index N>
+BitRaster<N> fill_holes(const BitRaster<N>& in, Connectivity connectivity = Connectivity::Full)
+{
+  const auto background = ~in;
+  const auto& shape = in.shape();
+  BitRaster<N> marker(shape);
+  for (Index r = 0; r < marker.rows(); ++r) {
+    auto p = Internal::linear_position(shape, r * shape[0]);
+    bool whole = false; // Whether the whole row is on the border
+    for (Index i = 1; i < N; ++i) {
+      whole |= p[i] == 0 || p[i] == shape[i] - 1;
+    }
+    if (whole) {
+      auto* row = marker.row(r);
+      for (Index w = 0; w < marker.row_words(); ++w) {
+        row[w] = ~typename BitRaster<N>::Word(0);
+      }
+      row[marker.row_words() - 1] &= marker.tail_mask();
+    } else if (shape[0] > 0) {
+      marker.set(p);
+      p[0] = shape[0] - 1;
+      marker.set(p);
+    }
+  }
+  marker &= background;
+  return ~reconstruct_by_dilation(marker, background, connectivity);
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,380 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_RECURSIVEGAUSSIAN_H
+#define _LINXTRANSFORMS_RECURSIVEGAUSSIAN_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Transpose.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/PaddedRaster.h"
+#include "Linx/Transforms/mixins/Filter.h"
+
+#include <algorithm> // copy_n, fill, max, min, swap
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The third-order recursive approximation of a Gaussian by Young and van Vliet.
+ *
+ * The forward pass is `w[n] = b * x[n] + a1 * w[n - 1] + a2 * w[n - 2] + a3 * w[n - 3]`,
+ * and the backward pass is the same recursion run from the end of the line.
+ * The coefficients sum to one, such that constant lines are left unchanged.
+ */
+struct YoungVanVliet {
+  /**
+   * @brief Compute the coefficients for a given standard deviation, greater than or equal to 0.5.
+   */
+  static YoungVanVliet from_sigma(double sigma)
+  {
+    const auto q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1. - 0.26891 * sigma);
+    const auto q2 = q * q;
+    const auto q3 = q2 * q;
+    const auto b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const auto b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const auto b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const auto b3 = 0.422205 * q3;
+    return {1. - (b1 + b2 + b3) / b0, b1 / b0, b2 / b0, b3 / b0};
+  }
+
+  /**
+   * @brief Smooth a line in place, with steady-state boundary conditions.
+   */
+  template <typename T>
+  void apply(T* line, Index size) const
+  {
+    if (size == 0) {
+      return;
+    }
+    T w1 = line[0];
+    T w2 = w1;
+    T w3 = w1;
+    for (Index n = 0; n < size; ++n) {
+      const T w = b * line[n] + a1 * w1 + a2 * w2 + a3 * w3;
+      w3 = w2;
+      w2 = w1;
+      w1 = line[n] = w;
+    }
+    w2 = w3 = w1;
+    for (Index n = size - 1; n >= 0; --n) {
+      const T w = b * line[n] + a1 * w1 + a2 * w2 + a3 * w3;
+      w3 = w2;
+      w2 = w1;
+      w1 = line[n] = w;
+    }
+  }
+
+  /**
+   * @brief Smooth interleaved lines in place, with steady-state boundary conditions.
+   * @param lines The lines, where value `n` of line `j` is `lines[n * width + j]`
+   * @param width The number of lines
+   * @param size The length of the lines
+   *
+   * The recursion runs along the lines, while the inner loop runs across them and is vectorized.
+   * Feedback values before the first (resp. after the last) value of a line are taken as equal to it.
+   */
+  template <typename T>
+  void apply(T* lines, Index width, Index size) const
+  {
+    if (width == 1) {
+      apply(lines, size); // Feedback values are kept in registers
+      return;
+    }
+    const auto cb = static_cast<T>(b);
+    const auto c1 = static_cast<T>(a1);
+    const auto c2 = static_cast<T>(a2);
+    const auto c3 = static_cast<T>(a3);
+    const auto row = [&](Index n) {
+      return lines + std::min(std::max(n, Index(0)), size - 1) * width;
+    };
+    for (Index n = 0; n < size; ++n) {
+      auto* w = lines + n * width;
+      const auto* w1 = row(n - 1);
+      const auto* w2 = row(n - 2);
+      const auto* w3 = row(n - 3);
+      for (Index j = 0; j < width; ++j) {
+        w[j] = cb * w[j] + c1 * w1[j] + c2 * w2[j] + c3 * w3[j];
+      }
+    }
+    for (Index n = size - 1; n >= 0; --n) {
+      auto* w = lines + n * width;
+      const auto* w1 = row(n + 1);
+      const auto* w2 = row(n + 2);
+      const auto* w3 = row(n + 3);
+      for (Index j = 0; j < width; ++j) {
+        w[j] = cb * w[j] + c1 * w1[j] + c2 * w2[j] + c3 * w3[j];
+      }
+    }
+  }
+
+  double b; ///< The input coefficient
+  double a1; ///< The first feedback coefficient
+  double a2; ///< The second feedback coefficient
+  double a3; ///< The third feedback coefficient
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Recursive Gaussian filter, and its derivatives.
+ * @tparam T The value type, which should be floating point
+ * @tparam N The dimension
+ *
+ * Each axis is smoothed with the third-order recursive filter of Young and van Vliet,
+ * which runs a forward and a backward pass along each line.
+ * The cost per pixel is therefore independent of the standard deviation,
+ * which makes it much faster than a convolution with a sampled Gaussian for large standard deviations.
+ * The approximation error is a few permil of the peak of the kernel.
+ *
+ * Derivatives of order 1 or 2 are obtained by central differences of the smoothed lines.
+ *
+ * With extrapolation, lines are padded with a margin of `ceil(4 * sigma)` values
+ * which follow the extrapolation method, which must provide `index(i, length)`, like `Constant`, `Nearest` and `Periodic`.
+ * When cropping, lines are extended with their end values,
+ * and the output is cropped by the same margin, which is the filter window.
+ *
+ * @see `recursive_gaussian()`
+ * @see `recursive_gaussian_derivative()`
+ */
+template <typename T, Index N = 2>
+class RecursiveGaussian : public FilterMixin<T, Box<N>, RecursiveGaussian<T, N>> {
+  friend class FilterMixin<T, Box<N>, RecursiveGaussian<T, N>>;
+
+public:
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief Constructor.
+   * @param sigma The standard deviation along each axis, or 0 for no smoothing
+   * @param order The derivation order along each axis, up to 2
+   */
+  explicit RecursiveGaussian(Vector<double, N> sigma, Position<N> order = Position<N>::zero()) :
+      m_sigma(LINX_MOVE(sigma)), m_order(LINX_MOVE(order)), m_radius(Position<N>::zero()), m_passes()
+  {
+    for (Index i = 0; i < N; ++i) {
+      if (m_sigma[i] != 0) {
+        OutOfBoundsError::may_throw("Sigma: ", m_sigma[i], {0.5, std::numeric_limits<double>::max()});
+        m_radius[i] = static_cast<Index>(std::ceil(4. * m_sigma[i]));
+      }
+      OutOfBoundsError::may_throw("Derivation order: ", m_order[i], {Index(0), Index(2)});
+      m_radius[i] = std::max(m_radius[i], m_order[i] > 0 ? Index(1) : Index(0));
+      m_passes.push_back(Internal::YoungVanVliet::from_sigma(std::max(m_sigma[i], 0.5)));
+    }
+  }
+
+  /**
+   * @brief Get the standard deviations.
+   */
+  const Vector<double, N>& sigma() const
+  {
+    return m_sigma;
+  }
+
+  /**
+   * @brief Get the derivation orders.
+   */
+  const Position<N>& order() const
+  {
+    return m_order;
+  }
+
+protected:
+
+  /**
+   * @brief Get the window, i.e. the margins of the lines.
+   */
+  Box<N> window_impl() const
+  {
+    return {-m_radius, m_radius};
+  }
+
+  /**
+   * @brief Filter and crop an input raster.
+   */
+  template <typename U, typename UHolder, typename TOut>
+  void transform_impl(const Raster<U, N, UHolder>& in, TOut& out) const
+  {
+    Raster<T, N> work(in.shape());
+    std::copy(in.begin(), in.end(), work.begin());
+    filter_lines(work, Nearest());
+    copy_region(work, m_radius, out);
+  }
+
+  /**
+   * @brief Filter an extrapolated raster.
+   */
+  template <typename TRaster, typename TMethod, typename TOut>
+  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
+  {
+    const auto& raw = dont_extrapolate(in);
+    Raster<T, N> work(raw.shape());
+    std::copy(raw.begin(), raw.end(), work.begin());
+    filter_lines(work, in.method());
+    std::copy(work.begin(), work.end(), out.begin());
+  }
+
+  /**
+   * @brief Filter a padded raster.
+   *
+   * The halo is used as is, and extended with its end values if needed.
+   */
+  template <typename U, typename TOut>
+  void transform_impl(const PaddedRaster<U, N>& in, TOut& out) const
+  {
+    const auto& raw = in.padded();
+    Raster<T, N> work(raw.shape());
+    std::copy(raw.begin(), raw.end(), work.begin());
+    filter_lines(work, Nearest());
+    copy_region(work, in.halo(), out);
+  }
+
+private:
+
+  /**
+   * @brief Filter a raster in place along each axis, with a given extrapolation method.
+   *
+   * Lines are processed by blocks with `transform_profiles()`,
+   * such that the slow axes are filtered with contiguous, vectorized loops across the lines.
+   */
+  template <typename TMethod>
+  void filter_lines(Raster<T, N>& work, const TMethod& method) const
+  {
+    static_assert(Internal::RemapsIndex<TMethod>::value, "Extrapolation method must provide index(i, length)");
+    const auto& shape = work.shape();
+    for (Index i = 0; i < N; ++i) {
+      if (m_sigma[i] == 0 && m_order[i] == 0) {
+        continue;
+      }
+      const auto length = shape[i];
+      const auto margin = m_radius[i];
+      const auto order = m_order[i];
+      const auto& pass = m_passes[i];
+      const bool smooth = m_sigma[i] != 0;
+      transform_profiles(ParallelPolicy(1), work, i, margin, [&](T* block, Index width) {
+        for (Index k = -margin; k < 0; ++k) {
+          extrapolate(method, block, width, length, k);
+        }
+        for (Index k = length; k < length + margin; ++k) {
+          extrapolate(method, block, width, length, k);
+        }
+        if (smooth) {
+          pass.apply(block - margin * width, width, length + 2 * margin);
+        }
+        if (order > 0) {
+          differentiate(block, width, length, order);
+        }
+      });
+    }
+  }
+
+  /**
+   * @brief Fill an extrapolated row of a block of lines.
+   */
+  template <typename TMethod>
+  static void extrapolate(const TMethod& method, T* block, Index width, Index length, Index k)
+  {
+    auto* row = block + k * width;
+    const auto j = method.index(k, length);
+    if constexpr (std::is_convertible_v<const TMethod&, T>) {
+      if (j < 0) {
+        std::fill(row, row + width, T(method)); // Constant
+        return;
+      }
+    }
+    std::copy_n(block + j * width, width, row);
+  }
+
+  /**
+   * @brief Differentiate a block of lines in place, with central differences.
+   *
+   * The rows before and after the lines must be valid.
+   * The previous and current input rows are saved, such that the output can overwrite the input.
+   */
+  static void differentiate(T* block, Index width, Index length, Index order)
+  {
+    std::vector<T> saved(2 * width);
+    auto* previous = saved.data();
+    auto* current = previous + width;
+    std::copy_n(block - width, width, previous);
+    for (Index k = 0; k < length; ++k) {
+      auto* row = block + k * width;
+      const auto* next = row + width;
+      std::copy_n(row, width, current);
+      if (order == 1) {
+        for (Index j = 0; j < width; ++j) {
+          row[j] = (next[j] - previous[j]) / 2;
+        }
+      } else {
+        for (Index j = 0; j < width; ++j) {
+          row[j] = next[j] - 2 * current[j] + previous[j];
+        }
+      }
+      std::swap(previous, current);
+    }
+  }
+
+  /**
+   * @brief Copy the region of the work raster which corresponds to the output.
+   */
+  template <typename TOut>
+  static void copy_region(const Raster<T, N>& work, const Position<N>& front, TOut& out)
+  {
+    const auto patch = work(Box<N>::from_shape(front, out.shape()));
+    std::copy(patch.begin(), patch.end(), out.begin());
+  }
+
+  Vector<double, N> m_sigma; ///< The standard deviations
+  Position<N> m_order; ///< The derivation orders
+  Position<N> m_radius; ///< The margins
+  std::vector<Internal::YoungVanVliet> m_passes; ///< The recursive filters
+};
+
+/**
+ * @ingroup filtering
+ * @brief Make an isotropic recursive Gaussian filter.
+ *
+ * The cost per pixel is independent of `sigma`.
+ *
+ * \code
+ * const auto background = recursive_gaussian<float>(12) * extrapolation<Nearest>(raster);
+ * \endcode
+ */
+template <typename T, Index N = 2>
+auto recursive_gaussian(double sigma)
+{
+  return RecursiveGaussian<T, N>(Vector<double, N>::one() * sigma);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a recursive Gaussian derivative filter along some axis.
+ * @param sigma The standard deviation along all axes
+ * @param order The derivation order along axis `I`, 1 or 2
+ */
+template <typename T, Index I, Index N = 2>
+auto recursive_gaussian_derivative(double sigma, Index order = 1)
+{
+  auto orders = Position<N>::zero();
+  orders[I] = order;
+  return RecursiveGaussian<T, N>(Vector<double, N>::one() * sigma, orders);
+}
+
+} // namespace Linx
+
+#endif
@@ -5,10 +5,17 @@
 #ifndef _LINXTRANSFORMS_SIMPLEFILTER_H
 #define _LINXTRANSFORMS_SIMPLEFILTER_H
 
+#include "Linx/Base/Parallel.h" // resolve_thread_count
+#include "Linx/Base/Trace.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/FilterPlanner.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
+#include <algorithm> // copy_n, min
+#include <memory> // unique_ptr
+#include <vector>
+
 namespace Linx {
 
 /// @cond
@@ -25,6 +32,120 @@ template <typename T>
 struct KernelShiftsWindow<T, std::void_t<typename T::ShiftsWindow>> : std::true_type {};
 /// @endcond
 
+/**
+ * @brief Test whether a kernel provides a region-wise engine for some input and output.
+ * 
+ * Such kernels implement `transform_region(in, front, shape, out)`, which filters a whole region at once,
+ * and `transforms_region()`, which tells whether the engine is applicable (e.g. if the kernel is separable).
+ */
+template <typename T, typename TIn, typename TOut, typename = void>
+struct KernelTransformsRegion : std::false_type {};
+
+/// @cond
+template <typename T, typename TIn, typename TOut>
+struct KernelTransformsRegion<
+    T,
+    TIn,
+    TOut,
+    std::void_t<decltype(std::declval<const T&>().transform_region(
+        std::declval<const TIn&>(),
+        std::declval<const Position<TIn::Dimension>&>(),
+        std::declval<const Position<TIn::Dimension>&>(),
+        std::declval<TOut&>()))>> : std::true_type {};
+/// @endcond
+
+/**
+ * @brief Test whether a kernel provides a decimating engine for some input and output.
+ * 
+ * Such kernels implement `transform_grid(in, front, step, shape, out)`, which filters and decimates a whole region,
+ * and `transforms_grid()`, which tells whether the engine is applicable.
+ */
+template <typename T, typename TIn, typename TOut, typename = void>
+struct KernelTransformsGrid : std::false_type {};
+
+/// @cond
+template <typename T, typename TIn, typename TOut>
+struct KernelTransformsGrid<
+    T,
+    TIn,
+    TOut,
+    std::void_t<decltype(std::declval<const T&>().transform_grid(
+        std::declval<const TIn&>(),
+        std::declval<const Position<TIn::Dimension>&>(),
+        std::declval<const Position<TIn::Dimension>&>(),
+        std::declval<const Position<TIn::Dimension>&>(),
+        std::declval<TOut&>()))>> : std::true_type {};
+/// @endcond
+
+/**
+ * @brief Test whether a kernel has a requested strategy, which may be `KernelStrategy::Measure`.
+ */
+template <typename T, typename = void>
+struct KernelMeasuresStrategy : std::false_type {};
+
+/// @cond
+template <typename T>
+struct KernelMeasuresStrategy<T, std::void_t<decltype(std::declval<const T&>().requested_strategy())>> :
+    std::true_type {};
+/// @endcond
+
+/**
+ * @brief Get a per-thread scratch buffer of at least some size.
+ * 
+ * The buffer only grows, and is reused across calls,
+ * such that repeated border tiles are extrapolated without allocation once the largest one has been met.
+ * The buffer must not be held while another user of the same value type may run on the same thread.
+ */
+template <typename T>
+T* scratch_buffer(std::size_t size)
+{
+  thread_local std::unique_ptr<T[]> buffer; // Not std::vector, which is specialized for bool
+  thread_local std::size_t capacity = 0;
+  if (capacity < size) {
+    buffer = std::make_unique<T[]>(size);
+    capacity = size;
+  }
+  return buffer.get();
+}
+
+/**
+ * @brief Split a box into bands along its last axis.
+ * 
+ * Bands have the same thickness up to one pixel.
+ * There are at most as many bands as pixels along the last axis.
+ */
+template <Index N>
+std::vector<Box<N>> split_bands(const Box<N>& box, Index count)
+{
+  const auto last = box.dimension() - 1;
+  const auto front = box.front()[last];
+  const auto length = box.length(last);
+  count = std::clamp(count, Index(1), std::max(length, Index(1)));
+  std::vector<Box<N>> out;
+  out.reserve(count);
+  for (Index i = 0; i < count; ++i) {
+    auto f = box.front();
+    auto b = box.back();
+    f[last] = front + length * i / count;
+    b[last] = front + length * (i + 1) / count - 1;
+    out.emplace_back(LINX_MOVE(f), LINX_MOVE(b));
+  }
+  return out;
+}
+
+/**
+ * @brief Get the sub-patch of an output raster or patch, in the output referential.
+ */
+template <typename TOut, Index N>
+decltype(auto) output_patch(TOut& out, const Box<N>& region)
+{
+  if constexpr (is_patch<TOut>()) {
+    return out(region + box(out.domain()).front());
+  } else {
+    return out(region);
+  }
+}
+
 } // namespace Internal
 /// @endcond
 
@@ -58,6 +179,63 @@ public:
   explicit SimpleFilter(TArgs&&... args) : m_kernel(LINX_FORWARD(args)...)
   {}
 
+  /**
+   * @brief Set the number of threads used by `transform()`.
+   * @param count The number of threads, or -1 to use as many threads as available
+   * 
+   * When multithreaded, the inner region of the input is split into bands along the last axis,
+   * which are processed concurrently with the border regions.
+   * The output is identical to the sequential output, which is computed with `count = 1` (the default).
+   * 
+   * \code
+   * auto out = median_filter<float>(Box<2>::from_center(2)).parallelize(8) * extrapolation(in);
+   * \endcode
+   */
+  SimpleFilter& parallelize(Index count = -1)
+  {
+    m_thread_count = count;
+    return *this;
+  }
+
+  /**
+   * @brief Get the number of threads used by `transform()`.
+   * @see `parallelize()`
+   */
+  Index thread_count() const
+  {
+    return Internal::resolve_thread_count(m_thread_count);
+  }
+
+  /**
+   * @brief Filter a batch of independent inputs into preallocated outputs.
+   * @param in The inputs, e.g. rasters or extrapolators of `PtrRaster`s
+   * @param out The outputs, with one raster or patch per input
+   * 
+   * Inputs are distributed over the threads, and each of them is filtered sequentially.
+   * For stacks of same-shape stamps, prefer filtering a raster of dimension `Dimension + 1`,
+   * or an extrapolator of it, which is processed slice by slice without any view creation.
+   */
+  template <typename TIn, typename TOut>
+  void transform_batch(const std::vector<TIn>& in, std::vector<TOut>& out) const
+  {
+    LINX_TRACE_SCOPE("SimpleFilter::transform_batch", "Transforms");
+    SizeError::may_throw(out.size(), in.size());
+    const auto count = static_cast<Index>(in.size());
+    const auto threads = std::min(thread_count(), count);
+    if (threads <= 1) {
+      for (Index i = 0; i < count; ++i) {
+        this->transform(in[i], out[i]);
+      }
+      return;
+    }
+    auto sequential = *this;
+    sequential.parallelize(1);
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(threads))
+    for (Index i = 0; i < count; ++i) {
+      sequential.transform(in[i], out[i]);
+    }
+  }
+
   /**
    * @brief Get the kernel.
    */
@@ -102,8 +280,29 @@ protected:
   template <typename T, Index N, typename THolder, typename TOut>
   void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
   {
+    LINX_TRACE_SCOPE("SimpleFilter::transform", "Transforms");
+    if (transform_measured(in, out) || transform_slices(in, in, out)) {
+      return;
+    }
     const auto region = in.domain() - window_box<N>();
-    transform_monolith(in(region), out);
+    if (transform_region(in, Position<N>::zero(), region.shape(), out)) {
+      return;
+    }
+    if (thread_count() == 1) {
+      transform_monolith(in(region), out);
+      return;
+    }
+    std::vector<std::pair<Box<N>, bool>> tasks;
+    for (auto& b : Internal::split_bands(region, bands_per_thread * thread_count())) {
+      tasks.emplace_back(LINX_MOVE(b), false);
+    }
+    run_tasks(tasks, [&](const auto& task) {
+      const auto insub = in(task.first);
+      if (insub.size() > 0) {
+        auto outsub = Internal::output_patch(out, task.first - region.front());
+        transform_monolith(insub, outsub);
+      }
+    });
   }
 
   /**
@@ -114,23 +313,75 @@ protected:
   template <typename TRaster, typename TMethod, typename TOut>
   void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
   {
+    LINX_TRACE_SCOPE("SimpleFilter::transform", "Transforms");
+    if (transform_measured(in, out)) {
+      return;
+    }
     const auto& raw = dont_extrapolate(in);
+    if constexpr (Internal::RemapsIndex<TMethod>::value) {
+      if (transform_slices(in, raw, out)) {
+        return;
+      }
+    }
+    if (transform_region(in, window_box<TRaster::Dimension>().front(), raw.shape(), out)) {
+      return;
+    }
     const auto bbox = Internal::BorderedBox<TRaster::Dimension>(raw.domain(), window_box<TRaster::Dimension>());
-    bbox.apply_inner_border(
-        [&](const auto& ib) {
-          const auto insub = raw(ib);
-          if (insub.size() > 0) {
-            auto outsub = out(insub.domain());
-            transform_monolith(insub, outsub);
-          }
-        },
-        [&](const auto& ib) {
-          const auto insub = in(ib);
-          if (insub.size() > 0) {
-            auto outsub = out(insub.domain());
-            transform_monolith_extrapolator(insub, outsub);
-          }
-        });
+    const auto inner_func = [&](const auto& ib) {
+      const auto insub = raw(ib);
+      if (insub.size() > 0) {
+        auto outsub = out(insub.domain());
+        transform_monolith(insub, outsub);
+      }
+    };
+    const auto border_func = [&](const auto& ib) {
+      const auto insub = in(ib);
+      if (insub.size() > 0) {
+        auto outsub = out(insub.domain());
+        transform_monolith_extrapolator(insub, outsub);
+      }
+    };
+    if (thread_count() == 1) {
+      bbox.apply_inner_border(inner_func, border_func);
+    } else {
+      run_tasks(make_tasks(bbox), [&](const auto& task) {
+        task.second ? border_func(task.first) : inner_func(task.first);
+      });
+    }
+  }
+
+  /**
+   * @brief Filter a padded raster.
+   * 
+   * Neighbors are read in the halo without extrapolation, such that the whole domain is processed as an inner region.
+   */
+  template <typename T, Index N, typename TOut>
+  void transform_impl(const PaddedRaster<T, N>& in, TOut& out) const
+  {
+    LINX_TRACE_SCOPE("SimpleFilter::transform", "Transforms");
+    if (transform_measured(in, out)) {
+      return;
+    }
+    const auto& raw = in.padded();
+    if (transform_region(raw, in.halo() + window_box<N>().front(), in.shape(), out)) {
+      return;
+    }
+    const auto region = Box<N>::from_shape(in.halo(), in.shape());
+    if (thread_count() == 1) {
+      transform_monolith(raw(region), out);
+      return;
+    }
+    std::vector<std::pair<Box<N>, bool>> tasks;
+    for (auto& b : Internal::split_bands(region, bands_per_thread * thread_count())) {
+      tasks.emplace_back(LINX_MOVE(b), false);
+    }
+    run_tasks(tasks, [&](const auto& task) {
+      const auto insub = raw(task.first);
+      if (insub.size() > 0) {
+        auto outsub = Internal::output_patch(out, task.first - region.front());
+        transform_monolith(insub, outsub);
+      }
+    });
   }
 
   /**
@@ -148,6 +399,9 @@ protected:
   template <typename T, typename TParent, typename TRegion, typename TOut>
   void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out) const
   {
+    if (transform_grid(in.parent(), in.domain(), out)) {
+      return;
+    }
     const auto& raw = dont_extrapolate(in);
     const auto& front = in.domain().front();
     const auto& step = in.domain().step();
@@ -164,32 +418,274 @@ protected:
     const auto& domain = rasterize(in).domain();
     const auto bbox = Internal::BorderedBox<TParent::Dimension>(domain, window);
     // FIXME accept non-Box window, and of lower dim
+    const auto inner_func = [&](const auto& ib) {
+      const auto insub = raw(ib);
+      if (insub.size() > 0) { // FIXME needed?
+        auto outsub = out(grid_to_box(insub.domain()));
+        transform_monolith(insub, outsub);
+      }
+    };
+    const auto border_func = [&](const auto& ib) {
+      const auto insub = in(ib);
+      if (insub.size() > 0) {
+        auto outsub = out(grid_to_box(insub.domain()));
+        transform_monolith(insub, outsub);
+      }
+    };
+    if (thread_count() == 1) {
+      bbox.apply_inner_border(inner_func, border_func);
+    } else {
+      run_tasks(make_tasks(bbox), [&](const auto& task) {
+        task.second ? border_func(task.first) : inner_func(task.first);
+      });
+    }
+  }
+
+private:
+
+  /**
+   * @brief Split a bordered box into tasks.
+   * 
+   * Each task is a box and a flag which is `true` for border boxes.
+   * The inner box is split into bands, such that there are several tasks per thread.
+   */
+  template <Index N>
+  std::vector<std::pair<Box<N>, bool>> make_tasks(const Internal::BorderedBox<N>& bbox) const
+  {
+    std::vector<std::pair<Box<N>, bool>> out;
     bbox.apply_inner_border(
         [&](const auto& ib) {
-          const auto insub = raw(ib);
-          if (insub.size() > 0) { // FIXME needed?
-            auto outsub = out(grid_to_box(insub.domain()));
-            transform_monolith(insub, outsub);
+          for (auto& b : Internal::split_bands(ib, bands_per_thread * thread_count())) {
+            out.emplace_back(LINX_MOVE(b), false);
           }
         },
         [&](const auto& ib) {
-          const auto insub = in(ib);
-          if (insub.size() > 0) {
-            auto outsub = out(grid_to_box(insub.domain()));
-            transform_monolith(insub, outsub);
-          }
+          out.emplace_back(ib, true);
         });
+    return out;
   }
 
-private:
+  /**
+   * @brief Run independent tasks concurrently.
+   * 
+   * Tasks write disjoint output regions, such that no synchronization is needed.
+   */
+  template <typename TTask, typename TFunc>
+  void run_tasks(const std::vector<TTask>& tasks, TFunc&& func) const
+  {
+    const auto size = static_cast<Index>(tasks.size());
+    const auto threads = static_cast<int>(std::min(thread_count(), size));
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (Index i = 0; i < size; ++i) {
+      LINX_TRACE_SCOPE("SimpleFilter::task", "Transforms");
+      func(tasks[i]);
+    }
+  }
+
+  /**
+   * @brief Filter an input with the strategy planned by the `FilterPlanner`, if measurement was requested.
+   * @return `false` if the requested strategy is not `KernelStrategy::Measure`, in which case nothing is done
+   */
+  template <typename TIn, typename TOut>
+  bool transform_measured(const TIn& in, TOut& out) const
+  {
+    if constexpr (Internal::KernelMeasuresStrategy<TKernel>::value) {
+      if (m_kernel.requested_strategy() == KernelStrategy::Measure) {
+        auto planned = *this;
+        planned.kernel().strategy(filter_planner().plan(*this, in));
+        planned.transform(in, out);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Filter an input raster or extrapolator slice by slice, if the window has a lower dimension.
+   * @param in The input raster or extrapolator
+   * @param raw The input raster
+   * @param out The output
+   * @return `false` if the window has the dimension of the input, or if the output is not a raster,
+   * in which case nothing is done
+   * 
+   * A window of dimension `M < N` spans the `M` first axes,
+   * such that filtering is a batch of independent `M`-dimensional filterings,
+   * one per contiguous slice along the trailing axes.
+   * Slices are viewed in place, and filtered without extending the window.
+   * They are distributed over the threads, unless there are too few of them,
+   * in which case each slice is processed in parallel.
+   * 
+   * This is the batch mode of the filter, e.g. for stacks of small stamps.
+   * Unless the kernel has an applicable region-wise engine,
+   * extrapolated slices of up to `padded_slice_max` elements are copied once with their margins
+   * into a per-thread scratch buffer, which is filtered as an inner region,
+   * such that no bordered box, border patch or output is created per slice.
+   */
+  template <typename TIn, typename TRaw, typename TOut>
+  bool transform_slices(const TIn& in, const TRaw& raw, TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    static constexpr Index M = Dimension;
+    if constexpr (M > 0 && M < N && is_raster<TRaw>() && is_raster<TOut>()) {
+      using T = std::decay_t<typename TRaw::Value>;
+      Position<M> in_shape;
+      Position<M> out_shape;
+      std::copy_n(raw.shape().begin(), M, in_shape.begin());
+      std::copy_n(out.shape().begin(), M, out_shape.begin());
+      const auto in_size = shape_size(in_shape);
+      const auto out_size = shape_size(out_shape);
+      const auto count = out_size > 0 ? static_cast<Index>(out.size()) / out_size : Index(0);
+      const auto threads = std::min(thread_count(), count);
+      auto sliced = *this;
+      const auto window = box(kernel().window());
+      const auto padded = Box<M>(Position<M>::zero(), in_shape - 1) + window;
+      const auto filter_slice = [&](Index s) {
+        LINX_TRACE_SCOPE("SimpleFilter::slice", "Transforms");
+        const PtrRaster<T, M> in_slice(in_shape, const_cast<T*>(raw.data()) + s * in_size); // Read only
+        PtrRaster<typename TOut::Value, M> out_slice(out_shape, out.data() + s * out_size);
+        if constexpr (is_extrapolator<TIn>()) {
+          using Method = std::decay_t<decltype(in.method())>;
+          using Extrapolated = Extrapolation<PtrRaster<T, M>, Method>;
+          const Extrapolated extrapolated(in_slice, Method(in.method()));
+          const auto pads = padded.size() <= padded_slice_max &&
+              not transforms_region<Extrapolated, PtrRaster<typename TOut::Value, M>>();
+          if (pads) { // Small slice: extrapolate once and filter as an inner region
+            PtrRaster<T, M> scratch(padded.shape(), Internal::scratch_buffer<T>(padded.size()));
+            extrapolated.copy_to(padded, scratch);
+            sliced.transform(scratch, out_slice);
+          } else {
+            sliced.transform(extrapolated, out_slice);
+          }
+        } else {
+          sliced.transform(in_slice, out_slice);
+        }
+      };
+      if (threads <= 1) {
+        for (Index s = 0; s < count; ++s) {
+          filter_slice(s);
+        }
+        return true;
+      }
+      sliced.parallelize(1);
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(threads))
+      for (Index s = 0; s < count; ++s) {
+        filter_slice(s);
+      }
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Check whether the kernel has a region-wise engine which applies to some input and output types.
+   */
+  template <typename TIn, typename TOut>
+  bool transforms_region() const
+  {
+    if constexpr (Internal::KernelTransformsRegion<TKernel, TIn, TOut>::value) {
+      return m_kernel.transforms_region();
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Filter an input raster or extrapolator with the region-wise engine of the kernel, if any.
+   * @param in The input raster or extrapolator
+   * @param front The input position of the window front for the first output element
+   * @param shape The output shape
+   * @param out The output
+   * @return `false` if the kernel has no suitable engine, in which case nothing is done
+   * 
+   * Output bands along the last axis are processed concurrently if multithreading is enabled.
+   */
+  template <typename TIn, typename TOut>
+  bool transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    using Band = decltype(Internal::output_patch(out, std::declval<const Box<N>&>()));
+    if constexpr (
+        Internal::KernelTransformsRegion<TKernel, TIn, TOut>::value &&
+        Internal::KernelTransformsRegion<TKernel, TIn, Band>::value) {
+      if (not m_kernel.transforms_region()) {
+        return false;
+      }
+      if (thread_count() == 1) {
+        m_kernel.transform_region(in, front, shape, out);
+        return true;
+      }
+      const auto bands = Internal::split_bands(Box<N>::from_shape(Position<N>::zero(), shape), bands_per_thread * thread_count());
+      run_tasks(bands, [&](const auto& band) {
+        auto outsub = Internal::output_patch(out, band);
+        m_kernel.transform_region(in, front + band.front(), band.shape(), outsub);
+      });
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Filter and decimate an input raster or extrapolator with the decimating engine of the kernel, if any.
+   * @param in The input raster or extrapolator
+   * @param grid The input grid
+   * @param out The output
+   * @return `false` if the kernel has no suitable engine, in which case nothing is done
+   * 
+   * Only the decimated outputs are computed, with strided reads of the filtered rows.
+   * Output bands along the last axis are processed concurrently if multithreading is enabled.
+   */
+  template <typename TIn, typename TGrid, typename TOut>
+  bool transform_grid(const TIn& in, const TGrid& grid, TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    using Band = decltype(Internal::output_patch(out, std::declval<const Box<N>&>()));
+    if constexpr (
+        std::is_same_v<TGrid, Grid<N>> && Internal::KernelTransformsGrid<TKernel, TIn, TOut>::value &&
+        Internal::KernelTransformsGrid<TKernel, TIn, Band>::value) {
+      if (not m_kernel.transforms_grid()) {
+        return false;
+      }
+      const auto& step = grid.step();
+      const auto front = grid.front() + window_box<N>().front();
+      const auto shape = grid.shape();
+      if (thread_count() == 1) {
+        m_kernel.transform_grid(in, front, step, shape, out);
+        return true;
+      }
+      const auto domain = Box<N>::from_shape(Position<N>::zero(), shape);
+      const auto bands = Internal::split_bands(domain, bands_per_thread * thread_count());
+      run_tasks(bands, [&](const auto& band) {
+        auto band_front = front;
+        for (Index i = 0; i < N; ++i) {
+          band_front[i] += band.front()[i] * step[i];
+        }
+        auto outsub = Internal::output_patch(out, band);
+        m_kernel.transform_grid(in, band_front, step, band.shape(), outsub);
+      });
+      return true;
+    } else {
+      return false;
+    }
+  }
 
   /**
    * @brief Filter a monolithic patch (no region splitting).
+   * 
+   * The extrapolated neighborhood is copied into a per-thread scratch buffer, such that nothing is allocated.
    */
   template <typename TIn, typename TOut>
   void transform_monolith_extrapolator(const TIn& in, TOut& out) const
   {
-    const auto extrapolated = in.parent().copy(Linx::box(in.domain()) + window_box<TIn::Dimension>());
+    using T = std::decay_t<typename TIn::Value>;
+    const auto region = Linx::box(in.domain()) + window_box<TIn::Dimension>();
+    PtrRaster<T, TIn::Dimension> extrapolated(region.shape(), Internal::scratch_buffer<T>(region.size()));
+    in.parent().copy_to(region, extrapolated);
     const auto box = extrapolated.domain() - window_box<TIn::Dimension>();
     // FIXME region - window().front()?
     transform_monolith(extrapolated(box), out);
@@ -211,24 +707,50 @@ private:
     // FIXME accept any region
     auto patch = in.parent()(extend<TIn::Dimension>(window_impl()));
     auto out_it = out.begin();
-    for (const auto& p : in.domain()) { // FIXME loop over out for a simpler sentinel?
+    const auto apply = [&](const auto& p) {
       if constexpr (Internal::KernelShiftsWindow<TKernel>::value) { // FIXME ugly
-        *out_it = m_kernel(in, patch, p);
+        *out_it = m_kernel(in.parent(), patch, p);
       } else {
         patch >>= p;
         *out_it = m_kernel(patch);
         patch <<= p;
       }
       ++out_it;
+    };
+    if constexpr (std::is_same_v<std::decay_t<decltype(in.domain())>, Box<TIn::Dimension>>) {
+      for_each_row(in.domain(), [&](auto p, Index length) { // Carry over axes once per row
+        for (Index x = 0; x < length; ++x, ++p[0]) {
+          apply(p);
+        }
+      });
+    } else {
+      for (const auto& p : in.domain()) {
+        apply(p);
+      }
     }
   }
 
 private:
 
+  /**
+   * @brief The number of bands of the inner region per thread, for load balancing.
+   */
+  static constexpr Index bands_per_thread = 4;
+
+  /**
+   * @brief The maximum number of elements of an extrapolated slice for it to be padded in a scratch buffer.
+   */
+  static constexpr Index padded_slice_max = 1 << 16;
+
   /**
    * @brief The operation.
    */
   TKernel m_kernel;
+
+  /**
+   * @brief The number of threads, or -1 for as many as available.
+   */
+  Index m_thread_count = 1;
 };
 
 } // namespace Linx
@@ -0,0 +1,242 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STACKING_H
+#define _LINXTRANSFORMS_STACKING_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Base/Selection.h"
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // copy_n, lower_bound, max, min, sort, upper_bound
+#include <cmath> // sqrt
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup pixelwise
+ * @brief Per-pixel median combiner for `combine_frames()`.
+ */
+struct MedianCombiner {
+  /**
+   * @brief Combine the values of a pixel, which are sorted if `sorted` is `true`, and may be reordered otherwise.
+   */
+  template <typename T>
+  double operator()(T* values, Index size, bool sorted) const
+  {
+    if (sorted) {
+      return (double(values[(size - 1) / 2]) + double(values[size / 2])) / 2;
+    }
+    return median_inplace(values, size);
+  }
+};
+
+/**
+ * @ingroup pixelwise
+ * @brief Per-pixel sigma-clipped mean combiner for `combine_frames()`.
+ *
+ * Values farther than `threshold` standard deviations from the median of the kept values are rejected,
+ * until no more values are rejected or `iterations` iterations are reached.
+ * The output is the mean of the kept values.
+ */
+struct SigmaClippedMeanCombiner {
+  /**
+   * @brief Constructor.
+   */
+  explicit SigmaClippedMeanCombiner(double threshold = 3, Index iterations = 5) :
+      m_threshold(threshold), m_iterations(iterations)
+  {}
+
+  /**
+   * @copydoc MedianCombiner::operator()()
+   *
+   * On sorted values, the kept values are a contiguous range, which is shrunk by binary search.
+   */
+  template <typename T>
+  double operator()(T* values, Index size, bool sorted) const
+  {
+    if (not sorted) {
+      std::sort(values, values + size);
+    }
+    const T* begin = values;
+    const T* end = values + size;
+    double mean = 0;
+    for (Index i = 0; i <= m_iterations; ++i) {
+      const auto count = end - begin;
+      double sum = 0;
+      double sum2 = 0;
+      for (auto it = begin; it != end; ++it) {
+        sum += *it;
+        sum2 += double(*it) * *it;
+      }
+      mean = sum / count;
+      if (i == m_iterations || count < 3) {
+        break;
+      }
+      const auto sigma = std::sqrt(std::max(0., sum2 / count - mean * mean));
+      const auto median = (double(begin[(count - 1) / 2]) + double(begin[count / 2])) / 2;
+      const auto lo = std::lower_bound(begin, end, median - m_threshold * sigma, [](const T& e, double v) {
+        return e < v;
+      });
+      const auto hi = std::upper_bound(lo, end, median + m_threshold * sigma, [](double v, const T& e) {
+        return v < e;
+      });
+      if (lo == begin && hi == end) {
+        break;
+      }
+      begin = lo;
+      end = hi;
+    }
+    return mean;
+  }
+
+private:
+
+  double m_threshold;
+  Index m_iterations;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The maximum number of frames for which pixel columns are sorted by a sorting network.
+ */
+constexpr Index StackNetworkMax = 16;
+
+/**
+ * @brief Sort the columns of a frame-major buffer with an odd-even transposition network.
+ * @param data The buffer, where the `k`-th value of pixel `x` is `data[k * width + x]`
+ * @param count The number of values per pixel
+ * @param width The number of pixels
+ *
+ * Each compare-exchange is applied to whole rows of pixels, such that the inner loop is a branchless,
+ * contiguous min/max which the compiler vectorizes.
+ */
+template <typename T>
+void sort_columns(T* data, Index count, Index width)
+{
+  for (Index pass = 0; pass < count; ++pass) {
+    for (Index k = pass % 2; k + 1 < count; k += 2) {
+      auto* lo = data + k * width;
+      auto* hi = lo + width;
+      for (Index x = 0; x < width; ++x) {
+        const auto a = lo[x];
+        const auto b = hi[x];
+        lo[x] = std::min(a, b);
+        hi[x] = std::max(a, b);
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup pixelwise
+ * @brief Combine frames pixel by pixel, band by band, with bounded memory.
+ * @param policy The parallel execution policy
+ * @param count The number of frames
+ * @param read The band reader, called as `read(k, band, data)` to copy the box `band` of frame `k` into `data`,
+ * contiguously, e.g. from memory or from a FITS file
+ * @param combiner The per-pixel combiner, e.g. `MedianCombiner` or `SigmaClippedMeanCombiner`
+ * @param out The output raster, of the frame shape
+ * @param memory The maximum size of the band buffers of all threads, in bytes
+ *
+ * The frames are split into bands along their last axis, such that the bands of all frames fit into `memory`.
+ * Bands are processed concurrently, each thread reusing its own buffer.
+ * For up to 16 frames, pixel columns are sorted by a vectorized sorting network;
+ * otherwise, each column is gathered and combined by selection or sorting, depending on the combiner.
+ *
+ * The reader must be safe to call concurrently (e.g. by locking a FITS file handle).
+ */
+template <typename T, typename TReader, typename TCombiner, typename U, Index N, typename UHolder>
+void combine_frames(
+    const ParallelPolicy& policy,
+    Index count,
+    TReader&& read,
+    const TCombiner& combiner,
+    Raster<U, N, UHolder>& out,
+    Index memory = Index(1) << 28)
+{
+  const auto& shape = out.shape();
+  const auto length = shape[N - 1];
+  const auto slab = length > 0 ? out.size() / length : 0;
+  const auto threads = std::max<Index>(1, std::min(policy.thread_count(), length));
+  const auto per_band = std::max<Index>(1, memory / (threads * std::max<Index>(1, count * slab) * sizeof(T)));
+  const auto band_count = length > 0 ? (length + per_band - 1) / per_band : 0;
+
+#pragma omp parallel num_threads(static_cast<int>(threads))
+  {
+    std::vector<T> buffer;
+    std::vector<T> column(count);
+#pragma omp for schedule(dynamic)
+    for (Index b = 0; b < band_count; ++b) {
+      auto front = out.domain().front();
+      auto back = out.domain().back();
+      front[N - 1] = b * per_band;
+      back[N - 1] = std::min(length, (b + 1) * per_band) - 1;
+      const Box<N> band(front, back);
+      const auto width = band.size();
+      buffer.resize(count * width);
+      for (Index k = 0; k < count; ++k) {
+        read(k, band, buffer.data() + k * width);
+      }
+      const auto sorted = count <= Internal::StackNetworkMax;
+      if (sorted) {
+        Internal::sort_columns(buffer.data(), count, width);
+      }
+      auto* dst = &out[front];
+      for (Index x = 0; x < width; ++x) {
+        for (Index k = 0; k < count; ++k) {
+          column[k] = buffer[k * width + x];
+        }
+        dst[x] = static_cast<U>(combiner(column.data(), count, sorted));
+      }
+    }
+  }
+}
+
+/**
+ * @ingroup pixelwise
+ * @brief Combine in-memory frames pixel by pixel.
+ * @param policy The parallel execution policy
+ * @param frames The frames, of the same shape
+ * @param combiner The per-pixel combiner
+ * @param memory The maximum size of the band buffers of all threads, in bytes
+ *
+ * \code
+ * auto master_flat = combine_frames(par, flats, SigmaClippedMeanCombiner(3));
+ * \endcode
+ *
+ * @see `combine_frames()` with a band reader for frames which do not fit in memory
+ */
+template <typename TRaster, typename TCombiner>
+auto combine_frames(
+    const ParallelPolicy& policy,
+    const std::vector<TRaster>& frames,
+    const TCombiner& combiner,
+    Index memory = Index(1) << 28)
+{
+  using T = std::decay_t<typename TRaster::Value>;
+  static constexpr Index N = TRaster::Dimension;
+  Raster<typename TypeTraits<T>::Floating, N> out(frames.empty() ? Position<N>::zero() : frames[0].shape());
+  for (const auto& f : frames) {
+    SizeError::may_throw(f.size(), out.size());
+  }
+  const auto read = [&](Index k, const Box<N>& band, T* data) {
+    std::copy_n(&frames[k][band.front()], band.size(), data);
+  };
+  combine_frames<T>(policy, static_cast<Index>(frames.size()), read, combiner, out, memory);
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,300 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STARLET_H
+#define _LINXTRANSFORMS_STARLET_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm> // min
+#include <cmath> // abs
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief The thresholding of the wavelet coefficients in `inverse_starlet()`.
+ */
+enum class Thresholding {
+  Hard, ///< Coefficients whose magnitude is lower than or equal to the threshold are zeroed
+  Soft ///< In addition, the magnitude of the other coefficients is decreased by the threshold
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Smooth rows along axis 0 with the B3-spline kernel `[1 4 6 4 1] / 16` with holes.
+ * @param in The input plane
+ * @param out The output plane, which can be `in`
+ * @param detail The plane from which the output is subtracted, or `nullptr`
+ * @param width The row length
+ * @param rows The number of rows
+ * @param step The distance between two kernel taps
+ *
+ * Each row is gathered into an extended row buffer, such that the taps are read without any bound check.
+ */
+template <typename T, typename TExtrapolation>
+void b3_rows(
+    const ParallelPolicy& policy,
+    const T* in,
+    T* out,
+    T* detail,
+    Index width,
+    Index rows,
+    Index step,
+    const TExtrapolation& extrapolation)
+{
+  parallel_chunks(policy.thread_count(), rows, [&](Index front, Index back) {
+    std::vector<T> buffer(width + 4 * step);
+    for (Index r = front; r < back; ++r) {
+      const auto offset = r * width;
+      for (Index x = -2 * step; x < width + 2 * step; ++x) {
+        buffer[x + 2 * step] = in[offset + extrapolation.index(x, width)];
+      }
+      const auto* b = buffer.data();
+      auto* o = out + offset;
+      for (Index x = 0; x < width; ++x) {
+        o[x] = (b[x] + b[x + 4 * step]) * T(1. / 16) + (b[x + step] + b[x + 3 * step]) * T(4. / 16) +
+            b[x + 2 * step] * T(6. / 16);
+      }
+      if (detail) {
+        auto* d = detail + offset;
+        for (Index x = 0; x < width; ++x) {
+          d[x] -= o[x];
+        }
+      }
+    }
+  });
+}
+
+/**
+ * @brief Smooth a plane along some axis other than 0 with the B3-spline kernel with holes.
+ * @param in The input plane
+ * @param out The output plane, which must not overlap `in`
+ * @param shape The plane shape
+ * @param axis The axis
+ * @param step The distance between two kernel taps
+ *
+ * Output rows are linear combinations of five contiguous input rows, such that the inner loop is vectorized.
+ */
+template <typename T, Index N, typename TExtrapolation>
+void b3_axis(
+    const ParallelPolicy& policy,
+    const T* in,
+    T* out,
+    const Position<N>& shape,
+    Index axis,
+    Index step,
+    const TExtrapolation& extrapolation)
+{
+  Index inner = 1;
+  for (Index i = 0; i < axis; ++i) {
+    inner *= shape[i];
+  }
+  const auto length = shape[axis];
+  const auto count = shape_size(shape) / inner; // Number of rows of length `inner`
+  parallel_chunks(policy.thread_count(), count, [&](Index front, Index back) {
+    for (Index r = front; r < back; ++r) {
+      const auto y = r % length;
+      const auto* base = in + (r - y) * inner;
+      const T* taps[5];
+      for (Index k = 0; k < 5; ++k) {
+        taps[k] = base + extrapolation.index(y + (k - 2) * step, length) * inner;
+      }
+      auto* o = out + r * inner;
+      for (Index x = 0; x < inner; ++x) {
+        o[x] = (taps[0][x] + taps[4][x]) * T(1. / 16) + (taps[1][x] + taps[3][x]) * T(4. / 16) + taps[2][x] * T(6. / 16);
+      }
+    }
+  });
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the starlet transform, a.k.a. isotropic undecimated wavelet transform, into a preallocated raster.
+ * @param policy The parallel execution policy
+ * @param in The input raster
+ * @param out The output raster, whose sections along the last axis are the planes, and whose other axes have the input shape
+ * @param extrapolation The boundary conditions, which provide `index(i, length)`, like `Mirror` or `Periodic`
+ *
+ * With `J = out.shape()[N] - 1`, sections `0` to `J - 1` are the wavelet planes `w_j = c_j - c_{j + 1}`,
+ * and section `J` is the smooth residual `c_J`,
+ * where `c_0` is the input, and `c_{j + 1}` is `c_j` smoothed with the separable B3-spline kernel `[1 4 6 4 1] / 16`
+ * whose taps are `2^j` pixels apart (à trous algorithm).
+ * The input is then the sum of all the planes (see `inverse_starlet()`).
+ *
+ * The holes are never stored: taps are read directly at their strided positions.
+ * Each smoothed plane is written into the section of the next plane,
+ * with at most one additional plane as intermediate buffer for `N > 1`,
+ * and the subtraction of the wavelet plane is fused with the last separable pass.
+ *
+ * @see `starlet()` to allocate the output
+ */
+template <typename TExtrapolation = Mirror, typename U, Index N, typename UHolder, typename T, Index M, typename THolder>
+Raster<T, M, THolder>& starlet_to(
+    const ParallelPolicy& policy,
+    const Raster<U, N, UHolder>& in,
+    Raster<T, M, THolder>& out,
+    const TExtrapolation& extrapolation = TExtrapolation())
+{
+  static_assert(M == N + 1, "The output dimension must be the input dimension + 1.");
+  const auto& shape = in.shape();
+  for (Index i = 0; i < N; ++i) {
+    SizeError::may_throw(out.shape()[i], shape[i]);
+  }
+  const auto scales = out.shape()[N] - 1;
+  OutOfBoundsError::may_throw("Starlet scale count", scales, {0, std::numeric_limits<Index>::max()});
+  const auto size = static_cast<Index>(in.size());
+  const auto width = shape[0];
+  const auto rows = width > 0 ? size / width : 0;
+
+  auto* c0 = out.data();
+  auto it = in.begin();
+  for (Index i = 0; i < size; ++i, ++it) {
+    c0[i] = static_cast<T>(*it);
+  }
+
+  std::vector<T> tmp(N > 1 ? size : 0);
+  for (Index j = 0; j < scales; ++j) {
+    const auto step = Index(1) << j;
+    auto* src = out.data() + j * size;
+    auto* dst = src + size;
+
+    // Axes N-1 to 1 alternate between the intermediate and destination planes
+    const T* from = src;
+    T* to = N % 2 == 0 ? tmp.data() : dst;
+    for (Index i = N - 1; i > 0; --i) {
+      Internal::b3_axis(policy, from, to, shape, i, step, extrapolation);
+      from = to;
+      to = to == dst ? tmp.data() : dst;
+    }
+
+    // Axis 0 ends in the destination plane, and the smoothed plane is subtracted on the fly
+    Internal::b3_rows(policy, from, dst, src, width, rows, step, extrapolation);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the starlet transform of a raster.
+ * @param policy The parallel execution policy
+ * @param in The input raster
+ * @param scales The number of wavelet planes
+ * @param extrapolation The boundary conditions
+ * @return The raster of `scales` wavelet planes followed by the smooth residual, stacked along the last axis
+ *
+ * \code
+ * auto planes = starlet<float>(par, image, 5);
+ * const auto denoised = inverse_starlet(par, planes, {3 * sigma, 3 * sigma, 2 * sigma, 0, 0});
+ * \endcode
+ *
+ * @see `starlet_to()`
+ */
+template <typename T, typename TExtrapolation = Mirror, typename U, Index N, typename UHolder>
+Raster<T, N + 1> starlet(
+    const ParallelPolicy& policy,
+    const Raster<U, N, UHolder>& in,
+    Index scales,
+    const TExtrapolation& extrapolation = TExtrapolation())
+{
+  OutOfBoundsError::may_throw("Starlet scale count", scales, {0, std::numeric_limits<Index>::max()});
+  Raster<T, N + 1> out(extend<N + 1>(in.shape(), Position<N + 1>::one() * (scales + 1)));
+  starlet_to(policy, in, out, extrapolation);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the starlet transform of a raster, sequentially.
+ */
+template <typename T, typename TExtrapolation = Mirror, typename U, Index N, typename UHolder>
+Raster<T, N + 1> starlet(const Raster<U, N, UHolder>& in, Index scales)
+{
+  return starlet<T, TExtrapolation>(ParallelPolicy(1), in, scales);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a raster from its starlet planes, with optional thresholding of the wavelet coefficients.
+ * @param policy The parallel execution policy
+ * @param planes The wavelet planes and smooth residual, as output by `starlet()`
+ * @param thresholds The threshold of each wavelet plane, or an empty vector for no thresholding
+ * @param mode The thresholding mode
+ *
+ * The output is the sum of the smooth residual and of the thresholded wavelet planes,
+ * computed plane after plane on chunks of pixels, without intermediate raster.
+ * Missing trailing thresholds are zero, and planes with a null threshold are not thresholded.
+ */
+template <typename T, Index M, typename THolder>
+Raster<std::decay_t<T>, M - 1> inverse_starlet(
+    const ParallelPolicy& policy,
+    const Raster<T, M, THolder>& planes,
+    const std::vector<double>& thresholds = {},
+    Thresholding mode = Thresholding::Hard)
+{
+  using V = std::decay_t<T>;
+  static constexpr Index N = M - 1;
+  const auto scales = planes.shape()[N] - 1;
+  SizeError::may_throw(std::min<Index>(thresholds.size(), scales), thresholds.size());
+  Position<N> shape;
+  for (Index i = 0; i < N; ++i) {
+    shape[i] = planes.shape()[i];
+  }
+  Raster<V, N> out(shape);
+  const auto size = out.size();
+  const auto* data = planes.data();
+  auto* o = out.data();
+  Internal::parallel_chunks(policy.thread_count(), size, [&](Index front, Index back) {
+    const auto* residual = data + scales * size;
+    for (Index i = front; i < back; ++i) {
+      o[i] = residual[i];
+    }
+    for (Index j = 0; j < scales; ++j) {
+      const auto* w = data + j * size;
+      const auto t = j < static_cast<Index>(thresholds.size()) ? static_cast<V>(thresholds[j]) : V(0);
+      if (t == 0) {
+        for (Index i = front; i < back; ++i) {
+          o[i] += w[i];
+        }
+      } else if (mode == Thresholding::Hard) {
+        for (Index i = front; i < back; ++i) {
+          o[i] += std::abs(w[i]) > t ? w[i] : V(0);
+        }
+      } else {
+        for (Index i = front; i < back; ++i) {
+          o[i] += w[i] > t ? w[i] - t : w[i] < -t ? w[i] + t : V(0);
+        }
+      }
+    }
+  });
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a raster from its starlet planes, sequentially.
+ */
+template <typename T, Index M, typename THolder>
+Raster<std::decay_t<T>, M - 1> inverse_starlet(
+    const Raster<T, M, THolder>& planes,
+    const std::vector<double>& thresholds = {},
+    Thresholding mode = Thresholding::Hard)
+{
+  return inverse_starlet(ParallelPolicy(1), planes, thresholds, mode);
+}
+
+} // namespace Linx
+
+#endif
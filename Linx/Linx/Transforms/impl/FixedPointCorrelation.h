@@ -0,0 +1,148 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_FIXEDPOINTCORRELATION_H
+#define _LINXTRANSFORMS_IMPL_FIXEDPOINTCORRELATION_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/RowFetching.h"
+
+#include <algorithm> // clamp
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Integer types used by the fixed-point correlation of values of type `T`.
+ *
+ * Input values are stored as signed integers of at least 16 bits,
+ * biased by half the range for unsigned types of 16 bits or more, such that they fit.
+ * The bias is compensated once per output value, such that the sums are those of the unbiased values.
+ * Products are accumulated in 32-bit integers for inputs up to 16 bits, and in 64-bit integers otherwise.
+ */
+template <typename T>
+struct FixedPointTypes {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "Fixed-point correlation supports integers up to 32 bits.");
+  using Row = std::conditional_t<sizeof(T) <= 2, std::int16_t, std::int32_t>;
+  using Accumulator = std::conditional_t<sizeof(T) <= 2, std::int32_t, std::int64_t>;
+  static constexpr Accumulator bias =
+      std::is_unsigned_v<T> && sizeof(T) >= 2 ? Accumulator(1) << (8 * sizeof(T) - 1) : 0;
+};
+
+/**
+ * @brief Round, shift and saturate an accumulator.
+ */
+template <typename T, typename TAcc>
+inline T fixed_point_round(TAcc acc, Index shift)
+{
+  const auto rounded = shift > 0 ? (acc + (TAcc(1) << (shift - 1))) >> shift : acc;
+  return static_cast<T>(std::clamp<TAcc>(rounded, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+}
+
+/**
+ * @brief Accumulate two scaled and shifted rows into another row.
+ *
+ * This is the hot loop of `fixed_point_correlate()`:
+ * for 16-bit rows, products of 16-bit integers are widened to 32 bits,
+ * which is vectorized with widening multiplications (e.g. `pmullw` and `pmulhw`, or `pmaddwd`) instead of `pmulld`.
+ */
+template <typename TRow, typename TAcc>
+inline void fixed_point_accumulate_row(
+    std::int16_t c0,
+    std::int16_t c1,
+    const TRow* __restrict src,
+    TAcc* __restrict dst,
+    Index size)
+{
+#pragma omp simd
+  for (Index x = 0; x < size; ++x) {
+    dst[x] += TAcc(c0) * TAcc(src[x]) + TAcc(c1) * TAcc(src[x + 1]);
+  }
+}
+
+/**
+ * @brief Correlate an integer input raster or extrapolator with quantized coefficients.
+ * @param in The input raster or extrapolator
+ * @param front The input position associated with the first output element and first coefficient
+ * @param window The window shape
+ * @param coefficients The quantized coefficients, ordered like the window positions
+ * @param shift The number of fractional bits of the coefficients
+ * @param shape The output shape
+ * @param out The output, iterated in order
+ *
+ * Like `shift_accumulate()`, output rows are accumulated tap by tap, here two taps at a time,
+ * in integer accumulators, which are then rounded, shifted back and saturated.
+ */
+template <typename T, typename TIn, typename TOut>
+void fixed_point_correlate(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const std::vector<std::int16_t>& coefficients,
+    Index shift,
+    const Position<TIn::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  using Value = std::decay_t<typename TIn::Value>;
+  using Row = typename FixedPointTypes<Value>::Row;
+  using Acc = typename FixedPointTypes<Value>::Accumulator;
+  constexpr Acc bias = FixedPointTypes<Value>::bias;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  const auto width = shape[0];
+  const auto length = window[0];
+  Acc correction = 0;
+  for (auto c : coefficients) {
+    correction += c * bias;
+  }
+  std::vector<Value> raw(width + length - 1);
+  std::vector<Row> row(width + length); // Padded for the last pair of taps
+  std::vector<Acc> acc(width);
+
+  auto rows_shape = window;
+  rows_shape[0] = 1;
+  const auto rows = Box<N>::from_shape(Position<N>::zero(), rows_shape);
+
+  auto lines_shape = shape;
+  lines_shape[0] = 1;
+  auto out_it = out.begin();
+  for (const auto& l : Box<N>::from_shape(Position<N>::zero(), lines_shape)) {
+    std::fill(acc.begin(), acc.end(), 0);
+    auto c = coefficients.data();
+    for (const auto& r : rows) {
+      fetch_row(in, front + l + r, raw);
+      for (std::size_t x = 0; x < raw.size(); ++x) {
+        row[x] = static_cast<Row>(raw[x] - bias);
+      }
+      Index k = 0;
+      for (; k + 1 < length; k += 2, c += 2) {
+        fixed_point_accumulate_row<Row, Acc>(c[0], c[1], row.data() + k, acc.data(), width);
+      }
+      if (k < length) {
+        fixed_point_accumulate_row<Row, Acc>(c[0], 0, row.data() + k, acc.data(), width);
+        ++c;
+      }
+    }
+    for (const auto& v : acc) {
+      *out_it = fixed_point_round<T>(v + correction, shift);
+      ++out_it;
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
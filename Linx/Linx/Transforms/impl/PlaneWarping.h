@@ -0,0 +1,151 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_PLANEWARPING_H
+#define _LINXTRANSFORMS_IMPL_PLANEWARPING_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/ResamplingMethods.h"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Sum the weighted taps of a stencil whose indices are remapped along each axis, from axis `A` down to axis 0.
+ * @param indices The remapped indices along each axis, or -1 for the extrapolation value
+ * @param value The extrapolation value
+ */
+template <typename T, Index A, Index S, typename U, typename TStrides, typename TIndices, typename TWeights>
+inline T
+remapped_sum(const U* data, const TStrides& strides, const TIndices& indices, const TWeights& weights, T value)
+{
+  T out {};
+  for (Index k = 0; k < S; ++k) {
+    const auto j = indices[A][k];
+    if (j < 0) {
+      out += weights[A][k] * value;
+    } else if constexpr (A == 0) {
+      out += weights[0][k] * T(data[j]);
+    } else {
+      out += weights[A][k] * remapped_sum<T, A - 1, S>(data + j * strides[A], strides, indices, weights, value);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief A group of planes of the same shape, which are interpolated with the same method and share their weights.
+ * @tparam TMethod The separable interpolation method
+ * @tparam TExtrapolation The extrapolation method, which provides `index(i, length)`, like `Nearest` or `Constant`
+ *
+ * For each output position, the weights and the first tap are computed once,
+ * and then applied to every plane:
+ * with an unrolled stencil if the taps lie inside the domain,
+ * or with indices remapped by the extrapolation method otherwise.
+ */
+template <typename TMethod, typename TExtrapolation, typename TIn, typename TOut>
+class PlaneGroup {
+  static_assert(IsSeparable<TMethod>::value, "Multi-plane warping requires a separable interpolation method.");
+  static_assert(not Prefilters<TMethod>::value, "Multi-plane warping does not support prefiltered methods.");
+
+public:
+
+  static constexpr Index Dimension = TIn::Dimension;
+  static constexpr Index Support = TMethod::Support;
+  using Sum = std::remove_cv_t<typename TypeTraits<std::decay_t<typename TIn::Value>>::Floating>;
+
+  /**
+   * @brief Constructor.
+   *
+   * All the planes must have the shape of the first input.
+   */
+  PlaneGroup(const std::vector<TIn>& in, std::vector<TOut>& out, TExtrapolation extrapolation) :
+      m_in(in), m_out(out), m_method(), m_extrapolation(LINX_MOVE(extrapolation)), m_shape(), m_strides(), m_value()
+  {
+    SizeError::may_throw(out.size(), in.size());
+    if (in.empty()) {
+      return;
+    }
+    m_shape = in[0].shape();
+    for (std::size_t k = 0; k < in.size(); ++k) {
+      if (in[k].shape() != m_shape || out[k].shape() != m_shape) {
+        throw Exception("Shapes of the warped planes differ");
+      }
+    }
+    Index stride = 1;
+    for (Index i = 0; i < Dimension; ++i) {
+      m_strides[i] = stride;
+      stride *= m_shape[i];
+    }
+    if constexpr (not std::is_void_v<typename ExtrapolationValue<TExtrapolation>::type>) {
+      m_value = static_cast<Sum>(typename ExtrapolationValue<TExtrapolation>::type(m_extrapolation));
+    }
+  }
+
+  /**
+   * @brief Get the shape of the planes.
+   */
+  const Position<Dimension>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Interpolate every input plane at a given position, and assign the output planes at a given index.
+   */
+  void operator()(const Vector<double, Dimension>& position, Index index) const
+  {
+    AxisWeights<Support, Dimension> weights;
+    Position<Dimension> front;
+    bool inside = true;
+    for (Index i = 0; i < Dimension; ++i) {
+      front[i] = m_method.weights(position[i], weights[i]);
+      inside &= front[i] >= 0 && front[i] + Support <= m_shape[i];
+    }
+    const auto count = m_in.size();
+    if (inside) {
+      Index offset = 0;
+      for (Index i = 0; i < Dimension; ++i) {
+        offset += front[i] * m_strides[i];
+      }
+      for (std::size_t k = 0; k < count; ++k) {
+        m_out[k].data()[index] = stencil_sum<Sum, Dimension - 1, Support>(m_in[k].data() + offset, m_strides, weights);
+      }
+      return;
+    }
+    std::array<std::array<Index, Support>, Dimension> indices;
+    for (Index i = 0; i < Dimension; ++i) {
+      for (Index s = 0; s < Support; ++s) {
+        indices[i][s] = m_extrapolation.index(front[i] + s, m_shape[i]);
+      }
+    }
+    for (std::size_t k = 0; k < count; ++k) {
+      m_out[k].data()[index] =
+          remapped_sum<Sum, Dimension - 1, Support>(m_in[k].data(), m_strides, indices, weights, m_value);
+    }
+  }
+
+private:
+
+  const std::vector<TIn>& m_in; ///< The input planes
+  std::vector<TOut>& m_out; ///< The output planes
+  TMethod m_method; ///< The interpolation method
+  TExtrapolation m_extrapolation; ///< The extrapolation method
+  Position<Dimension> m_shape; ///< The shape of the planes
+  std::array<Index, Dimension> m_strides; ///< The strides of the planes
+  Sum m_value; ///< The extrapolation value, if any
+};
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
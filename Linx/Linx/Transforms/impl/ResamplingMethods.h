@@ -7,8 +7,175 @@
 
 #include "Linx/Data/Raster.h"
 
+#include <algorithm> // clamp
+#include <array>
+#include <cmath> // abs, log, lround, sin, sqrt
+#include <vector>
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether an interpolation method is separable, i.e. provides `Support` and `weights()`.
+ */
+template <typename TMethod, typename = void>
+struct IsSeparable : std::false_type {};
+
+template <typename TMethod>
+struct IsSeparable<TMethod, std::void_t<decltype(TMethod::Support)>> : std::true_type {};
+
+/**
+ * @brief The weights of a separable interpolation, for each axis.
+ */
+template <Index S, Index N>
+using AxisWeights = std::conditional_t<
+    (N >= 0),
+    std::array<std::array<double, S>, static_cast<std::size_t>(N >= 0 ? N : 0)>,
+    std::vector<std::array<double, S>>>;
+
+/**
+ * @brief Sum the weighted taps of a contiguous stencil, from axis `A` down to axis 0.
+ * 
+ * Loops are of fixed length, such that the stencil is unrolled.
+ */
+template <typename T, Index A, Index S, typename U, typename TStrides, typename TWeights>
+inline T stencil_sum(const U* data, const TStrides& strides, const TWeights& weights)
+{
+  T out {};
+  for (Index k = 0; k < S; ++k) {
+    if constexpr (A == 0) {
+      out += weights[0][k] * T(data[k]);
+    } else {
+      out += weights[A][k] * stencil_sum<T, A - 1, S>(data + k * strides[A], strides, weights);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Sum the weighted taps of a stencil, from some axis down to axis 0, reading the raster element-wise.
+ */
+template <typename T, Index S, typename TRaster, typename TPosition, typename TWeights>
+inline T tap_sum(const TRaster& raster, const TPosition& front, const TWeights& weights, Index axis, TPosition& p)
+{
+  T out {};
+  for (Index k = 0; k < S; ++k) {
+    p[axis] = front[axis] + k;
+    out += weights[axis][k] * (axis == 0 ? T(raster[p]) : tap_sum<T, S>(raster, front, weights, axis - 1, p));
+  }
+  return out;
+}
+
+/**
+ * @brief Interpolate with a separable method.
+ * 
+ * The weights are computed once per axis.
+ * If the input is a raster of fixed dimension, the taps are read with a fixed, unrolled stencil;
+ * otherwise, they are read element-wise, e.g. through an extrapolator.
+ */
+template <typename T, typename TMethod, typename TRaster, Index N>
+T separable_at(const TMethod& method, const TRaster& raster, const Vector<double, N>& position)
+{
+  using V = std::remove_cv_t<T>;
+  constexpr Index S = TMethod::Support;
+  const auto dimension = static_cast<Index>(position.size());
+  AxisWeights<S, N> weights;
+  if constexpr (N < 0) {
+    weights.resize(dimension);
+  }
+  Position<N> front(dimension);
+  for (Index i = 0; i < dimension; ++i) {
+    front[i] = method.weights(position[i], weights[i]);
+  }
+  if constexpr (N >= 0 && is_raster<TRaster>()) {
+    std::array<Index, static_cast<std::size_t>(N)> strides;
+    Index stride = 1;
+    for (Index i = 0; i < N; ++i) {
+      strides[i] = stride;
+      stride *= raster.shape()[i];
+    }
+    return stencil_sum<V, N - 1, S>(raster.data() + raster.index(front), strides, weights);
+  } else {
+    auto p = front;
+    return tap_sum<V, S>(raster, front, weights, dimension - 1, p);
+  }
+}
+
+/**
+ * @brief Test whether an interpolation method requires a prefilter, i.e. provides `prefilter()`.
+ */
+template <typename TMethod, typename = void>
+struct Prefilters : std::false_type {};
+
+template <typename TMethod>
+struct Prefilters<
+    TMethod,
+    std::void_t<decltype(std::declval<const TMethod&>().template prefilter<double>(
+        std::declval<const Raster<double, 1>&>()))>> : std::true_type {};
+
+/**
+ * @brief Apply the recursive B-spline prefilter to a line in place, with mirror boundary conditions.
+ * @param poles The poles of the filter, in ]-1, 0[
+ * 
+ * This is the algorithm of Unser, Aldroubi and Eden, as implemented by Thevenaz, Blu and Unser:
+ * a causal and an anti-causal first-order recursions are run for each pole.
+ */
+template <typename T, std::size_t P>
+void bspline_prefilter(T* line, Index size, Index stride, const std::array<double, P>& poles)
+{
+  if (size < 2) {
+    return;
+  }
+  double gain = 1;
+  for (auto z : poles) {
+    gain *= (1 - z) * (1 - 1 / z);
+  }
+  for (Index k = 0; k < size; ++k) {
+    line[k * stride] *= gain;
+  }
+  const auto at = [&](Index k) -> T& {
+    return line[k * stride];
+  };
+  for (auto z : poles) {
+    // Initial causal coefficient
+    const auto horizon = static_cast<Index>(std::ceil(std::log(1.e-12) / std::log(std::abs(z))));
+    T sum = at(0);
+    if (horizon < size) {
+      auto zn = z;
+      for (Index k = 1; k < horizon; ++k) {
+        sum += zn * at(k);
+        zn *= z;
+      }
+    } else {
+      auto zn = z;
+      const auto iz = 1 / z;
+      auto z2n = std::pow(z, size - 1);
+      sum += z2n * at(size - 1);
+      z2n *= z2n * iz;
+      for (Index k = 1; k < size - 1; ++k) {
+        sum += (zn + z2n) * at(k);
+        zn *= z;
+        z2n *= iz;
+      }
+      sum /= (1 - zn * zn);
+    }
+    at(0) = sum;
+    for (Index k = 1; k < size; ++k) {
+      at(k) += z * at(k - 1);
+    }
+    // Initial anti-causal coefficient
+    at(size - 1) = (z / (z * z - 1)) * (z * at(size - 2) + at(size - 1));
+    for (Index k = size - 2; k >= 0; --k) {
+      at(k) = z * (at(k + 1) - at(k));
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup resampling
  * @brief Constant, a.k.a. Dirichlet boundary conditions.
@@ -31,6 +198,14 @@ public:
     return raster.contains(position) ? raster[position] : m_value;
   }
 
+  /**
+   * @brief Get the index which is read along an axis of given length, or -1 if out of bounds.
+   */
+  inline Index index(Index i, Index length) const
+  {
+    return i >= 0 && i < length ? i : -1;
+  }
+
   /**
    * @brief Get the extrapolation value.
    */
@@ -61,6 +236,28 @@ struct Nearest {
     return raster[clamp(LINX_MOVE(position), raster.shape())];
   }
 
+  /**
+   * @brief Get the index which is read along an axis of given length.
+   */
+  inline Index index(Index i, Index length) const
+  {
+    return std::clamp(i, Index(0), length - 1);
+  }
+
+  /**
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = 1;
+
+  /**
+   * @brief Compute the weights of the samples along an axis, and get the index of the first sample.
+   */
+  inline Index weights(double position, std::array<double, Support>& out) const
+  {
+    out[0] = 1;
+    return static_cast<Index>(position + .5); // Same as at()
+  }
+
   /**
    * @brief Return the value at the nearest integer position.
    */
@@ -96,6 +293,198 @@ struct Periodic {
         raster.shape());
     return raster[position];
   }
+
+  /**
+   * @brief Get the index which is read along an axis of given length.
+   */
+  inline Index index(Index i, Index length) const
+  {
+    const auto q = i % length;
+    return q < 0 ? q + length : q;
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Mirror, a.k.a. whole-sample symmetric, boundary conditions.
+ * 
+ * The border values are not repeated, e.g. index -1 is mapped to 1.
+ */
+struct Mirror {
+  /**
+   * @brief Return the value at the mirrored position.
+   */
+  template <typename TRaster>
+  inline const typename TRaster::value_type& at(TRaster& raster, Position<TRaster::Dimension> position) const
+  {
+    position.apply(
+        [&](auto p, auto s) {
+          return index(p, s);
+        },
+        raster.shape());
+    return raster[position];
+  }
+
+  /**
+   * @brief Get the index which is read along an axis of given length.
+   */
+  inline Index index(Index i, Index length) const
+  {
+    if (length == 1) {
+      return 0;
+    }
+    const auto period = 2 * (length - 1);
+    auto q = std::abs(i) % period;
+    return q < length ? q : period - q;
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The type of the extrapolation value of a method, or `void` if none.
+ */
+template <typename TMethod>
+struct ExtrapolationValue {
+  using type = void;
+};
+
+template <typename T>
+struct ExtrapolationValue<Constant<T>> {
+  using type = T;
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup resampling
+ * @brief Extrapolation through precomputed index maps.
+ * @tparam TMethod The tabulated method, which must provide `index(i, length)`, like `Constant`, `Nearest` or `Periodic`
+ * 
+ * For a given raster shape and margin, the offsets of the remapped indices are tabulated along each axis,
+ * over the domain extended by the margin on both sides.
+ * Extrapolated accesses are then one table lookup per axis instead of per-coordinate tests.
+ * With `Constant`, out-of-bounds indices map to a sentinel offset which points to the extrapolation value.
+ * 
+ * Positions beyond the margin are delegated to the tabulated method.
+ * The method is bound to the shape, and should therefore only be used with rasters of this shape.
+ * 
+ * \code
+ * const auto extrapolator = tabulated_extrapolation<Periodic>(raster, 2);
+ * \endcode
+ * 
+ * @see `tabulated_extrapolation()`
+ */
+template <typename TMethod = Nearest>
+class Tabulated {
+public:
+
+  /**
+   * @brief The tabulated method.
+   */
+  using Method = TMethod;
+
+  /**
+   * @brief Constructor.
+   * @param method The tabulated method
+   * @param shape The raster shape
+   * @param margin The margin on both sides of each axis
+   */
+  template <Index N>
+  Tabulated(TMethod method, const Position<N>& shape, Index margin) :
+      m_method(LINX_MOVE(method)), m_margin(margin), m_size(shape_size(shape)), m_starts(), m_lengths(),
+      m_offsets(), m_value()
+  {
+    if constexpr (not std::is_void_v<Value>) {
+      m_value = Value(m_method);
+    }
+    Index stride = 1;
+    for (auto length : shape) {
+      m_starts.push_back(static_cast<Index>(m_offsets.size()));
+      m_lengths.push_back(length + 2 * margin);
+      for (Index i = -margin; i < length + margin; ++i) {
+        const auto j = m_method.index(i, length);
+        m_offsets.push_back(j >= 0 ? j * stride : m_size); // Sums of sentinels are out of bounds, too
+      }
+      stride *= length;
+    }
+  }
+
+  /**
+   * @brief Get the tabulated method.
+   */
+  const TMethod& method() const
+  {
+    return m_method;
+  }
+
+  /**
+   * @brief Get the margin.
+   */
+  Index margin() const
+  {
+    return m_margin;
+  }
+
+  /**
+   * @brief Return the extrapolated value.
+   */
+  template <typename TRaster>
+  inline const typename TRaster::value_type& at(TRaster& raster, const Position<TRaster::Dimension>& position) const
+  {
+    const auto dimension = static_cast<Index>(position.size());
+    bool inside = true;
+    Index offset = 0;
+    for (Index i = 0; i < dimension; ++i) {
+      const auto k = static_cast<std::size_t>(position[i] + m_margin);
+      const auto length = static_cast<std::size_t>(m_lengths[i]);
+      inside &= k < length;
+      offset += m_offsets[m_starts[i] + static_cast<Index>(std::min(k, length - 1))]; // Clamped until tested
+    }
+    if (not inside) {
+      return m_method.at(raster, position);
+    }
+    if constexpr (std::is_void_v<Value>) {
+      return raster.data()[offset];
+    } else {
+      const typename TRaster::value_type* candidates[] = {&m_value, raster.data() + std::min(offset, m_size - 1)};
+      return *candidates[offset < m_size];
+    }
+  }
+
+  /**
+   * @brief Get the index which is read along an axis of given length.
+   */
+  inline Index index(Index i, Index length) const
+  {
+    return m_method.index(i, length);
+  }
+
+  /**
+   * @brief Get the extrapolation value, if any.
+   */
+  template <typename T, typename M = TMethod, typename std::enable_if_t<std::is_convertible_v<const M&, T>>* = nullptr>
+  operator T() const
+  {
+    return T(m_method);
+  }
+
+private:
+
+  /**
+   * @brief The extrapolation value type, or `void`.
+   */
+  using Value = typename Internal::ExtrapolationValue<TMethod>::type;
+
+  TMethod m_method; ///< The tabulated method
+  Index m_margin; ///< The margin
+  Index m_size; ///< The raster size, which is the sentinel offset
+  std::vector<Index> m_starts; ///< The start of the table of each axis
+  std::vector<Index> m_lengths; ///< The length of the table of each axis
+  std::vector<Index> m_offsets; ///< The tables of offsets
+  std::conditional_t<std::is_void_v<Value>, char, Value> m_value; ///< The extrapolation value, if any
 };
 
 /**
@@ -104,31 +493,29 @@ struct Periodic {
  */
 struct Linear {
   /**
-   * @brief Return the interpolated value at given index.
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = 2;
+
+  /**
+   * @brief Compute the weights of the samples along an axis, and get the index of the first sample.
    */
-  template <typename T, typename TRaster, typename... TIndices>
-  inline T at(const TRaster& raster, const Vector<double, 1>& position, TIndices... indices) const
+  inline Index weights(double position, std::array<double, Support>& out) const
   {
-    const auto f = floor<Index>(position.front());
-    const auto d = position.front() - f;
-    const T p = raster[{f, indices...}];
-    const T n = raster[{f + 1, indices...}];
-    return d * (n - p) + p;
+    const auto f = floor<Index>(position);
+    const auto d = position - f;
+    out[0] = 1 - d;
+    out[1] = d;
+    return f;
   }
 
   /**
    * @brief Return the interpolated value at given position.
    */
-  template <typename T, Index N, typename TRaster, typename... TIndices>
-  inline std::enable_if_t<N != 1, T> // FIXME use if constexpr
-  at(const TRaster& raster, const Vector<double, N>& position, TIndices... indices) const
+  template <typename T, typename TRaster, Index N>
+  inline T at(const TRaster& raster, const Vector<double, N>& position) const
   {
-    const auto f = floor<Index>(position.back());
-    const auto d = position.back() - f;
-    const auto pos = slice<N - 1>(position);
-    const auto p = at<T>(raster, pos, f, indices...);
-    const auto n = at<T>(raster, pos, f + 1, indices...);
-    return d * (n - p) + p;
+    return Internal::separable_at<T>(*this, raster, position);
   }
 };
 
@@ -138,35 +525,281 @@ struct Linear {
  */
 struct Cubic {
   /**
-   * @brief Return the interpolated value at given index.
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = 4;
+
+  /**
+   * @brief Compute the weights of the samples along an axis, and get the index of the first sample.
+   */
+  inline Index weights(double position, std::array<double, Support>& out) const
+  {
+    const auto f = floor<Index>(position);
+    const auto d = position - f;
+    const auto d2 = d * d;
+    const auto d3 = d2 * d;
+    out[0] = 0.5 * (-d + 2 * d2 - d3);
+    out[1] = 1 + 0.5 * (-5 * d2 + 3 * d3);
+    out[2] = 0.5 * (d + 4 * d2 - 3 * d3);
+    out[3] = 0.5 * (-d2 + d3);
+    return f - 1;
+  }
+
+  /**
+   * @brief Return the interpolated value at given position.
+   */
+  template <typename T, typename TRaster, Index N>
+  inline T at(const TRaster& raster, const Vector<double, N>& position) const
+  {
+    return Internal::separable_at<T>(*this, raster, position);
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief B-spline interpolation of degree 3 or 5.
+ * 
+ * Unlike `Cubic`, B-splines are not interpolating kernels:
+ * they are applied to coefficients which are obtained by a recursive prefilter of the whole raster.
+ * `Interpolation` computes the coefficients once, at construction, and shares them among its copies,
+ * such that the prefilter cost is amortized over the queries and warps.
+ * The prefilter assumes mirror boundary conditions.
+ * The coefficients of rasters are extrapolated with `Mirror`,
+ * while those of extrapolators are extrapolated with the method of the extrapolator.
+ * 
+ * The interpolation preserves the flux and the regularity (C2 for degree 3, C4 for degree 5)
+ * better than `Cubic`, at the cost of a larger support.
+ */
+template <Index Degree = 3>
+struct BSpline {
+  static_assert(Degree == 3 || Degree == 5, "B-spline degree must be 3 or 5");
+
+  /**
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = Degree + 1;
+
+  /**
+   * @brief Evaluate the B-spline basis function.
+   */
+  static double basis(double x)
+  {
+    x = std::abs(x);
+    if constexpr (Degree == 3) {
+      if (x < 1) {
+        return 2. / 3. - x * x + x * x * x / 2;
+      }
+      if (x < 2) {
+        const auto y = 2 - x;
+        return y * y * y / 6;
+      }
+      return 0;
+    } else {
+      const auto x2 = x * x;
+      if (x < 1) {
+        return 11. / 20. - x2 / 2 + x2 * x2 / 4 - x2 * x2 * x / 12;
+      }
+      if (x < 2) {
+        return 17. / 40. + 5. / 8. * x - 7. / 4. * x2 + 5. / 4. * x2 * x - 3. / 8. * x2 * x2 + x2 * x2 * x / 24;
+      }
+      if (x < 3) {
+        const auto y = 3 - x;
+        const auto y2 = y * y;
+        return y2 * y2 * y / 120;
+      }
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Compute the weights of the coefficients along an axis, and get the index of the first coefficient.
+   */
+  inline Index weights(double position, std::array<double, Support>& out) const
+  {
+    const auto first = floor<Index>(position) - (Degree - 1) / 2;
+    for (Index k = 0; k < Support; ++k) {
+      out[k] = basis(position - (first + k));
+    }
+    return first;
+  }
+
+  /**
+   * @brief Compute the B-spline coefficients of a raster.
+   */
+  template <typename T, typename TRaster>
+  Raster<T, TRaster::Dimension> prefilter(const TRaster& raster) const
+  {
+    std::array<double, (Degree - 1) / 2> poles;
+    if constexpr (Degree == 3) {
+      poles[0] = std::sqrt(3.) - 2;
+    } else {
+      poles[0] = std::sqrt(135. / 2. - std::sqrt(17745. / 4.)) + std::sqrt(105. / 4.) - 13. / 2.;
+      poles[1] = std::sqrt(135. / 2. + std::sqrt(17745. / 4.)) - std::sqrt(105. / 4.) - 13. / 2.;
+    }
+    Raster<T, TRaster::Dimension> out(raster.shape());
+    std::copy(raster.begin(), raster.end(), out.begin());
+    const auto& shape = out.shape();
+    auto* data = out.data();
+    Index stride = 1;
+    for (Index i = 0; i < static_cast<Index>(shape.size()); ++i) {
+      auto lines_shape = shape;
+      lines_shape[i] = 1;
+      for (const auto& l : Box<TRaster::Dimension>::from_shape(Position<TRaster::Dimension>::zero(), lines_shape)) {
+        Internal::bspline_prefilter(data + out.index(l), shape[i], stride, poles);
+      }
+      stride *= shape[i];
+    }
+    return out;
+  }
+
+  /**
+   * @brief Return the interpolated value at given position, given the coefficients.
    */
-  template <typename T, typename TRaster, typename... TIndices>
-  inline T at(const TRaster& raster, const Vector<double, 1>& position, TIndices... indices) const
+  template <typename T, typename TRaster, Index N>
+  inline T at(const TRaster& coefficients, const Vector<double, N>& position) const
   {
-    const auto f = floor<Index>(position.front());
-    const auto d = position.front() - f;
-    const T pp = raster[{f - 1, indices...}];
-    const T p = raster[{f, indices...}];
-    const T n = raster[{f + 1, indices...}];
-    const T nn = raster[{f + 2, indices...}];
-    return p + 0.5 * (d * (-pp + n) + d * d * (2 * pp - 5 * p + 4 * n - nn) + d * d * d * (-pp + 3 * p - 3 * n + nn));
+    return Internal::separable_at<T>(*this, coefficients, position);
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Lanczos interpolation.
+ * @tparam A The number of lobes, e.g. 3 for the classical Lanczos-3 kernel
+ * 
+ * The `2 * A` weights along each axis are normalized to sum to one, such that constants are preserved.
+ * They are computed once per axis, such that the cost of the weights grows linearly with the support.
+ */
+template <Index A = 3>
+struct Lanczos {
+  /**
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = 2 * A;
+
+  /**
+   * @brief Evaluate the Lanczos kernel.
+   */
+  static double kernel(double x)
+  {
+    constexpr double pi = 3.14159265358979323846;
+    if (x == 0) {
+      return 1;
+    }
+    if (std::abs(x) >= A) {
+      return 0;
+    }
+    const auto px = pi * x;
+    return A * std::sin(px) * std::sin(px / A) / (px * px);
+  }
+
+  /**
+   * @brief Compute the weights of the samples along an axis, and get the index of the first sample.
+   */
+  inline Index weights(double position, std::array<double, Support>& out) const
+  {
+    const auto first = floor<Index>(position) - A + 1;
+    double sum = 0;
+    for (Index k = 0; k < Support; ++k) {
+      out[k] = kernel(position - (first + k));
+      sum += out[k];
+    }
+    for (auto& w : out) {
+      w /= sum;
+    }
+    return first;
   }
 
   /**
    * @brief Return the interpolated value at given position.
    */
-  template <typename T, Index N, typename TRaster, typename... TIndices>
-  inline std::enable_if_t<N != 1, T> // FIXME use if constexpr
-  at(const TRaster& raster, const Vector<double, N>& position, TIndices... indices) const
-  {
-    const auto f = floor<Index>(position.back());
-    const auto d = position.back() - f;
-    const auto pos = slice<N - 1>(position);
-    const auto pp = at<T>(raster, pos, f - 1, indices...);
-    const auto p = at<T>(raster, pos, f, indices...);
-    const auto n = at<T>(raster, pos, f + 1, indices...);
-    const auto nn = at<T>(raster, pos, f + 2, indices...);
-    return p + 0.5 * (d * (-pp + n) + d * d * (2 * pp - 5 * p + 4 * n - nn) + d * d * d * (-pp + 3 * p - 3 * n + nn));
+  template <typename T, typename TRaster, Index N>
+  inline T at(const TRaster& raster, const Vector<double, N>& position) const
+  {
+    return Internal::separable_at<T>(*this, raster, position);
+  }
+};
+
+/**
+ * @ingroup resampling
+ * @brief Separable interpolation with weights read from a lookup table.
+ * @tparam TMethod The separable interpolation method, e.g. `Linear` or `Cubic`
+ * @tparam Steps The number of quantization steps of the fractional part of the coordinates
+ * 
+ * The fractional part of each coordinate is rounded to the nearest multiple of `1 / Steps`,
+ * and the weights are read from a table which is computed once and for all.
+ * This saves the evaluation of the polynomials, at the cost of a position error up to `0.5 / Steps`.
+ * 
+ * \code
+ * auto out = affinity.warp<Quantized<Cubic>>(in);
+ * \endcode
+ */
+template <typename TMethod, Index Steps = 1024>
+struct Quantized {
+  /**
+   * @brief The number of samples along each axis.
+   */
+  static constexpr Index Support = TMethod::Support;
+
+  /**
+   * @brief Read the weights of the samples along an axis, and get the index of the first sample.
+   */
+  inline Index weights(double position, std::array<double, Support>& out) const
+  {
+    auto f = floor<Index>(position);
+    auto q = static_cast<Index>(std::lround((position - f) * Steps));
+    if (q == Steps) {
+      ++f;
+      q = 0;
+    }
+    const auto& t = table();
+    out = t.weights[q];
+    return f + t.offset;
+  }
+
+  /**
+   * @brief Compute the coefficients of a raster, if the method requires a prefilter.
+   */
+  template <typename T, typename TRaster, typename UMethod = TMethod>
+  auto prefilter(const TRaster& raster) const -> decltype(std::declval<const UMethod&>().template prefilter<T>(raster))
+  {
+    return UMethod().template prefilter<T>(raster);
+  }
+
+  /**
+   * @brief Return the interpolated value at given position.
+   */
+  template <typename T, typename TRaster, Index N>
+  inline T at(const TRaster& raster, const Vector<double, N>& position) const
+  {
+    return Internal::separable_at<T>(*this, raster, position);
+  }
+
+private:
+
+  /**
+   * @brief The lookup table.
+   */
+  struct Table {
+    Table() : weights(Steps), offset(0)
+    {
+      const TMethod method {};
+      for (Index q = 0; q < Steps; ++q) {
+        offset = method.weights(static_cast<double>(q) / Steps, weights[q]);
+      }
+    }
+
+    std::vector<std::array<double, Support>> weights; ///< The weights of each step
+    Index offset; ///< The index of the first sample relative to the integral part of the coordinate
+  };
+
+  /**
+   * @brief Get the lookup table, which is built at first call.
+   */
+  static const Table& table()
+  {
+    static const Table t;
+    return t;
   }
 };
 
@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_ROWFETCHING_H
+#define _LINXTRANSFORMS_IMPL_ROWFETCHING_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Copy an input row.
+ * @param in The input raster
+ * @param front The position of the first element of the row
+ * @param row The output row, whose size is the number of elements to be copied along axis 0
+ */
+template <typename T, Index N, typename THolder, typename U>
+void fetch_row(const Raster<T, N, THolder>& in, const Position<N>& front, std::vector<U>& row)
+{
+  const auto* begin = &in[front];
+  std::copy(begin, begin + row.size(), row.begin());
+}
+
+/**
+ * @brief Copy an extrapolated input row.
+ *
+ * Values inside the raster domain are copied in block, and only the out-of-bounds values are extrapolated.
+ */
+template <typename TRaster, typename TMethod, typename U>
+void fetch_row(const Extrapolation<TRaster, TMethod>& in, const Position<TRaster::Dimension>& front, std::vector<U>& row)
+{
+  static constexpr Index N = TRaster::Dimension;
+  const auto& raw = dont_extrapolate(in);
+  const auto size = static_cast<Index>(row.size());
+  bool inside = true;
+  for (Index i = 1; i < N; ++i) {
+    inside &= (front[i] >= 0 && front[i] < raw.length(i));
+  }
+  Index begin = inside ? std::clamp(-front[0], Index(0), size) : size;
+  Index end = inside ? std::clamp(raw.length(0) - front[0], begin, size) : size;
+  auto p = front;
+  for (Index x = 0; x < begin; ++x, ++p[0]) {
+    row[x] = in[p];
+  }
+  if (end > begin) {
+    const auto* ptr = &raw[p];
+    std::copy(ptr, ptr + (end - begin), row.begin() + begin);
+    p[0] += end - begin;
+  }
+  for (Index x = end; x < size; ++x, ++p[0]) {
+    row[x] = in[p];
+  }
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -0,0 +1,323 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SEPARABLECORRELATION_H
+#define _LINXTRANSFORMS_IMPL_SEPARABLECORRELATION_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/RowFetching.h"
+
+#include <algorithm> // copy_n, fill_n, max
+#include <cmath>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Rank-one decomposition of a box-based correlation kernel, and associated streaming engine.
+ *
+ * A kernel is separable if its coefficients write `c[q] = a0[q0] * a1[q1] * ...`,
+ * in which case the correlation is computed as a sequence of 1D correlations along each axis.
+ *
+ * Contrary to `FilterSeq`, no intermediate raster is allocated:
+ * input rows are filtered along axis 0 and accumulated into a ring of line buffers,
+ * which are then combined along axis 1 (and recursively along higher axes),
+ * such that the working set is a few rows per axis.
+ */
+template <Index N>
+class SeparableCorrelation {
+public:
+
+  /**
+   * @brief Default constructor, which means the kernel is not separable.
+   */
+  SeparableCorrelation() : m_factors() {}
+
+  /**
+   * @brief Try and decompose some correlation coefficients.
+   * @param window The kernel window
+   * @param begin The iterator to the first coefficient, ordered like the window positions
+   *
+   * If the kernel is not separable, or if separation would not save operations, the output is empty.
+   */
+  template <typename TIt>
+  static SeparableCorrelation decompose(const Box<N>& window, TIt begin)
+  {
+    SeparableCorrelation out;
+    const auto shape = window.shape();
+    Index sum = 0;
+    Index product = 1;
+    for (auto l : shape) {
+      sum += l;
+      product *= l;
+    }
+    if (N < 2 || sum >= product) {
+      return out;
+    }
+
+    // Copy values and find pivot
+    Raster<double, N> values(shape);
+    std::copy_n(begin, values.size(), values.begin());
+    double pivot = 0;
+    auto pivot_position = Position<N>::zero();
+    for (const auto& p : values.domain()) {
+      if (std::abs(values[p]) > std::abs(pivot)) {
+        pivot = values[p];
+        pivot_position = p;
+      }
+    }
+    if (pivot == 0) {
+      return out;
+    }
+
+    // Extract lines through pivot
+    std::vector<std::vector<double>> factors(N);
+    for (Index i = 0; i < N; ++i) {
+      auto p = pivot_position;
+      for (p[i] = 0; p[i] < shape[i]; ++p[i]) {
+        factors[i].push_back(values[p]);
+      }
+    }
+    const auto scale = std::pow(pivot, N - 1);
+    for (auto& e : factors[0]) {
+      e /= scale;
+    }
+
+    // Check rank one
+    const auto tolerance = std::abs(pivot) * 1e-12;
+    for (const auto& p : values.domain()) {
+      double product = 1;
+      for (Index i = 0; i < N; ++i) {
+        product *= factors[i][p[i]];
+      }
+      if (std::abs(product - values[p]) > tolerance) {
+        return out;
+      }
+    }
+
+    out.m_factors = LINX_MOVE(factors);
+    return out;
+  }
+
+  /**
+   * @brief Create a separable kernel from its 1D factors along each axis.
+   */
+  static SeparableCorrelation from_factors(std::vector<std::vector<double>> factors)
+  {
+    SeparableCorrelation out;
+    out.m_factors = LINX_MOVE(factors);
+    return out;
+  }
+
+  /**
+   * @brief Check whether the kernel was decomposed.
+   */
+  explicit operator bool() const
+  {
+    return not m_factors.empty();
+  }
+
+  /**
+   * @brief Get the 1D factor along some axis.
+   */
+  const std::vector<double>& factor(Index i) const
+  {
+    return m_factors[i];
+  }
+
+  /**
+   * @brief Correlate an input raster or extrapolator.
+   * @param in The input raster or extrapolator
+   * @param front The input position associated with the first output element and first kernel coefficient
+   * @param shape The output shape
+   * @param out The output, iterated in order
+   *
+   * The output is computed as `out[p] = sum_r c[r] * in[front + p + r]`, where `r` spans `Box::from_shape(0, window.shape())`.
+   */
+  template <typename TIn, typename TOut>
+  void correlate(const TIn& in, const Position<N>& front, const Position<N>& shape, TOut& out) const
+  {
+    correlate(in, front, Position<N>::one(), shape, out);
+  }
+
+  /**
+   * @brief Correlate an input raster or extrapolator and decimate the result.
+   * @param step The decimation step along each axis
+   *
+   * The output is computed as `out[p] = sum_r c[r] * in[front + p * step + r]`.
+   * Only the input rows and slabs which contribute to the output are filtered,
+   * and each of them is filtered once, even if it contributes to several output slabs,
+   * i.e. partial sums are shared between neighboring output elements when the kernel is longer than the step.
+   */
+  template <typename TIn, typename TOut>
+  void correlate(const TIn& in, const Position<N>& front, const Position<N>& step, const Position<N>& shape, TOut& out)
+      const
+  {
+    for (auto l : shape) {
+      if (l <= 0) {
+        return;
+      }
+    }
+    Scratch scratch(m_factors, step, shape);
+    Position<N> e = Position<N>::zero();
+    auto out_it = out.begin();
+    auto flush = [&](const std::vector<double>& slab) {
+      for (auto v : slab) {
+        *out_it = cast<std::decay_t<decltype(*out_it)>>(v);
+        ++out_it;
+      }
+    };
+    if constexpr (N == 1) {
+      process<0>(in, front, step, shape, e, scratch, scratch.slab.data());
+      flush(scratch.slab);
+    } else {
+      constexpr Index D = N - 1;
+      const auto& factor = m_factors[D];
+      const auto length = static_cast<Index>(factor.size());
+      auto& ring = scratch.rings[D];
+      const auto slab_size = scratch.slab.size();
+      for (Index j = 0; j < shape[D]; ++j) {
+        fill_ring<D>(in, front, step, shape, e, scratch, j);
+        combine(factor, ring, slab_size, j * step[D], length, scratch.slab.data());
+        flush(scratch.slab);
+      }
+    }
+  }
+
+private:
+
+  /**
+   * @brief The working buffers.
+   */
+  struct Scratch {
+    Scratch(const std::vector<std::vector<double>>& factors, const Position<N>& step, const Position<N>& shape) :
+        row((shape[0] - 1) * step[0] + factors[0].size()), rings(N), slab()
+    {
+      Index size = 1;
+      for (Index d = 0; d < N; ++d) {
+        if (d > 0) {
+          rings[d].resize(factors[d].size() * size);
+        }
+        if (d < N - 1) {
+          size *= shape[d];
+        }
+      }
+      slab.resize(size);
+    }
+
+    std::vector<double> row; ///< The current input row
+    std::vector<std::vector<double>> rings; ///< The ring of slabs for each axis > 0
+    std::vector<double> slab; ///< The current output slab
+  };
+
+  /**
+   * @brief Cast a computed value to the output type.
+   */
+  template <typename T>
+  static T cast(double v)
+  {
+    if constexpr (std::is_integral_v<T>) {
+      return static_cast<T>(std::llround(v));
+    } else {
+      return static_cast<T>(v);
+    }
+  }
+
+  /**
+   * @brief Combine the slabs of a ring along some axis, from input slab `first`.
+   */
+  static void combine(
+      const std::vector<double>& factor,
+      const std::vector<double>& ring,
+      std::size_t slab_size,
+      Index first,
+      Index length,
+      double* dst)
+  {
+    std::fill_n(dst, slab_size, 0.);
+    for (Index k = 0; k < length; ++k) {
+      const auto c = factor[k];
+      const auto* src = ring.data() + ((first + k) % length) * slab_size;
+      for (std::size_t i = 0; i < slab_size; ++i) {
+        dst[i] += c * src[i];
+      }
+    }
+  }
+
+  /**
+   * @brief Update the ring of axis `D` such that it contains the input slabs `j * step` to `j * step + length - 1`.
+   *
+   * The slabs which were already computed for output slab `j - 1` are kept.
+   */
+  template <Index D, typename TIn>
+  void fill_ring(
+      const TIn& in,
+      const Position<N>& front,
+      const Position<N>& step,
+      const Position<N>& shape,
+      Position<N>& e,
+      Scratch& scratch,
+      Index j) const
+  {
+    const auto length = static_cast<Index>(m_factors[D].size());
+    const auto slab_size = scratch.rings[D].size() / length;
+    const auto first = j * step[D];
+    const Index begin = j == 0 ? 0 : std::max(first - step[D] + length, first);
+    for (Index k = begin; k < first + length; ++k) {
+      e[D] = k;
+      process<D - 1>(in, front, step, shape, e, scratch, scratch.rings[D].data() + (k % length) * slab_size);
+    }
+  }
+
+  /**
+   * @brief Compute the slab of axes 0 to `D` at the higher coordinates `e`.
+   */
+  template <Index D, typename TIn>
+  void process(
+      const TIn& in,
+      const Position<N>& front,
+      const Position<N>& step,
+      const Position<N>& shape,
+      Position<N>& e,
+      Scratch& scratch,
+      double* dst) const
+  {
+    if constexpr (D == 0) {
+      auto& row = scratch.row;
+      fetch_row(in, front + e, row);
+      const auto& factor = m_factors[0];
+      const auto length = factor.size();
+      const auto stride = step[0];
+      for (Index x = 0; x < shape[0]; ++x) {
+        const auto* src = row.data() + x * stride;
+        double sum = 0;
+        for (std::size_t k = 0; k < length; ++k) {
+          sum += factor[k] * src[k];
+        }
+        dst[x] = sum;
+      }
+    } else {
+      const auto& factor = m_factors[D];
+      const auto length = static_cast<Index>(factor.size());
+      const auto slab_size = scratch.rings[D].size() / length;
+      for (Index j = 0; j < shape[D]; ++j) {
+        fill_ring<D>(in, front, step, shape, e, scratch, j);
+        combine(factor, scratch.rings[D], slab_size, j * step[D], length, dst + j * slab_size);
+      }
+    }
+  }
+
+  /**
+   * @brief The 1D factors along each axis.
+   */
+  std::vector<std::vector<double>> m_factors;
+};
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -0,0 +1,111 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SHIFTACCUMULATE_H
+#define _LINXTRANSFORMS_IMPL_SHIFTACCUMULATE_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/RowFetching.h"
+
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Accumulate a scaled and shifted row into another row.
+ *
+ * This is the hot loop of `shift_accumulate()`, written such that it is vectorized.
+ */
+template <typename T>
+LINX_KERNEL void accumulate_row(T coefficient, const T* __restrict src, T* __restrict dst, Index size)
+{
+#pragma omp simd
+  for (Index x = 0; x < size; ++x) {
+    dst[x] += coefficient * src[x];
+  }
+}
+
+/**
+ * @brief Correlate an input raster or extrapolator by shifting and accumulating rows.
+ * @tparam T The computation type
+ * @param in The input raster or extrapolator
+ * @param front The input position associated with the first output element and first coefficient
+ * @param window The window shape
+ * @param coefficients The correlation coefficients, ordered like the window positions
+ * @param shape The output shape
+ * @param out The output, iterated in order
+ *
+ * Instead of computing an inner product at each output pixel,
+ * each output row is accumulated tap by tap: for each coefficient, the input row is shifted accordingly,
+ * scaled and added to the output row buffer.
+ * The inner loop runs over contiguous memory with a constant coefficient, and is vectorized.
+ * Input rows are read in place when possible, and fetched into a row buffer otherwise,
+ * e.g. for extrapolated or converted values.
+ * Null coefficients are skipped.
+ * The function is compiled for several instruction sets, see `instruction_set()`.
+ */
+template <typename T, typename TIn, typename TOut>
+LINX_KERNEL void shift_accumulate_kernel(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const std::vector<T>& coefficients,
+    const Position<TIn::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  constexpr bool in_place = not is_extrapolator<TIn>() && std::is_same_v<std::decay_t<typename TIn::Value>, T>;
+  const auto width = shape[0];
+  const auto length = window[0];
+  std::vector<T> row(width + length - 1);
+  std::vector<T> acc(width);
+
+  // Window rows, i.e. window positions with index 0 along axis 0
+  auto rows_shape = window;
+  rows_shape[0] = 1;
+  const auto rows = Box<N>::from_shape(Position<N>::zero(), rows_shape);
+
+  auto lines_shape = shape;
+  lines_shape[0] = 1;
+  auto out_it = out.begin();
+  for (const auto& l : Box<N>::from_shape(Position<N>::zero(), lines_shape)) {
+    std::fill(acc.begin(), acc.end(), T());
+    auto c = coefficients.data();
+    for (const auto& r : rows) {
+      const T* src;
+      if constexpr (in_place) {
+        src = &in[front + l + r];
+      } else {
+        fetch_row(in, front + l + r, row);
+        src = row.data();
+      }
+      for (Index k = 0; k < length; ++k, ++c) {
+        if (*c != T()) {
+          accumulate_row(*c, src + k, acc.data(), width);
+        }
+      }
+    }
+    for (const auto& v : acc) {
+      *out_it = v;
+      ++out_it;
+    }
+  }
+}
+
+LINX_MULTIVERSION(shift_accumulate)
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
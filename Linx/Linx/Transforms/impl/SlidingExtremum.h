@@ -0,0 +1,269 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SLIDINGEXTREMUM_H
+#define _LINXTRANSFORMS_IMPL_SLIDINGEXTREMUM_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a window is a box of some dimension.
+ */
+template <typename TWindow, Index N>
+constexpr bool is_box_window()
+{
+  return std::is_same_v<std::decay_t<TWindow>, Box<N>>;
+}
+
+/**
+ * @brief Minimum operator for `sliding_extremum()`.
+ */
+struct SlidingMin {
+  template <typename T>
+  inline const T& operator()(const T& lhs, const T& rhs) const
+  {
+    return std::min(lhs, rhs);
+  }
+};
+
+/**
+ * @brief Maximum operator for `sliding_extremum()`.
+ */
+struct SlidingMax {
+  template <typename T>
+  inline const T& operator()(const T& lhs, const T& rhs) const
+  {
+    return std::max(lhs, rhs);
+  }
+};
+
+/**
+ * @brief Compute the running extremum of strided lines along some axis with the van Herk/Gil-Werman algorithm.
+ * @param in The input buffer
+ * @param in_shape The input shape
+ * @param axis The axis
+ * @param length The window length along the axis
+ * @param op The extremum operator
+ * @param out The output buffer, whose shape is `in_shape` except along `axis`, where it is `in_shape[axis] - length + 1`
+ *
+ * Lines are split into blocks of `length` elements, inside which forward and backward cumulative extrema are computed.
+ * Each output value is the extremum of one backward and one forward value,
+ * such that the cost is three comparisons per element whatever the length.
+ * The function is compiled for several instruction sets.
+ */
+template <typename T, Index N, typename TOp>
+LINX_KERNEL void van_herk_along_kernel(
+    const T* in,
+    const Position<N>& in_shape,
+    Index axis,
+    Index length,
+    TOp&& op,
+    T* out,
+    std::vector<T>& forward,
+    std::vector<T>& backward)
+{
+  Index stride = 1;
+  for (Index i = 0; i < axis; ++i) {
+    stride *= in_shape[i];
+  }
+  const auto in_length = in_shape[axis];
+  const auto out_length = in_length - length + 1;
+  Index outer = 1;
+  for (Index i = axis + 1; i < N; ++i) {
+    outer *= in_shape[i];
+  }
+  forward.resize(in_length);
+  backward.resize(in_length);
+
+  for (Index o = 0; o < outer; ++o) {
+    for (Index s = 0; s < stride; ++s) {
+      const auto* line = in + o * stride * in_length + s;
+      auto* dst = out + o * stride * out_length + s;
+      for (Index i = 0; i < in_length; ++i) {
+        const auto& v = line[i * stride];
+        forward[i] = (i % length == 0) ? v : op(forward[i - 1], v);
+      }
+      for (Index i = in_length - 1; i >= 0; --i) {
+        const auto& v = line[i * stride];
+        backward[i] = (i % length == length - 1 || i == in_length - 1) ? v : op(backward[i + 1], v);
+      }
+      for (Index i = 0; i < out_length; ++i) {
+        dst[i * stride] = op(backward[i], forward[i + length - 1]);
+      }
+    }
+  }
+}
+
+LINX_MULTIVERSION(van_herk_along)
+
+/**
+ * @brief Compute the minimum or maximum filter with a box window, axis by axis.
+ * @tparam T The computation type
+ * @param in The input raster or extrapolator
+ * @param front The input position of the window front for the first output element
+ * @param window The window shape
+ * @param shape The output shape
+ * @param op The extremum operator
+ * @param convert The conversion of input values to `T`
+ * @param out The output, iterated in order
+ */
+template <typename T, typename TIn, typename TOp, typename TConvert, typename TOut>
+void sliding_extremum(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const Position<TIn::Dimension>& shape,
+    TOp&& op,
+    TConvert&& convert,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  auto buffer_shape = shape + window - 1;
+  const auto patch = in(Box<N>::from_shape(front, buffer_shape));
+  Raster<T, N> buffer(buffer_shape);
+  std::transform(patch.begin(), patch.end(), buffer.begin(), convert);
+
+  Raster<T, N> reduced;
+  std::vector<T> forward;
+  std::vector<T> backward;
+  for (Index i = 0; i < N; ++i) {
+    if (window[i] == 1) {
+      continue;
+    }
+    auto reduced_shape = buffer_shape;
+    reduced_shape[i] = shape[i];
+    reduced = Raster<T, N>(reduced_shape);
+    van_herk_along(buffer.data(), buffer_shape, i, window[i], op, reduced.data(), forward, backward);
+    std::swap(buffer, reduced);
+    buffer_shape = reduced_shape;
+  }
+
+  std::copy(buffer.begin(), buffer.end(), out.begin());
+}
+
+/**
+ * @brief Residual operator for `sliding_opening()` which keeps the opening or closing.
+ */
+struct NoResidual {
+  template <typename T>
+  inline T operator()(const T&, const T& filtered) const
+  {
+    return filtered;
+  }
+};
+
+/**
+ * @brief Residual operator for `sliding_opening()` which computes the white top-hat, i.e. input minus opening.
+ */
+struct WhiteResidual {
+  template <typename T>
+  inline T operator()(const T& in, const T& filtered) const
+  {
+    return in - filtered;
+  }
+};
+
+/**
+ * @brief Residual operator for `sliding_opening()` which computes the black top-hat, i.e. closing minus input.
+ */
+struct BlackResidual {
+  template <typename T>
+  inline T operator()(const T& in, const T& filtered) const
+  {
+    return filtered - in;
+  }
+};
+
+/**
+ * @brief Compute the opening or closing with a box window, axis by axis, and optionally a top-hat.
+ * @tparam T The computation type
+ * @param in The input raster or extrapolator
+ * @param front The input position of the footprint front for the first output element,
+ * where the footprint is the window dilated by itself
+ * @param window The window shape
+ * @param shape The output shape
+ * @param first The extremum operator of the first pass, e.g. `SlidingMin` for the opening
+ * @param second The extremum operator of the second pass, e.g. `SlidingMax` for the opening
+ * @param residual The operator which combines the input and filtered values into the output
+ * @param out The output, iterated in order
+ *
+ * Both passes are performed in two ping-pong buffers of the size of the input footprint,
+ * which are allocated once, and the residual is fused with the output assignment,
+ * such that no intermediate raster is created.
+ */
+template <typename T, typename TIn, typename TFirst, typename TSecond, typename TResidual, typename TOut>
+void sliding_opening(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const Position<TIn::Dimension>& shape,
+    TFirst&& first,
+    TSecond&& second,
+    TResidual&& residual,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  const auto margin = window - 1;
+  const auto source_shape = shape + margin * 2;
+  const auto patch = in(Box<N>::from_shape(front, source_shape));
+  Raster<T, N> source(source_shape);
+  std::transform(patch.begin(), patch.end(), source.begin(), [](const auto& e) {
+    return static_cast<T>(e);
+  });
+
+  Raster<T, N> ping(source_shape);
+  Raster<T, N> pong(source_shape);
+  std::vector<T> forward;
+  std::vector<T> backward;
+  const T* current = source.data();
+  auto current_shape = source_shape;
+  const auto reduce = [&](auto&& op) {
+    for (Index i = 0; i < N; ++i) {
+      if (window[i] == 1) {
+        continue;
+      }
+      auto* dst = current == ping.data() ? pong.data() : ping.data();
+      auto reduced_shape = current_shape;
+      reduced_shape[i] -= margin[i];
+      van_herk_along(current, current_shape, i, window[i], op, dst, forward, backward);
+      current = dst;
+      current_shape = reduced_shape;
+    }
+  };
+  reduce(first);
+  reduce(second);
+
+  const auto center = source(Box<N>::from_shape(margin, shape));
+  auto it = out.begin();
+  auto c = center.begin();
+  for (const auto* f = current; f != current + shape_size(shape); ++f, ++c, ++it) {
+    *it = residual(*c, *f);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -0,0 +1,320 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SLIDINGRANK_H
+#define _LINXTRANSFORMS_IMPL_SLIDINGRANK_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric> // accumulate
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a type is suitable for histogram-based sliding order statistics.
+ */
+template <typename T>
+constexpr bool is_histogrammable()
+{
+  return std::is_integral_v<T> && not std::is_same_v<T, bool> && sizeof(T) <= 2;
+}
+
+/**
+ * @brief Histogram with rank tracking, a la Huang, with coarse bins a la Perreault-Hebert.
+ *
+ * The tracked bin `m_median` is such that `m_below <= rank < m_below + m_fine[m_median]`,
+ * where `m_below` is the number of values in bins lower than `m_median`.
+ */
+template <typename T>
+class RankHistogram {
+public:
+
+  static constexpr Index Offset = -static_cast<Index>(std::numeric_limits<T>::min());
+  static constexpr Index Bins = Index(1) << (8 * sizeof(T));
+  static constexpr Index CoarseShift = 8;
+  static constexpr Index CoarseBins = std::max(Bins >> CoarseShift, Index(1));
+
+  explicit RankHistogram(Index rank) : m_fine(Bins, 0), m_coarse(CoarseBins, 0), m_rank(rank), m_median(0), m_below(0)
+  {}
+
+  void insert(T value)
+  {
+    const auto bin = value + Offset;
+    ++m_fine[bin];
+    ++m_coarse[bin >> CoarseShift];
+    m_below += (bin < m_median);
+  }
+
+  void erase(T value)
+  {
+    const auto bin = value + Offset;
+    --m_fine[bin];
+    --m_coarse[bin >> CoarseShift];
+    m_below -= (bin < m_median);
+  }
+
+  T value()
+  {
+    while (m_below > m_rank) {
+      const auto block = m_median >> CoarseShift;
+      if ((m_median & ((1 << CoarseShift) - 1)) == 0 && m_below - m_coarse[block - 1] > m_rank) {
+        m_below -= m_coarse[block - 1];
+        m_median -= 1 << CoarseShift;
+      } else {
+        --m_median;
+        m_below -= m_fine[m_median];
+      }
+    }
+    while (m_below + m_fine[m_median] <= m_rank) {
+      const auto block = m_median >> CoarseShift;
+      if ((m_median & ((1 << CoarseShift) - 1)) == 0 && m_below + m_coarse[block] <= m_rank) {
+        m_below += m_coarse[block];
+        m_median += 1 << CoarseShift;
+      } else {
+        m_below += m_fine[m_median];
+        ++m_median;
+      }
+    }
+    return static_cast<T>(m_median - Offset);
+  }
+
+private:
+
+  std::vector<Index> m_fine;
+  std::vector<Index> m_coarse;
+  Index m_rank;
+  Index m_median;
+  Index m_below;
+};
+
+/**
+ * @brief Sorted window with column-wise updates.
+ *
+ * Each update sorts the outgoing and incoming columns,
+ * and merges them into the sorted window in a single linear pass.
+ */
+template <typename T>
+class RankSortedWindow {
+public:
+
+  explicit RankSortedWindow(Index rank) : m_window(), m_merged(), m_outgoing(), m_incoming(), m_rank(rank) {}
+
+  void reset()
+  {
+    m_window.clear();
+    m_incoming.clear();
+  }
+
+  void insert(T value)
+  {
+    m_incoming.push_back(value);
+  }
+
+  void erase(T value)
+  {
+    m_outgoing.push_back(value);
+  }
+
+  T value()
+  {
+    return sorted()[m_rank];
+  }
+
+  const std::vector<T>& sorted()
+  {
+    if (not m_outgoing.empty() || not m_incoming.empty()) {
+      update();
+    }
+    return m_window;
+  }
+
+private:
+
+  void update()
+  {
+    std::sort(m_outgoing.begin(), m_outgoing.end());
+    std::sort(m_incoming.begin(), m_incoming.end());
+    m_merged.clear();
+    auto out_it = m_outgoing.begin();
+    auto in_it = m_incoming.begin();
+    for (auto v : m_window) {
+      if (out_it != m_outgoing.end() && not(*out_it < v) && not(v < *out_it)) {
+        ++out_it;
+        continue;
+      }
+      while (in_it != m_incoming.end() && *in_it < v) {
+        m_merged.push_back(*in_it);
+        ++in_it;
+      }
+      m_merged.push_back(v);
+    }
+    m_merged.insert(m_merged.end(), in_it, m_incoming.end());
+    std::swap(m_window, m_merged);
+    m_outgoing.clear();
+    m_incoming.clear();
+  }
+
+  std::vector<T> m_window;
+  std::vector<T> m_merged;
+  std::vector<T> m_outgoing;
+  std::vector<T> m_incoming;
+  Index m_rank;
+};
+
+/**
+ * @brief Slide a box window along axis 0, and evaluate some order statistic at each output position.
+ * @param in The input raster
+ * @param front The input position of the window front for the first output element
+ * @param window The window shape
+ * @param shape The output shape
+ * @param accumulator The order-statistics structure, which provides `insert()` and `erase()`
+ * @param evaluate The function which computes an output value from the accumulator
+ * @param out The output, iterated in order
+ *
+ * Along each line, the window is initialized once, and then updated column by column:
+ * the column which leaves the window is erased and the column which enters the window is inserted.
+ */
+template <typename T, Index N, typename THolder, typename TAccumulator, typename TFunc, typename TOut>
+void sliding_order_statistic(
+    const Raster<T, N, THolder>& in,
+    const Position<N>& front,
+    const Position<N>& window,
+    const Position<N>& shape,
+    TAccumulator& accumulator,
+    TFunc&& evaluate,
+    TOut& out)
+{
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  // Offsets of a window column, i.e. window positions with index 0 along axis 0
+  auto column_shape = window;
+  column_shape[0] = 1;
+  std::vector<Index> column;
+  for (const auto& r : Box<N>::from_shape(Position<N>::zero(), column_shape)) {
+    column.push_back(in.index(r) - in.index(Position<N>::zero()));
+  }
+
+  const auto* data = in.data();
+  auto line_shape = shape;
+  line_shape[0] = 1;
+  auto out_it = out.begin();
+  for (const auto& l : Box<N>::from_shape(Position<N>::zero(), line_shape)) {
+    const auto* base = data + in.index(front + l);
+    for (Index k = 0; k < window[0]; ++k) {
+      for (auto o : column) {
+        accumulator.insert(base[o + k]);
+      }
+    }
+    for (Index x = 0; x < shape[0]; ++x) {
+      *out_it = evaluate(accumulator);
+      ++out_it;
+      if (x + 1 < shape[0]) {
+        for (auto o : column) {
+          accumulator.erase(base[o + x]);
+          accumulator.insert(base[o + x + window[0]]);
+        }
+      }
+    }
+    if constexpr (std::is_same_v<TAccumulator, RankHistogram<T>>) {
+      const auto* last = base + shape[0] - 1;
+      for (Index k = 0; k < window[0]; ++k) {
+        for (auto o : column) {
+          accumulator.erase(last[o + k]);
+        }
+      }
+    } else {
+      accumulator.reset();
+    }
+  }
+}
+
+/**
+ * @brief Compute the rank filter with a box window by sliding it along axis 0.
+ * @param rank The rank of the output value in the sorted window, between 0 and the window size - 1
+ *
+ * For 8- and 16-bit integers, a histogram is maintained, such that the cost is nearly independent of the window size.
+ * Otherwise, a sorted window is updated with linear merges.
+ *
+ * @see `sliding_order_statistic()`
+ */
+template <typename T, Index N, typename THolder, typename TOut>
+void sliding_rank(
+    const Raster<T, N, THolder>& in,
+    const Position<N>& front,
+    const Position<N>& window,
+    const Position<N>& shape,
+    Index rank,
+    TOut& out)
+{
+  using Accumulator = std::conditional_t<is_histogrammable<T>(), RankHistogram<T>, RankSortedWindow<T>>;
+  Accumulator accumulator(rank);
+  sliding_order_statistic(
+      in,
+      front,
+      window,
+      shape,
+      accumulator,
+      [](auto& a) {
+        return a.value();
+      },
+      out);
+}
+
+/**
+ * @brief Compute the median filter with a box window of odd size by sliding it along axis 0.
+ */
+template <typename T, Index N, typename THolder, typename TOut>
+void sliding_median(
+    const Raster<T, N, THolder>& in,
+    const Position<N>& front,
+    const Position<N>& window,
+    const Position<N>& shape,
+    TOut& out)
+{
+  sliding_rank(in, front, window, shape, (shape_size(window) - 1) / 2, out);
+}
+
+/**
+ * @brief Compute the mean of the values with rank in `[first, last]` with a box window slid along axis 0.
+ * @tparam U The output value type
+ */
+template <typename U, typename T, Index N, typename THolder, typename TOut>
+void sliding_trimmed_mean(
+    const Raster<T, N, THolder>& in,
+    const Position<N>& front,
+    const Position<N>& window,
+    const Position<N>& shape,
+    Index first,
+    Index last,
+    TOut& out)
+{
+  RankSortedWindow<T> accumulator(first);
+  const auto count = static_cast<double>(last - first + 1);
+  sliding_order_statistic(
+      in,
+      front,
+      window,
+      shape,
+      accumulator,
+      [&](auto& a) {
+        const auto& sorted = a.sorted();
+        return static_cast<U>(std::accumulate(sorted.begin() + first, sorted.begin() + last + 1, 0.) / count);
+      },
+      out);
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -0,0 +1,132 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SPARSECORRELATION_H
+#define _LINXTRANSFORMS_IMPL_SPARSECORRELATION_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/impl/ShiftAccumulate.h"
+
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The non-zero taps of a correlation kernel.
+ *
+ * Positions are relative to the front of the bounding box of the window,
+ * such that they are all non-negative.
+ */
+template <typename T, Index N>
+struct SparseTaps {
+  /**
+   * @brief Gather the non-zero coefficients of a window.
+   * @param window The window, which is iterated to get the positions
+   * @param begin The iterator to the coefficients, ordered like the window positions
+   */
+  template <typename TWindow, typename TIt>
+  static SparseTaps from_window(const TWindow& window, TIt begin)
+  {
+    SparseTaps out;
+    const auto& bbox = box(window);
+    out.shape = bbox.shape();
+    for (const auto& p : window) {
+      const T c = *begin;
+      ++begin;
+      if (c != T()) {
+        out.positions.push_back(p - bbox.front());
+        out.weights.push_back(c);
+      }
+    }
+    return out;
+  }
+
+  Position<N> shape; ///< The bounding box shape
+  std::vector<Position<N>> positions; ///< The positions of the non-zero coefficients
+  std::vector<T> weights; ///< The non-zero coefficients
+};
+
+/**
+ * @brief Correlate a raster with sparse taps.
+ *
+ * The taps are compiled into a flat array of linear offsets for the raster strides once,
+ * and each output row is accumulated tap by tap, such that the cost is proportional to the number of non-zero taps.
+ */
+template <typename T, Index N, typename THolder, typename TOut>
+void sparse_correlate_raster(
+    const Raster<T, N, THolder>& in,
+    const Position<N>& front,
+    const SparseTaps<T, N>& taps,
+    const Position<N>& shape,
+    TOut& out)
+{
+  const auto origin = in.index(Position<N>::zero());
+  std::vector<Index> offsets;
+  offsets.reserve(taps.positions.size());
+  for (const auto& p : taps.positions) {
+    offsets.push_back(in.index(p) - origin);
+  }
+
+  const auto width = shape[0];
+  std::vector<T> acc(width);
+  auto lines_shape = shape;
+  lines_shape[0] = 1;
+  const auto* data = in.data();
+  auto out_it = out.begin();
+  for (const auto& l : Box<N>::from_shape(Position<N>::zero(), lines_shape)) {
+    std::fill(acc.begin(), acc.end(), T());
+    const auto* base = data + in.index(front + l);
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+      accumulate_row(taps.weights[i], base + offsets[i], acc.data(), width);
+    }
+    for (const auto& v : acc) {
+      *out_it = v;
+      ++out_it;
+    }
+  }
+}
+
+/**
+ * @brief Correlate a raster or extrapolator with sparse taps.
+ * @param in The input raster or extrapolator
+ * @param front The input position associated with the first output element and the front of the window box
+ * @param taps The taps
+ * @param shape The output shape
+ * @param out The output, iterated in order
+ *
+ * Extrapolated or converted inputs are first copied over the region read by the taps.
+ */
+template <typename T, typename TIn, typename TOut>
+void sparse_correlate(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const SparseTaps<T, TIn::Dimension>& taps,
+    const Position<TIn::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+  if constexpr (not is_extrapolator<TIn>() && std::is_same_v<std::decay_t<typename TIn::Value>, T>) {
+    sparse_correlate_raster(in, front, taps, shape, out);
+  } else {
+    const auto region = Box<N>::from_shape(front, shape + taps.shape - 1);
+    const auto patch = in(region);
+    Raster<T, N> raster(region.shape());
+    std::copy(patch.begin(), patch.end(), raster.begin());
+    sparse_correlate_raster(raster, Position<N>::zero(), taps, shape, out);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
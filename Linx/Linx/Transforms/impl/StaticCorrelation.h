@@ -0,0 +1,115 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_STATICCORRELATION_H
+#define _LINXTRANSFORMS_IMPL_STATICCORRELATION_H
+
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/impl/RowFetching.h"
+
+#include <array>
+#include <utility> // integer_sequence
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute an output row as the inner products of a fixed-size kernel with the input rows.
+ * @tparam Width The kernel length along axis 0
+ * @tparam Rows The number of kernel rows
+ * @param coefficients The correlation coefficients, row by row
+ * @param rows The input rows, each of `width + Width - 1` elements
+ * @param out The output row
+ * @param width The output width
+ *
+ * As the kernel shape is known at compile time, the inner loops are fully unrolled,
+ * and the outer loop is vectorized across output pixels.
+ */
+template <Index Width, Index Rows, typename T>
+LINX_KERNEL void static_correlate_row(const T* __restrict coefficients, const T* const* rows, T* __restrict out, Index width)
+{
+#pragma omp simd
+  for (Index x = 0; x < width; ++x) {
+    T sum = 0;
+    for (Index j = 0; j < Rows; ++j) {
+      for (Index i = 0; i < Width; ++i) {
+        sum += coefficients[j * Width + i] * rows[j][x + i];
+      }
+    }
+    out[x] = sum;
+  }
+}
+
+/**
+ * @brief Correlate an input raster or extrapolator with a kernel of compile-time shape.
+ * @param in The input raster or extrapolator
+ * @param front The input position associated with the first output element and first coefficient
+ * @param coefficients The correlation coefficients, ordered like the window positions
+ * @param shape The output shape
+ * @param out The output, iterated in order
+ *
+ * Like `shift_accumulate()`, input rows are read in place when possible, and fetched into row buffers otherwise,
+ * and the function is compiled for several instruction sets.
+ */
+template <typename T, Index L0, Index... Ls, std::size_t Size, typename TIn, typename TOut>
+LINX_KERNEL void static_correlate_kernel(
+    std::integer_sequence<Index, L0, Ls...>,
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const std::array<T, Size>& coefficients,
+    const Position<TIn::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  static constexpr Index Rows = (Index(1) * ... * Ls);
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  constexpr bool in_place = not is_extrapolator<TIn>() && std::is_same_v<std::decay_t<typename TIn::Value>, T>;
+  const auto width = shape[0];
+  std::array<std::vector<T>, Rows> buffers;
+  if constexpr (not in_place) {
+    for (auto& b : buffers) {
+      b.resize(width + L0 - 1);
+    }
+  }
+  std::array<const T*, Rows> rows;
+  std::vector<T> acc(width);
+
+  const auto window_rows = Box<N>::from_shape(Position<N>::zero(), Position<N> {1, Ls...});
+  auto lines_shape = shape;
+  lines_shape[0] = 1;
+  auto out_it = out.begin();
+  for (const auto& l : Box<N>::from_shape(Position<N>::zero(), lines_shape)) {
+    Index j = 0;
+    for (const auto& r : window_rows) {
+      if constexpr (in_place) {
+        rows[j] = &in[front + l + r];
+      } else {
+        fetch_row(in, front + l + r, buffers[j]);
+        rows[j] = buffers[j].data();
+      }
+      ++j;
+    }
+    static_correlate_row<L0, Rows>(coefficients.data(), rows.data(), acc.data(), width);
+    for (const auto& v : acc) {
+      *out_it = v;
+      ++out_it;
+    }
+  }
+}
+
+LINX_MULTIVERSION(static_correlate)
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -0,0 +1,245 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_IMPL_SUMMEDAREATABLE_H
+#define _LINXTRANSFORMS_IMPL_SUMMEDAREATABLE_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // max
+#include <cmath> // sqrt
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The accumulation type of summed-area tables.
+ *
+ * Integers are accumulated exactly as 64-bit integers,
+ * `float`s as `double`s, and wider floating point types as `long double`s,
+ * such that the differences of large partial sums keep the precision of the input.
+ */
+template <typename T>
+using SummedAreaValue = std::conditional_t<
+    std::is_integral_v<T>,
+    std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+    std::conditional_t<(sizeof(T) < sizeof(double)), double, long double>>;
+
+/**
+ * @brief Compute the inclusive prefix sums of a contiguous buffer along some axis.
+ */
+template <typename T, Index N>
+void prefix_sum_along(T* data, const Position<N>& shape, Index axis)
+{
+  Index stride = 1;
+  for (Index i = 0; i < axis; ++i) {
+    stride *= shape[i];
+  }
+  const auto length = shape[axis];
+  Index outer = 1;
+  for (Index i = axis + 1; i < N; ++i) {
+    outer *= shape[i];
+  }
+  for (Index o = 0; o < outer; ++o) {
+    auto* slab = data + o * stride * length;
+    for (Index j = 1; j < length; ++j) {
+      const auto* previous = slab + (j - 1) * stride;
+      auto* current = slab + j * stride;
+      for (Index s = 0; s < stride; ++s) {
+        current[s] += previous[s];
+      }
+    }
+  }
+}
+
+/**
+ * @brief The corners of a box window in a summed-area table, as index offsets and signs.
+ */
+struct SummedAreaCorners {
+  std::vector<Index> offsets; ///< The index offsets from the window front
+  std::vector<bool> positive; ///< The signs
+};
+
+/**
+ * @brief Get the corners of a box window in a padded summed-area table.
+ */
+template <typename TTable, Index N>
+SummedAreaCorners summed_area_corners(const TTable& table, const Position<N>& window)
+{
+  SummedAreaCorners out;
+  for (Index c = 0; c < (Index(1) << N); ++c) {
+    auto corner = Position<N>::zero();
+    Index count = 0;
+    for (Index i = 0; i < N; ++i) {
+      if ((c >> i) & 1) {
+        corner[i] = window[i];
+        ++count;
+      }
+    }
+    out.offsets.push_back(table.index(corner));
+    out.positive.push_back((N - count) % 2 == 0);
+  }
+  return out;
+}
+
+/**
+ * @brief Get the sum over a box window from a summed-area table.
+ * @param base The pointer to the table value at the window front
+ * @param corners The window corners
+ */
+template <typename T>
+inline T summed_area_sum(const T* base, const SummedAreaCorners& corners)
+{
+  T sum = 0;
+  for (std::size_t c = 0; c < corners.offsets.size(); ++c) {
+    if (corners.positive[c]) {
+      sum += base[corners.offsets[c]];
+    } else {
+      sum -= base[corners.offsets[c]];
+    }
+  }
+  return sum;
+}
+
+/**
+ * @brief Compute the mean filter with a box window from a summed-area table.
+ * @tparam T The output value type
+ * @param in The input raster or extrapolator
+ * @param front The input position of the window front for the first output element
+ * @param window The window shape
+ * @param shape The output shape
+ * @param out The output, iterated in order
+ *
+ * The table holds, at each position, the sum of the input values in the box which spans from the front to that position.
+ * The sum over any box is then a combination of the table values at its `2^N` corners.
+ * The table is padded with a leading zero hyperplane along each axis, which avoids bound checks.
+ */
+template <typename T, typename TIn, typename TOut>
+void summed_area_mean(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const Position<TIn::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TIn::Dimension;
+  using Sum = SummedAreaValue<T>;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  // Fill the table
+  const auto input_shape = shape + window - 1;
+  Raster<Sum, N> table(input_shape + 1);
+  const auto patch = in(Box<N>::from_shape(front, input_shape));
+  auto it = patch.begin();
+  const auto one = Position<N>::one();
+  for (const auto& p : Box<N>::from_shape(one, input_shape)) {
+    table[p] = static_cast<Sum>(*it);
+    ++it;
+  }
+  for (Index i = 0; i < N; ++i) {
+    prefix_sum_along(table.data(), table.shape(), i);
+  }
+
+  // Corner offsets and signs
+  const auto size = static_cast<Sum>(Box<N>::from_shape(Position<N>::zero(), window).size());
+  const auto corners = summed_area_corners(table, window);
+  // Combine the corners
+  const auto* data = table.data();
+  auto out_it = out.begin();
+  for (const auto& p : Box<N>::from_shape(Position<N>::zero(), shape)) {
+    const auto sum = summed_area_sum(data + table.index(p), corners);
+    *out_it = static_cast<T>(sum / size);
+    ++out_it;
+  }
+}
+
+/**
+ * @brief Compute the local mean, variance and standard deviation with a box window from summed-area tables.
+ * @tparam T The floating point output value type
+ * @param in The input raster or extrapolator
+ * @param front The input position of the window front for the first output element
+ * @param window The window shape
+ * @param shape The output shape
+ * @param mean The mean output, iterated in order
+ * @param variance The variance output, iterated in order
+ * @param stdev The standard deviation output, iterated in order
+ *
+ * Two tables are filled in a single pass over the input, of the values and of their squares.
+ * Values are shifted by their global mean beforehand, which leaves the variance unchanged,
+ * but avoids the catastrophic cancellation of `E(x^2) - E(x)^2` when the mean is large compared to the deviation.
+ * Rounding errors can still yield tiny negative variances, which are clamped to zero.
+ */
+template <typename T, typename TIn, typename TMean, typename TVariance, typename TStdev>
+void summed_area_moments(
+    const TIn& in,
+    const Position<TIn::Dimension>& front,
+    const Position<TIn::Dimension>& window,
+    const Position<TIn::Dimension>& shape,
+    TMean& mean,
+    TVariance& variance,
+    TStdev& stdev)
+{
+  static_assert(std::is_floating_point_v<T>, "Local moments must be floating point values.");
+  static constexpr Index N = TIn::Dimension;
+  using Sum = SummedAreaValue<T>;
+  for (auto l : shape) {
+    if (l <= 0) {
+      return;
+    }
+  }
+
+  // Fill the tables
+  const auto input_shape = shape + window - 1;
+  const auto patch = in(Box<N>::from_shape(front, input_shape));
+  Sum offset = 0;
+  for (const auto& e : patch) {
+    offset += static_cast<Sum>(e);
+  }
+  offset /= static_cast<Sum>(patch.size());
+  Raster<Sum, N> sums(input_shape + 1);
+  Raster<Sum, N> squares(input_shape + 1);
+  auto it = patch.begin();
+  const auto one = Position<N>::one();
+  for (const auto& p : Box<N>::from_shape(one, input_shape)) {
+    const auto v = static_cast<Sum>(*it) - offset;
+    sums[p] = v;
+    squares[p] = v * v;
+    ++it;
+  }
+  for (Index i = 0; i < N; ++i) {
+    prefix_sum_along(sums.data(), sums.shape(), i);
+    prefix_sum_along(squares.data(), squares.shape(), i);
+  }
+
+  // Combine the corners
+  const auto size = static_cast<Sum>(Box<N>::from_shape(Position<N>::zero(), window).size());
+  const auto corners = summed_area_corners(sums, window);
+  auto mean_it = mean.begin();
+  auto variance_it = variance.begin();
+  auto stdev_it = stdev.begin();
+  for (const auto& p : Box<N>::from_shape(Position<N>::zero(), shape)) {
+    const auto index = sums.index(p);
+    const auto m = summed_area_sum(sums.data() + index, corners) / size;
+    const auto v = std::max(Sum(0), summed_area_sum(squares.data() + index, corners) / size - m * m);
+    *mean_it = static_cast<T>(m + offset);
+    *variance_it = static_cast<T>(v);
+    *stdev_it = static_cast<T>(std::sqrt(v));
+    ++mean_it;
+    ++variance_it;
+    ++stdev_it;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+} // namespace Linx
+
+#endif
@@ -9,10 +9,62 @@
 #include "Linx/Data/Box.h"
 #include "Linx/Data/Grid.h"
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/StridedRaster.h"
+#include "Linx/Data/VirtualRaster.h"
 #include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/PaddedRaster.h"
+
+#include <algorithm> // copy, transform
+#include <vector>
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief The maximum number of values of the bands of virtual rasters which are generated for filtering.
+ */
+constexpr Index VirtualBandSize = Index(1) << 18;
+
+/**
+ * @brief Check whether a box contains at least one position.
+ */
+template <Index N>
+bool is_nonempty(const Box<N>& region)
+{
+  for (Index i = 0; i < region.dimension(); ++i) {
+    if (region.length(i) <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Replace overlapping boxes with their bounding box, until no boxes overlap.
+ */
+template <Index N>
+void merge_overlapping(std::vector<Box<N>>& regions)
+{
+  for (bool merged = true; merged;) {
+    merged = false;
+    for (std::size_t i = 0; i < regions.size() && not merged; ++i) {
+      for (std::size_t j = i + 1; j < regions.size(); ++j) {
+        if (is_nonempty(regions[i] & regions[j])) {
+          regions[i] |= regions[j];
+          regions.erase(regions.begin() + j);
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief Spatial filtering mixin.
@@ -55,27 +107,105 @@ public:
 
   /**
    * @brief Apply the filter into a given output.
+   * 
+   * The output is a raster or patch of the shape of `operator*()`'s output, which is overwritten.
+   * Reusing an output from one call to the next avoids allocating it,
+   * and intermediate rasters are pooled (see `MemoryPool`), such that steady-state runs do not allocate.
    */
   template <typename TIn, typename TOut>
   inline void transform(const TIn& in, TOut& out) const
   {
-    // FIXME make applicable to Sequence<Position>?
     LINX_CRTP_CONST_DERIVED.transform_impl(in, out);
   }
 
+  /**
+   * @brief Apply the filter to a single pixel into a given output of size one.
+   */
+  template <typename U, typename UParent, typename TOut>
+  void transform(const Patch<U, UParent, Position<UParent::Dimension>>& in, TOut& out) const
+  {
+    const auto patch = in.parent()(Box<UParent::Dimension>(in.domain(), in.domain())); // Position to Box
+    transform(patch, out);
+  }
+
+  /**
+   * @brief Apply the filter to a sequence of pixels into a given output of the same size.
+   */
+  template <typename U, typename UParent, typename UHolder, typename TOut>
+  void transform(const Patch<U, UParent, Sequence<Position<UParent::Dimension>, UHolder>>& in, TOut& out) const
+  {
+    SizeError::may_throw(out.size(), in.size());
+    std::transform(in.domain().begin(), in.domain().end(), out.begin(), [&](const auto& p) {
+      return (*this) * in.parent()(p);
+    });
+  }
+
+  /**
+   * @brief Recompute the output of the filter where the input changed.
+   * @param in The input raster or extrapolated raster
+   * @param changed The changed regions of the input
+   * @param out The output, previously computed as `*this * in`, which is updated in place
+   *
+   * The changed regions are dilated by the window and clamped to the output domain,
+   * and the overlapping regions are merged, such that each affected output region is recomputed once,
+   * and the rest of the output is left untouched.
+   * The cost is therefore proportional to the affected area instead of the output area,
+   * e.g. for interactive edits of small regions of large images.
+   */
+  template <typename TIn, typename TOut>
+  TOut& update(const TIn& in, const std::vector<Box<TIn::Dimension>>& changed, TOut& out) const
+  {
+    static constexpr Index N = TIn::Dimension;
+    const auto w = extend<N>(box(window())); // Copy, since FilterSeq::window() returns a temporary
+    const auto shift = is_extrapolator<TIn>() ? Position<N>::zero() : -w.front(); // Output to input positions
+    std::vector<Box<N>> regions;
+    for (const auto& c : changed) {
+      const auto r = Box<N>(c.front() - shift - w.back(), c.back() - shift - w.front()) & out.domain();
+      if (Internal::is_nonempty(r)) {
+        regions.push_back(r);
+      }
+    }
+    Internal::merge_overlapping(regions);
+    for (const auto& r : regions) {
+      const auto source = r + shift + w;
+      Raster<std::decay_t<typename TIn::Value>, N> patch(source.shape());
+      if constexpr (is_extrapolator<TIn>()) {
+        in.copy_to(source, patch);
+      } else {
+        const auto p = in(source);
+        std::copy(p.begin(), p.end(), patch.begin());
+      }
+      const auto filtered = *this * patch;
+      auto dst = out(r);
+      std::copy(filtered.begin(), filtered.end(), dst.begin());
+    }
+    return out;
+  }
+
   /**
    * @brief Apply the filter with cropping.
    */
   template <typename U, Index N, typename UHolder>
   Raster<Value, N> operator*(const Raster<U, N, UHolder>& in) const
   {
-    const auto& w = box(window());
+    const auto w = box(window()); // Copy, since FilterSeq::window() returns a temporary
     const auto shape = in.shape() - extend<N>(w.shape() - 1);
     Raster<Value, N> out(shape);
     transform(in, out);
     return out;
   }
 
+  /**
+   * @brief Apply the filter with cropping to a strided view.
+   * 
+   * The view is first copied to a contiguous temporary raster, such that the filter runs on contiguous rows.
+   */
+  template <typename U, Index N>
+  Raster<Value, N> operator*(const StridedRaster<U, N>& in) const
+  {
+    return *this * Raster<std::remove_const_t<U>, N>(in.shape(), in);
+  }
+
   /**
    * @brief Apply the filter with extrapolation.
    */
@@ -87,6 +217,54 @@ public:
     return out;
   }
 
+  /**
+   * @brief Apply the filter to a padded raster, whose halo must cover the window.
+   * 
+   * The output raster has the logical shape of the input.
+   */
+  template <typename U, Index N>
+  Raster<Value, N> operator*(const PaddedRaster<U, N>& in) const
+  {
+    const auto w = extend<N>(box(window()));
+    const auto& halo = in.halo();
+    for (Index i = 0; i < N; ++i) {
+      const auto bounds = std::make_pair(-halo[i], halo[i]);
+      OutOfBoundsError::may_throw("Window front along axis " + std::to_string(i) + ": ", w.front()[i], bounds);
+      OutOfBoundsError::may_throw("Window back along axis " + std::to_string(i) + ": ", w.back()[i], bounds);
+    }
+    Raster<Value, N> out(in.shape());
+    transform(in, out);
+    return out;
+  }
+
+  /**
+   * @brief Apply the filter to a virtual raster.
+   * 
+   * Since virtual rasters are defined everywhere, the output has the shape of the input, without extrapolation.
+   * The input is generated band by band along the last axis, with margins of the window size,
+   * such that the temporary memory is bounded whatever the raster size.
+   */
+  template <typename UFunc, Index N>
+  Raster<Value, N> operator*(const VirtualRaster<UFunc, N>& in) const
+  {
+    const auto w = extend<N>(box(window()));
+    Raster<Value, N> out(in.shape());
+    const auto length = in.shape()[N - 1];
+    const auto slab = length > 0 ? shape_size(in.shape() + w.shape() - 1) / (length + w.shape()[N - 1] - 1) : 0;
+    const auto rows = std::max<Index>(1, Internal::VirtualBandSize / std::max<Index>(1, slab) - w.shape()[N - 1] + 1);
+    for (Index front = 0; front < length; front += rows) {
+      auto f = out.domain().front();
+      auto b = out.domain().back();
+      f[N - 1] = front;
+      b[N - 1] = std::min(front + rows, length) - 1;
+      const Box<N> r(f, b);
+      const auto filtered = *this * in(r + w).eval();
+      auto dst = out(r);
+      std::copy(filtered.begin(), filtered.end(), dst.begin());
+    }
+    return out;
+  }
+
   /**
    * @brief Apply the filter to a box-, line- or grid-based patch.
    */
@@ -107,8 +285,7 @@ public:
   Value operator*(const Patch<U, UParent, Position<UParent::Dimension>>& in) const
   {
     Raster<Value, UParent::Dimension, StdHolder<std::array<Value, 1>>> out(Position<UParent::Dimension>::one());
-    const auto patch = in.parent()(Box<UParent::Dimension>(in.domain(), in.domain())); // Position to Box
-    transform(patch, out);
+    transform(in, out);
     return out[0];
   }
 
@@ -119,9 +296,7 @@ public:
   Sequence<Value> operator*(const Patch<U, UParent, Sequence<Position<UParent::Dimension>, UHolder>>& in) const
   {
     Sequence<Value> out(in.size());
-    std::transform(in.domain().begin(), in.domain().end(), out.begin(), [&](const auto& p) {
-      return (*this) * in.parent()(p);
-    });
+    transform(in, out);
     return out;
   }
 };
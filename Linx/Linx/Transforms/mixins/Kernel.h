@@ -6,12 +6,28 @@
 #define _LINXTRANSFORMS_MIXINS_KERNEL_H
 
 #include "Linx/Base/TypeUtils.h"
+#include "Linx/Transforms/impl/SeparableCorrelation.h"
+#include "Linx/Transforms/impl/ShiftAccumulate.h"
+#include "Linx/Transforms/impl/SparseCorrelation.h"
 #include "Linx/Transforms/mixins/StructuringElement.h"
 
 #include <initializer_list>
 
 namespace Linx {
 
+/**
+ * @ingroup filtering
+ * @brief The computation strategies of kernel-based filters.
+ */
+enum class KernelStrategy {
+  Automatic, ///< Separable if possible, shift-and-accumulate for other box windows, sparse for other windows
+  Direct, ///< Inner product of the kernel and neighborhood at each pixel
+  Separable, ///< Sequence of 1D correlations with line buffers, for rank-one kernels
+  ShiftAccumulate, ///< Vectorized accumulation of shifted and scaled input rows, for box windows
+  Sparse, ///< Like shift-and-accumulate, for the non-zero coefficients only, with precomputed offsets
+  Measure ///< Fastest strategy for the input, as timed by the `FilterPlanner` when used in a `SimpleFilter`
+};
+
 /**
  * @brief Mixin for kernel-based filters.
  */
@@ -44,12 +60,183 @@ public:
       KernelMixin(LINX_MOVE(window), LINX_FORWARD(values).begin(), LINX_FORWARD(values).end())
   {}
 
+  /**
+   * @brief Get the kernel values, ordered like the window positions.
+   */
+  const std::vector<T>& values() const
+  {
+    return m_values;
+  }
+
+  /**
+   * @brief Get the rank-one decomposition of the kernel, which is empty if the kernel is not separable.
+   *
+   * The decomposition is computed at construction for box windows and real values only.
+   */
+  const Internal::SeparableCorrelation<TWindow::Dimension>& separable() const
+  {
+    return m_separable;
+  }
+
+  /**
+   * @brief Set the computation strategy.
+   *
+   * If the requested strategy is not applicable to the kernel, the automatic strategy is used instead.
+   */
+  TDerived& strategy(KernelStrategy value)
+  {
+    m_strategy = value;
+    return LINX_CRTP_DERIVED;
+  }
+
+  /**
+   * @brief Get the requested computation strategy, which may not be applicable.
+   */
+  KernelStrategy requested_strategy() const
+  {
+    return m_strategy;
+  }
+
+  /**
+   * @brief Get the effective computation strategy.
+   *
+   * The `Measure` strategy is resolved by `SimpleFilter`, and is equivalent to the automatic strategy here.
+   * Kernels which are not decomposed by `init_impl()`, e.g. non-linear kernels, are always direct.
+   */
+  KernelStrategy strategy() const
+  {
+    if constexpr (not std::is_arithmetic_v<T>) {
+      return KernelStrategy::Direct;
+    } else {
+      if (not m_decomposed) {
+        return KernelStrategy::Direct;
+      }
+      const bool shiftable = std::is_same_v<std::decay_t<TWindow>, Box<TWindow::Dimension>>;
+      switch (m_strategy) {
+        case KernelStrategy::Direct:
+        case KernelStrategy::Sparse:
+          return m_strategy;
+        case KernelStrategy::ShiftAccumulate:
+          if (shiftable) {
+            return m_strategy;
+          }
+          break;
+        default:
+          break;
+      }
+      if (m_separable) {
+        return KernelStrategy::Separable;
+      }
+      return shiftable ? KernelStrategy::ShiftAccumulate : KernelStrategy::Sparse;
+    }
+  }
+
+  /**
+   * @brief Check whether `transform_region()` is applicable, i.e. whether the strategy is not direct.
+   */
+  bool transforms_region() const
+  {
+    return strategy() != KernelStrategy::Direct;
+  }
+
+  /**
+   * @brief Filter a whole region with the separable, shift-and-accumulate or sparse engine.
+   * @see `SimpleFilter`
+   */
+  template <typename TIn, typename TOut, std::enable_if_t<TIn::Dimension == TWindow::Dimension>* = nullptr>
+  void transform_region(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    if constexpr (std::is_arithmetic_v<T>) {
+      switch (strategy()) {
+        case KernelStrategy::Separable:
+          m_separable.correlate(in, front, shape, out);
+          break;
+        case KernelStrategy::ShiftAccumulate:
+          Internal::shift_accumulate(in, front, box(this->window()).shape(), m_coefficients, shape, out);
+          break;
+        default:
+          Internal::sparse_correlate(in, front, m_sparse, shape, out);
+      }
+    }
+  }
+
+  /**
+   * @brief Check whether `transform_grid()` is applicable, i.e. whether the strategy is separable.
+   */
+  bool transforms_grid() const
+  {
+    return strategy() == KernelStrategy::Separable;
+  }
+
+  /**
+   * @brief Filter and decimate a whole region with the separable engine.
+   * @param step The decimation step along each axis
+   * @see `SimpleFilter`
+   */
+  template <typename TIn, typename TOut, std::enable_if_t<TIn::Dimension == TWindow::Dimension>* = nullptr>
+  void transform_grid(
+      const TIn& in,
+      const Position<TIn::Dimension>& front,
+      const Position<TIn::Dimension>& step,
+      const Position<TIn::Dimension>& shape,
+      TOut& out) const
+  {
+    if constexpr (std::is_arithmetic_v<T>) {
+      m_separable.correlate(in, front, step, shape, out);
+    }
+  }
+
 protected:
 
+  /**
+   * @brief Store and decompose the kernel given its correlation coefficients.
+   */
+  template <typename TIt>
+  void decompose(TIt begin)
+  {
+    if constexpr (std::is_arithmetic_v<T>) {
+      m_sparse = Internal::SparseTaps<T, TWindow::Dimension>::from_window(this->window(), begin);
+    }
+    if constexpr (std::is_same_v<TWindow, Box<TWindow::Dimension>> && std::is_arithmetic_v<T>) {
+      m_coefficients.assign(begin, begin + m_values.size());
+      m_separable = Internal::SeparableCorrelation<TWindow::Dimension>::decompose(this->window(), begin);
+    }
+    m_decomposed = true;
+  }
+
   /**
    * @brief The kernel values.
    */
   std::vector<T> m_values;
+
+  /**
+   * @brief The correlation coefficients, for box windows and real values only.
+   */
+  std::vector<T> m_coefficients;
+
+  /**
+   * @brief The non-zero coefficients and their positions, for real values only.
+   */
+  Internal::SparseTaps<T, TWindow::Dimension> m_sparse;
+
+  /**
+   * @brief The rank-one decomposition.
+   */
+  Internal::SeparableCorrelation<TWindow::Dimension> m_separable;
+
+  /**
+   * @brief The requested strategy.
+   */
+  KernelStrategy m_strategy = KernelStrategy::Automatic;
+
+  /**
+   * @brief Whether the kernel has been decomposed, i.e. whether it is a linear kernel.
+   */
+  bool m_decomposed = false;
 };
 
 } // namespace Linx
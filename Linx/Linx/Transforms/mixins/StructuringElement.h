@@ -22,7 +22,7 @@ public:
   /**
    * @brief The kernel dimension.
    */
-  static constexpr Index Dimension = TWindow::Dimension;
+  static constexpr Index Dimension = std::decay_t<TWindow>::Dimension;
 
   /**
    * @brief The kernel window type.
@@ -4,3 +4,11 @@
 
 #include "Linx/Data/Raster.h"
 #include "Linx/Data/Sequence.h"
+
+namespace Linx {
+
+#define LINX_INSTANTIATE_RASTER(T, N) template class Raster<T, N>;
+LINX_PRECOMPILED_RASTERS(LINX_INSTANTIATE_RASTER)
+#undef LINX_INSTANTIATE_RASTER
+
+} // namespace Linx
@@ -4,3 +4,17 @@
 
 #include "Linx/Transforms/Affinity.h"
 #include "Linx/Transforms/Filters.h"
+
+namespace Linx {
+
+#define LINX_INSTANTIATE_KERNELS(T, N) \
+  template class Correlation<T, Box<N>>; \
+  template class Convolution<T, Box<N>>;
+LINX_PRECOMPILED_KERNELS(LINX_INSTANTIATE_KERNELS)
+#undef LINX_INSTANTIATE_KERNELS
+
+#define LINX_INSTANTIATE_AFFINITY(N) template class Affinity<N>;
+LINX_PRECOMPILED_DIMENSIONS(LINX_INSTANTIATE_AFFINITY)
+#undef LINX_INSTANTIATE_AFFINITY
+
+} // namespace Linx
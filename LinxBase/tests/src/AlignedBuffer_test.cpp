@@ -59,6 +59,40 @@ BOOST_AUTO_TEST_CASE(release_reset_test)
   BOOST_TEST(not owner.begin());
 }
 
+BOOST_AUTO_TEST_CASE(uninitialized_huge_page_test)
+{
+  AlignedBuffer<float> buffer(1000, uninitialized, huge_page_size);
+  BOOST_TEST(buffer.owns());
+  BOOST_TEST(buffer.end() - buffer.begin() == 1000);
+  BOOST_TEST(buffer.alignment_req() == huge_page_size);
+  BOOST_TEST(is_aligned(buffer.begin(), huge_page_size));
+}
+
+BOOST_AUTO_TEST_CASE(resize_test)
+{
+  AlignedBuffer<int> buffer(10, uninitialized, 64);
+  for (int i = 0; i < 10; ++i) {
+    const_cast<int*>(buffer.begin())[i] = i;
+  }
+  const auto* data = buffer.begin();
+  BOOST_TEST(buffer.capacity() == 16); // 64 bytes
+  buffer.resize(16);
+  BOOST_TEST(buffer.begin() == data);
+  BOOST_TEST(buffer.end() - buffer.begin() == 16);
+  buffer.resize(4);
+  BOOST_TEST(buffer.begin() == data);
+  buffer.resize(100);
+  BOOST_TEST(buffer.owns());
+  BOOST_TEST(buffer.capacity() == 112);
+  BOOST_TEST(buffer.alignment_req() == 64);
+  BOOST_TEST(is_aligned(buffer.begin(), 64));
+  BOOST_TEST(buffer.begin()[3] == 3);
+  AlignedBuffer<int> viewer(4, const_cast<int*>(buffer.begin()));
+  BOOST_CHECK_NO_THROW(viewer.resize(2));
+  BOOST_CHECK_THROW(viewer.resize(5), Exception);
+}
+
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Conversion.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Conversion_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(widening_test)
+{
+  const std::vector<std::int16_t> in {-32768, -1, 0, 1, 32767};
+  std::vector<float> out(in.size());
+  convert_n(in.data(), in.size(), out.data(), 2., 32768.);
+  const std::vector<float> expected {-32768, 32766, 32768, 32770, 98302};
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(saturating_narrowing_test)
+{
+  const std::vector<float> in {-1e6, -32768.6, -2.5, -2.4, 0, 2.4, 2.5, 32767.4, 1e6};
+  std::vector<std::int16_t> out(in.size());
+  convert_n(in.data(), in.size(), out.data());
+  const std::vector<std::int16_t> expected {-32768, -32768, -3, -2, 0, 2, 3, 32767, 32767};
+  BOOST_TEST(out == expected);
+  std::vector<std::uint16_t> unsigned_out(in.size());
+  convert_n(in.data(), in.size(), unsigned_out.data());
+  BOOST_TEST(unsigned_out[0] == 0);
+  BOOST_TEST(unsigned_out[6] == 3);
+  BOOST_TEST(unsigned_out[8] == 65535);
+}
+
+BOOST_AUTO_TEST_CASE(large_integers_test)
+{
+  const std::vector<double> in {-1e30, 1e30, 42};
+  std::vector<std::int64_t> out(in.size());
+  convert_n(in.data(), in.size(), out.data());
+  BOOST_TEST(out[0] == std::numeric_limits<std::int64_t>::min());
+  BOOST_TEST(out[1] == std::numeric_limits<std::int64_t>::max());
+  BOOST_TEST(out[2] == 42);
+}
+
+BOOST_AUTO_TEST_CASE(quantize_roundtrip_test)
+{
+  const std::vector<std::uint16_t> raw {0, 1, 1000, 65535};
+  const double bscale = 0.5;
+  const double bzero = 32768;
+  std::vector<double> physical(raw.size());
+  convert_n(raw.data(), raw.size(), physical.data(), bscale, bzero);
+  BOOST_TEST(physical[2] == 33268);
+  std::vector<std::uint16_t> back(raw.size());
+  quantize_n(physical.data(), physical.size(), back.data(), bscale, bzero);
+  BOOST_TEST(back == raw);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/CowHolder.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(CowHolder_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(construction_test)
+{
+  CowHolder<int> zeros(3);
+  BOOST_TEST(zeros.end() - zeros.begin() == 3);
+  BOOST_TEST(zeros.begin()[2] == 0);
+  BOOST_TEST(zeros.use_count() == 1);
+  BOOST_TEST(not zeros.is_shared());
+  const int values[] = {1, 2, 3};
+  CowHolder<int> holder(3, values);
+  BOOST_TEST(holder.begin()[2] == 3);
+  CowHolder<int> uninit(3, uninitialized);
+  BOOST_TEST(uninit.end() - uninit.begin() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(shared_copy_test)
+{
+  const int values[] = {1, 2, 3};
+  CowHolder<int> holder(3, values);
+  const auto* address = holder.begin();
+  auto copy = holder;
+  BOOST_TEST(copy.begin() == address);
+  BOOST_TEST(holder.use_count() == 2);
+  BOOST_TEST(copy.is_shared());
+  copy.detach();
+  BOOST_TEST(copy.begin() != address);
+  BOOST_TEST(copy.begin()[2] == 3);
+  BOOST_TEST(not copy.is_shared());
+  BOOST_TEST(not holder.is_shared());
+  holder.detach();
+  BOOST_TEST(holder.begin() == address); // Not shared anymore
+}
+
+BOOST_AUTO_TEST_CASE(move_test)
+{
+  CowHolder<int> holder(3);
+  const auto* address = holder.begin();
+  CowHolder<int> moved(std::move(holder));
+  BOOST_TEST(moved.begin() == address);
+  BOOST_TEST(not moved.is_shared());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
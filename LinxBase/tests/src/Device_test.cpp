@@ -0,0 +1,88 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Device.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Device_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(device_count_test)
+{
+  BOOST_TEST(device_count() >= 0);
+  BOOST_TEST(device_available() == (device_count() > 0));
+}
+
+BOOST_AUTO_TEST_CASE(unmapped_apply_test)
+{
+  Raster<float> raster({4, 3});
+  raster.range();
+  device_apply(raster, [](auto e) {
+    return 2 * e + 1;
+  });
+  for (Index i = 0; i < static_cast<Index>(raster.size()); ++i) {
+    BOOST_TEST(raster[i] == 2 * i + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mapped_chain_test)
+{
+  Raster<float> raw({5, 4});
+  raw.range();
+  Raster<float> flat({5, 4});
+  flat.fill(2);
+  Raster<float> out({5, 4});
+  {
+    DeviceMapping<Raster<float>> d_raw(raw);
+    DeviceMapping<const Raster<float>> d_flat(flat);
+    DeviceMapping<Raster<float>> d_out(out, false);
+    BOOST_TEST(d_out.size() == static_cast<Index>(out.size()));
+    device_generate(
+        out,
+        [](auto e, auto f) {
+          return e * f;
+        },
+        raw,
+        flat);
+    device_apply(out, [](auto e) {
+      return e - 1;
+    });
+    d_out.download_async();
+    d_out.wait();
+  }
+  for (Index i = 0; i < static_cast<Index>(out.size()); ++i) {
+    BOOST_TEST(out[i] == 2 * i - 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(upload_test)
+{
+  Raster<int> in({3, 3});
+  Raster<int> out({3, 3});
+  DeviceMapping<Raster<int>> d_in(in);
+  DeviceMapping<Raster<int>> d_out(out, false);
+  in.fill(7);
+  d_in.upload();
+  device_generate(
+      out,
+      [](auto e) {
+        return -e;
+      },
+      in);
+  d_out.download();
+  for (auto e : out) {
+    BOOST_TEST(e == -7);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Conversion.h"
+#include "Linx/Base/Dispatch.h"
+#include "Linx/Base/FastMath.h"
+#include "Linx/Base/Reduction.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace Linx;
+
+/**
+ * @brief Restore the active instruction set at scope exit.
+ */
+struct InstructionSetGuard {
+  InstructionSetGuard() : set(instruction_set()) {}
+  ~InstructionSetGuard()
+  {
+    select_instruction_set(set);
+  }
+  InstructionSet set;
+};
+
+/**
+ * @brief The instruction sets supported by the processor.
+ */
+std::vector<InstructionSet> supported_sets()
+{
+  std::vector<InstructionSet> out;
+  for (auto set : {InstructionSet::Baseline, InstructionSet::Avx2, InstructionSet::Avx512, InstructionSet::Sve}) {
+    if (supports_instruction_set(set)) {
+      out.push_back(set);
+    }
+  }
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Dispatch_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(detection_test)
+{
+  BOOST_TEST(supports_instruction_set(InstructionSet::Baseline));
+  BOOST_TEST(supports_instruction_set(detect_instruction_set()));
+  BOOST_TEST(supports_instruction_set(instruction_set()));
+  BOOST_TEST(instruction_set_report().find(instruction_set_name(instruction_set())) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(selection_test)
+{
+  InstructionSetGuard guard;
+  select_instruction_set("baseline");
+  BOOST_TEST((instruction_set() == InstructionSet::Baseline));
+  BOOST_TEST(instruction_set_report().find("selected") != std::string::npos);
+  select_instruction_set("auto");
+  BOOST_TEST((instruction_set() == detect_instruction_set()));
+  BOOST_CHECK_THROW(select_instruction_set("mmx"), Exception);
+  for (auto set : {InstructionSet::Avx2, InstructionSet::Avx512, InstructionSet::Sve}) {
+    if (not supports_instruction_set(set)) {
+      BOOST_CHECK_THROW(select_instruction_set(set), Exception);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(variants_agree_test)
+{
+  InstructionSetGuard guard;
+  std::vector<double> in(1001);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = 0.01 * i - 5;
+  }
+  std::vector<std::vector<double>> exps;
+  std::vector<std::vector<short>> shorts;
+  std::vector<double> sums;
+  for (auto set : supported_sets()) {
+    select_instruction_set(set);
+    auto e = in;
+    fast_exp(e.data(), e.size());
+    exps.push_back(e);
+    std::vector<short> s(in.size());
+    convert_n(in.data(), in.size(), s.data(), 1000., 3.);
+    shorts.push_back(s);
+    sums.push_back(transform_sum<double>(
+        Summation::Lanes,
+        [](auto e, auto f) {
+          return e * f;
+        },
+        in,
+        in));
+  }
+  for (std::size_t i = 1; i < exps.size(); ++i) {
+    for (std::size_t j = 0; j < in.size(); ++j) {
+      BOOST_TEST(exps[i][j] == exps[0][j], boost::test_tools::tolerance(1.e-14));
+    }
+    BOOST_TEST(shorts[i] == shorts[0], boost::test_tools::per_element());
+    BOOST_TEST(sums[i] == sums[0], boost::test_tools::tolerance(1.e-12));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/FastMath.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FastMath_test)
+
+//-----------------------------------------------------------------------------
+
+template <typename T>
+T ulp_error(T value, long double expected)
+{
+  const auto reference = static_cast<T>(expected);
+  if (value == reference) {
+    return 0;
+  }
+  const auto ulp = std::nextafter(reference, std::numeric_limits<T>::infinity()) - reference;
+  return static_cast<T>(std::abs(value - expected) / ulp);
+}
+
+template <typename T, typename TFast, typename TRef>
+T max_ulp_error(TFast fast, TRef reference, T min, T max)
+{
+  T out = 0;
+  constexpr int count = 10000;
+  for (int i = 0; i <= count; ++i) {
+    const auto x = min + (max - min) * i / count;
+    out = std::max(out, ulp_error(fast(x), reference(static_cast<long double>(x))));
+  }
+  return out;
+}
+
+template <typename T>
+void check_accuracy()
+{
+  // clang-format off
+  BOOST_TEST(max_ulp_error<T>([](T x) { return fast_exp(x); }, [](long double x) { return std::exp(x); },
+      -80, 80) <= 1.5);
+  BOOST_TEST(max_ulp_error<T>([](T x) { return fast_log(x); }, [](long double x) { return std::log(x); },
+      1e-30, 1e30) <= 1.5);
+  BOOST_TEST(max_ulp_error<T>([](T x) { return fast_log(x); }, [](long double x) { return std::log(x); },
+      0.5, 2) <= 1.5);
+  BOOST_TEST(max_ulp_error<T>([](T x) { return fast_sin(x); }, [](long double x) { return std::sin(x); },
+      -1000, 1000) <= 3);
+  BOOST_TEST(max_ulp_error<T>([](T x) { return fast_cos(x); }, [](long double x) { return std::cos(x); },
+      -1000, 1000) <= 3);
+  // clang-format on
+}
+
+BOOST_AUTO_TEST_CASE(float_accuracy_test)
+{
+  check_accuracy<float>();
+}
+
+BOOST_AUTO_TEST_CASE(double_accuracy_test)
+{
+  check_accuracy<double>();
+}
+
+template <typename T>
+void check_special_values()
+{
+  const auto inf = std::numeric_limits<T>::infinity();
+  const auto nan = std::numeric_limits<T>::quiet_NaN();
+  const auto denorm = std::numeric_limits<T>::denorm_min();
+  BOOST_TEST(fast_exp(T(0)) == 1);
+  BOOST_TEST(fast_exp(inf) == inf);
+  BOOST_TEST(fast_exp(-inf) == 0);
+  BOOST_TEST(fast_exp(T(1000)) == inf);
+  BOOST_TEST(fast_exp(T(-1000)) == 0);
+  BOOST_TEST(std::isnan(fast_exp(nan)));
+  BOOST_TEST(fast_log(T(1)) == 0);
+  BOOST_TEST(fast_log(T(0)) == -inf);
+  BOOST_TEST(fast_log(inf) == inf);
+  BOOST_TEST(std::isnan(fast_log(T(-1))));
+  BOOST_TEST(std::isnan(fast_log(nan)));
+  BOOST_TEST(ulp_error(fast_log(denorm), std::log(static_cast<long double>(denorm))) <= 1);
+  BOOST_TEST(fast_sin(T(0)) == 0);
+  BOOST_TEST(fast_cos(T(0)) == 1);
+  BOOST_TEST(std::isnan(fast_sin(inf)));
+  BOOST_TEST(std::isnan(fast_cos(nan)));
+}
+
+BOOST_AUTO_TEST_CASE(float_special_values_test)
+{
+  check_special_values<float>();
+}
+
+BOOST_AUTO_TEST_CASE(double_special_values_test)
+{
+  check_special_values<double>();
+}
+
+BOOST_AUTO_TEST_CASE(kernel_equals_scalar_test)
+{
+  std::vector<double> values(1000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.01 * i - 5;
+  }
+  auto out = values;
+  fast_exp(out.data(), out.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    BOOST_TEST(out[i] == fast_exp(values[i]));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Half.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Half_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(half_roundtrip_test)
+{
+  static_assert(sizeof(Half) == 2);
+  for (std::uint32_t b = 0; b < 0x10000; ++b) {
+    const auto h = Half::from_bits(static_cast<std::uint16_t>(b));
+    const float f = h;
+    if (std::isnan(f)) {
+      BOOST_TEST((b & 0x7C00) == 0x7C00);
+      BOOST_TEST(std::isnan(float(Half(f))));
+    } else {
+      BOOST_TEST(Half(f).bits() == b);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(half_rounding_test)
+{
+  BOOST_TEST(float(Half(1.F)) == 1.F);
+  BOOST_TEST(float(Half(65504.F)) == 65504.F);
+  BOOST_TEST(std::isinf(float(Half(65520.F)))); // Rounded up to infinity
+  BOOST_TEST(float(Half(65519.F)) == 65504.F);
+  BOOST_TEST(float(Half(1.F + 1.F / 2048)) == 1.F); // Tie to even
+  BOOST_TEST(float(Half(1.F + 3.F / 2048)) == 1.F + 2.F / 1024); // Tie to even
+  BOOST_TEST(float(Half(std::ldexp(1.F, -24))) == std::ldexp(1.F, -24)); // Smallest subnormal
+  BOOST_TEST(float(Half(std::ldexp(1.F, -26))) == 0.F);
+  BOOST_TEST(float(Half(-2.5F)) == -2.5F);
+  BOOST_TEST(float(std::numeric_limits<Half>::max()) == 65504.F);
+  BOOST_TEST(float(std::numeric_limits<Half>::epsilon()) == std::ldexp(1.F, -10));
+  BOOST_TEST(std::isinf(float(Limits<Half>::inf())));
+}
+
+BOOST_AUTO_TEST_CASE(bfloat16_test)
+{
+  static_assert(sizeof(BFloat16) == 2);
+  BOOST_TEST(float(BFloat16(1.F)) == 1.F);
+  BOOST_TEST(float(BFloat16(1.F + 1.F / 256)) == 1.F); // Tie to even
+  BOOST_TEST(float(BFloat16(1.F + 3.F / 256)) == 1.F + 2.F / 128); // Tie to even
+  BOOST_TEST(float(BFloat16(3e38F)) == 3e38F, boost::test_tools::tolerance(4e-3F));
+  BOOST_TEST(std::isnan(float(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+  BOOST_TEST(std::isinf(float(std::numeric_limits<BFloat16>::infinity())));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_conversion_test)
+{
+  std::vector<float> in(21);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = 0.1F * i - 1;
+  }
+  std::vector<Half> half(in.size());
+  convert_n(in.data(), in.size(), half.data());
+  std::vector<float> out(in.size());
+  convert_n(half.data(), half.size(), out.data());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(half[i].bits() == Half(in[i]).bits());
+    BOOST_TEST(out[i] == in[i], boost::test_tools::tolerance(1e-3F));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(raster_arithmetic_test)
+{
+  Raster<Half, 1> a({4}, {1, 2, 3, 4});
+  Raster<Half, 1> b({4}, {0.5, 0.25, 0.125, 1});
+  a *= b;
+  a += 1;
+  BOOST_TEST(float(a[0]) == 1.5F);
+  BOOST_TEST(float(a[3]) == 5.F);
+  BOOST_TEST(sum(a) == 1.5 + 1.5 + 1.375 + 5);
+  const auto c = a / 2;
+  BOOST_TEST(float(c[0]) == 0.75F);
+  const auto d = sqrt(c);
+  BOOST_TEST(float(d[3]) == std::sqrt(2.5F), boost::test_tools::tolerance(1e-3F));
+  const auto f = convert<float>(d);
+  BOOST_TEST(f[3] == float(d[3]));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
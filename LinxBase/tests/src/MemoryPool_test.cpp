@@ -0,0 +1,91 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/MemoryPool.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint> // uintptr_t
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MemoryPool_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(recycling_test)
+{
+  MemoryPool::clear();
+  const auto used = MemoryPool::in_use();
+  const void* address = nullptr;
+  {
+    PoolHolder<float> holder(1000);
+    address = holder.begin();
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(address) % MemoryPool::Alignment == 0);
+    BOOST_TEST(holder.end() - holder.begin() == 1000);
+    BOOST_TEST(holder.begin()[999] == 0);
+    BOOST_TEST(MemoryPool::in_use() == used + MemoryPool::block_size(4000));
+  }
+  BOOST_TEST(MemoryPool::in_use() == used);
+  BOOST_TEST(MemoryPool::cached() == MemoryPool::block_size(4000));
+  PoolHolder<int> same_size(1000);
+  BOOST_TEST(same_size.begin() == address);
+  BOOST_TEST(MemoryPool::cached() == 0);
+  PoolHolder<int> other_size(2000);
+  BOOST_TEST(other_size.begin() != address);
+}
+
+BOOST_AUTO_TEST_CASE(copy_move_test)
+{
+  const int values[] = {1, 2, 3};
+  PoolHolder<int> holder(3, values);
+  BOOST_TEST(holder.begin()[2] == 3);
+  PoolHolder<int> copy(holder);
+  BOOST_TEST(copy.begin() != holder.begin());
+  BOOST_TEST(copy.begin()[2] == 3);
+  const auto* address = holder.begin();
+  PoolHolder<int> moved(std::move(holder));
+  BOOST_TEST(holder.begin() == nullptr);
+  BOOST_TEST(moved.begin() == address);
+  copy = std::move(moved);
+  BOOST_TEST(copy.begin() == address);
+}
+
+BOOST_AUTO_TEST_CASE(high_water_mark_test)
+{
+  MemoryPool::reset_high_water_mark();
+  const auto used = MemoryPool::in_use();
+  BOOST_TEST(MemoryPool::high_water_mark() == used);
+  {
+    PoolHolder<char> a(1000);
+    PoolHolder<char> b(1000);
+  }
+  PoolHolder<char> c(1000);
+  BOOST_TEST(MemoryPool::high_water_mark() == used + 2 * MemoryPool::block_size(1000));
+  MemoryPool::reset_high_water_mark();
+  BOOST_TEST(MemoryPool::high_water_mark() == used + MemoryPool::block_size(1000));
+}
+
+BOOST_AUTO_TEST_CASE(capacity_test)
+{
+  MemoryPool::clear();
+  const auto capacity = MemoryPool::capacity();
+  MemoryPool::set_capacity(1024);
+  {
+    PoolHolder<char> small(512);
+  }
+  BOOST_TEST(MemoryPool::cached() == 512);
+  {
+    PoolHolder<char> large(2048);
+  }
+  BOOST_TEST(MemoryPool::cached() == 512);
+  MemoryPool::clear();
+  BOOST_TEST(MemoryPool::cached() == 0);
+  MemoryPool::set_capacity(capacity);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
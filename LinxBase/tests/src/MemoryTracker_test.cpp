@@ -0,0 +1,103 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#define LINX_TRACK_MEMORY
+
+#include "Linx/Base/MemoryTracker.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MemoryTracker_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(holders_test)
+{
+  BOOST_TEST(MemoryTracker::instrumented());
+  auto& tracker = MemoryTracker::instance();
+  const auto current = tracker.current();
+  tracker.reset_peak();
+  {
+    Raster<float> std_raster({10, 10});
+    BOOST_TEST(tracker.current() == current + 400);
+    AlignedRaster<double> aligned_raster({10, 10});
+    BOOST_TEST(tracker.current() == current + 1200);
+    PoolRaster<char> pool_raster({10, 10});
+    BOOST_TEST(tracker.current() == current + 1300);
+  }
+  BOOST_TEST(tracker.current() == current);
+  BOOST_TEST(tracker.peak() == current + 1300);
+  BOOST_TEST(tracker.baseline() == current);
+  BOOST_TEST(tracker.allocations() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(copy_move_test)
+{
+  auto& tracker = MemoryTracker::instance();
+  const auto current = tracker.current();
+  Raster<int> raster({10, 10});
+  auto copied = raster;
+  BOOST_TEST(tracker.current() == current + 800);
+  auto moved = LINX_MOVE(copied);
+  BOOST_TEST(tracker.current() == current + 800);
+  moved = raster;
+  BOOST_TEST(tracker.current() == current + 800);
+  Raster<int> small({2, 2});
+  moved = LINX_MOVE(small);
+  BOOST_TEST(tracker.current() == current + 416);
+  std::vector<int> container;
+  raster.move_to(container);
+  BOOST_TEST(tracker.current() == current + 16);
+}
+
+BOOST_AUTO_TEST_CASE(aligned_assignment_test)
+{
+  auto& tracker = MemoryTracker::instance();
+  const auto current = tracker.current();
+  {
+    AlignedRaster<float> raster({16, 16});
+    AlignedRaster<float> other({8, 8});
+    BOOST_TEST(tracker.current() == current + 1280);
+    other = raster;
+    BOOST_TEST(tracker.current() == current + 2048);
+    other = AlignedRaster<float>({4, 4});
+    BOOST_TEST(tracker.current() == current + 1088);
+  }
+  BOOST_TEST(tracker.current() == current);
+}
+
+BOOST_AUTO_TEST_CASE(nested_scopes_test)
+{
+  MemoryScope outer;
+  Raster<char> a({10, 10});
+  {
+    MemoryScope inner;
+    Raster<char> tmp({20, 10});
+    BOOST_TEST(inner.current() == 200);
+  }
+  BOOST_TEST(outer.current() == 100);
+  BOOST_TEST(outer.peak() == 300);
+  Raster<char> b({10, 10});
+  BOOST_TEST(outer.current() == 200);
+  BOOST_TEST(outer.peak() == 300);
+}
+
+BOOST_AUTO_TEST_CASE(thread_scope_test)
+{
+  MemoryScope scope;
+  std::thread([]() {
+    Raster<char> other_thread({100, 100});
+  }).join();
+  BOOST_TEST(scope.peak() == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
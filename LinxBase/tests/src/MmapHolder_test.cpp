@@ -0,0 +1,74 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/MmapHolder.h"
+#include "Linx/Io/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MmapHolder_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(anonymous_mapping_test)
+{
+  MmapHolder<int> holder(1000);
+  BOOST_TEST(holder.end() - holder.begin() == 1000);
+  auto* data = const_cast<int*>(holder.begin());
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_TEST(data[i] == 0);
+    data[i] = i;
+  }
+  holder.advise(MmapAdvice::Sequential);
+  MmapHolder<int> moved(std::move(holder));
+  BOOST_TEST(holder.begin() == nullptr);
+  BOOST_TEST(moved.begin()[999] == 999);
+}
+
+BOOST_AUTO_TEST_CASE(file_mapping_test)
+{
+  const std::size_t offset = 4100; // Not page-aligned
+  const std::size_t size = 2000;
+  std::string filename;
+  {
+    TemporaryPath path("MmapHolder_test.raw");
+    filename = path.string();
+    {
+      MmapHolder<float> holder(size, filename, MmapMode::ReadWrite, offset);
+      auto* data = const_cast<float*>(holder.begin());
+      for (std::size_t i = 0; i < size; ++i) {
+        data[i] = i;
+      }
+      holder.sync();
+    }
+    {
+      std::ifstream file(filename, std::ios::binary | std::ios::ate);
+      BOOST_TEST(static_cast<std::size_t>(file.tellg()) == offset + size * sizeof(float));
+    }
+    {
+      MmapHolder<float> holder(size, filename, MmapMode::CopyOnWrite, offset);
+      holder.advise(MmapAdvice::WillNeed, size / 2, size);
+      auto* data = const_cast<float*>(holder.begin());
+      BOOST_TEST(data[size - 1] == size - 1);
+      data[0] = -1;
+    }
+    {
+      const MmapHolder<const float> holder(size, filename, MmapMode::ReadOnly, offset);
+      BOOST_TEST(holder.begin()[0] == 0);
+      BOOST_TEST(holder.begin()[size - 1] == size - 1);
+    }
+    BOOST_CHECK_THROW(MmapHolder<const float>(size + 1, filename, MmapMode::ReadOnly, offset), MmapError);
+    BOOST_CHECK_THROW(MmapHolder<const float>(size, filename, MmapMode::ReadOnly, offset + 1), Exception);
+  }
+  BOOST_CHECK_THROW(MmapHolder<const float>(size, filename), MmapError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
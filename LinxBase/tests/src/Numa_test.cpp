@@ -0,0 +1,58 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Base/Numa.h"
+
+#include <algorithm> // fill
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Numa_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(chunk_bounds_test)
+{
+  AlignedBuffer<float> buffer(1000, uninitialized, 64);
+  const auto bounds = Internal::chunk_bounds(3, 1000, buffer.begin(), sizeof(float));
+  BOOST_TEST(bounds.size() == 4);
+  BOOST_TEST(bounds.front() == 0);
+  BOOST_TEST(bounds.back() == 1000);
+  for (std::size_t i = 1; i < 3; ++i) {
+    BOOST_TEST(bounds[i] * sizeof(float) % 64 == 0);
+    BOOST_TEST(bounds[i] > bounds[i - 1]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(node_query_test)
+{
+  AlignedBuffer<float> buffer(100000, uninitialized, huge_page_size);
+  numa_interleave(buffer.begin(), 100000); // Before first touch, may be unsupported
+  std::fill(const_cast<float*>(buffer.begin()), const_cast<float*>(buffer.end()), 1.F);
+  BOOST_TEST(numa_node(buffer.begin()) >= -1);
+  struct Container {
+    const float* data() const
+    {
+      return buffer.begin();
+    }
+    std::size_t size() const
+    {
+      return 100000;
+    }
+    const AlignedBuffer<float>& buffer;
+  } container {buffer};
+  const auto nodes = numa_nodes(container, par(4));
+  BOOST_TEST(nodes.size() == 4);
+  for (auto n : nodes) {
+    BOOST_TEST(n >= -1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
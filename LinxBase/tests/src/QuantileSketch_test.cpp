@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(QuantileSketch_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(small_exact_test)
+{
+  MinimalDataContainer<int> data {2, 1, 9, 4, 1, 2, 6};
+  const auto s = sketch(data);
+  BOOST_TEST(s.size() == data.size());
+  BOOST_TEST(s.sample_count() == data.size());
+  BOOST_TEST(s.min() == 1);
+  BOOST_TEST(s.max() == 9);
+  BOOST_TEST(s.median() == 2);
+  BOOST_TEST(s.mad() == 1);
+  BOOST_TEST(s.rank(4) == 4);
+}
+
+BOOST_AUTO_TEST_CASE(bounded_error_test)
+{
+  const Index size = 1000000;
+  MinimalDataContainer<float> data(size);
+  data.range();
+  const auto s = sketch(data);
+  BOOST_TEST(s.size() == size);
+  BOOST_TEST(s.sample_count() < 1000);
+  BOOST_TEST(s.min() == 0);
+  BOOST_TEST(s.max() == size - 1);
+  for (double q : {0.01, 0.1, 0.5, 0.9, 0.99}) {
+    BOOST_TEST(std::abs(s.quantile(q) - q * size) < 0.01 * size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(merge_test)
+{
+  const Index size = 100000;
+  MinimalDataContainer<double> data(size);
+  data.range();
+  QuantileSketch<double> merged;
+  for (Index i = 0; i < 10; ++i) {
+    std::vector<double> tile(data.begin() + i * size / 10, data.begin() + (i + 1) * size / 10);
+    merged.merge(QuantileSketch<double>(tile));
+  }
+  BOOST_TEST(merged.size() == size);
+  BOOST_TEST(merged.min() == 0);
+  BOOST_TEST(merged.max() == size - 1);
+  BOOST_TEST(std::abs(merged.median() - size / 2) < 0.01 * size);
+  const auto parallel = sketch(ParallelPolicy(4), data);
+  BOOST_TEST(parallel.size() == size);
+  BOOST_TEST(std::abs(parallel.median() - size / 2) < 0.01 * size);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
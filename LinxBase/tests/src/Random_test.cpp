@@ -124,6 +124,79 @@ BOOST_AUTO_TEST_CASE(reproducible_poisson_test)
   BOOST_TEST(sequence_a[2] == sequence_b[2]);
 }
 
+BOOST_AUTO_TEST_CASE(philox_known_answer_test)
+{
+  const PhiloxEngine::Block zero {0, 0, 0, 0};
+  const PhiloxEngine::Block expected {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+  BOOST_TEST(PhiloxEngine::block(zero, {0, 0}) == expected);
+  const PhiloxEngine::Block ones {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+  const PhiloxEngine::Block expected_ones {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+  BOOST_TEST(PhiloxEngine::block(ones, {0xffffffff, 0xffffffff}) == expected_ones);
+}
+
+BOOST_AUTO_TEST_CASE(counter_noise_parallel_test)
+{
+  MinimalDataContainer<double> sequential(10000);
+  auto parallel = sequential;
+  CounterGaussianNoise<double> noise(0, 1, 42);
+  sequential.generate(noise);
+  parallel.generate(ParallelPolicy(3), noise);
+  BOOST_TEST(sequential == parallel);
+  BOOST_TEST(sequential[1234] == noise.at(1234));
+  BOOST_TEST(std::abs(mean(sequential)) < 0.05);
+  BOOST_TEST(distribution(sequential).stdev() == 1, boost::test_tools::tolerance(0.05));
+  MinimalDataContainer<float> uniform(1000);
+  uniform.generate(ParallelPolicy(4), CounterUniformNoise<float>(-1, 1, 1));
+  BOOST_TEST(min(uniform) >= -1);
+  BOOST_TEST(max(uniform) < 1);
+}
+
+BOOST_AUTO_TEST_CASE(counter_poisson_test)
+{
+  MinimalDataContainer<int> sequence_a {10, 100, 1000};
+  auto sequence_b = sequence_a;
+  sequence_b[1] += 1;
+  CounterPoissonNoise<int> noise(0, 7);
+  sequence_a.apply(noise);
+  sequence_b.apply(ParallelPolicy(2), noise);
+  BOOST_TEST(sequence_a[0] == sequence_b[0]);
+  BOOST_TEST(sequence_a[2] == sequence_b[2]);
+  BOOST_TEST(sequence_a[2] == noise.at(2, 1000));
+}
+
+BOOST_AUTO_TEST_CASE(batch_gaussian_test)
+{
+  MinimalDataContainer<double> values(100000);
+  values.generate(BatchGaussianNoise<double>(10, 2, 0));
+  auto dist = distribution(values);
+  BOOST_TEST(dist.mean() == 10, boost::test_tools::tolerance(0.01));
+  BOOST_TEST(dist.stdev() == 2, boost::test_tools::tolerance(0.01));
+  MinimalDataContainer<std::complex<float>> complexes(1000);
+  complexes.generate(BatchGaussianNoise<std::complex<float>>({0, 100}, {1, 1}, 0));
+  std::complex<float> sum = 0;
+  for (const auto& c : complexes) {
+    sum += c;
+  }
+  BOOST_TEST(std::abs(sum / 1000.F - std::complex<float>(0, 100)) < 0.2);
+}
+
+BOOST_AUTO_TEST_CASE(batch_poisson_test)
+{
+  for (double lambda : {0.5, 3., 50., 1e5}) {
+    MinimalDataContainer<double> values(100000);
+    values.generate(BatchPoissonNoise<double>(lambda, 0));
+    auto dist = distribution(values);
+    BOOST_TEST(dist.mean() == lambda, boost::test_tools::tolerance(0.02));
+    BOOST_TEST(dist.variance() == lambda, boost::test_tools::tolerance(0.02));
+    BOOST_TEST(values[0] == std::round(values[0]));
+    BOOST_TEST(min(values) >= 0);
+  }
+  MinimalDataContainer<long> exact(10000);
+  exact.fill(1000000);
+  exact.apply(BatchPoissonNoise<long>(0, 0, std::numeric_limits<double>::infinity()));
+  BOOST_TEST(mean(exact) == 1000000, boost::test_tools::tolerance(0.001));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Reduction.h"
+
+#include <boost/test/unit_test.hpp>
+#include <list>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Reduction_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(exact_sum_test)
+{
+  const auto identity = [](auto e) {
+    return e;
+  };
+  for (Index size : {0, 1, 7, 8, 9, 1000}) {
+    std::vector<Index> values(size);
+    for (Index i = 0; i < size; ++i) {
+      values[i] = i;
+    }
+    const auto expected = size * (size - 1) / 2;
+    BOOST_TEST(transform_sum<Index>(Summation::Lanes, identity, values) == expected);
+    BOOST_TEST(transform_sum<Index>(Summation::Pairwise, identity, values) == expected);
+    BOOST_TEST(transform_sum<Index>(Summation::Kahan, identity, values) == expected);
+    BOOST_TEST(transform_sum<Index>(ParallelPolicy(3), Summation::Pairwise, identity, values) == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(inner_product_test)
+{
+  const std::vector<int> a {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  const std::list<int> b(a.begin(), a.end()); // Not random-access
+  const auto product = [](auto e, auto f) {
+    return e * f;
+  };
+  BOOST_TEST(transform_sum<int>(Summation::Lanes, product, a, b) == 506);
+  BOOST_TEST(transform_sum<int>(ParallelPolicy(4), Summation::Lanes, product, a, b) == 506);
+  BOOST_TEST(transform_sum<int>(ParallelPolicy(4), Summation::Lanes, product, a, a) == 506);
+}
+
+BOOST_AUTO_TEST_CASE(accuracy_test)
+{
+  const std::vector<float> values(1 << 20, 0.1F);
+  const auto identity = [](auto e) {
+    return e;
+  };
+  const double expected = double(0.1F) * values.size();
+  const auto naive = transform_sum<float>(Summation::Lanes, identity, values);
+  const auto pairwise = transform_sum<float>(Summation::Pairwise, identity, values);
+  const auto kahan = transform_sum<float>(Summation::Kahan, identity, values);
+  BOOST_TEST(std::abs(pairwise - expected) < std::abs(naive - expected));
+  BOOST_TEST(std::abs(kahan - expected) <= std::abs(pairwise - expected));
+  BOOST_TEST(kahan == expected, boost::test_tools::tolerance(1e-6));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Selection.h"
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Selection_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scratch_median_mad_test)
+{
+  MinimalDataContainer<int> data {2, 1, 9, 4, 1, 2, 6};
+  std::vector<double> scratch;
+  BOOST_TEST(median(data, scratch) == 2);
+  BOOST_TEST(mad(data, scratch) == 1);
+  BOOST_TEST(scratch.size() == data.size());
+  const std::vector<int> even {4, 1, 3, 2};
+  BOOST_TEST(median(even, scratch) == 2.5);
+  BOOST_TEST(mad(even, scratch) == 1);
+  BOOST_TEST(data[2] == 9); // Unchanged
+}
+
+BOOST_AUTO_TEST_CASE(inplace_median_mad_test)
+{
+  std::vector<float> data {5, 3, 1, 2, 4};
+  BOOST_TEST(median_inplace(data.data(), data.size()) == 3);
+  BOOST_TEST(mad_inplace(data.data(), data.size()) == 1);
+  BOOST_TEST(*std::max_element(data.begin(), data.end()) == 2); // Deviations
+}
+
+BOOST_AUTO_TEST_CASE(parallel_median_mad_test)
+{
+  for (Index size : {200000, 200001}) {
+    MinimalDataContainer<double> data(size);
+    for (Index i = 0; i < size; ++i) {
+      data[i] = (i * 7919) % size; // Permutation of [0, size)
+    }
+    const auto expected = 0.5 * (size - 1);
+    BOOST_TEST(median(ParallelPolicy(4), data) == expected);
+    std::vector<double> scratch;
+    BOOST_TEST(median(data, scratch) == expected);
+    BOOST_TEST(mad(ParallelPolicy(4), data, scratch) == mad(data, scratch));
+    MinimalDataContainer<double> constant(size);
+    constant.fill(3);
+    BOOST_TEST(median(ParallelPolicy(4), constant) == 3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
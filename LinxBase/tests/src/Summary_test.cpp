@@ -0,0 +1,63 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Summary.h"
+#include "Linx/Base/mixins/DataContainer.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Summary_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(moments_test)
+{
+  MinimalDataContainer<int> data {2, 1, 9, 4, 1, 2, 6};
+  const auto s = summarize(data);
+  BOOST_TEST(s.count() == 7);
+  BOOST_TEST(s.min() == 1);
+  BOOST_TEST(s.max() == 9);
+  BOOST_TEST(s.sum() == 25, boost::test_tools::tolerance(1e-12));
+  BOOST_TEST(s.mean() == 25. / 7, boost::test_tools::tolerance(1e-12));
+  const auto m2 = 143. - 25. * 25. / 7; // Sum of squared deviations
+  BOOST_TEST(s.variance() == m2 / 6, boost::test_tools::tolerance(1e-12));
+  BOOST_TEST(s.variance(false) == m2 / 7, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_moments_test)
+{
+  MinimalDataContainer<double> data(100001);
+  data.range(1e9); // Large offset to check stability
+  const auto s = summarize(data);
+  const auto p = summarize(ParallelPolicy(4), data);
+  BOOST_TEST(p.count() == s.count());
+  BOOST_TEST(p.min() == 1e9);
+  BOOST_TEST(p.max() == 1e9 + 100000);
+  BOOST_TEST(p.mean() == s.mean(), boost::test_tools::tolerance(1e-12));
+  BOOST_TEST(p.variance() == 100001. * 100002. / 12., boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(s.variance() == p.variance(), boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(histogram_test)
+{
+  MinimalDataContainer<int> data(10);
+  data.range();
+  const std::vector<double> bins {-10, -.5, 0, 1.5, 4, 9, 12};
+  const std::vector<std::size_t> expected {0, 0, 2, 2, 5, 1};
+  BOOST_TEST(histogram(data, bins) == expected);
+  BOOST_TEST(histogram(ParallelPolicy(3), data, bins) == expected);
+  const std::vector<std::size_t> uniform {2, 2, 2, 2, 2};
+  BOOST_TEST(histogram(data, 0, 10, 5) == uniform);
+  BOOST_TEST(histogram(ParallelPolicy(3), data, 0, 10, 5) == uniform);
+  const std::vector<std::size_t> closed {3, 3, 4};
+  BOOST_TEST(histogram(data, 0, 9, 3) == closed); // 9 is in the last bin
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#define LINX_TRACE
+#include "Linx/Base/Trace.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Trace_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(disabled_test)
+{
+  auto& recorder = TraceRecorder::instance();
+  recorder.disable();
+  recorder.clear();
+  {
+    LINX_TRACE_SCOPE("disabled", "test");
+  }
+  BOOST_TEST(recorder.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(scope_test)
+{
+  auto& recorder = TraceRecorder::instance();
+  recorder.enable();
+  recorder.clear();
+  {
+    LINX_TRACE_SCOPE("outer", "test");
+    std::thread worker([]() {
+      LINX_TRACE_SCOPE("inner", "test");
+    });
+    worker.join();
+  }
+  recorder.disable();
+  const auto events = recorder.events();
+  BOOST_TEST(events.size() == 2);
+  for (const auto& e : events) {
+    BOOST_TEST(e.second.end >= e.second.begin);
+  }
+  BOOST_TEST(events[0].first != events[1].first); // Different threads
+}
+
+BOOST_AUTO_TEST_CASE(ring_test)
+{
+  auto& recorder = TraceRecorder::instance();
+  recorder.enable(4);
+  recorder.clear();
+  std::thread worker([&]() {
+    for (int i = 0; i < 10; ++i) {
+      recorder.record("event", "test", i, i + 1);
+    }
+  });
+  worker.join();
+  recorder.disable();
+  const auto events = recorder.events();
+  BOOST_TEST(events.size() == 4);
+  BOOST_TEST(events.front().second.begin == 6); // Oldest events overwritten
+  BOOST_TEST(events.back().second.begin == 9);
+}
+
+BOOST_AUTO_TEST_CASE(chrome_json_test)
+{
+  auto& recorder = TraceRecorder::instance();
+  recorder.enable();
+  recorder.clear();
+  recorder.record("step \"one\"", "test", 1500, 4250);
+  recorder.disable();
+  std::ostringstream os;
+  recorder.write(os);
+  const auto json = os.str();
+  BOOST_TEST(json.find("\"traceEvents\"") != std::string::npos);
+  BOOST_TEST(json.find("\"name\":\"step \\\"one\\\"\"") != std::string::npos);
+  BOOST_TEST(json.find("\"ph\":\"X\"") != std::string::npos);
+  BOOST_TEST(json.find("\"ts\":1.500,\"dur\":2.750") != std::string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
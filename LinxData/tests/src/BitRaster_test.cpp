@@ -0,0 +1,72 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BitRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BitRaster_test)
+
+//-----------------------------------------------------------------------------
+
+Raster<char, 3> make_raster(Index modulo)
+{
+  Raster<char, 3> out({131, 3, 2});
+  out.generate([i = 0, modulo]() mutable {
+    return (++i % modulo) == 0;
+  });
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(packing_test)
+{
+  const auto in = make_raster(3);
+  const BitRaster<3> bits(in);
+  BOOST_TEST(bits.shape() == in.shape());
+  BOOST_TEST(bits.row_words() == 3);
+  BOOST_TEST(bits.rows() == 6);
+  BOOST_TEST(bits.words().size() == 18);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(bits[p] == bool(in[p]));
+  }
+  BOOST_TEST(bits.count() == std::count(in.begin(), in.end(), 1));
+  BOOST_TEST((bits.raster<char>() == in));
+}
+
+BOOST_AUTO_TEST_CASE(fill_and_set_test)
+{
+  BitRaster<2> bits({70, 2}, true);
+  BOOST_TEST(bits.count() == 140);
+  bits.set({65, 1}, false);
+  BOOST_TEST(not bits[Position<2>({65, 1})]);
+  BOOST_TEST(bits[Position<2>({64, 1})]);
+  BOOST_TEST(bits.count() == 139);
+  BOOST_TEST((~bits).count() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(bitwise_test)
+{
+  const auto a = make_raster(2);
+  const auto b = make_raster(3);
+  const BitRaster<3> x(a);
+  const BitRaster<3> y(b);
+  const auto both = x & y;
+  const auto any = x | y;
+  const auto one = x ^ y;
+  const auto only = andnot(x, y);
+  for (const auto& p : a.domain()) {
+    BOOST_TEST(both[p] == (a[p] && b[p]));
+    BOOST_TEST(any[p] == (a[p] || b[p]));
+    BOOST_TEST(one[p] == (bool(a[p]) != bool(b[p])));
+    BOOST_TEST(only[p] == (a[p] && not b[p]));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <set>
+#include <vector>
 
 using namespace Linx;
 
@@ -50,6 +51,21 @@ BOOST_AUTO_TEST_CASE(translation_test)
   BOOST_TEST(region.front() == back);
 }
 
+BOOST_AUTO_TEST_CASE(for_each_row_test)
+{
+  const Box<3> box({1, 2, 3}, {4, 5, 6});
+  std::vector<Position<3>> positions;
+  for_each_row(box, [&](const auto& front, Index length) {
+    BOOST_TEST(front[0] == box.front()[0]);
+    BOOST_TEST(length == box.length(0));
+    for (auto p = front; p[0] < front[0] + length; ++p[0]) {
+      positions.push_back(p);
+    }
+  });
+  std::vector<Position<3>> expected(box.begin(), box.end());
+  BOOST_TEST(positions == expected);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
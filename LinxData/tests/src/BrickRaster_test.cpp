@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BrickRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BrickRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(layout_test)
+{
+  const Position<3> shape {10, 5, 3};
+  BrickRaster<int, 3, 4> bricks(shape);
+  BOOST_TEST(bricks.shape() == shape);
+  BOOST_TEST(bricks.size() == 150);
+  BOOST_TEST((bricks.brick_shape() == Position<3> {3, 2, 1}));
+  BOOST_TEST(bricks.storage().size() == 6 * 64);
+  BOOST_TEST((bricks.index({3, 0, 0}) == 3));
+  BOOST_TEST((bricks.index({4, 0, 0}) == 64)); // Next brick
+  BOOST_TEST((bricks.index({0, 1, 0}) == 4));
+  BOOST_TEST((bricks.index({0, 0, 1}) == 16));
+  BOOST_TEST((bricks.index({0, 4, 0}) == 3 * 64));
+  BOOST_TEST((bricks.brick_domain({2, 1, 0}) == Box<3>({8, 4, 0}, {9, 4, 2})));
+}
+
+BOOST_AUTO_TEST_CASE(raster_conversion_test)
+{
+  auto raster = Raster<int, 3>({10, 5, 3}).range();
+  const BrickRaster<int, 3, 4> bricks(raster);
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(bricks[p] == raster[p]);
+  }
+  BOOST_TEST(bricks.raster() == raster);
+  const auto brick = bricks.brick({1, 0, 0});
+  BOOST_TEST((brick.shape() == Position<3> {4, 4, 4}));
+  BOOST_TEST((brick[{1, 2, 2}] == raster[{5, 2, 2}]));
+}
+
+BOOST_AUTO_TEST_CASE(patch_iteration_test)
+{
+  auto raster = Raster<int, 3>({10, 5, 3}).range();
+  BrickRaster<int, 3, 4> bricks(raster);
+  const Box<3> box {{2, 1, 0}, {8, 4, 2}};
+  const auto expected = raster(box);
+  const auto patch = static_cast<const BrickRaster<int, 3, 4>&>(bricks)(box);
+  BOOST_TEST(patch.size() == expected.size());
+  BOOST_TEST(std::equal(patch.begin(), patch.end(), expected.begin(), expected.end()));
+  auto mutable_patch = bricks(box);
+  mutable_patch *= 2;
+  raster(box) *= 2;
+  BOOST_TEST(bricks.raster() == raster);
+  const auto line = bricks(Line<2, 3>({3, 2, 0}, 2));
+  BOOST_TEST(line.size() == 3);
+  BOOST_TEST((*++line.begin() == raster[{3, 2, 1}]));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
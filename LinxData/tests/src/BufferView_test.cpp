@@ -0,0 +1,71 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BufferView.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BufferView_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(c_contiguous_test)
+{
+  std::vector<float> buffer(2 * 3 * 4);
+  const std::vector<Index> shape {2, 3, 4}; // (depth, height, width)
+  const std::vector<Index> strides {48, 16, 4};
+  auto raster = buffer_raster<float, 3>(buffer.data(), shape, strides);
+  BOOST_TEST(raster.shape() == Position<3>({4, 3, 2}));
+  BOOST_TEST(raster.data() == buffer.data());
+  raster[{3, 1, 1}] = 42;
+  BOOST_TEST(buffer[1 * 12 + 1 * 4 + 3] == 42);
+  BOOST_TEST(buffer_shape(raster) == shape, boost::test_tools::per_element());
+  BOOST_TEST(buffer_strides(raster) == strides, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(strided_test)
+{
+  std::vector<double> buffer(6 * 8);
+  for (std::size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = i;
+  }
+  const std::vector<Index> shape {3, 4}; // a[::2, ::2] of a (6, 8) array
+  const std::vector<Index> strides {2 * 8 * 8, 2 * 8};
+  auto view = buffer_view<double, 2>(buffer.data(), shape, strides);
+  BOOST_TEST(view.shape() == Position<2>({4, 3}));
+  BOOST_TEST(not view.is_contiguous());
+  BOOST_TEST(view[Position<2>({3, 2})] == 4 * 8 + 6);
+  BOOST_CHECK_THROW((buffer_raster<double, 2>(buffer.data(), shape, strides)), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(transposed_test)
+{
+  std::vector<int> buffer(3 * 5);
+  const std::vector<Index> shape {5, 3}; // Transpose of a (3, 5) array
+  const std::vector<Index> strides {4, 5 * 4};
+  auto view = buffer_view<int, 2>(buffer.data(), shape, strides);
+  BOOST_TEST(view.strides() == Position<2>({5, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(invalid_buffer_test)
+{
+  std::vector<int> buffer(16);
+  const std::vector<Index> shape {4, 4};
+  const auto view = [&](auto* data, std::vector<Index> strides) {
+    return buffer_view<int, 2>(data, shape, strides);
+  };
+  BOOST_CHECK_THROW(view(buffer.data(), {16, -4}), Exception); // Reversed fastest axis
+  BOOST_CHECK_THROW(view(buffer.data(), {0, 4}), Exception); // Broadcast axis
+  BOOST_CHECK_THROW(view(buffer.data(), {16, 2}), Exception); // Partial stride
+  BOOST_CHECK_THROW(view(reinterpret_cast<int*>(reinterpret_cast<char*>(buffer.data()) + 1), {16, 4}), Exception);
+  BOOST_CHECK_THROW((buffer_view<int, 3>(buffer.data(), shape, shape)), SizeError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Expression.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Expression_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(raster_expression_equals_eager_test)
+{
+  auto a = Raster<float, 3>({4, 3, 2}).range();
+  auto b = Raster<float, 3>({4, 3, 2}).range(1, 2);
+  auto c = Raster<float, 3>({4, 3, 2}).fill(3);
+  const auto expected = a * 2 + b - c;
+  const auto lazy_out = (lazy(a) * 2 + b - c).eval();
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(lazy_out)>, Raster<float, 3>>));
+  BOOST_TEST(lazy_out.shape() == a.shape());
+  BOOST_TEST(lazy_out == expected);
+  const auto calibrated = ((lazy(a) - b) / c * 2.F + 1.F).eval();
+  BOOST_TEST(calibrated == (a - b) / 3.F * 2.F + 1.F);
+  const auto reversed = (1.F - lazy(a) * -lazy(b)).eval();
+  BOOST_TEST(reversed == (a * b) + 1.F);
+}
+
+BOOST_AUTO_TEST_CASE(in_place_evaluation_test)
+{
+  auto a = Raster<int>({3, 2}).range();
+  const auto b = Raster<int>({3, 2}).fill(2);
+  const auto expected = (a + b) * b;
+  ((lazy(a) + b) * b).eval_to(a); // Element-wise, such that aliasing is safe
+  BOOST_TEST(a == expected);
+  Raster<int> wrong({2, 2});
+  BOOST_CHECK_THROW((lazy(a) + b).eval_to(wrong), SizeError);
+  BOOST_CHECK_THROW(lazy(a) + wrong, SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(patch_and_vector_expression_test)
+{
+  const auto raster = Raster<int>({4, 3}).range();
+  const auto patch = raster(Box<2>({1, 1}, {2, 2}));
+  const auto doubled = (lazy(patch) * 2).eval();
+  BOOST_TEST(doubled.shape() == (Position<2> {2, 2}));
+  BOOST_TEST((doubled[{0, 0}] == 2 * raster[{1, 1}]));
+  BOOST_TEST((doubled[{1, 1}] == 2 * raster[{2, 2}]));
+
+  const Vector<double, 3> u {1, 2, 3};
+  const Vector<double, 3> v {4, 5, 6};
+  const auto w = (lazy(u) * v - 1.).eval();
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(w)>, Vector<double, 3>>));
+  BOOST_TEST((w == Vector<double, 3> {3, 9, 17}));
+  const auto norms = lazy(
+                         [](auto x, auto y) {
+                           return x * x + y * y;
+                         },
+                         u,
+                         v)
+                         .eval();
+  BOOST_TEST((norms == Vector<double, 3> {17, 29, 45}));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -66,6 +66,23 @@ BOOST_AUTO_TEST_CASE(grid_clamp_is_shrunk_test)
   BOOST_TEST(out6.step()[0] == 3);
 }
 
+BOOST_AUTO_TEST_CASE(grid_clamp_is_bounded_test)
+{
+  const Grid<1> in({{1}, {9}}, {3});
+  // -+--+--+--
+
+  const auto out0 = in & Box<1>({-2}, {12});
+  BOOST_TEST(out0.front()[0] == 1);
+  BOOST_TEST(out0.back()[0] == 7);
+  BOOST_TEST(out0.size() == 3);
+
+  const auto out8 = in & Box<1>({8}, {12});
+  BOOST_TEST(out8.size() == 0);
+
+  const auto out9 = in & Box<1>({-2}, {0});
+  BOOST_TEST(out9.size() == 0);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
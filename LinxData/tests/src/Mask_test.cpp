@@ -6,6 +6,7 @@
 #include "Linx/Data/Raster.h"
 
 #include <boost/test/unit_test.hpp>
+#include <vector>
 
 using namespace Linx;
 
@@ -74,6 +75,33 @@ BOOST_AUTO_TEST_CASE(empty_mask_iterator_passes_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(for_each_run_test)
+{
+  const auto mask = Mask<2>::ball<2>(3, {5, 6});
+  std::vector<Position<2>> positions;
+  for_each_run(mask, [&](const auto& front, Index length) {
+    BOOST_TEST(length > 0);
+    for (auto p = front; p[0] < front[0] + length; ++p[0]) {
+      BOOST_TEST(mask[p]);
+      positions.push_back(p);
+    }
+  });
+  std::vector<Position<2>> expected(mask.begin(), mask.end());
+  BOOST_TEST(positions == expected);
+}
+
+BOOST_AUTO_TEST_CASE(cached_ball_runs_test)
+{
+  const auto first = Mask<2>::ball<2>(4);
+  auto second = Mask<2>::ball<2>(4, {1, 2});
+  BOOST_TEST(second.flags() == first.flags());
+  BOOST_TEST(&second.runs() == &first.runs()); // Shared
+  second[{1, 2}] = false;
+  BOOST_TEST(second.runs().size() == first.runs().size() + 1); // Center row split in two
+  const auto third = Mask<2>::ball<2>(4, {1, 2});
+  BOOST_TEST(third.flags() == first.flags()); // Cache untouched
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,54 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Matrix.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Matrix_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(identity_diagonal_test)
+{
+  const auto identity = Matrix<int, 3>::identity();
+  const auto diagonal = Matrix<int, 3>::diagonal(Vector<int, 3> {1, 2, 3});
+  for (Index i = 0; i < 3; ++i) {
+    for (Index j = 0; j < 3; ++j) {
+      BOOST_TEST(identity(i, j) == (i == j));
+      BOOST_TEST(diagonal(i, j) == (i == j) * (i + 1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(products_test)
+{
+  const Matrix<int, 2, 3> a {1, 2, 3, 4, 5, 6};
+  const Matrix<int, 3, 2> b {1, 0, 0, 1, 1, 1};
+  const auto ab = a * b;
+  BOOST_TEST(ab.container() == (Matrix<int, 2> {4, 5, 10, 11}).container());
+  const auto av = a * Vector<int, 3> {1, 1, 1};
+  BOOST_TEST(av[0] == 6);
+  BOOST_TEST(av[1] == 15);
+}
+
+BOOST_AUTO_TEST_CASE(determinant_inverse_test)
+{
+  const Matrix<double, 3> m {0, 2, 1, 1, 0, 3, 2, 1, 0};
+  BOOST_TEST(m.determinant() == 13, boost::test_tools::tolerance(1e-12));
+  const auto product = m * inverse(m);
+  for (Index i = 0; i < 3; ++i) {
+    for (Index j = 0; j < 3; ++j) {
+      BOOST_TEST(product(i, j) == (i == j), boost::test_tools::tolerance(1e-12));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -47,6 +47,35 @@ BOOST_AUTO_TEST_CASE(inner_cube_iterator_test)
   check_iterator(shape, Sequence<Position<3>>(box));
 }
 
+BOOST_AUTO_TEST_CASE(sparse_mask_iterator_test)
+{
+  const Position<3> shape {9, 9, 9};
+  check_iterator(shape, Mask<3>::ball<1>(3, {4, 4, 4}));
+  check_iterator(shape, Mask<3>::ball<2>(4, {4, 4, 4}));
+  check_iterator(shape, Mask<3>({{1, 1, 1}, {3, 3, 3}}, false));
+}
+
+BOOST_AUTO_TEST_CASE(strided_grid_iterator_test)
+{
+  const Position<3> shape {8, 5, 6};
+  const Box<3> box {{1, 0, 1}, {7, 4, 5}};
+  check_iterator(shape, Grid<3>(box, {2, 1, 1}));
+  check_iterator(shape, Grid<3>(box, {3, 2, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(dynamic_dimension_iterator_test)
+{
+  const Position<-1> shape {4, 5, 6};
+  const Box<-1> box {{1, 1, 1}, {2, 3, 4}};
+  check_iterator(shape, box);
+}
+
+BOOST_AUTO_TEST_CASE(empty_box_iterator_test)
+{
+  const Position<3> shape {4, 5, 6};
+  check_iterator(shape, Box<3> {{1, 1, 1}, {0, 3, 4}});
+}
+
 template <Index I, Index N>
 void check_slice_iterator(const Position<N>& shape)
 {
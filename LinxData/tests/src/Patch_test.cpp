@@ -55,6 +55,92 @@ BOOST_AUTO_TEST_CASE(contiguity_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(parallel_pixelwise_test)
+{
+  Raster<int> raster({16, 9});
+  raster.range();
+  const Box<2> box({1, 2}, {14, 7});
+  auto patch = raster(box);
+  patch.generate(
+      par(4),
+      [](auto e) {
+        return -e;
+      },
+      raster(box));
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == (box.contains(p) ? -1 : 1) * (p[0] + p[1] * 16));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(for_each_row_test)
+{
+  Raster<int> raster({16, 9});
+  raster.range();
+  const Box<2> box({1, 2}, {14, 7});
+  auto patch = raster(box);
+  Index count = 0;
+  patch.for_each_row([&](int* row, Index length) {
+    BOOST_TEST(length == box.length(0));
+    for (Index i = 0; i < length; ++i) {
+      row[i] = -row[i];
+    }
+    ++count;
+  });
+  BOOST_TEST(count == box.length(1));
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == (box.contains(p) ? -1 : 1) * (p[0] + p[1] * 16));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(span_count_test)
+{
+  Raster<int, 3> raster({6, 5, 4});
+  Index count = 0;
+  const auto count_spans = [&](auto begin, auto end) {
+    BOOST_TEST(end > begin);
+    ++count;
+  };
+  raster(Box<3>({1, 1, 1}, {3, 3, 2})).for_each_span(count_spans);
+  BOOST_TEST(count == 3 * 2);
+  count = 0;
+  raster(Box<3>({0, 1, 1}, {5, 3, 2})).for_each_span(count_spans); // Full rows merge per plane
+  BOOST_TEST(count == 2);
+  count = 0;
+  raster(Box<3>({0, 0, 1}, {5, 4, 2})).for_each_span(count_spans); // Full planes merge
+  BOOST_TEST(count == 1);
+}
+
+BOOST_AUTO_TEST_CASE(span_pixelwise_test)
+{
+  Raster<float, 3> raster({7, 6, 5});
+  raster.range();
+  auto expected = raster;
+  const Box<3> box({1, 2, 0}, {5, 4, 3});
+  Raster<float, 3> values(box.shape());
+  values.range(100);
+
+  auto patch = raster(box);
+  patch += 1;
+  patch *= 2;
+  patch.sqrt();
+  patch.fast_exp();
+  patch.apply([](auto e) {
+    return e - 1;
+  });
+  for (const auto& p : box) {
+    expected[p] = fast_exp(std::sqrt((expected[p] + 1) * 2)) - 1;
+  }
+  BOOST_TEST(raster.container() == expected.container(), boost::test_tools::per_element());
+
+  raster(box).fill(-1);
+  raster(box).assign(values);
+  auto it = values.begin();
+  for (const auto& p : box) {
+    expected[p] = *it++;
+  }
+  BOOST_TEST(raster.container() == expected.container(), boost::test_tools::per_element());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
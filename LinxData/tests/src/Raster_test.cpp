@@ -3,8 +3,10 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Io/Temporary.h"
 
 #include <boost/test/unit_test.hpp>
+#include <utility> // as_const
 
 using namespace Linx;
 
@@ -284,6 +286,179 @@ BOOST_AUTO_TEST_CASE(raster_apply_generate_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(parallel_pixelwise_test)
+{
+  Raster<float, 3> a({101, 13, 7});
+  Raster<float, 3> b(a.shape());
+  a.range(par(3), 1);
+  b.range(1);
+  BOOST_TEST(a == b);
+  a.fill(par(3), 2);
+  BOOST_TEST(a.contains_only(2));
+  a.apply(
+      par(3),
+      [](auto e, auto f) {
+        return e * f;
+      },
+      b);
+  b.apply([](auto e) {
+    return e * 2;
+  });
+  BOOST_TEST(a == b);
+}
+
+BOOST_AUTO_TEST_CASE(mmap_raster_test)
+{
+  TemporaryPath path("Raster_test_mmap.raw");
+  {
+    MmapRaster<int, 3> raster({4, 3, 2}, path.string(), MmapMode::ReadWrite);
+    raster.range();
+  }
+  MmapRaster<const int, 3> raster({4, 3, 2}, path.string());
+  raster.advise(MmapAdvice::Sequential);
+  BOOST_TEST((raster.section(1)[{0, 0}] == 12));
+  BOOST_TEST((raster[{3, 2, 1}] == 23));
+}
+
+BOOST_AUTO_TEST_CASE(uninitialized_raster_test)
+{
+  const Position<2> shape {3, 4};
+  Raster<int> raster(shape, uninitialized); // Unsupported by the holder
+  BOOST_TEST(raster.shape() == shape);
+  BOOST_TEST((raster[{2, 3}] == 0));
+  AlignedRaster<int> aligned(shape, uninitialized, 64);
+  BOOST_TEST(aligned.shape() == shape);
+  BOOST_TEST(is_aligned(aligned.data(), 64));
+  PoolRaster<int> pooled(shape, uninitialized);
+  BOOST_TEST(pooled.size() == shape_size(shape));
+}
+
+BOOST_AUTO_TEST_CASE(first_touch_raster_test)
+{
+  const Position<2> shape {30, 40};
+  AlignedRaster<int> raster(shape, par(3));
+  BOOST_TEST(raster.shape() == shape);
+  for (const auto& e : raster) {
+    BOOST_TEST(e == 0);
+  }
+  Raster<int> fallback(shape, par(3)); // Value-initialized by the holder
+  BOOST_TEST((fallback[{29, 39}] == 0));
+}
+
+BOOST_AUTO_TEST_CASE(cow_raster_test)
+{
+  CowRaster<int> raster({3, 2});
+  raster.range();
+  const auto* address = std::as_const(raster).data();
+  auto copy = raster;
+  BOOST_TEST(std::as_const(copy).data() == address);
+  BOOST_TEST((copy == raster));
+  copy[{2, 1}] = -1;
+  BOOST_TEST(std::as_const(copy).data() != address);
+  BOOST_TEST(std::as_const(raster).data() == address);
+  BOOST_TEST((raster[{2, 1}] == 5));
+  auto other = raster;
+  other.at(-1) = -1;
+  BOOST_TEST((other == copy));
+  auto sum = raster;
+  sum += 1;
+  BOOST_TEST(std::as_const(raster).data() == address);
+  BOOST_TEST(sum[0] == 1);
+  BOOST_TEST(raster[0] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(rvalue_arithmetic_test)
+{
+  Raster<float> a({3, 2});
+  a.range();
+  const auto b = a;
+  auto c = a + b;
+  const auto* address = c.data();
+  auto d = -(std::move(c) * 2.F + b);
+  BOOST_TEST(d.data() == address);
+  BOOST_TEST(d[1] == -5);
+  auto e = b - std::move(d);
+  BOOST_TEST(e.data() == address);
+  BOOST_TEST(e[1] == 6);
+  auto f = abs(std::move(e) - 10.F);
+  BOOST_TEST(f.data() == address);
+  BOOST_TEST(f[1] == 4);
+  auto g = 1.F - std::move(f);
+  BOOST_TEST(g.data() == address);
+  BOOST_TEST(g[1] == -3);
+  BOOST_TEST(b[1] == 1);
+}
+
+BOOST_AUTO_TEST_CASE(convert_quantize_test)
+{
+  Raster<std::uint16_t, 1> raw({4}, {0, 1, 2, 65535});
+  const auto physical = convert<float>(raw, 2, -32768);
+  BOOST_TEST(physical[1] == -32766);
+  BOOST_TEST(physical[3] == 98302);
+  const auto back = quantize<std::uint16_t>(physical, 2, -32768);
+  BOOST_TEST(back == raw);
+  const auto saturated = quantize<std::int16_t>(physical, 2, -32768);
+  BOOST_TEST(saturated[3] == 32767);
+}
+
+BOOST_AUTO_TEST_CASE(reshape_test)
+{
+  Raster<int> raster({3, 4});
+  raster.range();
+  const auto* data = raster.data();
+  raster.reshape({6, 2});
+  BOOST_TEST(raster.shape() == (Position<2> {6, 2}));
+  BOOST_TEST(raster.data() == data);
+  BOOST_TEST((raster[{5, 1}]) == 11);
+  BOOST_CHECK_THROW(raster.reshape({5, 2}), SizeError);
+}
+
+template <typename TRaster>
+void check_resize(TRaster& raster, const Position<3>& shape)
+{
+  const auto original = raster;
+  raster.resize(shape);
+  BOOST_TEST(raster.shape() == shape);
+  BOOST_TEST(raster.size() == shape_size(shape));
+  for (const auto& p : raster.domain()) {
+    const auto expected = original.domain().contains(p) ? original[p] : 0;
+    BOOST_TEST(raster[p] == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(resize_preserves_overlap_test)
+{
+  Raster<int, 3> raster({4, 3, 2});
+  raster.range(1);
+  check_resize(raster, {3, 5, 2}); // Mixed
+  check_resize(raster, {5, 6, 3}); // Larger
+  check_resize(raster, {2, 2, 2}); // Smaller
+  check_resize(raster, {4, 1, 3}); // Mixed
+  check_resize(raster, {0, 1, 3}); // Empty
+  check_resize(raster, {2, 3, 1}); // Not empty
+  AlignedRaster<int, 3> aligned({4, 3, 2});
+  aligned.range(1);
+  check_resize(aligned, {3, 5, 2});
+  check_resize(aligned, {2, 2, 2});
+}
+
+BOOST_AUTO_TEST_CASE(resize_reuses_capacity_test)
+{
+  AlignedRaster<float> raster({100, 100}, uninitialized);
+  const auto* data = raster.data();
+  raster.resize({98, 101}, uninitialized);
+  BOOST_TEST(raster.data() == data);
+  BOOST_TEST(raster.size() == 98 * 101);
+  raster.resize({99, 100});
+  BOOST_TEST(raster.data() == data);
+  Raster<float> vector_raster({100, 100});
+  data = vector_raster.data();
+  vector_raster.resize({50, 50}, uninitialized);
+  vector_raster.resize({100, 99}, uninitialized);
+  BOOST_TEST(vector_raster.data() == data);
+  BOOST_TEST(vector_raster.size() == 9900);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
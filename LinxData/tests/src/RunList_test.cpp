@@ -0,0 +1,106 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/RunList.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RunList_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(compilation_test)
+{
+  const std::vector<Position<2>> positions {{4, 1}, {1, 2}, {2, 1}, {3, 1}, {2, 1}, {0, 2}, {7, 0}};
+  const RunList<2> runs(positions);
+  BOOST_TEST(runs.size() == 6);
+  BOOST_TEST(runs.run_count() == 3);
+  BOOST_TEST((runs.box() == Box<2>({0, 0}, {7, 2})));
+  const std::vector<Position<2>> expected {{7, 0}, {2, 1}, {3, 1}, {4, 1}, {0, 2}, {1, 2}};
+  const std::vector<Position<2>> out(runs.begin(), runs.end());
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(append_test)
+{
+  RunList<2> runs;
+  runs.append({3, 0}, 2);
+  runs.append({5, 0}, 1); // Contiguous
+  runs.append({0, 2}, 4);
+  BOOST_TEST(runs.size() == 7);
+  BOOST_TEST(runs.run_count() == 2);
+  BOOST_TEST((runs.box() == Box<2>({0, 0}, {5, 2})));
+  const std::vector<Position<2>> positions {{3, 0}, {4, 0}, {5, 0}, {0, 2}, {1, 2}, {2, 2}, {3, 2}};
+  BOOST_TEST(runs == RunList<2>(positions));
+}
+
+BOOST_AUTO_TEST_CASE(patch_test)
+{
+  Raster<int, 3> raster({6, 5, 4});
+  raster.range();
+  const Box<3> box({1, 1, 1}, {4, 3, 2});
+  std::vector<Position<3>> positions(box.begin(), box.end());
+  positions.push_back({0, 0, 3});
+  const RunList<3> runs(positions);
+  BOOST_TEST(runs.run_count() == box.size() / box.length(0) + 1);
+  std::vector<int> expected;
+  for (const auto& p : runs) {
+    expected.push_back(raster[p]);
+  }
+  const auto patch = raster(runs);
+  const std::vector<int> out(patch.begin(), patch.end());
+  BOOST_TEST(out == expected);
+  raster(runs + Position<3> {1, 0, 0}) += 1000;
+  for (const auto& p : raster.domain()) {
+    const bool in = (box + Position<3> {1, 0, 0}).contains(p) || p == Position<3> {1, 0, 3};
+    BOOST_TEST(raster[p] == raster.index(p) + (in ? 1000 : 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gather_scatter_test)
+{
+  Raster<float> raster({16, 9});
+  raster.range();
+  std::vector<Position<2>> positions;
+  for (Index i = 0; i < 40; ++i) {
+    positions.push_back({(i * 7) % 16, (i * 3) % 9});
+  }
+  const RunList<2> runs(positions);
+  auto values = gather(par(4), raster, runs);
+  BOOST_TEST(values.size() == runs.size());
+  auto it = values.begin();
+  for (const auto& p : runs) {
+    BOOST_TEST(*it == raster[p]);
+    *it = -1;
+    ++it;
+  }
+  scatter(par(4), values, runs, raster);
+  for (const auto& p : positions) {
+    BOOST_TEST(raster[p] == -1);
+  }
+  BOOST_TEST(std::count(raster.begin(), raster.end(), -1) == runs.size());
+}
+
+BOOST_AUTO_TEST_CASE(crop_test)
+{
+  const Box<2> box({0, 0}, {9, 9});
+  const RunList<2> runs(box);
+  const Box<2> bounds({2, 3}, {5, 4});
+  const auto cropped = runs & bounds;
+  BOOST_TEST(cropped.run_count() == 2);
+  BOOST_TEST((cropped.box() == bounds));
+  const std::vector<Position<2>> out(cropped.begin(), cropped.end());
+  const std::vector<Position<2>> expected(bounds.begin(), bounds.end());
+  BOOST_TEST(out == expected);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
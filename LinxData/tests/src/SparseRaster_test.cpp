@@ -0,0 +1,93 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/SparseRaster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SparseRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(dense_round_trip_test)
+{
+  Raster<int, 3> dense({9, 4, 3});
+  for (const auto& p : dense.domain()) {
+    dense[p] = (p[0] * 5 + p[1] * 3 + p[2]) % 7 == 0 ? p[0] + 10 * p[1] + 100 * p[2] + 1 : 0;
+  }
+  dense[{7, 3, 2}] = dense[{8, 3, 2}] = -1; // Run up to the end of the last row
+  const SparseRaster<int, 3> sparse(dense);
+  BOOST_TEST(sparse.shape() == dense.shape());
+  BOOST_TEST(sparse.size() == dense.size());
+  BOOST_TEST(sparse.count() == dense.size() - std::count(dense.begin(), dense.end(), 0));
+  BOOST_TEST(sparse.raster() == dense);
+  for (const auto& p : dense.domain()) {
+    BOOST_TEST(sparse[p] == dense[p]);
+  }
+  Index count = 0;
+  sparse.for_each([&](const auto& p, auto v) {
+    BOOST_TEST(v != 0);
+    BOOST_TEST(v == dense[p]);
+    ++count;
+  });
+  BOOST_TEST(count == sparse.count());
+}
+
+BOOST_AUTO_TEST_CASE(positions_test)
+{
+  const Sequence<Position<2>> positions {{4, 1}, {1, 2}, {2, 1}, {3, 1}, {2, 1}, {0, 2}, {7, 0}};
+  const SparseRaster<char> flags({8, 3}, positions);
+  BOOST_TEST(flags.count() == 6);
+  BOOST_TEST(flags.region().run_count() == 3);
+  for (const auto& p : flags.domain()) {
+    const bool in = std::find(positions.begin(), positions.end(), p) != positions.end();
+    BOOST_TEST(flags[p] == in);
+  }
+  const std::vector<float> values {1, 2, 3, 4, 5, 6, 7};
+  const SparseRaster<float> sparse({8, 3}, positions, values);
+  BOOST_TEST(sparse.count() == 6);
+  BOOST_TEST((sparse[{2, 1}]) == 5); // Last duplicate
+  BOOST_TEST((sparse[{7, 0}]) == 7);
+  BOOST_TEST((sparse[{1, 2}]) == 2);
+  BOOST_TEST((sparse[{5, 1}]) == 0);
+  BOOST_CHECK_THROW(SparseRaster<char>({4, 3}, positions), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(dense_arithmetics_test)
+{
+  Raster<float> image({16, 9});
+  image.range();
+  const auto original = image;
+  std::vector<Position<2>> positions;
+  std::vector<float> values;
+  for (Index i = 0; i < 20; ++i) {
+    positions.push_back({(i * 7) % 16, (i * 5) % 9});
+    values.push_back(1000 + i);
+  }
+  const SparseRaster<float> sparse(image.shape(), positions, values);
+  image += sparse;
+  BOOST_TEST(image == original + sparse.raster());
+  BOOST_TEST(image - sparse == original);
+  image -= sparse;
+  BOOST_TEST(image == original);
+
+  const auto product = sparse * image;
+  BOOST_TEST((product.region() == sparse.region()));
+  BOOST_TEST(product.raster() == sparse.raster() * image);
+  BOOST_TEST((image * sparse == product));
+
+  image(sparse.region()).fill(-1);
+  for (const auto& p : image.domain()) {
+    BOOST_TEST(image[p] == (sparse[p] != 0 ? -1 : original[p]));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/SplitRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SplitRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(interleave_test)
+{
+  Raster<std::complex<float>> in({3, 2});
+  for (Index i = 0; i < static_cast<Index>(in.size()); ++i) {
+    in[i] = {float(i), float(-2 * i)};
+  }
+  const SplitRaster<float> split(in);
+  BOOST_TEST(split.shape() == in.shape());
+  BOOST_TEST(split.real()[4] == 4);
+  BOOST_TEST(split.imag()[4] == -8);
+  BOOST_TEST((split[{1, 1}] == in[{1, 1}]));
+  Raster<std::complex<float>> out(in.shape());
+  split.interleave(out);
+  BOOST_TEST(out == in);
+  Raster<std::complex<float>> bad({2, 2});
+  BOOST_CHECK_THROW(split.interleave(bad), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(multiply_test)
+{
+  Raster<std::complex<double>, 1> a({4}, {{1, 2}, {3, -1}, {0, 1}, {-2, 0.5}});
+  Raster<std::complex<double>, 1> b({4}, {{2, 1}, {1, 1}, {-1, 3}, {0.5, 2}});
+  SplitRaster<double, 1> product(a);
+  product *= SplitRaster<double, 1>(b);
+  SplitRaster<double, 1> acc(a.shape());
+  acc.multiply_add(SplitRaster<double, 1>(a), SplitRaster<double, 1>(b));
+  acc.multiply_add(SplitRaster<double, 1>(a), SplitRaster<double, 1>(b), true);
+  auto interleaved = a;
+  Internal::complex_multiply(interleaved.data(), b.data(), b.size());
+  for (Index i = 0; i < static_cast<Index>(a.size()); ++i) {
+    BOOST_TEST(product[{i}] == a[i] * b[i]);
+    BOOST_TEST(acc[{i}] == a[i] * b[i] + a[i] * std::conj(b[i]));
+    BOOST_TEST(interleaved[i] == a[i] * b[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(complex_to_real_test)
+{
+  Raster<std::complex<double>, 1> in({3}, {{3, 4}, {-1, 0}, {0, -2}});
+  const SplitRaster<double, 1> split(in);
+  BOOST_TEST(real(split) == real(in));
+  BOOST_TEST(imag(split) == imag(in));
+  BOOST_TEST(norm(split) == norm(in));
+  BOOST_TEST(abs(split) == abs(in));
+  BOOST_TEST(arg(split) == arg(in));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Mask.h"
+#include "Linx/Data/StridedRaster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(StridedRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(contiguous_view_test)
+{
+  Raster<int, 3> raster({4, 5, 6});
+  raster.range();
+  const auto view = strided(raster);
+  BOOST_TEST(view.shape() == raster.shape());
+  BOOST_TEST(view.is_contiguous());
+  BOOST_TEST(std::equal(view.begin(), view.end(), raster.begin(), raster.end()));
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(view[p] == raster[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(box_view_test)
+{
+  Raster<int, 3> raster({4, 5, 6});
+  raster.range();
+  const Box<3> box({1, 2, 1}, {3, 3, 4});
+  auto view = strided(raster)(box);
+  BOOST_TEST(view.shape() == box.shape());
+  BOOST_TEST(not view.is_contiguous());
+  const auto patch = raster(box);
+  BOOST_TEST(std::equal(view.begin(), view.end(), patch.begin(), patch.end()));
+  view += 1000;
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == raster.index(p) + (box.contains(p) ? 1000 : 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(grid_view_test)
+{
+  Raster<int, 2> raster({9, 7});
+  raster.range();
+  const Grid<2> grid({{1, 0}, {7, 6}}, {3, 2});
+  const auto view = strided(std::as_const(raster))(grid);
+  BOOST_TEST(view.shape() == grid.shape());
+  std::vector<int> expected;
+  for (const auto& p : grid) {
+    expected.push_back(raster[p]);
+  }
+  const std::vector<int> values(view.begin(), view.end());
+  BOOST_TEST(values == expected);
+  for (const auto& p : view.domain()) {
+    BOOST_TEST((view[p] == raster[{1 + 3 * p[0], 2 * p[1]}]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(permutation_test)
+{
+  Raster<int, 3> raster({4, 5, 6});
+  raster.range();
+  const auto view = strided(raster).permute({2, 0, 1});
+  BOOST_TEST((view.shape() == Position<3> {6, 4, 5}));
+  for (const auto& p : view.domain()) {
+    BOOST_TEST((view[p] == raster[{p[1], p[2], p[0]}]));
+  }
+  std::vector<int> expected;
+  for (const auto& p : view.domain()) {
+    expected.push_back(view[p]);
+  }
+  const std::vector<int> values(view.begin(), view.end());
+  BOOST_TEST(values == expected);
+  const Raster<int, 3> copy(view.shape(), view);
+  BOOST_TEST(copy.shape() == view.shape());
+  BOOST_TEST(std::equal(copy.begin(), copy.end(), view.begin(), view.end()));
+}
+
+BOOST_AUTO_TEST_CASE(pixelwise_test)
+{
+  Raster<float, 2> raster({8, 6});
+  raster.fill(1);
+  auto view = strided(raster)(Grid<2>(raster.domain(), {2, 3}));
+  view.fill(par(3), 4);
+  view.apply([](auto e) {
+    return std::sqrt(e);
+  });
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == (p[0] % 2 == 0 && p[1] % 3 == 0 ? 2 : 1));
+  }
+  Index count = 0;
+  view.for_each_row([&](auto* row, Index length, Index step) {
+    BOOST_TEST(step == 2);
+    for (Index i = 0; i < length * step; i += step) {
+      count += row[i];
+    }
+  });
+  BOOST_TEST(count == 2 * view.size());
+}
+
+BOOST_AUTO_TEST_CASE(mask_patch_test)
+{
+  Raster<int, 2> raster({8, 8});
+  raster.range();
+  const auto view = strided(raster).permute({1, 0});
+  const auto mask = Mask<2>::ball<1>(2, {4, 3});
+  const auto patch = view(mask);
+  auto it = patch.begin();
+  for (const auto& p : mask) {
+    BOOST_TEST((*it == raster[{p[1], p[0]}]));
+    ++it;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Transpose.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Transpose_test)
+
+//-----------------------------------------------------------------------------
+
+template <Index N>
+void check_transpose(const Position<N>& shape, const Position<N>& axes)
+{
+  auto in = Raster<int, N>(shape).range();
+  const auto view = strided(in).permute(axes);
+  const auto out = transpose(in, axes);
+  BOOST_TEST(out.shape() == view.shape());
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == view[p]);
+  }
+  BOOST_TEST((transpose(par(3), in, axes) == out));
+  Raster<long, N> copy(out.shape());
+  BOOST_TEST((transpose(in, axes, copy) == out));
+}
+
+BOOST_AUTO_TEST_CASE(transpose_2d_test)
+{
+  check_transpose<2>({70, 45}, {1, 0});
+  check_transpose<2>({7, 5}, {0, 1});
+}
+
+BOOST_AUTO_TEST_CASE(transpose_3d_test)
+{
+  const Position<3> shape {37, 33, 5};
+  check_transpose(shape, {2, 1, 0});
+  check_transpose(shape, {1, 0, 2});
+  check_transpose(shape, {0, 2, 1});
+  check_transpose(shape, {1, 2, 0});
+  check_transpose(shape, {2, 0, 1});
+}
+
+BOOST_AUTO_TEST_CASE(transpose_shape_mismatch_test)
+{
+  const Raster<int, 3> in({2, 3, 4});
+  Raster<int, 3> out({2, 3, 4});
+  BOOST_CHECK_THROW(transpose(in, {2, 1, 0}, out), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(transpose_inplace_test)
+{
+  auto in = Raster<int, 3>({3, 70, 70}).range();
+  const auto expected = transpose(in, {0, 2, 1});
+  auto out = in;
+  transpose_inplace(out, 1, 2);
+  BOOST_TEST((out == expected));
+  transpose_inplace(par(4), out, 2, 1);
+  BOOST_TEST((out == in));
+  BOOST_CHECK_THROW(transpose_inplace(out, 0, 1), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(transform_profiles_test)
+{
+  const Position<3> shape {37, 5, 6}; // Wider than a block along axis 0
+  const auto in = Raster<Index, 3>(shape).range();
+  for (Index axis = 0; axis < 3; ++axis) {
+    const auto length = shape[axis];
+    auto out = in;
+    transform_profiles(par(3), out, axis, 1, [&](Index* block, Index width) {
+      for (Index j = 0; j < width; ++j) {
+        block[-width + j] = 0; // Margin
+      }
+      for (Index k = 0; k < length; ++k) {
+        for (Index j = 0; j < width; ++j) {
+          block[k * width + j] += block[(k - 1) * width + j];
+        }
+      }
+    });
+    for (const auto& p : in.domain()) {
+      Index expected = 0;
+      auto q = p;
+      for (q[axis] = 0; q[axis] <= p[axis]; ++q[axis]) {
+        expected += in[q];
+      }
+      BOOST_TEST(out[p] == expected);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
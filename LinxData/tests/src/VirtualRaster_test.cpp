@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Random.h"
+#include "Linx/Data/VirtualRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(VirtualRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(index_equals_range_test)
+{
+  const Position<3> shape {4, 3, 2};
+  const auto v = virtual_index<int>(shape);
+  BOOST_TEST(v.size() == 24);
+  auto expected = Raster<int, 3>(shape);
+  expected.range();
+  BOOST_TEST(v.eval() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(coordinate_and_constant_test)
+{
+  const auto x = virtual_coordinate<float>(Position<2> {5, 4}, 0);
+  const auto y = virtual_coordinate<float>(Position<2> {5, 4}, 1);
+  const auto c = virtual_constant(Position<2> {5, 4}, 10.F);
+  const auto out = (x + y * c).eval();
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == p[0] + p[1] * 10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sub_raster_is_shifted_test)
+{
+  const auto v = virtual_index<int>(Position<2> {6, 5});
+  const auto sub = v(Box<2>({2, 1}, {4, 3}));
+  BOOST_TEST(sub.shape() == Position<2>({3, 3}));
+  BOOST_TEST(sub[Position<2>({0, 0})] == 8);
+  BOOST_TEST(sub[Position<2>({2, 2})] == 22);
+  BOOST_TEST(sub[Position<2>({-2, -1})] == 0); // Outside the sub-raster
+}
+
+BOOST_AUTO_TEST_CASE(noise_equals_counter_generation_test)
+{
+  const CounterGaussianNoise<double> noise(0, 1, 42);
+  const Position<2> shape {16, 9};
+  const auto v = virtual_noise(shape, noise);
+  auto expected = Raster<double>(shape);
+  expected.generate(noise);
+  auto in = Raster<double>(shape).range();
+  const auto noisy = (in + v).eval(); // Virtual operands are stored by value
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(v[p] == expected[p]);
+    BOOST_TEST(noisy[p] == in[p] + expected[p]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,25 +5,363 @@
 #ifndef _LINXIO_PNG_H
 #define _LINXIO_PNG_H
 
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
 #include <png.h>
 #include <string>
+#include <type_traits>
+#include <vector>
+#include <zlib.h>
 
 namespace Linx {
 
+/**
+ * @brief Compression parameters of a PNG file.
+ *
+ * The defaults favor write throughput over file size, e.g. for quick-look products.
+ *
+ * @see `Png::write()`
+ */
+struct PngCompression {
+  /**
+   * @brief The row filters, which are applied before compression.
+   */
+  enum class Filter {
+    None = PNG_FILTER_NONE, ///< No filtering, fastest
+    Sub = PNG_FILTER_SUB, ///< Difference with the left pixel, cheap and generally effective
+    Up = PNG_FILTER_UP, ///< Difference with the upper pixel
+    Average = PNG_FILTER_AVG, ///< Difference with the mean of the left and upper pixels
+    Paeth = PNG_FILTER_PAETH, ///< Difference with the Paeth predictor
+    Adaptive = PNG_ALL_FILTERS ///< Best filter selected for each row, slowest
+  };
+
+  /**
+   * @brief The zlib compression strategies.
+   */
+  enum class Strategy {
+    Default = Z_DEFAULT_STRATEGY, ///< Standard deflate
+    Filtered = Z_FILTERED, ///< Tuned for filtered data
+    HuffmanOnly = Z_HUFFMAN_ONLY, ///< No string matching, very fast
+    Rle = Z_RLE ///< Run-length matching only, fast and good with filtered images
+  };
+
+  /**
+   * @brief The zlib compression level, from 0 (no compression) to 9 (best compression).
+   */
+  int level = 1;
+
+  /**
+   * @brief The row filters.
+   */
+  Filter filter = Filter::Sub;
+
+  /**
+   * @brief The zlib strategy.
+   */
+  Strategy strategy = Strategy::Rle;
+};
+
+/**
+ * @brief PNG file reader/writer.
+ *
+ * Images of 8- or 16-bit values are represented as rasters of `unsigned char` or `std::uint16_t`:
+ * - 2D rasters for grayscale images;
+ * - 3D rasters of shape `{channels, width, height}` for any image,
+ *   where the channels are gray, gray-alpha, RGB or RGBA, such that pixels are interleaved like in the file.
+ *
+ * Rows are read and written in place, from and to the raster data, without intermediate pixel buffer.
+ * When reading, palettes and low bit depths are expanded, and the bit depth is converted to that of the raster.
+ *
+ * \code
+ * Raster<unsigned char, 3> rgb({3, width, height});
+ * ...
+ * Png("preview.png").write(rgb);
+ * \endcode
+ */
 class Png {
 public:
 
-  Png(const std::string& filename);
+  /**
+   * @brief Constructor.
+   */
+  Png(const std::filesystem::path& path) : m_path(path) {}
+
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
 
-  bool accept();
+  /**
+   * @brief Check whether the file exists and has a PNG signature.
+   */
+  bool accept() const
+  {
+    File file(std::fopen(m_path.c_str(), "rb"), &std::fclose);
+    if (not file) {
+      return false;
+    }
+    png_byte signature[8];
+    return std::fread(signature, 1, 8, file.get()) == 8 && png_sig_cmp(signature, 0, 8) == 0;
+  }
 
+  /**
+   * @brief Read the image.
+   */
   template <typename TRaster>
-  TRaster read();
+  TRaster read() const
+  {
+    using T = typename TRaster::Value;
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 2 || N == 3, "PNG images are read as 2D (gray) or 3D (channels) rasters.");
+    static_assert(bit_depth<T>() > 0, "PNG values must be unsigned char or std::uint16_t.");
+
+    FileNotFoundError::may_throw(m_path);
+    File file(std::fopen(m_path.c_str(), "rb"), &std::fclose);
+    if (not file) {
+      throw FileFormatError("Cannot open file", m_path);
+    }
+    Context context(false);
+    if (not context.info || not read_info(context.png, context.info, file.get(), bit_depth<T>())) {
+      throw FileFormatError("Cannot read file: " + context.message, m_path);
+    }
 
+    const Index width = png_get_image_width(context.png, context.info);
+    const Index height = png_get_image_height(context.png, context.info);
+    const Index channels = png_get_channels(context.png, context.info);
+    Position<N> shape;
+    if constexpr (N == 2) {
+      if (channels != 1) {
+        throw FileFormatError("Cannot read " + std::to_string(channels) + "-channel image as 2D raster", m_path);
+      }
+      shape = {width, height};
+    } else {
+      shape = {channels, width, height};
+    }
+    TRaster out(shape);
+    std::vector<png_bytep> rows(height);
+    for (Index y = 0; y < height; ++y) {
+      rows[y] = reinterpret_cast<png_bytep>(out.data() + y * width * channels);
+    }
+    if (not read_rows(context.png, rows.data())) {
+      throw FileFormatError("Cannot read file: " + context.message, m_path);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Write a raster.
+   * @param raster The raster
+   * @param compression The compression parameters
+   * @param mode `x` to create a new file, `w` to create or overwrite
+   */
   template <typename TRaster>
-  void write(const TRaster& raster);
+  void write(const TRaster& raster, const PngCompression& compression = {}, char mode = 'x') const
+  {
+    using T = std::decay_t<typename TRaster::Value>;
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 2 || N == 3, "PNG images are written from 2D (gray) or 3D (channels) rasters.");
+    static_assert(bit_depth<T>() > 0, "PNG values must be unsigned char or std::uint16_t.");
+
+    const auto& shape = raster.shape();
+    const Index channels = N == 2 ? 1 : shape[0];
+    const Index width = shape[N - 2];
+    const Index height = shape[N - 1];
+    OutOfBoundsError::may_throw("Channel count: ", channels, {1, 4});
+
+    if (mode == 'x') {
+      PathExistsError::may_throw(m_path);
+    }
+    File file(std::fopen(m_path.c_str(), "wb"), &std::fclose);
+    if (not file) {
+      throw FileFormatError("Cannot create file", m_path);
+    }
+    Context context(true);
+    std::vector<png_bytep> rows(height);
+    for (Index y = 0; y < height; ++y) {
+      rows[y] = reinterpret_cast<png_bytep>(const_cast<T*>(raster.data() + y * width * channels)); // Not modified
+    }
+    static const int color_types[] = {PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GA, PNG_COLOR_TYPE_RGB, PNG_COLOR_TYPE_RGBA};
+    const Header header {width, height, bit_depth<T>(), color_types[channels - 1]};
+    if (not context.info || not write_rows(context.png, context.info, file.get(), header, compression, rows.data())) {
+      throw FileFormatError("Cannot write file: " + context.message, m_path);
+    }
+    if (std::fclose(file.release()) != 0) {
+      throw FileFormatError("Cannot close file", m_path);
+    }
+  }
 
 private:
+
+  /**
+   * @brief A C file handle.
+   */
+  using File = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+  /**
+   * @brief The libpng read or write structures, and the last error message.
+   */
+  struct Context {
+    explicit Context(bool writing) :
+        writing(writing), message(),
+        png(
+            writing ? png_create_write_struct(PNG_LIBPNG_VER_STRING, &message, on_error, on_warning) :
+                      png_create_read_struct(PNG_LIBPNG_VER_STRING, &message, on_error, on_warning)),
+        info(png ? png_create_info_struct(png) : nullptr)
+    {}
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+    ~Context()
+    {
+      if (writing) {
+        png_destroy_write_struct(&png, &info);
+      } else {
+        png_destroy_read_struct(&png, &info, nullptr);
+      }
+    }
+    bool writing;
+    std::string message;
+    png_structp png;
+    png_infop info;
+  };
+
+  /**
+   * @brief The image header.
+   */
+  struct Header {
+    Index width;
+    Index height;
+    int bit_depth;
+    int color_type;
+  };
+
+  /**
+   * @brief Get the PNG bit depth of a value type, or 0 if unsupported.
+   */
+  template <typename T>
+  static constexpr int bit_depth()
+  {
+    if constexpr (std::is_same_v<T, unsigned char>) {
+      return 8;
+    }
+    if constexpr (std::is_same_v<T, std::uint16_t>) {
+      return 16;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Store the libpng error message and jump back to the calling function.
+   */
+  static void on_error(png_structp png, png_const_charp message)
+  {
+    *static_cast<std::string*>(png_get_error_ptr(png)) = message;
+    png_longjmp(png, 1);
+  }
+
+  /**
+   * @brief Ignore libpng warnings.
+   */
+  static void on_warning(png_structp, png_const_charp) {}
+
+  /**
+   * @brief Read the header and set up the transformations to the requested bit depth.
+   * @return False in case of libpng error
+   *
+   * Like the other functions which call `setjmp()`, no C++ object lives in this scope.
+   */
+  static bool read_info(png_structp png, png_infop info, std::FILE* file, int bit_depth)
+  {
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    png_init_io(png, file);
+    png_read_info(png, info);
+    png_set_expand(png); // Palette to RGB, low bit depths to 8 bits, tRNS to alpha
+    if (bit_depth == 8) {
+      png_set_strip_16(png);
+    } else {
+      png_set_expand_16(png);
+      if (is_little_endian()) {
+        png_set_swap(png);
+      }
+    }
+    png_read_update_info(png, info);
+    return true;
+  }
+
+  /**
+   * @brief Read the rows.
+   * @return False in case of libpng error
+   */
+  static bool read_rows(png_structp png, png_bytepp rows)
+  {
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    png_read_image(png, rows);
+    png_read_end(png, nullptr);
+    return true;
+  }
+
+  /**
+   * @brief Write the header and rows.
+   * @return False in case of libpng error
+   */
+  static bool write_rows(
+      png_structp png,
+      png_infop info,
+      std::FILE* file,
+      const Header& header,
+      const PngCompression& compression,
+      png_bytepp rows)
+  {
+    if (setjmp(png_jmpbuf(png))) {
+      return false;
+    }
+    png_init_io(png, file);
+    png_set_compression_level(png, compression.level);
+    png_set_compression_strategy(png, static_cast<int>(compression.strategy));
+    png_set_compression_buffer_size(png, 1 << 16); // Fewer, larger writes
+    png_set_filter(png, PNG_FILTER_TYPE_BASE, static_cast<int>(compression.filter));
+    png_set_IHDR(
+        png,
+        info,
+        header.width,
+        header.height,
+        header.bit_depth,
+        header.color_type,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_BASE,
+        PNG_FILTER_TYPE_BASE);
+    png_write_info(png, info);
+    if (header.bit_depth == 16 && is_little_endian()) {
+      png_set_swap(png);
+    }
+    png_write_image(png, rows);
+    png_write_end(png, nullptr);
+    return true;
+  }
+
+  /**
+   * @brief Check whether the host is little endian, i.e. whether 16-bit values must be byte-swapped.
+   */
+  static constexpr bool is_little_endian()
+  {
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
 };
 
 } // namespace Linx
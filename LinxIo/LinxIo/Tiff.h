@@ -5,42 +5,384 @@
 #ifndef _LINXIO_TIFF_H
 #define _LINXIO_TIFF_H
 
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Exceptions.h"
+
+#include <algorithm> // min
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <string>
-#include <tiff.h>
+#include <tiffio.h>
+#include <type_traits>
+#include <vector>
 
 namespace Linx {
 
+/**
+ * @brief TIFF file reader/writer.
+ *
+ * Values are read and written at their native type, e.g. `std::uint16_t` or `float`,
+ * which must match the bits per sample and sample format of the file.
+ * A page is represented as a 2D raster if it has a single sample per pixel,
+ * or as a 3D raster of shape `{samples, width, height}` otherwise, such that samples are interleaved like in the file.
+ * Multi-page files are represented with one more axis, e.g. as 3D rasters of shape `{width, height, pages}`.
+ *
+ * Strips are decoded directly into the raster storage, while tiles go through a buffer of the size of a tile.
+ * Strips and tiles can be decoded in parallel, each thread reading through its own file handle:
+ *
+ * \code
+ * auto image = Tiff("image.tif").read<Raster<std::uint16_t>>(par(4));
+ * auto stack = Tiff("stack.tif").read_pages<Raster<float, 3>>();
+ * \endcode
+ */
 class Tiff {
 public:
 
-  Tiff(const std::string& filename) : m_tif(TIFFOpen(filename.c_str(), "r"))
-  { // FIXME mode
+  /**
+   * @brief Constructor.
+   */
+  Tiff(const std::filesystem::path& path) : m_path(path) {}
+
+  /**
+   * @brief Get the file path.
+   */
+  const std::filesystem::path& path() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @brief Check whether the file exists and has a TIFF or BigTIFF signature.
+   */
+  bool accept() const
+  {
+    std::ifstream file(m_path, std::ios::binary);
+    char signature[4] = {};
+    if (not file.read(signature, 4)) {
+      return false;
+    }
+    const std::string magic(signature, 4);
+    return magic == std::string("II*\0", 4) || magic == std::string("MM\0*", 4) ||
+        magic == std::string("II+\0", 4) || magic == std::string("MM\0+", 4);
   }
 
-  ~Tiff()
+  /**
+   * @brief Get the number of pages.
+   */
+  Index page_count() const
   {
-    TIFFClose(m_tif);
+    auto tif = open('r');
+    return TIFFNumberOfDirectories(tif.get());
   }
 
-  bool accept();
+  /**
+   * @brief Read a page.
+   * @param page The (0-based) page index
+   */
+  template <typename TRaster>
+  TRaster read(Index page = 0) const
+  {
+    return read<TRaster>(ParallelPolicy(1), page);
+  }
 
+  /**
+   * @brief Read a page with several threads.
+   * @param policy The parallel execution policy
+   * @param page The (0-based) page index
+   *
+   * Strips or tiles are split into one group per thread, and each thread decodes its group
+   * through its own file handle.
+   */
   template <typename TRaster>
-  TRaster read()
+  TRaster read(const ParallelPolicy& policy, Index page = 0) const
   {
-    std::uint32_t width, height;
-    TIFFGetField(m_tif, TIFFTAG_IMAGEWIDTH, &width);
-    TIFFGetField(m_tif, TIFFTAG_IMAGELENGTH, &height);
-    TRaster out({width, height});
-    TIFFReadRGBAImage(m_tif, w, h, out.data(), 0);
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 2 || N == 3, "TIFF pages are read as 2D or 3D (samples) rasters.");
+    auto tif = open('r');
+    const auto layout = read_layout<typename TRaster::Value>(tif.get(), page);
+    Position<N> shape;
+    if constexpr (N == 2) {
+      if (layout.samples != 1) {
+        throw FileFormatError("Cannot read " + std::to_string(layout.samples) + "-sample page as 2D raster", m_path);
+      }
+      shape = {layout.width, layout.height};
+    } else {
+      shape = {layout.samples, layout.width, layout.height};
+    }
+    tif.reset();
+    TRaster out(shape);
+    read_page(policy, layout, page, out.data());
     return out;
   }
 
+  /**
+   * @brief Read all the pages, stacked along the last axis.
+   *
+   * All the pages must have the same shape and type.
+   */
   template <typename TRaster>
-  void write(const TRaster& raster);
+  TRaster read_pages(const ParallelPolicy& policy = ParallelPolicy(1)) const
+  {
+    using T = typename TRaster::Value;
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 3 || N == 4, "TIFF pages are stacked as 3D or 4D (samples) rasters.");
+    auto tif = open('r');
+    const Index count = TIFFNumberOfDirectories(tif.get());
+    std::vector<Layout> layouts;
+    for (Index p = 0; p < count; ++p) {
+      layouts.push_back(read_layout<T>(tif.get(), p));
+      const auto& l = layouts.back();
+      const auto& l0 = layouts.front();
+      if (l.width != l0.width || l.height != l0.height || l.samples != l0.samples) {
+        throw FileFormatError("Page " + std::to_string(p) + " shape differs from that of page 0", m_path);
+      }
+    }
+    tif.reset();
+    const auto& l0 = layouts.front();
+    Position<N> shape;
+    if constexpr (N == 3) {
+      if (l0.samples != 1) {
+        throw FileFormatError("Cannot read " + std::to_string(l0.samples) + "-sample pages as 3D raster", m_path);
+      }
+      shape = {l0.width, l0.height, count};
+    } else {
+      shape = {l0.samples, l0.width, l0.height, count};
+    }
+    TRaster out(shape);
+    const auto page_size = l0.width * l0.height * l0.samples;
+    for (Index p = 0; p < count; ++p) {
+      read_page(policy, layouts[p], p, out.data() + p * page_size);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Write a raster as a page.
+   * @param raster The raster, of shape `{width, height}` or `{samples, width, height}`
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append a page
+   */
+  template <typename TRaster>
+  void write(const TRaster& raster, char mode = 'x') const
+  {
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 2 || N == 3, "TIFF pages are written from 2D or 3D (samples) rasters.");
+    const auto& shape = raster.shape();
+    auto tif = open(mode);
+    write_page(tif.get(), raster.data(), N == 2 ? 1 : shape[0], shape[N - 2], shape[N - 1]);
+  }
+
+  /**
+   * @brief Write a raster as pages, i.e. one page per section along the last axis.
+   * @param raster The raster, of shape `{width, height, pages}` or `{samples, width, height, pages}`
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append the pages
+   */
+  template <typename TRaster>
+  void write_pages(const TRaster& raster, char mode = 'x') const
+  {
+    static constexpr Index N = TRaster::Dimension;
+    static_assert(N == 3 || N == 4, "TIFF pages are written from 3D or 4D (samples) rasters.");
+    const auto& shape = raster.shape();
+    const Index samples = N == 3 ? 1 : shape[0];
+    const auto width = shape[N - 3];
+    const auto height = shape[N - 2];
+    auto tif = open(mode);
+    for (Index p = 0; p < shape[N - 1]; ++p) {
+      write_page(tif.get(), raster.data() + p * samples * width * height, samples, width, height);
+    }
+  }
 
 private:
 
-  TIFF* m_tif;
+  /**
+   * @brief A libtiff file handle.
+   */
+  using Handle = std::unique_ptr<TIFF, void (*)(TIFF*)>;
+
+  /**
+   * @brief The geometry and storage of a page.
+   */
+  struct Layout {
+    Index width;
+    Index height;
+    Index samples;
+    bool tiled;
+    Index block_width; ///< The tile width, or image width for strips
+    Index block_height; ///< The tile height, or rows per strip
+    Index block_count;
+  };
+
+  /**
+   * @brief Open the file according to some mode.
+   */
+  Handle open(char mode) const
+  {
+    if (mode == 'r') {
+      FileNotFoundError::may_throw(m_path);
+    } else if (mode == 'x') {
+      PathExistsError::may_throw(m_path);
+    }
+    const char* flags = mode == 'r' ? "r" : mode == 'a' ? "a" : "w";
+    TIFF* tif = TIFFOpen(m_path.c_str(), flags);
+    if (not tif) {
+      throw FileFormatError("Cannot open file", m_path);
+    }
+    return Handle(tif, [](TIFF* t) {
+      TIFFClose(t);
+    });
+  }
+
+  /**
+   * @brief Get the sample format of some type.
+   */
+  template <typename T>
+  static constexpr int sample_format()
+  {
+    if constexpr (std::is_floating_point_v<T>) {
+      return SAMPLEFORMAT_IEEEFP;
+    }
+    if constexpr (std::is_signed_v<T>) {
+      return SAMPLEFORMAT_INT;
+    }
+    return SAMPLEFORMAT_UINT;
+  }
+
+  /**
+   * @brief Move to some page and read its layout, checking that its values are of type `T`.
+   */
+  template <typename T>
+  Layout read_layout(TIFF* tif, Index page) const
+  {
+    if (not TIFFSetDirectory(tif, static_cast<tdir_t>(page))) {
+      throw FileFormatError("Cannot move to page " + std::to_string(page), m_path);
+    }
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint16_t samples = 1;
+    std::uint16_t bits = 1;
+    std::uint16_t format = SAMPLEFORMAT_UINT;
+    std::uint16_t planar = PLANARCONFIG_CONTIG;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samples);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bits);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &format);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+    if (bits != 8 * sizeof(T) || format != sample_format<T>()) {
+      throw FileFormatError(
+          "Cannot read " + std::to_string(bits) + "-bit samples of format " + std::to_string(format) +
+              " as values of " + std::to_string(8 * sizeof(T)) + " bits",
+          m_path);
+    }
+    if (samples > 1 && planar != PLANARCONFIG_CONTIG) {
+      throw FileFormatError("Cannot read planar samples", m_path);
+    }
+    Layout out {width, height, samples, TIFFIsTiled(tif) != 0, width, height, 0};
+    if (out.tiled) {
+      std::uint32_t tile_width = 0;
+      std::uint32_t tile_height = 0;
+      TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tile_width);
+      TIFFGetField(tif, TIFFTAG_TILELENGTH, &tile_height);
+      out.block_width = tile_width;
+      out.block_height = tile_height;
+      out.block_count = TIFFNumberOfTiles(tif);
+    } else {
+      std::uint32_t rows = height;
+      TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rows);
+      out.block_height = std::min<Index>(rows, height);
+      out.block_count = TIFFNumberOfStrips(tif);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Decode the strips or tiles of a page into some contiguous storage.
+   */
+  template <typename T>
+  void read_page(const ParallelPolicy& policy, const Layout& layout, Index page, T* data) const
+  {
+    const auto pixel_size = layout.samples;
+    const auto row_size = layout.width * pixel_size;
+    const auto tiles_per_row = (layout.width + layout.block_width - 1) / std::max<Index>(layout.block_width, 1);
+    std::vector<char> failures(layout.block_count, false);
+    Internal::parallel_chunks(policy.thread_count(), layout.block_count, [&](Index front, Index back) {
+      TIFF* tif = TIFFOpen(m_path.c_str(), "r");
+      if (not tif || not TIFFSetDirectory(tif, static_cast<tdir_t>(page))) {
+        failures[front] = true;
+        if (tif) {
+          TIFFClose(tif);
+        }
+        return;
+      }
+      std::vector<T> tile(layout.tiled ? layout.block_width * layout.block_height * pixel_size : 0);
+      for (auto b = front; b < back; ++b) {
+        const auto y0 = (layout.tiled ? b / tiles_per_row : b) * layout.block_height;
+        const auto rows = std::min(layout.block_height, layout.height - y0);
+        if (not layout.tiled) {
+          const auto size = static_cast<tmsize_t>(rows * row_size * sizeof(T));
+          failures[b] = TIFFReadEncodedStrip(tif, static_cast<std::uint32_t>(b), data + y0 * row_size, size) < 0;
+          continue;
+        }
+        const auto x0 = b % tiles_per_row * layout.block_width;
+        const auto columns = std::min(layout.block_width, layout.width - x0);
+        const auto size = static_cast<tmsize_t>(tile.size() * sizeof(T));
+        failures[b] = TIFFReadEncodedTile(tif, static_cast<std::uint32_t>(b), tile.data(), size) < 0;
+        for (Index y = 0; y < rows; ++y) {
+          const auto* src = tile.data() + y * layout.block_width * pixel_size;
+          std::copy_n(src, columns * pixel_size, data + (y0 + y) * row_size + x0 * pixel_size);
+        }
+      }
+      TIFFClose(tif);
+    });
+    for (auto f : failures) {
+      if (f) {
+        throw FileFormatError("Cannot decode page " + std::to_string(page), m_path);
+      }
+    }
+  }
+
+  /**
+   * @brief Write a page from some contiguous storage, in strips of about 64 kB.
+   */
+  template <typename T>
+  void write_page(TIFF* tif, const T* data, Index samples, Index width, Index height) const
+  {
+    using Value = std::decay_t<T>;
+    const auto row_size = width * samples;
+    const auto rows = std::max<Index>(1, (Index(1) << 16) / std::max<Index>(row_size * sizeof(Value), 1));
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, static_cast<std::uint32_t>(width));
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, static_cast<std::uint32_t>(height));
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, static_cast<std::uint16_t>(samples));
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, static_cast<std::uint16_t>(8 * sizeof(Value)));
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, static_cast<std::uint16_t>(sample_format<Value>()));
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, static_cast<std::uint16_t>(PLANARCONFIG_CONTIG));
+    TIFFSetField(
+        tif,
+        TIFFTAG_PHOTOMETRIC,
+        static_cast<std::uint16_t>(samples >= 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK));
+    if (samples == 2 || samples == 4) {
+      std::uint16_t extra = EXTRASAMPLE_UNASSALPHA;
+      TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, static_cast<std::uint16_t>(1), &extra);
+    }
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, static_cast<std::uint32_t>(rows));
+    for (Index y0 = 0, s = 0; y0 < height; y0 += rows, ++s) {
+      const auto size = static_cast<tmsize_t>(std::min(rows, height - y0) * row_size * sizeof(Value));
+      auto* strip = const_cast<Value*>(data + y0 * row_size); // Not modified
+      if (TIFFWriteEncodedStrip(tif, static_cast<std::uint32_t>(s), strip, size) < 0) {
+        throw FileFormatError("Cannot write strip " + std::to_string(s), m_path);
+      }
+    }
+    if (not TIFFWriteDirectory(tif)) {
+      throw FileFormatError("Cannot write page", m_path);
+    }
+  }
+
+  /**
+   * @brief The file path.
+   */
+  std::filesystem::path m_path;
 };
 
 } // namespace Linx
@@ -0,0 +1,95 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(AsyncFits_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(bounded_queue_test)
+{
+  Internal::BoundedQueue<int> queue(2);
+  std::thread producer([&]() {
+    for (int i = 0; i < 100; ++i) {
+      queue.push(i);
+    }
+    queue.close();
+  });
+  int expected = 0;
+  while (auto i = queue.pop()) {
+    BOOST_TEST(*i == expected);
+    ++expected;
+  }
+  producer.join();
+  BOOST_TEST(expected == 100);
+  BOOST_TEST(not queue.push(100));
+}
+
+BOOST_AUTO_TEST_CASE(async_write_read_test)
+{
+  TemporaryPath path("async.fits");
+  std::vector<Raster<int>> rasters;
+  for (int i = 0; i < 5; ++i) {
+    rasters.push_back(Raster<int>({8, 6}).fill(i));
+  }
+  AsyncFitsWriter writer(2);
+  writer.write(path, Raster<int, 0>(), 'w'); // Empty Primary
+  for (const auto& r : rasters) {
+    writer.write(path, r, 'a');
+  }
+  writer.wait();
+
+  std::vector<FitsHdu> hdus;
+  for (Index i = 1; i <= 5; ++i) {
+    hdus.push_back({path, i});
+  }
+  AsyncFitsReader<Raster<int>> reader(hdus, 2);
+  std::size_t count = 0;
+  while (auto raster = reader.next()) {
+    BOOST_TEST(*raster == rasters[count]);
+    ++count;
+  }
+  BOOST_TEST(count == rasters.size());
+}
+
+BOOST_AUTO_TEST_CASE(async_session_append_test)
+{
+  TemporaryPath path("async_session.fits");
+  const auto raster = Raster<float>({4, 3}).range();
+  {
+    FitsSession session(path, 'x');
+    AsyncFitsWriter writer;
+    writer.append(session, raster);
+    writer.append(session, raster * 2);
+    writer.wait();
+  }
+  BOOST_TEST(Fits(path).read<Raster<float>>(1) == raster * 2);
+}
+
+BOOST_AUTO_TEST_CASE(write_after_wait_throws_test)
+{
+  TemporaryPath path("async_closed.fits");
+  AsyncFitsWriter writer;
+  writer.wait();
+  BOOST_CHECK_THROW(writer.write(path, Raster<float>({4, 3})), Exception);
+  BOOST_TEST(not std::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(async_read_error_test)
+{
+  AsyncFitsReader<Raster<int>> reader({{"no_such_file.fits", 0}});
+  BOOST_CHECK_THROW(reader.next(), FileNotFoundError);
+  BOOST_TEST(not reader.next());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
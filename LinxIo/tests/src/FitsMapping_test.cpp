@@ -0,0 +1,69 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FitsMapping_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(byteswap_test)
+{
+  std::vector<std::int32_t> values {0x01020304, -1, 0};
+  Internal::byteswap_n(values.data(), values.size());
+  BOOST_TEST(values[0] == 0x04030201);
+  BOOST_TEST(values[1] == -1);
+  Internal::byteswap_n(values.data(), values.size());
+  BOOST_TEST(values[0] == 0x01020304);
+}
+
+BOOST_AUTO_TEST_CASE(region_map_test)
+{
+  Raster<float, 3> in({5, 4, 7});
+  in.range();
+  TemporaryPath path("cube.fits");
+  write(in, path);
+  FitsMapping<float, 3> mapping(path);
+  BOOST_TEST(mapping.shape() == in.shape());
+  BOOST_TEST((mapping[{1, 2, 3}] == in[{1, 2, 3}]));
+  const Box<3> region({1, 1, 2}, {3, 2, 4});
+  BOOST_TEST((Raster<float, 3>(mapping(region)) == Raster<float, 3>(in(region))));
+  BOOST_TEST(mapping.section(6) == in.section(6));
+  BOOST_TEST(mapping.raster() == in);
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write_test)
+{
+  Raster<short> in({6, 3});
+  in.range();
+  TemporaryPath path("image.fits");
+  write(in, path);
+  {
+    FitsMapping<short> mapping(path);
+    mapping.raster().fill(0);
+  }
+  BOOST_TEST(read<short>(path) == in);
+}
+
+BOOST_AUTO_TEST_CASE(unmappable_test)
+{
+  Raster<float> in({6, 3});
+  in.range();
+  TemporaryPath path("image.fits");
+  Fits(path).write(in, FitsCompression {FitsCompression::Algorithm::Gzip, {}, 0});
+  BOOST_CHECK_THROW((FitsMapping<float>(path)), FileFormatError);
+  TemporaryPath other("other.fits");
+  write(in, other);
+  BOOST_CHECK_THROW((FitsMapping<double>(other)), FileFormatError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
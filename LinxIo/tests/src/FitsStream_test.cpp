@@ -0,0 +1,74 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Tiling.h"
+#include "Linx/Io.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FitsStream_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(chunk_read_test)
+{
+  Raster<int, 3> in({5, 4, 7});
+  in.range();
+  TemporaryPath path("cube.fits");
+  write(in, path);
+  FitsChunkReader<int, 3> reader(path, 3);
+  BOOST_TEST(reader.shape() == in.shape());
+  Index count = 0;
+  while (reader.next()) {
+    const auto& domain = reader.domain();
+    BOOST_TEST(domain.shape()[2] == (count < 2 ? 3 : 1));
+    BOOST_TEST((reader.chunk() == Raster<int, 3>(in(domain))));
+    ++count;
+  }
+  BOOST_TEST(count == 3);
+  BOOST_TEST(not reader.next());
+}
+
+BOOST_AUTO_TEST_CASE(chunk_write_test)
+{
+  Raster<float> in({6, 10});
+  in.range();
+  TemporaryPath path("rows.fits");
+  {
+    FitsChunkWriter<float> writer(path, in.shape());
+    for (const auto& part : chunks(in, 4)) {
+      BOOST_TEST(not writer.done());
+      writer.write(part);
+    }
+    BOOST_TEST(writer.done());
+    BOOST_CHECK_THROW(writer.write(Raster<float>({6, 1})), OutOfBoundsError);
+    BOOST_CHECK_THROW(writer.write(Raster<float>({5, 1})), SizeError);
+  }
+  BOOST_TEST(read<float>(path) == in);
+}
+
+BOOST_AUTO_TEST_CASE(chunk_read_write_test)
+{
+  Raster<short, 3> in({4, 3, 5});
+  in.range();
+  TemporaryPath input("in.fits");
+  TemporaryPath output("out.fits");
+  write(in, input);
+  FitsChunkReader<short, 3> reader(input);
+  FitsChunkWriter<short, 3> writer(output, reader.shape());
+  while (reader.next()) {
+    reader.chunk() *= 2;
+    writer.write(reader.chunk());
+  }
+  writer.close();
+  BOOST_TEST((read<short, 3>(output) == in * 2));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Tiling.h"
 #include "Linx/Io.h"
+#include "Linx/Transforms/Extrapolation.h"
 
 #include <boost/test/unit_test.hpp>
 #include <fstream>
@@ -79,6 +81,146 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(auto_append_read_test, T, SupportedFitsTypes)
   BOOST_TEST(out == in);
 }
 
+BOOST_AUTO_TEST_CASE(quantized_write_read_test)
+{
+  Raster<float> in({16, 16});
+  in.range(-100, 0.5);
+  TemporaryPath path("quantized.fits");
+  Fits io(path);
+  io.write_quantized<short>(in, 0.5, 10);
+  const auto out = io.read<Raster<float>>();
+  BOOST_TEST(out == in);
+}
+
+BOOST_AUTO_TEST_CASE(patch_write_read_test)
+{
+  Raster<short> in({16, 12});
+  in.range();
+  const Box<2> region({3, 2}, {9, 5});
+  TemporaryPath path("patch.fits");
+  Fits io(path);
+  io.write(in(region));
+  const auto out = io.read<Raster<short>>();
+  BOOST_TEST(out == Raster<short>(in(region)));
+
+  const auto extrapolated = extrapolation(in, short(0))(in.domain() + 2);
+  io.write(extrapolated, 'w');
+  BOOST_TEST(io.read<Raster<short>>() == Raster<short>(extrapolated));
+}
+
+BOOST_AUTO_TEST_CASE(region_read_test)
+{
+  Raster<int> in({16, 12});
+  in.range();
+  TemporaryPath path("region.fits");
+  write(in, path);
+  const Box<2> region({3, 2}, {9, 5});
+  const auto out = read<int>(path, region);
+  BOOST_TEST(out.shape() == region.shape());
+  for (const auto& p : region) {
+    BOOST_TEST(out[p - region.front()] == in[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(tile_wise_write_test)
+{
+  Raster<float> in({16, 12});
+  in.range();
+  TemporaryPath path("tiles.fits");
+  Fits io(path);
+  io.create<float>(in.shape());
+  for (const auto& patch : tiles(in, Position<2>({5, 4}))) {
+    Raster<float> tile(patch.domain().shape());
+    std::copy(patch.begin(), patch.end(), tile.begin());
+    io.write(tile, patch.domain());
+  }
+  BOOST_TEST(io.read<Raster<float>>() == in);
+  BOOST_CHECK_THROW(io.write(in, Box<2>::from_shape({0, 0}, {2, 2})), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(session_append_read_test)
+{
+  Raster<int> a({16, 12});
+  a.range();
+  Raster<float> b({8, 6});
+  b.range(1, .5);
+  TemporaryPath path("session.fits");
+  {
+    FitsSession session(path, 'x');
+    BOOST_TEST(session.append(a) == 0);
+    BOOST_TEST(session.append(b) == 1);
+    BOOST_TEST(session.append(a) == 2);
+    BOOST_TEST(session.hdu_count() == 3);
+    BOOST_TEST(session.read<Raster<float>>(1) == b);
+  }
+  FitsSession session(path, 'a');
+  BOOST_TEST(session.read<Raster<int>>(2) == a);
+  BOOST_TEST(session.read<Raster<int>>(0) == a);
+  const Box<2> region({1, 2}, {4, 3});
+  const Raster<int> zeros(region.shape());
+  session.write(zeros, region, 2);
+  BOOST_TEST(session.read<Raster<int>>(region, 2) == zeros);
+  session.close();
+  BOOST_TEST(Fits(path).read<Raster<float>>(1) == b);
+}
+
+BOOST_AUTO_TEST_CASE(compressed_write_read_test)
+{
+  Raster<int> in({64, 40});
+  in.range();
+  TemporaryPath path("compressed.fits");
+  Fits io(path);
+  FitsCompression compression;
+  compression.tile = {64, 8};
+  io.write(in, compression);
+  BOOST_TEST(io.read<Raster<int>>(1) == in); // Compressed image in an extension
+  BOOST_TEST(io.read<Raster<int>>(par(3), 1) == in);
+}
+
+BOOST_AUTO_TEST_CASE(lossless_float_compression_test)
+{
+  Raster<float> in({30, 20});
+  in.range(-1, .01);
+  TemporaryPath path("gzip.fits");
+  Fits io(path);
+  FitsCompression compression;
+  compression.algorithm = FitsCompression::Algorithm::ShuffledGzip;
+  compression.quantization = 0;
+  io.write(in, compression);
+  BOOST_TEST(io.read<Raster<float>>(par, 1) == in);
+}
+
+BOOST_AUTO_TEST_CASE(header_queries_test)
+{
+  TemporaryPath path("header.fits");
+  Fits io(path);
+  io.write(Raster<short, 3>({4, 3, 2}));
+  io.write(Raster<float>({5, 6}), 'a');
+  BOOST_TEST(io.hdu_count() == 2);
+  BOOST_TEST(io.shape<3>() == Position<3>({4, 3, 2}));
+  BOOST_TEST(io.shape(1) == Position<2>({5, 6}));
+  BOOST_TEST(io.shape<-1>(1).size() == 2);
+  BOOST_TEST(io.bitpix() == Fits::bitpix<short>());
+  BOOST_TEST(io.bitpix(1) == Fits::bitpix<float>());
+}
+
+BOOST_AUTO_TEST_CASE(read_to_test)
+{
+  TemporaryPath path("read_to.fits");
+  Fits io(path);
+  const auto in = Raster<float>({16, 9}).range();
+  io.write(in);
+  AlignedRaster<float> aligned(in.shape());
+  io.read_to(aligned);
+  BOOST_TEST(aligned == in);
+  std::vector<float> buffer(in.size());
+  PtrRaster<float> view(in.shape(), buffer.data());
+  io.read_to(view);
+  BOOST_TEST(view == in);
+  Raster<float> transposed({9, 16});
+  BOOST_CHECK_THROW(io.read_to(transposed), SizeError);
+}
+
 BOOST_AUTO_TEST_CASE(auto_read_wrong_format_test)
 {
   TemporaryPath path("dummy.txt"); // FIXME .fits
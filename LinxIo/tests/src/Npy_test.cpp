@@ -0,0 +1,70 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Npy.h"
+#include "Linx/Io/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Npy_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(dtype_test)
+{
+  BOOST_TEST(Npy::dtype<unsigned char>() == "|u1");
+  BOOST_TEST(Npy::dtype<std::int16_t>().substr(1) == "i2");
+  BOOST_TEST(Npy::dtype<const float>().substr(1) == "f4");
+  BOOST_TEST(Npy::dtype<std::complex<double>>().substr(1) == "c16");
+}
+
+BOOST_AUTO_TEST_CASE(write_read_test)
+{
+  Raster<float, 3> in({5, 4, 3});
+  in.range();
+  TemporaryPath path("raster.npy");
+  Npy npy(path);
+  npy.write(in);
+  BOOST_TEST(std::filesystem::file_size(path) == Npy::header_size + in.size() * sizeof(float));
+  BOOST_TEST(npy.dtype() == Npy::dtype<float>());
+  BOOST_TEST(npy.shape<3>() == in.shape());
+  BOOST_TEST((npy.read<Raster<float, 3>>() == in));
+  BOOST_CHECK_THROW(npy.write(in), PathExistsError);
+  BOOST_CHECK_THROW((npy.read<Raster<double, 3>>()), FileFormatError);
+  BOOST_CHECK_THROW((npy.read<Raster<float, 2>>()), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(direct_write_map_test)
+{
+  AlignedRaster<int> in({1000, 3}); // Not a multiple of the page size
+  in.range();
+  TemporaryPath path("direct.npy");
+  Npy npy(path);
+  npy.write(in, 'w', Npy::Access::Direct);
+  const auto mapped = npy.map<const int>();
+  BOOST_TEST(mapped == in);
+  BOOST_TEST(reinterpret_cast<std::uintptr_t>(mapped.data()) % Npy::header_size == 0);
+}
+
+BOOST_AUTO_TEST_CASE(map_write_test)
+{
+  Raster<short> in({7, 2});
+  in.range();
+  TemporaryPath path("mapped.npy");
+  Npy npy(path);
+  npy.write(in);
+  {
+    auto mapped = npy.map<short>(MmapMode::ReadWrite);
+    mapped *= 2;
+  }
+  BOOST_TEST(npy.read<Raster<short>>() == in * 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Temporary.h"
+#include "LinxIo/Png.h"
+
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Png_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(gray_write_read_test)
+{
+  Raster<unsigned char> in({13, 7});
+  in.range();
+  TemporaryPath path("gray.png");
+  Png png(path);
+  BOOST_TEST(not png.accept());
+  png.write(in);
+  BOOST_TEST(png.accept());
+  BOOST_TEST(png.read<Raster<unsigned char>>() == in);
+  BOOST_CHECK_THROW(png.write(in), PathExistsError);
+}
+
+BOOST_AUTO_TEST_CASE(rgba16_write_read_test)
+{
+  Raster<std::uint16_t, 3> in({4, 9, 5});
+  for (auto& e : in) {
+    e = static_cast<std::uint16_t>(&e - in.data()) * 257;
+  }
+  TemporaryPath path("rgba.png");
+  Png png(path);
+  png.write(in, {6, PngCompression::Filter::Adaptive, PngCompression::Strategy::Default});
+  BOOST_TEST((png.read<Raster<std::uint16_t, 3>>() == in));
+  BOOST_CHECK_THROW((png.read<Raster<std::uint16_t>>()), FileFormatError);
+}
+
+BOOST_AUTO_TEST_CASE(bit_depth_conversion_test)
+{
+  Raster<std::uint16_t, 3> in({3, 6, 2});
+  for (auto& e : in) {
+    e = static_cast<std::uint16_t>((&e - in.data()) * 257);
+  }
+  TemporaryPath path("rgb.png");
+  Png png(path);
+  png.write(in, {0, PngCompression::Filter::None}, 'w');
+  const auto out = png.read<Raster<unsigned char, 3>>();
+  BOOST_TEST(out.shape() == in.shape());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(out.data()[i] == in.data()[i] / 257);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(not_png_test)
+{
+  TemporaryPath path("not.png");
+  { std::ofstream(std::filesystem::path(path)) << "Not a PNG file"; }
+  Png png(path);
+  BOOST_TEST(not png.accept());
+  BOOST_CHECK_THROW((png.read<Raster<unsigned char>>()), FileFormatError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
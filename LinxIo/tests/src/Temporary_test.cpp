@@ -0,0 +1,66 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Temporary.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Temporary_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(path_policy_test)
+{
+  std::filesystem::path copy;
+  {
+    TemporaryPath path("scratch.txt", {{ScratchLocation::Memory, ScratchLocation::Temporary}});
+    copy = path;
+    BOOST_TEST(copy.parent_path() == std::filesystem::temp_directory_path()); // Memory skipped
+    std::ofstream(copy) << "scratch";
+    BOOST_TEST(std::filesystem::exists(copy));
+  }
+  BOOST_TEST(not std::filesystem::exists(copy));
+}
+
+BOOST_AUTO_TEST_CASE(memory_buffer_map_test)
+{
+  const Position<2> shape {16, 8};
+  TemporaryBuffer buffer("memory", shape_size(shape) * sizeof(int), {{ScratchLocation::Memory}});
+  BOOST_TEST((buffer.location() == ScratchLocation::Memory));
+  BOOST_TEST(buffer.size() == 128 * sizeof(int));
+  {
+    MmapRaster<int> raster(shape, buffer.path().string(), MmapMode::ReadWrite);
+    raster.range();
+  }
+  MmapRaster<const int> raster(shape, buffer.path().string());
+  BOOST_TEST((raster[{15, 7}] == 127));
+}
+
+BOOST_AUTO_TEST_CASE(budget_fallback_test)
+{
+  ScratchPolicy policy {{ScratchLocation::Memory, ScratchLocation::Temporary}, 1000};
+  TemporaryBuffer first("first", 600, policy);
+  BOOST_TEST((first.location() == ScratchLocation::Memory));
+  std::filesystem::path path;
+  {
+    TemporaryBuffer second("second", 600, policy); // Over budget
+    BOOST_TEST((second.location() == ScratchLocation::Temporary));
+    path = second.path();
+    BOOST_TEST(std::filesystem::file_size(path) == 600);
+  }
+  BOOST_TEST(not std::filesystem::exists(path));
+  TemporaryBuffer third("third", 400, policy);
+  BOOST_TEST((third.location() == ScratchLocation::Memory));
+  BOOST_CHECK_THROW(TemporaryBuffer("fourth", 1, {{ScratchLocation::Memory}, 1000}), Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
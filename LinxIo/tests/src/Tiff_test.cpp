@@ -0,0 +1,63 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Io/Temporary.h"
+#include "LinxIo/Tiff.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Tiff_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(gray_write_read_test)
+{
+  Raster<std::uint16_t> in({300, 500}); // Several strips
+  in.range();
+  TemporaryPath path("gray.tif");
+  Tiff tiff(path);
+  BOOST_TEST(not tiff.accept());
+  tiff.write(in);
+  BOOST_TEST(tiff.accept());
+  BOOST_TEST(tiff.page_count() == 1);
+  BOOST_TEST(tiff.read<Raster<std::uint16_t>>() == in);
+  BOOST_TEST(tiff.read<Raster<std::uint16_t>>(par(3)) == in);
+  BOOST_CHECK_THROW(tiff.write(in), PathExistsError);
+  BOOST_CHECK_THROW(tiff.read<Raster<float>>(), FileFormatError);
+  BOOST_CHECK_THROW((tiff.read<Raster<std::uint16_t, 3>>(1)), FileFormatError);
+}
+
+BOOST_AUTO_TEST_CASE(rgb_write_read_test)
+{
+  Raster<unsigned char, 3> in({3, 7, 5});
+  in.range();
+  TemporaryPath path("rgb.tif");
+  Tiff tiff(path);
+  tiff.write(in);
+  BOOST_TEST((tiff.read<Raster<unsigned char, 3>>() == in));
+  BOOST_CHECK_THROW(tiff.read<Raster<unsigned char>>(), FileFormatError);
+}
+
+BOOST_AUTO_TEST_CASE(multi_page_write_read_test)
+{
+  Raster<float, 3> in({6, 4, 3});
+  in.range();
+  TemporaryPath path("stack.tif");
+  Tiff tiff(path);
+  tiff.write_pages(in);
+  BOOST_TEST(tiff.page_count() == 3);
+  BOOST_TEST((tiff.read_pages<Raster<float, 3>>() == in));
+  BOOST_TEST(tiff.read<Raster<float>>(2) == in.section(2));
+  tiff.write(in.section(0), 'a');
+  BOOST_TEST(tiff.page_count() == 4);
+  BOOST_TEST(tiff.read<Raster<float>>(3) == in.section(0));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
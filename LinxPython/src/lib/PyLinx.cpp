@@ -0,0 +1,411 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BufferView.h"
+#include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm> // copy, reverse
+#include <complex>
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include <type_traits> // decay_t, integral_constant
+#include <utility> // declval, move
+
+namespace py = pybind11;
+
+namespace Linx {
+namespace Python {
+
+/**
+ * @brief A NumPy array of given value type.
+ *
+ * Arrays are not force-cast, such that arrays of the right type are passed as is, with their strides.
+ */
+template <typename T>
+using Array = py::array_t<T, 0>;
+
+/**
+ * @brief A C-contiguous NumPy array of given value type.
+ */
+template <typename T>
+using ContiguousArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief Call a function with the dimension of an array as an integral constant.
+ */
+template <typename TFunc>
+py::array with_dimension(Index dimension, TFunc&& func)
+{
+  switch (dimension) {
+    case 2:
+      return func(std::integral_constant<Index, 2>());
+    case 3:
+      return func(std::integral_constant<Index, 3>());
+    default:
+      throw py::value_error("Unsupported array dimension: " + std::to_string(dimension) + " (expected 2 or 3)");
+  }
+}
+
+/**
+ * @brief Check the name of a boundary condition.
+ */
+void check_boundary(const std::string& boundary)
+{
+  if (boundary != "nearest" && boundary != "periodic" && boundary != "zero") {
+    throw py::value_error("Unknown boundary: " + boundary + " (expected nearest, periodic or zero)");
+  }
+}
+
+/**
+ * @brief Call a function with an extrapolator of given boundary condition.
+ */
+template <typename TRaster, typename TFunc>
+void with_boundary(const TRaster& in, const std::string& boundary, TFunc&& func)
+{
+  using T = std::decay_t<typename TRaster::Value>;
+  if (boundary == "nearest") {
+    func(extrapolation<Nearest>(in));
+  } else if (boundary == "periodic") {
+    func(extrapolation<Periodic>(in));
+  } else {
+    func(extrapolation<Constant<T>>(in, T(0)));
+  }
+}
+
+/**
+ * @brief Call a function with an interpolation method given by its order, like in `scipy.ndimage`.
+ */
+template <typename TFunc>
+py::array with_interpolation(Index order, TFunc&& func)
+{
+  switch (order) {
+    case 0:
+      return func(Nearest());
+    case 1:
+      return func(Linear());
+    case 3:
+      return func(Cubic());
+    default:
+      throw py::value_error("Unsupported interpolation order: " + std::to_string(order) + " (expected 0, 1 or 3)");
+  }
+}
+
+/**
+ * @brief Call a function with a read-only contiguous raster view of an array.
+ *
+ * C-contiguous arrays are viewed without copy, while other arrays, e.g. slices or transposes,
+ * are first copied to contiguous memory, once.
+ */
+template <typename T, Index N, typename TArray, typename TFunc>
+void with_raster(const TArray& in, TFunc&& func)
+{
+  if (not(in.flags() & py::array::c_style)) {
+    with_raster<T, N>(ContiguousArray<T>::ensure(in), std::forward<TFunc>(func));
+    return;
+  }
+  const auto info = in.request();
+  func(buffer_raster<const T, N>(static_cast<const T*>(info.ptr), info.shape, info.strides));
+}
+
+/**
+ * @brief Get the output array of a filter, which is either provided or allocated.
+ */
+template <typename T>
+Array<T> output_array(const Array<T>& in, const py::object& out)
+{
+  if (out.is_none()) {
+    return Array<T>(std::vector<py::ssize_t>(in.shape(), in.shape() + in.ndim()));
+  }
+  if (not py::isinstance<Array<T>>(out)) {
+    throw py::type_error("Output array must have the same value type as the input array");
+  }
+  auto array = out.cast<Array<T>>();
+  if (array.ndim() != in.ndim() || not std::equal(in.shape(), in.shape() + in.ndim(), array.shape())) {
+    throw py::value_error("Output array must have the same shape as the input array");
+  }
+  return array;
+}
+
+/**
+ * @brief Move a raster to a NumPy array, without copy.
+ *
+ * The array owns the raster, which is deleted when the array is garbage-collected.
+ */
+template <typename T, Index N, typename THolder>
+Array<T> to_array(Raster<T, N, THolder>&& raster)
+{
+  auto* owned = new Raster<T, N, THolder>(std::move(raster));
+  py::capsule owner(owned, [](void* ptr) {
+    delete static_cast<Raster<T, N, THolder>*>(ptr);
+  });
+  return Array<T>(buffer_shape(*owned), buffer_strides(*owned), owned->data(), owner);
+}
+
+/**
+ * @brief Apply a filter to an array.
+ * @param in The input array
+ * @param boundary The boundary condition
+ * @param out The output array, or `None` to allocate it
+ * @param make The filter factory, which takes the dimension as an integral constant
+ *
+ * The filter writes directly to the output array if it is contiguous and does not overlap the input,
+ * or through a temporary raster otherwise, e.g. to filter in place.
+ * The GIL is released during the computation.
+ */
+template <typename T, typename TMake>
+py::array filter_array(const Array<T>& in, const std::string& boundary, const py::object& out, TMake&& make)
+{
+  check_boundary(boundary);
+  return with_dimension(in.ndim(), [&](auto dimension) -> py::array {
+    static constexpr Index N = decltype(dimension)::value;
+    const auto filter = make(dimension);
+    auto output = output_array(in, out);
+    const auto may_share_memory = py::module_::import("numpy").attr("may_share_memory");
+    const auto overlaps = not out.is_none() && py::cast<bool>(may_share_memory(in, output));
+    const auto info = output.request(true);
+    auto dst = buffer_view<T, N>(static_cast<T*>(info.ptr), info.shape, info.strides);
+    with_raster<T, N>(in, [&](const auto& raster) {
+      py::gil_scoped_release release;
+      with_boundary(raster, boundary, [&](const auto& extrapolated) {
+        if (dst.is_contiguous() && not overlaps) {
+          PtrRaster<T, N> contiguous(dst.shape(), dst.data());
+          filter.transform(extrapolated, contiguous);
+        } else {
+          const auto result = filter * extrapolated;
+          std::copy(result.begin(), result.end(), dst.begin());
+        }
+      });
+    });
+    return output;
+  });
+}
+
+/**
+ * @brief Apply a warp to an array.
+ * @param in The input array
+ * @param order The interpolation order
+ * @param boundary The boundary condition
+ * @param warp The warp, which takes the interpolation method and extrapolated raster
+ *
+ * The output is a new array which owns the output raster.
+ * The GIL is released during the computation.
+ */
+template <typename T, typename TWarp>
+py::array warp_array(const Array<T>& in, Index order, const std::string& boundary, TWarp&& warp)
+{
+  check_boundary(boundary);
+  return with_dimension(in.ndim(), [&](auto dimension) -> py::array {
+    static constexpr Index N = decltype(dimension)::value;
+    return with_interpolation(order, [&](auto method) -> py::array {
+      Raster<T, N> result;
+      with_raster<T, N>(in, [&](const auto& raster) {
+        py::gil_scoped_release release;
+        with_boundary(raster, boundary, [&](const auto& extrapolated) {
+          result = warp(method, extrapolated);
+        });
+      });
+      return to_array(std::move(result));
+    });
+  });
+}
+
+/**
+ * @brief Apply a DFT to an array.
+ * @param in The input array
+ * @param transform The transform, which takes a contiguous raster and returns a DFT buffer
+ *
+ * The output is a new array which owns the DFT buffer.
+ * The GIL is released during the computation.
+ */
+template <typename T, typename TTransform>
+py::array dft_array(const Array<T>& in, TTransform&& transform)
+{
+  return with_dimension(in.ndim(), [&](auto dimension) -> py::array {
+    static constexpr Index N = decltype(dimension)::value;
+    std::decay_t<decltype(transform(std::declval<const PtrRaster<const T, N>&>()))> result;
+    with_raster<T, N>(in, [&](const auto& raster) {
+      py::gil_scoped_release release;
+      result = transform(raster);
+    });
+    return to_array(std::move(result));
+  });
+}
+
+/**
+ * @brief Bind the functions of some value type.
+ */
+template <typename T>
+void bind_functions(py::module_& m)
+{
+  using namespace py::literals;
+
+  const auto window_filter = [&](const char* name, const char* doc, auto make) {
+    m.def(
+        name,
+        [=](const Array<T>& in, Index radius, const std::string& boundary, const py::object& out) {
+          return filter_array<T>(in, boundary, out, [&](auto dimension) {
+            return make(Box<decltype(dimension)::value>::from_center(radius));
+          });
+        },
+        doc,
+        "input"_a,
+        "radius"_a = 1,
+        "boundary"_a = "nearest",
+        "out"_a = py::none());
+  };
+  window_filter("mean_filter", "Apply a mean filter over a box of given radius.", [](auto window) {
+    return mean_filter<T>(std::move(window));
+  });
+  window_filter("median_filter", "Apply a median filter over a box of given radius.", [](auto window) {
+    return median_filter<T>(std::move(window));
+  });
+  window_filter("minimum_filter", "Apply a minimum filter over a box of given radius.", [](auto window) {
+    return minimum_filter<T>(std::move(window));
+  });
+  window_filter("maximum_filter", "Apply a maximum filter over a box of given radius.", [](auto window) {
+    return maximum_filter<T>(std::move(window));
+  });
+
+  m.def(
+      "correlate",
+      [](const Array<T>& in, const Array<T>& kernel, const std::string& boundary, const py::object& out) {
+        if (kernel.ndim() != in.ndim()) {
+          throw py::value_error("Kernel must have the same dimension as the input array");
+        }
+        return filter_array<T>(in, boundary, out, [&](auto dimension) {
+          static constexpr Index N = decltype(dimension)::value;
+          Raster<T, N> values;
+          with_raster<T, N>(kernel, [&](const auto& k) {
+            values = Raster<T, N>(k.shape());
+            std::copy(k.begin(), k.end(), values.begin());
+          });
+          return correlation(values);
+        });
+      },
+      "Correlate an array with a kernel, whose origin is at the center.",
+      "input"_a,
+      "kernel"_a,
+      "boundary"_a = "nearest",
+      "out"_a = py::none());
+
+  m.def(
+      "rotate",
+      [](const Array<T>& in, double angle, Index order, const std::string& boundary, Index threads) {
+        return warp_array<T>(in, order, boundary, [&](auto method, const auto& extrapolated) {
+          return rotate_deg<decltype(method)>(extrapolated, angle, 0, 1, threads);
+        });
+      },
+      "Rotate an array around its center by some angle in degrees, in the plane of its two fastest axes.",
+      "input"_a,
+      "angle"_a,
+      "order"_a = 1,
+      "boundary"_a = "zero",
+      "threads"_a = 1);
+
+  m.def(
+      "scale",
+      [](const Array<T>& in, double factor, Index order, const std::string& boundary, Index threads) {
+        return warp_array<T>(in, order, boundary, [&](auto method, const auto& extrapolated) {
+          return scale<decltype(method)>(extrapolated, factor, threads);
+        });
+      },
+      "Scale an array from its center by some factor, without changing its shape.",
+      "input"_a,
+      "factor"_a,
+      "order"_a = 1,
+      "boundary"_a = "zero",
+      "threads"_a = 1);
+
+  m.def(
+      "translate",
+      [](const Array<T>& in, std::vector<double> vector, Index order, const std::string& boundary, Index threads) {
+        if (static_cast<Index>(vector.size()) != in.ndim()) {
+          throw py::value_error("Translation vector must have one component per axis");
+        }
+        std::reverse(vector.begin(), vector.end()); // Row-major to Linx axis order
+        return warp_array<T>(in, order, boundary, [&](auto method, const auto& extrapolated) {
+          static constexpr Index N = std::decay_t<decltype(extrapolated)>::Dimension;
+          Vector<double, N> v;
+          std::copy(vector.begin(), vector.end(), v.begin());
+          return translate<decltype(method)>(extrapolated, v, threads);
+        });
+      },
+      "Translate an array by some vector, given in array axis order.",
+      "input"_a,
+      "vector"_a,
+      "order"_a = 1,
+      "boundary"_a = "zero",
+      "threads"_a = 1);
+
+  using C = std::complex<T>;
+
+  m.def(
+      "dft",
+      [](const Array<T>& in) {
+        return dft_array<T>(in, [](const auto& raster) {
+          return real_dft<T>(raster);
+        });
+      },
+      "Compute the real DFT of an array, whose last axis is halved, like numpy.fft.rfftn().",
+      "input"_a);
+
+  m.def(
+      "inverse_dft",
+      [](const Array<C>& in, const py::object& shape) {
+        std::vector<Index> logical(in.shape(), in.shape() + in.ndim());
+        if (shape.is_none()) {
+          logical.back() = 2 * (logical.back() - 1);
+        } else {
+          logical = shape.cast<std::vector<Index>>();
+          if (static_cast<Index>(logical.size()) != in.ndim()) {
+            throw py::value_error("Shape must have one length per axis");
+          }
+        }
+        std::reverse(logical.begin(), logical.end()); // Row-major to Linx axis order
+        return dft_array<C>(in, [&](const auto& raster) {
+          static constexpr Index N = std::decay_t<decltype(raster)>::Dimension;
+          Position<N> position;
+          std::copy(logical.begin(), logical.end(), position.begin());
+          return inverse_real_dft<T>(raster, position);
+        });
+      },
+      "Compute the normalized inverse real DFT of an array, like numpy.fft.irfftn().",
+      "input"_a,
+      "shape"_a = py::none());
+
+  m.def(
+      "complex_dft",
+      [](const Array<C>& in) {
+        return dft_array<C>(in, [](const auto& raster) {
+          return complex_dft<T>(raster);
+        });
+      },
+      "Compute the complex DFT of an array, like numpy.fft.fftn().",
+      "input"_a);
+
+  m.def(
+      "inverse_complex_dft",
+      [](const Array<C>& in) {
+        return dft_array<C>(in, [](const auto& raster) {
+          return inverse_complex_dft<T>(raster);
+        });
+      },
+      "Compute the normalized inverse complex DFT of an array, like numpy.fft.ifftn().",
+      "input"_a);
+}
+
+} // namespace Python
+} // namespace Linx
+
+PYBIND11_MODULE(pylinx, m)
+{
+  m.doc() = "Python bindings of Linx filters, warps and DFTs, which operate on NumPy arrays without copy.";
+  Linx::Python::bind_functions<float>(m);
+  Linx::Python::bind_functions<double>(m);
+}
@@ -0,0 +1,49 @@
+# @copyright 2022-2024, Antoine Basset (CNES)
+# This file is part of Linx <github.com/kabasset/Linx>
+# SPDX-License-Identifier: Apache-2.0
+
+import unittest
+
+import numpy as np
+import pylinx
+
+
+class PyLinxTest(unittest.TestCase):
+
+    def setUp(self):
+        self.image = np.random.default_rng(0).random((13, 17), dtype=np.float32)
+
+    def test_mean_filter_of_constant(self):
+        image = np.full((7, 9), 3.0)
+        np.testing.assert_allclose(pylinx.mean_filter(image, 1), image)
+
+    def test_in_place_filter(self):
+        expected = pylinx.median_filter(self.image, 1)
+        image = self.image.copy()
+        pylinx.median_filter(image, 1, out=image)
+        np.testing.assert_array_equal(image, expected)
+
+    def test_overlapping_output_filter(self):
+        kernel = np.ones((3, 3), dtype=np.float32)
+        image = np.vstack([self.image, self.image[:1]])
+        expected = pylinx.correlate(image[:-1].copy(), kernel)
+        pylinx.correlate(image[:-1], kernel, out=image[1:])
+        np.testing.assert_allclose(image[1:], expected, rtol=1e-5)
+
+    def test_strided_output_filter(self):
+        expected = pylinx.maximum_filter(self.image, 2)
+        out = np.zeros((13, 34), dtype=np.float32)[:, ::2]
+        pylinx.maximum_filter(self.image, 2, out=out)
+        np.testing.assert_array_equal(out, expected)
+
+    def test_dft_matches_numpy(self):
+        image = self.image.astype(np.float64)
+        np.testing.assert_allclose(pylinx.dft(image), np.fft.rfftn(image), atol=1e-9)
+        np.testing.assert_allclose(pylinx.inverse_dft(pylinx.dft(image), image.shape), image, atol=1e-9)
+        complex_image = image + 1j * image[::-1, ::-1]
+        np.testing.assert_allclose(pylinx.complex_dft(complex_image), np.fft.fftn(complex_image), atol=1e-9)
+        np.testing.assert_allclose(pylinx.inverse_complex_dft(np.fft.fftn(complex_image)), complex_image, atol=1e-9)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,243 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_BENCHMARK_H
+#define _LINXRUN_BENCHMARK_H
+
+#include "Linx/Base/MemoryTracker.h"
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Run/ProgramOptions.h"
+
+#include <algorithm> // max
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief The measurements of a benchmark case.
+ */
+struct BenchmarkCase {
+  /**
+   * @brief Constructor.
+   */
+  BenchmarkCase(std::string case_name, std::vector<double> samples, std::int64_t peak = 0);
+
+  /**
+   * @brief The case name.
+   */
+  std::string name;
+
+  /**
+   * @brief The times of the repetitions, in milliseconds.
+   */
+  std::vector<double> milliseconds;
+
+  /**
+   * @brief The median time.
+   */
+  double median;
+
+  /**
+   * @brief The minimum time.
+   */
+  double min;
+
+  /**
+   * @brief The median absolute deviation of the times.
+   */
+  double mad;
+
+  /**
+   * @brief The mean time.
+   */
+  double mean;
+
+  /**
+   * @brief The maximum over the repetitions of the peak number of bytes allocated, or 0 if not tracked.
+   */
+  std::int64_t peak_bytes;
+};
+
+/**
+ * @brief A benchmark harness with warm-up, repetitions, statistics, machine-readable output and baseline comparison.
+ *
+ * Each case is run a number of times without measurement, to warm up caches, allocators and plans,
+ * and then a number of times with measurement.
+ * Robust statistics (median, minimum and MAD) are computed with `DataDistribution`.
+ *
+ * If the program is compiled with `LINX_TRACK_MEMORY`, the peak memory allocated by each run is measured, too,
+ * with a `MemoryScope`, i.e. only the allocations of the calling thread are accounted.
+ *
+ * Results can be written as JSON or CSV, and compared to a baseline CSV file previously written by the harness:
+ * a case regresses if its median time or its peak memory exceeds that of the baseline by more than a relative threshold.
+ *
+ * The parameters are generally read from the command line:
+ *
+ * \code
+ * ProgramOptions options;
+ * Benchmark::declare(options);
+ * options.parse(argc, argv);
+ * Benchmark benchmark(options);
+ * benchmark.run("exp", [&]() {
+ *   raster.exp();
+ * });
+ * return benchmark.conclude(std::cout); // Non-zero in case of regression
+ * \endcode
+ */
+class Benchmark {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param warmups The number of unmeasured runs
+   * @param repetitions The number of measured runs
+   */
+  explicit Benchmark(Index warmups = 1, Index repetitions = 10);
+
+  /**
+   * @brief Constructor from program options, which were declared with `declare()`.
+   */
+  explicit Benchmark(const ProgramOptions& options);
+
+  /**
+   * @brief Declare the options of the harness: `warmup`, `repeat`, `output`, `baseline` and `threshold`.
+   */
+  static void declare(ProgramOptions& options);
+
+  /**
+   * @brief Run a case.
+   * @param name The case name
+   * @param func The function to be benchmarked
+   *
+   * If `func` returns a `std::chrono::duration`, the returned duration is used as the measurement,
+   * e.g. to exclude some setup from timing.
+   * Otherwise, the whole call is timed.
+   */
+  template <typename TFunc>
+  const BenchmarkCase& run(const std::string& name, TFunc&& func)
+  {
+    for (Index i = 0; i < m_warmups; ++i) {
+      func();
+    }
+    std::vector<double> samples;
+    samples.reserve(m_repetitions);
+    std::int64_t peak = 0;
+    for (Index i = 0; i < m_repetitions; ++i) {
+      MemoryScope scope;
+      samples.push_back(measure(func));
+      peak = std::max<std::int64_t>(peak, scope.peak());
+    }
+    m_cases.emplace_back(name, LINX_MOVE(samples), peak);
+    return m_cases.back();
+  }
+
+  /**
+   * @brief Get the measured cases.
+   */
+  const std::vector<BenchmarkCase>& cases() const
+  {
+    return m_cases;
+  }
+
+  /**
+   * @brief Write a human-readable summary.
+   */
+  void report(std::ostream& os) const;
+
+  /**
+   * @brief Write the results in JSON, including the individual samples.
+   */
+  void write_json(std::ostream& os) const;
+
+  /**
+   * @brief Write the statistics in CSV, which can be used as a baseline.
+   */
+  void write_csv(std::ostream& os) const;
+
+  /**
+   * @brief Write the results to a JSON or CSV file, depending on the extension.
+   */
+  void write(const std::filesystem::path& path) const;
+
+  /**
+   * @brief Read a baseline CSV file.
+   */
+  static std::vector<BenchmarkCase> read_csv(const std::filesystem::path& path);
+
+  /**
+   * @brief Compare the results to a baseline.
+   * @param baseline The baseline cases
+   * @param threshold The maximum relative increase of the median time and peak memory, e.g. 0.1 for 10%
+   * @param os The stream where comparisons are reported
+   * @return The number of regressions
+   *
+   * Cases which are not in the baseline are ignored.
+   */
+  Index compare(const std::vector<BenchmarkCase>& baseline, double threshold, std::ostream& os) const;
+
+  /**
+   * @brief Report, write the output file and compare to the baseline file, if set by the options.
+   * @return 1 in case of regression, or 0 otherwise, to be returned by the program
+   */
+  int conclude(std::ostream& os) const;
+
+private:
+
+  /**
+   * @brief Measure one call of a function, in milliseconds.
+   */
+  template <typename TFunc>
+  static double measure(TFunc& func)
+  {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    if constexpr (std::is_void_v<decltype(func())>) {
+      const auto start = std::chrono::steady_clock::now();
+      func();
+      const auto stop = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<Milliseconds>(stop - start).count();
+    } else {
+      return std::chrono::duration_cast<Milliseconds>(func()).count();
+    }
+  }
+
+  /**
+   * @brief The number of unmeasured runs.
+   */
+  Index m_warmups;
+
+  /**
+   * @brief The number of measured runs.
+   */
+  Index m_repetitions;
+
+  /**
+   * @brief The output file, or an empty path.
+   */
+  std::filesystem::path m_output;
+
+  /**
+   * @brief The baseline file, or an empty path.
+   */
+  std::filesystem::path m_baseline;
+
+  /**
+   * @brief The regression threshold.
+   */
+  double m_threshold;
+
+  /**
+   * @brief The measured cases.
+   */
+  std::vector<BenchmarkCase> m_cases;
+};
+
+} // namespace Linx
+
+#endif
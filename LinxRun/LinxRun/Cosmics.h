@@ -6,7 +6,16 @@
 #define _LINXRUN_COSMICS_H
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/Sequence.h"
+#include "Linx/Data/SparseRaster.h"
 #include "Linx/Transforms/Filters.h"
+#include "LinxRun/CosmicsDiagnostics.h"
+
+#include <algorithm> // max, sort, unique
+#include <numeric> // accumulate, inner_product
+#include <type_traits> // decay_t, is_same_v
+#include <utility> // as_const
+#include <vector>
 
 namespace Linx {
 namespace Cosmics {
@@ -22,28 +31,42 @@ public:
 
   void init_impl() // FIXME private
   {
-    const auto mean = std::accumulate(this->m_values.begin(), this->m_values.end(), T()) / this->m_values.size();
+    const auto mean = transform_sum<T>(Summation::Lanes, identity, this->m_values) / this->m_values.size();
     std::transform(this->m_values.begin(), this->m_values.end(), this->m_values.begin(), [=](auto& e) {
       return e - mean;
     });
-    m_sum2 = std::inner_product(this->m_values.begin(), this->m_values.end(), this->m_values.begin(), T());
+    m_sum2 = transform_sum<T>(Summation::Lanes, square, this->m_values);
   }
 
   template <typename TIn>
   T operator()(const TIn& neighbors) const
   {
-    const auto mean = std::accumulate(neighbors.begin(), neighbors.end(), T()) / neighbors.size();
-    auto centered = neighbors;
+    const auto mean = transform_sum<T>(Summation::Lanes, identity, neighbors) / neighbors.size();
+    std::vector<T> centered(neighbors.begin(), neighbors.end());
     std::transform(centered.begin(), centered.end(), centered.begin(), [=](auto& e) {
       return e - mean;
     });
-    const auto sum2 = std::inner_product(centered.begin(), centered.end(), centered.begin(), T());
-    return std::inner_product(this->m_values.begin(), this->m_values.end(), centered.begin(), T()) /
-        std::sqrt(m_sum2 * sum2);
+    const auto sum2 = transform_sum<T>(Summation::Lanes, square, centered);
+    return transform_sum<T>(Summation::Lanes, product, this->m_values, centered) / std::sqrt(m_sum2 * sum2);
   }
 
 private:
 
+  static T identity(T e)
+  {
+    return e;
+  }
+
+  static T square(T e)
+  {
+    return e * e;
+  }
+
+  static T product(T e, T f)
+  {
+    return e * f;
+  }
+
   T m_sum2;
 };
 
@@ -76,90 +99,249 @@ public:
   void init_impl() {} // FIXME private
 };
 
+/**
+ * @brief Apply a filter with nearest-neighbor extrapolation into a pooled raster.
+ * 
+ * The intermediate maps of the detection are short-lived, such that their memory is recycled from one call to the next.
+ * Calls are qualified, because argument-dependent lookup would otherwise select the cropping
+ * `Internal::temporary_filter()` of `FilterSeq`.
+ */
+template <typename TFilter, typename TIn>
+PoolRaster<typename TFilter::Value> temporary_filter(const TFilter& filter, const TIn& in)
+{
+  PoolRaster<typename TFilter::Value> out(in.shape(), uninitialized);
+  filter.transform(extrapolation<Nearest>(in), out);
+  return out;
+}
+
 template <typename TIn, typename TPsf>
-Raster<typename TPsf::Value> quotient(const TIn& in, const TPsf& psf)
+PoolRaster<typename TPsf::Value> quotient(const TIn& in, const TPsf& psf)
+{
+  using T = typename TPsf::Value;
+  auto filter = SimpleFilter<QuotientFilter<T, Box<2>>>(psf.domain() - (psf.shape() - 1) / 2, psf.begin(), psf.end());
+  return Cosmics::temporary_filter(filter, in);
+}
+
+/**
+ * @brief Apply the quotient filter at given positions only.
+ */
+template <typename TIn, typename TPsf, typename THolder>
+Sequence<typename TPsf::Value>
+quotient(const TIn& in, const TPsf& psf, const Sequence<Position<2>, THolder>& positions)
 {
   using T = typename TPsf::Value;
   auto filter = SimpleFilter<QuotientFilter<T, Box<2>>>(psf.domain() - (psf.shape() - 1) / 2, psf.begin(), psf.end());
-  return filter * extrapolation<Nearest>(in);
+  return filter * extrapolation<Nearest>(in)(positions);
 }
 
+/**
+ * @brief Compute the Pearson correlation coefficient between the PSF and each neighborhood of the input.
+ * 
+ * The result is that of filtering with `PearsonCorrelation`, without centering each neighborhood:
+ * the local means and variances are obtained from summed-area tables of the input and of its square,
+ * and the cross term is the correlation with the centered PSF, whose sum is null.
+ * The cost is therefore about that of one correlation.
+ * The correlation is direct rather than DFT-based:
+ * PSFs are a few pixels wide, for which the direct correlation is faster than a pair of DFTs of the whole image,
+ * and it keeps LinxRun free of the FFTW dependency of LinxTransforms.
+ * Flat neighborhoods yield NaNs.
+ */
 template <typename TIn, typename TPsf>
-Raster<typename TPsf::Value> match(const TIn& in, const TPsf& psf)
+PoolRaster<typename TPsf::Value> match(const TIn& in, const TPsf& psf)
 {
   using T = typename TPsf::Value;
-  auto filter =
-      SimpleFilter<PearsonCorrelation<T, Box<2>>>(psf.domain() - (psf.shape() - 1) / 2, psf.begin(), psf.end());
-  return filter * extrapolation<Nearest>(in);
+  const auto origin = (psf.shape() - 1) / 2;
+  const auto window = psf.domain() - origin;
+  const auto size = static_cast<double>(psf.size());
+
+  Raster<T> centered(psf.shape(), psf.begin());
+  const auto mean = std::accumulate(centered.begin(), centered.end(), 0.) / size;
+  centered -= mean;
+  const auto norm2 = std::inner_product(centered.begin(), centered.end(), centered.begin(), 0.);
+
+  auto out = Cosmics::temporary_filter(correlation(centered, origin), in);
+  PoolRaster<double> square(in.shape(), uninitialized);
+  square.generate(
+      [](auto e) {
+        return double(e) * e;
+      },
+      in);
+  const auto means = Cosmics::temporary_filter(mean_filter<double>(window), in);
+  const auto square_means = Cosmics::temporary_filter(mean_filter<double>(window), square);
+  out.generate(
+      [=](auto c, auto m, auto m2) {
+        return c / std::sqrt(norm2 * size * std::max(m2 - m * m, 0.));
+      },
+      out,
+      means,
+      square_means);
+  return out;
 }
 
 template <typename TIn>
-Raster<typename TIn::Value> laplacian(const TIn& in)
+PoolRaster<typename TIn::Value> laplacian(const TIn& in)
 {
   using T = typename TIn::Value;
   const auto filter = convolution(
       Raster<T>({3, 3}, {-1. / 6., -2. / 3., -1. / 6., -2. / 3., 10. / 3., -2. / 3., -1. / 6., -2. / 3., -1. / 6.}));
-  return filter * extrapolation<Nearest>(in);
+  return Cosmics::temporary_filter(filter, in);
+}
+
+/**
+ * @brief Compute the Laplacian of a contiguous 2D raster row by row, and call a function on each row.
+ * @param in The input raster
+ * @param func The function, called as `func(y, row)` for each row index `y` in order,
+ * where `row` is a contiguous range of the Laplacian values of the row
+ * 
+ * The values are those of `laplacian()`, with nearest-neighbor extrapolation,
+ * but they are computed one row at a time into a small buffer instead of a map,
+ * such that consumers of the Laplacian, e.g. statistics and thresholding, are fused with its computation
+ * while the row is in cache.
+ */
+template <typename TIn, typename TFunc>
+void for_each_laplacian_row(const TIn& in, TFunc&& func)
+{
+  using T = typename TIn::Value;
+  const auto width = in.shape()[0];
+  const auto height = in.shape()[1];
+  const auto* data = in.data();
+  std::vector<T> buffer(width);
+  const auto stencil = [](T center, T edges, T corners) {
+    return T(10. / 3.) * center - T(2. / 3.) * edges - T(1. / 6.) * corners;
+  };
+  const auto at_border = [&](const T* previous, const T* row, const T* next, Index x) {
+    const auto left = std::max<Index>(x - 1, 0);
+    const auto right = std::min<Index>(x + 1, width - 1);
+    return stencil(
+        row[x],
+        previous[x] + row[left] + row[right] + next[x],
+        previous[left] + previous[right] + next[left] + next[right]);
+  };
+  for (Index y = 0; y < height; ++y) {
+    const auto* previous = data + std::max<Index>(y - 1, 0) * width;
+    const auto* row = data + y * width;
+    const auto* next = data + std::min<Index>(y + 1, height - 1) * width;
+    auto* l = buffer.data();
+    for (Index x = 1; x < width - 1; ++x) { // Branchless, vectorizable
+      l[x] = stencil(
+          row[x],
+          previous[x] + row[x - 1] + row[x + 1] + next[x],
+          previous[x - 1] + previous[x + 1] + next[x - 1] + next[x + 1]);
+    }
+    l[0] = at_border(previous, row, next, 0);
+    l[width - 1] = at_border(previous, row, next, width - 1);
+    func(y, std::as_const(buffer));
+  }
 }
 
 template <typename TIn>
-Raster<typename TIn::Value> dilate(const TIn& in, Index radius = 1)
+PoolRaster<typename TIn::Value> dilate(const TIn& in, Index radius = 1)
 {
   using T = typename TIn::Value;
   auto filter = dilation<T>(Box<2>::from_center(radius)); // FIXME L2-ball?
-  return filter * extrapolation<Nearest>(in);
+  return Cosmics::temporary_filter(filter, in);
 }
 
 template <typename TIn>
-Raster<typename TIn::Value> blur(const TIn& in, Index radius = 1)
+PoolRaster<typename TIn::Value> blur(const TIn& in, Index radius = 1)
 {
   using T = typename TIn::Value;
   auto filter = mean_filter<T>(Box<2>::from_center(radius)); // FIXME L2-ball?
-  return filter * extrapolation<Nearest>(in);
+  return Cosmics::temporary_filter(filter, in);
 }
 
 /**
  * @brief Detect cosmic rays.
  * @param in The input 2D raster
+ * @param psf The PSF
  * @param pfa The detection probability of false alarm
+ * @param tq The quotient threshold
+ * @param diagnostics The sink of the intermediate maps and values (see `NoDiagnostics`)
  * 
  * This is a simple adaptive Laplacian thresholding.
  * The input raster is convolved with some Laplacian kernel.
  * The parameters of the background noise (empirically assumed Laplace-distributed)
  * of the filtered image are estimated to deduce the detection threshold from a PFA.
+ * Candidates are then confirmed if their dilated quotient with the PSF is below `tq`.
+ * Since candidates are rare, the quotient is evaluated in their neighborhood only.
+ * The Laplacian map itself is not stored: the norm and the thresholding are each fused with the Laplacian stencil,
+ * unless some diagnostics sink is provided.
+ *
+ * The maps `laplacian` and `quotient` (NaN where not evaluated),
+ * and the values `norm`, `threshold`, `radius` and `candidates` are sent to the diagnostics sink.
  */
-template <typename TIn, typename TPsf>
-Raster<char> detect(const TIn& in, const TPsf& psf, float pfa, float tq)
+template <typename TIn, typename TPsf, typename TDiagnostics = NoDiagnostics>
+Raster<char> detect(const TIn& in, const TPsf& psf, float pfa, float tq, TDiagnostics&& diagnostics = TDiagnostics())
 {
-  auto laplacian_map = laplacian(in);
-  Fits("/tmp/cosmic.fits").write(laplacian_map, 'a');
-  float n = 0;
-  float s = 0;
-  for (auto e : laplacian_map) {
-    if (not std::isnan(e)) {
-      n += std::abs(e);
-      ++s;
-    }
+  if constexpr (not std::is_same_v<std::decay_t<TDiagnostics>, NoDiagnostics>) {
+    diagnostics.map("laplacian", laplacian(in));
   }
-  printf("Norm: %f\n", n);
+
+  // First pass: L1 norm of the Laplacian, ignoring NaNs
+  double n = 0;
+  Index s = 0;
+  for_each_laplacian_row(in, [&](Index, const auto& row) {
+    n += transform_sum<double>(
+        Summation::Lanes,
+        [](auto l) {
+          return std::isnan(l) ? 0. : std::abs(l);
+        },
+        row);
+    s += transform_sum<Index>(
+        Summation::Lanes,
+        [](auto l) {
+          return Index(not std::isnan(l));
+        },
+        row);
+  });
+  diagnostics.value("norm", n);
 
   // Empirically assume Laplace distribution
-  // const auto tl = -norm<1>(laplacian_map) / laplacian_map.size() * std::log(2.0 * pfa);
   const auto tl = -n / s * std::log(2.0 * pfa);
-  printf("Threshold: %f\n", tl);
+  diagnostics.value("threshold", tl);
 
   const Index radius = std::sqrt(psf.size()) / 4;
-  printf("Radius: %li\n", radius);
-  auto quotient_map = dilate(quotient(in, psf), radius);
-  Fits("/tmp/cosmic.fits").write(quotient_map, 'a');
+  diagnostics.value("radius", radius);
+
+  // The dilated quotient is only needed where l > tl, which is a small fraction of the pixels:
+  // evaluate the quotient in the neighborhood of the candidates only
+  using T = typename TPsf::Value;
+  const auto neighborhood = Box<2>::from_center(radius);
+  std::vector<Position<2>> candidates;
+  for_each_laplacian_row(in, [&](Index y, const auto& row) { // Second pass: thresholding
+    for (std::size_t x = 0; x < row.size(); ++x) {
+      if (row[x] > tl) {
+        candidates.push_back({Index(x), y});
+      }
+    }
+  });
+  diagnostics.value("candidates", candidates.size());
+  Raster<char> needed(in.shape());
+  std::vector<Position<2>> positions;
+  for (const auto& c : candidates) {
+    for (const auto& p : (neighborhood + c) & in.domain()) {
+      if (not needed[p]) {
+        needed[p] = true;
+        positions.push_back(p);
+      }
+    }
+  }
+  const auto values = quotient(in, psf, Sequence<Position<2>>(positions));
+  PoolRaster<T> quotient_map(in.shape(), uninitialized);
+  quotient_map.fill(std::numeric_limits<T>::quiet_NaN());
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    quotient_map[positions[i]] = values[i];
+  }
+  diagnostics.map("quotient", quotient_map);
 
   Raster<char> out(in.shape());
-  out.generate(
-      [=](auto l, auto q) {
-        return l > tl && q < tq; // FIXME compute quotient only where l > tl
-      },
-      laplacian_map,
-      quotient_map);
+  for (const auto& c : candidates) {
+    auto q = std::numeric_limits<T>::lowest();
+    for (const auto& p : (neighborhood + c) & in.domain()) { // Dilation
+      q = std::max(q, quotient_map[p]);
+    }
+    out[c] = q < tq;
+  }
   return out;
 }
 
@@ -189,23 +371,65 @@ float min_contrast(const TIn& in, const TMask& mask, const Position<2>& p)
  * @brief Segment detected cosmic rays.
  * @param mask The detection map
  * @param threshold The similarity threshold
+ * @param iterations The maximum number of region-growing iterations, or -1 to grow until convergence
+ * @return The number of pixels added to the mask
  * 
  * Given a detection map, neighbors of flagged pixels are considered as candidate cosmic rays.
  * Some similarity distance is computed in the neighborhood in order to decide
  * whether the cadidate belongs to the cosmic ray or to the background, by thresholding.
+ * 
+ * Growing is frontier-based: each iteration only tests the previously rejected candidates
+ * and the neighbors of the pixels added by the previous iteration,
+ * such that the cost is proportional to the number of flagged pixels instead of the image area.
+ * Within an iteration, candidates are visited in raster order and the mask is updated in place.
  */
 template <typename TIn, typename TMask>
-void segment(const TIn& in, TMask& mask, float threshold)
+Index segment(const TIn& in, TMask& mask, float threshold, Index iterations = 1)
 {
   // FIXME Mask<2>::ball<1>(1)
-  auto candidates = dilation<typename TMask::Value>(Box<2>::from_center(1)) * extrapolation(mask, '\0') - mask;
-  for (const auto& p : candidates.domain() - Box<2>::from_center(1)) {
-    if (candidates[p]) {
+  const auto neighborhood = Box<2>::from_center(1);
+  const auto inner = mask.domain() - neighborhood;
+  const auto before = [](const auto& lhs, const auto& rhs) {
+    return lhs[1] < rhs[1] || (lhs[1] == rhs[1] && lhs[0] < rhs[0]);
+  };
+  std::vector<Position<2>> added;
+  if constexpr (is_raster<TMask>()) {
+    const SparseRaster<char, 2> flagged(mask); // Contiguous scan, without index computations
+    added.assign(flagged.region().begin(), flagged.region().end());
+  } else {
+    for (const auto& p : mask.domain()) {
+      if (mask[p]) {
+        added.push_back(p);
+      }
+    }
+  }
+  std::vector<Position<2>> candidates;
+  std::vector<Position<2>> rejected;
+  Index count = 0;
+  for (Index i = 0; i != iterations && not added.empty(); ++i) {
+    candidates.swap(rejected); // Rejected candidates remain candidates, as neighbors of the mask
+    for (const auto& a : added) {
+      for (const auto& p : (neighborhood + a) & inner) {
+        if (not mask[p]) {
+          candidates.push_back(p);
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), before);
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    added.clear();
+    rejected.clear();
+    for (const auto& p : candidates) {
       if (min_contrast(in, mask, p) < threshold) {
         mask[p] = true;
+        added.push_back(p);
+      } else {
+        rejected.push_back(p);
       }
     }
+    count += added.size();
   }
+  return count;
 }
 
 } // namespace Cosmics
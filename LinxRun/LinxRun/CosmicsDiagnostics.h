@@ -0,0 +1,197 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_COSMICSDIAGNOSTICS_H
+#define _LINXRUN_COSMICSDIAGNOSTICS_H
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Npy.h"
+
+#include <algorithm> // min, max
+#include <cmath> // isnan
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Linx {
+namespace Cosmics {
+
+/**
+ * @brief The default diagnostics sink, which discards everything.
+ *
+ * A diagnostics sink receives the intermediate maps and scalar values of the detection, by name, through:
+ * - `template <typename TRaster> void map(const std::string& name, const TRaster& raster)`;
+ * - `void value(const std::string& name, double value)`.
+ *
+ * With this sink, the calls are inlined as no-ops, such that production runs pay nothing.
+ */
+struct NoDiagnostics {
+  /**
+   * @brief Discard a map.
+   */
+  template <typename TRaster>
+  void map(const std::string&, const TRaster&)
+  {}
+
+  /**
+   * @brief Discard a value.
+   */
+  void value(const std::string&, double) {}
+};
+
+/**
+ * @brief Base class of the sinks which keep the scalar values.
+ */
+struct ValueDiagnostics {
+  /**
+   * @brief Keep a value.
+   */
+  void value(const std::string& name, double v)
+  {
+    values[name] = v;
+  }
+
+  /**
+   * @brief Write the values, one per line.
+   */
+  void report(std::ostream& os) const
+  {
+    for (const auto& v : values) {
+      os << "  " << v.first << ": " << v.second << std::endl;
+    }
+  }
+
+  /**
+   * @brief The values, by name.
+   */
+  std::map<std::string, double> values;
+};
+
+/**
+ * @brief A diagnostics sink which keeps copies of the maps and the values in memory, e.g. for testing.
+ */
+struct MemoryDiagnostics : ValueDiagnostics {
+  /**
+   * @brief Copy a map.
+   */
+  template <typename TRaster>
+  void map(const std::string& name, const TRaster& raster)
+  {
+    maps.insert_or_assign(name, Raster<float>(raster.shape(), raster.begin()));
+  }
+
+  /**
+   * @brief The maps, by name.
+   */
+  std::map<std::string, Raster<float>> maps;
+};
+
+/**
+ * @brief A diagnostics sink which keeps summary statistics of the maps instead of the maps themselves.
+ *
+ * For a map `name`, values `name.min`, `name.max` and `name.mean` are computed over the non-NaN elements,
+ * as well as `name.nan`, the number of NaNs.
+ */
+struct SummaryDiagnostics : ValueDiagnostics {
+  /**
+   * @brief Summarize a map.
+   */
+  template <typename TRaster>
+  void map(const std::string& name, const TRaster& raster)
+  {
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    double sum = 0;
+    Index nan = 0;
+    for (const auto& e : raster) {
+      if (std::isnan(e)) {
+        ++nan;
+        continue;
+      }
+      min = std::min<double>(min, e);
+      max = std::max<double>(max, e);
+      sum += e;
+    }
+    const auto count = raster.size() - nan;
+    value(name + ".min", count ? min : std::numeric_limits<double>::quiet_NaN());
+    value(name + ".max", count ? max : std::numeric_limits<double>::quiet_NaN());
+    value(name + ".mean", count ? sum / count : std::numeric_limits<double>::quiet_NaN());
+    value(name + ".nan", nan);
+  }
+};
+
+/**
+ * @brief A diagnostics sink which writes the maps as NumPy files asynchronously.
+ *
+ * Each map is copied and written to `<directory>/<name>.npy` by a background task,
+ * such that the detection is not delayed by the writes.
+ * The writes are waited for by `wait()` or at destruction.
+ */
+class NpyDiagnostics : public ValueDiagnostics {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param directory The output directory, which must exist
+   */
+  explicit NpyDiagnostics(std::filesystem::path directory) : m_directory(LINX_MOVE(directory)), m_writes() {}
+
+  /**
+   * @brief Destructor, which waits for the writes.
+   */
+  ~NpyDiagnostics()
+  {
+    for (auto& w : m_writes) {
+      if (w.valid()) {
+        w.wait();
+      }
+    }
+  }
+
+  /**
+   * @brief Write a map asynchronously.
+   */
+  template <typename TRaster>
+  void map(const std::string& name, const TRaster& raster)
+  {
+    auto path = m_directory / (name + ".npy");
+    Raster<std::decay_t<typename TRaster::Value>> copy(raster.shape(), raster.begin());
+    m_writes.push_back(std::async(std::launch::async, [path = LINX_MOVE(path), copy = LINX_MOVE(copy)]() {
+      Npy(path).write(copy, 'w');
+    }));
+  }
+
+  /**
+   * @brief Wait for the pending writes, and rethrow their errors, if any.
+   */
+  void wait()
+  {
+    auto writes = LINX_MOVE(m_writes);
+    m_writes.clear();
+    for (auto& w : writes) {
+      w.get();
+    }
+  }
+
+private:
+
+  /**
+   * @brief The output directory.
+   */
+  std::filesystem::path m_directory;
+
+  /**
+   * @brief The pending writes.
+   */
+  std::vector<std::future<void>> m_writes;
+};
+
+} // namespace Cosmics
+} // namespace Linx
+
+#endif
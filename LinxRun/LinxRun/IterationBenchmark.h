@@ -7,6 +7,9 @@
 
 #include "Linx/Data/Raster.h"
 #include "Linx/Run/Timer.h"
+#include "LinxRun/PerfCounters.h"
+
+#include <memory> // unique_ptr
 
 namespace Linx {
 
@@ -29,12 +32,22 @@ public:
   /**
    * @brief The duration unit.
    */
-  using Duration = std::chrono::milliseconds;
+  using Duration = std::chrono::microseconds;
 
   /**
    * @brief Constructor.
+   * @param side The raster width, height and depth
+   * @param counters Whether to read hardware performance counters in each case
+   */
+  IterationBenchmark(Index side, bool counters = false);
+
+  /**
+   * @brief Get the performance counters of the last case, or `nullptr` if not requested.
    */
-  IterationBenchmark(Index side);
+  const PerfCounters* counters() const
+  {
+    return m_counters.get();
+  }
 
   /**
    * @brief Loop over positions built by looping over x, then y, and then z.
@@ -56,6 +69,11 @@ public:
    */
   Duration iterate_over_positions_optimized();
 
+  /**
+   * @brief Loop over rows via `for_each_row()`, and over indices in each row.
+   */
+  Duration iterate_over_rows();
+
   /**
    * @brief Loop over indices.
    */
@@ -76,8 +94,26 @@ public:
    */
   Duration call_generate();
 
+  /**
+   * @brief Copy the first raster into the third one with axes z, y and x permuted, via `transpose()`.
+   *
+   * As opposed to other cases, the result is not the sum of the rasters,
+   * and the timing is to be compared to that of `loop_over_zyx()`, which traverses the same amount of data.
+   */
+  Duration permute_axes();
+
 protected:
 
+  /**
+   * @brief Start the timer and counters.
+   */
+  void start();
+
+  /**
+   * @brief Stop the timer and counters.
+   */
+  Duration stop();
+
   Index m_width;
   Index m_height;
   Index m_depth;
@@ -85,6 +121,7 @@ protected:
   Raster<Value, Dimension> m_b;
   Raster<Value, Dimension> m_c;
   Timer<Duration> m_timer;
+  std::unique_ptr<PerfCounters> m_counters;
 };
 
 } // namespace Linx
@@ -0,0 +1,129 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_PERFCOUNTERS_H
+#define _LINXRUN_PERFCOUNTERS_H
+
+#include "Linx/Base/TypeUtils.h"
+
+#include <array>
+#include <ostream>
+
+namespace Linx {
+
+/**
+ * @brief A group of hardware performance counters of the calling thread, read with `perf_event_open()`.
+ *
+ * The counters are opened as a single group, such that they are scheduled together
+ * and their ratios are consistent, and they count user-space events only,
+ * which is allowed by the default `perf_event_paranoid` setting.
+ * If the group is multiplexed with other groups, values are scaled by the enabled-to-running time ratio.
+ *
+ * The system call may be unavailable, e.g. on non-Linux systems, in containers or virtual machines,
+ * or for some events on some CPUs.
+ * In this case, the missing counters have a value of -1, and if no counter can be opened, `available()` is false,
+ * while `start()` and `stop()` are no-ops, such that instrumented code needs no special handling.
+ *
+ * There is no portable counter for vector instructions.
+ * Instead, the vectorization of a loop is best assessed with the number of instructions per processed element:
+ *
+ * \code
+ * PerfCounters counters;
+ * counters.start();
+ * raster += 1;
+ * counters.stop();
+ * counters.report(std::cout, raster.size());
+ * \endcode
+ */
+class PerfCounters {
+public:
+
+  /**
+   * @brief The counted events.
+   */
+  enum Event {
+    Cycles = 0, ///< CPU cycles
+    Instructions, ///< Retired instructions
+    CacheReferences, ///< Last-level cache accesses
+    CacheMisses, ///< Last-level cache misses
+    BranchMisses, ///< Mispredicted branches
+    EventCount ///< The number of events
+  };
+
+  /**
+   * @brief Constructor, which opens the counters.
+   */
+  PerfCounters();
+
+  /**
+   * @brief Non-copyable.
+   */
+  PerfCounters(const PerfCounters&) = delete;
+
+  /**
+   * @brief Non-copyable.
+   */
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /**
+   * @brief Destructor, which closes the counters.
+   */
+  ~PerfCounters();
+
+  /**
+   * @brief Get the name of an event.
+   */
+  static const char* name(Event event);
+
+  /**
+   * @brief Check whether at least one counter could be opened.
+   */
+  bool available() const;
+
+  /**
+   * @brief Reset and start counting.
+   */
+  void start();
+
+  /**
+   * @brief Stop counting and read the counters.
+   */
+  void stop();
+
+  /**
+   * @brief Get the value of a counter at the last `stop()`, or -1 if unavailable.
+   */
+  double operator[](Event event) const
+  {
+    return m_values[event];
+  }
+
+  /**
+   * @brief Write the counter values, and some ratios if available.
+   * @param os The output stream
+   * @param elements The number of processed elements, for per-element ratios, or 0
+   */
+  void report(std::ostream& os, Index elements = 0) const;
+
+private:
+
+  /**
+   * @brief The file descriptors of the counters, or -1.
+   */
+  std::array<int, EventCount> m_fds;
+
+  /**
+   * @brief The file descriptor of the group leader, or -1.
+   */
+  int m_leader;
+
+  /**
+   * @brief The values of the counters.
+   */
+  std::array<double, EventCount> m_values;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,169 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxRun/Benchmark.h"
+
+#include "Linx/Base/DataDistribution.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Linx {
+
+BenchmarkCase::BenchmarkCase(std::string case_name, std::vector<double> samples, std::int64_t peak) :
+    name(LINX_MOVE(case_name)), milliseconds(LINX_MOVE(samples)), median(0), min(0), mad(0), mean(0), peak_bytes(peak)
+{
+  if (milliseconds.empty()) {
+    return;
+  }
+  DataDistribution<double> distribution(milliseconds);
+  median = distribution.median();
+  min = distribution.min();
+  mad = distribution.mad();
+  mean = distribution.mean();
+}
+
+Benchmark::Benchmark(Index warmups, Index repetitions) :
+    m_warmups(warmups), m_repetitions(repetitions), m_output(), m_baseline(), m_threshold(0.1), m_cases()
+{}
+
+Benchmark::Benchmark(const ProgramOptions& options) :
+    m_warmups(options.as<Index>("warmup")), m_repetitions(options.as<Index>("repeat")),
+    m_output(options.as<std::string>("output")), m_baseline(options.as<std::string>("baseline")),
+    m_threshold(options.as<double>("threshold")), m_cases()
+{}
+
+void Benchmark::declare(ProgramOptions& options)
+{
+  options.named("warmup", "Number of unmeasured runs per case", Index(1));
+  options.named("repeat", "Number of measured runs per case", Index(10));
+  options.named("output", "Output file (.json or .csv), or empty", std::string());
+  options.named("baseline", "Baseline CSV file to compare with, or empty", std::string());
+  options.named("threshold", "Maximum relative increase of the median time or peak memory w.r.t. the baseline", 0.1);
+}
+
+void Benchmark::report(std::ostream& os) const
+{
+  for (const auto& c : m_cases) {
+    os << "  " << c.name << ": " << c.median << "ms (median of " << c.milliseconds.size() << "; min: " << c.min
+       << "ms; MAD: " << c.mad << "ms";
+    if (c.peak_bytes > 0) {
+      os << "; peak: " << c.peak_bytes << " bytes";
+    }
+    os << ")" << std::endl;
+  }
+}
+
+void Benchmark::write_json(std::ostream& os) const
+{
+  os << std::setprecision(9) << "{\"cases\": [";
+  for (std::size_t i = 0; i < m_cases.size(); ++i) {
+    const auto& c = m_cases[i];
+    os << (i ? ",\n" : "\n") << "  {\"name\": \"" << c.name << "\", \"repetitions\": " << c.milliseconds.size()
+       << ", \"median\": " << c.median << ", \"min\": " << c.min << ", \"mad\": " << c.mad << ", \"mean\": " << c.mean
+       << ", \"peak_bytes\": " << c.peak_bytes << ", \"milliseconds\": [";
+    for (std::size_t j = 0; j < c.milliseconds.size(); ++j) {
+      os << (j ? ", " : "") << c.milliseconds[j];
+    }
+    os << "]}";
+  }
+  os << "\n]}" << std::endl;
+}
+
+void Benchmark::write_csv(std::ostream& os) const
+{
+  os << std::setprecision(9) << "name,repetitions,median,min,mad,mean,peak_bytes" << std::endl;
+  for (const auto& c : m_cases) {
+    os << c.name << ',' << c.milliseconds.size() << ',' << c.median << ',' << c.min << ',' << c.mad << ',' << c.mean
+       << ',' << c.peak_bytes << std::endl;
+  }
+}
+
+void Benchmark::write(const std::filesystem::path& path) const
+{
+  std::ofstream ofs(path);
+  if (not ofs) {
+    throw std::runtime_error("Cannot open benchmark output: " + path.string());
+  }
+  if (path.extension() == ".json") {
+    write_json(ofs);
+  } else {
+    write_csv(ofs);
+  }
+}
+
+std::vector<BenchmarkCase> Benchmark::read_csv(const std::filesystem::path& path)
+{
+  std::ifstream ifs(path);
+  if (not ifs) {
+    throw std::runtime_error("Cannot open benchmark baseline: " + path.string());
+  }
+  std::vector<BenchmarkCase> out;
+  std::string line;
+  std::getline(ifs, line); // Header
+  while (std::getline(ifs, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream iss(line);
+    std::string name;
+    std::string field;
+    std::vector<double> values;
+    std::getline(iss, name, ',');
+    while (std::getline(iss, field, ',')) {
+      values.push_back(std::stod(field));
+    }
+    if (values.size() != 5 && values.size() != 6) { // peak_bytes is optional
+      throw std::runtime_error("Invalid benchmark baseline line: " + line);
+    }
+    BenchmarkCase c(name, {}, values.size() == 6 ? std::int64_t(values[5]) : 0);
+    c.median = values[1];
+    c.min = values[2];
+    c.mad = values[3];
+    c.mean = values[4];
+    out.push_back(LINX_MOVE(c));
+  }
+  return out;
+}
+
+Index Benchmark::compare(const std::vector<BenchmarkCase>& baseline, double threshold, std::ostream& os) const
+{
+  Index out = 0;
+  for (const auto& c : m_cases) {
+    for (const auto& b : baseline) {
+      if (b.name != c.name || b.median <= 0) {
+        continue;
+      }
+      const auto change = c.median / b.median - 1;
+      bool regression = change > threshold;
+      os << "  " << (regression ? "REGRESSION " : "") << c.name << ": " << std::showpos << change * 100
+         << std::noshowpos << "% (" << c.median << "ms vs. " << b.median << "ms)" << std::endl;
+      if (c.peak_bytes > 0 && b.peak_bytes > 0) {
+        const auto growth = double(c.peak_bytes) / b.peak_bytes - 1;
+        const bool inflation = growth > threshold;
+        os << "  " << (inflation ? "REGRESSION " : "") << c.name << " peak memory: " << std::showpos << growth * 100
+           << std::noshowpos << "% (" << c.peak_bytes << " vs. " << b.peak_bytes << " bytes)" << std::endl;
+        regression = regression || inflation;
+      }
+      out += regression;
+    }
+  }
+  return out;
+}
+
+int Benchmark::conclude(std::ostream& os) const
+{
+  report(os);
+  if (not m_output.empty()) {
+    write(m_output);
+  }
+  if (not m_baseline.empty()) {
+    return compare(read_csv(m_baseline), m_threshold, os) > 0;
+  }
+  return 0;
+}
+
+} // namespace Linx
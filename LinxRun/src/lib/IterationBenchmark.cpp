@@ -4,11 +4,13 @@
 
 #include "LinxRun/IterationBenchmark.h"
 
+#include "Linx/Data/Transpose.h"
+
 namespace Linx {
 
-IterationBenchmark::IterationBenchmark(Index side) :
+IterationBenchmark::IterationBenchmark(Index side, bool counters) :
     m_width(side), m_height(side), m_depth(side), m_a({side, side, side}), m_b({side, side, side}),
-    m_c({side, side, side})
+    m_c({side, side, side}), m_timer(), m_counters(counters ? std::make_unique<PerfCounters>() : nullptr)
 {
   //! [Randomize]
   m_a.generate(UniformNoise<Value>(-50, 50));
@@ -16,9 +18,26 @@ IterationBenchmark::IterationBenchmark(Index side) :
   //! [Randomize]
 }
 
-IterationBenchmark::Duration IterationBenchmark::loop_over_xyz()
+void IterationBenchmark::start()
 {
+  if (m_counters) {
+    m_counters->start();
+  }
   m_timer.start();
+}
+
+IterationBenchmark::Duration IterationBenchmark::stop()
+{
+  const auto out = m_timer.stop();
+  if (m_counters) {
+    m_counters->stop();
+  }
+  return out;
+}
+
+IterationBenchmark::Duration IterationBenchmark::loop_over_xyz()
+{
+  start();
   //! [x-y-z]
   for (Index x = 0; x < m_width; ++x) {
     for (Index y = 0; y < m_height; ++y) {
@@ -28,12 +47,12 @@ IterationBenchmark::Duration IterationBenchmark::loop_over_xyz()
     }
   }
   //! [x-y-z]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::loop_over_zyx()
 {
-  m_timer.start();
+  start();
   //! [z-y-x]
   for (Index z = 0; z < m_depth; ++z) {
     for (Index y = 0; y < m_height; ++y) {
@@ -43,47 +62,64 @@ IterationBenchmark::Duration IterationBenchmark::loop_over_zyx()
     }
   }
   //! [z-y-x]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::iterate_over_positions()
 {
-  m_timer.start();
+  start();
   //! [position]
   for (const auto& p : m_c.domain()) {
     m_c[p] = m_a[p] + m_b[p];
   }
   //! [position]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::iterate_over_positions_optimized()
 {
-  m_timer.start();
+  start();
   //! [position-index]
   for (const auto& p : m_c.domain()) {
     const auto i = m_c.index(p);
     m_c[i] = m_a[i] + m_b[i];
   }
   //! [position-index]
-  return m_timer.stop();
+  return stop();
+}
+
+IterationBenchmark::Duration IterationBenchmark::iterate_over_rows()
+{
+  start();
+  //! [row]
+  for_each_row(m_c.domain(), [&](const auto& front, Index length) {
+    const auto i = m_c.index(front);
+    const auto* a = &m_a[i];
+    const auto* b = &m_b[i];
+    auto* c = &m_c[i];
+    for (Index x = 0; x < length; ++x) {
+      c[x] = a[x] + b[x];
+    }
+  });
+  //! [row]
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::loop_over_indices()
 {
-  m_timer.start();
+  start();
   //! [index]
   const auto size = m_c.size();
   for (std::size_t i = 0; i < size; ++i) {
     m_c[i] = m_a[i] + m_b[i];
   }
   //! [index]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::iterate_over_values()
 {
-  m_timer.start();
+  start();
   //! [value]
   auto ait = m_a.begin();
   auto bit = m_b.begin();
@@ -93,21 +129,21 @@ IterationBenchmark::Duration IterationBenchmark::iterate_over_values()
     *cit = *ait + *bit;
   }
   //! [value]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::call_operator()
 {
-  m_timer.start();
+  start();
   //! [operator]
   m_c = m_a + m_b;
   //! [operator]
-  return m_timer.stop();
+  return stop();
 }
 
 IterationBenchmark::Duration IterationBenchmark::call_generate()
 {
-  m_timer.start();
+  start();
   //! [generate]
   m_c.generate(
       [](auto e, auto f) {
@@ -116,7 +152,16 @@ IterationBenchmark::Duration IterationBenchmark::call_generate()
       m_a,
       m_b);
   //! [generate]
-  return m_timer.stop();
+  return stop();
+}
+
+IterationBenchmark::Duration IterationBenchmark::permute_axes()
+{
+  start();
+  //! [transpose]
+  transpose(m_a, {2, 1, 0}, m_c);
+  //! [transpose]
+  return stop();
 }
 
 } // namespace Linx
@@ -0,0 +1,154 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxRun/PerfCounters.h"
+
+#include <cstdint>
+#include <cstring> // memset
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Linx {
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+
+namespace {
+
+/**
+ * @brief Open a user-space hardware counter of the calling thread.
+ */
+int open_counter(std::uint64_t config, int leader)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = leader < 0; // Members follow the leader
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() : m_fds(), m_leader(-1), m_values()
+{
+  static const std::uint64_t configs[] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_REFERENCES,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+  m_fds.fill(-1);
+  m_values.fill(-1);
+  for (int i = 0; i < EventCount; ++i) {
+    m_fds[i] = open_counter(configs[i], m_leader);
+    if (m_leader < 0) {
+      m_leader = m_fds[i];
+    }
+  }
+}
+
+PerfCounters::~PerfCounters()
+{
+  for (auto fd : m_fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool PerfCounters::available() const
+{
+  return m_leader >= 0;
+}
+
+void PerfCounters::start()
+{
+  if (m_leader < 0) {
+    return;
+  }
+  ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop()
+{
+  if (m_leader < 0) {
+    return;
+  }
+  ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  std::vector<std::uint64_t> buffer(3 + EventCount); // nr, time_enabled, time_running, values
+  if (read(m_leader, buffer.data(), buffer.size() * sizeof(std::uint64_t)) <= 0) {
+    m_values.fill(-1);
+    return;
+  }
+  const auto enabled = static_cast<double>(buffer[1]);
+  const auto running = static_cast<double>(buffer[2]);
+  const auto scale = running > 0 ? enabled / running : 0;
+  std::size_t j = 3; // Values are in the order of opening, skipping unavailable counters
+  for (int i = 0; i < EventCount; ++i) {
+    m_values[i] = m_fds[i] >= 0 ? buffer[j++] * scale : -1;
+  }
+}
+
+#else
+
+PerfCounters::PerfCounters() : m_fds(), m_leader(-1), m_values()
+{
+  m_fds.fill(-1);
+  m_values.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {}
+
+bool PerfCounters::available() const
+{
+  return false;
+}
+
+void PerfCounters::start() {}
+
+void PerfCounters::stop() {}
+
+#endif
+
+const char* PerfCounters::name(Event event)
+{
+  static const char* names[] = {"cycles", "instructions", "cache references", "cache misses", "branch misses"};
+  return names[event];
+}
+
+void PerfCounters::report(std::ostream& os, Index elements) const
+{
+  if (not available()) {
+    os << "  Performance counters unavailable" << std::endl;
+    return;
+  }
+  for (int i = 0; i < EventCount; ++i) {
+    if (m_values[i] >= 0) {
+      os << "  " << name(static_cast<Event>(i)) << ": " << m_values[i];
+      if (elements > 0) {
+        os << " (" << m_values[i] / elements << " per element)";
+      }
+      os << std::endl;
+    }
+  }
+  if (m_values[Cycles] > 0 && m_values[Instructions] >= 0) {
+    os << "  instructions per cycle: " << m_values[Instructions] / m_values[Cycles] << std::endl;
+  }
+  if (m_values[CacheReferences] > 0 && m_values[CacheMisses] >= 0) {
+    os << "  cache miss ratio: " << m_values[CacheMisses] / m_values[CacheReferences] << std::endl;
+  }
+}
+
+} // namespace Linx
@@ -5,12 +5,13 @@
 #include "Linx/Base/AlignedBuffer.h"
 #include "Linx/Run/ProgramOptions.h"
 #include "Linx/Run/Timer.h"
+#include "LinxRun/Benchmark.h"
 
 #include <map>
 #include <string>
 #include <vector>
 
-using Timer = Linx::Timer<std::chrono::milliseconds>;
+using Timer = Linx::Timer<std::chrono::microseconds>;
 
 Timer::Unit benchmark_buffer(Linx::Index size, Linx::Index alignment)
 {
@@ -19,7 +20,7 @@ Timer::Unit benchmark_buffer(Linx::Index size, Linx::Index alignment)
   timer.start();
   Linx::AlignedBuffer<long> buffer(size, nullptr, alignment);
   auto duration = timer.stop();
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl; // FIXME cout << duration << endl?
+  std::cout << "  Done in " << duration.count() << "us" << std::endl; // FIXME cout << duration << endl?
   long sum = 0;
   std::cout << "Iteration..." << std::endl;
   timer.start();
@@ -28,7 +29,7 @@ Timer::Unit benchmark_buffer(Linx::Index size, Linx::Index alignment)
   }
   duration = timer.stop();
   std::cout << "  Sum:" << sum << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "  Done in " << duration.count() << "us" << std::endl;
   return timer.total();
 }
 
@@ -39,7 +40,7 @@ Timer::Unit benchmark_vector(Linx::Index size)
   timer.start();
   std::vector<long> buffer(size);
   auto duration = timer.stop();
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "  Done in " << duration.count() << "us" << std::endl;
   long sum = 0;
   std::cout << "Iteration..." << std::endl;
   timer.start();
@@ -48,7 +49,7 @@ Timer::Unit benchmark_vector(Linx::Index size)
   }
   duration = timer.stop();
   std::cout << "  Sum:" << sum << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
+  std::cout << "  Done in " << duration.count() << "us" << std::endl;
   return timer.total();
 }
 
@@ -57,17 +58,21 @@ int main(int argc, char const* argv[])
   Linx::ProgramOptions options;
   options.named<long>("align", "Alignment for an AlignedBuffer or 0 for a std::vector");
   options.named<long>("size", "Number of elements", 1000000);
+  Linx::Benchmark::declare(options);
   options.parse(argc, argv);
   const auto alignment = options.as<long>("align");
   const auto size = options.as<long>("size");
 
+  Linx::Benchmark benchmark(options);
   if (alignment > 0) {
-    const auto duration = benchmark_buffer(size, alignment);
-    std::cout << "Done in " << duration.count() << "ms" << std::endl;
+    benchmark.run("buffer" + std::to_string(alignment), [&]() {
+      return benchmark_buffer(size, alignment);
+    });
   } else {
-    const auto duration = benchmark_vector(size);
-    std::cout << "Done in " << duration.count() << "ms" << std::endl;
+    benchmark.run("vector", [&]() {
+      return benchmark_vector(size);
+    });
   }
 
-  return 0;
+  return benchmark.conclude(std::cout);
 }
@@ -5,12 +5,13 @@
 #include "Linx/Run/ProgramOptions.h"
 #include "Linx/Run/Timer.h"
 #include "Linx/Transforms/Filters.h"
+#include "LinxRun/Benchmark.h"
 
 #include <map>
 #include <string>
 
 using Image = Linx::Raster<float>;
-using Duration = std::chrono::milliseconds;
+using Duration = std::chrono::microseconds;
 
 void filter_monolith(Image& image, const Image& values)
 {
@@ -65,6 +66,18 @@ TDuration filter(Image& image, const Image& kernel, char setup)
     case 'd':
       image = Linx::convolution(kernel) * Linx::extrapolation<Linx::Nearest>(image);
       break;
+    case 'p': {
+      auto filter = Linx::convolution(kernel);
+      filter.kernel().strategy(Linx::KernelStrategy::Direct);
+      image = filter * Linx::extrapolation<Linx::Nearest>(image);
+      break;
+    }
+    case 'a': {
+      auto filter = Linx::convolution(kernel);
+      filter.kernel().strategy(Linx::KernelStrategy::ShiftAccumulate);
+      image = filter * Linx::extrapolation<Linx::Nearest>(image);
+      break;
+    }
     case 's':
       image = Linx::sparse_convolution(kernel) * Linx::extrapolation<Linx::Nearest>(image);
       break;
@@ -83,10 +96,11 @@ TDuration filter(Image& image, const Image& kernel, char setup)
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options;
-  options.named("case", "Test case: d (default), m (monolith), h (hardcoded)", 'd');
+  options.named("case", "Test case: d (default), p (pixel-wise), a (shift-and-accumulate), s (sparse), m (monolith), h (hardcoded)", 'd');
   options.named("image", "Raster length along each axis", 2048L);
   options.named("kernel", "Kernel length along each axis", 5L);
   options.named("sparse", "Kernel sparsity", 0.);
+  Linx::Benchmark::declare(options);
   options.parse(argc, argv);
   const auto setup = options.as<char>("case");
   const auto image_diameter = options.as<Linx::Index>("image");
@@ -104,10 +118,13 @@ int main(int argc, char const* argv[])
   std::cout << "  kernel: " << kernel << " (size: " << Linx::sum(mask) << ")" << std::endl;
 
   std::cout << "Filtering..." << std::endl;
-  const auto duration = filter<Duration>(image, kernel, setup);
+  Linx::Benchmark benchmark(options);
+  const auto input = image;
+  benchmark.run(std::string("convolution-") + setup, [&]() {
+    image = input; // Not timed
+    return filter<Duration>(image, kernel, setup);
+  });
   std::cout << "  output: " << image << std::endl;
 
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
-
-  return 0;
+  return benchmark.conclude(std::cout);
 }
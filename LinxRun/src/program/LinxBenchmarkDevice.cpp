@@ -0,0 +1,85 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/Device.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Run/Timer.h"
+#include "LinxRun/Benchmark.h"
+
+#include <string>
+
+using Image = Linx::Raster<float>;
+using Duration = std::chrono::microseconds;
+
+/**
+ * Calibrate a raw raster as `out = raw * flat * gain - bias`.
+ * @param setup The test case: s (sequential), p (parallel), d (device), m (mapped device)
+ */
+template <typename TDuration>
+TDuration calibrate(const Image& raw, const Image& flat, Image& out, char setup)
+{
+  const float gain = 1.5;
+  const float bias = 100;
+  const auto mul = [](auto e, auto f) {
+    return e * f;
+  };
+  const auto affine = [=](auto e) {
+    return e * gain - bias;
+  };
+  Linx::Timer<TDuration> timer;
+  timer.start();
+  switch (setup) {
+    case 's':
+      out.generate(mul, raw, flat);
+      out.apply(affine);
+      break;
+    case 'p':
+      out.generate(Linx::par, mul, raw, flat);
+      out.apply(Linx::par, affine);
+      break;
+    case 'd':
+      Linx::device_generate(out, mul, raw, flat);
+      Linx::device_apply(out, affine);
+      break;
+    case 'm': {
+      Linx::DeviceMapping<const Image> d_raw(raw);
+      Linx::DeviceMapping<const Image> d_flat(flat);
+      Linx::DeviceMapping<Image> d_out(out, false);
+      Linx::device_generate(out, mul, raw, flat);
+      Linx::device_apply(out, affine);
+      d_out.download();
+      break;
+    }
+    default:
+      throw std::runtime_error("Case not implemented"); // FIXME CaseNotImplemented
+  }
+  return timer.stop();
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options;
+  options.named("case", "Test case: s (sequential), p (parallel), d (device), m (mapped device)", 'd');
+  options.named("side", "Image width and height (same value)", 4096L);
+  Linx::Benchmark::declare(options);
+  options.parse(argc, argv);
+  const auto setup = options.as<char>("case");
+  const auto side = options.as<Linx::Index>("side");
+
+  std::cout << "Generating rasters..." << std::endl;
+  const auto raw = Image({side, side}).generate(Linx::UniformNoise<float>(0, 1000, 0));
+  const auto flat = Image({side, side}).generate(Linx::GaussianNoise<float>(1, 0.1, 1));
+  Image out({side, side});
+  std::cout << "  devices: " << Linx::device_count() << std::endl;
+
+  std::cout << "Calibrating..." << std::endl;
+  Linx::Benchmark benchmark(options);
+  benchmark.run(std::string("calibration-") + setup, [&]() {
+    return calibrate<Duration>(raw, flat, out, setup);
+  });
+  std::cout << "  output: " << out << std::endl;
+
+  return benchmark.conclude(std::cout);
+}
@@ -5,6 +5,7 @@
 #include "Linx/Data/Raster.h"
 #include "Linx/Run/ProgramOptions.h"
 #include "Linx/Run/Timer.h"
+#include "LinxRun/Benchmark.h"
 
 #include <map>
 #include <string>
@@ -31,37 +32,45 @@ void taylor_exp(Linx::Raster<double>& inout, Linx::Index order)
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options;
-  options.named<long>("order", "Taylor series order (or -1 for std::exp)", -1);
+  options.named<long>("order", "Taylor series order (or -1 for std::exp, -2 for fast_exp)", -1);
   options.named<long>("side", "Image width and height (same value)", 4096);
+  Linx::Benchmark::declare(options);
   options.parse(argc, argv);
   const auto order = options.as<long>("order");
   const auto side = options.as<long>("side");
 
-  using Duration = std::chrono::milliseconds;
+  using Duration = std::chrono::microseconds;
   Linx::Timer<Duration> timer;
 
+  Linx::Benchmark benchmark(options);
+
   std::cout << "Generating random raster..." << std::endl;
-  auto raster = Linx::Raster<double>({side, side}).generate(Linx::GaussianNoise<double>(0, 1, 0));
+  const auto input = Linx::Raster<double>({side, side}).generate(Linx::GaussianNoise<double>(0, 1, 0));
+  auto raster = input;
 
   std::cout << "Computing exponential..." << std::endl;
-  timer.start();
-  switch (order) {
-    case -1:
-      raster.exp();
-      break;
-    case 0:
-      raster.fill(1);
-      break;
-    case 1:
-      raster += 1;
-      break;
-    default:
-      taylor_exp(raster, order);
-  }
-  const auto duration = timer.stop();
+  benchmark.run("exp" + std::to_string(order), [&]() {
+    raster = input; // Not timed
+    timer.start();
+    switch (order) {
+      case -2:
+        raster.fast_exp();
+        break;
+      case -1:
+        raster.exp();
+        break;
+      case 0:
+        raster.fill(1);
+        break;
+      case 1:
+        raster += 1;
+        break;
+      default:
+        taylor_exp(raster, order);
+    }
+    return timer.stop();
+  });
 
   std::cout << "  found: " << raster << std::endl;
-  std::cout << "  in " << duration.count() << "ms" << std::endl;
-
-  return 0;
+  return benchmark.conclude(std::cout);
 }
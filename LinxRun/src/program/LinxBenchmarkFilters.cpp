@@ -0,0 +1,271 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/ProgramOptions.h"
+#include "Linx/Transforms/FilterSeq.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxRun/Benchmark.h"
+
+#include <algorithm> // transform
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Split a comma-separated list.
+ */
+std::vector<std::string> split(const std::string& list)
+{
+  std::vector<std::string> out;
+  std::istringstream iss(list);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+    if (not item.empty()) {
+      out.push_back(item);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Split a comma-separated list of integers.
+ */
+std::vector<Linx::Index> split_indices(const std::string& list)
+{
+  std::vector<Linx::Index> out;
+  for (const auto& item : split(list)) {
+    out.push_back(std::stol(item));
+  }
+  return out;
+}
+
+/**
+ * @brief A benchmark configuration.
+ */
+struct Setup {
+  std::string filter;
+  std::string type;
+  Linx::Index image;
+  Linx::Index kernel;
+  double sparsity;
+  Linx::Index threads;
+  bool weak;
+
+  /**
+   * @brief Get the configuration name without thread count, e.g. `median-float-i2048-k5-s0`.
+   */
+  std::string label() const
+  {
+    std::ostringstream oss;
+    oss << filter << '-' << type << "-i" << image << "-k" << kernel << "-s" << sparsity;
+    return oss.str();
+  }
+
+  /**
+   * @brief Get the case name, e.g. `median-float-i2048-k5-s0-t4`, with suffix `-weak` for weak scaling.
+   */
+  std::string name() const
+  {
+    return label() + "-t" + std::to_string(threads) + (weak ? "-weak" : "");
+  }
+};
+
+/**
+ * @brief Run a filter on a raster and get the median time in milliseconds.
+ */
+template <typename T, typename TFilter>
+double measure(Linx::Benchmark& benchmark, const Setup& setup, const TFilter& filter, const Linx::Raster<T>& input)
+{
+  Linx::Raster<T> output;
+  return benchmark
+      .run(
+          setup.name(),
+          [&]() {
+            output = filter * Linx::extrapolation<Linx::Nearest>(input);
+          })
+      .median;
+}
+
+/**
+ * @brief Benchmark a filter with a given structuring element.
+ */
+template <typename T, typename TWindow>
+double filter(
+    Linx::Benchmark& benchmark,
+    const Setup& setup,
+    const TWindow& window,
+    const Linx::Raster<T>& kernel,
+    const Linx::Raster<T>& input)
+{
+  const auto& f = setup.filter;
+  const auto t = setup.threads;
+  if (f == "convolution") {
+    auto filter = Linx::convolution(kernel);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "sparse") {
+    auto filter = Linx::sparse_convolution(kernel);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "mean") {
+    auto filter = Linx::mean_filter<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "median") {
+    auto filter = Linx::median_filter<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "minimum") {
+    auto filter = Linx::minimum_filter<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "maximum") {
+    auto filter = Linx::maximum_filter<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "erosion") {
+    auto filter = Linx::erosion<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "dilation") {
+    auto filter = Linx::dilation<T>(window);
+    return measure(benchmark, setup, filter.parallelize(t), input);
+  }
+  if (f == "sequence") { // Denoise, smooth and close
+    auto filter = Linx::median_filter<T>(window) * Linx::mean_filter<T>(window) * Linx::dilation<T>(window) *
+        Linx::erosion<T>(window);
+    return measure(benchmark, setup, filter.stream(-1, t), input);
+  }
+  throw std::runtime_error("Unknown filter: " + f);
+}
+
+/**
+ * @brief Generate the data and benchmark a filter with a given value type.
+ */
+template <typename T>
+double filter(Linx::Benchmark& benchmark, const Setup& setup)
+{
+  const Linx::Position<2> image_shape {setup.image, setup.image};
+  const Linx::Position<2> kernel_shape {setup.kernel, setup.kernel};
+  const auto input = Linx::Raster<T>(image_shape).generate(Linx::UniformNoise<T>(1, 100, 0));
+  auto flags = Linx::Raster<bool>(kernel_shape).generate(Linx::ImpulseNoise<bool>(true, 1 - setup.sparsity, 0));
+  flags[(kernel_shape - 1) / 2] = true;
+  auto kernel = Linx::Raster<T>(kernel_shape).range(1);
+  std::transform(kernel.begin(), kernel.end(), flags.begin(), kernel.begin(), [](auto k, auto f) {
+    return f ? k : T(0);
+  });
+  const auto box = kernel.domain() - (kernel_shape - 1) / 2;
+  if (setup.sparsity > 0) {
+    return filter(benchmark, setup, Linx::Mask<2>(box, flags), kernel, input);
+  }
+  return filter(benchmark, setup, box, kernel, input);
+}
+
+/**
+ * @brief Benchmark a filter with the value type of the setup.
+ */
+double filter(Linx::Benchmark& benchmark, const Setup& setup)
+{
+  if (setup.type == "float") {
+    return filter<float>(benchmark, setup);
+  }
+  if (setup.type == "double") {
+    return filter<double>(benchmark, setup);
+  }
+  if (setup.type == "int") {
+    return filter<int>(benchmark, setup);
+  }
+  throw std::runtime_error("Unknown value type: " + setup.type);
+}
+
+/**
+ * @brief Print a scaling curve.
+ * @param pixels The number of pixels for each thread count
+ * @param milliseconds The median time for each thread count
+ *
+ * The speedup and efficiency are relative to the first thread count.
+ * In strong scaling, the ideal speedup is the thread count ratio;
+ * in weak scaling, the workload grows with the thread count, and the ideal time is constant.
+ */
+void report(
+    const std::string& title,
+    const std::vector<Linx::Index>& threads,
+    const std::vector<Linx::Index>& pixels,
+    const std::vector<double>& milliseconds,
+    bool weak)
+{
+  std::cout << "  " << title << std::endl;
+  for (std::size_t i = 0; i < threads.size(); ++i) {
+    const auto ratio = double(threads[i]) / threads[0];
+    const auto speedup = milliseconds[0] / milliseconds[i] * (weak ? ratio : 1);
+    std::cout << "    threads: " << std::setw(3) << threads[i] << "; pixels/s: " << std::setw(12)
+              << std::setprecision(4) << pixels[i] / milliseconds[i] * 1000 << "; speedup: " << std::setw(6)
+              << speedup << "; efficiency: " << std::setw(6) << speedup / ratio << std::endl;
+  }
+}
+
+int main(int argc, char const* argv[])
+{
+  Linx::ProgramOptions options;
+  options.named(
+      "filters",
+      "Comma-separated filters: convolution, sparse, mean, median, minimum, maximum, erosion, dilation, sequence",
+      std::string("convolution,sparse,mean,median,minimum,maximum,erosion,dilation,sequence"));
+  options.named("types", "Comma-separated value types: float, double, int", std::string("float"));
+  options.named("images", "Comma-separated raster lengths along each axis", std::string("512,2048"));
+  options.named("kernels", "Comma-separated kernel lengths along each axis", std::string("3,7"));
+  options.named("sparsities", "Comma-separated kernel sparsities", std::string("0"));
+  options.named("threads", "Comma-separated thread counts", std::string("1,2,4"));
+  options.flag("weak", "Also measure weak scaling, where the raster area grows with the thread count");
+  Linx::Benchmark::declare(options);
+  options.parse(argc, argv);
+  const auto filters = split(options.as<std::string>("filters"));
+  const auto types = split(options.as<std::string>("types"));
+  const auto images = split_indices(options.as<std::string>("images"));
+  const auto kernels = split_indices(options.as<std::string>("kernels"));
+  const auto threads = split_indices(options.as<std::string>("threads"));
+  std::vector<double> sparsities;
+  for (const auto& s : split(options.as<std::string>("sparsities"))) {
+    sparsities.push_back(std::stod(s));
+  }
+  const auto weak = options.has("weak");
+
+  Linx::Benchmark benchmark(options);
+  std::cout << "Filtering..." << std::endl;
+  for (const auto& f : filters) {
+    for (const auto& type : types) {
+      for (auto k : kernels) {
+        for (auto s : sparsities) {
+          for (auto i : images) {
+            std::vector<Linx::Index> pixels;
+            std::vector<double> milliseconds;
+            for (auto t : threads) {
+              pixels.push_back(i * i);
+              milliseconds.push_back(filter(benchmark, {f, type, i, k, s, t, false}));
+            }
+            const auto title = Setup {f, type, i, k, s, 0, false}.label() + " (strong scaling)";
+            report(title, threads, pixels, milliseconds, false);
+          }
+          if (weak) {
+            const auto i = images.front();
+            std::vector<Linx::Index> pixels;
+            std::vector<double> milliseconds;
+            for (auto t : threads) {
+              const auto side = Linx::Index(std::lround(i * std::sqrt(double(t) / threads.front())));
+              pixels.push_back(side * side);
+              milliseconds.push_back(filter(benchmark, {f, type, side, k, s, t, true}));
+            }
+            const auto title = Setup {f, type, i, k, s, 0, true}.label() + " (weak scaling)";
+            report(title, threads, pixels, milliseconds, true);
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << "Summary:" << std::endl;
+  return benchmark.conclude(std::cout);
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Run/ProgramOptions.h"
+#include "LinxRun/Benchmark.h"
 #include "LinxRun/IterationBenchmark.h"
 
 #include <map>
@@ -19,6 +20,8 @@ Linx::IterationBenchmark::Duration iterate(Linx::IterationBenchmark& benchmark,
       return benchmark.iterate_over_positions();
     case 'q':
       return benchmark.iterate_over_positions_optimized();
+    case 'r':
+      return benchmark.iterate_over_rows();
     case 'i':
       return benchmark.loop_over_indices();
     case 'v':
@@ -27,6 +30,8 @@ Linx::IterationBenchmark::Duration iterate(Linx::IterationBenchmark& benchmark,
       return benchmark.call_operator();
     case 'g':
       return benchmark.call_generate();
+    case 't':
+      return benchmark.permute_axes();
     default:
       throw std::runtime_error("Case not implemented"); // FIXME CaseNotImplemented
   }
@@ -38,17 +43,28 @@ int main(int argc, char const* argv[])
   options.named<char>(
       "case",
       "Initial of the test case to be benchmarked: "
-      "x (x-y-z), z (z-y-x), p (position), i (index), v (value), o (operator), g (generate)");
+      "x (x-y-z), z (z-y-x), p (position), q (position-index), r (row), i (index), v (value), o (operator), "
+      "g (generate), t (transpose)");
   options.named<long>("side", "Image width, height and depth (same value)", 400);
+  options.flag("counters", "Read hardware performance counters (cycles, instructions, cache and branch misses)");
+  Linx::Benchmark::declare(options);
   options.parse(argc, argv);
 
   std::cout << "Generating random rasters..." << std::endl;
-  Linx::IterationBenchmark benchmark(options.as<Linx::Index>("side"));
+  const auto side = options.as<Linx::Index>("side");
+  Linx::IterationBenchmark benchmark(side, options.has("counters"));
 
   std::cout << "Iterating over them..." << std::endl;
-  const auto duration = iterate(benchmark, options.as<char>("case"));
+  const auto setup = options.as<char>("case");
+  Linx::Benchmark harness(options);
+  harness.run(std::string("iteration-") + setup, [&]() {
+    return iterate(benchmark, setup);
+  });
 
-  std::cout << "Done in " << duration.count() << "ms" << std::endl;
+  if (const auto* counters = benchmark.counters()) {
+    std::cout << "Last run counters:" << std::endl;
+    counters->report(std::cout, side * side * side);
+  }
 
-  return 0;
+  return harness.conclude(std::cout);
 }
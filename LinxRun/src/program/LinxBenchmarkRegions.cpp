@@ -5,9 +5,11 @@
 #include "Linx/Data/Grid.h"
 #include "Linx/Data/Mask.h"
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/RunList.h"
 #include "Linx/Data/Sequence.h"
 #include "Linx/Run/ProgramOptions.h"
 #include "Linx/Run/Timer.h"
+#include "LinxRun/Benchmark.h"
 
 #include <map>
 #include <string>
@@ -20,6 +22,7 @@ TDuration filter(Linx::Raster<int, 3>& in, const Linx::Box<3>& box, char setup)
   Linx::Grid<3> grid(box, Linx::Position<3>::one());
   Linx::Mask<3> mask(box);
   Linx::Sequence<Linx::Position<3>> sequence(box);
+  Linx::RunList<3> runs(sequence);
   //! [Make sparse regions]
   timer.start();
   switch (setup) {
@@ -43,6 +46,11 @@ TDuration filter(Linx::Raster<int, 3>& in, const Linx::Box<3>& box, char setup)
       in(sequence) += 1;
       //! [Iterate over sequence]
       break;
+    case 'r':
+      //! [Iterate over run list]
+      in(runs) += 1;
+      //! [Iterate over run list]
+      break;
     default:
       throw std::runtime_error("Case not implemented"); // FIXME CaseNotImplemented
   }
@@ -51,15 +59,16 @@ TDuration filter(Linx::Raster<int, 3>& in, const Linx::Box<3>& box, char setup)
 
 int main(int argc, char const* argv[])
 {
-  using Duration = std::chrono::milliseconds;
+  using Duration = std::chrono::microseconds;
 
   Linx::ProgramOptions options;
   options.named<char>(
       "case",
       "Initial of the test case to be benchmarked: "
-      "b (box), g (grid), m (mask), s (sequence)");
+      "b (box), g (grid), m (mask), s (sequence), r (run list)");
   options.named("side", "Image width, height and depth (same value)", 400L);
   options.named("radius", "Region radius", 10L);
+  Linx::Benchmark::declare(options);
   options.parse(argc, argv);
 
   const auto setup = options.as<char>("case");
@@ -73,11 +82,13 @@ int main(int argc, char const* argv[])
   //! [Make box]
 
   std::cout << "Filtering it..." << std::endl;
-  const auto duration = filter<Duration>(raster, box, setup);
+  Linx::Benchmark benchmark(options);
+  benchmark.run(std::string("regions-") + setup, [&]() {
+    raster.fill(0); // Not timed
+    return filter<Duration>(raster, box, setup);
+  });
   const auto count = std::accumulate(raster.begin(), raster.end(), 0);
 
   std::cout << "  Performed " << count << " additions" << std::endl;
-  std::cout << "  Done in " << duration.count() << "ms" << std::endl;
-
-  return 0;
+  return benchmark.conclude(std::cout);
 }
\ No newline at end of file
@@ -3,16 +3,143 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Io/AsyncFits.h"
 #include "Linx/Io/Fits.h"
+#include "Linx/Run/Execution.h"
 #include "Linx/Run/ProgramOptions.h"
 #include "Linx/Run/Timer.h"
 #include "LinxRun/Cosmics.h"
 
 #include <boost/algorithm/string.hpp>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
+/**
+ * @brief Parse the HDU selection, i.e. `all` or a comma-separated list of indices.
+ */
+std::vector<Linx::Index> parse_hdus(const std::string& selection, Linx::Index count)
+{
+  std::vector<Linx::Index> out;
+  if (selection == "all") {
+    for (Linx::Index i = 0; i < count; ++i) {
+      out.push_back(i);
+    }
+    return out;
+  }
+  std::vector<std::string> items;
+  boost::split(items, selection, boost::is_any_of(","));
+  for (const auto& item : items) {
+    if (not item.empty()) {
+      out.push_back(std::stol(item));
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Detect and segment the cosmic rays of several HDUs concurrently.
+ *
+ * Each worker reads an HDU through the shared input session, processes it, and hands the mask over;
+ * masks are appended to the output in the order of the selection by the asynchronous writer,
+ * whatever the order in which workers complete.
+ */
+int mask_hdus(
+    Linx::FitsSession& data_fits,
+    const std::vector<Linx::Index>& hdus,
+    const Linx::Raster<float>& psf,
+    Linx::FitsSession& map_fits,
+    Linx::Index worker_count,
+    double pfa,
+    double tq,
+    double tc,
+    Linx::Index iter_count)
+{
+  const auto count = static_cast<Linx::Index>(hdus.size());
+  std::vector<std::optional<Linx::Raster<char>>> masks(count);
+  std::mutex read_mutex;
+  std::mutex write_mutex;
+  Linx::Index next_job = 0;
+  Linx::Index next_write = 0;
+  Linx::Index pixel_count = 0;
+  std::exception_ptr error;
+  Linx::AsyncFitsWriter writer(count);
+
+  std::cout << "Masking " << count << " HDUs with " << worker_count << " workers..." << std::endl;
+  Linx::Timer<std::chrono::milliseconds> total_timer;
+  total_timer.start();
+  auto work = [&]() {
+    Linx::Timer<std::chrono::milliseconds> timer;
+    while (true) {
+      Linx::Index job = 0;
+      Linx::Raster<float> data;
+      {
+        std::lock_guard<std::mutex> lock(read_mutex);
+        if (next_job >= count || error) {
+          return;
+        }
+        job = next_job++;
+        try {
+          data = data_fits.read<Linx::Raster<float>>(hdus[job]);
+        } catch (...) {
+          error = std::current_exception();
+          return;
+        }
+      }
+      Linx::Raster<char> mask;
+      try {
+        timer.start();
+        mask = Linx::Cosmics::detect(data, psf, pfa, tq);
+        Linx::Cosmics::segment(data, mask, tc, iter_count);
+        timer.stop();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(read_mutex);
+        error = std::current_exception();
+        return;
+      }
+      const auto milliseconds = timer.back().count();
+      std::lock_guard<std::mutex> lock(write_mutex);
+      std::cout << "  HDU " << hdus[job] << ": " << milliseconds << " ms; "
+                << data.size() / (milliseconds + 1.) / 1000 << " Mpix/s; density: " << Linx::mean(mask) << std::endl;
+      pixel_count += data.size();
+      masks[job] = LINX_MOVE(mask);
+      try {
+        for (; next_write < count && masks[next_write]; ++next_write) {
+          writer.append(map_fits, LINX_MOVE(*masks[next_write]));
+          masks[next_write].reset();
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> error_lock(read_mutex);
+        error = std::current_exception();
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (Linx::Index i = 0; i < worker_count; ++i) {
+    workers.emplace_back(work);
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  writer.wait();
+  total_timer.stop();
+
+  const auto milliseconds = total_timer.back().count();
+  std::cout << "  Done in: " << milliseconds << " ms" << std::endl;
+  std::cout << "  Throughput: " << count * 1000. / (milliseconds + 1.) << " HDU/s; "
+            << pixel_count / (milliseconds + 1.) / 1000 << " Mpix/s" << std::endl;
+  std::cout << "  Peak pooled memory: " << Linx::MemoryPool::high_water_mark() / 1024 << " kB" << std::endl;
+  std::cout << "Saved masks as: " << map_fits.path() << std::endl;
+  return 0;
+}
+
 int main(int argc, char const* argv[])
 {
   Linx::ProgramOptions options;
@@ -23,44 +150,75 @@ int main(int argc, char const* argv[])
   options.named("pfa,p", "The detection probability of false alarm", 0.01);
   options.named("quotient,q", "The star rejection quotient threshold", 0.1);
   options.named("contrast,c", "The region-growing contrast threshold", 0.5);
-  options.named("niter,n", "The number of segmentation iterations", 1L);
+  options.named("niter,n", "The maximum number of segmentation iterations, or -1 to grow until convergence", 1L);
+  options.named("hdus", "The 0-based HDU indices to be processed concurrently, comma-separated, or all", std::string());
+  options.named("workers,j", "The number of concurrent HDUs", 1L);
+  options.named("diagnostics", "The directory where to write the intermediate maps, or empty", std::string());
+  Linx::ExecutionContext::declare(options);
   options.parse(argc, argv);
+  Linx::ExecutionContext::configure(options);
+  std::cout << "Instruction set: " << Linx::instruction_set_report() << std::endl;
   Linx::Fits data_fits(options.as<std::string>("input"));
-  Linx::Fits map_fits(options.as<std::string>("output"));
   Linx::Fits psf_fits(options.as<std::string>("psf"));
   const auto hdu = options.as<Linx::Index>("hdu");
   const auto pfa = options.as<double>("pfa");
   const auto tq = options.as<double>("quotient");
   const auto tc = options.as<double>("contrast");
   const auto iter_count = options.as<Linx::Index>("niter");
+  const auto diagnostics_dir = options.as<std::string>("diagnostics");
+  const auto hdu_selection = options.as<std::string>("hdus");
+  const auto worker_count = std::max<Linx::Index>(options.as<Linx::Index>("workers"), 1);
 
   Linx::Timer<std::chrono::milliseconds> timer;
 
+  if (not hdu_selection.empty()) {
+    std::cout << "Reading PSF: " << psf_fits.path() << std::endl;
+    const auto psf = psf_fits.read<Linx::Raster<float>>();
+    Linx::FitsSession data_session(data_fits.path());
+    const auto hdus = parse_hdus(hdu_selection, data_session.hdu_count());
+    Linx::FitsSession map_fits(options.as<std::string>("output"), 'w');
+    return mask_hdus(data_session, hdus, psf, map_fits, worker_count, pfa, tq, tc, iter_count);
+  }
+
   std::cout << "Reading data: " << data_fits.path() << std::endl;
   auto data = data_fits.read<Linx::Raster<float>>(hdu);
   std::cout << "Reading PSF: " << psf_fits.path() << std::endl;
   auto psf = psf_fits.read<Linx::Raster<float>>();
-  map_fits.write(data, 'w');
+  Linx::FitsSession map_fits(options.as<std::string>("output"), 'w');
+  Linx::AsyncFitsWriter writer; // Overlap writing with detection and segmentation
+  writer.append(map_fits, data);
 
   std::cout << "Detecting cosmics..." << std::endl;
-  timer.start();
-  auto mask = Linx::Cosmics::detect(data, psf, pfa, tq);
-  timer.stop();
+  Linx::Raster<char> mask;
+  if (diagnostics_dir.empty()) {
+    timer.start();
+    mask = Linx::Cosmics::detect(data, psf, pfa, tq);
+    timer.stop();
+  } else {
+    Linx::Cosmics::NpyDiagnostics diagnostics(diagnostics_dir);
+    timer.start();
+    mask = Linx::Cosmics::detect(data, psf, pfa, tq, diagnostics);
+    timer.stop();
+    diagnostics.report(std::cout);
+    diagnostics.wait();
+    std::cout << "  Saved diagnostics in: " << diagnostics_dir << std::endl;
+  }
   std::cout << "  Done in: " << timer.back().count() << " ms" << std::endl;
   std::cout << "  Density: " << Linx::mean(mask) << std::endl;
-  map_fits.write(mask, 'a');
+  std::cout << "  Peak pooled memory: " << Linx::MemoryPool::high_water_mark() / 1024 << " kB" << std::endl;
+  writer.append(map_fits, mask);
 
   std::cout << "Segmenting cosmics..." << std::endl;
-  for (Linx::Index i = 0; i < iter_count; ++i) {
-    std::cout << "  Iteration " << i + 1 << "/" << iter_count << std::endl;
-    timer.start();
-    Linx::Cosmics::segment(data, mask, tc);
-    timer.stop();
-    std::cout << "    Done in: " << timer.back().count() << " ms" << std::endl;
-    std::cout << "    Density: " << Linx::mean(mask) << std::endl;
-    map_fits.write(mask, 'a');
-  }
+  timer.start();
+  const auto added = Linx::Cosmics::segment(data, mask, tc, iter_count);
+  timer.stop();
+  std::cout << "  Done in: " << timer.back().count() << " ms" << std::endl;
+  std::cout << "  Added pixels: " << added << std::endl;
+  std::cout << "  Density: " << Linx::mean(mask) << std::endl;
+  std::cout << "  Peak pooled memory: " << Linx::MemoryPool::high_water_mark() / 1024 << " kB" << std::endl;
+  writer.append(map_fits, mask);
 
+  writer.wait();
   std::cout << "Saved map as: " << map_fits.path() << std::endl;
 
   return 0;
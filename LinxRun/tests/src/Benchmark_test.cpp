@@ -0,0 +1,93 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#define LINX_TRACK_MEMORY
+
+#include "Linx/Data/Raster.h"
+#include "LinxRun/Benchmark.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Benchmark_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(warmup_and_repetitions_test)
+{
+  Benchmark benchmark(2, 5);
+  int calls = 0;
+  const auto& c = benchmark.run("count", [&]() {
+    ++calls;
+  });
+  BOOST_TEST(calls == 7);
+  BOOST_TEST(c.name == "count");
+  BOOST_TEST(c.milliseconds.size() == 5);
+  BOOST_TEST(c.min <= c.median);
+}
+
+BOOST_AUTO_TEST_CASE(returned_duration_test)
+{
+  Benchmark benchmark(0, 3);
+  std::chrono::milliseconds duration(1);
+  const auto& c = benchmark.run("returned", [&]() {
+    duration *= 2;
+    return duration;
+  });
+  BOOST_TEST(c.min == 2);
+  BOOST_TEST(c.median == 4);
+  BOOST_TEST(c.mad == 2);
+}
+
+BOOST_AUTO_TEST_CASE(csv_baseline_test)
+{
+  Benchmark benchmark(0, 1);
+  benchmark.run("fast", []() {
+    return std::chrono::milliseconds(10);
+  });
+  benchmark.run("slow", []() {
+    return std::chrono::milliseconds(20);
+  });
+  std::ostringstream json;
+  benchmark.write_json(json);
+  BOOST_TEST(json.str().find("\"name\": \"slow\"") != std::string::npos);
+
+  const auto path = std::filesystem::temp_directory_path() / "Benchmark_test.csv";
+  benchmark.write(path);
+  auto baseline = Benchmark::read_csv(path);
+  BOOST_TEST(baseline.size() == 2);
+  BOOST_TEST(baseline[1].median == 20);
+
+  std::ostringstream report;
+  BOOST_TEST(benchmark.compare(baseline, 0.1, report) == 0);
+  baseline[1].median = 10;
+  BOOST_TEST(benchmark.compare(baseline, 0.1, report) == 1);
+  BOOST_TEST(report.str().find("REGRESSION slow") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(peak_memory_regression_test)
+{
+  Benchmark benchmark(0, 3);
+  const auto& c = benchmark.run("temporary", []() {
+    Raster<char> tmp({100, 10});
+    return std::chrono::milliseconds(10);
+  });
+  BOOST_TEST(c.peak_bytes == 1000);
+
+  std::vector<BenchmarkCase> baseline {BenchmarkCase("temporary", {}, 1000)};
+  baseline[0].median = 10;
+  std::ostringstream report;
+  BOOST_TEST(benchmark.compare(baseline, 0.1, report) == 0);
+  baseline[0].peak_bytes = 500;
+  BOOST_TEST(benchmark.compare(baseline, 0.1, report) == 1);
+  BOOST_TEST(report.str().find("REGRESSION temporary peak memory") != std::string::npos);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "LinxRun/Cosmics.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Cosmics_test)
+
+//-----------------------------------------------------------------------------
+
+Raster<float> make_psf()
+{
+  Raster<float> psf({5, 5});
+  const auto center = Position<2> {2, 2};
+  for (const auto& p : psf.domain()) {
+    const auto d = p - center;
+    psf[p] = std::exp(-0.5 * (d[0] * d[0] + d[1] * d[1]));
+  }
+  return psf;
+}
+
+Raster<float> make_image()
+{
+  auto image = Raster<float>({64, 64}).generate(GaussianNoise<float>(100, 1, 0));
+  image[{20, 30}] += 1000;
+  image[{21, 30}] += 1000;
+  return image;
+}
+
+BOOST_AUTO_TEST_CASE(no_diagnostics_test)
+{
+  const auto psf = make_psf();
+  const auto image = make_image();
+  Cosmics::MemoryDiagnostics diagnostics;
+  const auto mask = Cosmics::detect(image, psf, 0.001, 0.5);
+  const auto same = Cosmics::detect(image, psf, 0.001, 0.5, diagnostics);
+  BOOST_TEST(mask.container() == same.container(), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(memory_diagnostics_test)
+{
+  const auto psf = make_psf();
+  const auto image = make_image();
+  Cosmics::MemoryDiagnostics diagnostics;
+  Cosmics::detect(image, psf, 0.001, 0.5, diagnostics);
+  BOOST_TEST(diagnostics.maps.count("laplacian") == 1);
+  BOOST_TEST(diagnostics.maps.count("quotient") == 1);
+  BOOST_TEST(diagnostics.maps.at("laplacian").shape() == image.shape());
+  BOOST_TEST(diagnostics.values.count("norm") == 1);
+  BOOST_TEST(diagnostics.values.count("threshold") == 1);
+  BOOST_TEST(diagnostics.values.at("candidates") > 0);
+}
+
+BOOST_AUTO_TEST_CASE(summary_diagnostics_test)
+{
+  Cosmics::SummaryDiagnostics diagnostics;
+  Raster<float> map({2, 2}, {1, 3, std::numeric_limits<float>::quiet_NaN(), 5});
+  diagnostics.map("m", map);
+  BOOST_TEST(diagnostics.values.at("m.min") == 1);
+  BOOST_TEST(diagnostics.values.at("m.max") == 5);
+  BOOST_TEST(diagnostics.values.at("m.mean") == 3);
+  BOOST_TEST(diagnostics.values.at("m.nan") == 1);
+}
+
+BOOST_AUTO_TEST_CASE(fused_laplacian_test)
+{
+  const auto image = Raster<float>({13, 7}).generate(UniformNoise<float>(1, 100, 0));
+  const auto expected = Cosmics::laplacian(image);
+  Index count = 0;
+  Cosmics::for_each_laplacian_row(image, [&](Index y, const auto& row) {
+    BOOST_TEST(y == count);
+    BOOST_TEST(row.size() == 13);
+    for (std::size_t x = 0; x < row.size(); ++x) {
+      const Position<2> p {Index(x), y};
+      BOOST_TEST(row[x] == expected[p], boost::test_tools::tolerance(1e-4f));
+    }
+    ++count;
+  });
+  BOOST_TEST(count == 7);
+}
+
+BOOST_AUTO_TEST_CASE(match_test)
+{
+  const auto psf = make_psf();
+  const auto image = make_image();
+  const auto window = psf.domain() - (psf.shape() - 1) / 2;
+  const auto filter = SimpleFilter<Cosmics::PearsonCorrelation<float, Box<2>>>(window, psf.begin(), psf.end());
+  const auto expected = filter * extrapolation<Nearest>(image);
+  const auto matched = Cosmics::match(image, psf);
+  BOOST_TEST(matched.shape() == image.shape());
+  for (const auto& p : image.domain()) {
+    BOOST_TEST(std::abs(matched[p] - expected[p]) < 1e-4);
+  }
+}
+
+/**
+ * @brief The former, full-image segmentation iteration.
+ */
+template <typename TIn, typename TMask>
+void dense_segment(const TIn& in, TMask& mask, float threshold)
+{
+  Raster<char> candidates(mask.shape());
+  dilation<char>(Box<2>::from_center(1)).transform(extrapolation(mask, '\0'), candidates);
+  candidates.generate(std::minus<>(), candidates, mask);
+  for (const auto& p : candidates.domain() - Box<2>::from_center(1)) {
+    if (candidates[p] && Cosmics::min_contrast(in, mask, p) < threshold) {
+      mask[p] = true;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(segment_test)
+{
+  const auto image = Raster<float>({64, 64}).generate(UniformNoise<float>(1, 100, 0));
+  const auto seeds = Raster<char>({64, 64}).generate(ImpulseNoise<char>(1, 0.02, 0));
+  auto dense = seeds;
+  for (Index i = 1; i <= 4; ++i) {
+    dense_segment(image, dense, 0.3);
+    auto frontier = seeds;
+    const auto added = Cosmics::segment(image, frontier, 0.3, i);
+    BOOST_TEST(added == std::count(frontier.begin(), frontier.end(), 1) - std::count(seeds.begin(), seeds.end(), 1));
+    BOOST_TEST(frontier.container() == dense.container(), boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(segment_convergence_test)
+{
+  const auto image = Raster<float>({32, 32}).generate(UniformNoise<float>(1, 100, 0));
+  auto mask = Raster<char>({32, 32}).generate(ImpulseNoise<char>(1, 0.05, 0));
+  BOOST_TEST(Cosmics::segment(image, mask, 0.3, -1) > 0);
+  auto converged = mask;
+  BOOST_TEST(Cosmics::segment(image, converged, 0.3, -1) == 0);
+  dense_segment(image, converged, 0.3);
+  BOOST_TEST(converged.container() == mask.container(), boost::test_tools::per_element());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
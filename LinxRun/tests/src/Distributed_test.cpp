@@ -0,0 +1,253 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/Distributed.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <atomic>
+#include <boost/test/unit_test.hpp>
+#include <condition_variable>
+#include <cstring> // memcpy
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Linx;
+
+/**
+ * @brief A communicator between threads, which stand for processes.
+ */
+class ThreadCommunicator {
+public:
+
+  struct Shared {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<std::pair<Index, Index>, std::vector<std::vector<char>>> mailboxes;
+    Index arrived = 0;
+    Index generation = 0;
+    Index errors = 0;
+  };
+
+  ThreadCommunicator(std::shared_ptr<Shared> shared, Index rank, Index size) :
+      m_shared(LINX_MOVE(shared)), m_rank(rank), m_size(size)
+  {}
+
+  Index rank() const
+  {
+    return m_rank;
+  }
+
+  Index size() const
+  {
+    return m_size;
+  }
+
+  template <typename T>
+  void exchange(const T* send, Index send_count, Index dest, T* recv, Index recv_count, Index source)
+  {
+    std::unique_lock<std::mutex> lock(m_shared->mutex);
+    if (dest >= 0) {
+      std::vector<char> message(send_count * sizeof(T));
+      std::memcpy(message.data(), send, message.size());
+      m_shared->mailboxes[{m_rank, dest}].push_back(LINX_MOVE(message));
+      m_shared->cv.notify_all();
+    }
+    if (source >= 0) {
+      auto& box = m_shared->mailboxes[{source, m_rank}];
+      m_shared->cv.wait(lock, [&]() {
+        return not box.empty();
+      });
+      if (box.front().size() == recv_count * sizeof(T)) {
+        std::memcpy(recv, box.front().data(), box.front().size());
+      } else {
+        ++m_shared->errors;
+      }
+      box.erase(box.begin());
+    }
+  }
+
+  void barrier()
+  {
+    std::unique_lock<std::mutex> lock(m_shared->mutex);
+    const auto generation = m_shared->generation;
+    if (++m_shared->arrived == m_size) {
+      m_shared->arrived = 0;
+      ++m_shared->generation;
+      m_shared->cv.notify_all();
+    } else {
+      m_shared->cv.wait(lock, [&]() {
+        return m_shared->generation != generation;
+      });
+    }
+  }
+
+private:
+
+  std::shared_ptr<Shared> m_shared;
+  Index m_rank;
+  Index m_size;
+};
+
+/**
+ * @brief Run a function on each rank concurrently, and get the number of communication errors.
+ *
+ * As Boost.Test assertions are not thread-safe, the function should not use them.
+ */
+template <typename TFunc>
+Index run_ranks(Index size, TFunc&& func)
+{
+  auto shared = std::make_shared<ThreadCommunicator::Shared>();
+  std::vector<std::thread> threads;
+  for (Index r = 0; r < size; ++r) {
+    threads.emplace_back([&, r]() {
+      func(ThreadCommunicator(shared, r, size));
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  return shared->errors;
+}
+
+/**
+ * @brief A file-like reader of a raster.
+ */
+struct RasterFile {
+  template <typename TRaster>
+  TRaster read(const Box<2>& region, Index)
+  {
+    return TRaster(raster(region));
+  }
+
+  template <typename TRaster>
+  void write(const TRaster& in, const Box<2>& region, Index)
+  {
+    auto patch = raster(region);
+    std::copy(in.begin(), in.end(), patch.begin());
+  }
+
+  Raster<float> raster;
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Distributed_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(block_partition_test)
+{
+  const Box<2> domain({1, 2}, {6, 11});
+  Index previous = 1;
+  for (Index r = 0; r < 3; ++r) {
+    const auto block = block_partition(domain, 3, r);
+    BOOST_TEST(block.front()[0] == 1);
+    BOOST_TEST(block.back()[0] == 6);
+    BOOST_TEST(block.front()[1] == previous + 1);
+    BOOST_TEST(block.length(1) >= 3);
+    previous = block.back()[1];
+  }
+  BOOST_TEST(previous == 11);
+}
+
+BOOST_AUTO_TEST_CASE(serial_test)
+{
+  Raster<float> in({8, 6});
+  in.range();
+  const auto filter = mean_filter<float>(Box<2>::from_center(1));
+  DistributedRaster<float> image(in.domain(), box(filter.window()));
+  BOOST_TEST(image.owned() == in.domain());
+  BOOST_TEST(image.halo() == in.domain());
+  RasterFile file {in};
+  image.read(file);
+  const auto out = image.filter(filter).gather();
+  const auto expected = filter * extrapolation(in);
+  BOOST_TEST(out.container() == expected.container(), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(halo_exchange_test)
+{
+  Raster<float> in({5, 13});
+  in.range();
+  const Box<2> margin({-1, -2}, {1, 3});
+  std::atomic<Index> mismatches(0);
+  const auto errors = run_ranks(4, [&](ThreadCommunicator comm) {
+    DistributedRaster<float, 2, ThreadCommunicator> image(in.domain(), margin, comm);
+    if (image.halo() != ((image.owned() + margin) & in.domain())) {
+      ++mismatches;
+    }
+    for (const auto& p : image.owned()) {
+      image.local()[p - image.halo().front()] = in[p];
+    }
+    image.exchange();
+    for (const auto& p : image.halo()) {
+      if (image.local()[p - image.halo().front()] != in[p]) {
+        ++mismatches;
+      }
+    }
+  });
+  BOOST_TEST(errors == 0);
+  BOOST_TEST(mismatches == 0);
+}
+
+BOOST_AUTO_TEST_CASE(distributed_filter_test)
+{
+  Raster<float> in({16, 21});
+  in.generate(
+      [](auto p) {
+        return float((p[0] * 7 + p[1] * 13) % 17);
+      },
+      in.domain());
+  Raster<float> kernel({3, 5});
+  kernel.range();
+  const auto filter = correlation(kernel);
+  const auto expected = filter * extrapolation(in);
+  Raster<float> gathered;
+  std::atomic<Index> non_root_size(0);
+  const auto errors = run_ranks(3, [&](ThreadCommunicator comm) {
+    DistributedRaster<float, 2, ThreadCommunicator> image(in.domain(), box(filter.window()), comm);
+    RasterFile file {in};
+    image.read(file);
+    const auto rank = comm.rank();
+    auto out = image.filter(filter).gather();
+    if (rank == 0) {
+      gathered = LINX_MOVE(out);
+    } else {
+      non_root_size += out.size();
+    }
+  });
+  BOOST_TEST(errors == 0);
+  BOOST_TEST(non_root_size == 0);
+  BOOST_TEST(gathered.container() == expected.container(), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(too_small_margin_test)
+{
+  DistributedRaster<float> image(Box<2>::from_shape({4, 4}), Box<2>::from_center(1));
+  const auto filter = mean_filter<float>(Box<2>::from_center(2));
+  BOOST_CHECK_THROW(image.filter(filter), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(write_test)
+{
+  Raster<float> in({6, 8});
+  in.range();
+  RasterFile file {Raster<float>(in.shape())};
+  const auto errors = run_ranks(2, [&](ThreadCommunicator comm) {
+    DistributedRaster<float, 2, ThreadCommunicator> image(in.domain(), Box<2>::from_center(0), comm);
+    for (const auto& p : image.owned()) {
+      image.local()[p - image.halo().front()] = in[p];
+    }
+    image.write(file);
+  });
+  BOOST_TEST(errors == 0);
+  BOOST_TEST(file.raster.container() == in.container(), boost::test_tools::per_element());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
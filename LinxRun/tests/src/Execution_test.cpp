@@ -0,0 +1,168 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Tiling.h"
+#include "Linx/Run/Execution.h"
+
+#include <atomic>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Execution_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(configure_test)
+{
+  ExecutionContext::configure(3);
+#ifdef _OPENMP
+  BOOST_TEST(ExecutionContext::thread_count() == 3);
+  BOOST_TEST(par.thread_count() == 3);
+#endif
+  BOOST_TEST(not ExecutionContext::nested());
+  ExecutionContext::configure(0);
+  BOOST_TEST(ExecutionContext::thread_count() >= 1);
+}
+
+BOOST_AUTO_TEST_CASE(program_options_test)
+{
+  ProgramOptions options;
+  ExecutionContext::declare(options);
+  options.parse("exe --threads 2 --pin");
+  ExecutionContext::configure(options);
+#ifdef _OPENMP
+  BOOST_TEST(ExecutionContext::thread_count() == 2);
+#endif
+  BOOST_TEST(ExecutionContext::pinned() == not ExecutionContext::allowed_cores().empty());
+  ExecutionContext::configure(0);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_box_test)
+{
+  Raster<int> raster({7, 5});
+  parallel_for(par(3), raster.domain(), [&](const auto& p) {
+    raster[p] = p[0] + p[1] * 7;
+  });
+  for (Index i = 0; i < static_cast<Index>(raster.size()); ++i) {
+    BOOST_TEST(raster[i] == i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_each_tiles_test)
+{
+  Raster<int> raster({10, 9});
+  std::atomic<Index> count(0);
+  parallel_for_each(par(4), tiles(raster, Position<2> {4, 4}), [&](auto& tile) {
+    tile.fill(1);
+    ++count;
+  });
+  BOOST_TEST(count == 9);
+  BOOST_TEST(sum(raster) == raster.size());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_reduce_tiles_test)
+{
+  Raster<int> raster({10, 9});
+  raster.range();
+  const auto total = parallel_reduce(
+      par(3),
+      tiles(raster, Position<2> {4, 4}),
+      Index(0),
+      [](Index& acc, const auto& tile) {
+        for (auto e : tile) {
+          acc += e;
+        }
+      },
+      [](Index& acc, Index other) {
+        acc += other;
+      });
+  BOOST_TEST(total == sum(raster));
+  using Fronts = std::vector<Position<2>>;
+  const auto fronts = parallel_reduce(
+      par(4),
+      tiles(raster, Position<2> {4, 4}),
+      Fronts(),
+      [](Fronts& acc, const auto& tile) {
+        acc.push_back(tile.domain().front());
+      },
+      [](Fronts& acc, const Fronts& other) {
+        acc.insert(acc.end(), other.begin(), other.end());
+      });
+  BOOST_TEST(fronts.size() == 9);
+  Index i = 0;
+  for (const auto& tile : tiles(raster, Position<2> {4, 4})) {
+    BOOST_TEST(fronts[i] == tile.domain().front()); // Range order
+    ++i;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_reduce_empty_test)
+{
+  std::vector<int> values;
+  const auto out = parallel_reduce(
+      par(2),
+      values,
+      -1,
+      [](int& acc, int v) {
+        acc += v;
+      },
+      [](int& acc, int other) {
+        acc += other;
+      });
+  BOOST_TEST(out == -1);
+}
+
+BOOST_AUTO_TEST_CASE(nested_test)
+{
+  Raster<int> raster({8, 6});
+  parallel_for_each(par(2), sections(raster), [&](auto& section) {
+    parallel_for(par(2), section.domain(), [&](const auto& p) {
+      section[p] = 1;
+    });
+  });
+  BOOST_TEST(sum(raster) == raster.size());
+}
+
+BOOST_AUTO_TEST_CASE(run_tasks_test)
+{
+  int a = 0;
+  int b = 0;
+  run_tasks(
+      par(2),
+      [&]() {
+        a = 1;
+      },
+      [&]() {
+        b = 2;
+      });
+  BOOST_TEST(a == 1);
+  BOOST_TEST(b == 2);
+}
+
+BOOST_AUTO_TEST_CASE(error_test)
+{
+  std::atomic<Index> count(0);
+  std::vector<int> values {0, 1, 2, 3};
+  BOOST_CHECK_THROW(
+      parallel_for_each(
+          par(2),
+          values,
+          [&](int v) {
+            ++count;
+            if (v == 2) {
+              throw std::runtime_error("2");
+            }
+          }),
+      std::runtime_error);
+  BOOST_TEST(count == 4);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
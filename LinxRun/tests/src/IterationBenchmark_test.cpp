@@ -55,6 +55,12 @@ BOOST_AUTO_TEST_CASE(position_optimized_test)
   validate();
 }
 
+BOOST_AUTO_TEST_CASE(row_test)
+{
+  iterate_over_rows();
+  validate();
+}
+
 BOOST_AUTO_TEST_CASE(index_test)
 {
   loop_over_indices();
@@ -79,6 +85,14 @@ BOOST_AUTO_TEST_CASE(generate_test)
   validate();
 }
 
+BOOST_AUTO_TEST_CASE(transpose_test)
+{
+  permute_axes();
+  for (const auto& p : m_a.domain()) {
+    BOOST_TEST((m_c[{p[2], p[1], p[0]}] == m_a[p]));
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,50 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxRun/IterationBenchmark.h"
+#include "LinxRun/PerfCounters.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PerfCounters_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(start_stop_test)
+{
+  PerfCounters counters;
+  BOOST_TEST(counters[PerfCounters::Instructions] == -1); // Not read yet
+  volatile double sum = 0;
+  counters.start();
+  for (int i = 0; i < 100000; ++i) {
+    sum = sum + i;
+  }
+  counters.stop();
+  if (counters.available()) {
+    BOOST_TEST(counters[PerfCounters::Instructions] != 0);
+  } else {
+    BOOST_TEST(counters[PerfCounters::Instructions] == -1); // Graceful fallback
+  }
+  std::ostringstream os;
+  counters.report(os, 100000);
+  BOOST_TEST(not os.str().empty());
+}
+
+BOOST_AUTO_TEST_CASE(iteration_benchmark_test)
+{
+  IterationBenchmark without(4);
+  BOOST_TEST(not without.counters());
+  IterationBenchmark with(4, true);
+  with.loop_over_indices();
+  BOOST_TEST(with.counters());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
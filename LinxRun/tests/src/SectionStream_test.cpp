@@ -0,0 +1,118 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/SectionStream.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <vector>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SectionStream_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(chunk_domains_test)
+{
+  SectionStream<float> stream({4, 3, 10}, 3);
+  BOOST_TEST(stream.size() == 4);
+  BOOST_TEST(stream.domain(1) == Box<3>({0, 0, 3}, {3, 2, 5}));
+  BOOST_TEST(stream.domain(3) == Box<3>({0, 0, 9}, {3, 2, 9}));
+  BOOST_CHECK_THROW(SectionStream<float>({4, 3, 10}, 0), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(filter_sections_test)
+{
+  auto cube = Raster<float, 3>({17, 13, 11}).range();
+  const auto filter = mean_filter<float>(Box<2>::from_center(1));
+  auto expected = Raster<float, 3>(cube.shape());
+  for (Index z = 0; z < cube.shape()[2]; ++z) {
+    const auto plane = filter * extrapolation(cube.section(z));
+    std::copy(plane.begin(), plane.end(), expected.section(z).begin());
+  }
+  for (Index depth : {1, 3}) {
+    Raster<float, 3> out(cube.shape());
+    SectionStream<float> stream(cube.shape(), 1, depth);
+    stream.run(
+        raster_source(cube),
+        [&](const auto& in, auto& chunk) {
+          const auto plane = filter * extrapolation(in.section(0));
+          std::copy(plane.begin(), plane.end(), chunk.begin());
+        },
+        raster_sink(out));
+    BOOST_TEST(out == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(callbacks_test)
+{
+  const Position<2> shape {5, 8};
+  std::vector<Box<2>> loaded;
+  std::vector<int> sums;
+  SectionStream<int, long, 2> stream(shape, 3);
+  stream.run(
+      [&](const auto& domain, auto& chunk) {
+        loaded.push_back(domain);
+        chunk.fill(int(domain.front()[1]));
+      },
+      [](const auto& in, auto& out) {
+        for (Index i = 0; i < static_cast<Index>(in.size()); ++i) {
+          out[i] = 2 * in[i];
+        }
+      },
+      [&](const auto&, const auto& chunk) {
+        sums.push_back(std::accumulate(chunk.begin(), chunk.end(), 0));
+      });
+  BOOST_TEST(loaded.size() == 3);
+  BOOST_TEST(loaded.back().shape() == Position<2>({5, 2}));
+  BOOST_TEST(sums == std::vector<int>({0, 90, 120}), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(error_propagation_test)
+{
+  SectionStream<float> stream({2, 2, 20});
+  const auto compute = [](const auto& in, auto& out) {
+    std::copy(in.begin(), in.end(), out.begin());
+  };
+  const auto nop = [](const auto&, const auto&) {};
+  const auto fill = [](const auto&, auto& chunk) {
+    chunk.fill(1);
+  };
+  const auto failing = [](const auto& domain, const auto&) {
+    if (domain.front()[2] == 7) {
+      throw Exception("Failure");
+    }
+  };
+  BOOST_CHECK_THROW(stream.run(failing, compute, nop), Exception);
+  BOOST_CHECK_THROW(stream.run(fill, compute, failing), Exception);
+  BOOST_CHECK_THROW(
+      stream.run(
+          fill,
+          [](const auto&, auto&) {
+            throw Exception("Failure");
+          },
+          nop),
+      Exception);
+}
+
+BOOST_AUTO_TEST_CASE(stages_overlap_test)
+{
+  const auto delay = std::chrono::milliseconds(20);
+  const auto wait = [&](auto&&...) {
+    std::this_thread::sleep_for(delay);
+  };
+  SectionStream<char> stream({1, 1, 8});
+  const auto start = std::chrono::steady_clock::now();
+  stream.run(wait, wait, wait);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  BOOST_TEST(elapsed.count() < delay.count() * 8 * 2); // 8 * 3 if serial, 8 + 2 if pipelined
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
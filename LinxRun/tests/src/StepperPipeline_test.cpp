@@ -2,9 +2,16 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Io/Npy.h"
+#include "Linx/Io/Temporary.h"
 #include "Linx/Run/StepperPipeline.h"
 
+#include <atomic>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <numeric> // accumulate
+#include <thread>
+#include <vector>
 
 using namespace Linx;
 
@@ -116,6 +123,242 @@ Step2::Value Dag::get_impl<Step2>()
   return m_2.value;
 }
 
+struct Source : PipelineStep<int()> {};
+struct Left : PipelineStep<int(Source)> {};
+struct Right : PipelineStep<int(Source)> {};
+struct Sink : PipelineStep<int(Left, Right)> {};
+
+class Diamond : public StepperPipeline<Diamond> {
+public:
+
+  std::atomic<int> count {0};
+
+protected:
+
+  template <typename S>
+  void evaluate_impl()
+  {
+    ++count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  template <typename S>
+  typename S::Value get_impl()
+  {
+    return count;
+  }
+};
+
+struct Raw : PipelineStep<const std::vector<int>&()> {
+  static constexpr bool Retained = true;
+};
+struct Scaled : PipelineStep<const std::vector<int>&(Raw)> {};
+struct Offset : PipelineStep<const std::vector<int>&(Scaled)> {};
+struct Total : PipelineStep<int(Raw, Offset)> {};
+
+class Chain : public StepperPipeline<Chain> {
+public:
+
+  const std::vector<int>& scaled() const
+  {
+    return m_scaled;
+  }
+
+  const std::vector<int>& offset() const
+  {
+    return m_offset;
+  }
+
+  int count = 0;
+
+protected:
+
+  template <typename S>
+  void evaluate_impl();
+
+  template <typename S>
+  typename S::Value get_impl();
+
+  template <typename S>
+  void release_impl()
+  {}
+
+private:
+
+  std::vector<int> m_raw;
+  std::vector<int> m_scaled;
+  std::vector<int> m_offset;
+  int m_total = 0;
+};
+
+template <>
+void Chain::evaluate_impl<Raw>()
+{
+  ++count;
+  m_raw = {1, 2, 3};
+}
+
+template <>
+void Chain::evaluate_impl<Scaled>()
+{
+  ++count;
+  m_scaled = m_raw;
+  for (auto& e : m_scaled) {
+    e *= 10;
+  }
+}
+
+template <>
+void Chain::evaluate_impl<Offset>()
+{
+  ++count;
+  m_offset = m_scaled;
+  for (auto& e : m_offset) {
+    ++e;
+  }
+}
+
+template <>
+void Chain::evaluate_impl<Total>()
+{
+  ++count;
+  m_total = 0;
+  for (std::size_t i = 0; i < m_raw.size(); ++i) {
+    m_total += m_raw[i] + m_offset[i];
+  }
+}
+
+template <>
+const std::vector<int>& Chain::get_impl<Raw>()
+{
+  return m_raw;
+}
+
+template <>
+const std::vector<int>& Chain::get_impl<Scaled>()
+{
+  return m_scaled;
+}
+
+template <>
+const std::vector<int>& Chain::get_impl<Offset>()
+{
+  return m_offset;
+}
+
+template <>
+int Chain::get_impl<Total>()
+{
+  return m_total;
+}
+
+template <>
+void Chain::release_impl<Scaled>()
+{
+  std::vector<int>().swap(m_scaled);
+}
+
+template <>
+void Chain::release_impl<Offset>()
+{
+  std::vector<int>().swap(m_offset);
+}
+
+struct Frame : PipelineStep<const Raster<float, 1>&()> {};
+struct Calibrated : PipelineStep<const Raster<float, 1>&(Frame)> {
+  static constexpr bool Cached = true;
+};
+struct Mean : PipelineStep<float(Calibrated)> {};
+
+class Calibration : public StepperPipeline<Calibration> {
+public:
+
+  explicit Calibration(const std::filesystem::path& directory, float gain) : m_gain(gain)
+  {
+    cache_directory(directory);
+  }
+
+  int count = 0;
+
+protected:
+
+  template <typename S>
+  void evaluate_impl();
+
+  template <typename S>
+  typename S::Value get_impl();
+
+  template <typename S>
+  std::size_t hash_impl()
+  {
+    return 0;
+  }
+
+  template <typename S>
+  void save_impl(const std::filesystem::path& path)
+  {
+    Npy(path).write(get_impl<S>(), 'w');
+  }
+
+  template <typename S>
+  void load_impl(const std::filesystem::path& path)
+  {
+    m_calibrated = Npy(path).read<Raster<float, 1>>();
+  }
+
+private:
+
+  float m_gain;
+  Raster<float, 1> m_frame;
+  Raster<float, 1> m_calibrated;
+  float m_mean = 0;
+};
+
+template <>
+void Calibration::evaluate_impl<Frame>()
+{
+  ++count;
+  m_frame = Raster<float, 1>({4}, {1, 2, 3, 4});
+}
+
+template <>
+void Calibration::evaluate_impl<Calibrated>()
+{
+  ++count;
+  m_calibrated = m_frame * m_gain;
+}
+
+template <>
+void Calibration::evaluate_impl<Mean>()
+{
+  ++count;
+  m_mean = std::accumulate(m_calibrated.begin(), m_calibrated.end(), 0.F) / m_calibrated.size();
+}
+
+template <>
+const Raster<float, 1>& Calibration::get_impl<Frame>()
+{
+  return m_frame;
+}
+
+template <>
+const Raster<float, 1>& Calibration::get_impl<Calibrated>()
+{
+  return m_calibrated;
+}
+
+template <>
+float Calibration::get_impl<Mean>()
+{
+  return m_mean;
+}
+
+template <>
+std::size_t Calibration::hash_impl<Calibrated>()
+{
+  return std::hash<float>()(m_gain);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE(StepperPipeline_test)
@@ -185,6 +428,117 @@ BOOST_AUTO_TEST_CASE(all_in_one_test)
   BOOST_TEST(dag.milliseconds<Step2>() > 0);
 }
 
+BOOST_AUTO_TEST_CASE(peak_bytes_test)
+{
+  Dag dag;
+  BOOST_TEST(dag.peak_bytes<Step0>() == -1);
+  dag.get<Step0>();
+  BOOST_TEST(dag.peak_bytes<Step0>() == 0); // Not instrumented
+  BOOST_TEST(dag.peak_bytes<Step1a>() == -1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_test)
+{
+  Diamond dag;
+  const auto z = dag.get<Sink>(par(2));
+  BOOST_TEST(z == 4); // Each step evaluated once
+  BOOST_TEST(dag.evaluated<Left>());
+  BOOST_TEST(dag.evaluated<Right>());
+  const auto branch = std::max(dag.milliseconds<Left>(), dag.milliseconds<Right>());
+  const auto critical = dag.milliseconds<Source>() + branch + dag.milliseconds<Sink>();
+  BOOST_TEST(dag.critical_milliseconds<Sink>() == critical);
+  BOOST_TEST(dag.critical_milliseconds<Sink>() < dag.milliseconds());
+  BOOST_TEST(dag.critical_milliseconds<Left>() == dag.milliseconds<Source>() + dag.milliseconds<Left>());
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_get_test)
+{
+  Diamond dag;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      dag.get<Sink>();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_TEST(dag.count == 4); // Each step evaluated once
+  BOOST_TEST(dag.milliseconds<Sink>() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(copy_times_test)
+{
+  Dag dag;
+  dag.get<Step1a>();
+  const auto copy = dag;
+  BOOST_TEST(copy.evaluated<Step1a>());
+  BOOST_TEST(not copy.evaluated<Step1b>());
+  BOOST_TEST(copy.milliseconds<Step0>() == dag.milliseconds<Step0>());
+  BOOST_TEST(copy.milliseconds() == dag.milliseconds());
+}
+
+BOOST_AUTO_TEST_CASE(release_test)
+{
+  Chain chain;
+  const auto total = chain.get<Total>();
+  BOOST_TEST(total == 6 + 63);
+  BOOST_TEST(chain.count == 4);
+  BOOST_TEST(chain.evaluated<Raw>()); // Retained
+  BOOST_TEST(not chain.released<Raw>());
+  BOOST_TEST(chain.released<Scaled>());
+  BOOST_TEST(chain.scaled().empty());
+  BOOST_TEST(chain.released<Offset>());
+  BOOST_TEST(chain.offset().empty());
+  BOOST_TEST(chain.evaluated<Total>()); // Requested
+  BOOST_TEST(chain.milliseconds<Scaled>() >= 0);
+
+  chain.get<Total>();
+  BOOST_TEST(chain.count == 4); // Nothing re-evaluated
+
+  const auto& offset = chain.get<Offset>();
+  BOOST_TEST(chain.count == 6); // Scaled and Offset re-evaluated
+  BOOST_TEST(offset.size() == 3);
+  BOOST_TEST(chain.evaluated<Offset>());
+  BOOST_TEST(chain.released<Scaled>());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_release_test)
+{
+  Chain chain;
+  const auto total = chain.get<Total>(par(2));
+  BOOST_TEST(total == 6 + 63);
+  BOOST_TEST(chain.count == 4);
+  BOOST_TEST(chain.evaluated<Raw>());
+  BOOST_TEST(chain.scaled().empty());
+  BOOST_TEST(chain.offset().empty());
+}
+
+BOOST_AUTO_TEST_CASE(cache_test)
+{
+  TemporaryPath directory("StepperPipeline_cache_test");
+
+  Calibration first(directory, 2);
+  BOOST_TEST(first.get<Mean>() == 5);
+  BOOST_TEST(first.count == 3);
+  BOOST_TEST(not first.cached<Calibrated>());
+  BOOST_TEST(std::filesystem::is_regular_file(first.cache_path<Calibrated>()));
+
+  Calibration second(directory, 2);
+  BOOST_TEST(second.get<Mean>() == 5);
+  BOOST_TEST(second.count == 1); // Frame and Calibrated skipped
+  BOOST_TEST(second.cached<Calibrated>());
+  BOOST_TEST(second.evaluated<Calibrated>());
+  BOOST_TEST(second.milliseconds<Calibrated>() >= 0);
+  BOOST_TEST(not second.evaluated<Frame>());
+
+  Calibration other(directory, 3);
+  BOOST_TEST(other.cache_path<Calibrated>() != first.cache_path<Calibrated>());
+  BOOST_TEST(other.get<Mean>() == 7.5);
+  BOOST_TEST(other.count == 3);
+  BOOST_TEST(not other.cached<Calibrated>());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
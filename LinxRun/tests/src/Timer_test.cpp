@@ -6,6 +6,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <thread> // sleep_for
+#include <vector>
 
 using namespace Linx;
 
@@ -90,6 +91,42 @@ BOOST_AUTO_TEST_CASE(two_incs_test)
   BOOST_TEST(max() == slow);
 }
 
+BOOST_AUTO_TEST_CASE(tick_clock_test)
+{
+  BOOST_TEST(TickClock::frequency() > 0);
+  const auto tic = TickClock::now();
+  wait(20);
+  const auto toc = TickClock::now();
+  const auto ms = TickClock::to<std::chrono::milliseconds>(toc - tic);
+  BOOST_TEST(ms >= 15);
+  BOOST_TEST(ms < 1000);
+}
+
+BOOST_AUTO_TEST_CASE(scoped_timer_test)
+{
+  TickSamples samples(10);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 15; ++i) {
+        ScopedTimer timer(samples);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_TEST(samples.count() == 60);
+  auto distribution = samples.distribution<std::chrono::microseconds>();
+  BOOST_TEST(distribution.size() == 40); // 10 retained per thread
+  BOOST_TEST(distribution.min() >= 90);
+  BOOST_TEST(samples.total<std::chrono::microseconds>() >= 60 * 90);
+  samples.clear();
+  BOOST_TEST(samples.count() == 0);
+  BOOST_TEST(samples.merge().empty());
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
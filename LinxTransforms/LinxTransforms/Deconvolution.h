@@ -0,0 +1,246 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_DECONVOLUTION_H
+#define _LINXTRANSFORMS_DECONVOLUTION_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/SplitRaster.h" // complex_multiply
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm> // copy_n
+#include <cmath> // abs
+#include <complex>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief Deconvolution engine, with Wiener filtering and Richardson-Lucy iterations in Fourier domain.
+ * @tparam N The dimension
+ * @tparam T The precision of the transforms
+ *
+ * The PSF spectrum (transfer function) and its adjoint are computed once, at construction,
+ * already scaled by the DFT normalization factor,
+ * and every transform is performed in the buffers of a single pair of `DftPlan`s,
+ * such that iterations neither plan nor allocate anything.
+ * Pointwise steps, e.g. the ratio of the data to the blurred estimate and the multiplicative update,
+ * are fused with the loops which read the transform outputs,
+ * and parallelized according to the policy given at construction.
+ * Transforms are multithreaded according to `FftwAllocator::set_thread_count()`, which must be called beforehand.
+ *
+ * Convolutions are periodic: inputs should be padded beforehand if their borders are not negligible,
+ * e.g. with `PaddedRaster`.
+ *
+ * \code
+ * Deconvolution<2> deconvolution(par, psf, image.shape());
+ * const auto sharp = deconvolution.richardson_lucy(image, 50, 1e-4);
+ * std::cout << deconvolution.iteration_count() << " iterations" << std::endl;
+ * \endcode
+ */
+template <Index N = 2, typename T = double>
+class Deconvolution {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param policy The parallel execution policy of the pointwise steps
+   * @param psf The point spread function, centered at `psf.shape() / 2`, and normalized to unit sum if not already
+   * @param shape The shape of the images
+   */
+  template <typename TPsf>
+  Deconvolution(const ParallelPolicy& policy, const TPsf& psf, const Position<N>& shape) :
+      m_dft(shape), m_idft(m_dft.inverse()), m_transfer(m_dft.out_shape()), m_adjoint(m_dft.out_shape()),
+      m_threads(policy.thread_count()), m_iterations(0)
+  {
+    const auto& psf_shape = psf.shape();
+    for (Index i = 0; i < N; ++i) {
+      OutOfBoundsError::may_throw("PSF length", psf_shape[i], {1, shape[i]});
+    }
+    auto& buffer = m_dft.in();
+    buffer.fill(0);
+    const auto center = psf_shape / 2;
+    double sum = 0;
+    auto it = psf.begin();
+    for (const auto& q : Box<N>::from_shape(Position<N>::zero(), psf_shape)) {
+      auto p = q - center;
+      for (Index i = 0; i < N; ++i) {
+        p[i] = (p[i] + shape[i]) % shape[i];
+      }
+      buffer[p] = static_cast<T>(*it);
+      sum += *it;
+      ++it;
+    }
+    m_dft.transform();
+    const auto factor = static_cast<T>(1. / ((sum == 0 ? 1. : sum) * m_dft.normalization_factor()));
+    auto adjoint_it = m_adjoint.begin();
+    auto transfer_it = m_transfer.begin();
+    for (const auto& e : m_dft.out()) {
+      *transfer_it = e * factor;
+      *adjoint_it = std::conj(*transfer_it);
+      ++transfer_it;
+      ++adjoint_it;
+    }
+  }
+
+  /**
+   * @brief Constructor, with sequential pointwise steps.
+   */
+  template <typename TPsf>
+  Deconvolution(const TPsf& psf, const Position<N>& shape) : Deconvolution(ParallelPolicy(1), psf, shape)
+  {}
+
+  LINX_NON_COPYABLE(Deconvolution)
+
+  /**
+   * @brief Get the image shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_dft.logical_shape();
+  }
+
+  /**
+   * @brief Get the number of iterations performed by the last call to `richardson_lucy()`.
+   */
+  Index iteration_count() const
+  {
+    return m_iterations;
+  }
+
+  /**
+   * @brief Deconvolve an image with a Wiener filter.
+   * @param in The blurred image
+   * @param balance The noise-to-signal power ratio, which regularizes the inverse filter
+   *
+   * The output spectrum is `conj(H) / (|H|^2 + balance) * Y`,
+   * where `H` is the transfer function and `Y` is the spectrum of the input.
+   */
+  template <typename TRaster>
+  Raster<T, N> wiener(const TRaster& in, double balance)
+  {
+    load(in);
+    m_dft.transform();
+    const auto n = m_dft.normalization_factor();
+    auto& spectrum = m_dft.out();
+    const auto size = static_cast<Index>(spectrum.size());
+    auto* out_data = spectrum.data();
+    const auto* adjoint = m_adjoint.data();
+#pragma omp parallel for num_threads(static_cast<int>(m_threads))
+    for (Index i = 0; i < size; ++i) {
+      const auto a = adjoint[i];
+      out_data[i] *= a / static_cast<T>(std::norm(a) * n * n + balance);
+    }
+    m_idft.transform();
+    return Raster<T, N>(shape(), m_idft.out());
+  }
+
+  /**
+   * @brief Deconvolve an image with the Richardson-Lucy algorithm.
+   * @param in The blurred image, with non-negative values
+   * @param iterations The maximum number of iterations
+   * @param tolerance The relative change of the estimate below which iterations stop early
+   *
+   * Starting from a constant estimate `x` of the input mean, each iteration computes
+   * `x *= adjoint(y / blur(x))`, where `y` is the input,
+   * with four transforms and two fused pointwise loops.
+   * The relative change is the L1 norm of the update divided by the L1 norm of the estimate;
+   * with a null tolerance, exactly `iterations` iterations are performed.
+   */
+  template <typename TRaster>
+  Raster<T, N> richardson_lucy(const TRaster& in, Index iterations, double tolerance = 0)
+  {
+    check_shape(in);
+    const Raster<T, N> data(shape(), in);
+    double mean = 0;
+    for (const auto& e : data) {
+      mean += e;
+    }
+    mean /= data.size();
+    Raster<T, N> estimate(shape());
+    estimate.fill(static_cast<T>(mean));
+
+    auto& signal = m_dft.in();
+    auto& spectrum = m_dft.out();
+    const auto size = static_cast<Index>(signal.size());
+    const auto spectrum_size = spectrum.size();
+    auto* x = estimate.data();
+    const auto* y = data.data();
+    auto* s = signal.data();
+
+    for (m_iterations = 0; m_iterations < iterations;) {
+
+      // Blurred estimate
+      std::copy_n(x, size, s);
+      m_dft.transform();
+      Internal::complex_multiply(spectrum.data(), m_transfer.data(), spectrum_size);
+      m_idft.transform();
+
+      // Ratio, back-projected
+#pragma omp parallel for num_threads(static_cast<int>(m_threads))
+      for (Index i = 0; i < size; ++i) {
+        s[i] = s[i] > 0 ? y[i] / s[i] : T(0);
+      }
+      m_dft.transform();
+      Internal::complex_multiply(spectrum.data(), m_adjoint.data(), spectrum_size);
+      m_idft.transform();
+
+      // Update
+      double change = 0;
+      double norm = 0;
+#pragma omp parallel for num_threads(static_cast<int>(m_threads)) reduction(+ : change, norm)
+      for (Index i = 0; i < size; ++i) {
+        const auto previous = x[i];
+        x[i] *= s[i];
+        change += std::abs(x[i] - previous);
+        norm += std::abs(x[i]);
+      }
+      ++m_iterations;
+      if (change <= tolerance * norm) {
+        break;
+      }
+    }
+    return estimate;
+  }
+
+private:
+
+  /**
+   * @brief Check that an image has the expected shape.
+   */
+  template <typename TRaster>
+  void check_shape(const TRaster& in) const
+  {
+    if (in.shape() != shape()) {
+      throw Exception("Image and deconvolution shapes differ");
+    }
+  }
+
+  /**
+   * @brief Copy an image into the input buffer.
+   */
+  template <typename TRaster>
+  void load(const TRaster& in)
+  {
+    check_shape(in);
+    auto it = m_dft.in().begin();
+    for (const auto& e : in) {
+      *it = static_cast<T>(e);
+      ++it;
+    }
+  }
+
+  RealDft<N, T> m_dft; ///< The forward plan
+  typename RealDft<N, T>::Inverse m_idft; ///< The inverse plan, with shared buffers
+  Raster<std::complex<T>, N> m_transfer; ///< The scaled transfer function
+  Raster<std::complex<T>, N> m_adjoint; ///< The scaled adjoint transfer function
+  Index m_threads; ///< The number of threads of the pointwise steps
+  Index m_iterations; ///< The number of iterations of the last run
+};
+
+} // namespace Linx
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef _LINXTRANSFORMS_DFT_H
 #define _LINXTRANSFORMS_DFT_H
 
+#include "Linx/Base/Precompiled.h"
 #include "LinxTransforms/DftPlan.h"
 
 #include <complex>
@@ -14,30 +15,76 @@ namespace Linx {
 /**
  * @ingroup dft
  * @brief DFT buffer of real data.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
  */
-template <Index N = 2>
-using RealDftBuffer = AlignedRaster<double, N>;
+template <Index N = 2, typename T = double>
+using RealDftBuffer = AlignedRaster<T, N>;
 
 /**
  * @ingroup dft
  * @brief DFT buffer of complex data.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
  */
-template <Index N = 2>
-using ComplexDftBuffer = AlignedRaster<std::complex<double>, N>;
+template <Index N = 2, typename T = double>
+using ComplexDftBuffer = AlignedRaster<std::complex<T>, N>;
 
 /// @cond
 namespace Internal {
 
 /**
- * @brief Convert a raster shape into an FFTW shape.
+ * @brief The layout of a batch of contiguous FFTW transforms.
  */
-template <typename TRaster>
-std::vector<int> fftw_shape(const TRaster& raster)
-{
-  std::vector<int> out(raster.shape().begin(), raster.shape().end());
-  std::reverse(out.begin(), out.end());
-  return out;
-}
+struct FftwLayout {
+  /**
+   * @brief Make a layout from the logical shape and buffer shapes.
+   * @param batch The number of last axes which are batched, 0 or 1
+   * 
+   * Linx axes are ordered from fastest to slowest, and FFTW's from slowest to fastest.
+   */
+  template <Index N>
+  static FftwLayout
+  from_shapes(const Position<N>& shape, const Position<N>& in_shape, const Position<N>& out_shape, Index batch)
+  {
+    FftwLayout out;
+    const auto rank = N - batch;
+    out.n.assign(shape.begin(), shape.begin() + rank);
+    std::reverse(out.n.begin(), out.n.end());
+    out.inembed.assign(in_shape.begin(), in_shape.begin() + rank);
+    std::reverse(out.inembed.begin(), out.inembed.end());
+    out.onembed.assign(out_shape.begin(), out_shape.begin() + rank);
+    std::reverse(out.onembed.begin(), out.onembed.end());
+    out.howmany = static_cast<int>(batch ? shape[N - 1] : 1);
+    out.idist = 1;
+    out.odist = 1;
+    for (Index i = 0; i < rank; ++i) {
+      out.idist *= in_shape[i];
+      out.odist *= out_shape[i];
+    }
+    return out;
+  }
+
+  std::vector<int> n; ///< The logical shape of each transform, in FFTW order
+  std::vector<int> inembed; ///< The shape of each input buffer, in FFTW order, e.g. padded for in-place real DFTs
+  std::vector<int> onembed; ///< The shape of each output buffer, in FFTW order
+  int howmany; ///< The number of transforms
+  int idist; ///< The distance between the inputs of successive transforms
+  int odist; ///< The distance between the outputs of successive transforms
+};
+
+/**
+ * @brief Get the precision of a real or complex value type.
+ */
+template <typename T>
+struct DftPrecision {
+  using Type = T;
+};
+
+/// @cond
+template <typename T>
+struct DftPrecision<std::complex<T>> {
+  using Type = T;
+};
+/// @endcond
 
 /**
  * @brief Inverse of a `DftTransformMixin`.
@@ -47,6 +94,12 @@ struct Inverse; // Forward declaration for DftTransformMixin
 
 /**
  * @brief Base DFT transform to be inherited.
+ * 
+ * Child classes must implement `allocate_fftw_plan(in, out, flags)` and `allocate_inverse_fftw_plan(in, out, flags)`,
+ * as well as `execute(plan, in, out)` and `execute_inverse(plan, in, out)`, which run a plan on new buffers,
+ * and may shadow `in_shape()` and `out_shape()`.
+ * In-place transforms shadow `InPlace`, and take the logical shape as a third parameter of the allocation functions,
+ * since it cannot be deduced from the buffer shapes.
  */
 template <typename TIn, typename TOut, typename TDerived>
 struct DftTransformMixin {
@@ -70,11 +123,21 @@ struct DftTransformMixin {
    */
   using OutValue = TOut;
 
+  /**
+   * @brief The floating point precision.
+   */
+  using Precision = typename DftPrecision<TIn>::Type;
+
   /**
    * @brief The tag of the inverse transform type.
    */
   using InverseTransform = Inverse<Transform>;
 
+  /**
+   * @brief Whether the input and output buffers are the same buffer.
+   */
+  static constexpr bool InPlace = false;
+
   /**
    * @brief Input buffer shape.
    * @param shape The logical shape
@@ -96,10 +159,14 @@ struct DftTransformMixin {
   }
 
   /**
-   * @brief Allocate an FFTW plan.
+   * @brief Normalization factor, i.e. the number of elements of each transform.
+   * @param shape The logical shape
    */
   template <Index N>
-  static FftwPlanPtr allocate_fftw_plan(AlignedRaster<TIn, N>& in, AlignedRaster<TOut, N>& out);
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return shape_size(shape);
+  }
 };
 
 /**
@@ -111,22 +178,50 @@ struct DftTransformMixin<TIn, TOut, Inverse<TTransform>> {
   using Transform = Inverse<TTransform>;
   using InValue = TOut;
   using OutValue = TIn;
+  using Precision = typename DftPrecision<TIn>::Type;
   using InverseTransform = TTransform;
+  static constexpr bool InPlace = TTransform::InPlace;
 
   template <Index N>
   static Position<N> in_shape(const Position<N>& shape)
   {
-    return DftTransformMixin<TIn, TOut, TTransform>::out_shape(shape);
+    return TTransform::out_shape(shape);
   }
 
   template <Index N>
   static Position<N> out_shape(const Position<N>& shape)
   {
-    return DftTransformMixin<TIn, TOut, TTransform>::in_shape(shape);
+    return TTransform::in_shape(shape);
+  }
+
+  template <Index N>
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return TTransform::normalization_factor(shape);
   }
 
   template <Index N>
-  static FftwPlanPtr allocate_fftw_plan(AlignedRaster<TOut, N>& in, AlignedRaster<TIn, N>& out);
+  static FftwPlanPtr<Precision>
+  allocate_fftw_plan(AlignedRaster<TOut, N>& in, AlignedRaster<TIn, N>& out, unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_inverse_fftw_plan(in, out, flags);
+  }
+
+  template <Index N>
+  static FftwPlanPtr<Precision> allocate_fftw_plan(
+      AlignedRaster<TOut, N>& in,
+      AlignedRaster<TIn, N>& out,
+      const Position<N>& shape,
+      unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_inverse_fftw_plan(in, out, shape, flags);
+  }
+
+  template <typename TPlan, Index N>
+  static void execute(TPlan plan, AlignedRaster<TOut, N>& in, AlignedRaster<TIn, N>& out)
+  {
+    TTransform::execute_inverse(plan, in, out);
+  }
 };
 
 template <typename TTransform>
@@ -134,104 +229,532 @@ struct Inverse : DftTransformMixin<typename TTransform::InValue, typename TTrans
 
 /**
  * @brief Real DFT type.
+ * @tparam T The precision
  */
-struct RealDftTransform;
-struct RealDftTransform : DftTransformMixin<double, std::complex<double>, RealDftTransform> {};
+template <typename T = double>
+struct RealDftTransform : DftTransformMixin<T, std::complex<T>, RealDftTransform<T>> {
+  template <Index N>
+  static Position<N> out_shape(const Position<N>& shape)
+  {
+    auto out = shape;
+    out[0] = out[0] / 2 + 1;
+    return out;
+  }
 
-template <>
-template <Index N>
-Position<N> RealDftTransform::Base::out_shape(const Position<N>& shape)
-{
-  auto out = shape;
-  out[0] = out[0] / 2 + 1;
-  return out;
-}
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      RealDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    const auto layout = FftwLayout::from_shapes(in.shape(), in.shape(), out.shape(), batch);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_dft_r2c(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        reinterpret_cast<T*>(in.data()),
+        layout.inembed.data(),
+        layout.idist,
+        reinterpret_cast<typename Fftw<T>::Complex*>(out.data()),
+        layout.onembed.data(),
+        layout.odist,
+        flags));
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr RealDftTransform::Base::allocate_fftw_plan(RealDftBuffer<N>& in, ComplexDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(in);
-  return std::make_unique<fftw_plan>(fftw_plan_dft_r2c(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<double*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_MEASURE));
-}
+  template <Index N>
+  static FftwPlanPtr<T> allocate_inverse_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      RealDftBuffer<N, T>& out,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    const auto layout = FftwLayout::from_shapes(out.shape(), in.shape(), out.shape(), batch);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_dft_c2r(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        reinterpret_cast<typename Fftw<T>::Complex*>(in.data()),
+        layout.inembed.data(),
+        layout.idist,
+        reinterpret_cast<T*>(out.data()),
+        layout.onembed.data(),
+        layout.odist,
+        flags));
+  }
+  template <Index N>
+  static void execute(typename Fftw<T>::Plan plan, RealDftBuffer<N, T>& in, ComplexDftBuffer<N, T>& out)
+  {
+    Fftw<T>::execute_dft_r2c(plan, in.data(), reinterpret_cast<typename Fftw<T>::Complex*>(out.data()));
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr Inverse<RealDftTransform>::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, RealDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(out);
-  return std::make_unique<fftw_plan>(fftw_plan_dft_c2r(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<double*>(out.data()),
-      FFTW_MEASURE));
-}
+  template <Index N>
+  static void execute_inverse(typename Fftw<T>::Plan plan, ComplexDftBuffer<N, T>& in, RealDftBuffer<N, T>& out)
+  {
+    Fftw<T>::execute_dft_c2r(plan, reinterpret_cast<typename Fftw<T>::Complex*>(in.data()), out.data());
+  }
+};
+
+/**
+ * @brief In-place real DFT type.
+ * @tparam T The precision
+ * 
+ * The real buffer is padded along axis 0 to `2 * (length0 / 2 + 1)` values, as required by FFTW,
+ * such that the complex buffer fits in the same memory.
+ */
+template <typename T = double>
+struct InPlaceRealDftTransform : DftTransformMixin<T, std::complex<T>, InPlaceRealDftTransform<T>> {
+  static constexpr bool InPlace = true;
+
+  template <Index N>
+  static Position<N> in_shape(const Position<N>& shape)
+  {
+    auto out = shape;
+    out[0] = 2 * (out[0] / 2 + 1);
+    return out;
+  }
+
+  template <Index N>
+  static Position<N> out_shape(const Position<N>& shape)
+  {
+    return RealDftTransform<T>::out_shape(shape);
+  }
+
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      RealDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      const Position<N>& shape,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    const auto layout = FftwLayout::from_shapes(shape, in.shape(), out.shape(), batch);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_dft_r2c(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        in.data(),
+        layout.inembed.data(),
+        layout.idist,
+        reinterpret_cast<typename Fftw<T>::Complex*>(out.data()),
+        layout.onembed.data(),
+        layout.odist,
+        flags));
+  }
+
+  template <Index N>
+  static FftwPlanPtr<T> allocate_inverse_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      RealDftBuffer<N, T>& out,
+      const Position<N>& shape,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    const auto layout = FftwLayout::from_shapes(shape, in.shape(), out.shape(), batch);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_dft_c2r(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        reinterpret_cast<typename Fftw<T>::Complex*>(in.data()),
+        layout.inembed.data(),
+        layout.idist,
+        out.data(),
+        layout.onembed.data(),
+        layout.odist,
+        flags));
+  }
+
+  template <Index N>
+  static void execute(typename Fftw<T>::Plan plan, RealDftBuffer<N, T>& in, ComplexDftBuffer<N, T>& out)
+  {
+    RealDftTransform<T>::execute(plan, in, out);
+  }
+
+  template <Index N>
+  static void execute_inverse(typename Fftw<T>::Plan plan, ComplexDftBuffer<N, T>& in, RealDftBuffer<N, T>& out)
+  {
+    RealDftTransform<T>::execute_inverse(plan, in, out);
+  }
+};
 
 /**
  * @brief Complex DFT type.
+ * @tparam T The precision
  */
-struct ComplexDftTransform;
-struct ComplexDftTransform : DftTransformMixin<std::complex<double>, std::complex<double>, ComplexDftTransform> {};
+template <typename T = double>
+struct ComplexDftTransform : DftTransformMixin<std::complex<T>, std::complex<T>, ComplexDftTransform<T>> {
+  template <Index N>
+  static FftwPlanPtr<T> allocate_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    return allocate(in, out, FFTW_FORWARD, flags, batch);
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr ComplexDftTransform::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, ComplexDftBuffer<N>& out)
-{
-  auto shape = fftw_shape(in);
-  return std::make_unique<fftw_plan>(fftw_plan_dft(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_FORWARD,
-      FFTW_MEASURE));
-}
+  template <Index N>
+  static FftwPlanPtr<T> allocate_inverse_fftw_plan(
+      ComplexDftBuffer<N, T>& in,
+      ComplexDftBuffer<N, T>& out,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    return allocate(in, out, FFTW_BACKWARD, flags, batch);
+  }
 
-template <>
-template <Index N>
-FftwPlanPtr Inverse<ComplexDftTransform>::Base::allocate_fftw_plan(ComplexDftBuffer<N>& in, ComplexDftBuffer<N>& out)
+  template <Index N>
+  static void execute(typename Fftw<T>::Plan plan, ComplexDftBuffer<N, T>& in, ComplexDftBuffer<N, T>& out)
+  {
+    Fftw<T>::execute_dft(
+        plan,
+        reinterpret_cast<typename Fftw<T>::Complex*>(in.data()),
+        reinterpret_cast<typename Fftw<T>::Complex*>(out.data()));
+  }
+
+  template <Index N>
+  static void execute_inverse(typename Fftw<T>::Plan plan, ComplexDftBuffer<N, T>& in, ComplexDftBuffer<N, T>& out)
+  {
+    execute(plan, in, out); // The direction is part of the plan
+  }
+
+private:
+
+  template <Index N>
+  static FftwPlanPtr<T>
+  allocate(ComplexDftBuffer<N, T>& in, ComplexDftBuffer<N, T>& out, int sign, unsigned flags, Index batch)
+  {
+    const auto layout = FftwLayout::from_shapes(out.shape(), in.shape(), out.shape(), batch);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_dft(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        reinterpret_cast<typename Fftw<T>::Complex*>(in.data()),
+        layout.inembed.data(),
+        layout.idist,
+        reinterpret_cast<typename Fftw<T>::Complex*>(out.data()),
+        layout.onembed.data(),
+        layout.odist,
+        sign,
+        flags));
+  }
+};
+
+/**
+ * @brief Get the logical length of a real-to-real transform along some axis, i.e. the length of the equivalent DFT.
+ */
+inline Index r2r_logical_length(fftw_r2r_kind kind, Index length)
 {
-  auto shape = fftw_shape(out);
-  return std::make_unique<fftw_plan>(fftw_plan_dft(
-      shape.size(),
-      shape.data(),
-      reinterpret_cast<fftw_complex*>(in.data()),
-      reinterpret_cast<fftw_complex*>(out.data()),
-      FFTW_BACKWARD,
-      FFTW_MEASURE));
+  switch (kind) {
+    case FFTW_REDFT00:
+      return 2 * (length - 1);
+    case FFTW_RODFT00:
+      return 2 * (length + 1);
+    case FFTW_REDFT01:
+    case FFTW_REDFT10:
+    case FFTW_REDFT11:
+    case FFTW_RODFT01:
+    case FFTW_RODFT10:
+    case FFTW_RODFT11:
+      return 2 * length;
+    default:
+      return length;
+  }
 }
 
+/**
+ * @brief Real-to-real DFT type, i.e. discrete cosine or sine transform.
+ * @tparam Kind The FFTW kind of the direct transform along each axis, e.g. `FFTW_REDFT10` for the DCT-II
+ * @tparam InverseKind The FFTW kind of the inverse transform, e.g. `FFTW_REDFT01` for the DCT-III
+ * @tparam T The precision
+ * 
+ * Input and output buffers have the logical shape, and can be the same buffer.
+ * Like DFTs, transforms are not scaled: the normalization factor is the number of elements of the equivalent DFT,
+ * e.g. `2 * length` along each axis for the DCT-II.
+ */
+template <fftw_r2r_kind Kind, fftw_r2r_kind InverseKind, typename T = double>
+struct RealToRealTransform : DftTransformMixin<T, T, RealToRealTransform<Kind, InverseKind, T>> {
+  template <Index N>
+  static double normalization_factor(const Position<N>& shape)
+  {
+    double out = 1;
+    for (auto l : shape) {
+      out *= r2r_logical_length(Kind, l);
+    }
+    return out;
+  }
+
+  template <Index N>
+  static FftwPlanPtr<T>
+  allocate_fftw_plan(RealDftBuffer<N, T>& in, RealDftBuffer<N, T>& out, unsigned flags = FFTW_MEASURE, Index batch = 0)
+  {
+    return allocate(in, out, Kind, flags, batch);
+  }
+
+  template <Index N>
+  static FftwPlanPtr<T> allocate_inverse_fftw_plan(
+      RealDftBuffer<N, T>& in,
+      RealDftBuffer<N, T>& out,
+      unsigned flags = FFTW_MEASURE,
+      Index batch = 0)
+  {
+    return allocate(in, out, InverseKind, flags, batch);
+  }
+
+  template <Index N>
+  static void execute(typename Fftw<T>::Plan plan, RealDftBuffer<N, T>& in, RealDftBuffer<N, T>& out)
+  {
+    Fftw<T>::execute_r2r(plan, in.data(), out.data());
+  }
+
+  template <Index N>
+  static void execute_inverse(typename Fftw<T>::Plan plan, RealDftBuffer<N, T>& in, RealDftBuffer<N, T>& out)
+  {
+    execute(plan, in, out); // The kind is part of the plan
+  }
+
+private:
+
+  template <Index N>
+  static FftwPlanPtr<T>
+  allocate(RealDftBuffer<N, T>& in, RealDftBuffer<N, T>& out, fftw_r2r_kind kind, unsigned flags, Index batch)
+  {
+    const auto layout = FftwLayout::from_shapes(out.shape(), in.shape(), out.shape(), batch);
+    const std::vector<fftw_r2r_kind> kinds(layout.n.size(), kind);
+    return std::make_unique<typename Fftw<T>::Plan>(Fftw<T>::plan_many_r2r(
+        layout.n.size(),
+        layout.n.data(),
+        layout.howmany,
+        in.data(),
+        layout.inembed.data(),
+        layout.idist,
+        out.data(),
+        layout.onembed.data(),
+        layout.odist,
+        kinds.data(),
+        flags));
+  }
+};
+
+/**
+ * @brief Batch of DFTs along all axes but the last one, which indexes the transforms.
+ * @tparam TTransform The transform of each section
+ * 
+ * All the transforms are computed with a single FFTW plan, which can vectorize across the batch.
+ */
+template <typename TTransform>
+struct BatchDftTransform :
+    DftTransformMixin<typename TTransform::InValue, typename TTransform::OutValue, BatchDftTransform<TTransform>> {
+  static constexpr bool InPlace = TTransform::InPlace;
+
+  template <Index N>
+  static Position<N> in_shape(const Position<N>& shape)
+  {
+    return TTransform::in_shape(shape);
+  }
+
+  template <Index N>
+  static Position<N> out_shape(const Position<N>& shape)
+  {
+    return TTransform::out_shape(shape);
+  }
+
+  template <Index N>
+  static double normalization_factor(const Position<N>& shape)
+  {
+    return TTransform::normalization_factor(slice<N - 1>(shape));
+  }
+
+  template <typename TIn, typename TOut>
+  static auto allocate_fftw_plan(TIn& in, TOut& out, unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_fftw_plan(in, out, flags, 1);
+  }
+
+  template <typename TIn, typename TOut>
+  static auto allocate_inverse_fftw_plan(TIn& in, TOut& out, unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_inverse_fftw_plan(in, out, flags, 1);
+  }
+
+  template <typename TIn, typename TOut, Index N>
+  static auto allocate_fftw_plan(TIn& in, TOut& out, const Position<N>& shape, unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_fftw_plan(in, out, shape, flags, 1);
+  }
+
+  template <typename TIn, typename TOut, Index N>
+  static auto allocate_inverse_fftw_plan(TIn& in, TOut& out, const Position<N>& shape, unsigned flags = FFTW_MEASURE)
+  {
+    return TTransform::allocate_inverse_fftw_plan(in, out, shape, flags, 1);
+  }
+
+  template <typename TPlan, typename TIn, typename TOut>
+  static void execute(TPlan plan, TIn& in, TOut& out)
+  {
+    TTransform::execute(plan, in, out);
+  }
+
+  template <typename TPlan, typename TIn, typename TOut>
+  static void execute_inverse(TPlan plan, TIn& in, TOut& out)
+  {
+    TTransform::execute_inverse(plan, in, out);
+  }
+};
+
 } // namespace Internal
 /// @endcond
 
 /**
  * @ingroup dft
  * @brief Real DFT plan.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * Single-precision plans work directly on `float` data, with twice smaller buffers than double-precision plans.
+ */
+template <Index N = 2, typename T = double>
+using RealDft = DftPlan<Internal::RealDftTransform<T>, N>;
+
+/**
+ * @ingroup dft
+ * @brief In-place real DFT plan.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * The input and output buffers share the same memory, which halves the footprint of a `RealDft`.
+ * To this end, the real buffer is padded along axis 0 to `2 * (length0 / 2 + 1)` values,
+ * and `unpadded()` provides a view of the logical values:
+ * 
+ * \code
+ * InPlaceRealDft<2> dft(shape);
+ * auto signal = unpadded(dft.in(), dft.logical_shape());
+ * std::copy(raster.begin(), raster.end(), signal.begin());
+ * dft.transform(); // dft.out() overwrites signal
+ * \endcode
+ * 
+ * Padding values are garbage after transforms.
  */
-template <Index N = 2>
-using RealDft = DftPlan<Internal::RealDftTransform, N>;
+template <Index N = 2, typename T = double>
+using InPlaceRealDft = DftPlan<Internal::InPlaceRealDftTransform<T>, N>;
 
 /**
  * @ingroup dft
  * @brief Complex DFT plan.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ */
+template <Index N = 2, typename T = double>
+using ComplexDft = DftPlan<Internal::ComplexDftTransform<T>, N>;
+
+/**
+ * @ingroup dft
+ * @brief Real-to-real DFT plan of some FFTW kinds, e.g. `RealToRealDft<FFTW_REDFT00, FFTW_REDFT00>` for the DCT-I.
+ * @tparam Kind The FFTW kind of the direct transform, applied along each axis
+ * @tparam InverseKind The FFTW kind of the inverse transform
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * Real-to-real transforms of real data have real coefficients and buffers of the logical shape,
+ * i.e. about twice smaller than the half-spectrum of a `RealDft`.
+ * 
+ * @see `Dct`
+ * @see `Dst`
+ */
+template <fftw_r2r_kind Kind, fftw_r2r_kind InverseKind, Index N = 2, typename T = double>
+using RealToRealDft = DftPlan<Internal::RealToRealTransform<Kind, InverseKind, T>, N>;
+
+/**
+ * @ingroup dft
+ * @brief DCT-II plan, whose inverse is the DCT-III.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * The DCT-II is the DFT of the even extension of the signal around the boundaries,
+ * such that filtering in the DCT domain by a symmetric kernel is equivalent to a convolution with mirror extrapolation
+ * (i.e. half-sample symmetric boundary conditions), without padding the input to twice its shape:
+ * 
+ * \code
+ * Dct<2> dct(shape);
+ * auto idct = dct.inverse();
+ * std::copy(raster.begin(), raster.end(), dct.in().begin());
+ * dct.transform();
+ * dct.out() *= filter; // Assign filter somehow
+ * idct.transform().normalize();
+ * \endcode
+ * 
+ * The normalization factor is the product of `2 * length` along each axis.
  */
-template <Index N = 2>
-using ComplexDft = DftPlan<Internal::ComplexDftTransform, N>;
+template <Index N = 2, typename T = double>
+using Dct = RealToRealDft<FFTW_REDFT10, FFTW_REDFT01, N, T>;
+
+/**
+ * @ingroup dft
+ * @brief DST-II plan, whose inverse is the DST-III.
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * The DST-II is the DFT of the odd extension of the signal around the boundaries,
+ * which is typical of Poisson solvers with zero Dirichlet boundary conditions.
+ * 
+ * The normalization factor is the product of `2 * length` along each axis.
+ */
+template <Index N = 2, typename T = double>
+using Dst = RealToRealDft<FFTW_RODFT10, FFTW_RODFT01, N, T>;
+
+/**
+ * @ingroup dft
+ * @brief Batch of real DFT plans of the sections of a raster, i.e. along all axes but the last one.
+ * @tparam N The dimension of the buffers, i.e. the dimension of each transform plus one
+ * @tparam T The precision, i.e. `double`, `float` or `long double`
+ * 
+ * The last axis indexes the transforms, which are computed with a single FFTW plan.
+ * For example, the 2D transforms of all the planes of a cube are computed at once:
+ * 
+ * \code
+ * RealDftBatch<3, float> dft(cube.shape());
+ * std::copy(cube.begin(), cube.end(), dft.in().begin());
+ * dft.transform();
+ * auto plane_dft = dft.out().section(2); // The DFT of the third plane
+ * \endcode
+ * 
+ * Normalization is performed per transform.
+ */
+template <Index N = 3, typename T = double>
+using RealDftBatch = DftPlan<Internal::BatchDftTransform<Internal::RealDftTransform<T>>, N>;
+
+/**
+ * @ingroup dft
+ * @brief Batch of complex DFT plans of the sections of a raster, i.e. along all axes but the last one.
+ * @copydetails RealDftBatch
+ */
+template <Index N = 3, typename T = double>
+using ComplexDftBatch = DftPlan<Internal::BatchDftTransform<Internal::ComplexDftTransform<T>>, N>;
+
+/**
+ * @relatesalso DftPlan
+ * @brief Get a view of the logical values of a padded real buffer, e.g. of an `InPlaceRealDft`.
+ * @param buffer The padded buffer
+ * @param shape The logical shape
+ */
+template <typename T, Index N>
+auto unpadded(AlignedRaster<T, N>& buffer, const Position<N>& shape)
+{
+  return buffer(Box<N>::from_shape(Position<N>::zero(), shape));
+}
+
+/**
+ * @relatesalso DftPlan
+ * @copydoc unpadded()
+ */
+template <typename T, Index N>
+auto unpadded(const AlignedRaster<T, N>& buffer, const Position<N>& shape)
+{
+  return buffer(Box<N>::from_shape(Position<N>::zero(), shape));
+}
 
 /**
  * @relatesalso DftPlan
  * @brief Compute the complex DFT.
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> complex_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> complex_dft(const TRaster& in)
 {
-  ComplexDft<TRaster::Dimension> plan(in.shape());
+  ComplexDft<TRaster::Dimension, T> plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform();
   return std::move(plan.out());
@@ -241,10 +764,10 @@ ComplexDftBuffer<TRaster::Dimension> complex_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the inverse complex DFT.
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> inverse_complex_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> inverse_complex_dft(const TRaster& in)
 {
-  typename ComplexDft<TRaster::Dimension>::Inverse plan(in.shape());
+  typename ComplexDft<TRaster::Dimension, T>::Inverse plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform().normalize();
   return std::move(plan.out());
@@ -254,10 +777,10 @@ ComplexDftBuffer<TRaster::Dimension> inverse_complex_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the real DFT.
  */
-template <typename TRaster>
-ComplexDftBuffer<TRaster::Dimension> real_dft(const TRaster& in)
+template <typename T = double, typename TRaster>
+ComplexDftBuffer<TRaster::Dimension, T> real_dft(const TRaster& in)
 {
-  RealDft<TRaster::Dimension> plan(in.shape());
+  RealDft<TRaster::Dimension, T> plan(in.shape());
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform();
   return std::move(plan.out());
@@ -267,15 +790,49 @@ ComplexDftBuffer<TRaster::Dimension> real_dft(const TRaster& in)
  * @relatesalso DftPlan
  * @brief Compute the inverse real DFT.
  */
-template <typename TRaster>
-RealDftBuffer<TRaster::Dimension> inverse_real_dft(const TRaster& in, const Position<TRaster::Dimension>& shape)
+template <typename T = double, typename TRaster>
+RealDftBuffer<TRaster::Dimension, T> inverse_real_dft(const TRaster& in, const Position<TRaster::Dimension>& shape)
 {
-  typename RealDft<TRaster::Dimension>::Inverse plan(shape);
+  typename RealDft<TRaster::Dimension, T>::Inverse plan(shape);
   std::copy(in.begin(), in.end(), plan.in().begin());
   plan.transform().normalize();
   return std::move(plan.out());
 }
 
+/**
+ * @relatesalso DftPlan
+ * @brief Compute the DCT-II.
+ */
+template <typename T = double, typename TRaster>
+RealDftBuffer<TRaster::Dimension, T> dct(const TRaster& in)
+{
+  Dct<TRaster::Dimension, T> plan(in.shape());
+  std::copy(in.begin(), in.end(), plan.in().begin());
+  plan.transform();
+  return std::move(plan.out());
+}
+
+/**
+ * @relatesalso DftPlan
+ * @brief Compute the normalized DCT-III, i.e. the inverse DCT-II.
+ */
+template <typename T = double, typename TRaster>
+RealDftBuffer<TRaster::Dimension, T> inverse_dct(const TRaster& in)
+{
+  typename Dct<TRaster::Dimension, T>::Inverse plan(in.shape());
+  std::copy(in.begin(), in.end(), plan.in().begin());
+  plan.transform().normalize();
+  return std::move(plan.out());
+}
+
+#ifdef LINX_PRECOMPILED
+#define LINX_EXTERN_DFTS(T, N) \
+  extern template class DftPlan<Internal::RealDftTransform<T>, N>; \
+  extern template class DftPlan<Internal::ComplexDftTransform<T>, N>;
+LINX_PRECOMPILED_KERNELS(LINX_EXTERN_DFTS)
+#undef LINX_EXTERN_DFTS
+#endif
+
 } // namespace Linx
 
 #endif
@@ -0,0 +1,394 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_DFTFILTER_H
+#define _LINXTRANSFORMS_DFTFILTER_H
+
+#include "Linx/Data/SplitRaster.h" // complex_multiply
+#include "Linx/Data/Tiling.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxTransforms/Dft.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief The kernel size (number of values) from which convolutions and correlations are computed in Fourier domain.
+ *
+ * Direct filtering costs one multiply-add per kernel value and pixel,
+ * while DFT-based filtering costs three transforms of the extended input,
+ * which is faster from medium-sized kernels on.
+ * Separable kernels are always filtered directly, with the separable engine.
+ *
+ * @see `dft_transform()`
+ */
+inline Index dft_filtering_threshold = 121; // 11 x 11
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Extend a filter window to some dimension.
+ */
+template <Index M, Index N>
+Box<M> extend_window(const Box<N>& window)
+{
+  return {extend<M>(window.front()), extend<M>(window.back())};
+}
+
+/**
+ * @brief Get the correlation coefficients of a kernel, ordered like the window positions.
+ */
+template <typename T, typename TWindow>
+std::vector<double> correlation_coefficients(const Correlation<T, TWindow>& kernel)
+{
+  return {kernel.values().begin(), kernel.values().end()};
+}
+
+/**
+ * @brief Get the correlation coefficients of a kernel, ordered like the window positions.
+ */
+template <typename T, typename TWindow>
+std::vector<double> correlation_coefficients(const Convolution<T, TWindow>& kernel)
+{
+  return {kernel.values().rbegin(), kernel.values().rend()};
+}
+
+/**
+ * @brief Test whether a kernel is supported by DFT-based filtering.
+ */
+template <typename TKernel>
+struct IsDftFilterable : std::false_type {};
+
+template <typename T, Index N>
+struct IsDftFilterable<Correlation<T, Box<N>>> : std::is_arithmetic<T> {};
+
+template <typename T, Index N>
+struct IsDftFilterable<Convolution<T, Box<N>>> : std::is_arithmetic<T> {};
+
+/**
+ * @brief Correlate a signal with some coefficients in Fourier domain, in the valid region only.
+ * @param signal The signal
+ * @param coefficients The coefficients, ordered like the positions of a box with the same dimension as `signal`
+ * @param shape The window shape
+ * @param out The output raster, whose shape is `signal.shape() - shape + 1`
+ *
+ * The output is computed as `out[p] = sum_q coefficients[q] * signal[p + q]`,
+ * where `q` spans the window box `Box::from_shape(0, shape)`.
+ * The DFT is computed with the signal shape:
+ * since only the valid region is kept, circular boundary effects are discarded.
+ */
+template <typename TSignal, typename TOut>
+void dft_correlate_valid(
+    const TSignal& signal,
+    const std::vector<double>& coefficients,
+    const Position<TSignal::Dimension>& shape,
+    TOut& out)
+{
+  static constexpr Index N = TSignal::Dimension;
+  using Value = typename TOut::Value;
+
+  const auto& logical_shape = signal.shape();
+  RealDft<N> signal_dft(logical_shape);
+  auto signal_idft = signal_dft.inverse();
+  RealDft<N> kernel_dft(logical_shape);
+
+  // Plans are optimized first, because this overwrites the buffers
+  std::copy(signal.begin(), signal.end(), signal_dft.in().begin());
+  auto& flipped = kernel_dft.in();
+  flipped.fill(0);
+  auto it = coefficients.begin();
+  for (const auto& q : Box<N>::from_shape(Position<N>::zero(), shape)) {
+    auto p = -q;
+    for (Index i = 0; i < N; ++i) {
+      p[i] = (p[i] + logical_shape[i]) % logical_shape[i];
+    }
+    flipped[p] = *it;
+    ++it;
+  }
+
+  signal_dft.transform();
+  kernel_dft.transform();
+  Internal::complex_multiply(signal_dft.out().data(), kernel_dft.out().data(), kernel_dft.out().size());
+  signal_idft.transform().normalize();
+
+  const auto& result = signal_idft.out();
+  auto out_it = out.begin();
+  for (const auto& p : out.domain()) {
+    if constexpr (std::is_integral_v<Value>) {
+      *out_it = static_cast<Value>(std::llround(result[p]));
+    } else {
+      *out_it = static_cast<Value>(result[p]);
+    }
+    ++out_it;
+  }
+}
+
+/**
+ * @brief Read the region of an extrapolated input which is needed for some output tile.
+ */
+template <typename TRaster, typename TMethod, Index N>
+auto read_tile_region(const Extrapolation<TRaster, TMethod>& in, const Box<N>& region)
+{
+  return in.copy(region);
+}
+
+/**
+ * @brief Read the region of an input raster which is needed for some output tile.
+ */
+template <typename T, Index N, typename THolder>
+auto read_tile_region(const Raster<T, N, THolder>& in, const Box<N>& region)
+{
+  return in(region);
+}
+
+/**
+ * @brief Correlate an input with some coefficients in Fourier domain, tile by tile, with the overlap-save method.
+ * @param in The input raster or extrapolator
+ * @param offset The input position of the front of the window for the output position 0
+ * @param coefficients The coefficients, ordered like the positions of a box with the same dimension as `in`
+ * @param shape The window shape
+ * @param fft_shape The logical shape of the DFTs, which is the shape of the input tiles
+ * @param threads The number of threads
+ * @param out The output raster
+ *
+ * The output is partitioned into tiles of shape `fft_shape - shape + 1`.
+ * For each of them, the input tile (the output tile extended by the window) is transformed,
+ * multiplied by the kernel spectrum, and transformed back, and only the valid region is kept, such that tiles are stitched without seams.
+ * The kernel spectrum and the plans are computed once, and shared by the threads, which each own a pair of buffers.
+ */
+template <typename TIn, typename TOut, Index N>
+void dft_correlate_tiles(
+    const TIn& in,
+    const Position<N>& offset,
+    const std::vector<double>& coefficients,
+    const Position<N>& shape,
+    const Position<N>& fft_shape,
+    Index threads,
+    TOut& out)
+{
+  using Value = typename TOut::Value;
+  const Position<N> tile_shape = fft_shape - shape + 1;
+  for (Index i = 0; i < N; ++i) {
+    OutOfBoundsError::may_throw("FFT length", fft_shape[i], {shape[i], std::numeric_limits<Index>::max()});
+  }
+
+  RealDft<N> dft(fft_shape);
+  auto idft = dft.inverse();
+  RealDft<N> kernel_dft(fft_shape);
+  auto& flipped = kernel_dft.in();
+  flipped.fill(0);
+  auto it = coefficients.begin();
+  for (const auto& q : Box<N>::from_shape(Position<N>::zero(), shape)) {
+    auto p = -q;
+    for (Index i = 0; i < N; ++i) {
+      p[i] = (p[i] + fft_shape[i]) % fft_shape[i];
+    }
+    flipped[p] = *it;
+    ++it;
+  }
+  kernel_dft.transform();
+  const auto& kernel_spectrum = kernel_dft.out();
+  const auto factor = 1. / dft.normalization_factor();
+
+  std::vector<Box<N>> boxes;
+  for (const auto& tile : tiles(out, tile_shape)) {
+    boxes.push_back(tile.domain());
+  }
+  const auto size = static_cast<Index>(boxes.size());
+#pragma omp parallel num_threads(static_cast<int>(std::min(threads, size)))
+  {
+    auto signal = FftwAllocator::acquire<double>(fft_shape);
+    auto spectrum = FftwAllocator::acquire<std::complex<double>>(dft.out_shape());
+#pragma omp for schedule(dynamic)
+    for (Index t = 0; t < size; ++t) {
+      const auto& box = boxes[t];
+      const auto region = Box<N>::from_shape(box.front() + offset, box.shape() + shape - 1);
+      const auto values = read_tile_region(in, region);
+      signal.fill(0);
+      auto value_it = values.begin();
+      for (const auto& q : Box<N>::from_shape(Position<N>::zero(), region.shape())) {
+        signal[q] = *value_it;
+        ++value_it;
+      }
+      dft.transform(signal, spectrum);
+      Internal::complex_multiply(spectrum.data(), kernel_spectrum.data(), kernel_spectrum.size());
+      idft.transform(spectrum, signal);
+      for (const auto& p : box) {
+        const auto v = signal[p - box.front()] * factor;
+        if constexpr (std::is_integral_v<Value>) {
+          out[p] = static_cast<Value>(std::llround(v));
+        } else {
+          out[p] = static_cast<Value>(v);
+        }
+      }
+    }
+    FftwAllocator::recycle(LINX_MOVE(signal));
+    FftwAllocator::recycle(LINX_MOVE(spectrum));
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Apply a convolution or correlation filter in Fourier domain.
+ *
+ * The output is that of `filter * in`, up to rounding errors, if `in` is an extrapolator or a raster:
+ * - If `in` is an extrapolator, the output has the same shape as the input,
+ *   and extrapolated values are computed according to the extrapolation method;
+ * - If `in` is a raster, the output is cropped like in the direct method.
+ *
+ * If the value type is integral, the output values are rounded.
+ *
+ * @see `dft_filtering_threshold`
+ */
+template <typename TKernel, typename TRaster, typename TMethod>
+Raster<typename SimpleFilter<TKernel>::Value, TRaster::Dimension>
+dft_transform(const SimpleFilter<TKernel>& filter, const Extrapolation<TRaster, TMethod>& in)
+{
+  static constexpr Index N = TRaster::Dimension;
+  const auto window = Internal::extend_window<N>(filter.window());
+  const auto domain = dont_extrapolate(in).domain();
+  Raster<typename SimpleFilter<TKernel>::Value, N> out(domain.shape());
+  const auto signal = in.copy(domain + window);
+  Internal::dft_correlate_valid(signal, Internal::correlation_coefficients(filter.kernel()), window.shape(), out);
+  return out;
+}
+
+/**
+ * @copydoc dft_transform()
+ */
+template <typename TKernel, typename T, Index N, typename THolder>
+Raster<typename SimpleFilter<TKernel>::Value, N>
+dft_transform(const SimpleFilter<TKernel>& filter, const Raster<T, N, THolder>& in)
+{
+  const auto window = Internal::extend_window<N>(filter.window());
+  Raster<typename SimpleFilter<TKernel>::Value, N> out(in.shape() - (window.shape() - 1));
+  if (out.size() > 0) {
+    Internal::dft_correlate_valid(in, Internal::correlation_coefficients(filter.kernel()), window.shape(), out);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Apply a convolution or correlation filter in Fourier domain, tile by tile.
+ * @param filter The filter
+ * @param in The input extrapolator or raster
+ * @param fft_shape The logical shape of the DFTs, which should be much larger than the window, e.g. `{1024, 1024}`
+ *
+ * The output is that of `dft_transform()`, but the memory footprint does not depend on the input shape:
+ * the input is processed by tiles of shape `fft_shape`, with the overlap-save method,
+ * which yields output tiles of shape `fft_shape - window.shape() + 1`, stitched without seams.
+ * The plans and the spectrum of the kernel are computed once for all tiles,
+ * and tiles are processed in parallel according to `filter.parallelize()`.
+ *
+ * FFTW is fastest when the lengths of `fft_shape` have small prime factors only, e.g. powers of two.
+ *
+ * @see `dft_transform()`
+ */
+template <typename TKernel, typename TRaster, typename TMethod>
+Raster<typename SimpleFilter<TKernel>::Value, TRaster::Dimension> tiled_dft_transform(
+    const SimpleFilter<TKernel>& filter,
+    const Extrapolation<TRaster, TMethod>& in,
+    const Position<TRaster::Dimension>& fft_shape)
+{
+  static constexpr Index N = TRaster::Dimension;
+  const auto window = Internal::extend_window<N>(filter.window());
+  Raster<typename SimpleFilter<TKernel>::Value, N> out(dont_extrapolate(in).shape());
+  Internal::dft_correlate_tiles(
+      in,
+      window.front(),
+      Internal::correlation_coefficients(filter.kernel()),
+      window.shape(),
+      fft_shape,
+      filter.thread_count(),
+      out);
+  return out;
+}
+
+/**
+ * @copydoc tiled_dft_transform()
+ */
+template <typename TKernel, typename T, Index N, typename THolder>
+Raster<typename SimpleFilter<TKernel>::Value, N> tiled_dft_transform(
+    const SimpleFilter<TKernel>& filter,
+    const Raster<T, N, THolder>& in,
+    const Position<N>& fft_shape)
+{
+  const auto window = Internal::extend_window<N>(filter.window());
+  Raster<typename SimpleFilter<TKernel>::Value, N> out(in.shape() - (window.shape() - 1));
+  if (out.size() > 0) {
+    Internal::dft_correlate_tiles(
+        in,
+        Position<N>::zero(),
+        Internal::correlation_coefficients(filter.kernel()),
+        window.shape(),
+        fft_shape,
+        filter.thread_count(),
+        out);
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Filter an extrapolated raster, in Fourier domain if the kernel is large enough.
+ *
+ * This overload is selected over the plain `FilterMixin::operator*()`
+ * as soon as this header is included.
+ *
+ * @see `dft_transform()`
+ * @see `dft_filtering_threshold`
+ */
+template <
+    typename TKernel,
+    typename TRaster,
+    typename TMethod,
+    typename std::enable_if_t<Internal::IsDftFilterable<TKernel>::value>* = nullptr>
+Raster<typename SimpleFilter<TKernel>::Value, TRaster::Dimension>
+operator*(const SimpleFilter<TKernel>& filter, const Extrapolation<TRaster, TMethod>& in)
+{
+  if (filter.window().size() >= dft_filtering_threshold && not filter.kernel().separable()) {
+    return dft_transform(filter, in);
+  }
+  Raster<typename SimpleFilter<TKernel>::Value, TRaster::Dimension> out(in.shape());
+  filter.transform(in, out);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Filter a raster, in Fourier domain if the kernel is large enough.
+ *
+ * @copydetails operator*(const SimpleFilter<TKernel>&, const Extrapolation<TRaster, TMethod>&)
+ */
+template <
+    typename TKernel,
+    typename T,
+    Index N,
+    typename THolder,
+    typename std::enable_if_t<Internal::IsDftFilterable<TKernel>::value>* = nullptr>
+Raster<typename SimpleFilter<TKernel>::Value, N>
+operator*(const SimpleFilter<TKernel>& filter, const Raster<T, N, THolder>& in)
+{
+  if (filter.window().size() >= dft_filtering_threshold && not filter.kernel().separable()) {
+    return dft_transform(filter, in);
+  }
+  const auto window = Internal::extend_window<N>(filter.window());
+  Raster<typename SimpleFilter<TKernel>::Value, N> out(in.shape() - (window.shape() - 1));
+  filter.transform(in, out);
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -5,21 +5,343 @@
 #ifndef _LINXTRANSFORMS_DFTMEMORY_H
 #define _LINXTRANSFORMS_DFTMEMORY_H
 
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // max
 #include <complex>
+#include <cstddef> // size_t
 #include <fftw3.h>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread> // hardware_concurrency
+#include <typeinfo>
+#include <vector>
 
 namespace Linx {
 
+/**
+ * @ingroup dft
+ * @brief The planning rigor of DFT plans.
+ * 
+ * The more rigorous, the longer the planning, and the faster the execution.
+ * Planning time can be saved across processes with wisdom files, see `FftwAllocator::use_wisdom()`.
+ */
+enum class DftRigor {
+  Estimate, ///< Heuristic plan, without measurement (`FFTW_ESTIMATE`), which does not overwrite buffers
+  Measure, ///< Fastest of several measured plans (`FFTW_MEASURE`), the default
+  Patient, ///< Fastest of a wide range of measured plans (`FFTW_PATIENT`)
+  Exhaustive ///< Fastest of all measured plans (`FFTW_EXHAUSTIVE`)
+};
+
 /// @cond
 namespace Internal {
 
 /**
- * @brief RAII wrapper for `fftw_plan`.
+ * @brief The FFTW API of some precision.
  * 
- * `FftwPlan::get()` returns an `fftw_plan`.
+ * The precision is `double` (`fftw_` functions), `float` (`fftwf_`) or `long double` (`fftwl_`).
+ * 
+ * Each precision is a separate FFTW library (e.g. `libfftw3f` for `float`),
+ * which only has to be linked if the precision is used.
+ */
+template <typename T>
+struct Fftw;
+
+/**
+ * @brief The threads API of FFTW, which requires linking against `fftw3_threads` or its analogue.
+ *
+ * Without `LINX_FFTW_THREADS`, plans are single-threaded and the threads functions are no-ops,
+ * except for the cleanup.
+ */
+#ifdef LINX_FFTW_THREADS
+#define LINX_FFTW_THREADS_API(prefix) \
+  static void init_threads() \
+  { \
+    prefix##_init_threads(); \
+  } \
+  static void make_planner_thread_safe() \
+  { \
+    prefix##_make_planner_thread_safe(); \
+  } \
+  static void plan_with_nthreads(int count) \
+  { \
+    prefix##_plan_with_nthreads(count); \
+  } \
+  static void cleanup_threads() \
+  { \
+    prefix##_cleanup_threads(); \
+  }
+#else
+#define LINX_FFTW_THREADS_API(prefix) \
+  static void init_threads() {} \
+  static void make_planner_thread_safe() {} \
+  static void plan_with_nthreads(int) {} \
+  static void cleanup_threads() \
+  { \
+    prefix##_cleanup(); \
+  }
+#endif
+
+/**
+ * @brief Define the FFTW API of some precision, given the function prefix.
+ * 
+ * Plans are destroyed with the `destroy_fftw_plan()` overload of their type.
+ */
+#define LINX_FFTW_API(T, prefix) \
+  template <> \
+  struct Fftw<T> { \
+    using Plan = prefix##_plan; \
+    using Complex = prefix##_complex; \
+    static Plan plan_many_dft( \
+        int rank, \
+        const int* n, \
+        int howmany, \
+        Complex* in, \
+        const int* inembed, \
+        int idist, \
+        Complex* out, \
+        const int* onembed, \
+        int odist, \
+        int sign, \
+        unsigned flags) \
+    { \
+      return prefix##_plan_many_dft(rank, n, howmany, in, inembed, 1, idist, out, onembed, 1, odist, sign, flags); \
+    } \
+    static Plan plan_many_dft_r2c( \
+        int rank, \
+        const int* n, \
+        int howmany, \
+        T* in, \
+        const int* inembed, \
+        int idist, \
+        Complex* out, \
+        const int* onembed, \
+        int odist, \
+        unsigned flags) \
+    { \
+      return prefix##_plan_many_dft_r2c(rank, n, howmany, in, inembed, 1, idist, out, onembed, 1, odist, flags); \
+    } \
+    static Plan plan_many_dft_c2r( \
+        int rank, \
+        const int* n, \
+        int howmany, \
+        Complex* in, \
+        const int* inembed, \
+        int idist, \
+        T* out, \
+        const int* onembed, \
+        int odist, \
+        unsigned flags) \
+    { \
+      return prefix##_plan_many_dft_c2r(rank, n, howmany, in, inembed, 1, idist, out, onembed, 1, odist, flags); \
+    } \
+    static Plan plan_many_r2r( \
+        int rank, \
+        const int* n, \
+        int howmany, \
+        T* in, \
+        const int* inembed, \
+        int idist, \
+        T* out, \
+        const int* onembed, \
+        int odist, \
+        const fftw_r2r_kind* kind, \
+        unsigned flags) \
+    { \
+      return prefix##_plan_many_r2r(rank, n, howmany, in, inembed, 1, idist, out, onembed, 1, odist, kind, flags); \
+    } \
+    static void execute(Plan plan) \
+    { \
+      prefix##_execute(plan); \
+    } \
+    static void execute_dft(Plan plan, Complex* in, Complex* out) \
+    { \
+      prefix##_execute_dft(plan, in, out); \
+    } \
+    static void execute_dft_r2c(Plan plan, T* in, Complex* out) \
+    { \
+      prefix##_execute_dft_r2c(plan, in, out); \
+    } \
+    static void execute_dft_c2r(Plan plan, Complex* in, T* out) \
+    { \
+      prefix##_execute_dft_c2r(plan, in, out); \
+    } \
+    static void execute_r2r(Plan plan, T* in, T* out) \
+    { \
+      prefix##_execute_r2r(plan, in, out); \
+    } \
+    static int alignment_of(T* data) \
+    { \
+      return prefix##_alignment_of(data); \
+    } \
+    LINX_FFTW_THREADS_API(prefix) \
+    static bool import_wisdom(const std::string& filename) \
+    { \
+      return prefix##_import_wisdom_from_filename(filename.c_str()); \
+    } \
+    static bool export_wisdom(const std::string& filename) \
+    { \
+      return prefix##_export_wisdom_to_filename(filename.c_str()); \
+    } \
+    static void forget_wisdom() \
+    { \
+      prefix##_forget_wisdom(); \
+    } \
+  }; \
+  inline void destroy_fftw_plan(prefix##_plan plan) \
+  { \
+    prefix##_destroy_plan(plan); \
+  }
+
+LINX_FFTW_API(double, fftw)
+LINX_FFTW_API(float, fftwf)
+LINX_FFTW_API(long double, fftwl)
+
+#undef LINX_FFTW_API
+#undef LINX_FFTW_THREADS_API
+
+/**
+ * @brief RAII wrapper for FFTW plans of some precision.
+ * 
+ * `FftwPlanPtr::get()` returns a pointer to an `fftw_plan`, `fftwf_plan` or `fftwl_plan`.
+ */
+template <typename T = double>
+using FftwPlanPtr = std::unique_ptr<typename Fftw<T>::Plan>;
+
+/**
+ * @brief The FFTW cleaner of some precision.
+ * 
+ * With `LINX_FFTW_THREADS`, the constructor calls `fftw_init_threads()` and `fftw_make_planner_thread_safe()`
+ * or their analogues, such that plans created outside of `FftwAllocator` (e.g. by another library) do not race with it,
+ * and the destructor calls `fftw_cleanup_threads()`, which also performs `fftw_cleanup()`.
+ * Otherwise, the destructor calls `fftw_cleanup()`.
+ * If a wisdom file was set, the wisdom is exported to it before cleanup.
+ */
+template <typename T>
+struct FftwCleaner {
+  FftwCleaner() : wisdom_file(), plans()
+  {
+    Fftw<T>::init_threads();
+    Fftw<T>::make_planner_thread_safe();
+  }
+
+  ~FftwCleaner()
+  {
+    clear_plans();
+    if (not wisdom_file.empty()) {
+      Fftw<T>::export_wisdom(wisdom_file);
+    }
+    Fftw<T>::cleanup_threads();
+  }
+
+  void clear_plans()
+  {
+    for (auto& p : plans) {
+      destroy_fftw_plan(p.second);
+    }
+    plans.clear();
+  }
+
+  std::string wisdom_file; ///< The file where wisdom is exported at exit, if any
+  std::map<std::string, typename Fftw<T>::Plan> plans; ///< The registry of shared plans
+};
+
+/**
+ * @brief The state shared by the pools of recycled DFT buffers of all value types and dimensions.
+ *
+ * Pools are accessed under `FftwAllocator`'s pool mutex only.
  */
-using FftwPlanPtr = std::unique_ptr<fftw_plan>;
+struct DftBufferPools {
+  /**
+   * @brief Get the functions which empty each pool, registered when the pools are created.
+   */
+  static std::vector<void (*)()>& clearers()
+  {
+    static std::vector<void (*)()> functions;
+    return functions;
+  }
+
+  /**
+   * @brief Get the number of bytes of the pooled buffers.
+   */
+  static std::size_t& bytes()
+  {
+    static std::size_t count = 0;
+    return count;
+  }
+
+  /**
+   * @brief Get the maximum number of bytes of the pooled buffers.
+   */
+  static std::size_t& budget()
+  {
+    static std::size_t count = std::size_t(256) << 20;
+    return count;
+  }
+};
+
+/**
+ * @brief A pool of recycled DFT buffers of some value type and dimension.
+ */
+template <typename T, Index N>
+struct DftBufferPool {
+  /**
+   * @brief The maximum number of buffers kept in the pool.
+   */
+  static constexpr std::size_t capacity = 16;
+
+  /**
+   * @brief Get the pool.
+   */
+  static std::vector<AlignedRaster<T, N>>& buffers()
+  {
+    static std::vector<AlignedRaster<T, N>> pool = []() {
+      DftBufferPools::clearers().push_back(&clear);
+      return std::vector<AlignedRaster<T, N>>();
+    }();
+    return pool;
+  }
+
+  /**
+   * @brief Get the number of bytes of a buffer.
+   */
+  static std::size_t bytes(const AlignedRaster<T, N>& buffer)
+  {
+    return buffer.size() * sizeof(T);
+  }
+
+  /**
+   * @brief Free the oldest buffer of the pool.
+   */
+  static void pop_front()
+  {
+    auto& pool = buffers();
+    DftBufferPools::bytes() -= bytes(pool.front());
+    pool.erase(pool.begin());
+  }
+
+  /**
+   * @brief Free all the buffers of the pool.
+   */
+  static void clear()
+  {
+    while (not buffers().empty()) {
+      pop_front();
+    }
+  }
+};
+
+/**
+ * @brief Get the FFTW alignment of some buffer, i.e. the offset from a SIMD-aligned address.
+ */
+template <typename T, typename U>
+int fftw_alignment(U* data)
+{
+  return Fftw<T>::alignment_of(reinterpret_cast<T*>(const_cast<std::remove_const_t<U>*>(data)));
+}
 
 } // namespace Internal
 /// @endcond
@@ -27,8 +349,21 @@ using FftwPlanPtr = std::unique_ptr<fftw_plan>;
 /**
  * @brief Thread-safe singleton class to ensure proper FFTW memory management.
  * 
- * This is a Meyer's singleton.
- * The destructor, which is executed once (at the end of the program), calls `fftw_cleanup()`.
+ * This is a Meyer's singleton per precision.
+ * The destructor, which is executed once (at the end of the program), calls `fftw_cleanup_threads()` or its analogue,
+ * for the precisions which were used only.
+ * 
+ * Plans are multithreaded according to `set_thread_count()` if `LINX_FFTW_THREADS` is defined,
+ * which requires linking against FFTW's threads libraries; the thread count is ignored otherwise.
+ * Since the FFTW planner is not thread-safe, plans are created and destroyed under a global lock,
+ * such that `DftPlan`s can be constructed from concurrent workers.
+ * Plan execution is not locked: a single `DftPlan` can be executed concurrently on per-worker buffers
+ * with `DftPlan::transform(in, out)`.
+ * 
+ * In addition, the allocator maintains a registry of shared plans,
+ * which are reused on new buffers (see `cached_plan()`), and a pool of recycled buffers (see `acquire()` and `recycle()`), such that repeatedly constructing
+ * `DftPlan`s of the same shape costs neither planning nor allocation.
+ * The pooled buffers are bounded by a byte budget (see `set_pool_budget()`), and can be freed with `clear_buffers()`.
  */
 class FftwAllocator {
 private:
@@ -39,23 +374,52 @@ private:
   FftwAllocator() {}
 
   /**
-   * @brief Destructor which frees.
+   * @brief Get the instance of some precision.
+   * 
+   * Get the singleton if it exists already or instantiate it otherwise,
+   * which triggers cleanup at destruction, i.e. when program ends.
    */
-  ~FftwAllocator()
+  template <typename T>
+  static Internal::FftwCleaner<T>& instantiate()
   {
-    fftw_cleanup();
+    static Internal::FftwCleaner<T> cleaner;
+    return cleaner;
   }
 
   /**
-   * @brief Get the instance.
-   * 
-   * Get the singleton if it exists already or instantiate it otherwise,
-   * which triggers cleanup at destruction, i.e. when program ends.
+   * @brief Get the planner mutex.
+   */
+  static std::mutex& mutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+
+  /**
+   * @brief Get the number of threads of the plans to be created.
    */
-  static FftwAllocator& instantiate()
+  static int& threads()
   {
-    static FftwAllocator allocator;
-    return allocator;
+    static int count = 1;
+    return count;
+  }
+
+  /**
+   * @brief Get the buffer pool mutex.
+   */
+  static std::mutex& pool_mutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+
+  /**
+   * @brief Get the planning rigor of the plans to be created.
+   */
+  static DftRigor& planning()
+  {
+    static DftRigor value = DftRigor::Measure;
+    return value;
   }
 
 public:
@@ -70,25 +434,333 @@ public:
    */
   FftwAllocator& operator=(const FftwAllocator&) = delete;
 
+  /**
+   * @brief Set the number of threads of the plans to be created.
+   * @param count The number of threads, or -1 to use as many threads as available
+   * 
+   * Plans which already exist are not affected.
+   * Multithreading is only worth it for large transforms, e.g. of millions of values.
+   * 
+   * \code
+   * FftwAllocator::set_thread_count(8);
+   * RealDft<2, float> dft({8192, 8192}); // Executed with 8 threads
+   * \endcode
+   */
+  static void set_thread_count(int count = -1)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    threads() = count > 0 ? count : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+
+  /**
+   * @brief Get the number of threads of the plans to be created.
+   */
+  static int thread_count()
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    return threads();
+  }
+
+  /**
+   * @brief Set the planning rigor of the plans to be created.
+   */
+  static void set_rigor(DftRigor rigor)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    planning() = rigor;
+  }
+
+  /**
+   * @brief Get the planning rigor of the plans to be created.
+   */
+  static DftRigor rigor()
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    return planning();
+  }
+
+  /**
+   * @brief Get the FFTW planner flags of the plans to be created.
+   */
+  static unsigned planning_flags()
+  {
+    switch (rigor()) {
+      case DftRigor::Estimate:
+        return FFTW_ESTIMATE;
+      case DftRigor::Patient:
+        return FFTW_PATIENT;
+      case DftRigor::Exhaustive:
+        return FFTW_EXHAUSTIVE;
+      default:
+        return FFTW_MEASURE;
+    }
+  }
+
+  /**
+   * @brief Import wisdom of some precision from a file.
+   * @return `true` if the file could be read
+   * 
+   * Plans which were accumulated in the wisdom are then created almost instantly,
+   * as long as they have the same shape, precision, rigor, thread count and buffer alignment.
+   */
+  template <typename T = double>
+  static bool load_wisdom(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    instantiate<T>();
+    return Internal::Fftw<T>::import_wisdom(filename);
+  }
+
+  /**
+   * @brief Export the accumulated wisdom of some precision to a file.
+   * @return `true` if the file could be written
+   */
+  template <typename T = double>
+  static bool save_wisdom(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    instantiate<T>();
+    return Internal::Fftw<T>::export_wisdom(filename);
+  }
+
+  /**
+   * @brief Import wisdom of some precision from a file, if it exists, and export it back to the file at exit.
+   * 
+   * This is typically called once at startup by each process of a batch job,
+   * such that only the first process pays the planning cost:
+   * 
+   * \code
+   * FftwAllocator::set_rigor(DftRigor::Patient);
+   * FftwAllocator::use_wisdom<float>("fftwf.wisdom");
+   * RealDft<2, float> dft({4096, 4096}); // Slow the first time only
+   * \endcode
+   * 
+   * @warning
+   * Concurrent processes may overwrite the file at exit, in which case the wisdom of one of them is kept.
+   */
+  template <typename T = double>
+  static bool use_wisdom(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    auto& cleaner = instantiate<T>();
+    cleaner.wisdom_file = filename;
+    return Internal::Fftw<T>::import_wisdom(filename);
+  }
+
+  /**
+   * @brief Forget the accumulated wisdom of some precision.
+   */
+  template <typename T = double>
+  static void forget_wisdom()
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    instantiate<T>();
+    Internal::Fftw<T>::forget_wisdom();
+  }
+
   /**
    * @brief Create a plan.
    * @warning
-   * `in` and `out` are filled with garbage.
+   * `in` and `out` are filled with garbage, unless the rigor is `DftRigor::Estimate`
+   * or the plan was found in the wisdom.
    */
   template <typename TTransform, typename TIn, typename TOut>
-  static Internal::FftwPlanPtr create_plan(TIn& in, TOut& out)
+  static Internal::FftwPlanPtr<typename TTransform::Precision> create_plan(TIn& in, TOut& out)
+  {
+    using T = typename TTransform::Precision;
+    const auto flags = planning_flags();
+    std::lock_guard<std::mutex> lock(mutex());
+    instantiate<T>();
+    Internal::Fftw<T>::plan_with_nthreads(threads());
+    return TTransform::allocate_fftw_plan(in, out, flags);
+  }
+
+  /**
+   * @brief Get a plan from the registry of shared plans, or create and register it.
+   * 
+   * The plan is keyed by the transform type, the logical shape, the shapes and FFTW alignments of the buffers,
+   * the planning rigor and the number of threads.
+   * It is owned by the registry, and must be executed with the new-array execute functions
+   * on buffers of the same shapes and alignments (e.g. `fftw_execute_dft()`),
+   * which makes it reusable across `DftPlan`s.
+   * If the plan is created, `in` and `out` are filled with garbage.
+   */
+  template <typename TTransform, typename TIn, typename TOut, Index N>
+  static typename Internal::Fftw<typename TTransform::Precision>::Plan
+  cached_plan(TIn& in, TOut& out, const Position<N>& shape)
+  {
+    using T = typename TTransform::Precision;
+    const auto flags = planning_flags();
+    std::ostringstream os;
+    os << typeid(TTransform).name() << ' ' << flags;
+    for (auto l : shape) {
+      os << ' ' << l;
+    }
+    for (auto l : in.shape()) {
+      os << ' ' << l;
+    }
+    for (auto l : out.shape()) {
+      os << ' ' << l;
+    }
+    os << ' ' << Internal::fftw_alignment<T>(in.data()) << ' ' << Internal::fftw_alignment<T>(out.data());
+    os << ' ' << (static_cast<void*>(in.data()) == static_cast<void*>(out.data()));
+    std::lock_guard<std::mutex> lock(mutex());
+    os << ' ' << threads();
+    auto& registry = instantiate<T>().plans;
+    const auto key = os.str();
+    const auto it = registry.find(key);
+    if (it != registry.end()) {
+      return it->second;
+    }
+    Internal::Fftw<T>::plan_with_nthreads(threads());
+    auto plan = allocate_plan<TTransform>(in, out, shape, flags);
+    const auto raw = *plan;
+    registry.emplace(key, raw);
+    return raw;
+  }
+
+  /**
+   * @brief Allocate a plan, given the logical shape for in-place transforms.
+   */
+  template <typename TTransform, typename TIn, typename TOut, Index N>
+  static auto allocate_plan(TIn& in, TOut& out, const Position<N>& shape, unsigned flags)
+  {
+    if constexpr (TTransform::InPlace) {
+      return TTransform::allocate_fftw_plan(in, out, shape, flags);
+    } else {
+      return TTransform::allocate_fftw_plan(in, out, flags);
+    }
+  }
+
+  /**
+   * @brief Destroy the shared plans of some precision.
+   * @warning
+   * Existing `DftPlan`s of this precision must not be executed anymore.
+   */
+  template <typename T = double>
+  static void clear_plans()
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    instantiate<T>().clear_plans();
+  }
+
+  /**
+   * @brief Get the number of shared plans of some precision.
+   */
+  template <typename T = double>
+  static std::size_t plan_count()
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    return instantiate<T>().plans.size();
+  }
+
+  /**
+   * @brief Get an owning buffer of some shape, recycled from the pool if possible.
+   */
+  template <typename T, Index N>
+  static AlignedRaster<T, N> acquire(const Position<N>& shape)
+  {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex());
+      auto& pool = Internal::DftBufferPool<T, N>::buffers();
+      for (auto it = pool.begin(); it != pool.end(); ++it) {
+        if (it->shape() == shape) {
+          auto out = LINX_MOVE(*it);
+          pool.erase(it);
+          Internal::DftBufferPools::bytes() -= Internal::DftBufferPool<T, N>::bytes(out);
+          return out;
+        }
+      }
+    }
+    return AlignedRaster<T, N>(shape);
+  }
+
+  /**
+   * @brief Give an owning buffer back to the pool.
+   * 
+   * Non-owning buffers are ignored.
+   * The oldest buffers of the same type are freed if the pool is full or if the budget would be exceeded,
+   * and the buffer itself is freed if it does not fit in the budget anyway.
+   */
+  template <typename T, Index N>
+  static void recycle(AlignedRaster<T, N>&& buffer)
+  {
+    using Pool = Internal::DftBufferPool<T, N>;
+    if (not buffer.owns()) {
+      return;
+    }
+    const auto bytes = Pool::bytes(buffer);
+    std::lock_guard<std::mutex> lock(pool_mutex());
+    auto& pool = Pool::buffers();
+    auto& pooled = Internal::DftBufferPools::bytes();
+    const auto budget = Internal::DftBufferPools::budget();
+    while (not pool.empty() && (pool.size() >= Pool::capacity || pooled + bytes > budget)) {
+      Pool::pop_front();
+    }
+    if (pooled + bytes > budget) {
+      return;
+    }
+    pooled += bytes;
+    pool.push_back(LINX_MOVE(buffer));
+  }
+
+  /**
+   * @brief Free the pooled buffers of all types.
+   * 
+   * Buffers which were acquired are not affected, and may be recycled later.
+   */
+  static void clear_buffers()
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex());
+    for (auto clear : Internal::DftBufferPools::clearers()) {
+      clear();
+    }
+  }
+
+  /**
+   * @brief Set the maximum number of bytes of the pooled buffers, 256 MiB by default.
+   * 
+   * If the pooled buffers exceed the new budget, they are all freed.
+   */
+  static void set_pool_budget(std::size_t bytes)
+  {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex());
+      Internal::DftBufferPools::budget() = bytes;
+      if (Internal::DftBufferPools::bytes() <= bytes) {
+        return;
+      }
+    }
+    clear_buffers();
+  }
+
+  /**
+   * @brief Get the maximum number of bytes of the pooled buffers.
+   */
+  static std::size_t pool_budget()
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex());
+    return Internal::DftBufferPools::budget();
+  }
+
+  /**
+   * @brief Get the number of bytes of the pooled buffers.
+   */
+  static std::size_t pooled_bytes()
   {
-    instantiate();
-    return TTransform::allocate_fftw_plan(in, out);
+    std::lock_guard<std::mutex> lock(pool_mutex());
+    return Internal::DftBufferPools::bytes();
   }
 
   /**
    * @brief Destroy a plan.
    */
-  static void destroy_plan(Internal::FftwPlanPtr& plan)
+  template <typename TPlan>
+  static void destroy_plan(std::unique_ptr<TPlan>& plan)
   {
     if (plan) {
-      fftw_destroy_plan(*plan);
+      std::lock_guard<std::mutex> lock(mutex());
+      Internal::destroy_fftw_plan(*plan);
     }
   }
 };
@@ -5,6 +5,7 @@
 #ifndef _LINXTRANSFORMS_DFTPLAN_H
 #define _LINXTRANSFORMS_DFTPLAN_H
 
+#include "Linx/Base/Trace.h"
 #include "Linx/Data/Raster.h"
 #include "LinxTransforms/DftMemory.h"
 
@@ -25,6 +26,9 @@ namespace Linx {
  * is to call the forward transform and later the inverse transform.
  * To this end, `inverse()` creates an inverse plan with shared buffers (see example below).
  * 
+ * Plans and buffers are shared with and recycled by `FftwAllocator`,
+ * such that constructing a plan of an already planned shape neither plans nor allocates (in general).
+ * 
  * On computation side, the class relies on user-triggered evaluation
  * -- instead of early or lazy evaluations --,
  * i.e. the user has to explicitely call `transform()` when relevant.
@@ -55,6 +59,9 @@ namespace Linx {
  * by calling `transform()` and then `inverse().transform()` -- `normalize()` performs normalization on request.
  * The factor equals the logical number of elements.
  * 
+ * Plans are parameterized by the precision of the transform, e.g. `DftPlan<Internal::RealDftTransform<float>, N>`,
+ * which is one of `double`, `float` and `long double`, backed by `fftw_`, `fftwf_` and `fftwl_` plans, respectively.
+ * 
  * @tspecialization{ComplexDft}
  * @tspecialization{RealDft}
  * 
@@ -87,6 +94,11 @@ public:
    */
   using Inverse = DftPlan<InverseTransform, N>;
 
+  /**
+   * @brief The floating point precision.
+   */
+  using Precision = typename Transform::Precision;
+
   /**
    * @brief The input value type.
    */
@@ -102,10 +114,13 @@ public:
    * @param shape The logical shape
    * @param in_data The pre-existing input buffer, or `nullptr` to allocate a new one
    * @param out_data The pre-existing output buffer, or `nullptr` to allocate a new one
+   * 
+   * For in-place transforms, the output buffer defaults to the input buffer.
    */
   DftPlan(Position<N> shape, InValue* in_data = nullptr, OutValue* out_data = nullptr) :
-      m_shape {shape}, m_in {Transform::in_shape(m_shape), in_data}, m_out {Transform::out_shape(m_shape), out_data},
-      m_plan {FftwAllocator::create_plan<Transform>(m_in, m_out)}
+      m_shape {shape}, m_in {buffer(Transform::in_shape(m_shape), in_data)},
+      m_out {buffer(Transform::out_shape(m_shape), out_data ? out_data : in_place_data())},
+      m_plan {FftwAllocator::cached_plan<Transform>(m_in, m_out, m_shape)}
   {}
 
   LINX_DEFAULT_COPYABLE(DftPlan)
@@ -114,12 +129,13 @@ public:
   /**
    * @brief Destructor.
    * @warning
-   * Buffers are freed if they were allocated by the plan constructor.
+   * Buffers are given back to the pool of `FftwAllocator` if they were allocated by the plan constructor.
    * If data has to outlive the `DftPlan` object, buffers should be copied beforehand.
    */
   ~DftPlan()
   {
-    FftwAllocator::destroy_plan(m_plan);
+    FftwAllocator::recycle(LINX_MOVE(m_in));
+    FftwAllocator::recycle(LINX_MOVE(m_out));
   }
 
   /**
@@ -220,7 +236,7 @@ public:
    */
   double normalization_factor() const
   {
-    return shape_size(m_shape);
+    return Transform::normalization_factor(m_shape);
   }
 
   /**
@@ -228,7 +244,57 @@ public:
    */
   DftPlan& transform()
   {
-    fftw_execute(*m_plan);
+    LINX_TRACE_SCOPE("DftPlan::transform", "Transforms");
+    Transform::execute(m_plan, m_in, m_out);
+    return *this;
+  }
+
+  /**
+   * @brief Compute the transform of external buffers, with the plan of this `DftPlan`.
+   *
+   * This is FFTW's "plan once, execute anywhere" scheme:
+   * the plan is executed with the new-array execute functions (e.g. `fftw_execute_dft()`),
+   * which are thread-safe, such that one plan can be shared by concurrent workers,
+   * as long as each of them owns its buffers:
+   *
+   * \code
+   * RealDft dft(tile_shape);
+   * #pragma omp parallel
+   * {
+   *   auto in = FftwAllocator::acquire<double>(dft.in_shape());
+   *   auto out = FftwAllocator::acquire<std::complex<double>>(dft.out_shape());
+   *   #pragma omp for
+   *   for (Index i = 0; i < tile_count; ++i) {
+   *     in = ... ; // Assign tile i somehow
+   *     dft.transform(in, out);
+   *     ... // Use out
+   *   }
+   * }
+   * \endcode
+   *
+   * The buffers must have the shapes of the plan buffers, the same FFTW alignments (see `fftw_alignment_of()`),
+   * and be distinct if and only if the plan buffers are distinct.
+   * Buffers allocated by `FftwAllocator::acquire()` or `AlignedRaster` satisfy the alignment requirement.
+   * Neither the plan buffers nor the plan state are modified.
+   *
+   * As with `transform()`, `in` contains garbage after the call.
+   */
+  const DftPlan& transform(AlignedRaster<InValue, N>& in, AlignedRaster<OutValue, N>& out) const
+  {
+    if (in.shape() != in_shape() || out.shape() != out_shape()) {
+      throw Exception("DFT error", "Buffer shapes differ from plan shapes.");
+    }
+    if (Internal::fftw_alignment<Precision>(in.data()) != Internal::fftw_alignment<Precision>(m_in.data()) ||
+        Internal::fftw_alignment<Precision>(out.data()) != Internal::fftw_alignment<Precision>(m_out.data())) {
+      throw Exception("DFT error", "Buffer alignments differ from plan alignments.");
+    }
+    const bool in_place = static_cast<void*>(in.data()) == static_cast<void*>(out.data());
+    const bool plan_in_place = static_cast<const void*>(m_in.data()) == static_cast<const void*>(m_out.data());
+    if (in_place != plan_in_place) {
+      throw Exception("DFT error", "Buffers must be in place if and only if plan buffers are.");
+    }
+    LINX_TRACE_SCOPE("DftPlan::transform", "Transforms");
+    Transform::execute(m_plan, in, out);
     return *this;
   }
 
@@ -237,13 +303,37 @@ public:
    */
   DftPlan& normalize()
   {
-    const auto factor = 1. / normalization_factor();
+    const auto factor = static_cast<Precision>(1. / normalization_factor());
     m_out *= factor;
     return *this;
   }
 
 private:
 
+  /**
+   * @brief Get the input buffer data as output values if the transform is in place, or `nullptr` otherwise.
+   */
+  OutValue* in_place_data()
+  {
+    if constexpr (Transform::InPlace) {
+      return reinterpret_cast<OutValue*>(m_in.data());
+    } else {
+      return nullptr;
+    }
+  }
+
+  /**
+   * @brief Get a recycled buffer, or a view of a pre-existing one.
+   */
+  template <typename T>
+  static AlignedRaster<T, N> buffer(const Position<N>& shape, T* data)
+  {
+    if (data) {
+      return AlignedRaster<T, N>(shape, data);
+    }
+    return FftwAllocator::acquire<T, N>(shape);
+  }
+
   /**
    * @brief The logical shape.
    */
@@ -260,9 +350,9 @@ private:
   AlignedRaster<OutValue, N> m_out;
 
   /**
-   * @brief The transform plan.
+   * @brief The transform plan, owned by the registry of `FftwAllocator`.
    */
-  Internal::FftwPlanPtr m_plan;
+  typename Internal::Fftw<Precision>::Plan m_plan;
 };
 
 } // namespace Linx
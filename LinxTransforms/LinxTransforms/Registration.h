@@ -0,0 +1,267 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_REGISTRATION_H
+#define _LINXTRANSFORMS_REGISTRATION_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Parallel.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/SplitRaster.h" // complex_multiply
+#include "Linx/Data/Vector.h"
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm> // max, max_element, min
+#include <cmath> // abs, ceil
+#include <complex>
+#include <iterator> // distance
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the signed frequency of a DFT index.
+ */
+inline double signed_frequency(Index k, Index length)
+{
+  return k <= length / 2 ? double(k) : double(k - length);
+}
+
+/**
+ * @brief Contract an axis of a complex raster with a matrix, i.e. apply a matrix DFT along this axis.
+ * @param in The input raster
+ * @param axis The contracted axis
+ * @param matrix The row-major matrix, of shape `rows` x `in.shape()[axis]`
+ * @param rows The output length along `axis`
+ */
+template <typename TIn, Index N>
+Raster<std::complex<double>, N>
+contract_axis(const TIn& in, Index axis, const std::vector<std::complex<double>>& matrix, Index rows)
+{
+  const auto& in_shape = in.shape();
+  const auto length = in_shape[axis];
+  Index stride = 1;
+  for (Index i = 0; i < axis; ++i) {
+    stride *= in_shape[i];
+  }
+  auto shape = in_shape;
+  shape[axis] = rows;
+  Raster<std::complex<double>, N> out(shape);
+  for (const auto& p : out.domain()) {
+    auto q = p;
+    q[axis] = 0;
+    const auto* it = &in[q];
+    const auto* row = matrix.data() + p[axis] * length;
+    std::complex<double> sum {};
+    for (Index k = 0; k < length; ++k) {
+      sum += row[k] * std::complex<double>(it[k * stride]);
+    }
+    out[p] = sum;
+  }
+  return out;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup resampling
+ * @brief Phase-correlation registration engine, which estimates the translations of frames with respect to a reference.
+ * @tparam N The dimension
+ * @tparam T The precision of the transforms
+ *
+ * The shift `s` of a frame is such that `frame(x) = reference(x - s)`, with periodic boundary conditions.
+ * It is estimated as the position of the maximum of the inverse DFT of the normalized cross-power spectrum,
+ * and refined to sub-pixel precision by evaluating the correlation on a grid of step `1 / upsampling`
+ * in a neighborhood of 1.5 pixel around the integer peak,
+ * with matrix DFTs of the half spectrum (Guizar-Sicairos et al., 2008) instead of a zero-padded inverse DFT.
+ * Spectrum values are normalized to unit magnitude, except those below the rounding errors,
+ * which are not amplified.
+ *
+ * The reference spectrum and the plans are computed once, at construction,
+ * and the transform buffers are taken from and given back to the pool of `FftwAllocator`,
+ * such that repeated registrations do not allocate nor plan anything.
+ * Frames of a sequence are registered concurrently from the same plans, each thread owning a pair of buffers.
+ *
+ * \code
+ * PhaseCorrelation<2> registration(frames[0]);
+ * const auto shifts = registration(par, frames);
+ * \endcode
+ */
+template <Index N = 2, typename T = double>
+class PhaseCorrelation {
+public:
+
+  /**
+   * @brief Constructor.
+   * @param reference The reference frame, whose shape is that of all the frames
+   * @param upsampling The inverse of the sub-pixel precision, or 1 to skip sub-pixel refinement
+   */
+  template <typename TRaster>
+  explicit PhaseCorrelation(const TRaster& reference, Index upsampling = 100) :
+      m_dft(reference.shape()), m_idft(m_dft.inverse()), m_reference(m_dft.out_shape()), m_upsampling(upsampling)
+  {
+    OutOfBoundsError::may_throw("Upsampling factor", upsampling, {1, std::numeric_limits<Index>::max()});
+    auto it = m_dft.in().begin();
+    for (const auto& e : reference) {
+      *it = static_cast<T>(e);
+      ++it;
+    }
+    m_dft.transform();
+    auto ref_it = m_reference.begin();
+    for (const auto& e : m_dft.out()) {
+      *ref_it = std::conj(e);
+      ++ref_it;
+    }
+  }
+
+  LINX_NON_COPYABLE(PhaseCorrelation)
+
+  /**
+   * @brief Get the frame shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_dft.logical_shape();
+  }
+
+  /**
+   * @brief Get the upsampling factor.
+   */
+  Index upsampling() const
+  {
+    return m_upsampling;
+  }
+
+  /**
+   * @brief Estimate the shift of a frame.
+   */
+  template <typename TRaster>
+  Vector<double, N> operator()(const TRaster& frame) const
+  {
+    auto signal = FftwAllocator::acquire<T>(m_dft.in_shape());
+    auto spectrum = FftwAllocator::acquire<std::complex<T>>(m_dft.out_shape());
+    auto out = estimate(frame, signal, spectrum);
+    FftwAllocator::recycle(LINX_MOVE(signal));
+    FftwAllocator::recycle(LINX_MOVE(spectrum));
+    return out;
+  }
+
+  /**
+   * @brief Estimate the shifts of a sequence of frames, concurrently.
+   */
+  template <typename TRaster>
+  std::vector<Vector<double, N>> operator()(const ParallelPolicy& policy, const std::vector<TRaster>& frames) const
+  {
+    const auto size = static_cast<Index>(frames.size());
+    std::vector<Vector<double, N>> out(size);
+    if (size == 0) {
+      return out;
+    }
+#pragma omp parallel num_threads(static_cast<int>(std::min(policy.thread_count(), size)))
+    {
+      auto signal = FftwAllocator::acquire<T>(m_dft.in_shape());
+      auto spectrum = FftwAllocator::acquire<std::complex<T>>(m_dft.out_shape());
+#pragma omp for schedule(dynamic)
+      for (Index k = 0; k < size; ++k) {
+        out[k] = estimate(frames[k], signal, spectrum);
+      }
+      FftwAllocator::recycle(LINX_MOVE(signal));
+      FftwAllocator::recycle(LINX_MOVE(spectrum));
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Estimate the shift of a frame with given buffers.
+   */
+  template <typename TRaster>
+  Vector<double, N>
+  estimate(const TRaster& frame, AlignedRaster<T, N>& signal, AlignedRaster<std::complex<T>, N>& spectrum) const
+  {
+    const auto& logical_shape = shape();
+    if (frame.shape() != logical_shape) {
+      throw Exception("Frame and reference shapes differ");
+    }
+
+    // Normalized cross-power spectrum
+    auto it = signal.begin();
+    for (const auto& e : frame) {
+      *it = static_cast<T>(e);
+      ++it;
+    }
+    m_dft.transform(signal, spectrum);
+    Internal::complex_multiply(spectrum.data(), m_reference.data(), m_reference.size());
+    T floor = 0;
+    for (const auto& e : spectrum) {
+      floor = std::max(floor, std::abs(e));
+    }
+    floor *= 100 * std::numeric_limits<T>::epsilon(); // Magnitude of the rounding errors
+    for (auto& e : spectrum) {
+      e /= std::max(std::abs(e), floor);
+    }
+    const auto cross_power = m_upsampling > 1 ? Raster<std::complex<T>, N>(spectrum.shape(), spectrum) :
+                                                Raster<std::complex<T>, N>();
+
+    // Integer peak
+    m_idft.transform(spectrum, signal);
+    auto index = std::distance(signal.begin(), std::max_element(signal.begin(), signal.end()));
+    Vector<double, N> out;
+    for (Index i = 0; i < N; ++i) {
+      const auto length = logical_shape[i];
+      const auto p = index % length;
+      index /= length;
+      out[i] = p > length / 2 ? p - length : p;
+    }
+    if (m_upsampling == 1) {
+      return out;
+    }
+
+    // Sub-pixel peak
+    const auto rows = static_cast<Index>(std::ceil(1.5 * m_upsampling));
+    const auto half = rows / 2;
+    constexpr double pi = 3.14159265358979323846;
+    Raster<std::complex<double>, N> correlation;
+    for (Index i = 0; i < N; ++i) {
+      const auto length = logical_shape[i];
+      const auto width = cross_power.shape()[i];
+      std::vector<std::complex<double>> matrix(rows * width);
+      for (Index m = 0; m < rows; ++m) {
+        const auto x = out[i] + double(m - half) / m_upsampling;
+        for (Index k = 0; k < width; ++k) {
+          const auto phase = 2 * pi * Internal::signed_frequency(k, length) * x / length;
+          // Half spectrum along axis 0: other frequencies are given by conjugate symmetry
+          const auto weight = i > 0 || k == 0 || 2 * k == length ? 1. : 2.;
+          matrix[m * width + k] = std::polar(weight, phase);
+        }
+      }
+      correlation = i == 0 ? Internal::contract_axis<Raster<std::complex<T>, N>, N>(cross_power, i, matrix, rows) :
+                             Internal::contract_axis<Raster<std::complex<double>, N>, N>(correlation, i, matrix, rows);
+    }
+    const auto peak = std::max_element(correlation.begin(), correlation.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.real() < rhs.real();
+    });
+    index = std::distance(correlation.begin(), peak);
+    for (Index i = 0; i < N; ++i) {
+      out[i] += double(index % rows - half) / m_upsampling;
+      index /= rows;
+    }
+    return out;
+  }
+
+  RealDft<N, T> m_dft; ///< The forward plan
+  typename RealDft<N, T>::Inverse m_idft; ///< The inverse plan
+  Raster<std::complex<T>, N> m_reference; ///< The conjugate reference spectrum
+  Index m_upsampling; ///< The upsampling factor
+};
+
+} // namespace Linx
+
+#endif
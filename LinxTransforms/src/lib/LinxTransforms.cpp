@@ -3,3 +3,13 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "LinxTransforms/Dft.h"
+
+namespace Linx {
+
+#define LINX_INSTANTIATE_DFTS(T, N) \
+  template class DftPlan<Internal::RealDftTransform<T>, N>; \
+  template class DftPlan<Internal::ComplexDftTransform<T>, N>;
+LINX_PRECOMPILED_KERNELS(LINX_INSTANTIATE_DFTS)
+#undef LINX_INSTANTIATE_DFTS
+
+} // namespace Linx
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -162,13 +163,14 @@ BOOST_AUTO_TEST_CASE(raster_upsampling_sesquiple_test)
 BOOST_AUTO_TEST_CASE(raster_upsampling_double_test)
 {
   const auto in = Raster<float>({3, 2}).range();
-  const auto out = upsample<Nearest>(in, 2); // FIXME out of bounds somehow
+  const auto out = upsample<Nearest>(in, 2);
   BOOST_TEST(out.shape() == in.shape() * 2);
   for (const auto& p : out.domain()) {
     Vector<double> q(p);
     q += 1;
     q /= 2;
     Position<2> r(q);
+    r = clamp(r, in.shape()); // Rasters are read as if extrapolated with Nearest
     BOOST_TEST(out[p] == in[r]);
   }
 }
@@ -183,6 +185,7 @@ BOOST_AUTO_TEST_CASE(raster_upsampling_triple_test)
     q += 1.5;
     q /= 3;
     Position<2> r(q);
+    r = clamp(r, in.shape()); // Rasters are read as if extrapolated with Nearest
     BOOST_TEST(out[p] == in[r]);
   }
 }
@@ -198,6 +201,7 @@ BOOST_AUTO_TEST_CASE(raster_upsampling_partial_test)
     q /= 3;
     Position<3> r(q);
     r[2] = p[2];
+    r = clamp(r, in.shape()); // Rasters are read as if extrapolated with Nearest
     BOOST_TEST(out[p] == in[r]);
   }
 }
@@ -212,10 +216,219 @@ BOOST_AUTO_TEST_CASE(raster_upsampling_full_test)
     q += 1.5;
     q /= 3;
     Position<3> r(q);
+    r = clamp(r, in.shape()); // Rasters are read as if extrapolated with Nearest
     BOOST_TEST(out[p] == in[r]);
   }
 }
 
+BOOST_AUTO_TEST_CASE(row_wise_transform_equals_pointwise_test)
+{
+  const auto in = Raster<double, 3>({7, 6, 5}).range();
+  const auto extrapolator = extrapolation(in, 0.);
+  const auto interpolator = interpolation<Linear>(extrapolator);
+  auto affinity = Affinity<3>::rotation_deg(17, 0, 1, {3, 2.5, 2});
+  affinity.rotate_deg(-5, 2, 0);
+  affinity *= Vector<double, 3> {1.1, 0.9, 1};
+  affinity += Vector<double, 3> {0.3, -0.2, 0.1};
+  Raster<double, 3> out(in.shape());
+  affinity.transform(interpolator, out);
+  const auto inv = inverse(affinity);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == interpolator(inv(p)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_warp_equals_sequential_test)
+{
+  const auto in = Raster<double>({37, 29}).range();
+  const auto extrapolator = extrapolation(in, 0.);
+  const auto sequential = rotate_deg<Cubic>(extrapolator, 25);
+  const auto parallel = rotate_deg<Cubic>(extrapolator, 25, 0, 1, 4);
+  BOOST_TEST(parallel.container() == sequential.container());
+  const auto translated = translate<Linear>(extrapolator, {0.5, 0.5}, 3);
+  BOOST_TEST(translated.container() == translate<Linear>(extrapolator, {0.5, 0.5}).container());
+
+  Raster<double> out(in.shape());
+  auto patch = out(Box<2>({3, 2}, {20, 25}));
+  auto affinity = Affinity<2>::scaling(1.2, center(in));
+  affinity.parallelize(5).transform(interpolation<Linear>(in), patch);
+  Raster<double> expected(in.shape());
+  auto expected_patch = expected(Box<2>({3, 2}, {20, 25}));
+  affinity.parallelize(1).transform(interpolation<Linear>(in), expected_patch);
+  BOOST_TEST(out.container() == expected.container());
+}
+
+BOOST_AUTO_TEST_CASE(integral_translation_copies_rows_test)
+{
+  const auto in = Raster<double, 3>({7, 6, 5}).range();
+  const auto extrapolator = extrapolation(in, -1.);
+  const Vector<double, 3> vector {2, -3, 1};
+  const auto out = translate<Linear>(extrapolator, vector);
+  const auto expected = Affinity<3>::translation(vector).warp<Linear>(extrapolator);
+  BOOST_TEST(out.container() == expected.container());
+  const auto periodic = extrapolation<Periodic>(in);
+  const auto wrapped = translate<Cubic>(periodic, {-8, 4, 0});
+  for (const auto& p : wrapped.domain()) {
+    BOOST_TEST(wrapped[p] == (periodic[p + Position<3> {8, -4, 0}]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(separable_scaling_equals_warp_test)
+{
+  const auto in = Raster<float>({23, 17}).range();
+  const auto extrapolator = extrapolation(in, 0.F);
+  const auto out = scale<Cubic>(extrapolator, 1.7, 3);
+  const auto expected = Affinity<2>::scaling(1.7, center(in)).warp<Cubic>(extrapolator);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1.e-3F));
+  }
+  const auto down = scale<Linear>(extrapolator, 0.6);
+  const auto down_expected = Affinity<2>::scaling(0.6, center(in)).warp<Linear>(extrapolator);
+  for (const auto& p : down.domain()) {
+    BOOST_TEST(down[p] == down_expected[p], boost::test_tools::tolerance(1.e-3F));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(separable_upsampling_equals_transform_test)
+{
+  const auto in = Raster<double, 3>({5, 4, 3}).range();
+  const auto out = upsample<Linear>(in, 2.5);
+  Raster<double, 3> expected(out.shape());
+  Affinity<3>::scaling({2.5, 2.5, 1}).transform(interpolation<Linear>(extrapolation<Nearest>(in)), expected);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(interior_split_equals_extrapolated_test)
+{
+  const auto in = Raster<double>({41, 33}).range();
+  const auto extrapolator = extrapolation<Periodic>(in);
+  auto affinity = Affinity<2>::rotation_deg(-37, 0, 1, center(in));
+  affinity *= 1.3;
+  for (Index t : {1, 3}) {
+    affinity.parallelize(t);
+    const auto cubic = interpolation<Cubic>(extrapolator);
+    Raster<double> out(in.shape());
+    affinity.transform(cubic, out);
+    const auto inv = inverse(affinity);
+    for (const auto& p : out.domain()) {
+      BOOST_TEST(out[p] == cubic(inv(p)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(prefiltered_scaling_equals_warp_test)
+{
+  Raster<double> in({21, 18});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(0.3 * p[0]) * std::cos(0.2 * p[1]);
+  }
+  const auto out = scale<BSpline<3>>(in, 1.4);
+  const auto interpolator = interpolation<BSpline<3>>(in); // Prefiltered once for both warps
+  const auto affinity = Affinity<2>::scaling(1.4, center(in));
+  Raster<double> expected(in.shape());
+  affinity.transform(interpolator, expected);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1.e-9));
+  }
+  const auto lanczos = rotate_deg<Lanczos<3>>(extrapolation(in, 0.), 15);
+  BOOST_TEST(lanczos.shape() == in.shape());
+}
+
+BOOST_AUTO_TEST_CASE(shear_rotation_equals_warp_test)
+{
+  Raster<double, 3> in({31, 27, 2});
+  for (const auto& p : in.domain()) {
+    in[p] = 2. * p[0] - 3. * p[1] + p[2] + 1;
+  }
+  for (double angle : {0., 20., -35., 120., -170., 180.}) {
+    const auto out = shear_rotate_deg<Cubic>(extrapolation<Nearest>(in), angle, 0, 1, 3);
+    const auto sequential = shear_rotate_deg<Cubic>(extrapolation<Nearest>(in), angle);
+    const auto inv = inverse(Affinity<3>::rotation_deg(angle, 0, 1, center(in)));
+    for (const auto& p : out.domain()) {
+      BOOST_TEST(out[p] == sequential[p]);
+      const auto q = inv(p);
+      if (q[0] >= 4 && q[0] <= 26 && q[1] >= 4 && q[1] <= 22) { // Far enough from the borders
+        BOOST_TEST(out[p] == 2. * q[0] - 3. * q[1] + q[2] + 1, boost::test_tools::tolerance(1.e-9));
+      }
+    }
+  }
+  const auto flipped = shear_rotate_deg<Linear>(in, 180);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(flipped[p] == (in[{30 - p[0], 26 - p[1], p[2]}]));
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(warps_to_preallocated_output_test)
+{
+  Raster<double, 2> in({31, 27});
+  for (const auto& p : in.domain()) {
+    in[p] = 2. * p[0] - 3. * p[1] + 1;
+  }
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto vector = Vector<double, 2> {1.5, -2.25};
+  Raster<double, 2> out(in.shape());
+  for (Index i = 0; i < 2; ++i) {
+    const auto cached = MemoryPool::cached();
+    BOOST_TEST(translate_to<Cubic>(extrapolated, vector, out) == translate<Cubic>(extrapolated, vector));
+    BOOST_TEST(scale_to<Linear>(extrapolated, 1.3, out) == scale<Linear>(extrapolated, 1.3));
+    BOOST_TEST(rotate_deg_to<Linear>(extrapolated, 20, out) == rotate_deg<Linear>(extrapolated, 20));
+    BOOST_TEST(shear_rotate_deg_to<Cubic>(extrapolated, 20, out) == shear_rotate_deg<Cubic>(extrapolated, 20));
+    if (i > 0) {
+      BOOST_TEST(MemoryPool::cached() == cached); // Intermediate rasters are recycled
+    }
+  }
+  Raster<double, 2> wrong({27, 31});
+  BOOST_CHECK_THROW((scale_to<Linear>(extrapolated, 2, wrong)), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(multi_plane_warp_equals_per_plane_warp_test)
+{
+  Raster<double, 3> in({29, 23, 3});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(.3 * p[0] + p[2]) * std::cos(.2 * p[1]);
+  }
+  Raster<char> mask({29, 23});
+  for (const auto& p : mask.domain()) {
+    mask[p] = (p[0] + p[1]) % 3 == 0;
+  }
+  auto affinity = Affinity<2>::rotation_deg(25, 0, 1, center(mask));
+  affinity *= 1.2;
+  affinity += Vector<double, 2> {1.5, -.75};
+
+  for (Index threads : {1, 3}) {
+    affinity.parallelize(threads);
+    const auto out = affinity.warp_channels<Cubic>(in);
+    for (Index c = 0; c < 3; ++c) {
+      const auto plane = in.section(c);
+      const auto expected = affinity.warp<Cubic>(extrapolation<Nearest>(plane));
+      for (const auto& p : expected.domain()) {
+        const Position<3> q {p[0], p[1], c};
+        BOOST_TEST(out[q] == expected[p], boost::test_tools::tolerance(1.e-12));
+      }
+    }
+
+    std::vector<PtrRaster<const char>> masks {PtrRaster<const char>(mask.shape(), mask.data())};
+    Raster<char> warped_mask(mask.shape());
+    std::vector<PtrRaster<char>> mask_out {PtrRaster<char>(mask.shape(), warped_mask.data())};
+    std::vector<PtrRaster<const double>> data;
+    std::vector<Raster<double>> data_out;
+    for (Index c = 0; c < 3; ++c) {
+      data.emplace_back(mask.shape(), in.data() + c * mask.size());
+      data_out.emplace_back(mask.shape());
+    }
+    affinity.warp_planes<Cubic, Nearest>(data, data_out, masks, mask_out, Constant<double>(0));
+    const auto expected_mask = affinity.warp<Nearest>(extrapolation(mask, char(0)));
+    BOOST_TEST(warped_mask == expected_mask);
+    const auto expected = affinity.warp<Cubic>(extrapolation<Constant<double>>(data[1], 0.));
+    for (const auto& p : expected.domain()) {
+      BOOST_TEST(data_out[1][p] == expected[p], boost::test_tools::tolerance(1.e-12));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
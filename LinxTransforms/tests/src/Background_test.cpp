@@ -0,0 +1,96 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Background.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Background_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(mesh_shape_test)
+{
+  const BackgroundEstimator<float> estimator({8, 4});
+  BOOST_TEST(estimator.mesh_shape({32, 16}) == (Position<2> {4, 4}));
+  BOOST_TEST(estimator.mesh_shape({33, 17}) == (Position<2> {5, 5}));
+  BOOST_CHECK_THROW(BackgroundEstimator<float>({8, 0}), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(outliers_are_clipped_test)
+{
+  Raster<float> image({64, 48});
+  image.fill(10);
+  for (const auto& p : image.domain()) {
+    if ((p[0] * 7 + p[1] * 3) % 23 == 0) {
+      image[p] = 1000; // Stars
+    }
+  }
+  for (const auto& p : Box<2>({16, 16}, {31, 31})) {
+    image[p] = 500; // Extended object which covers a whole tile
+  }
+  const BackgroundEstimator<float> estimator({16, 16});
+  const auto mesh = estimator.mesh(ParallelPolicy(3), image);
+  BOOST_TEST(mesh.shape() == (Position<2> {4, 3}));
+  for (const auto& e : mesh) {
+    BOOST_TEST(e == 10);
+  }
+  const auto background = estimator(ParallelPolicy(3), image);
+  BOOST_TEST(background.shape() == image.shape());
+  for (const auto& e : background) {
+    BOOST_TEST(std::abs(e - 10) < 1e-4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gradient_is_interpolated_test)
+{
+  const Position<2> shape {64, 64};
+  Raster<double> image(shape);
+  for (const auto& p : image.domain()) {
+    image[p] = 100 + 0.5 * p[0] - 0.25 * p[1];
+  }
+  const BackgroundEstimator<double> estimator({8, 8}, BackgroundStatistic::Median, 3, 5, 0);
+  const auto mesh = estimator.mesh(image);
+  BOOST_TEST((mesh[{0, 0}]) == 100 + 0.5 * 3.5 - 0.25 * 3.5);
+  BOOST_TEST((mesh[{2, 5}]) == 100 + 0.5 * 19.5 - 0.25 * 43.5);
+  const auto background = estimator.upsample<Cubic>(mesh, shape);
+  for (const auto& p : Box<2>({12, 12}, {51, 51})) { // Beyond, the extrapolated mesh is constant
+    BOOST_TEST(std::abs(background[p] - image[p]) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(nan_tiles_are_filled_test)
+{
+  Raster<float> image({32, 32});
+  image.fill(5);
+  for (const auto& p : Box<2>({0, 0}, {15, 15})) {
+    image[p] = std::numeric_limits<float>::quiet_NaN();
+  }
+  image[{16, 0}] = std::numeric_limits<float>::quiet_NaN();
+  const BackgroundEstimator<float> estimator({16, 16}, BackgroundStatistic::Mode, 3, 5, 0);
+  const auto mesh = estimator.mesh(image);
+  for (const auto& e : mesh) {
+    BOOST_TEST(e == 5);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_matches_sequential_test)
+{
+  Raster<float> image({100, 70});
+  for (const auto& p : image.domain()) {
+    image[p] = 20 + 0.1 * p[0] + std::sin(0.7 * p[0] * p[1]);
+  }
+  const BackgroundEstimator<float> estimator({16, 16});
+  BOOST_TEST(estimator(ParallelPolicy(4), image) == estimator(image));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Binning.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Binning_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(row_remainder_test)
+{
+  const auto in = Raster<int, 1>({5}).range();
+  const auto sum = bin<int>(in, 2, Binning::Sum);
+  BOOST_TEST(sum.shape() == Position<1>({3}));
+  BOOST_TEST(sum[0] == 1);
+  BOOST_TEST(sum[1] == 5);
+  BOOST_TEST(sum[2] == 4);
+  const auto mean = bin<float>(in, 2, Binning::Mean);
+  BOOST_TEST(mean[0] == .5);
+  BOOST_TEST(mean[1] == 2.5);
+  BOOST_TEST(mean[2] == 4);
+}
+
+BOOST_AUTO_TEST_CASE(bin_equals_direct_test)
+{
+  auto in = Raster<std::uint16_t, 3>({17, 10, 7}).range();
+  for (Index factor : {1, 2, 3, 4}) {
+    for (Index threads : {1, 3}) {
+      const Position<3> factors {factor, 2, 3};
+      const auto sum = bin<std::int64_t>(par(threads), in, factors, Binning::Sum);
+      const auto mean = bin<double>(par(threads), in, factors, Binning::Mean);
+      BOOST_TEST(sum.shape() == Position<3>({(17 + factor - 1) / factor, 5, 3}));
+      for (const auto& q : sum.domain()) {
+        auto front = q;
+        for (Index i = 0; i < 3; ++i) {
+          front[i] *= factors[i];
+        }
+        const auto block = Box<3>(front, front + factors - 1) & in.domain();
+        const auto patch = in(block);
+        std::int64_t expected = 0;
+        for (const auto& e : patch) {
+          expected += e;
+        }
+        BOOST_TEST(sum[q] == expected);
+        BOOST_TEST(mean[q] == double(expected) / block.size(), boost::test_tools::tolerance(1.e-12));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(integer_rounding_and_saturation_test)
+{
+  const auto in = Raster<unsigned char>({4, 2}, {200, 200, 1, 2, 200, 200, 2, 2}); // Block sums 800 and 7
+  const auto sum = bin<unsigned char>(in, 2, Binning::Sum);
+  BOOST_TEST(sum[0] == 255);
+  BOOST_TEST(sum[1] == 7);
+  const auto mean = bin<unsigned char>(in, 2, Binning::Mean);
+  BOOST_TEST(mean[0] == 200);
+  BOOST_TEST(mean[1] == 2); // 1.75 rounded
+}
+
+BOOST_AUTO_TEST_CASE(invalid_factor_test)
+{
+  const auto in = Raster<float>({4, 4});
+  BOOST_CHECK_THROW(bin<float>(in, 0), OutOfBoundsError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/BitMorphology.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BitMorphology_test)
+
+//-----------------------------------------------------------------------------
+
+Raster<char, 3> make_raster()
+{
+  Raster<char, 3> out({150, 7, 4});
+  out.generate([i = 0]() mutable {
+    ++i;
+    return (i % 5) != 0 && (i % 7) != 0;
+  });
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(erode_dilate_equals_filters_test)
+{
+  const auto in = make_raster();
+  const BitRaster<3> bits(in);
+  const auto window = Box<3>({-70, -1, 0}, {3, 2, 1});
+  const auto extrapolated = extrapolation(in, char(0));
+  const auto eroded = erosion<char>(window) * extrapolated;
+  const auto dilated = dilation<char>(window) * extrapolated;
+  BOOST_TEST((erode(bits, window).raster<char>() == eroded));
+  BOOST_TEST((dilate(bits, window).raster<char>() == dilated));
+  const auto filled = extrapolation(in, char(1));
+  BOOST_TEST((erode(bits, window, true).raster<char>() == erosion<char>(window) * filled));
+}
+
+BOOST_AUTO_TEST_CASE(open_close_test)
+{
+  const auto in = make_raster();
+  const BitRaster<3> bits(in);
+  const auto window = Box<3>::from_center(1);
+  const auto opened = open(bits, window);
+  const auto closed = close(bits, window, true);
+  BOOST_TEST((andnot(opened, bits).count() == 0)); // Anti-extensive
+  BOOST_TEST((andnot(bits, closed).count() == 0)); // Extensive
+  BOOST_TEST((open(opened, window) == opened)); // Idempotent
+  BOOST_TEST((close(closed, window, true) == closed));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LinxTransforms/Deconvolution.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Deconvolution_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Make an invertible 3x3 PSF, normalized to unit sum.
+ */
+Raster<double, 2> make_psf()
+{
+  return Raster<double, 2>({3, 3}, {1, 4, 1, 4, 16, 4, 1, 4, 1}) / 36.; // No zero in Fourier domain
+}
+
+/**
+ * @brief Blur an image with periodic boundary conditions.
+ */
+Raster<double, 2> blur(const Raster<double, 2>& in, const Raster<double, 2>& psf)
+{
+  const auto& shape = in.shape();
+  Raster<double, 2> out(shape);
+  for (const auto& p : out.domain()) {
+    double sum = 0;
+    for (const auto& q : psf.domain()) {
+      const Position<2> r {(p[0] - q[0] + 1 + shape[0]) % shape[0], (p[1] - q[1] + 1 + shape[1]) % shape[1]};
+      sum += psf[q] * in[r];
+    }
+    out[p] = sum;
+  }
+  return out;
+}
+
+/**
+ * @brief Make a sparse image of point sources over a flat background.
+ */
+Raster<double, 2> make_image()
+{
+  Raster<double, 2> out({16, 12});
+  out.fill(1);
+  out[{3, 4}] = 50;
+  out[{10, 2}] = 30;
+  out[{12, 9}] = 80;
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(wiener_inverts_blur_test)
+{
+  const auto image = make_image();
+  const auto psf = make_psf();
+  Deconvolution<2> deconvolution(psf, image.shape());
+  const auto out = deconvolution.wiener(blur(image, psf), 1e-12);
+  BOOST_TEST(out.shape() == image.shape());
+  for (const auto& p : image.domain()) {
+    BOOST_TEST(std::abs(out[p] - image[p]) < 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(richardson_lucy_sharpens_test)
+{
+  const auto image = make_image();
+  const auto psf = make_psf();
+  const auto blurred = blur(image, psf);
+  Deconvolution<2> deconvolution(par(2), psf, image.shape());
+  const auto out = deconvolution.richardson_lucy(blurred, 200);
+  BOOST_TEST(deconvolution.iteration_count() == 200);
+  double in_error = 0;
+  double out_error = 0;
+  for (const auto& p : image.domain()) {
+    BOOST_TEST(out[p] >= 0);
+    in_error += std::abs(blurred[p] - image[p]);
+    out_error += std::abs(out[p] - image[p]);
+  }
+  BOOST_TEST(out_error < in_error / 4);
+  const auto reblurred = blur(out, psf);
+  for (const auto& p : image.domain()) {
+    BOOST_TEST(std::abs(reblurred[p] - blurred[p]) < .05 * blurred[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(richardson_lucy_early_stopping_test)
+{
+  const auto image = make_image();
+  const auto psf = make_psf();
+  const auto blurred = blur(image, psf);
+  Deconvolution<2> deconvolution(psf, image.shape());
+  const auto out = deconvolution.richardson_lucy(blurred, 1000, 1e-3);
+  BOOST_TEST(deconvolution.iteration_count() > 1);
+  BOOST_TEST(deconvolution.iteration_count() < 1000);
+  const auto next = deconvolution.richardson_lucy(blurred, deconvolution.iteration_count());
+  BOOST_TEST(next.container() == out.container());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/DeviceFilters.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DeviceFilters_test)
+
+//-----------------------------------------------------------------------------
+
+Raster<float> make_raster()
+{
+  return Raster<float>({17, 11}).generate(UniformNoise<float>(0, 1, 0));
+}
+
+template <typename TA, typename TB>
+void check_equal(const TA& a, const TB& b)
+{
+  BOOST_TEST(a.shape() == b.shape());
+  for (Index i = 0; i < static_cast<Index>(a.size()); ++i) {
+    BOOST_TEST(a[i] == b[i], boost::test_tools::tolerance(1e-4f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(correlation_convolution_test)
+{
+  const auto in = make_raster();
+  const auto kernel = Raster<float>({5, 3}).range(1);
+  Raster<float> out(in.shape());
+  device_correlation(in, kernel, out);
+  check_equal(out, correlation(kernel) * extrapolation<Nearest>(in));
+  device_convolution(in, kernel, out);
+  check_equal(out, convolution(kernel) * extrapolation<Nearest>(in));
+}
+
+BOOST_AUTO_TEST_CASE(separable_correlation_test)
+{
+  const auto in = make_raster();
+  const std::vector<float> horizontal {1, 2, 3};
+  const std::vector<float> vertical {-1, 0, 2, 1, 1};
+  Raster<float> kernel({3, 5});
+  for (const auto& p : kernel.domain()) {
+    kernel[p] = horizontal[p[0]] * vertical[p[1]];
+  }
+  Raster<float> out(in.shape());
+  device_separable_correlation(in, horizontal, vertical, out);
+  check_equal(out, correlation(kernel) * extrapolation<Nearest>(in));
+}
+
+BOOST_AUTO_TEST_CASE(morphology_test)
+{
+  const auto in = make_raster();
+  const Position<2> radius {2, 1};
+  const auto window = Box<2>(-radius, radius);
+  Raster<float> out(in.shape());
+  device_minimum_filter(in, radius, out);
+  check_equal(out, minimum_filter<float>(window) * extrapolation<Nearest>(in));
+  device_maximum_filter(in, radius, out);
+  check_equal(out, maximum_filter<float>(window) * extrapolation<Nearest>(in));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_chain_test)
+{
+  const auto in = make_raster();
+  const auto kernel = Raster<float>({3, 3}).fill(1. / 9.);
+  Raster<float> out(in.shape());
+  {
+    DeviceMapping<const Raster<float>> d_in(in);
+    DeviceMapping<Raster<float>> d_out(out, false);
+    device_correlation(in, kernel, out);
+    device_apply(out, [](auto e) {
+      return e * 2;
+    });
+    d_out.download();
+  }
+  auto expected = correlation(kernel) * extrapolation<Nearest>(in);
+  expected *= 2;
+  check_equal(out, expected);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
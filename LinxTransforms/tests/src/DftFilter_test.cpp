@@ -0,0 +1,107 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LinxTransforms/DftFilter.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DftFilter_test)
+
+//-----------------------------------------------------------------------------
+
+template <typename TFilter, typename TIn>
+void check_dft_equals_direct(const TFilter& filter, const TIn& in)
+{
+  const auto direct = filter.FilterMixin<typename TFilter::Value, Box<TFilter::Dimension>, TFilter>::operator*(in);
+  const auto dft = dft_transform(filter, in);
+  BOOST_TEST(dft.shape() == direct.shape());
+  for (std::size_t i = 0; i < dft.size(); ++i) {
+    BOOST_TEST(dft[i] == direct[i], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(convolution_extrapolation_test)
+{
+  const auto in = Raster<double, 2>({17, 12}).range();
+  const auto values = Raster<double, 2>({5, 4}).range();
+  const auto filter = convolution(values);
+  check_dft_equals_direct(filter, extrapolation(in, 0.));
+  check_dft_equals_direct(filter, extrapolation<Nearest>(in));
+  check_dft_equals_direct(filter, extrapolation<Periodic>(in));
+}
+
+BOOST_AUTO_TEST_CASE(correlation_raster_test)
+{
+  const auto in = Raster<double, 3>({9, 8, 7}).range();
+  const auto values = Raster<double, 3>({3, 4, 2}).range();
+  const auto filter = correlation(values);
+  check_dft_equals_direct(filter, in);
+}
+
+BOOST_AUTO_TEST_CASE(integral_convolution_test)
+{
+  const auto in = Raster<int, 2>({10, 11}).range();
+  const auto filter = convolution(Raster<int, 2>({3, 3}).range());
+  const auto direct = filter.FilterMixin<int, Box<2>, std::decay_t<decltype(filter)>>::operator*(extrapolation(in, 0));
+  const auto dft = dft_transform(filter, extrapolation(in, 0));
+  BOOST_TEST(dft.container() == direct.container());
+}
+
+BOOST_AUTO_TEST_CASE(lower_dimension_window_test)
+{
+  const auto in = Raster<double, 2>({12, 5}).range();
+  const auto filter = convolution_along<double, 0>({1, 2, 3, 4, 5});
+  const auto direct = filter * extrapolation<Nearest>(in);
+  const auto dft = dft_transform(filter, extrapolation<Nearest>(in));
+  BOOST_TEST(dft.shape() == direct.shape());
+  for (std::size_t i = 0; i < dft.size(); ++i) {
+    BOOST_TEST(dft[i] == direct[i], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(automatic_selection_test)
+{
+  const auto in = Raster<double, 2>({32, 32}).range();
+  const auto small = convolution(Raster<double, 2>({3, 3}).range());
+  const auto large = convolution(Raster<double, 2>({15, 15}).range());
+  BOOST_TEST(small.window().size() < dft_filtering_threshold);
+  BOOST_TEST(large.window().size() >= dft_filtering_threshold);
+  const auto extra = extrapolation<Nearest>(in);
+  const auto out = large * extra;
+  const auto expected = dft_transform(large, extra);
+  BOOST_TEST(out.container() == expected.container());
+  check_dft_equals_direct(large, extra);
+  check_dft_equals_direct(small, extra);
+}
+
+template <typename TFilter, typename TIn>
+void check_tiled_equals_whole(const TFilter& filter, const TIn& in, const Position<TFilter::Dimension>& fft_shape)
+{
+  const auto whole = dft_transform(filter, in);
+  const auto tiled = tiled_dft_transform(filter, in, fft_shape);
+  BOOST_TEST(tiled.shape() == whole.shape());
+  for (std::size_t i = 0; i < tiled.size(); ++i) {
+    BOOST_TEST(tiled[i] == whole[i], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(tiled_convolution_test)
+{
+  const auto in = Raster<double, 2>({23, 17}).range();
+  auto filter = convolution(Raster<double, 2>({5, 4}).range());
+  check_tiled_equals_whole(filter, extrapolation(in, 0.), {8, 8}); // Uneven tiles
+  check_tiled_equals_whole(filter, extrapolation<Nearest>(in), {12, 7});
+  check_tiled_equals_whole(filter, in, {9, 6});
+  filter.parallelize(3);
+  check_tiled_equals_whole(filter, extrapolation<Periodic>(in), {8, 8});
+  BOOST_CHECK_THROW(tiled_dft_transform(filter, in, {4, 8}), OutOfBoundsError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,12 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "Linx/Io/Temporary.h"
 #include "LinxTransforms/Dft.h"
 #include "LinxTransforms/DftMemory.h"
 
 #include <boost/test/unit_test.hpp>
+#include <vector>
 
 using namespace Linx;
 
@@ -42,20 +44,167 @@ BOOST_AUTO_TEST_CASE(allocate_plan_test)
   RealDftBuffer<3> rout(shape);
   ComplexDftBuffer<3> cin(shape);
   ComplexDftBuffer<3> cout(shape);
-  auto rc = FftwAllocator::create_plan<Internal::RealDftTransform>(rin, cout);
+  auto rc = FftwAllocator::create_plan<Internal::RealDftTransform<>>(rin, cout);
   BOOST_TEST(rc.get() != nullptr);
   FftwAllocator::destroy_plan(rc);
-  auto irc = FftwAllocator::create_plan<Internal::Inverse<Internal::RealDftTransform>>(cout, rin);
+  auto irc = FftwAllocator::create_plan<Internal::Inverse<Internal::RealDftTransform<>>>(cout, rin);
   BOOST_TEST(irc.get() != nullptr);
   FftwAllocator::destroy_plan(irc);
-  auto cc = FftwAllocator::create_plan<Internal::ComplexDftTransform>(cin, cout);
+  auto cc = FftwAllocator::create_plan<Internal::ComplexDftTransform<>>(cin, cout);
   BOOST_TEST(cc.get() != nullptr);
   FftwAllocator::destroy_plan(cc);
-  auto icc = FftwAllocator::create_plan<Internal::Inverse<Internal::ComplexDftTransform>>(cout, cin);
+  auto icc = FftwAllocator::create_plan<Internal::Inverse<Internal::ComplexDftTransform<>>>(cout, cin);
   BOOST_TEST(icc.get() != nullptr);
   FftwAllocator::destroy_plan(icc);
 }
 
+BOOST_AUTO_TEST_CASE(multithreaded_plan_test)
+{
+  const Position<2> shape {6, 4};
+  RealDft<2> single(shape);
+  FftwAllocator::set_thread_count(4);
+  BOOST_TEST(FftwAllocator::thread_count() == 4);
+  RealDft<2> multi(shape);
+  FftwAllocator::set_thread_count(1);
+  BOOST_TEST(FftwAllocator::thread_count() == 1);
+  FftwAllocator::set_thread_count(-1);
+  BOOST_TEST(FftwAllocator::thread_count() >= 1);
+  FftwAllocator::set_thread_count(1);
+
+  for (const auto& p : single.in().domain()) {
+    single.in()[p] = multi.in()[p] = p[0] * p[1] + 1;
+  }
+  single.transform();
+  multi.transform();
+  for (std::size_t i = 0; i < single.out().size(); ++i) {
+    BOOST_TEST(std::abs(multi.out()[i] - single.out()[i]) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rigor_test)
+{
+  BOOST_TEST((FftwAllocator::rigor() == DftRigor::Measure));
+  BOOST_TEST(FftwAllocator::planning_flags() == FFTW_MEASURE);
+  FftwAllocator::set_rigor(DftRigor::Estimate);
+  BOOST_TEST(FftwAllocator::planning_flags() == FFTW_ESTIMATE);
+  RealDft<2> dft({4, 3});
+  dft.in().fill(1);
+  dft.transform();
+  BOOST_TEST(std::abs(dft.out()[0] - 12.) < 1e-9);
+  FftwAllocator::set_rigor(DftRigor::Measure);
+}
+
+BOOST_AUTO_TEST_CASE(wisdom_round_trip_test)
+{
+  TemporaryPath path("dft.wisdom");
+  TemporaryPath float_path("dftf.wisdom");
+  BOOST_TEST(not FftwAllocator::load_wisdom(path.string()));
+  BOOST_TEST(not FftwAllocator::use_wisdom<float>(float_path.string())); // Missing file is not an error
+  RealDft<2> dft({8, 6});
+  BOOST_TEST(FftwAllocator::save_wisdom(path.string()));
+  FftwAllocator::forget_wisdom();
+  BOOST_TEST(FftwAllocator::load_wisdom(path.string()));
+}
+
+BOOST_AUTO_TEST_CASE(plan_registry_test)
+{
+  const Position<2> shape {7, 5};
+  const auto count = FftwAllocator::plan_count();
+  const double* data = nullptr;
+  {
+    RealDft<2> dft(shape);
+    data = dft.in().data();
+    BOOST_TEST(FftwAllocator::plan_count() == count + 1);
+  }
+  RealDft<2> dft(shape); // Same plan and recycled buffers
+  BOOST_TEST(FftwAllocator::plan_count() == count + 1);
+  BOOST_TEST(dft.in().data() == data);
+  BOOST_TEST(dft.in().owns());
+
+  RealDft<2> other(shape); // Same plan, new buffers
+  BOOST_TEST(FftwAllocator::plan_count() == count + 1);
+  BOOST_TEST(other.in().data() != dft.in().data());
+  for (const auto& p : dft.in().domain()) {
+    dft.in()[p] = p[0] + 1;
+    other.in()[p] = p[1] + 1;
+  }
+  dft.transform();
+  other.transform();
+  BOOST_TEST(std::abs(dft.out()[0] - 5. * 28.) < 1e-9);
+  BOOST_TEST(std::abs(other.out()[0] - 7. * 15.) < 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_budget_test)
+{
+  const auto budget = FftwAllocator::pool_budget();
+  const std::size_t bytes = 8 * 8 * sizeof(double);
+  FftwAllocator::clear_buffers();
+  BOOST_TEST(FftwAllocator::pooled_bytes() == 0);
+  FftwAllocator::recycle(AlignedRaster<double>({8, 8}));
+  BOOST_TEST(FftwAllocator::pooled_bytes() == bytes);
+
+  FftwAllocator::set_pool_budget(bytes + 1);
+  FftwAllocator::recycle(AlignedRaster<double>({8, 8})); // Frees the oldest buffer
+  BOOST_TEST(FftwAllocator::pooled_bytes() == bytes);
+  FftwAllocator::recycle(AlignedRaster<float, 3>({8, 8, 8})); // Larger than the budget
+  BOOST_TEST(FftwAllocator::pooled_bytes() == bytes);
+  const auto buffer = FftwAllocator::acquire<double>(Position<2> {8, 8}); // Recycled
+  BOOST_TEST(FftwAllocator::pooled_bytes() == 0);
+  BOOST_TEST(buffer.owns());
+
+  FftwAllocator::recycle(AlignedRaster<float>({4, 4}));
+  BOOST_TEST(FftwAllocator::pooled_bytes() > 0);
+  FftwAllocator::clear_buffers();
+  BOOST_TEST(FftwAllocator::pooled_bytes() == 0);
+  FftwAllocator::set_pool_budget(budget);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_plan_and_execute_test)
+{
+  const Position<2> shape {8, 6};
+  const Index count = 16;
+  RealDft<2> shared(shape);
+  std::vector<std::complex<double>> expected(count);
+  for (Index i = 0; i < count; ++i) {
+    for (const auto& p : shared.in().domain()) {
+      shared.in()[p] = p[0] + p[1] * i;
+    }
+    shared.transform();
+    expected[i] = shared.out()[1];
+  }
+
+  std::vector<std::complex<double>> planned(count);
+  std::vector<std::complex<double>> executed(count);
+#pragma omp parallel for
+  for (Index i = 0; i < count; ++i) {
+    RealDft<2> dft(shape); // Concurrent planning
+    auto in = FftwAllocator::acquire<double>(shape);
+    auto out = FftwAllocator::acquire<std::complex<double>>(shared.out_shape());
+    for (const auto& p : in.domain()) {
+      dft.in()[p] = in[p] = p[0] + p[1] * i;
+    }
+    dft.transform();
+    shared.transform(in, out); // Concurrent execution
+    planned[i] = dft.out()[1];
+    executed[i] = out[1];
+    FftwAllocator::recycle(LINX_MOVE(in));
+    FftwAllocator::recycle(LINX_MOVE(out));
+  }
+  for (Index i = 0; i < count; ++i) {
+    BOOST_TEST(std::abs(planned[i] - expected[i]) < 1e-9);
+    BOOST_TEST(std::abs(executed[i] - expected[i]) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(execute_mismatching_buffers_test)
+{
+  const Position<2> shape {8, 6};
+  RealDft<2> dft(shape);
+  AlignedRaster<double> in(Position<2> {6, 8});
+  AlignedRaster<std::complex<double>> out(dft.out_shape());
+  BOOST_CHECK_THROW(dft.transform(in, out), Exception);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
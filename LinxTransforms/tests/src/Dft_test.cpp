@@ -89,6 +89,177 @@ BOOST_AUTO_TEST_CASE(dft_r2c_c2c_ic2c_ir2c_test)
   }
 }
 
+template <typename T>
+void check_real_round_trip()
+{
+  RealDft<2, T> dft({5, 6});
+  auto idft = dft.inverse();
+  BOOST_TEST((std::is_same_v<typename decltype(dft)::OutValue, std::complex<T>>));
+  auto& signal = dft.in();
+  for (const auto& p : signal.domain()) {
+    signal[p] = 1 + p[0] + p[1];
+  }
+  dft.transform();
+  BOOST_TEST(std::abs(dft.out()[0] - std::complex<T>(165)) < 1e-3); // Sum of the signal
+  idft.transform().normalize();
+  for (const auto& p : signal.domain()) {
+    BOOST_TEST(std::abs(signal[p] - T(1 + p[0] + p[1])) < 1e-4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(float_round_trip_test)
+{
+  check_real_round_trip<float>();
+}
+
+#ifdef LINX_FFTW_LONG_DOUBLE
+BOOST_AUTO_TEST_CASE(long_double_round_trip_test)
+{
+  check_real_round_trip<long double>();
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(float_complex_dft_test)
+{
+  Raster<std::complex<float>, 1> in({4});
+  in.fill(1);
+  const auto out = complex_dft<float>(in);
+  BOOST_TEST((std::is_same_v<std::decay_t<decltype(out[0])>, std::complex<float>>));
+  BOOST_TEST(std::abs(out[0] - std::complex<float>(4)) < 1e-6);
+  BOOST_TEST(std::abs(out[1]) < 1e-6);
+  const auto back = inverse_complex_dft<float>(out);
+  BOOST_TEST(std::abs(back[2] - std::complex<float>(1)) < 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(real_batch_equals_sections_test)
+{
+  const Position<3> shape {5, 4, 3};
+  RealDftBatch<3, float> batch(shape);
+  auto ibatch = batch.inverse();
+  BOOST_TEST(batch.out_shape() == (Position<3> {3, 4, 3}));
+  BOOST_TEST(batch.normalization_factor() == 20);
+  for (const auto& p : batch.in().domain()) {
+    batch.in()[p] = p[0] + 2 * p[1] + 3 * p[1] * p[2] + 1;
+  }
+  const auto signal = batch.in();
+  batch.transform();
+  for (Index k = 0; k < shape[2]; ++k) {
+    const auto expected = real_dft<float>(signal.section(k));
+    const auto actual = batch.out().section(k);
+    for (const auto& p : expected.domain()) {
+      BOOST_TEST(std::abs(actual[p] - expected[p]) < 1e-3);
+    }
+  }
+  ibatch.transform().normalize();
+  for (const auto& p : signal.domain()) {
+    BOOST_TEST(std::abs(ibatch.out()[p] - signal[p]) < 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(complex_batch_of_rows_test)
+{
+  ComplexDftBatch<2> batch({4, 3});
+  for (const auto& p : batch.in().domain()) {
+    batch.in()[p] = p[1] + 1; // Constant rows
+  }
+  batch.transform();
+  for (const auto& p : batch.out().domain()) {
+    const auto expected = p[0] == 0 ? 4. * (p[1] + 1) : 0.;
+    BOOST_TEST(std::abs(batch.out()[p] - expected) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dct_of_constant_test)
+{
+  Raster<double> in({4, 3});
+  in.fill(2);
+  const auto out = dct(in);
+  BOOST_TEST(out.shape() == in.shape());
+  for (const auto& p : out.domain()) {
+    const auto expected = p == Position<2>::zero() ? 4. * 2. * 12. : 0.;
+    BOOST_TEST(std::abs(out[p] - expected) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dct_round_trip_test)
+{
+  Dct<2> dct({5, 4});
+  auto idct = dct.inverse();
+  BOOST_TEST(dct.normalization_factor() == 10 * 8);
+  BOOST_TEST(idct.normalization_factor() == 10 * 8);
+  for (const auto& p : dct.in().domain()) {
+    dct.in()[p] = p[0] * p[1] + p[0] + 1;
+  }
+  dct.transform();
+  idct.transform().normalize();
+  for (const auto& p : idct.out().domain()) {
+    BOOST_TEST(std::abs(idct.out()[p] - (p[0] * p[1] + p[0] + 1)) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dst_and_dct1_round_trip_test)
+{
+  Dst<1, float> dst({6});
+  RealToRealDft<FFTW_REDFT00, FFTW_REDFT00, 1> dct1({6});
+  BOOST_TEST(dst.normalization_factor() == 12);
+  BOOST_TEST(dct1.normalization_factor() == 10);
+  auto idst = dst.inverse();
+  auto idct1 = dct1.inverse();
+  for (Index i = 0; i < 6; ++i) {
+    dst.in()[i] = dct1.in()[i] = i * i - 3;
+  }
+  dst.transform();
+  dct1.transform();
+  idst.transform().normalize();
+  idct1.transform().normalize();
+  for (Index i = 0; i < 6; ++i) {
+    BOOST_TEST(std::abs(idst.out()[i] - (i * i - 3)) < 1e-4);
+    BOOST_TEST(std::abs(idct1.out()[i] - (i * i - 3)) < 1e-9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(dct_batch_normalization_test)
+{
+  DftPlan<Internal::BatchDftTransform<Internal::RealToRealTransform<FFTW_REDFT10, FFTW_REDFT01>>, 3> batch({4, 3, 2});
+  BOOST_TEST(batch.normalization_factor() == 8 * 6);
+}
+
+template <typename T>
+void check_in_place_matches_out_of_place(const Position<2>& shape)
+{
+  InPlaceRealDft<2, T> dft(shape);
+  auto idft = dft.inverse();
+  BOOST_TEST(dft.in_shape()[0] == 2 * (shape[0] / 2 + 1));
+  BOOST_TEST(static_cast<void*>(dft.in().data()) == static_cast<void*>(dft.out().data()));
+  RealDft<2, T> reference(shape);
+  auto signal = unpadded(dft.in(), shape);
+  BOOST_TEST(signal.domain() == Box<2>::from_shape(Position<2>::zero(), shape));
+  for (const auto& p : signal.domain()) {
+    signal[p] = reference.in()[p] = p[0] * p[1] + p[0] + 1;
+  }
+  dft.transform();
+  reference.transform();
+  BOOST_TEST(dft.out_shape() == reference.out_shape());
+  for (const auto& p : reference.out().domain()) {
+    BOOST_TEST(std::abs(dft.out()[p] - reference.out()[p]) < 1e-3);
+  }
+  idft.transform().normalize();
+  const auto back = unpadded(idft.out(), shape);
+  for (const auto& p : back.domain()) {
+    BOOST_TEST(std::abs(back[p] - T(p[0] * p[1] + p[0] + 1)) < 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(in_place_real_dft_even_test)
+{
+  check_in_place_matches_out_of_place<double>({6, 3});
+}
+
+BOOST_AUTO_TEST_CASE(in_place_real_dft_odd_test)
+{
+  check_in_place_matches_out_of_place<float>({7, 3});
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
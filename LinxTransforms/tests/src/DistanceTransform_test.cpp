@@ -0,0 +1,105 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/DistanceTransform.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Compute the squared distance transform by exhaustive search.
+ */
+template <Index N>
+Raster<double, N> brute_force(const Raster<char, N>& mask)
+{
+  Raster<double, N> out(mask.shape());
+  out.fill(std::numeric_limits<double>::infinity());
+  for (const auto& p : mask.domain()) {
+    for (const auto& q : mask.domain()) {
+      if (mask[q]) {
+        double d2 = 0;
+        for (Index i = 0; i < N; ++i) {
+          d2 += double(p[i] - q[i]) * (p[i] - q[i]);
+        }
+        out[p] = std::min(out[p], d2);
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Generate a sparse pseudo-random mask.
+ */
+template <Index N>
+Raster<char, N> random_mask(const Position<N>& shape, Index modulo)
+{
+  Raster<char, N> mask(shape);
+  std::size_t state = 42;
+  for (auto& e : mask) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    e = (state >> 33) % modulo == 0;
+  }
+  return mask;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DistanceTransform_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(single_pixel_test)
+{
+  Raster<char> mask({5, 4});
+  mask[{1, 2}] = true;
+  const auto out = distance_transform(mask);
+  BOOST_TEST(out[Position<2>({1, 2})] == 0);
+  BOOST_TEST(out[Position<2>({4, 2})] == 3);
+  BOOST_TEST(out[Position<2>({4, 0})] == std::sqrt(13.f));
+}
+
+BOOST_AUTO_TEST_CASE(empty_mask_test)
+{
+  Raster<char> mask({3, 3});
+  const auto out = squared_distance_transform(mask);
+  for (const auto& e : out) {
+    BOOST_TEST(std::isinf(e));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_2d_test)
+{
+  const auto mask = random_mask<2>({23, 17}, 29);
+  const auto expected = brute_force(mask);
+  for (Index threads : {1, 3}) {
+    const auto out = squared_distance_transform(par(threads), mask);
+    BOOST_TEST(out.container() == expected.container(), boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_3d_test)
+{
+  const auto mask = random_mask<3>({9, 7, 8}, 40);
+  const auto expected = brute_force(mask);
+  const auto out = squared_distance_transform(par(2), mask);
+  BOOST_TEST(out.container() == expected.container(), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(ball_dilation_test)
+{
+  const auto mask = random_mask<2>({31, 26}, 50);
+  const auto expected = brute_force(mask);
+  for (double radius : {0., 1., 1.5, 4.2}) {
+    const auto out = ball_dilation(par(2), mask, radius);
+    for (const auto& p : mask.domain()) {
+      BOOST_TEST(bool(out[p]) == (expected[p] <= radius * radius));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,64 @@ BOOST_AUTO_TEST_CASE(laplacian_minus_test)
   BOOST_TEST((laplace_operator<int, 0, 1>(-1).impulse()) == expected);
 }
 
+BOOST_AUTO_TEST_CASE(single_pass_norm_test)
+{
+  auto raster = Raster<int>({9, 7}).range();
+  raster.apply([](auto e) {
+    return (e * 37) % 11;
+  });
+  const auto dx = sobel_gradient<int, 0, 1>();
+  const auto dy = sobel_gradient<int, 1, 0>();
+  const auto magnitude = norm(dx, dy);
+  const auto squared = [](int x, int y) {
+    return x * x + y * y;
+  };
+
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  Raster<int> expected(raster.shape());
+  expected.generate(squared, dx * extrapolated, dy * extrapolated);
+  BOOST_TEST((magnitude * extrapolated) == expected);
+
+  const auto dx_cropped = dx * raster;
+  Raster<int> expected_cropped(dx_cropped.shape());
+  expected_cropped.generate(squared, dx_cropped, dy * raster);
+  BOOST_TEST((magnitude * raster) == expected_cropped);
+}
+
+BOOST_AUTO_TEST_CASE(single_pass_asymmetric_sum_test)
+{
+  const auto raster = Raster<int>({8, 6}).range();
+  const auto a = convolution_along<int, 0>({1, 2, 3, 4});
+  const auto b = correlation<int>(Raster<int>({2, 3}, {1, -1, 2, 0, 0, 3}));
+  const auto extrapolated = extrapolation(raster, 1);
+  Raster<int> expected(raster.shape());
+  expected.generate(std::plus<int>(), a * extrapolated, b * extrapolated);
+  BOOST_TEST(((a + b) * extrapolated) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(preallocated_multi_pass_test)
+{
+  const auto raster = Raster<int>({19, 17}).range();
+  const auto agg = median_filter<int>(Box<2>::from_center(1)) + maximum_filter<int>(Box<2>::from_center(1));
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  const auto expected = agg * extrapolated;
+  Raster<int> out(raster.shape());
+  for (Index i = 0; i < 2; ++i) {
+    const auto cached = MemoryPool::cached();
+    agg.transform(extrapolated, out);
+    BOOST_TEST(out == expected);
+    if (i > 0) {
+      BOOST_TEST(MemoryPool::cached() == cached); // Temporaries are recycled
+    }
+  }
+  const std::vector<Position<2>> positions {{0, 0}, {5, 7}, {18, 16}};
+  Sequence<int> values(positions.size());
+  agg.transform(extrapolated(Sequence<Position<2>>(positions)), values);
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    BOOST_TEST(values[i] == expected[positions[i]]);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Raster.h"
+#include "Linx/Io/Temporary.h"
+#include "Linx/Transforms/FilterPlanner.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FilterPlanner_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(measured_equals_automatic_test)
+{
+  Raster<float> in({32, 24});
+  in.generate(UniformNoise<float>(-1, 1));
+  auto filter = correlation(Raster<float>({5, 3}).range());
+  const auto automatic = filter * extrapolation<Nearest>(in);
+  filter.kernel().strategy(KernelStrategy::Measure);
+  BOOST_TEST((filter.kernel().requested_strategy() == KernelStrategy::Measure));
+
+  filter_planner().clear();
+  const auto measured = filter * extrapolation<Nearest>(in);
+  BOOST_TEST(filter_planner().size() == 1);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(measured[p] == automatic[p], boost::test_tools::tolerance(1e-4f));
+  }
+
+  const auto cached = filter * extrapolation<Nearest>(in);
+  BOOST_TEST(filter_planner().size() == 1);
+  BOOST_TEST(cached == measured);
+
+  const auto cropped = filter * in;
+  BOOST_TEST(filter_planner().size() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(measure_skips_inapplicable_strategies_test)
+{
+  const auto in = Raster<float>({16, 16}).range();
+  const auto filter = correlation(Raster<float>({4, 4}).range()); // Rank > 1
+  FilterPlanner planner(1);
+  const auto strategy = planner.measure(filter, extrapolation<Nearest>(in));
+  BOOST_TEST((strategy != KernelStrategy::Separable));
+  BOOST_TEST((strategy != KernelStrategy::Automatic));
+}
+
+BOOST_AUTO_TEST_CASE(save_load_test)
+{
+  const auto in = Raster<float>({16, 16}).range();
+  const auto filter = convolution(Raster<float>({3, 3}).range());
+  FilterPlanner loaded;
+  std::string filename;
+  {
+    TemporaryPath path("planner.txt");
+    filename = path.string();
+    FilterPlanner planner(1);
+    const auto strategy = planner.plan(filter, extrapolation(in));
+    planner.save(filename);
+
+    loaded.load(filename);
+    BOOST_TEST(loaded.size() == 1);
+    BOOST_TEST((loaded.plan(filter, extrapolation(in)) == strategy));
+  }
+
+  loaded.load(filename); // Missing file is not an error
+  BOOST_TEST(loaded.size() == 1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -98,6 +98,42 @@ BOOST_AUTO_TEST_CASE(orthogonal_associativity_commutativity_test)
   BOOST_TEST(commutated == direct);
 }
 
+BOOST_AUTO_TEST_CASE(streaming_equals_sequential_test)
+{
+  const auto raster = Raster<int>({17, 23}).range();
+  const auto blur = mean_filter<int>(Box<2>::from_center(1));
+  const auto laplacian = convolution(Raster<int>({3, 3}, {0, 1, 0, 1, -4, 1, 0, 1, 0}));
+  const auto dilate = maximum_filter<int>(Box<2>({-2, 0}, {1, 1}));
+  const auto seq = blur * laplacian * dilate;
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  const auto expected = seq * extrapolated;
+  const auto cropped = seq * raster;
+  for (Index length : {1, 3, 100, -1}) {
+    auto streamed = seq;
+    streamed.stream(length, 3);
+    BOOST_TEST((streamed * extrapolated) == expected);
+    BOOST_TEST((streamed * raster) == cropped);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_update_test)
+{
+  auto raster = Raster<int>({29, 31}).range();
+  const auto seq = mean_filter<int>(Box<2>::from_center(1)) * maximum_filter<int>(Box<2>({-2, 0}, {1, 1}));
+  auto extrapolated = seq * extrapolation<Nearest>(raster);
+  auto cropped = seq * raster;
+  const std::vector<Box<2>> changed {{{3, 4}, {5, 4}}, {{20, 0}, {28, 2}}};
+  for (const auto& c : changed) {
+    for (const auto& p : c) {
+      raster[p] = 1000 - raster[p];
+    }
+  }
+  seq.update(extrapolation<Nearest>(raster), changed, extrapolated);
+  seq.update(raster, changed, cropped);
+  BOOST_TEST(extrapolated == seq * extrapolation<Nearest>(raster));
+  BOOST_TEST(cropped == seq * raster);
+}
+
 // BOOST_AUTO_TEST_CASE(sum3x3_dirichlet_test)
 // {
 //   const SeparableKernel<int, 0, 1, 2> kernel({1, 1, 1});
@@ -142,6 +178,22 @@ BOOST_AUTO_TEST_CASE(orthogonal_associativity_commutativity_test)
 //   BOOST_TEST(edges1.container() == expected1);
 // }
 
+BOOST_AUTO_TEST_CASE(preallocated_grid_test)
+{
+  const auto raster = Raster<int>({17, 23}).range();
+  const auto seq = mean_filter<int>(Box<2>::from_center(1)) * maximum_filter<int>(Box<2>({-2, 0}, {1, 1}));
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  const auto expected = seq * extrapolated;
+  const auto grid = Grid<2>({Position<2> {1, 2}, Position<2> {16, 20}}, Position<2> {3, 2});
+  Raster<int> out(grid.shape());
+  for (Index i = 0; i < 2; ++i) {
+    seq.transform(extrapolated(grid), out);
+    for (const auto& p : out.domain()) {
+      BOOST_TEST(out[p] == (expected[{1 + p[0] * 3, 2 + p[1] * 2}]));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "Linx/Transforms/Filters.h"
 
 #include <boost/test/unit_test.hpp>
+#include <numeric> // accumulate
 
 using namespace Linx;
 
@@ -120,6 +121,453 @@ BOOST_AUTO_TEST_CASE(extrapolated_decimate_3d_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(separable_decimate_test)
+{
+  const auto in = Raster<int, 2>({23, 19}).range();
+  const auto extrapolated = extrapolation<Periodic>(in);
+  Raster<int, 2> values({5, 3});
+  for (const auto& p : values.domain()) {
+    values[p] = (std::array<int, 5> {1, 4, 6, 4, 1})[p[0]] * (std::array<int, 3> {1, 2, 1})[p[1]];
+  }
+  auto k = correlation(values);
+  BOOST_TEST(bool(k.kernel().separable()));
+  const auto expected = k * extrapolated;
+  for (const auto& step : {Position<2> {2, 2}, Position<2> {4, 4}, Position<2> {7, 1}, Position<2> {1, 5}}) {
+    const auto region = Grid<2>({Position<2> {1, 0}, Position<2> {22, 18}}, step);
+    for (Index threads : {1, 3}) {
+      k.parallelize(threads);
+      const auto out = k * extrapolated(region);
+      BOOST_TEST(out.shape() == region.shape());
+      for (const auto& p : out.domain()) {
+        BOOST_TEST(out[p] == (expected[{region.front()[0] + p[0] * step[0], region.front()[1] + p[1] * step[1]}]));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(separable_detection_test)
+{
+  const auto rank_one = convolution(Raster<int>({3, 2}, {1, 2, 3, 2, 4, 6}));
+  BOOST_TEST(bool(rank_one.kernel().separable()));
+  const auto rank_two = convolution(Raster<int>({3, 3}).range());
+  BOOST_TEST(not rank_two.kernel().separable());
+  const auto tiny = convolution(Raster<int>({2, 2}).fill(1)); // No gain
+  BOOST_TEST(not tiny.kernel().separable());
+}
+
+BOOST_AUTO_TEST_CASE(strategy_selection_test)
+{
+  auto rank_one = convolution(Raster<int>({3, 2}, {1, 2, 3, 2, 4, 6}));
+  BOOST_TEST((rank_one.kernel().strategy() == KernelStrategy::Separable));
+  rank_one.kernel().strategy(KernelStrategy::ShiftAccumulate);
+  BOOST_TEST((rank_one.kernel().strategy() == KernelStrategy::ShiftAccumulate));
+  rank_one.kernel().strategy(KernelStrategy::Direct);
+  BOOST_TEST((rank_one.kernel().strategy() == KernelStrategy::Direct));
+  BOOST_TEST(not rank_one.kernel().transforms_region());
+  const auto rank_two = convolution(Raster<int>({3, 3}).range());
+  BOOST_TEST((rank_two.kernel().strategy() == KernelStrategy::ShiftAccumulate));
+}
+
+BOOST_AUTO_TEST_CASE(shift_accumulate_equals_direct_test)
+{
+  const auto in = Raster<float, 3>({13, 9, 5}).range();
+  auto values = Raster<float, 3>({5, 3, 2}).range();
+  values[{1, 1, 1}] = 0;
+  const auto k = convolution(values);
+  BOOST_TEST((k.kernel().strategy() == KernelStrategy::ShiftAccumulate));
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p), boost::test_tools::tolerance(1.e-5f));
+  }
+
+  const auto cropped = k * in;
+  const auto region = in.domain() - k.window();
+  BOOST_TEST(cropped.shape() == region.shape());
+  for (const auto& p : cropped.domain()) {
+    BOOST_TEST(cropped[p] == out[p + region.front()], boost::test_tools::tolerance(1.e-5f));
+  }
+
+  const auto ints = Raster<int>({11, 7}).range();
+  const auto l = correlation(Raster<int>({3, 3}).range());
+  const auto int_out = l * extrapolation(ints, 1);
+  for (const auto& p : ints.domain()) {
+    BOOST_TEST(int_out[p] == l * extrapolation(ints, 1)(p));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sparse_equals_direct_test)
+{
+  const auto in = Raster<float, 3>({13, 9, 5}).range();
+  auto values = Raster<float, 3>({5, 3, 3});
+  values[{0, 0, 0}] = 1;
+  values[{4, 1, 2}] = -2;
+  values[{2, 2, 1}] = 3;
+  const auto k = sparse_convolution(values);
+  BOOST_TEST((k.kernel().strategy() == KernelStrategy::Sparse));
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p));
+  }
+
+  auto dense = convolution(values);
+  dense.kernel().strategy(KernelStrategy::Sparse);
+  BOOST_TEST((dense.kernel().strategy() == KernelStrategy::Sparse));
+  BOOST_TEST((dense * in) == (convolution(values) * in));
+}
+
+BOOST_AUTO_TEST_CASE(separable_equals_direct_test)
+{
+  const auto in = Raster<double, 3>({9, 8, 7}).range();
+  std::vector<double> a {1, -2, 3};
+  std::vector<double> b {0.5, 1, 2, 1};
+  std::vector<double> c {2, 3};
+  Raster<double, 3> values({3, 4, 2});
+  for (const auto& p : values.domain()) {
+    values[p] = a[p[0]] * b[p[1]] * c[p[2]];
+  }
+  const auto k = correlation(values);
+  BOOST_TEST(bool(k.kernel().separable()));
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p), boost::test_tools::tolerance(1.e-9));
+  }
+
+  const auto cropped = k * in;
+  const auto region = in.domain() - k.window();
+  BOOST_TEST(cropped.shape() == region.shape());
+  for (const auto& p : cropped.domain()) {
+    BOOST_TEST(cropped[p] == out[p + region.front()], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(static_correlation_equals_dynamic_test)
+{
+  auto in = Raster<float>({13, 9}).range();
+  in.apply([](auto e) {
+    return float(int(e * 7) % 11);
+  });
+  auto values = Raster<float>({5, 3}).range();
+  std::array<float, 15> array;
+  std::copy(values.begin(), values.end(), array.begin());
+  const auto fixed = correlation<float, 5, 3>(array);
+  const auto dynamic = correlation(values);
+  BOOST_TEST(fixed.window() == dynamic.window());
+  BOOST_TEST((fixed * extrapolation(in)) == (dynamic * extrapolation(in)));
+  BOOST_TEST((fixed * in) == (dynamic * in));
+  BOOST_TEST((convolution<float, 5, 3>(array) * in) == (convolution(values) * in));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST((fixed * extrapolation(in)(p)) == (dynamic * extrapolation(in)(p)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(static_gradients_3d_test)
+{
+  const auto in = Raster<int, 3>({6, 5, 4}).range();
+  const auto extrapolated = extrapolation(in);
+  const auto sobel = sobel_gradient<int, 2, 0>();
+  BOOST_TEST(sobel.window() == (Box<3>({-1, 0, -1}, {1, 0, 1})));
+  const auto separable = convolution_along<int, 2>({1, 0, -1}) * convolution_along<int, 0>({1, 2, 1});
+  BOOST_TEST((sobel * extrapolated) == (separable * extrapolated));
+  const auto laplacian = laplace_operator<int, 0, 1, 2>();
+  const auto sum = FilterAgg(
+      [](int a, int b, int c) {
+        return a + b + c;
+      },
+      convolution_along<int, 0>({1, -2, 1}),
+      convolution_along<int, 1>({1, -2, 1}),
+      convolution_along<int, 2>({1, -2, 1}));
+  BOOST_TEST((laplacian * extrapolated) == (sum * extrapolated));
+}
+
+BOOST_AUTO_TEST_CASE(fused_sequence_equals_direct_test)
+{
+  const auto in = Raster<int>({11, 7}).range();
+  const auto extrapolated = extrapolation(in, 0);
+  const auto sobel = sobel_gradient<int, 0, 1>();
+  const auto direct = convolution(sobel.impulse());
+  const auto out = sobel * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == direct * extrapolated(p)); // Single-position filtering is always direct
+  }
+  BOOST_TEST((sobel * in) == (direct * in));
+}
+
+using SlidingMedianTypes = std::tuple<unsigned char, std::int16_t, std::uint16_t, int, float, double>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sliding_median_equals_direct_test, T, SlidingMedianTypes)
+{
+  const auto in = random<T, 3>({13, 9, 5});
+  const auto k = median_filter<T>(Box<3>::from_center(2, Position<3> {0, 0, 1}));
+  BOOST_TEST(k.kernel().transforms_region());
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p)); // Single-position filtering is always direct
+  }
+
+  const auto cropped = k * in;
+  const auto region = in.domain() - k.window();
+  for (const auto& p : cropped.domain()) {
+    BOOST_TEST(cropped[p] == out[p + region.front()]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(even_median_is_direct_test)
+{
+  const auto k = median_filter<float>(Box<2>({0, 0}, {1, 1}));
+  BOOST_TEST(not k.kernel().transforms_region());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sliding_rank_equals_direct_test, T, SlidingMedianTypes)
+{
+  const auto in = random<T, 3>({13, 9, 5});
+  const auto window = Box<3>({-2, -1, 0}, {2, 1, 1});
+  const auto extrapolated = extrapolation<Nearest>(in);
+  for (auto q : {.05, .3, .95}) {
+    const auto k = rank_filter<T>(window, q);
+    BOOST_TEST(k.kernel().transforms_region());
+    const auto out = k * extrapolated;
+    for (const auto& p : in.domain()) {
+      BOOST_TEST(out[p] == k * extrapolated(p));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(extreme_ranks_are_extrema_test)
+{
+  const auto in = random<float, 2>({16, 12});
+  const auto window = Box<2>::from_center(2);
+  BOOST_TEST((rank_filter<float>(window, 0) * in) == (minimum_filter<float>(window) * in));
+  BOOST_TEST((rank_filter<float>(window, 1) * in) == (maximum_filter<float>(window) * in));
+  BOOST_TEST((rank_filter<float>(window, .5) * in) == (median_filter<float>(window) * in));
+  BOOST_CHECK_THROW(rank_filter<float>(window, 1.5), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(sliding_trimmed_mean_equals_direct_test)
+{
+  const auto in = random<int, 2>({16, 12});
+  const auto k = trimmed_mean_filter<double>(Box<2>::from_center(2), .2);
+  BOOST_TEST(k.kernel().transforms_region());
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p), boost::test_tools::tolerance(1e-12));
+  }
+}
+
+using SlidingExtremumTypes = std::tuple<unsigned char, int, float>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sliding_extremum_equals_direct_test, T, SlidingExtremumTypes)
+{
+  const auto in = random<T, 3>({13, 9, 5});
+  const auto window = Box<3>({-3, -1, 0}, {2, 1, 1});
+  const auto min = minimum_filter<T>(window);
+  const auto max = maximum_filter<T>(window);
+  BOOST_TEST(min.kernel().transforms_region());
+  BOOST_TEST(max.kernel().transforms_region());
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto min_out = min * extrapolated;
+  const auto max_out = max * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(min_out[p] == min * extrapolated(p)); // Single-position filtering is always direct
+    BOOST_TEST(max_out[p] == max * extrapolated(p));
+  }
+
+  const auto cropped = min * in;
+  const auto region = in.domain() - window;
+  BOOST_TEST(cropped.shape() == region.shape());
+  for (const auto& p : cropped.domain()) {
+    BOOST_TEST(cropped[p] == min_out[p + region.front()]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sliding_binary_morphology_equals_direct_test)
+{
+  auto in = Raster<char>({17, 11});
+  in.generate([i = 0]() mutable {
+    return (++i % 7) == 0;
+  });
+  const auto extrapolated = extrapolation(in, char(0));
+  const auto erode = erosion<char>(Box<2>::from_center(1));
+  const auto dilate = dilation<char>(Box<2>::from_center(2));
+  BOOST_TEST(erode.kernel().transforms_region());
+  const auto eroded = erode * extrapolated;
+  const auto dilated = dilate * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(eroded[p] == erode * extrapolated(p));
+    BOOST_TEST(dilated[p] == dilate * extrapolated(p));
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(fused_opening_closing_equals_sequence_test, T, SlidingExtremumTypes)
+{
+  const auto in = random<T, 3>({13, 9, 5});
+  const auto element = Box<3>({-2, -1, 0}, {1, 1, 1});
+  const auto min = minimum_filter<T>(element);
+  const auto max = maximum_filter<T>(element);
+  const auto opened = max * (min * in);
+  const auto closed = min * (max * in);
+  BOOST_TEST((opening<T>(element) * in) == opened);
+  BOOST_TEST((closing<T>(element) * in) == closed);
+
+  const auto white = white_tophat<T>(element) * in;
+  const auto black = black_tophat<T>(element) * in;
+  const auto center = in(in.domain() - white_tophat<T>(element).window());
+  BOOST_TEST(white.shape() == opened.shape());
+  auto c = center.begin();
+  for (const auto& p : white.domain()) {
+    BOOST_TEST(white[p] == T(*c - opened[p]));
+    BOOST_TEST(black[p] == T(closed[p] - *c));
+    ++c;
+  }
+
+  const auto extrapolated = opening<T>(element) * extrapolation<Nearest>(in);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(extrapolated[p] == opening<T>(element) * extrapolation<Nearest>(in)(p)); // Direct
+  }
+}
+
+BOOST_AUTO_TEST_CASE(summed_area_mean_equals_direct_test)
+{
+  auto in = Raster<float, 3>({13, 9, 5});
+  in.generate(UniformNoise<float>(-1, 1));
+  const auto k = mean_filter<float>(Box<3>({-4, -2, 0}, {3, 2, 1}));
+  BOOST_TEST(k.kernel().transforms_region());
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(out[p] - k * extrapolated(p)) < 1.e-5); // Direct float accumulation is less accurate
+  }
+
+  const auto cropped = k * in;
+  const auto region = in.domain() - k.window();
+  BOOST_TEST(cropped.shape() == region.shape());
+  for (const auto& p : cropped.domain()) {
+    BOOST_TEST(cropped[p] == out[p + region.front()]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(summed_area_integer_mean_equals_direct_test)
+{
+  const auto in = Raster<int>({17, 11}).range();
+  const auto extrapolated = extrapolation(in, 0);
+  const auto k = mean_filter<int>(Box<2>::from_center(3));
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(local_moments_equal_direct_test)
+{
+  auto in = Raster<double, 2>({19, 13});
+  in.generate(UniformNoise<double>(-1, 1));
+  in += 1.e6; // Large mean compared to the deviation
+  const Box<2> window({-2, -1}, {3, 2});
+  const auto moments = local_moments<double>(window);
+
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto [mean, variance, stdev] = moments * extrapolated;
+  BOOST_TEST(mean.shape() == in.shape());
+  for (const auto& p : in.domain()) {
+    const auto neighbors = extrapolated(window + p);
+    const auto m = std::accumulate(neighbors.begin(), neighbors.end(), 0.) / neighbors.size();
+    double v = 0;
+    for (const auto& e : neighbors) {
+      v += (e - m) * (e - m);
+    }
+    v /= neighbors.size();
+    BOOST_TEST(mean[p] == m, boost::test_tools::tolerance(1.e-12));
+    BOOST_TEST(variance[p] == v, boost::test_tools::tolerance(1.e-6));
+    BOOST_TEST(stdev[p] == std::sqrt(variance[p]), boost::test_tools::tolerance(1.e-12));
+  }
+
+  const auto cropped = moments * in;
+  const auto region = in.domain() - window;
+  BOOST_TEST(cropped.variance.shape() == region.shape());
+  for (const auto& p : cropped.variance.domain()) {
+    BOOST_TEST(cropped.mean[p] == mean[p + region.front()], boost::test_tools::tolerance(1.e-12));
+    BOOST_TEST(cropped.variance[p] == variance[p + region.front()], boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(virtual_raster_filtering_test)
+{
+  const auto in = virtual_coordinate<float>(Position<3> {64, 64, 80}, 2); // Several bands
+  const auto k = mean_filter<float>(Box<3>({-1, -2, -3}, {1, 2, 3}));
+  const auto out = k * in;
+  BOOST_TEST(out.shape() == in.shape());
+  const auto expected = k * in(in.domain() + k.window()).eval();
+  BOOST_TEST(out == expected);
+}
+
+using FixedPointTypes = std::tuple<unsigned char, std::uint16_t, short, int>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(fixed_point_correlation_equals_direct_test, T, FixedPointTypes)
+{
+  const auto in = random<T, 3>({13, 9, 5});
+  auto values = Raster<double, 3>({3, 5, 2});
+  values.generate(UniformNoise<double>(-1, 1));
+  const auto k = fixed_point_correlation<T>(values);
+  BOOST_TEST(k.kernel().transforms_region());
+  BOOST_TEST(k.kernel().shift() > 0);
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = k * extrapolated;
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == k * extrapolated(p));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_point_convolution_is_accurate_test)
+{
+  const auto in = random<std::uint16_t, 2>({32, 24});
+  const auto values = Raster<double, 2>({3, 3}, {1, 2, 1, 2, 4, 2, 1, 2, 1}) / 16.;
+  const auto fixed = fixed_point_convolution<std::uint16_t>(values);
+  BOOST_TEST(fixed.kernel().shift() == 15);
+  BOOST_TEST(fixed.kernel().correlation_coefficients() == std::vector<double>(values.begin(), values.end()));
+  const auto reference = convolution(values);
+  const auto extrapolated = extrapolation<Nearest>(in);
+  const auto out = fixed * extrapolated;
+  Raster<double, 2> real(in.shape());
+  std::copy(in.begin(), in.end(), real.begin());
+  const auto expected = reference * extrapolation<Nearest>(real);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(out[p] - expected[p]) <= .5);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_point_saturation_test)
+{
+  const auto in = Raster<unsigned char, 1>({4}).fill(200);
+  const auto values = Raster<double, 1>({3}, {1, 1, -.5});
+  const auto out = fixed_point_correlation<unsigned char>(values) * extrapolation<Nearest>(in);
+  for (auto e : out) {
+    BOOST_TEST(e == 255);
+  }
+  const auto negative = fixed_point_correlation<unsigned char>(Raster<double, 1>({1}, {-1})) * in;
+  for (auto e : negative) {
+    BOOST_TEST(e == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(strided_view_test)
+{
+  auto in = Raster<float>({12, 10}).range();
+  const auto window = Box<2>::from_center(1);
+  const auto transposed = strided(in).permute({1, 0});
+  const Raster<float> copy(transposed.shape(), transposed);
+  BOOST_TEST((median_filter<float>(window) * transposed) == (median_filter<float>(window) * copy));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
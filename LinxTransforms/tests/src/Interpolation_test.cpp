@@ -48,6 +48,28 @@ BOOST_AUTO_TEST_CASE(periodic_test)
   BOOST_TEST(extra[positive] == (raster[{0, 1, 0}]));
 }
 
+BOOST_AUTO_TEST_CASE(copy_equals_extrapolated_patch_test)
+{
+  const auto raster = Raster<int, 3>({5, 4, 3}).range();
+  const std::vector<Box<3>> boxes {
+      Box<3>({-7, -2, -4}, {9, 6, 5}),
+      Box<3>({1, 1, 1}, {3, 2, 2}),
+      Box<3>({-3, 0, 0}, {0, 3, 2}),
+      Box<3>({4, -1, 2}, {12, 1, 3}),
+      Box<3>({-20, -9, -5}, {-8, -6, -4}), // Fully outside
+      Box<3>({-13, 1, 0}, {17, 2, 1})}; // Several periods
+  const auto check = [&](const auto& extra) {
+    for (const auto& b : boxes) {
+      const Raster<int, 3> expected(extra(b));
+      BOOST_TEST(extra.copy(b) == expected);
+    }
+  };
+  check(extrapolation(raster, -1));
+  check(extrapolation<Nearest>(raster));
+  check(extrapolation<Periodic>(raster));
+  check(extrapolation<Mirror>(raster));
+}
+
 BOOST_AUTO_TEST_CASE(linear_test)
 {
   Raster<int, 3> raster({2, 2, 2});
@@ -82,6 +104,129 @@ BOOST_AUTO_TEST_CASE(cubic_test)
   BOOST_TEST(center == 32.5);
 }
 
+BOOST_AUTO_TEST_CASE(stencil_equals_extrapolated_taps_test)
+{
+  Raster<float, 3> raster({5, 6, 4});
+  raster.range(1);
+  const auto extrapolator = extrapolation(raster, 0.F);
+  const auto direct = interpolation<Cubic>(raster);
+  const auto checked = interpolation<Cubic>(extrapolator);
+  for (const auto& v : {Vector<double, 3> {1.3, 2.7, 1.5}, Vector<double, 3> {2.25, 1., 1.9}}) {
+    BOOST_TEST(direct(v) == checked(v));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(quantized_test)
+{
+  Raster<double> raster({6, 6});
+  raster.range(1);
+  const auto exact = interpolation<Cubic>(raster);
+  const auto quantized = interpolation<Quantized<Cubic, 256>>(raster);
+  const Vector<double> on_step {2.5, 1.25};
+  BOOST_TEST(quantized(on_step) == exact(on_step));
+  const Vector<double> off_step {2.1234, 1.9876};
+  BOOST_TEST(quantized(off_step) == exact(off_step), boost::test_tools::tolerance(1.e-2));
+  const auto linear = interpolation<Quantized<Linear, 4>>(raster);
+  BOOST_TEST(linear({1.99, 2.}) == (raster[{2, 2}]));
+}
+
+BOOST_AUTO_TEST_CASE(mirror_test)
+{
+  const Mirror mirror;
+  BOOST_TEST(mirror.index(-1, 4) == 1);
+  BOOST_TEST(mirror.index(-3, 4) == 3);
+  BOOST_TEST(mirror.index(4, 4) == 2);
+  BOOST_TEST(mirror.index(7, 4) == 1);
+  BOOST_TEST(mirror.index(5, 1) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(bspline_interpolates_samples_test)
+{
+  Raster<double> raster({7, 5});
+  for (const auto& p : raster.domain()) {
+    raster[p] = std::sin(p[0]) + std::cos(2 * p[1]);
+  }
+  const auto cubic = interpolation<BSpline<3>>(raster);
+  const auto mirrored = extrapolation<Mirror>(raster);
+  const auto quintic = interpolation<BSpline<5>>(mirrored);
+  for (const auto& p : raster.domain()) {
+    const Vector<double> v(p);
+    BOOST_TEST(cubic(v) == raster[p], boost::test_tools::tolerance(1.e-9));
+    BOOST_TEST(quintic(v) == raster[p], boost::test_tools::tolerance(1.e-9));
+  }
+  const auto copy = cubic;
+  BOOST_TEST(copy.coefficients() == cubic.coefficients()); // Shared
+  BOOST_TEST(interpolation<Cubic>(raster).coefficients() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(bspline_and_lanczos_preserve_affine_data_test)
+{
+  Raster<double> raster({40, 40}); // Large enough for the mirror boundaries to be negligible at the center
+  for (const auto& p : raster.domain()) {
+    raster[p] = 2 * p[0] - p[1] + 1;
+  }
+  const auto bspline = interpolation<BSpline<3>>(raster);
+  const auto zero = extrapolation(raster, 0.);
+  const auto lanczos = interpolation<Lanczos<3>>(zero);
+  const Vector<double> v {20.3, 19.6};
+  BOOST_TEST(bspline(v) == 2 * 20.3 - 19.6 + 1, boost::test_tools::tolerance(1.e-6));
+  BOOST_TEST(lanczos({20.5, 19.5}) == 2 * 20.5 - 19.5 + 1, boost::test_tools::tolerance(1.e-2));
+  Raster<double> flat({5, 5});
+  for (auto& e : flat) {
+    e = 3;
+  }
+  const auto extrapolator = extrapolation<Nearest>(flat);
+  const auto constant = interpolation<Lanczos<3>>(extrapolator);
+  BOOST_TEST(constant({0.3, 4.7}) == 3, boost::test_tools::tolerance(1.e-12));
+}
+
+BOOST_AUTO_TEST_CASE(gather_equals_elementwise_test)
+{
+  Raster<float> raster({50, 40});
+  raster.range();
+  const auto extrapolator = extrapolation(raster, -1.F);
+  const auto interpolator = interpolation<Cubic>(extrapolator);
+  Sequence<Vector<double, 2>> positions(1000);
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    positions[i] = {std::fmod(i * 7.31, 56.) - 3, std::fmod(i * 3.17, 46.) - 3};
+  }
+  for (Index tile : {0, 8}) {
+    for (Index threads : {1, 4}) {
+      const auto values = interpolator.gather(positions, threads, tile);
+      BOOST_TEST(values.size() == positions.size());
+      for (std::size_t i = 0; i < positions.size(); ++i) {
+        BOOST_TEST(values[i] == interpolator(positions[i]));
+      }
+    }
+  }
+  const Sequence<Position<2>> integral {{0, 0}, {49, 39}, {-1, 3}};
+  const auto samples = interpolator.gather(integral);
+  BOOST_TEST(samples[0] == (raster[{0, 0}]));
+  BOOST_TEST(samples[1] == (raster[{49, 39}]));
+  BOOST_TEST(samples[2] == -1);
+}
+
+BOOST_AUTO_TEST_CASE(tabulated_equals_extrapolated_test)
+{
+  const auto raster = Raster<float, 3>({5, 4, 3}).range();
+  const auto region = Box<3>::from_shape({-4, -4, -4}, {13, 12, 11}); // Beyond the margin
+  const auto check = [&](const auto& tabulated, const auto& expected) {
+    for (const auto& p : region) {
+      BOOST_TEST(tabulated[p] == expected[p]);
+    }
+  };
+  check(tabulated_extrapolation(raster, 2), extrapolation(raster));
+  check(tabulated_extrapolation<Periodic>(raster, 2), extrapolation<Periodic>(raster));
+  check(tabulated_extrapolation<Mirror>(raster, 2), extrapolation<Mirror>(raster));
+  check(tabulated_extrapolation<Constant<float>>(raster, 2, -1.F), extrapolation(raster, -1.F));
+  const auto tabulated = tabulated_extrapolation<Constant<float>>(raster, 1, -1.F);
+  const auto interpolated = interpolation<Cubic>(tabulated)(Vector<double, 3> {0.3, 3.2, -0.4});
+  const auto expected = interpolation<Cubic>(extrapolation(raster, -1.F))(Vector<double, 3> {0.3, 3.2, -0.4});
+  BOOST_TEST(interpolated == expected);
+  BOOST_TEST(float(tabulated.method()) == -1.F);
+}
+
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Labeling.h"
+
+#include <boost/test/unit_test.hpp>
+#include <deque>
+
+using namespace Linx;
+
+/**
+ * @brief Label a mask with a breadth-first search, numbering regions in memory order.
+ */
+template <Index N>
+Raster<Index, N> bfs_labels(const Raster<char, N>& mask, Connectivity connectivity)
+{
+  Raster<Index, N> out(mask.shape());
+  Index label = 0;
+  for (const auto& p : mask.domain()) {
+    if (not mask[p] || out[p]) {
+      continue;
+    }
+    ++label;
+    out[p] = label;
+    std::deque<Position<N>> queue {p};
+    while (not queue.empty()) {
+      const auto q = queue.front();
+      queue.pop_front();
+      for (const auto& d : Box<N>::from_center(1)) {
+        Index norm = 0;
+        for (Index i = 0; i < N; ++i) {
+          norm += d[i] != 0;
+        }
+        const auto r = q + d;
+        if (norm == 0 || (connectivity == Connectivity::Faces && norm > 1) || not mask.domain().contains(r)) {
+          continue;
+        }
+        if (mask[r] && not out[r]) {
+          out[r] = label;
+          queue.push_back(r);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Check labels and statistics against a breadth-first search, for several thread counts.
+ */
+template <Index N>
+void check_labeling(const Raster<char, N>& mask, Connectivity connectivity)
+{
+  Raster<float, N> in(mask.shape());
+  in.range();
+  const auto expected = bfs_labels(mask, connectivity);
+  for (Index threads : {1, 2, 3, 7}) {
+    const auto out = label_regions(par(threads), mask, in, connectivity);
+    BOOST_TEST(out.labels.container() == expected.container(), boost::test_tools::per_element());
+    std::vector<Region<N>> regions(out.regions.size());
+    for (const auto& p : expected.domain()) {
+      if (expected[p]) {
+        regions[expected[p] - 1].add(p, in[p]);
+      }
+    }
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+      BOOST_TEST(out.regions[i].label == Index(i + 1));
+      BOOST_TEST(out.regions[i].area == regions[i].area);
+      BOOST_TEST(out.regions[i].box == regions[i].box);
+      BOOST_TEST(out.regions[i].flux == regions[i].flux);
+    }
+  }
+}
+
+/**
+ * @brief Generate a pseudo-random mask.
+ */
+template <Index N>
+Raster<char, N> random_mask(const Position<N>& shape, Index modulo)
+{
+  Raster<char, N> mask(shape);
+  std::size_t state = 12345;
+  for (auto& e : mask) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    e = (state >> 33) % modulo == 0;
+  }
+  return mask;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Labeling_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(diagonal_test)
+{
+  Raster<char> mask({3, 3}, {1, 0, 0, 0, 1, 0, 0, 0, 1});
+  Raster<float> in(mask.shape());
+  in.fill(2);
+  const auto full = label_regions(mask, in, Connectivity::Full);
+  BOOST_TEST(full.regions.size() == 1);
+  BOOST_TEST(full.regions[0].area == 3);
+  BOOST_TEST(full.regions[0].flux == 6);
+  BOOST_TEST(full.regions[0].box == mask.domain());
+  const auto faces = label_regions(mask, in, Connectivity::Faces);
+  BOOST_TEST(faces.regions.size() == 3);
+  BOOST_TEST(faces.labels[Position<2>({2, 2})] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(u_shape_across_blocks_test)
+{
+  Raster<char> mask({5, 12});
+  for (const auto& p : mask.domain()) {
+    mask[p] = p[0] == 0 || p[0] == 4 || p[1] == 11;
+  }
+  Raster<float> in(mask.shape());
+  in.fill(1);
+  const auto out = label_regions(par(4), mask, in, Connectivity::Faces);
+  BOOST_TEST(out.regions.size() == 1);
+  BOOST_TEST(out.regions[0].area == 12 + 12 + 3);
+}
+
+BOOST_AUTO_TEST_CASE(random_2d_test)
+{
+  const auto mask = random_mask<2>({37, 41}, 3);
+  check_labeling(mask, Connectivity::Faces);
+  check_labeling(mask, Connectivity::Full);
+}
+
+BOOST_AUTO_TEST_CASE(random_3d_test)
+{
+  const auto mask = random_mask<3>({9, 8, 13}, 4);
+  check_labeling(mask, Connectivity::Faces);
+  check_labeling(mask, Connectivity::Full);
+}
+
+BOOST_AUTO_TEST_CASE(empty_mask_test)
+{
+  Raster<char> mask({4, 3});
+  const auto out = label_regions(par(2), mask, mask, Connectivity::Full);
+  BOOST_TEST(out.regions.empty());
+  BOOST_TEST(out.labels.container() == std::vector<Index>(12, 0), boost::test_tools::per_element());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
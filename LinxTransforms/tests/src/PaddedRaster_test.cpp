@@ -0,0 +1,63 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/PaddedRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PaddedRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(halo_equals_extrapolation_test)
+{
+  const auto raster = Raster<int, 3>({5, 4, 3}).range();
+  PaddedRaster<int, 3> padded(raster, {3, 2, 4});
+  const auto check = [&](const auto& extra) {
+    for (const auto& p : padded.padded_domain()) {
+      BOOST_TEST(padded[p] == extra[p]);
+    }
+  };
+  padded.extrapolate<Nearest>();
+  check(extrapolation<Nearest>(raster));
+  padded.extrapolate<Periodic>();
+  check(extrapolation<Periodic>(raster));
+  padded.extrapolate(-1);
+  check(extrapolation(raster, -1));
+}
+
+BOOST_AUTO_TEST_CASE(filter_padded_equals_extrapolated_test)
+{
+  const auto raster = Raster<int>({17, 13}).range();
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  PaddedRaster<int> padded(raster, {2, 2});
+  padded.extrapolate<Nearest>();
+
+  const auto mean = mean_filter<int>(Box<2>::from_center(2));
+  BOOST_TEST((mean * padded) == (mean * extrapolated));
+  const auto median = median_filter<int>(Box<2>({-1, -2}, {2, 0}));
+  BOOST_TEST((median * padded) == (median * extrapolated));
+  const auto conv = convolution(Raster<int>({3, 3}, {0, 1, 0, 1, -4, 1, 0, 1, 0}));
+  BOOST_TEST((conv * padded) == (conv * extrapolated));
+  const auto seq = mean_filter<int>(Box<2>::from_center(1)) * maximum_filter<int>(Box<2>::from_center(1));
+  BOOST_TEST((seq * padded) == (seq * extrapolated));
+  const auto magnitude = norm(sobel_gradient<int, 0, 1>(), sobel_gradient<int, 1, 0>());
+  BOOST_TEST((magnitude * padded) == (magnitude * extrapolated));
+}
+
+BOOST_AUTO_TEST_CASE(thin_halo_throws_test)
+{
+  PaddedRaster<int> padded({8, 8}, {1, 1});
+  const auto mean = mean_filter<int>(Box<2>::from_center(2));
+  BOOST_CHECK_THROW(mean * padded, OutOfBoundsError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
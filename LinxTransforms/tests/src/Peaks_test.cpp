@@ -0,0 +1,73 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Mask.h"
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/Peaks.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Peaks_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peaks_equal_maximum_filter_test)
+{
+  auto in = Raster<int, 2>({31, 23});
+  in.generate(UniformNoise<int>(0, 20)); // Many ties
+  const auto window = Box<2>::from_center(2);
+  const auto max = maximum_filter<int>(window) * extrapolation(in, std::numeric_limits<int>::min());
+  const auto peaks = find_peaks(in, window, 5);
+  Index count = 0;
+  for (const auto& p : in.domain()) {
+    if (in[p] > 5 && in[p] == max[p]) {
+      ++count; // Candidate, possibly on a plateau
+    }
+  }
+  BOOST_TEST(peaks.size() > 0);
+  BOOST_TEST(peaks.size() <= count);
+  for (const auto& p : peaks) {
+    BOOST_TEST(in[p] > 5);
+    BOOST_TEST(in[p] == max[p]);
+  }
+  for (Index threads : {2, 3, 7}) {
+    BOOST_TEST(find_peaks(par(threads), in, window, 5) == peaks);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(plateau_yields_single_peak_test)
+{
+  auto in = Raster<float, 2>({8, 6});
+  in[{3, 2}] = 1;
+  in[{4, 2}] = 1;
+  in[{3, 3}] = 1;
+  const auto peaks = find_peaks(in, Mask<2>::ball<1>(1), 0.f);
+  BOOST_TEST(peaks.size() == 1);
+  BOOST_TEST((peaks[0] == Position<2> {3, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(subpixel_refinement_test)
+{
+  auto in = Raster<double, 2>({9, 7});
+  const Vector<double, 2> center {4.3, 2.8};
+  in.generate([&, i = Index(0)]() mutable {
+    const auto x = i % 9 - center[0];
+    const auto y = i / 9 - center[1];
+    ++i;
+    return 10. - x * x - y * y;
+  });
+  const auto peaks = find_peaks(in, Box<2>::from_center(1), 0.);
+  BOOST_TEST(peaks.size() == 1);
+  const auto refined = refine_peaks(in, peaks);
+  BOOST_TEST(refined[0][0] == center[0], boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(refined[0][1] == center[1], boost::test_tools::tolerance(1e-9));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
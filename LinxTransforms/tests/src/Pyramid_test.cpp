@@ -0,0 +1,116 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Pyramid.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+/**
+ * @brief Smooth and decimate a 2D raster pixel by pixel.
+ */
+Raster<float> reference_level(const Raster<float>& in)
+{
+  const float binomial[] = {1, 4, 6, 4, 1};
+  Raster<float> out((in.shape() + 1) / 2);
+  for (const auto& q : out.domain()) {
+    double sum = 0;
+    for (Index j = -2; j <= 2; ++j) {
+      for (Index i = -2; i <= 2; ++i) {
+        const auto x = std::clamp<Index>(2 * q[0] + i, 0, in.shape()[0] - 1);
+        const auto y = std::clamp<Index>(2 * q[1] + j, 0, in.shape()[1] - 1);
+        sum += binomial[i + 2] * binomial[j + 2] * in[{x, y}];
+      }
+    }
+    out[q] = sum / 256;
+  }
+  return out;
+}
+
+/**
+ * @brief Copy the values of a level.
+ */
+template <typename TRaster>
+std::vector<float> values(const TRaster& in)
+{
+  return std::vector<float>(in.begin(), in.end());
+}
+
+/**
+ * @brief Generate a test image.
+ */
+Raster<float> test_image(Position<2> shape)
+{
+  Raster<float> out(shape);
+  out.generate(
+      [](auto p) {
+        return float((p[0] * 7 + p[1] * 13) % 19);
+      },
+      out.domain());
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Pyramid_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(shared_storage_test)
+{
+  const auto in = test_image({13, 8});
+  Pyramid<float> pyramid(in, 3);
+  BOOST_TEST(pyramid.size() == 3);
+  BOOST_TEST(pyramid.storage_size() == 13 * 8 + 7 * 4 + 4 * 2);
+  BOOST_TEST(pyramid.level(1).data() == pyramid.level(0).data() + 13 * 8);
+  BOOST_TEST(pyramid.level(2).data() == pyramid.level(1).data() + 7 * 4);
+  BOOST_TEST(pyramid.level(2).shape() == Position<2>({4, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(lazy_levels_test)
+{
+  const auto in = test_image({16, 12});
+  Pyramid<float> pyramid(in, 4);
+  BOOST_TEST(pyramid.built() == 1);
+  BOOST_TEST(values(pyramid.level(0)) == in.container(), boost::test_tools::per_element());
+  pyramid.level(2);
+  BOOST_TEST(pyramid.built() == 3);
+  pyramid.build();
+  BOOST_TEST(pyramid.built() == 4);
+  BOOST_CHECK_THROW(pyramid.level(4), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(levels_test)
+{
+  const auto in = test_image({21, 17});
+  Pyramid<float> pyramid(in, 3);
+  const auto expected1 = reference_level(in);
+  const auto expected2 = reference_level(expected1);
+  BOOST_TEST(values(pyramid.level(1)) == expected1.container(), boost::test_tools::tolerance(1.e-4f));
+  BOOST_TEST(values(pyramid.level(2)) == expected2.container(), boost::test_tools::tolerance(1.e-4f));
+}
+
+BOOST_AUTO_TEST_CASE(partial_update_test)
+{
+  auto in = test_image({32, 24});
+  Pyramid<float> pyramid(in, 4);
+  pyramid.build();
+  const Box<2> region({5, 17}, {9, 23});
+  for (const auto& p : region) {
+    in[p] = 100;
+    pyramid.base()[p] = 100;
+  }
+  pyramid.update(region);
+  Pyramid<float> expected(in, 4);
+  for (Index l = 1; l < 4; ++l) {
+    BOOST_TEST(
+        values(pyramid.level(l)) == values(expected.level(l)),
+        boost::test_tools::tolerance(1.e-4f));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
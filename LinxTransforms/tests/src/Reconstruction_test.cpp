@@ -0,0 +1,145 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Reconstruction.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+template <typename T, Index N>
+Raster<T, N> naive_reconstruction(const Raster<T, N>& marker, const Raster<T, N>& mask, Connectivity connectivity)
+{
+  auto neighbors = Internal::preceding_neighbors<N>(connectivity);
+  const auto count = neighbors.size();
+  for (std::size_t k = 0; k < count; ++k) {
+    neighbors.push_back(-neighbors[k]);
+  }
+  auto out = marker;
+  for (const auto& p : out.domain()) {
+    out[p] = std::min(out[p], mask[p]);
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto next = out;
+    for (const auto& p : out.domain()) {
+      auto v = out[p];
+      for (const auto& d : neighbors) {
+        if (out.domain().contains(p + d)) {
+          v = std::max(v, out[p + d]);
+        }
+      }
+      v = std::min(v, mask[p]);
+      if (v != next[p]) {
+        next[p] = v;
+        changed = true;
+      }
+    }
+    out = next;
+  }
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Reconstruction_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(grayscale_reconstruction_matches_iterated_dilation_test)
+{
+  Raster<int, 2> mask({37, 29});
+  Raster<int, 2> marker(mask.shape());
+  for (const auto& p : mask.domain()) {
+    mask[p] = (p[0] * 7 + p[1] * 13 + p[0] * p[1]) % 17;
+    marker[p] = (p[0] * 5 + p[1] * 3) % 23 == 0 ? 16 : 0;
+  }
+  for (auto connectivity : {Connectivity::Faces, Connectivity::Full}) {
+    const auto expected = naive_reconstruction(marker, mask, connectivity);
+    BOOST_TEST(reconstruct_by_dilation(marker, mask, connectivity) == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(spiral_is_reconstructed_test)
+{
+  // A single long path which goes against the raster scans
+  Raster<unsigned char, 2> mask({21, 21});
+  for (Index r = 0; r <= 10; r += 2) {
+    const auto lo = r;
+    const auto hi = 20 - r;
+    for (Index i = lo; i <= hi; ++i) {
+      mask[{i, lo}] = mask[{hi, i}] = mask[{i, hi}] = 1;
+      if (i > lo + 1) {
+        mask[{lo, i}] = 1;
+      }
+    }
+    if (lo + 2 <= hi) {
+      mask[{lo + 1, lo + 2}] = 1;
+    }
+  }
+  Raster<unsigned char, 2> marker(mask.shape());
+  marker[{10, 10}] = 1;
+  for (auto connectivity : {Connectivity::Faces, Connectivity::Full}) {
+    const auto expected = naive_reconstruction(marker, mask, connectivity);
+    BOOST_TEST(reconstruct_by_dilation(marker, mask, connectivity) == expected);
+    BOOST_TEST((BitRaster<2>(reconstruct_by_dilation(marker, mask, connectivity)) == BitRaster<2>(expected)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bit_reconstruction_matches_raster_reconstruction_test)
+{
+  Raster<unsigned char, 3> mask({150, 7, 5});
+  Raster<unsigned char, 3> marker(mask.shape());
+  for (const auto& p : mask.domain()) {
+    mask[p] = (p[0] * 3 + p[1] * 7 + p[2] * 11 + p[0] * p[1]) % 5 != 0;
+    marker[p] = (p[0] * 13 + p[1] + p[2] * 17) % 97 == 0;
+  }
+  for (auto connectivity : {Connectivity::Faces, Connectivity::Full}) {
+    const auto expected = reconstruct_by_dilation(marker, mask, connectivity);
+    const auto bits = reconstruct_by_dilation(BitRaster<3>(marker), BitRaster<3>(mask), connectivity);
+    BOOST_TEST((bits == BitRaster<3>(expected)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(holes_are_filled_test)
+{
+  Raster<unsigned char, 2> in({70, 9});
+  for (const auto& p : Box<2>({1, 1}, {66, 7})) {
+    in[p] = 1;
+  }
+  for (const auto& p : Box<2>({3, 3}, {64, 5})) {
+    in[p] = 0; // Hole
+  }
+  in[{1, 4}] = 0;
+  in[{2, 4}] = 0; // Gap between the hole and the border
+  in[{0, 4}] = 1;
+  BOOST_TEST(fill_holes(in) == in); // The gap connects to the border diagonally
+  BOOST_TEST((fill_holes(BitRaster<2>(in)) == BitRaster<2>(in)));
+  auto expected = in;
+  for (const auto& p : Box<2>({1, 3}, {64, 5})) {
+    expected[p] = 1;
+  }
+  BOOST_TEST(fill_holes(in, Connectivity::Faces) == expected);
+  BOOST_TEST((fill_holes(BitRaster<2>(in), Connectivity::Faces) == BitRaster<2>(expected)));
+}
+
+BOOST_AUTO_TEST_CASE(grayscale_basin_is_filled_test)
+{
+  Raster<float, 2> in({7, 7});
+  in.fill(5);
+  for (const auto& p : Box<2>({1, 1}, {5, 5})) {
+    in[p] = 8;
+  }
+  in[{3, 3}] = 2;
+  in[{2, 3}] = 6;
+  auto expected = in;
+  expected[{3, 3}] = 8;
+  expected[{2, 3}] = 8;
+  BOOST_TEST(fill_holes(in) == expected);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/RecursiveGaussian.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RecursiveGaussian_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(constant_is_invariant_test)
+{
+  const auto raster = Raster<double>({16, 12}).fill(3.);
+  const auto filter = recursive_gaussian<double>(4);
+  for (auto e : filter * extrapolation<Nearest>(raster)) {
+    BOOST_TEST(e == 3., boost::test_tools::tolerance(1e-9));
+  }
+  for (auto e : filter * extrapolation(raster, 3.)) {
+    BOOST_TEST(e == 3., boost::test_tools::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sampled_gaussian_test)
+{
+  const double sigma = 3;
+  const Index radius = 4 * sigma;
+  std::vector<double> values;
+  for (Index i = -radius; i <= radius; ++i) {
+    values.push_back(std::exp(-0.5 * i * i / (sigma * sigma)));
+  }
+  const auto sum = std::accumulate(values.begin(), values.end(), 0.);
+  for (auto& v : values) {
+    v /= sum;
+  }
+  const auto sampled = convolution_along<double, 0, 1>(values);
+
+  Raster<double> raster({40, 30});
+  raster.generate(UniformNoise<double>(0, 1, 42));
+  const auto extrapolated = extrapolation<Nearest>(raster);
+  const auto expected = sampled * extrapolated;
+  const auto output = recursive_gaussian<double>(sigma) * extrapolated;
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    BOOST_TEST(std::abs(output[i] - expected[i]) < 0.01);
+  }
+
+  const auto cropped = recursive_gaussian<double>(sigma) * raster;
+  BOOST_TEST(cropped.shape() == (raster.shape() - 2 * radius));
+}
+
+BOOST_AUTO_TEST_CASE(periodic_is_shift_invariant_test)
+{
+  Raster<double> raster({20, 10});
+  raster.generate(UniformNoise<double>(0, 1, 1));
+  const auto shifted = Raster<double>(extrapolation<Periodic>(raster)(raster.domain() + Position<2>({7, 3})));
+  const auto filter = recursive_gaussian<double>(2.5);
+  const auto output = filter * extrapolation<Periodic>(raster);
+  const auto shifted_output = filter * extrapolation<Periodic>(shifted);
+  for (const auto& p : raster.domain()) {
+    const Position<2> q {(p[0] + 7) % 20, (p[1] + 3) % 10};
+    BOOST_TEST(std::abs(shifted_output[p] - output[q]) < 1e-3); // Margins are finite
+  }
+}
+
+BOOST_AUTO_TEST_CASE(derivative_of_ramp_test)
+{
+  Raster<double> raster({30, 20});
+  raster.generate(
+      [](const auto& p) {
+        return 2. * p[0] - p[1];
+      },
+      raster.domain());
+  const auto dx = recursive_gaussian_derivative<double, 0>(2) * raster;
+  for (auto e : dx) {
+    BOOST_TEST(e == 2., boost::test_tools::tolerance(0.01));
+  }
+  const auto dyy = recursive_gaussian_derivative<double, 1>(2, 2) * raster;
+  for (auto e : dyy) {
+    BOOST_TEST(std::abs(e) < 0.01);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(small_sigma_throws_test)
+{
+  BOOST_CHECK_THROW(recursive_gaussian<float>(0.2), OutOfBoundsError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LinxTransforms/Registration.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Registration_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Make a periodic image, band-limited below the Nyquist frequency, translated by some shift.
+ */
+Raster<double, 2> make_frame(Index length, double dx, double dy)
+{
+  constexpr double pi = 3.14159265358979323846;
+  Raster<double, 2> out({length, length});
+  for (const auto& p : out.domain()) {
+    double value = 0;
+    for (Index u = 0; u < length / 2; ++u) {
+      for (Index v = -length / 2 + 1; v < length / 2; ++v) {
+        const auto phase = 2 * pi * (u * (p[0] - dx) + v * (p[1] - dy)) / length + .1 * (7 * u + 13 * v);
+        value += std::cos(phase) / (1. + u * u + v * v);
+      }
+    }
+    out[p] = value;
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(integer_shift_test)
+{
+  const auto reference = make_frame(32, 0, 0);
+  PhaseCorrelation<2> registration(reference, 1);
+  const auto shift = registration(make_frame(32, 7, -3));
+  BOOST_TEST(shift[0] == 7);
+  BOOST_TEST(shift[1] == -3);
+}
+
+BOOST_AUTO_TEST_CASE(subpixel_shift_test)
+{
+  const auto reference = make_frame(32, 0, 0);
+  PhaseCorrelation<2> registration(reference, 100);
+  const auto shift = registration(make_frame(32, 3.25, -5.63));
+  BOOST_TEST(std::abs(shift[0] - 3.25) < .005);
+  BOOST_TEST(std::abs(shift[1] + 5.63) < .005);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_frames_test)
+{
+  const auto reference = make_frame(24, 0, 0);
+  PhaseCorrelation<2> registration(reference, 20);
+  std::vector<Raster<double, 2>> frames;
+  for (Index k = 0; k < 5; ++k) {
+    frames.push_back(make_frame(24, .5 * k, -.35 * k));
+  }
+  const auto shifts = registration(par(3), frames);
+  BOOST_TEST(shifts.size() == frames.size());
+  for (Index k = 0; k < 5; ++k) {
+    const auto sequential = registration(frames[k]);
+    BOOST_TEST(shifts[k][0] == sequential[0]);
+    BOOST_TEST(shifts[k][1] == sequential[1]);
+    BOOST_TEST(std::abs(shifts[k][0] - .5 * k) < .025);
+    BOOST_TEST(std::abs(shifts[k][1] + .35 * k) < .025);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -83,6 +83,107 @@ BOOST_AUTO_TEST_CASE(pixel_list_test)
   }
 }
 
+template <typename TFilter, typename TIn>
+void check_parallel_equals_sequential(TFilter filter, const TIn& in)
+{
+  const auto expected = filter * in;
+  for (Index threads : {2, 3, -1}) {
+    filter.parallelize(threads);
+    BOOST_TEST(filter.thread_count() > 0);
+    const auto out = filter * in;
+    BOOST_TEST(out.shape() == expected.shape());
+    BOOST_TEST(out.container() == expected.container());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_test)
+{
+  const auto in = Raster<int, 2>({17, 23}).range();
+  const auto extra = extrapolation<Nearest>(in);
+  const auto box = Box<2>::from_center(2);
+  const auto grid = Grid<2>({Position<2> {1, 1}, Position<2> {15, 20}}, Position<2> {3, 2});
+
+  const auto median = median_filter<int>(box);
+  check_parallel_equals_sequential(median, in);
+  check_parallel_equals_sequential(median, extra);
+  check_parallel_equals_sequential(median, extra(grid));
+
+  const auto conv = convolution(Raster<int, 2>({3, 5}).range());
+  check_parallel_equals_sequential(conv, in);
+  check_parallel_equals_sequential(conv, extra);
+  check_parallel_equals_sequential(conv, extra(grid));
+
+  const auto erode = erosion<int>(box);
+  check_parallel_equals_sequential(erode, extra);
+}
+
+BOOST_AUTO_TEST_CASE(incremental_update_test)
+{
+  auto in = Raster<int, 2>({31, 27}).range();
+  const auto filter = correlation(Raster<int, 2>({3, 5}).range());
+  auto extrapolated = filter * extrapolation<Nearest>(in);
+  auto cropped = filter * in;
+  const std::vector<Box<2>> changed {
+      {{0, 0}, {2, 1}},
+      {{12, 10}, {13, 14}},
+      {{13, 12}, {15, 12}},
+      {{30, 26}, {30, 26}}};
+  for (const auto& c : changed) {
+    for (const auto& p : c) {
+      in[p] = -3 * in[p];
+    }
+  }
+  filter.update(extrapolation<Nearest>(in), changed, extrapolated);
+  filter.update(in, changed, cropped);
+  BOOST_TEST(extrapolated.container() == (filter * extrapolation<Nearest>(in)).container());
+  BOOST_TEST(cropped.container() == (filter * in).container());
+}
+
+BOOST_AUTO_TEST_CASE(lower_dimension_window_test)
+{
+  auto in = Raster<int, 3>({13, 11, 4}).range();
+  const auto median = median_filter<int>(Box<2>::from_center(1));
+  const auto conv = convolution(Raster<int, 2>({3, 5}).range());
+  const auto check = [&](const auto& filter) {
+    const auto extrapolated = filter * extrapolation<Periodic>(in);
+    const auto cropped = filter * in;
+    BOOST_TEST(extrapolated.shape() == in.shape());
+    for (Index k = 0; k < in.shape()[2]; ++k) {
+      const auto section = in.section(k);
+      const auto expected = filter * extrapolation<Periodic>(section);
+      BOOST_TEST(extrapolated.section(k) == expected);
+      BOOST_TEST(cropped.section(k) == filter * section);
+    }
+    check_parallel_equals_sequential(filter, in);
+    check_parallel_equals_sequential(filter, extrapolation<Periodic>(in));
+  };
+  check(median);
+  check(conv);
+}
+
+BOOST_AUTO_TEST_CASE(batch_test)
+{
+  auto stack = Raster<int, 3>({8, 7, 5}).range();
+  auto filter = convolution(Raster<int, 2>({3, 3}).range());
+  std::vector<PtrRaster<int, 2>> stamps;
+  std::vector<PtrRaster<int, 2>> out;
+  Raster<int, 3> out_stack(stack.shape());
+  for (Index k = 0; k < stack.shape()[2]; ++k) {
+    stamps.emplace_back(Position<2> {8, 7}, &stack[{0, 0, k}]);
+    out.emplace_back(Position<2> {8, 7}, &out_stack[{0, 0, k}]);
+  }
+  std::vector<Extrapolation<PtrRaster<int, 2>, Nearest>> in;
+  for (const auto& s : stamps) {
+    in.emplace_back(s);
+  }
+  const auto expected = filter * extrapolation<Nearest>(stack);
+  for (Index threads : {1, 3}) {
+    out_stack.fill(0);
+    filter.parallelize(threads).transform_batch(in, out);
+    BOOST_TEST(out_stack == expected);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
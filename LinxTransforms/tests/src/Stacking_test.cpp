@@ -0,0 +1,86 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Stacking.h"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Stacking_test)
+
+//-----------------------------------------------------------------------------
+
+std::vector<Raster<float, 2>> make_frames(Index count)
+{
+  std::vector<Raster<float, 2>> out;
+  for (Index k = 0; k < count; ++k) {
+    auto frame = Raster<float, 2>({7, 5}).range();
+    frame += float((k * 11) % count); // Shuffled offsets
+    if (k == 1) {
+      frame[{3, 2}] = 1000; // Outlier
+    }
+    out.push_back(LINX_MOVE(frame));
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(median_test)
+{
+  for (Index count : {5, 6, 31}) {
+    const auto frames = make_frames(count);
+    for (Index threads : {1, 3}) {
+      for (Index memory : {Index(1) << 20, Index(64)}) { // Single band or one row per band
+        const auto out = combine_frames(par(threads), frames, MedianCombiner(), memory);
+        BOOST_TEST(out.shape() == frames[0].shape());
+        for (const auto& p : out.domain()) {
+          std::vector<double> values;
+          for (const auto& f : frames) {
+            values.push_back(f[p]);
+          }
+          std::sort(values.begin(), values.end());
+          const auto expected = (values[(count - 1) / 2] + values[count / 2]) / 2;
+          BOOST_TEST(out[p] == expected);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sigma_clipped_mean_rejects_outlier_test)
+{
+  for (Index count : {9, 21}) {
+    const auto frames = make_frames(count);
+    const auto out = combine_frames(par(2), frames, SigmaClippedMeanCombiner(3));
+    const auto mean = (count - 1) / 2.;
+    const auto clipped = (mean * count - 11 % count) / (count - 1); // Without the outlier
+    for (const auto& p : out.domain()) {
+      const auto expected = p == Position<2> {3, 2} ? clipped : mean;
+      BOOST_TEST(out[p] == frames[0].index(p) + expected, boost::test_tools::tolerance(1e-6));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(band_reader_test)
+{
+  const auto frames = make_frames(4);
+  Raster<double, 2> out(frames[0].shape());
+  Index calls = 0;
+  const auto read = [&](Index k, const Box<2>& band, float* data) {
+#pragma omp atomic
+    ++calls;
+    const auto patch = frames[k](band);
+    std::copy(patch.begin(), patch.end(), data);
+  };
+  combine_frames<float>(ParallelPolicy(1), 4, read, MedianCombiner(), out, 4 * 7 * 2 * sizeof(float));
+  BOOST_TEST(calls == 4 * 3); // Bands of 2 rows
+  BOOST_TEST(out == combine_frames(par(1), frames, MedianCombiner()));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
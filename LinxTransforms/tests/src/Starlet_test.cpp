@@ -0,0 +1,105 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Starlet.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Starlet_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Smooth a 2D raster with the dilated B3-spline kernel, naively.
+ */
+Raster<double, 2> naive_smooth(const Raster<double, 2>& in, Index step)
+{
+  const double kernel[] = {1. / 16, 4. / 16, 6. / 16, 4. / 16, 1. / 16};
+  const Mirror mirror;
+  Raster<double, 2> out(in.shape());
+  for (const auto& p : out.domain()) {
+    double sum = 0;
+    for (Index ky = 0; ky < 5; ++ky) {
+      for (Index kx = 0; kx < 5; ++kx) {
+        const Position<2> q {
+            mirror.index(p[0] + (kx - 2) * step, in.shape()[0]),
+            mirror.index(p[1] + (ky - 2) * step, in.shape()[1])};
+        sum += kernel[kx] * kernel[ky] * in[q];
+      }
+    }
+    out[p] = sum;
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(starlet_equals_naive_test)
+{
+  Raster<double, 2> in({13, 9});
+  for (const auto& p : in.domain()) {
+    in[p] = std::sin(.7 * p[0]) + std::cos(1.3 * p[1]) + (p[0] * p[1]) % 5;
+  }
+  const auto planes = starlet<double>(par(3), in, 3);
+  const Position<3> shape {13, 9, 4};
+  BOOST_TEST(planes.shape() == shape);
+  auto c = in;
+  for (Index j = 0; j < 3; ++j) {
+    const auto smooth = naive_smooth(c, Index(1) << j);
+    const auto plane = planes.section(j);
+    for (const auto& p : in.domain()) {
+      BOOST_TEST(plane[p] == c[p] - smooth[p], boost::test_tools::tolerance(1e-12));
+    }
+    c = smooth;
+  }
+  const auto residual = planes.section(3);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(residual[p] == c[p], boost::test_tools::tolerance(1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reconstruction_test)
+{
+  const auto in = Raster<int, 3>({8, 7, 6}).range();
+  const auto planes = starlet<double>(in, 4);
+  const auto out = inverse_starlet(par(2), planes);
+  for (Index i = 0; i < static_cast<Index>(in.size()); ++i) {
+    BOOST_TEST(out[i] == in[i], boost::test_tools::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(thresholding_test)
+{
+  auto in = Raster<float, 2>({16, 16});
+  in.fill(1);
+  in[{8, 8}] = 100;
+  const auto planes = starlet<float>(in, 2);
+  const std::vector<double> huge {1e6, 1e6};
+  const auto smooth = inverse_starlet(planes, huge);
+  const auto residual = planes.section(2);
+  for (Index i = 0; i < static_cast<Index>(in.size()); ++i) {
+    BOOST_TEST(smooth[i] == residual[i]);
+  }
+  const std::vector<double> thresholds {1, 1};
+  const auto hard = inverse_starlet(planes, thresholds, Thresholding::Hard);
+  const auto soft = inverse_starlet(planes, thresholds, Thresholding::Soft);
+  for (Index i = 0; i < static_cast<Index>(in.size()); ++i) {
+    float expected_hard = residual[i];
+    float expected_soft = residual[i];
+    for (Index j = 0; j < 2; ++j) {
+      const auto w = planes.section(j)[i];
+      expected_hard += std::abs(w) > 1 ? w : 0;
+      expected_soft += w > 1 ? w - 1 : w < -1 ? w + 1 : 0;
+    }
+    BOOST_TEST(hard[i] == expected_hard, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(soft[i] == expected_soft, boost::test_tools::tolerance(1e-5f));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()